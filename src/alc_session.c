@@ -49,9 +49,11 @@
 #include "alc_session.h"
 #include "mad_rlc.h"
 #include "alc_rx.h"
+#include "atsc3_alc_rx.h"
 //#include "alc_tx.h"
 #include "transport.h"
 #include "alc_channel.h"
+#include "atsc3_qsbr.h"
 
 /**
  * Use absolute path with base directory.
@@ -59,49 +61,142 @@
 
 #define ABSOLUTE_PATH 1
 
-struct alc_session *alc_session_list[MAX_ALC_SESSIONS]; /**< List which contains all ALC sessions */
+/**
+ * Session registry, MAX_ALC_SESSIONS slots split into ALC_SESSION_REGISTRY_SHARDS cache line aligned shards.
+ * Slots are claimed and released with a compare and swap and read with an acquire load, so opening, closing
+ * and looking up a session never takes a lock. New sessions start their slot search at the next shard in
+ * turn, so concurrent opens do not contend on the same cache line. A closed session is handed to
+ * atsc3_qsbr_retire and only torn down once every thread that may have looked it up has been quiescent.
+ */
+
+#define ALC_SESSION_REGISTRY_SHARD_SLOTS ((MAX_ALC_SESSIONS + ALC_SESSION_REGISTRY_SHARDS - 1) / ALC_SESSION_REGISTRY_SHARDS)
+
+typedef struct alc_session_registry_shard {
+  struct alc_session *slots[ALC_SESSION_REGISTRY_SHARD_SLOTS];
+} __attribute__((aligned(64))) alc_session_registry_shard_t;
+
+static alc_session_registry_shard_t alc_session_registry[ALC_SESSION_REGISTRY_SHARDS]; /**< All ALC sessions, indexed by s_id */
+static unsigned int alc_session_registry_next_shard = 0;
 int nb_alc_session = 0; /**< Number of ALC sessions */
 
 /**
- * Global variables semaphore
+ * This is a private function, which returns the registry slot of the session identifier.
+ *
  */
 
-#ifdef _MSC_VER
-RTL_CRITICAL_SECTION session_variables_semaphore;
-#else
-pthread_mutex_t session_variables_semaphore = PTHREAD_MUTEX_INITIALIZER;
-#endif
+static struct alc_session** alc_session_registry_slot(int s_id) {
+  assert (s_id >= 0);
+  assert (s_id < MAX_ALC_SESSIONS);
+
+  return &alc_session_registry[s_id / ALC_SESSION_REGISTRY_SHARD_SLOTS].slots[s_id % ALC_SESSION_REGISTRY_SHARD_SLOTS];
+}
+
+static void alc_session_free(void *ptr);
 
 /**
- * This is a private function, which locks the session.
+ * This is a private function, which publishes the session in a free registry slot and sets its s_id.
  *
  */
 
-void lock_session() {
-#ifdef _MSC_VER
-  EnterCriticalSection(&session_variables_semaphore);
-#else
-  pthread_mutex_lock(&session_variables_semaphore);
-#endif
+static int alc_session_registry_add(alc_session_t *s) {
+  unsigned int shard = __atomic_fetch_add(&alc_session_registry_next_shard, 1, __ATOMIC_RELAXED) % ALC_SESSION_REGISTRY_SHARDS;
+  int i;
+  int j;
+
+  for(i = 0; i < ALC_SESSION_REGISTRY_SHARDS; i++, shard = (shard + 1) % ALC_SESSION_REGISTRY_SHARDS) {
+    for(j = 0; j < ALC_SESSION_REGISTRY_SHARD_SLOTS && shard * ALC_SESSION_REGISTRY_SHARD_SLOTS + j < MAX_ALC_SESSIONS; j++) {
+      struct alc_session **slot = &alc_session_registry[shard].slots[j];
+      struct alc_session *expected = NULL;
+
+      if(__atomic_load_n(slot, __ATOMIC_RELAXED) != NULL) {
+        continue;
+      }
+
+      s->s_id = shard * ALC_SESSION_REGISTRY_SHARD_SLOTS + j;
+      if(__atomic_compare_exchange_n(slot, &expected, s, false, __ATOMIC_RELEASE, __ATOMIC_RELAXED)) {
+        __atomic_fetch_add(&nb_alc_session, 1, __ATOMIC_RELAXED);
+        return s->s_id;
+      }
+    }
+  }
+
+  return -1;
 }
 
 /**
- * This is a private function, which unlocks the session.
+ * This is a private function, which releases the registry slot of the session.
  *
  */
 
-void unlock_session() {
-#ifdef _MSC_VER
-  LeaveCriticalSection(&session_variables_semaphore);
-#else
-  pthread_mutex_unlock(&session_variables_semaphore);
-#endif
+static BOOL alc_session_registry_remove(alc_session_t *s) {
+  struct alc_session *expected = s;
+
+  if(__atomic_compare_exchange_n(alc_session_registry_slot(s->s_id), &expected, NULL, false, __ATOMIC_ACQ_REL, __ATOMIC_RELAXED)) {
+    __atomic_fetch_sub(&nb_alc_session, 1, __ATOMIC_RELAXED);
+    return TRUE;
+  }
+
+  return FALSE;
+}
+
+alc_session_t* get_alc_session(int s_id) {
+  return __atomic_load_n(alc_session_registry_slot(s_id), __ATOMIC_ACQUIRE);
+}
+
+/**
+ * This is a private function, which looks up the session for an s_id accessor inside a qsbr read section,
+ * so a concurrent close can not free it before the accessor calls alc_session_release.
+ *
+ */
+
+static alc_session_t* alc_session_acquire(int s_id, bool *qsbr_registered) {
+  *qsbr_registered = atsc3_qsbr_read_section_begin();
+  return get_alc_session(s_id);
+}
+
+static void alc_session_release(bool qsbr_registered) {
+  atsc3_qsbr_read_section_end(qsbr_registered);
+}
+
+int alc_session_get_state(alc_session_t *s) {
+  return __atomic_load_n(&s->state, __ATOMIC_ACQUIRE);
+}
+
+void alc_session_set_state(alc_session_t *s, enum alc_session_states state) {
+  __atomic_store_n(&s->state, state, __ATOMIC_RELEASE);
+}
+
+void alc_session_reset_object_cache(alc_session_t *s) {
+  __atomic_add_fetch(&s->alc_object_cache_epoch, 1, __ATOMIC_RELEASE);
+}
+
+trans_obj_t* alc_session_get_obj_list(alc_session_t *s) {
+  return s->obj_list;
+}
+
+trans_obj_t* alc_session_get_fdt_list(alc_session_t *s) {
+  return s->fdt_list;
+}
+
+wanted_obj_t* alc_session_get_wanted_obj_list(alc_session_t *s) {
+  return s->wanted_obj_list;
+}
+
+unsigned int alc_session_get_fdt_instance_id(alc_session_t *s) {
+  return s->fdt_instance_id;
+}
+
+void alc_session_set_fdt_instance_id(alc_session_t *s, unsigned int instance_id) {
+  s->fdt_instance_id = (instance_id & 0x00FFFFFF);
+}
+
+void alc_session_set_fdt_instance_parsed(alc_session_t *s) {
+  s->waiting_fdt_instance = FALSE;
 }
 
 alc_session_t* open_alc_session(alc_arguments_t *a) {
 
   alc_session_t *s;
-  int i;
   int retval;
   struct timeb timeb_current_time;
   
@@ -109,24 +204,18 @@ alc_session_t* open_alc_session(alc_arguments_t *a) {
   char fullpath[MAX_PATH_LENGTH];
 #endif
 
-  lock_session();
-  
-  if(!lib_init) {
+  if(!__atomic_load_n(&lib_init, __ATOMIC_ACQUIRE)) {
     alc_init();
-    /* alc session list initialization */
-    memset(alc_session_list, 0, MAX_ALC_SESSIONS * sizeof(alc_session_t*));
   }
   
-  if(nb_alc_session >= MAX_ALC_SESSIONS) {
+  if(__atomic_load_n(&nb_alc_session, __ATOMIC_RELAXED) >= MAX_ALC_SESSIONS) {
     /* Could not create new alc session */
     printf("Could not create new alc session: too many sessions!\n");
-    unlock_session();
     return NULL;
   }
   
   if (!(s = (alc_session_t*)calloc(1, sizeof(alc_session_t)))) {
     printf("Could not alloc memory for alc session!\n");
-    unlock_session();
     return NULL;
   }
 
@@ -143,7 +232,6 @@ alc_session_t* open_alc_session(alc_arguments_t *a) {
     retval = init_mad_rlc(s);
     
     if(retval < 0) {
-      unlock_session();
       return NULL;
     }
   }
@@ -198,7 +286,6 @@ alc_session_t* open_alc_session(alc_arguments_t *a) {
 
       if(s->handle_tx_thread == NULL) {
 	perror("open_alc_session: _beginthread");
-	unlock_session();
 	return -1;
       }
 #else
@@ -271,7 +358,6 @@ alc_session_t* open_alc_session(alc_arguments_t *a) {
     
     if(s->handle_rx_thread == NULL) {
       perror("open_alc_session: _beginthread");
-      unlock_session();
       return -1;
     }
 #else
@@ -284,22 +370,24 @@ alc_session_t* open_alc_session(alc_arguments_t *a) {
     
   }
   
-  for(i = 0; i < MAX_ALC_SESSIONS; i++) {
-    if(alc_session_list[i] == NULL) {
-      s->s_id = i;
-      alc_session_list[s->s_id] = s;
-      break;
-    }
+  if(alc_session_registry_add(s) < 0) {
+    /* Lost the race for the last free slot, never published so no reader can hold it */
+    printf("Could not create new alc session: too many sessions!\n");
+    alc_session_free(s);
+    return NULL;
   }
   
-  nb_alc_session++;
-  
-  unlock_session();
   return s;
 }
 
-void close_alc_session(int s_id) {
+/**
+ * This is a private function, which tears down a closed session once no reader can still reach it.
+ *
+ */
+
+static void alc_session_free(void *ptr) {
 
+  alc_session_t *s = (alc_session_t*)ptr;
   int i;
   wanted_obj_t *next_want;
   wanted_obj_t *want;
@@ -310,8 +398,6 @@ void close_alc_session(int s_id) {
   tx_queue_t *pkt;
   
   trans_obj_t *to;
-  
-  alc_session_t *s;
 
 #ifdef USE_RETRIEVE_UNIT
   trans_unit_container_t *tmp;
@@ -324,24 +410,20 @@ void close_alc_session(int s_id) {
 
   /* Wait for open thread. */
 #ifdef _MSC_VER
-  if(alc_session_list[s_id]->handle_rx_thread != NULL) {
-	WaitForSingleObject(alc_session_list[s_id]->handle_rx_thread, INFINITE);
-	CloseHandle(alc_session_list[s_id]->handle_rx_thread);
-	alc_session_list[s_id]->handle_rx_thread = NULL;
+  if(s->handle_rx_thread != NULL) {
+	WaitForSingleObject(s->handle_rx_thread, INFINITE);
+	CloseHandle(s->handle_rx_thread);
+	s->handle_rx_thread = NULL;
   }
 #else
-//  if(alc_session_list[s_id]->rx_thread_id != 0) {
-//     join_retval = pthread_join(alc_session_list[s_id]->rx_thread_id, NULL);
+//  if(s->rx_thread_id != 0) {
+//     join_retval = pthread_join(s->rx_thread_id, NULL);
 //     assert(join_retval == 0);
-//     pthread_detach(alc_session_list[s_id]->rx_thread_id);
-//     alc_session_list[s_id]->rx_thread_id = 0;
+//     pthread_detach(s->rx_thread_id);
+//     s->rx_thread_id = 0;
 //  }
 #endif
 
-  lock_session();
-  s = alc_session_list[s_id];
-  s->state = SClosed;  
-
   for(i = 0; i < s->max_channel; i++) {
     
     if(s->ch_list[i] != NULL) {
@@ -362,6 +444,10 @@ void close_alc_session(int s_id) {
 	s->unit_pool = NULL;
 #endif
 
+  alc_packet_pool_free(&s->alc_packet_pool);
+  alc_raptorq_session_free(&s->alc_raptorq_session);
+  atsc3_alc_object_tracker_free(&s->alc_object_tracker);
+
   /* Closing, free all uncompleted objects, uncompleted fdt instances and wanted obj list */
   
   to = s->obj_list;
@@ -408,26 +494,30 @@ void close_alc_session(int s_id) {
   }
   
   free(s);
-  alc_session_list[s_id] = NULL;
-  nb_alc_session--;
-  unlock_session();
 }
 
-alc_session_t* get_alc_session(int s_id) {
+void alc_session_close(alc_session_t *s) {
 
-  alc_session_t* alc_session;
+  /* Unpublish first, control plane lookups by s_id no longer see the session, a second close is a no-op */
+  if(!alc_session_registry_remove(s)) {
+    return;
+  }
+  alc_session_set_state(s, SClosed);
 
-  lock_session();
-  assert (alc_session_list != NULL);
-  assert (s_id >= 0);
-  assert (s_id < MAX_ALC_SESSIONS);
-  alc_session = alc_session_list[s_id];
+  /* Readers that loaded the session before the unpublish may still be using it */
+  atsc3_qsbr_retire(s, alc_session_free);
+}
 
-  unlock_session();
+void close_alc_session(int s_id) {
+  bool qsbr_registered;
+  alc_session_t *s = alc_session_acquire(s_id, &qsbr_registered);
 
-  return alc_session;
-}
+  if(s != NULL) {
+    alc_session_close(s);
+  }
 
+  alc_session_release(qsbr_registered);
+}
 
 int add_alc_channel(int s_id, const char *port, const char *addr, const char *intface, const char *intface_name) {
 	
@@ -435,20 +525,24 @@ int add_alc_channel(int s_id, const char *port, const char *addr, const char *in
   alc_session_t *s;
   int ret;
 
-  lock_session();
+  bool qsbr_registered;
+
   ch = NULL;
-  s = alc_session_list[s_id];
+  s = alc_session_acquire(s_id, &qsbr_registered);
 
-  if(s->nb_channel >= s->max_channel) {
+  if(s == NULL) {
+    ret = -1;
+  }
+  else if(s->nb_channel >= s->max_channel) {
     /* Could not add new alc channel to alc session */
     printf("Could not create new alc channel: Max number of channels already used!\n");
-    unlock_session();
-    return -1;
+    ret = -1;
+  }
+  else {
+    ret = open_alc_channel(ch, s, port, addr, intface, intface_name, s->def_tx_rate);
   }
 
-  ret = open_alc_channel(ch, s, port, addr, intface, intface_name, s->def_tx_rate);
-  unlock_session();
-
+  alc_session_release(qsbr_registered);
   return ret;
 }
 
@@ -457,11 +551,11 @@ void remove_alc_channels(int s_id) {
   alc_session_t *s;
   alc_channel_t *ch;
   int i;
+  bool qsbr_registered;
 
-  lock_session();
-  s = alc_session_list[s_id];
+  s = alc_session_acquire(s_id, &qsbr_registered);
 
-  for(i = 0; i < s->max_channel; i++) {
+  for(i = 0; s != NULL && i < s->max_channel; i++) {
 
     if(s->ch_list[i] != NULL) {
       ch = s->ch_list[i];
@@ -469,17 +563,19 @@ void remove_alc_channels(int s_id) {
     }
   }
 
-  unlock_session();
+  alc_session_release(qsbr_registered);
 }
 
 trans_obj_t* get_session_obj_list(int s_id) {
 
   trans_obj_t* obj_list;
 
-  lock_session();
-  obj_list = alc_session_list[s_id]->obj_list;
-  unlock_session();
+  bool qsbr_registered;
+  alc_session_t *s = alc_session_acquire(s_id, &qsbr_registered);
+
+  obj_list = s != NULL ? s->obj_list : NULL;
 
+  alc_session_release(qsbr_registered);
   return obj_list;
 }
 
@@ -487,10 +583,12 @@ trans_obj_t* get_session_fdt_list(int s_id) {
 
   trans_obj_t* fdt_list;
 
-  lock_session();
-  fdt_list = alc_session_list[s_id]->fdt_list;
-  unlock_session();
+  bool qsbr_registered;
+  alc_session_t *s = alc_session_acquire(s_id, &qsbr_registered);
+
+  fdt_list = s != NULL ? s->fdt_list : NULL;
 
+  alc_session_release(qsbr_registered);
   return fdt_list;
 }
 
@@ -498,168 +596,231 @@ wanted_obj_t* get_session_wanted_obj_list(int s_id) {
 
   wanted_obj_t* wanted_obj_list;
 
-  lock_session();
-  wanted_obj_list = alc_session_list[s_id]->wanted_obj_list;
-  unlock_session();
+  bool qsbr_registered;
+  alc_session_t *s = alc_session_acquire(s_id, &qsbr_registered);
 
+  wanted_obj_list = s != NULL ? s->wanted_obj_list : NULL;
+
+  alc_session_release(qsbr_registered);
   return wanted_obj_list;
 }
 
 int get_session_state(int s_id) {
   int state;
+  bool qsbr_registered;
 
-  lock_session();
+  alc_session_t *s = alc_session_acquire(s_id, &qsbr_registered);
 
-  if(alc_session_list[s_id] == NULL) {
-    unlock_session();
-    return -1;
-  }
+  state = s != NULL ? alc_session_get_state(s) : -1;
 
-  state = alc_session_list[s_id]->state;
-  unlock_session();
+  alc_session_release(qsbr_registered);
   return state;
 }
 
 void set_session_state(int s_id, enum alc_session_states state) {
-  lock_session();
-  alc_session_list[s_id]->state = state;
-  unlock_session();
+  bool qsbr_registered;
+  alc_session_t *s = alc_session_acquire(s_id, &qsbr_registered);
+
+  if(s != NULL) {
+    alc_session_set_state(s, state);
+  }
+
+  alc_session_release(qsbr_registered);
 }
 
 void set_all_sessions_state(enum alc_session_states state) {
 
   int i;
-  lock_session();
+  alc_session_t *s;
+  bool qsbr_registered = atsc3_qsbr_read_section_begin();
 
   for(i = 0; i < MAX_ALC_SESSIONS; i++)
     {
-      if(alc_session_list[i] != NULL)
+      if((s = get_alc_session(i)) != NULL)
         {
-	  alc_session_list[i]->state = state;
+	  alc_session_set_state(s, state);
         }
     }
-  unlock_session();
+
+  atsc3_qsbr_read_section_end(qsbr_registered);
 }
 
 int get_session_a_flag_usage(int s_id) {
 
   int flag;
-  lock_session();
-  flag = alc_session_list[s_id]->a_flag;
-  unlock_session();
+  bool qsbr_registered;
+  alc_session_t *s = alc_session_acquire(s_id, &qsbr_registered);
 
+  flag = s != NULL ? s->a_flag : 0;
+
+  alc_session_release(qsbr_registered);
   return flag;
 }
 
 void set_session_a_flag_usage(int s_id) {
 
-  lock_session();
-  alc_session_list[s_id]->a_flag = 1;
-  unlock_session();
+  bool qsbr_registered;
+  alc_session_t *s = alc_session_acquire(s_id, &qsbr_registered);
+
+  if(s != NULL) {
+    s->a_flag = 1;
+  }
+
+  alc_session_release(qsbr_registered);
 }
 
 unsigned int get_fdt_instance_id(int s_id) {
 
   int instance_id;
 
-  lock_session();
-  instance_id = alc_session_list[s_id]->fdt_instance_id;
-  unlock_session();
+  bool qsbr_registered;
+  alc_session_t *s = alc_session_acquire(s_id, &qsbr_registered);
+
+  instance_id = s != NULL ? s->fdt_instance_id : 0;
 
+  alc_session_release(qsbr_registered);
   return instance_id;
 }
 
 void set_fdt_instance_id(int s_id, unsigned int instance_id) {
-  lock_session();
-  alc_session_list[s_id]->fdt_instance_id =  (instance_id & 0x00FFFFFF);
-  unlock_session();
+  bool qsbr_registered;
+  alc_session_t *s = alc_session_acquire(s_id, &qsbr_registered);
+
+  if(s != NULL) {
+    s->fdt_instance_id =  (instance_id & 0x00FFFFFF);
+  }
+
+  alc_session_release(qsbr_registered);
 }
 
 void set_fdt_instance_parsed(int s_id) {
-  lock_session();
-  alc_session_list[s_id]->waiting_fdt_instance = FALSE;
-  unlock_session();
+  bool qsbr_registered;
+  alc_session_t *s = alc_session_acquire(s_id, &qsbr_registered);
+
+  if(s != NULL) {
+    s->waiting_fdt_instance = FALSE;
+  }
+
+  alc_session_release(qsbr_registered);
 }
 
 unsigned long long get_session_sent_bytes(int s_id) {
   unsigned long long byte_sent;
 
-  lock_session();
-  byte_sent = alc_session_list[s_id]->sent_bytes;
-  unlock_session();
+  bool qsbr_registered;
+  alc_session_t *s = alc_session_acquire(s_id, &qsbr_registered);
+
+  byte_sent = s != NULL ? s->sent_bytes : 0;
 
+  alc_session_release(qsbr_registered);
   return byte_sent;
 }
 
 void set_session_sent_bytes(int s_id, unsigned long long sent_bytes) {
 
-  lock_session();
-  alc_session_list[s_id]->sent_bytes = sent_bytes;
-  unlock_session();
+  bool qsbr_registered;
+  alc_session_t *s = alc_session_acquire(s_id, &qsbr_registered);
+
+  if(s != NULL) {
+    s->sent_bytes = sent_bytes;
+  }
+
+  alc_session_release(qsbr_registered);
 }
 
 void add_session_sent_bytes(int s_id, unsigned int sent_bytes) {
 
-  lock_session();
-  alc_session_list[s_id]->sent_bytes += sent_bytes;
-  unlock_session();
+  bool qsbr_registered;
+  alc_session_t *s = alc_session_acquire(s_id, &qsbr_registered);
+
+  if(s != NULL) {
+    s->sent_bytes += sent_bytes;
+  }
+
+  alc_session_release(qsbr_registered);
 }
 
 unsigned long long get_object_sent_bytes(int s_id) {
   unsigned long long byte_sent;
 
-  lock_session();
-  byte_sent = alc_session_list[s_id]->obj_sent_bytes;
-  unlock_session();
+  bool qsbr_registered;
+  alc_session_t *s = alc_session_acquire(s_id, &qsbr_registered);
 
+  byte_sent = s != NULL ? s->obj_sent_bytes : 0;
+
+  alc_session_release(qsbr_registered);
   return byte_sent;
 }
 
  void set_object_sent_bytes(int s_id, unsigned long long sent_bytes) {
 
-   lock_session();
-   alc_session_list[s_id]->obj_sent_bytes = sent_bytes;
-   unlock_session();
+   bool qsbr_registered;
+   alc_session_t *s = alc_session_acquire(s_id, &qsbr_registered);
+
+   if(s != NULL) {
+     s->obj_sent_bytes = sent_bytes;
+   }
+
+   alc_session_release(qsbr_registered);
  }
 
 void add_object_sent_bytes(int s_id, unsigned int sent_bytes) {
 
-  lock_session();
-  alc_session_list[s_id]->obj_sent_bytes += sent_bytes;
-  unlock_session();
+  bool qsbr_registered;
+  alc_session_t *s = alc_session_acquire(s_id, &qsbr_registered);
+
+  if(s != NULL) {
+    s->obj_sent_bytes += sent_bytes;
+  }
+
+  alc_session_release(qsbr_registered);
 }
 
 double get_object_last_print_tx_percent(int s_id) {                                                                                                                   
   double tx_percent;
 
-  lock_session();
-  tx_percent = alc_session_list[s_id]->last_print_tx_percent;
-  unlock_session();
+  bool qsbr_registered;
+  alc_session_t *s = alc_session_acquire(s_id, &qsbr_registered);
+
+  tx_percent = s != NULL ? s->last_print_tx_percent : 0;
 
+  alc_session_release(qsbr_registered);
   return tx_percent;
 }
                                                                                                                                           
 void set_object_last_print_tx_percent(int s_id, double last_print_tx_percent) {                                                                                  
-  lock_session();
-  alc_session_list[s_id]->last_print_tx_percent = last_print_tx_percent;
-  unlock_session();
+  bool qsbr_registered;
+  alc_session_t *s = alc_session_acquire(s_id, &qsbr_registered);
+
+  if(s != NULL) {
+    s->last_print_tx_percent = last_print_tx_percent;
+  }
+
+  alc_session_release(qsbr_registered);
 }
 
 void set_session_tx_toi(int s_id, unsigned long long toi) {
 
-  lock_session();
-  alc_session_list[s_id]->tx_toi = toi;
-  unlock_session();
+  bool qsbr_registered;
+  alc_session_t *s = alc_session_acquire(s_id, &qsbr_registered);
+
+  if(s != NULL) {
+    s->tx_toi = toi;
+  }
+
+  alc_session_release(qsbr_registered);
 }
 
 unsigned long long get_session_tx_toi(int s_id) {
 
   unsigned long long tx_toi;
 
-  lock_session();
-  tx_toi = alc_session_list[s_id]->tx_toi;
-  unlock_session();
+  bool qsbr_registered;
+  alc_session_t *s = alc_session_acquire(s_id, &qsbr_registered);
+
+  tx_toi = s != NULL ? s->tx_toi : 0;
 
+  alc_session_release(qsbr_registered);
   return tx_toi;
 }
 
@@ -667,11 +828,11 @@ void update_session_tx_rate(int s_id, int base_tx_rate) {
 	alc_session_t *s;
 	alc_channel_t *ch;
 	int i;
+	bool qsbr_registered;
 
-	lock_session();
-	s = alc_session_list[s_id];
+	s = alc_session_acquire(s_id, &qsbr_registered);
 	
-	for(i = 0; i < s->max_channel; i++) {
+	for(i = 0; s != NULL && i < s->max_channel; i++) {
 		if(s->ch_list[i] != NULL) {
 			ch = s->ch_list[i];
 
@@ -686,50 +847,42 @@ void update_session_tx_rate(int s_id, int base_tx_rate) {
 			printf("new rate [channel: %i]: %i\n", ch->ch_id, ch->tx_rate);
 		}
 	}
-	unlock_session();
+
+	alc_session_release(qsbr_registered);
 }
 
 wanted_obj_t* get_wanted_object(alc_session_t *s, unsigned long long toi) {
 
 	wanted_obj_t *tmp;
 
-	lock_session();
-
 	tmp = s->wanted_obj_list;
 
 	while(tmp != NULL) {
 		if(tmp->toi == toi) {
-		  unlock_session();
 		  return tmp;
 		}
 		tmp = tmp->next;
 	}
 
-	unlock_session();
 	return NULL;
 }
 
-int set_wanted_object(int s_id, unsigned long long toi,
+static int alc_session_set_wanted_object(alc_session_t *s, unsigned long long toi,
 		      unsigned long long transfer_len,
 		      unsigned short es_len, unsigned int max_sb_len, int fec_inst_id,
 		      short fec_enc_id, unsigned short max_nb_of_es,
 		      unsigned char content_enc_algo, unsigned char finite_field,
 			  unsigned char nb_of_es_per_group) {
 	
-  alc_session_t *s;
   wanted_obj_t *wanted_obj;
   wanted_obj_t *tmp;
   
-  lock_session();
-   
-  s = alc_session_list[s_id];
   tmp = s->wanted_obj_list;
   
   if(tmp == NULL) {
     
     if (!(wanted_obj = (wanted_obj_t*)calloc(1, sizeof(wanted_obj_t)))) {
       printf("Could not alloc memory for wanted object!\n");
-      unlock_session();
       return -1;
     }
     
@@ -758,7 +911,6 @@ int set_wanted_object(int s_id, unsigned long long toi,
 	
 	if (!(wanted_obj = (wanted_obj_t*)calloc(1, sizeof(wanted_obj_t)))) {
 	  printf("Could not alloc memory for wanted object!\n");
-	  unlock_session();
 	  return -1;
 	}
 	
@@ -782,20 +934,38 @@ int set_wanted_object(int s_id, unsigned long long toi,
     }
   }
   
-  unlock_session();
   return 0;
 }
 
+int set_wanted_object(int s_id, unsigned long long toi,
+		      unsigned long long transfer_len,
+		      unsigned short es_len, unsigned int max_sb_len, int fec_inst_id,
+		      short fec_enc_id, unsigned short max_nb_of_es,
+		      unsigned char content_enc_algo, unsigned char finite_field,
+			  unsigned char nb_of_es_per_group) {
+
+  int ret = -1;
+  bool qsbr_registered;
+  alc_session_t *s = alc_session_acquire(s_id, &qsbr_registered);
+
+  if(s != NULL) {
+    ret = alc_session_set_wanted_object(s, toi, transfer_len, es_len, max_sb_len, fec_inst_id, fec_enc_id,
+					max_nb_of_es, content_enc_algo, finite_field, nb_of_es_per_group);
+  }
+
+  alc_session_release(qsbr_registered);
+  return ret;
+}
+
 void remove_wanted_object(int s_id, unsigned long long toi) {
 
 	alc_session_t *s; 	
 	wanted_obj_t *next_want;
 	wanted_obj_t *want;
+	bool qsbr_registered;
 	
-	lock_session();
-
-	s = alc_session_list[s_id];
-	next_want = s->wanted_obj_list;
+	s = alc_session_acquire(s_id, &qsbr_registered);
+	next_want = s != NULL ? s->wanted_obj_list : NULL;
 
 	while(next_want != NULL) {
 		
@@ -819,7 +989,7 @@ void remove_wanted_object(int s_id, unsigned long long toi) {
 	    	next_want = want->next;
 	}
 
-	unlock_session();
+	alc_session_release(qsbr_registered);
 }
                                                                                                                                               
 BOOL is_received_instance(alc_session_t *s, unsigned int fdt_instance_id) {
@@ -843,15 +1013,12 @@ int set_received_instance(alc_session_t *s, unsigned int fdt_instance_id) {
         rx_fdt_instance_t *rx_fdt_instance;
         rx_fdt_instance_t *list;
         
-	lock_session();
-
         list = s->rx_fdt_instance_list;
                                                                                                                                               
         if(list == NULL) {
                                                                                                                                               
                 if (!(rx_fdt_instance = (rx_fdt_instance_t*)calloc(1, sizeof(rx_fdt_instance_t)))) {
                         printf("Could not alloc memory for rx_fdt_instance!\n");
-			unlock_session();
                         return -1;
                 }
 
@@ -870,7 +1037,6 @@ int set_received_instance(alc_session_t *s, unsigned int fdt_instance_id) {
               
 							  if (!(rx_fdt_instance = (rx_fdt_instance_t*)calloc(1, sizeof(rx_fdt_instance_t)))) {
 								printf("Could not alloc memory for rx_fdt_instance!\n");
-								unlock_session();
 								return -1;
 							  }
 			  
@@ -885,7 +1051,6 @@ int set_received_instance(alc_session_t *s, unsigned int fdt_instance_id) {
                 }
         }
 	
-	unlock_session();
         return 0;
 }
 
@@ -893,27 +1058,18 @@ char* get_session_basedir(int s_id) {
 
   alc_session_t *s;
   char* base_dir;
+  bool qsbr_registered;
 
-  lock_session();
-
-  s = alc_session_list[s_id];
-  base_dir = s->base_dir;
-
-  unlock_session();
+  s = alc_session_acquire(s_id, &qsbr_registered);
+  base_dir = s != NULL ? s->base_dir : NULL;
 
+  alc_session_release(qsbr_registered);
   return base_dir;
 }
 
 void initialize_session_handler() {
-#ifdef _MSC_VER
-  InitializeCriticalSection(&session_variables_semaphore);
-#else
-#endif
+  /* Session registry is lock free, nothing to initialize */
 }
 
 void release_session_handler() {
-#ifdef _MSC_VER
-  DeleteCriticalSection(&session_variables_semaphore);
-#else
-#endif
 }
@@ -48,6 +48,12 @@
 extern "C" {
 #endif
 
+/**
+ * Number of cache line aligned shards the MAX_ALC_SESSIONS session registry is split into.
+ */
+
+#define ALC_SESSION_REGISTRY_SHARDS 4
+
 /**
  * ALC session states.
  * @enum alc_session_states
@@ -212,6 +218,11 @@ typedef struct alc_session {
 
   BOOL waiting_fdt_instance;				/**< FDT instance is in parsing state */ 
 
+  struct alc_packet_pool *alc_packet_pool;	/**< recycled alc_packet_t's for alc_rx_analyze_packet_a331_compliant */
+  struct alc_raptorq_session *alc_raptorq_session;	/**< RaptorQ objects being recovered for this session */
+  struct atsc3_alc_object_tracker *alc_object_tracker;	/**< byte range coverage of the objects received in this session */
+  unsigned int alc_object_cache_epoch;		/**< bumped by alc_session_reset_object_cache, atomic */
+
 } alc_session_t;
 
 /**
@@ -235,7 +246,19 @@ alc_session_t* open_alc_session(alc_arguments_t *a);
 void close_alc_session(int s_id);
 
 /**
- * This function returns session from the alc_session_list.
+ * This function closes the session by its handle.
+ *
+ * @param s pointer to the session
+ *
+ */
+
+void alc_session_close(alc_session_t *s);
+
+/**
+ * This function returns session from the lock free session registry, for control plane lookups.
+ * A closed session is only freed once readers are quiescent (atsc3_qsbr), so the pointer stays valid
+ * until the calling thread's next atsc3_qsbr_quiescent, threads that are not qsbr readers must do the
+ * lookup and use inside atsc3_qsbr_read_section_begin/end.
  *
  * @param s_id session identifier
  *
@@ -245,6 +268,112 @@ void close_alc_session(int s_id);
 
 alc_session_t* get_alc_session(int s_id);
 
+/*
+ * Session handle accessors.
+ *
+ * A session is owned by the one worker thread that receives its packets, which passes the alc_session_t*
+ * it got from open_alc_session directly instead of looking it up by s_id, and none of these take a lock.
+ * The state is the only field read from other threads (set_all_sessions_state, get_session_state) and is
+ * loaded and stored atomically. The s_id functions below are kept for the control plane, each is a
+ * registry lookup followed by the same lockless access inside a qsbr read section, and does nothing
+ * (or returns 0, NULL or -1) when the session has been closed.
+ */
+
+/**
+ * This function returns the state of session.
+ *
+ * @param s pointer to the session
+ *
+ * @return the state of the session
+ *
+ */
+
+int alc_session_get_state(alc_session_t *s);
+
+/**
+ * This function sets state of session.
+ *
+ * @param s pointer to the session
+ * @param state state to be set
+ *
+ */
+
+void alc_session_set_state(alc_session_t *s, enum alc_session_states state);
+
+/**
+ * This function drops the session's cache of completed objects, so carousel repeats are received again,
+ * e.g. when a new consumer starts reconstituting the session's objects. It may be called from any thread,
+ * the cache is dropped by the receiving thread on its next packet.
+ *
+ * @param s pointer to the session
+ *
+ */
+
+void alc_session_reset_object_cache(alc_session_t *s);
+
+/**
+ * This function returns session object list.
+ *
+ * @param s pointer to the session
+ *
+ * @return pointer to the object list
+ *
+ */
+
+struct trans_obj* alc_session_get_obj_list(alc_session_t *s);
+
+/**
+ * This function returns session fdt list.
+ *
+ * @param s pointer to the session
+ *
+ * @return pointer to the fdt list
+ *
+ */
+
+struct trans_obj* alc_session_get_fdt_list(alc_session_t *s);
+
+/**
+ * This function returns session wanted object list.
+ *
+ * @param s pointer to the session
+ *
+ * @return pointer to the wanted object list
+ *
+ */
+
+wanted_obj_t* alc_session_get_wanted_obj_list(alc_session_t *s);
+
+/**
+ * This function returns session's FDT instance id.
+ *
+ * @param s pointer to the session
+ *
+ * @return session's FDT instance id
+ *
+ */
+
+unsigned int alc_session_get_fdt_instance_id(alc_session_t *s);
+
+/**
+ * This function sets session's FDT instance id.
+ *
+ * @param s pointer to the session
+ * @param instance_id FDT instance id to be set
+ *
+ */
+
+void alc_session_set_fdt_instance_id(alc_session_t *s, unsigned int instance_id);
+
+/**
+ * This function sets FDT instance parsed.
+ *
+ * @param s pointer to the session
+ *
+ */
+
+void alc_session_set_fdt_instance_parsed(alc_session_t *s);
+
 /**
  * This function adds channel to the session.
  * @param s_id session identifier
@@ -0,0 +1,402 @@
+/*
+ * atsc3_af_packet_capture.c
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: jjustman
+ */
+
+#include <string.h>
+#include <errno.h>
+#include <pthread.h>
+
+#include "atsc3_af_packet_capture.h"
+
+#if defined(__linux__)
+#include <unistd.h>
+#include <poll.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <arpa/inet.h>
+#include <net/if.h>
+#include <linux/if_packet.h>
+#include <linux/if_ether.h>
+#include <linux/filter.h>
+#endif
+
+static atsc3_af_packet_capture_statistics_t atsc3_af_packet_capture_statistics_released;
+static pthread_mutex_t atsc3_af_packet_capture_contexts_mutex = PTHREAD_MUTEX_INITIALIZER;
+static atsc3_af_packet_capture_context_t* atsc3_af_packet_capture_contexts[ATSC3_AF_PACKET_CAPTURE_WORKERS_MAX];
+
+bool atsc3_af_packet_capture_is_dev(const char* dev) {
+	return dev && !strncmp(dev, ATSC3_AF_PACKET_CAPTURE_DEV_PREFIX, strlen(ATSC3_AF_PACKET_CAPTURE_DEV_PREFIX));
+}
+
+static void atsc3_af_packet_capture_statistics_add(atsc3_af_packet_capture_statistics_t* to, atsc3_af_packet_capture_statistics_t* from) {
+	to->frames_received += from->frames_received;
+	to->bytes_received += from->bytes_received;
+	to->blocks_received += from->blocks_received;
+	to->kernel_packets += from->kernel_packets;
+	to->kernel_drops += from->kernel_drops;
+	to->kernel_freeze_q_cnt += from->kernel_freeze_q_cnt;
+}
+
+static void atsc3_af_packet_capture_register(atsc3_af_packet_capture_context_t* atsc3_af_packet_capture_context) {
+	pthread_mutex_lock(&atsc3_af_packet_capture_contexts_mutex);
+	for(int i = 0; i < ATSC3_AF_PACKET_CAPTURE_WORKERS_MAX; i++) {
+		if(!atsc3_af_packet_capture_contexts[i]) {
+			atsc3_af_packet_capture_contexts[i] = atsc3_af_packet_capture_context;
+			break;
+		}
+	}
+	pthread_mutex_unlock(&atsc3_af_packet_capture_contexts_mutex);
+}
+
+static void atsc3_af_packet_capture_unregister(atsc3_af_packet_capture_context_t* atsc3_af_packet_capture_context) {
+	pthread_mutex_lock(&atsc3_af_packet_capture_contexts_mutex);
+	for(int i = 0; i < ATSC3_AF_PACKET_CAPTURE_WORKERS_MAX; i++) {
+		if(atsc3_af_packet_capture_contexts[i] == atsc3_af_packet_capture_context) {
+			atsc3_af_packet_capture_contexts[i] = NULL;
+			atsc3_af_packet_capture_statistics_add(&atsc3_af_packet_capture_statistics_released, &atsc3_af_packet_capture_context->statistics);
+			break;
+		}
+	}
+	pthread_mutex_unlock(&atsc3_af_packet_capture_contexts_mutex);
+}
+
+void atsc3_af_packet_capture_statistics_get(atsc3_af_packet_capture_statistics_t* atsc3_af_packet_capture_statistics) {
+	pthread_mutex_lock(&atsc3_af_packet_capture_contexts_mutex);
+	*atsc3_af_packet_capture_statistics = atsc3_af_packet_capture_statistics_released;
+	for(int i = 0; i < ATSC3_AF_PACKET_CAPTURE_WORKERS_MAX; i++) {
+		if(atsc3_af_packet_capture_contexts[i]) {
+			atsc3_af_packet_capture_statistics_add(atsc3_af_packet_capture_statistics, &atsc3_af_packet_capture_contexts[i]->statistics);
+		}
+	}
+	pthread_mutex_unlock(&atsc3_af_packet_capture_contexts_mutex);
+}
+
+bool atsc3_af_packet_capture_is_running() {
+	bool is_running = false;
+	pthread_mutex_lock(&atsc3_af_packet_capture_contexts_mutex);
+	for(int i = 0; i < ATSC3_AF_PACKET_CAPTURE_WORKERS_MAX && !is_running; i++) {
+		is_running = atsc3_af_packet_capture_contexts[i] != NULL;
+	}
+	pthread_mutex_unlock(&atsc3_af_packet_capture_contexts_mutex);
+	return is_running;
+}
+
+void atsc3_af_packet_capture_breakloop(atsc3_af_packet_capture_context_t* atsc3_af_packet_capture_context) {
+	atsc3_af_packet_capture_context->breakloop = 1;
+}
+
+void atsc3_af_packet_capture_batch_to_pcap_handler(atsc3_af_packet_capture_context_t* atsc3_af_packet_capture_context, atsc3_af_packet_frame_t* frames, uint32_t frames_n) {
+	for(uint32_t i = 0; i < frames_n; i++) {
+		atsc3_af_packet_capture_context->pcap_callback(NULL, &frames[i].pkthdr, frames[i].packet);
+	}
+}
+
+#if defined(__linux__)
+
+/**
+ * ipv4/udp with a multicast destination, ethernet framing:
+ *
+ * 	ldh [12]; jeq #0x0800
+ * 	ldb [23]; jeq #17
+ * 	ld  [30]; and #0xf0000000; jeq #0xe0000000
+ */
+static struct sock_filter atsc3_af_packet_capture_filter_multicast_udp[] = {
+	BPF_STMT(BPF_LD  | BPF_H   | BPF_ABS, 12),
+	BPF_JUMP(BPF_JMP | BPF_JEQ | BPF_K, ETH_P_IP, 0, 6),
+	BPF_STMT(BPF_LD  | BPF_B   | BPF_ABS, 23),
+	BPF_JUMP(BPF_JMP | BPF_JEQ | BPF_K, IPPROTO_UDP, 0, 4),
+	BPF_STMT(BPF_LD  | BPF_W   | BPF_ABS, 30),
+	BPF_STMT(BPF_ALU | BPF_AND | BPF_K, 0xf0000000),
+	BPF_JUMP(BPF_JMP | BPF_JEQ | BPF_K, 0xe0000000, 0, 1),
+	BPF_STMT(BPF_RET | BPF_K, 0x40000),
+	BPF_STMT(BPF_RET | BPF_K, 0),
+};
+
+atsc3_af_packet_capture_context_t* atsc3_af_packet_capture_open(const char* ifname, uint16_t fanout_group_id) {
+	int version = TPACKET_V3;
+	struct tpacket_req3 req;
+	struct sockaddr_ll sll;
+	struct sock_fprog fprog;
+
+	unsigned int ifindex = if_nametoindex(ifname);
+	if(!ifindex) {
+		__AF_PACKET_CAPTURE_ERROR("if_nametoindex: %s: %s", ifname, strerror(errno));
+		return NULL;
+	}
+
+	atsc3_af_packet_capture_context_t* atsc3_af_packet_capture_context = (atsc3_af_packet_capture_context_t*)calloc(1, sizeof(atsc3_af_packet_capture_context_t));
+	atsc3_af_packet_capture_context->ifname = strdup(ifname);
+	atsc3_af_packet_capture_context->block_size = ATSC3_AF_PACKET_CAPTURE_BLOCK_SIZE;
+	atsc3_af_packet_capture_context->block_nr = ATSC3_AF_PACKET_CAPTURE_BLOCK_NR;
+	atsc3_af_packet_capture_context->ring = (uint8_t*)MAP_FAILED;
+
+	atsc3_af_packet_capture_context->fd = socket(AF_PACKET, SOCK_RAW, htons(ETH_P_ALL));
+	if(atsc3_af_packet_capture_context->fd < 0) {
+		__AF_PACKET_CAPTURE_ERROR("socket(AF_PACKET): %s, CAP_NET_RAW is required", strerror(errno));
+		goto error;
+	}
+
+	//attach the filter before bind so no unfiltered frames are queued
+	fprog.len = sizeof(atsc3_af_packet_capture_filter_multicast_udp) / sizeof(struct sock_filter);
+	fprog.filter = atsc3_af_packet_capture_filter_multicast_udp;
+	if(setsockopt(atsc3_af_packet_capture_context->fd, SOL_SOCKET, SO_ATTACH_FILTER, &fprog, sizeof(fprog)) < 0) {
+		__AF_PACKET_CAPTURE_ERROR("SO_ATTACH_FILTER: %s", strerror(errno));
+		goto error;
+	}
+
+	if(setsockopt(atsc3_af_packet_capture_context->fd, SOL_PACKET, PACKET_VERSION, &version, sizeof(version)) < 0) {
+		__AF_PACKET_CAPTURE_ERROR("PACKET_VERSION TPACKET_V3: %s", strerror(errno));
+		goto error;
+	}
+
+	memset(&req, 0, sizeof(req));
+	req.tp_block_size = atsc3_af_packet_capture_context->block_size;
+	req.tp_block_nr = atsc3_af_packet_capture_context->block_nr;
+	req.tp_frame_size = ATSC3_AF_PACKET_CAPTURE_FRAME_SIZE;
+	req.tp_frame_nr = (req.tp_block_size * req.tp_block_nr) / req.tp_frame_size;
+	req.tp_retire_blk_tov = ATSC3_AF_PACKET_CAPTURE_BLOCK_TIMEOUT_MS;
+	req.tp_feature_req_word = TP_FT_REQ_FILL_RXHASH;
+
+	if(setsockopt(atsc3_af_packet_capture_context->fd, SOL_PACKET, PACKET_RX_RING, &req, sizeof(req)) < 0) {
+		__AF_PACKET_CAPTURE_ERROR("PACKET_RX_RING: %s", strerror(errno));
+		goto error;
+	}
+
+	atsc3_af_packet_capture_context->ring_len = (size_t)req.tp_block_size * req.tp_block_nr;
+	atsc3_af_packet_capture_context->ring = (uint8_t*)mmap(NULL, atsc3_af_packet_capture_context->ring_len, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_LOCKED, atsc3_af_packet_capture_context->fd, 0);
+	if(atsc3_af_packet_capture_context->ring == MAP_FAILED) {
+		//MAP_LOCKED needs RLIMIT_MEMLOCK headroom, fall back to a pageable ring
+		atsc3_af_packet_capture_context->ring = (uint8_t*)mmap(NULL, atsc3_af_packet_capture_context->ring_len, PROT_READ | PROT_WRITE, MAP_SHARED, atsc3_af_packet_capture_context->fd, 0);
+	}
+	if(atsc3_af_packet_capture_context->ring == MAP_FAILED) {
+		__AF_PACKET_CAPTURE_ERROR("mmap rx ring: %s", strerror(errno));
+		goto error;
+	}
+
+	memset(&sll, 0, sizeof(sll));
+	sll.sll_family = AF_PACKET;
+	sll.sll_protocol = htons(ETH_P_ALL);
+	sll.sll_ifindex = ifindex;
+	if(bind(atsc3_af_packet_capture_context->fd, (struct sockaddr*)&sll, sizeof(sll)) < 0) {
+		__AF_PACKET_CAPTURE_ERROR("bind: %s: %s", ifname, strerror(errno));
+		goto error;
+	}
+
+	if(fanout_group_id) {
+		int fanout = fanout_group_id | ((PACKET_FANOUT_HASH | PACKET_FANOUT_FLAG_DEFRAG) << 16);
+		if(setsockopt(atsc3_af_packet_capture_context->fd, SOL_PACKET, PACKET_FANOUT, &fanout, sizeof(fanout)) < 0) {
+			__AF_PACKET_CAPTURE_ERROR("PACKET_FANOUT group: %u: %s", fanout_group_id, strerror(errno));
+			goto error;
+		}
+	}
+
+	atsc3_af_packet_capture_register(atsc3_af_packet_capture_context);
+
+	__AF_PACKET_CAPTURE_INFO("af_packet capture: %s, TPACKET_V3 ring: %u blocks of %u bytes, fanout group: %u",
+			ifname, atsc3_af_packet_capture_context->block_nr, atsc3_af_packet_capture_context->block_size, fanout_group_id);
+
+	return atsc3_af_packet_capture_context;
+
+error:
+	atsc3_af_packet_capture_free(&atsc3_af_packet_capture_context);
+	return NULL;
+}
+
+//PACKET_STATISTICS is reset by the kernel on every read
+static void atsc3_af_packet_capture_update_kernel_statistics(atsc3_af_packet_capture_context_t* atsc3_af_packet_capture_context) {
+	struct tpacket_stats_v3 tp_stats;
+	socklen_t tp_stats_len = sizeof(tp_stats);
+
+	if(getsockopt(atsc3_af_packet_capture_context->fd, SOL_PACKET, PACKET_STATISTICS, &tp_stats, &tp_stats_len) == 0) {
+		atsc3_af_packet_capture_context->statistics.kernel_packets += tp_stats.tp_packets;
+		atsc3_af_packet_capture_context->statistics.kernel_drops += tp_stats.tp_drops;
+		atsc3_af_packet_capture_context->statistics.kernel_freeze_q_cnt += tp_stats.tp_freeze_q_cnt;
+	}
+}
+
+static uint32_t atsc3_af_packet_capture_process_block(atsc3_af_packet_capture_context_t* atsc3_af_packet_capture_context, struct tpacket_block_desc* block_desc) {
+	uint32_t num_pkts = block_desc->hdr.bh1.num_pkts;
+	uint32_t frames_n = 0;
+	struct tpacket3_hdr* tp3_hdr = (struct tpacket3_hdr*)((uint8_t*)block_desc + block_desc->hdr.bh1.offset_to_first_pkt);
+
+	for(uint32_t i = 0; i < num_pkts; i++) {
+		atsc3_af_packet_frame_t* frame = &atsc3_af_packet_capture_context->frames[frames_n++];
+
+		frame->pkthdr.ts.tv_sec = tp3_hdr->tp_sec;
+		frame->pkthdr.ts.tv_usec = tp3_hdr->tp_nsec / 1000;
+		frame->pkthdr.caplen = tp3_hdr->tp_snaplen;
+		frame->pkthdr.len = tp3_hdr->tp_len;
+		frame->packet = (const u_char*)tp3_hdr + tp3_hdr->tp_mac;
+
+		atsc3_af_packet_capture_context->statistics.bytes_received += tp3_hdr->tp_snaplen;
+
+		if(frames_n == ATSC3_AF_PACKET_CAPTURE_BATCH_MAX) {
+			atsc3_af_packet_capture_context->batch_callback(atsc3_af_packet_capture_context, atsc3_af_packet_capture_context->frames, frames_n);
+			frames_n = 0;
+		}
+
+		tp3_hdr = (struct tpacket3_hdr*)((uint8_t*)tp3_hdr + tp3_hdr->tp_next_offset);
+	}
+
+	if(frames_n) {
+		atsc3_af_packet_capture_context->batch_callback(atsc3_af_packet_capture_context, atsc3_af_packet_capture_context->frames, frames_n);
+	}
+
+	atsc3_af_packet_capture_context->statistics.frames_received += num_pkts;
+	atsc3_af_packet_capture_context->statistics.blocks_received++;
+
+	return num_pkts;
+}
+
+int64_t atsc3_af_packet_capture_loop(atsc3_af_packet_capture_context_t* atsc3_af_packet_capture_context, atsc3_af_packet_capture_batch_f batch_callback, void* user) {
+	struct pollfd pfd;
+	int64_t frames_delivered = 0;
+
+	atsc3_af_packet_capture_context->batch_callback = batch_callback;
+	atsc3_af_packet_capture_context->user = user;
+
+	memset(&pfd, 0, sizeof(pfd));
+	pfd.fd = atsc3_af_packet_capture_context->fd;
+	pfd.events = POLLIN | POLLERR;
+
+	while(!atsc3_af_packet_capture_context->breakloop) {
+		struct tpacket_block_desc* block_desc = (struct tpacket_block_desc*)(atsc3_af_packet_capture_context->ring + (size_t)atsc3_af_packet_capture_context->block_index * atsc3_af_packet_capture_context->block_size);
+
+		if(!(__atomic_load_n(&block_desc->hdr.bh1.block_status, __ATOMIC_ACQUIRE) & TP_STATUS_USER)) {
+			int ret = poll(&pfd, 1, ATSC3_AF_PACKET_CAPTURE_POLL_TIMEOUT_MS);
+			if(ret < 0 && errno != EINTR) {
+				__AF_PACKET_CAPTURE_ERROR("poll: %s: %s", atsc3_af_packet_capture_context->ifname, strerror(errno));
+				return -1;
+			}
+			if(ret == 0) {
+				atsc3_af_packet_capture_update_kernel_statistics(atsc3_af_packet_capture_context);
+			}
+			continue;
+		}
+
+		frames_delivered += atsc3_af_packet_capture_process_block(atsc3_af_packet_capture_context, block_desc);
+
+		//hand the block back to the kernel
+		__atomic_store_n(&block_desc->hdr.bh1.block_status, TP_STATUS_KERNEL, __ATOMIC_RELEASE);
+		atsc3_af_packet_capture_context->block_index = (atsc3_af_packet_capture_context->block_index + 1) % atsc3_af_packet_capture_context->block_nr;
+
+		atsc3_af_packet_capture_update_kernel_statistics(atsc3_af_packet_capture_context);
+	}
+
+	return frames_delivered;
+}
+
+void atsc3_af_packet_capture_free(atsc3_af_packet_capture_context_t** atsc3_af_packet_capture_context_p) {
+	if(atsc3_af_packet_capture_context_p) {
+		atsc3_af_packet_capture_context_t* atsc3_af_packet_capture_context = *atsc3_af_packet_capture_context_p;
+		if(atsc3_af_packet_capture_context) {
+			atsc3_af_packet_capture_unregister(atsc3_af_packet_capture_context);
+
+			if(atsc3_af_packet_capture_context->ring != MAP_FAILED) {
+				munmap(atsc3_af_packet_capture_context->ring, atsc3_af_packet_capture_context->ring_len);
+			}
+			if(atsc3_af_packet_capture_context->fd >= 0) {
+				close(atsc3_af_packet_capture_context->fd);
+			}
+			freesafe(atsc3_af_packet_capture_context->ifname);
+			free(atsc3_af_packet_capture_context);
+		}
+		*atsc3_af_packet_capture_context_p = NULL;
+	}
+}
+
+#else
+
+atsc3_af_packet_capture_context_t* atsc3_af_packet_capture_open(const char* ifname, uint16_t fanout_group_id) {
+	__AF_PACKET_CAPTURE_ERROR("af_packet capture is only available on linux, unable to open: %s", ifname);
+	return NULL;
+}
+
+int64_t atsc3_af_packet_capture_loop(atsc3_af_packet_capture_context_t* atsc3_af_packet_capture_context, atsc3_af_packet_capture_batch_f batch_callback, void* user) {
+	return -1;
+}
+
+void atsc3_af_packet_capture_free(atsc3_af_packet_capture_context_t** atsc3_af_packet_capture_context_p) {
+	if(atsc3_af_packet_capture_context_p && *atsc3_af_packet_capture_context_p) {
+		atsc3_af_packet_capture_unregister(*atsc3_af_packet_capture_context_p);
+		freesafe((*atsc3_af_packet_capture_context_p)->ifname);
+		free(*atsc3_af_packet_capture_context_p);
+		*atsc3_af_packet_capture_context_p = NULL;
+	}
+}
+
+#endif
+
+int atsc3_af_packet_capture_run(const char* dev, pcap_handler callback) {
+	const char* ifname = atsc3_af_packet_capture_is_dev(dev) ? dev + strlen(ATSC3_AF_PACKET_CAPTURE_DEV_PREFIX) : dev;
+
+	atsc3_af_packet_capture_context_t* atsc3_af_packet_capture_context = atsc3_af_packet_capture_open(ifname, 0);
+	if(!atsc3_af_packet_capture_context) {
+		return -1;
+	}
+
+	atsc3_af_packet_capture_context->pcap_callback = callback;
+	int64_t ret = atsc3_af_packet_capture_loop(atsc3_af_packet_capture_context, atsc3_af_packet_capture_batch_to_pcap_handler, NULL);
+	atsc3_af_packet_capture_free(&atsc3_af_packet_capture_context);
+
+	return ret < 0 ? -1 : 0;
+}
+
+static void* atsc3_af_packet_capture_worker_run_thread(void* atsc3_af_packet_capture_context_pointer) {
+	atsc3_af_packet_capture_context_t* atsc3_af_packet_capture_context = (atsc3_af_packet_capture_context_t*)atsc3_af_packet_capture_context_pointer;
+	atsc3_af_packet_capture_loop(atsc3_af_packet_capture_context, atsc3_af_packet_capture_context->batch_callback, atsc3_af_packet_capture_context->user);
+	return NULL;
+}
+
+int atsc3_af_packet_capture_fanout_run(const char* ifname, uint32_t workers_n, atsc3_af_packet_capture_batch_f batch_callback, void* user) {
+	atsc3_af_packet_capture_context_t* workers[ATSC3_AF_PACKET_CAPTURE_WORKERS_MAX] = { NULL };
+	pthread_t worker_thread_ids[ATSC3_AF_PACKET_CAPTURE_WORKERS_MAX];
+	uint16_t fanout_group_id = (getpid() & 0xFFFF) ? (getpid() & 0xFFFF) : 1;
+	uint32_t workers_started = 0;
+	int ret = 0;
+
+	if(!workers_n || workers_n > ATSC3_AF_PACKET_CAPTURE_WORKERS_MAX) {
+		__AF_PACKET_CAPTURE_ERROR("fanout workers: %u, must be 1-%u", workers_n, ATSC3_AF_PACKET_CAPTURE_WORKERS_MAX);
+		return -1;
+	}
+
+	//open every socket up front so a failure is reported before any worker runs
+	for(uint32_t i = 0; i < workers_n; i++) {
+		workers[i] = atsc3_af_packet_capture_open(ifname, fanout_group_id);
+		if(!workers[i]) {
+			ret = -1;
+			goto cleanup;
+		}
+		workers[i]->worker_index = i;
+		workers[i]->batch_callback = batch_callback;
+		workers[i]->user = user;
+	}
+
+	for(; workers_started < workers_n; workers_started++) {
+		if(pthread_create(&worker_thread_ids[workers_started], NULL, atsc3_af_packet_capture_worker_run_thread, workers[workers_started])) {
+			__AF_PACKET_CAPTURE_ERROR("unable to start fanout worker: %u", workers_started);
+			ret = -1;
+			break;
+		}
+	}
+
+	if(ret) {
+		for(uint32_t i = 0; i < workers_started; i++) {
+			atsc3_af_packet_capture_breakloop(workers[i]);
+		}
+	}
+
+	for(uint32_t i = 0; i < workers_started; i++) {
+		pthread_join(worker_thread_ids[i], NULL);
+	}
+
+cleanup:
+	for(uint32_t i = 0; i < workers_n; i++) {
+		atsc3_af_packet_capture_free(&workers[i]);
+	}
+
+	return ret;
+}
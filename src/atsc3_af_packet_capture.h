@@ -0,0 +1,132 @@
+/*
+ * atsc3_af_packet_capture.h
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: jjustman
+ *
+ * native linux live capture backend, AF_PACKET with a TPACKET_V3 block mapped rx ring
+ *
+ * the kernel fills whole blocks of frames into a ring shared with userspace, we poll() for a retired block,
+ * hand its frames to a batch callback in chunks of ATSC3_AF_PACKET_CAPTURE_BATCH_MAX and return the block
+ * to the kernel, no copy and no syscall per packet as with pcap_open_live(..., 0, ...) + pcap_loop
+ *
+ * 	filtering:	a classic BPF program on the socket only passes ipv4/udp to 224.0.0.0/4, i.e. LLS (224.0.23.60)
+ * 				and the 239.255.x.x SLS/MMT/ROUTE ranges, everything else is dropped in the kernel
+ *
+ * 	fanout:		atsc3_af_packet_capture_fanout_run() opens one socket per worker thread in the same PACKET_FANOUT_HASH
+ * 				group, so each ip/udp flow is always delivered to the same worker. the batch callback is then invoked
+ * 				concurrently for different flows and must not touch shared receive chain state without locking
+ *
+ * 	stats:		PACKET_STATISTICS is read after every block, kernel drops (ring full) and freeze queue counts
+ * 				(blocks the kernel had to skip) are accumulated per context and in atsc3_af_packet_capture_statistics_get()
+ *
+ * listener tools select this backend in place of libpcap with a dev of af_packet:<interface>, see
+ * atsc3_af_packet_capture_is_dev(), and deliver to their existing pcap_handler with atsc3_af_packet_capture_run()
+ *
+ * on non-linux platforms atsc3_af_packet_capture_open() returns NULL
+ */
+
+#include <pcap.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <signal.h>
+
+#include "atsc3_utils.h"
+#include "atsc3_logging.h"
+#include "atsc3_listener_udp.h"
+
+#ifndef ATSC3_AF_PACKET_CAPTURE_H_
+#define ATSC3_AF_PACKET_CAPTURE_H_
+
+#if defined (__cplusplus)
+extern "C" {
+#endif
+
+#define ATSC3_AF_PACKET_CAPTURE_DEV_PREFIX			"af_packet:"
+
+#define ATSC3_AF_PACKET_CAPTURE_BLOCK_SIZE			(1 << 20)
+#define ATSC3_AF_PACKET_CAPTURE_BLOCK_NR			64
+#define ATSC3_AF_PACKET_CAPTURE_FRAME_SIZE			2048
+//retire a partially filled block after this timeout, keeps latency bounded at low bitrates
+#define ATSC3_AF_PACKET_CAPTURE_BLOCK_TIMEOUT_MS	4
+#define ATSC3_AF_PACKET_CAPTURE_POLL_TIMEOUT_MS		100
+
+#define ATSC3_AF_PACKET_CAPTURE_BATCH_MAX			256
+#define ATSC3_AF_PACKET_CAPTURE_WORKERS_MAX			16
+
+typedef struct atsc3_af_packet_frame {
+	struct pcap_pkthdr	pkthdr;
+	const u_char*		packet;
+} atsc3_af_packet_frame_t;
+
+typedef struct atsc3_af_packet_capture_statistics {
+	uint64_t	frames_received;
+	uint64_t	bytes_received;
+	uint64_t	blocks_received;
+	uint64_t	kernel_packets;			//tp_packets, passed the filter
+	uint64_t	kernel_drops;			//tp_drops, ring full
+	uint64_t	kernel_freeze_q_cnt;	//tp_freeze_q_cnt, blocks skipped while the ring was frozen
+} atsc3_af_packet_capture_statistics_t;
+
+typedef struct atsc3_af_packet_capture_context atsc3_af_packet_capture_context_t;
+
+//frames are only valid for the duration of the callback, the block is returned to the kernel afterwards
+typedef void (*atsc3_af_packet_capture_batch_f)(atsc3_af_packet_capture_context_t* atsc3_af_packet_capture_context, atsc3_af_packet_frame_t* frames, uint32_t frames_n);
+
+struct atsc3_af_packet_capture_context {
+	char*								ifname;
+	int									fd;
+	uint32_t							worker_index;
+
+	//mmap'd TPACKET_V3 rx ring
+	uint8_t*							ring;
+	size_t								ring_len;
+	uint32_t							block_size;
+	uint32_t							block_nr;
+	uint32_t							block_index;
+
+	atsc3_af_packet_capture_batch_f		batch_callback;
+	pcap_handler						pcap_callback;
+	void*								user;
+
+	atsc3_af_packet_frame_t				frames[ATSC3_AF_PACKET_CAPTURE_BATCH_MAX];
+
+	volatile sig_atomic_t				breakloop;
+
+	atsc3_af_packet_capture_statistics_t	statistics;
+};
+
+bool atsc3_af_packet_capture_is_dev(const char* dev);
+
+//fanout_group_id 0 does not join a fanout group
+atsc3_af_packet_capture_context_t* atsc3_af_packet_capture_open(const char* ifname, uint16_t fanout_group_id);
+
+//returns the number of frames delivered to batch_callback, or -1 on a socket error
+int64_t atsc3_af_packet_capture_loop(atsc3_af_packet_capture_context_t* atsc3_af_packet_capture_context, atsc3_af_packet_capture_batch_f batch_callback, void* user);
+void atsc3_af_packet_capture_breakloop(atsc3_af_packet_capture_context_t* atsc3_af_packet_capture_context);
+
+void atsc3_af_packet_capture_free(atsc3_af_packet_capture_context_t** atsc3_af_packet_capture_context_p);
+
+//batch callback adapter, delivers each frame to atsc3_af_packet_capture_context->pcap_callback with a NULL user
+void atsc3_af_packet_capture_batch_to_pcap_handler(atsc3_af_packet_capture_context_t* atsc3_af_packet_capture_context, atsc3_af_packet_frame_t* frames, uint32_t frames_n);
+
+//open dev (af_packet:<interface>) and deliver every frame to callback on the calling thread, for listener tools
+int atsc3_af_packet_capture_run(const char* dev, pcap_handler callback);
+
+//one socket and thread per worker in a hash fanout group, blocks until all workers exit
+int atsc3_af_packet_capture_fanout_run(const char* ifname, uint32_t workers_n, atsc3_af_packet_capture_batch_f batch_callback, void* user);
+
+//summed across all open and released contexts
+void atsc3_af_packet_capture_statistics_get(atsc3_af_packet_capture_statistics_t* atsc3_af_packet_capture_statistics);
+bool atsc3_af_packet_capture_is_running();
+
+#if defined (__cplusplus)
+}
+#endif
+
+#define __AF_PACKET_CAPTURE_ERROR(...)   __ATSC3_LOG_ERROR(ATSC3_LOG_MODULE_AF_PACKET_CAPTURE, __VA_ARGS__)
+#define __AF_PACKET_CAPTURE_WARN(...)    __ATSC3_LOG_WARN(ATSC3_LOG_MODULE_AF_PACKET_CAPTURE, __VA_ARGS__)
+#define __AF_PACKET_CAPTURE_INFO(...)    __ATSC3_LOG_INFO(ATSC3_LOG_MODULE_AF_PACKET_CAPTURE, __VA_ARGS__)
+
+#endif /* ATSC3_AF_PACKET_CAPTURE_H_ */
@@ -0,0 +1,353 @@
+/*
+ * atsc3_alc_object_tracker.c
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: jjustman
+ */
+
+#include "atsc3_alc_object_tracker.h"
+
+#define __BYTE_RANGE_SET_INITIAL_SIZE 8
+
+atsc3_alc_object_tracker_stats_t atsc3_alc_object_tracker_stats;
+
+//first range with end >= offset, i.e. the first one that overlaps or touches a range starting at offset
+static uint32_t __byte_range_set_lower_bound(atsc3_byte_range_set_t* atsc3_byte_range_set, uint32_t offset) {
+	uint32_t lo = 0;
+	uint32_t hi = atsc3_byte_range_set->ranges_n;
+	while(lo < hi) {
+		uint32_t mid = lo + (hi - lo) / 2;
+		if(atsc3_byte_range_set->ranges[mid].end < offset) {
+			lo = mid + 1;
+		} else {
+			hi = mid;
+		}
+	}
+	return lo;
+}
+
+//first range with start > offset, from index lo
+static uint32_t __byte_range_set_upper_bound(atsc3_byte_range_set_t* atsc3_byte_range_set, uint32_t lo, uint32_t offset) {
+	uint32_t hi = atsc3_byte_range_set->ranges_n;
+	while(lo < hi) {
+		uint32_t mid = lo + (hi - lo) / 2;
+		if(atsc3_byte_range_set->ranges[mid].start <= offset) {
+			lo = mid + 1;
+		} else {
+			hi = mid;
+		}
+	}
+	return lo;
+}
+
+uint32_t atsc3_byte_range_set_add(atsc3_byte_range_set_t* atsc3_byte_range_set, uint32_t start, uint32_t len) {
+	if(!len) {
+		return 0;
+	}
+	uint64_t end64 = (uint64_t)start + len;
+	uint32_t end = end64 > UINT32_MAX ? UINT32_MAX : (uint32_t)end64;
+	atsc3_byte_range_t* ranges = atsc3_byte_range_set->ranges;
+	uint32_t n = atsc3_byte_range_set->ranges_n;
+
+	//in order delivery, extends the last range
+	if(n && start >= ranges[n - 1].start && start <= ranges[n - 1].end) {
+		if(end <= ranges[n - 1].end) {
+			return 0;
+		}
+		uint32_t added = end - ranges[n - 1].end;
+		ranges[n - 1].end = end;
+		atsc3_byte_range_set->covered += added;
+		return added;
+	}
+
+	//ranges [lo, hi) overlap or touch [start, end) and collapse into one
+	uint32_t lo = __byte_range_set_lower_bound(atsc3_byte_range_set, start);
+	uint32_t hi = __byte_range_set_upper_bound(atsc3_byte_range_set, lo, end);
+
+	if(lo == hi) {
+		if(n == atsc3_byte_range_set->ranges_size) {
+			atsc3_byte_range_set->ranges_size = n ? n * 2 : __BYTE_RANGE_SET_INITIAL_SIZE;
+			atsc3_byte_range_set->ranges = (atsc3_byte_range_t*)realloc(atsc3_byte_range_set->ranges, atsc3_byte_range_set->ranges_size * sizeof(atsc3_byte_range_t));
+			if(!atsc3_byte_range_set->ranges) {
+				abort();
+			}
+			ranges = atsc3_byte_range_set->ranges;
+		}
+		memmove(&ranges[lo + 1], &ranges[lo], (n - lo) * sizeof(atsc3_byte_range_t));
+		ranges[lo].start = start;
+		ranges[lo].end = end;
+		atsc3_byte_range_set->ranges_n++;
+		atsc3_byte_range_set->covered += end - start;
+		return end - start;
+	}
+
+	uint64_t overlapped = 0;
+	for(uint32_t i = lo; i < hi; i++) {
+		overlapped += ranges[i].end - ranges[i].start;
+	}
+	uint32_t merged_start = start < ranges[lo].start ? start : ranges[lo].start;
+	uint32_t merged_end = end > ranges[hi - 1].end ? end : ranges[hi - 1].end;
+	uint32_t added = (uint32_t)((merged_end - merged_start) - overlapped);
+
+	ranges[lo].start = merged_start;
+	ranges[lo].end = merged_end;
+	memmove(&ranges[lo + 1], &ranges[hi], (n - hi) * sizeof(atsc3_byte_range_t));
+	atsc3_byte_range_set->ranges_n -= hi - lo - 1;
+	atsc3_byte_range_set->covered += added;
+
+	return added;
+}
+
+bool atsc3_byte_range_set_covers(atsc3_byte_range_set_t* atsc3_byte_range_set, uint32_t start, uint32_t end) {
+	if(start >= end) {
+		return true;
+	}
+	uint32_t i = __byte_range_set_lower_bound(atsc3_byte_range_set, start);
+	return i < atsc3_byte_range_set->ranges_n && atsc3_byte_range_set->ranges[i].start <= start && atsc3_byte_range_set->ranges[i].end >= end;
+}
+
+void atsc3_byte_range_set_clear(atsc3_byte_range_set_t* atsc3_byte_range_set) {
+	atsc3_byte_range_set->ranges_n = 0;
+	atsc3_byte_range_set->covered = 0;
+}
+
+void atsc3_byte_range_set_free(atsc3_byte_range_set_t* atsc3_byte_range_set) {
+	free(atsc3_byte_range_set->ranges);
+	memset(atsc3_byte_range_set, 0, sizeof(atsc3_byte_range_set_t));
+}
+
+//fibonacci hashing, mid bits as TOIs are mostly sequential
+static inline uint32_t __alc_object_cache_bucket(uint32_t tsi, uint32_t toi) {
+	return ((toi ^ (tsi << 20)) * 2654435769u >> 12) & (ATSC3_ALC_OBJECT_CACHE_BUCKETS - 1);
+}
+
+static atsc3_alc_object_cache_entry_t* __alc_object_cache_find(atsc3_alc_object_cache_t* atsc3_alc_object_cache, uint32_t tsi, uint32_t toi) {
+	uint16_t i = atsc3_alc_object_cache->buckets[__alc_object_cache_bucket(tsi, toi)];
+	while(i) {
+		atsc3_alc_object_cache_entry_t* atsc3_alc_object_cache_entry = &atsc3_alc_object_cache->entries[i - 1];
+		if(atsc3_alc_object_cache_entry->tsi == tsi && atsc3_alc_object_cache_entry->toi == toi) {
+			return atsc3_alc_object_cache_entry;
+		}
+		i = atsc3_alc_object_cache_entry->next;
+	}
+	return NULL;
+}
+
+static void __alc_object_cache_unlink(atsc3_alc_object_cache_t* atsc3_alc_object_cache, atsc3_alc_object_cache_entry_t* atsc3_alc_object_cache_entry) {
+	uint16_t index = (uint16_t)(atsc3_alc_object_cache_entry - atsc3_alc_object_cache->entries) + 1;
+	uint16_t* link = &atsc3_alc_object_cache->buckets[__alc_object_cache_bucket(atsc3_alc_object_cache_entry->tsi, atsc3_alc_object_cache_entry->toi)];
+	while(*link != index) {
+		link = &atsc3_alc_object_cache->entries[*link - 1].next;
+	}
+	*link = atsc3_alc_object_cache_entry->next;
+}
+
+//reuses the least recently used entry once the cache is full
+static atsc3_alc_object_cache_entry_t* __alc_object_cache_add(atsc3_alc_object_tracker_t* atsc3_alc_object_tracker, uint32_t tsi, uint32_t toi) {
+	atsc3_alc_object_cache_t* atsc3_alc_object_cache = &atsc3_alc_object_tracker->completed_cache;
+	atsc3_alc_object_cache_entry_t* atsc3_alc_object_cache_entry = NULL;
+
+	if(atsc3_alc_object_cache->entries_n < ATSC3_ALC_OBJECT_CACHE_MAX) {
+		atsc3_alc_object_cache_entry = &atsc3_alc_object_cache->entries[atsc3_alc_object_cache->entries_n++];
+	} else {
+		atsc3_alc_object_cache_entry = &atsc3_alc_object_cache->entries[0];
+		for(uint32_t i = 1; i < ATSC3_ALC_OBJECT_CACHE_MAX; i++) {
+			if(atsc3_alc_object_cache->entries[i].last_used < atsc3_alc_object_cache_entry->last_used) {
+				atsc3_alc_object_cache_entry = &atsc3_alc_object_cache->entries[i];
+			}
+		}
+		__alc_object_cache_unlink(atsc3_alc_object_cache, atsc3_alc_object_cache_entry);
+		atsc3_alc_object_tracker->cache_evicted++;
+		atsc3_alc_object_tracker_stats.cache_evicted++;
+	}
+
+	memset(atsc3_alc_object_cache_entry, 0, sizeof(atsc3_alc_object_cache_entry_t));
+	atsc3_alc_object_cache_entry->tsi = tsi;
+	atsc3_alc_object_cache_entry->toi = toi;
+
+	uint16_t* bucket = &atsc3_alc_object_cache->buckets[__alc_object_cache_bucket(tsi, toi)];
+	atsc3_alc_object_cache_entry->next = *bucket;
+	*bucket = (uint16_t)(atsc3_alc_object_cache_entry - atsc3_alc_object_cache->entries) + 1;
+
+	return atsc3_alc_object_cache_entry;
+}
+
+static void __alc_object_reset(atsc3_alc_object_t* atsc3_alc_object) {
+	atsc3_byte_range_set_clear(&atsc3_alc_object->received);
+	atsc3_alc_object->transfer_len = 0;
+	atsc3_alc_object->completed = false;
+	atsc3_alc_object->duplicate_bytes = 0;
+}
+
+atsc3_alc_object_tracker_t* atsc3_alc_object_tracker_new() {
+	return (atsc3_alc_object_tracker_t*)calloc(1, sizeof(atsc3_alc_object_tracker_t));
+}
+
+atsc3_alc_object_t* atsc3_alc_object_tracker_find(atsc3_alc_object_tracker_t* atsc3_alc_object_tracker, uint32_t tsi, uint32_t toi) {
+	for(uint32_t i = 0; i < atsc3_alc_object_tracker->objects_n; i++) {
+		atsc3_alc_object_t* atsc3_alc_object = &atsc3_alc_object_tracker->objects[i];
+		if(atsc3_alc_object->tsi == tsi && atsc3_alc_object->toi == toi) {
+			return atsc3_alc_object;
+		}
+	}
+	return NULL;
+}
+
+static atsc3_alc_object_t* __alc_object_tracker_add_object(atsc3_alc_object_tracker_t* atsc3_alc_object_tracker, uint32_t tsi, uint32_t toi) {
+	atsc3_alc_object_t* atsc3_alc_object = NULL;
+
+	if(atsc3_alc_object_tracker->objects_n < ATSC3_ALC_OBJECT_TRACKER_OBJECTS_MAX) {
+		atsc3_alc_object = &atsc3_alc_object_tracker->objects[atsc3_alc_object_tracker->objects_n++];
+	} else {
+		atsc3_alc_object = &atsc3_alc_object_tracker->objects[0];
+		for(uint32_t i = 1; i < ATSC3_ALC_OBJECT_TRACKER_OBJECTS_MAX; i++) {
+			if(atsc3_alc_object_tracker->objects[i].last_used < atsc3_alc_object->last_used) {
+				atsc3_alc_object = &atsc3_alc_object_tracker->objects[i];
+			}
+		}
+		if(!atsc3_alc_object->completed) {
+			atsc3_alc_object_tracker->objects_evicted++;
+			atsc3_alc_object_tracker_stats.objects_evicted++;
+		}
+	}
+
+	//keep the range array for reuse
+	__alc_object_reset(atsc3_alc_object);
+	atsc3_alc_object->tsi = tsi;
+	atsc3_alc_object->toi = toi;
+
+	return atsc3_alc_object;
+}
+
+atsc3_alc_object_event_t atsc3_alc_object_tracker_add(atsc3_alc_object_tracker_t* atsc3_alc_object_tracker, uint32_t tsi, uint32_t toi,
+		uint32_t start_offset, uint32_t len, uint64_t transfer_len, bool close_object_flag) {
+
+	atsc3_alc_object_t* atsc3_alc_object = atsc3_alc_object_tracker_find(atsc3_alc_object_tracker, tsi, toi);
+	if(!atsc3_alc_object) {
+		atsc3_alc_object = __alc_object_tracker_add_object(atsc3_alc_object_tracker, tsi, toi);
+	}
+	atsc3_alc_object->last_used = ++atsc3_alc_object_tracker->clock;
+
+	if(atsc3_alc_object->completed) {
+		atsc3_alc_object->duplicate_bytes += len;
+		atsc3_alc_object_tracker->duplicate_bytes += len;
+		atsc3_alc_object_tracker_stats.duplicate_bytes += len;
+		return ATSC3_ALC_OBJECT_EVENT_DUPLICATE;
+	}
+
+	uint32_t duplicate_len = len - atsc3_byte_range_set_add(&atsc3_alc_object->received, start_offset, len);
+	atsc3_alc_object->duplicate_bytes += duplicate_len;
+	atsc3_alc_object_tracker->duplicate_bytes += duplicate_len;
+	atsc3_alc_object_tracker_stats.duplicate_bytes += duplicate_len;
+
+	if(!atsc3_alc_object->transfer_len) {
+		if(transfer_len) {
+			atsc3_alc_object->transfer_len = transfer_len;
+		} else if(close_object_flag) {
+			atsc3_alc_object->transfer_len = (uint64_t)start_offset + len;
+		}
+	}
+
+	if(!atsc3_alc_object->transfer_len || atsc3_alc_object->received.covered < atsc3_alc_object->transfer_len ||
+			atsc3_alc_object->transfer_len > UINT32_MAX || !atsc3_byte_range_set_covers(&atsc3_alc_object->received, 0, (uint32_t)atsc3_alc_object->transfer_len)) {
+		return ATSC3_ALC_OBJECT_EVENT_NONE;
+	}
+
+	atsc3_alc_object_tracker->objects_completed++;
+	atsc3_alc_object_tracker_stats.objects_completed++;
+
+	//the next FDT-Instance re-uses TOI 0
+	if(!toi) {
+		__alc_object_reset(atsc3_alc_object);
+		return ATSC3_ALC_OBJECT_EVENT_COMPLETE;
+	}
+
+	atsc3_alc_object->completed = true;
+	atsc3_byte_range_set_clear(&atsc3_alc_object->received);
+
+	//SLS fragments on TSI 0 carry their version in the TOI, on any other TSI only an object its FDT-Instance announced with a
+	//Content-MD5 is cached, an unversioned one (e.g. the init segment) may be re-sent with new content under the same TOI
+	atsc3_alc_object_cache_entry_t* atsc3_alc_object_cache_entry = __alc_object_cache_find(&atsc3_alc_object_tracker->completed_cache, tsi, toi);
+	if(!atsc3_alc_object_cache_entry) {
+		if(tsi) {
+			return ATSC3_ALC_OBJECT_EVENT_COMPLETE;
+		}
+		atsc3_alc_object_cache_entry = __alc_object_cache_add(atsc3_alc_object_tracker, tsi, toi);
+	}
+	atsc3_alc_object_cache_entry->completed = true;
+	atsc3_alc_object_cache_entry->transfer_len = atsc3_alc_object->transfer_len;
+	atsc3_alc_object_cache_entry->last_used = ++atsc3_alc_object_tracker->completed_cache.clock;
+
+	return ATSC3_ALC_OBJECT_EVENT_COMPLETE;
+}
+
+bool atsc3_alc_object_tracker_is_repeat(atsc3_alc_object_tracker_t* atsc3_alc_object_tracker, uint32_t tsi, uint32_t toi, uint32_t len) {
+	if(!toi) {
+		return false;
+	}
+
+	atsc3_alc_object_cache_entry_t* atsc3_alc_object_cache_entry = __alc_object_cache_find(&atsc3_alc_object_tracker->completed_cache, tsi, toi);
+	if(!atsc3_alc_object_cache_entry || !atsc3_alc_object_cache_entry->completed) {
+		return false;
+	}
+
+	atsc3_alc_object_cache_entry->last_used = ++atsc3_alc_object_tracker->completed_cache.clock;
+	atsc3_alc_object_tracker->repeats_suppressed++;
+	atsc3_alc_object_tracker->repeat_bytes_saved += len;
+	atsc3_alc_object_tracker_stats.repeats_suppressed++;
+	atsc3_alc_object_tracker_stats.repeat_bytes_saved += len;
+	return true;
+}
+
+void atsc3_alc_object_tracker_announce_version(atsc3_alc_object_tracker_t* atsc3_alc_object_tracker, uint32_t tsi, uint32_t toi, uint32_t version) {
+	if(!toi || !version) {
+		return;
+	}
+
+	atsc3_alc_object_cache_entry_t* atsc3_alc_object_cache_entry = __alc_object_cache_find(&atsc3_alc_object_tracker->completed_cache, tsi, toi);
+	if(!atsc3_alc_object_cache_entry) {
+		//kept for when the object completes, or taken as is if it completed before its first announcement
+		atsc3_alc_object_cache_entry = __alc_object_cache_add(atsc3_alc_object_tracker, tsi, toi);
+		atsc3_alc_object_cache_entry->last_used = ++atsc3_alc_object_tracker->completed_cache.clock;
+
+		atsc3_alc_object_t* atsc3_alc_object = atsc3_alc_object_tracker_find(atsc3_alc_object_tracker, tsi, toi);
+		if(atsc3_alc_object && atsc3_alc_object->completed) {
+			atsc3_alc_object_cache_entry->completed = true;
+			atsc3_alc_object_cache_entry->transfer_len = atsc3_alc_object->transfer_len;
+		}
+	} else if(atsc3_alc_object_cache_entry->completed && atsc3_alc_object_cache_entry->version && atsc3_alc_object_cache_entry->version != version) {
+		atsc3_alc_object_cache_entry->completed = false;
+		atsc3_alc_object_tracker->objects_invalidated++;
+		atsc3_alc_object_tracker_stats.objects_invalidated++;
+
+		atsc3_alc_object_t* atsc3_alc_object = atsc3_alc_object_tracker_find(atsc3_alc_object_tracker, tsi, toi);
+		if(atsc3_alc_object) {
+			__alc_object_reset(atsc3_alc_object);
+		}
+	}
+
+	//an object completed before its first announcement takes the version as is
+	atsc3_alc_object_cache_entry->version = version;
+}
+
+void atsc3_alc_object_tracker_clear_completed(atsc3_alc_object_tracker_t* atsc3_alc_object_tracker) {
+	memset(&atsc3_alc_object_tracker->completed_cache, 0, sizeof(atsc3_alc_object_cache_t));
+	for(uint32_t i = 0; i < atsc3_alc_object_tracker->objects_n; i++) {
+		if(atsc3_alc_object_tracker->objects[i].completed) {
+			__alc_object_reset(&atsc3_alc_object_tracker->objects[i]);
+		}
+	}
+}
+
+void atsc3_alc_object_tracker_free(atsc3_alc_object_tracker_t** atsc3_alc_object_tracker_p) {
+	atsc3_alc_object_tracker_t* atsc3_alc_object_tracker = *atsc3_alc_object_tracker_p;
+	if(!atsc3_alc_object_tracker) {
+		return;
+	}
+
+	for(uint32_t i = 0; i < atsc3_alc_object_tracker->objects_n; i++) {
+		atsc3_byte_range_set_free(&atsc3_alc_object_tracker->objects[i].received);
+	}
+	free(atsc3_alc_object_tracker);
+	*atsc3_alc_object_tracker_p = NULL;
+}
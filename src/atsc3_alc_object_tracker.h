@@ -0,0 +1,159 @@
+/*
+ * atsc3_alc_object_tracker.h
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: jjustman
+ *
+ * object level completion tracking for ALC/ROUTE, per (TSI, TOI):
+ *
+ * 	received:		interval set of the byte ranges [start_offset, start_offset + alc_len) received so far, kept sorted and
+ * 					merged so coverage is known without scanning the object. a packet costs an O(log n) search over the
+ * 					disjoint ranges, in order delivery extends the last range in O(1)
+ * 	transfer_len:	from EXT_FTI / EXT_TOL on any packet of the object, or the end of the close object flag packet if the
+ * 					object never announces it
+ * 	completion:		ATSC3_ALC_OBJECT_EVENT_COMPLETE is returned exactly once, for the packet after which the received
+ * 					bytes cover [0, transfer_len). packets for an object that is already complete return
+ * 					ATSC3_ALC_OBJECT_EVENT_DUPLICATE
+ * 	duplicate bytes: bytes received more than once, per object and per tracker
+ *
+ * at most ATSC3_ALC_OBJECT_TRACKER_OBJECTS_MAX objects are tracked, the least recently used is evicted, same as the
+ * RaptorQ object decoders. completed objects keep their slot so carousel repeats are recognized until they are evicted.
+ *
+ * completed objects are also remembered in completed_cache, a hashed LRU of up to ATSC3_ALC_OBJECT_CACHE_MAX
+ * (TSI, TOI, version) entries, so the SLS and NRT objects a ROUTE carousel repeats are recognized from the LCT header
+ * of the first repeated packet, see atsc3_alc_object_tracker_is_repeat:
+ *
+ * 	TSI 0:			SLS fragments carry their version in the TOI, they are cached on completion
+ * 	other TSIs:		only cached once announced with a version, from the Content-MD5 of their FDT-Instance File entry, see
+ * 					atsc3_alc_object_tracker_announce_version. unversioned objects (e.g. the init segment of a media
+ * 					track) are never suppressed, the same TOI may be re-sent with new content of the same length.
+ * 					an announcement that differs from the version an object completed with drops it from the cache, so
+ * 					a TOI re-used for new content is received again
+ * 	TOI 0:			the FDT-Instance re-uses its TOI for every new instance, it is never cached and its slot is reset
+ * 					on completion
+ *
+ * not locked, owned by the thread parsing the ALC session.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifndef ATSC3_ALC_OBJECT_TRACKER_H_
+#define ATSC3_ALC_OBJECT_TRACKER_H_
+
+#if defined (__cplusplus)
+extern "C" {
+#endif
+
+#define ATSC3_ALC_OBJECT_TRACKER_OBJECTS_MAX 16
+#define ATSC3_ALC_OBJECT_CACHE_MAX 256
+//power of 2
+#define ATSC3_ALC_OBJECT_CACHE_BUCKETS 512
+
+//[start, end)
+typedef struct atsc3_byte_range {
+	uint32_t	start;
+	uint32_t	end;
+} atsc3_byte_range_t;
+
+//sorted, disjoint and non-adjacent ranges
+typedef struct atsc3_byte_range_set {
+	atsc3_byte_range_t*	ranges;
+	uint32_t			ranges_n;
+	uint32_t			ranges_size;
+	uint64_t			covered;		//total bytes in ranges
+} atsc3_byte_range_set_t;
+
+//returns the number of bytes of [start, start + len) that were not covered yet
+uint32_t atsc3_byte_range_set_add(atsc3_byte_range_set_t* atsc3_byte_range_set, uint32_t start, uint32_t len);
+bool atsc3_byte_range_set_covers(atsc3_byte_range_set_t* atsc3_byte_range_set, uint32_t start, uint32_t end);
+void atsc3_byte_range_set_clear(atsc3_byte_range_set_t* atsc3_byte_range_set);
+void atsc3_byte_range_set_free(atsc3_byte_range_set_t* atsc3_byte_range_set);
+
+typedef enum atsc3_alc_object_event {
+	ATSC3_ALC_OBJECT_EVENT_NONE = 0,
+	ATSC3_ALC_OBJECT_EVENT_COMPLETE,
+	ATSC3_ALC_OBJECT_EVENT_DUPLICATE,
+} atsc3_alc_object_event_t;
+
+typedef struct atsc3_alc_object {
+	uint32_t				tsi;
+	uint32_t				toi;
+	uint64_t				transfer_len;		//0 until known
+	bool					completed;
+	atsc3_byte_range_set_t	received;
+	uint64_t				duplicate_bytes;
+	uint64_t				last_used;
+} atsc3_alc_object_t;
+
+typedef struct atsc3_alc_object_cache_entry {
+	uint32_t	tsi;
+	uint32_t	toi;
+	uint32_t	version;			//0 until announced
+	bool		completed;			//false while the entry only holds an announced version
+	uint64_t	transfer_len;
+	uint64_t	last_used;
+	uint16_t	next;				//bucket chain, entry index + 1, 0 at the end
+} atsc3_alc_object_cache_entry_t;
+
+typedef struct atsc3_alc_object_cache {
+	atsc3_alc_object_cache_entry_t	entries[ATSC3_ALC_OBJECT_CACHE_MAX];
+	uint32_t						entries_n;
+	uint16_t						buckets[ATSC3_ALC_OBJECT_CACHE_BUCKETS];	//entry index + 1, 0 if empty
+	uint64_t						clock;
+} atsc3_alc_object_cache_t;
+
+typedef struct atsc3_alc_object_tracker {
+	atsc3_alc_object_t			objects[ATSC3_ALC_OBJECT_TRACKER_OBJECTS_MAX];
+	uint32_t					objects_n;
+	uint64_t					clock;
+
+	atsc3_alc_object_cache_t	completed_cache;
+	uint32_t					completed_cache_epoch;	//see alc_session_reset_object_cache
+
+	uint64_t					objects_completed;
+	uint64_t					objects_evicted;		//evicted before they completed
+	uint64_t					duplicate_bytes;
+
+	uint64_t					repeats_suppressed;		//packets of cached objects
+	uint64_t					repeat_bytes_saved;
+	uint64_t					objects_invalidated;	//cached objects re-announced with a new version
+	uint64_t					cache_evicted;
+} atsc3_alc_object_tracker_t;
+
+//totals over the trackers of every ALC session, for the global statistics, updated by the thread parsing the sessions
+typedef struct atsc3_alc_object_tracker_stats {
+	uint64_t	objects_completed;
+	uint64_t	objects_evicted;
+	uint64_t	duplicate_bytes;
+
+	uint64_t	repeats_suppressed;
+	uint64_t	repeat_bytes_saved;
+	uint64_t	objects_invalidated;
+	uint64_t	cache_evicted;
+} atsc3_alc_object_tracker_stats_t;
+
+extern atsc3_alc_object_tracker_stats_t atsc3_alc_object_tracker_stats;
+
+atsc3_alc_object_tracker_t* atsc3_alc_object_tracker_new();
+
+//transfer_len 0 if the packet does not carry it
+atsc3_alc_object_event_t atsc3_alc_object_tracker_add(atsc3_alc_object_tracker_t* atsc3_alc_object_tracker, uint32_t tsi, uint32_t toi,
+		uint32_t start_offset, uint32_t len, uint64_t transfer_len, bool close_object_flag);
+
+//true if tsi/toi completed already and is still cached, only the LCT header fields are needed. len is counted as saved
+bool atsc3_alc_object_tracker_is_repeat(atsc3_alc_object_tracker_t* atsc3_alc_object_tracker, uint32_t tsi, uint32_t toi, uint32_t len);
+//version of tsi/toi from its FDT-Instance File entry, non zero, makes an object on a TSI other than 0 eligible for the cache
+void atsc3_alc_object_tracker_announce_version(atsc3_alc_object_tracker_t* atsc3_alc_object_tracker, uint32_t tsi, uint32_t toi, uint32_t version);
+void atsc3_alc_object_tracker_clear_completed(atsc3_alc_object_tracker_t* atsc3_alc_object_tracker);
+
+atsc3_alc_object_t* atsc3_alc_object_tracker_find(atsc3_alc_object_tracker_t* atsc3_alc_object_tracker, uint32_t tsi, uint32_t toi);
+void atsc3_alc_object_tracker_free(atsc3_alc_object_tracker_t** atsc3_alc_object_tracker_p);
+
+#if defined (__cplusplus)
+}
+#endif
+
+#endif /* ATSC3_ALC_OBJECT_TRACKER_H_ */
@@ -0,0 +1,389 @@
+/*
+ *
+ * atsc3_alc_object_tracker_test.c:  driver for ALC byte range interval sets and object completion
+ *
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+
+#include "atsc3_alc_object_tracker.h"
+
+#define __OBJECT_TRACKER_TEST_TSI 100
+#define __OBJECT_TRACKER_TEST_SYMBOL_LEN 1400
+
+int test_byte_range_set_merge();
+int test_object_tracker_in_order();
+int test_object_tracker_out_of_order();
+int test_object_tracker_duplicates();
+int test_object_tracker_close_object_flag();
+int test_object_tracker_eviction();
+int test_object_tracker_carousel_repeats();
+int test_object_tracker_unversioned_not_cached();
+int test_object_tracker_version_announce();
+int test_object_tracker_cache_lru();
+
+int main() {
+	int failed = 0;
+
+	failed += test_byte_range_set_merge();
+	failed += test_object_tracker_in_order();
+	failed += test_object_tracker_out_of_order();
+	failed += test_object_tracker_duplicates();
+	failed += test_object_tracker_close_object_flag();
+	failed += test_object_tracker_eviction();
+	failed += test_object_tracker_carousel_repeats();
+	failed += test_object_tracker_unversioned_not_cached();
+	failed += test_object_tracker_version_announce();
+	failed += test_object_tracker_cache_lru();
+
+	printf("atsc3_alc_object_tracker_test: %s\n", failed ? "FAILED" : "OK");
+	return failed;
+}
+
+int test_byte_range_set_merge() {
+	atsc3_byte_range_set_t atsc3_byte_range_set = { 0 };
+	int failed = 0;
+
+	//[100, 200) [300, 400) [500, 600)
+	if(atsc3_byte_range_set_add(&atsc3_byte_range_set, 300, 100) != 100 || atsc3_byte_range_set_add(&atsc3_byte_range_set, 100, 100) != 100 ||
+			atsc3_byte_range_set_add(&atsc3_byte_range_set, 500, 100) != 100 || atsc3_byte_range_set.ranges_n != 3) {
+		printf("test_byte_range_set_merge: disjoint, ranges: %u\n", atsc3_byte_range_set.ranges_n);
+		failed = 1;
+	}
+
+	//[150, 550) bridges all three, 200 new bytes
+	uint32_t added = atsc3_byte_range_set_add(&atsc3_byte_range_set, 150, 400);
+	if(added != 200 || atsc3_byte_range_set.ranges_n != 1 || atsc3_byte_range_set.covered != 500 ||
+			atsc3_byte_range_set.ranges[0].start != 100 || atsc3_byte_range_set.ranges[0].end != 600) {
+		printf("test_byte_range_set_merge: bridge, added: %u, ranges: %u, covered: %llu\n", added, atsc3_byte_range_set.ranges_n, (unsigned long long)atsc3_byte_range_set.covered);
+		failed = 1;
+	}
+
+	//adjacent ranges collapse, covered subsets add nothing
+	if(atsc3_byte_range_set_add(&atsc3_byte_range_set, 0, 100) != 100 || atsc3_byte_range_set.ranges_n != 1 ||
+			atsc3_byte_range_set_add(&atsc3_byte_range_set, 10, 20) != 0 || !atsc3_byte_range_set_covers(&atsc3_byte_range_set, 0, 600) ||
+			atsc3_byte_range_set_covers(&atsc3_byte_range_set, 0, 601)) {
+		printf("test_byte_range_set_merge: adjacent, ranges: %u\n", atsc3_byte_range_set.ranges_n);
+		failed = 1;
+	}
+
+	//every other 10 byte range, then fill the gaps in reverse: grows past the initial array and collapses back to one range
+	atsc3_byte_range_set_clear(&atsc3_byte_range_set);
+	for(uint32_t i = 0; i < 1000; i += 2) {
+		atsc3_byte_range_set_add(&atsc3_byte_range_set, i * 10, 10);
+	}
+	if(atsc3_byte_range_set.ranges_n != 500) {
+		printf("test_byte_range_set_merge: gaps, ranges: %u\n", atsc3_byte_range_set.ranges_n);
+		failed = 1;
+	}
+	for(int32_t i = 999; i > 0; i -= 2) {
+		atsc3_byte_range_set_add(&atsc3_byte_range_set, i * 10, 10);
+	}
+	if(atsc3_byte_range_set.ranges_n != 1 || atsc3_byte_range_set.covered != 10000) {
+		printf("test_byte_range_set_merge: filled, ranges: %u, covered: %llu\n", atsc3_byte_range_set.ranges_n, (unsigned long long)atsc3_byte_range_set.covered);
+		failed = 1;
+	}
+
+	atsc3_byte_range_set_free(&atsc3_byte_range_set);
+	return failed;
+}
+
+int test_object_tracker_in_order() {
+	atsc3_alc_object_tracker_t* atsc3_alc_object_tracker = atsc3_alc_object_tracker_new();
+	uint32_t transfer_len = 10 * __OBJECT_TRACKER_TEST_SYMBOL_LEN + 100;
+	int completions = 0;
+	int failed = 0;
+
+	for(uint32_t offset = 0; offset < transfer_len; offset += __OBJECT_TRACKER_TEST_SYMBOL_LEN) {
+		uint32_t len = transfer_len - offset < __OBJECT_TRACKER_TEST_SYMBOL_LEN ? transfer_len - offset : __OBJECT_TRACKER_TEST_SYMBOL_LEN;
+		atsc3_alc_object_event_t atsc3_alc_object_event = atsc3_alc_object_tracker_add(atsc3_alc_object_tracker, __OBJECT_TRACKER_TEST_TSI, 1, offset, len, transfer_len, false);
+		if(atsc3_alc_object_event == ATSC3_ALC_OBJECT_EVENT_COMPLETE) {
+			completions++;
+			if(offset + len != transfer_len) {
+				printf("test_object_tracker_in_order: completed early at offset: %u\n", offset);
+				failed = 1;
+			}
+		}
+	}
+
+	atsc3_alc_object_t* atsc3_alc_object = atsc3_alc_object_tracker_find(atsc3_alc_object_tracker, __OBJECT_TRACKER_TEST_TSI, 1);
+	if(completions != 1 || !atsc3_alc_object || !atsc3_alc_object->completed || atsc3_alc_object->duplicate_bytes) {
+		printf("test_object_tracker_in_order: completions: %d\n", completions);
+		failed = 1;
+	}
+
+	atsc3_alc_object_tracker_free(&atsc3_alc_object_tracker);
+	return failed;
+}
+
+int test_object_tracker_out_of_order() {
+	atsc3_alc_object_tracker_t* atsc3_alc_object_tracker = atsc3_alc_object_tracker_new();
+	uint32_t symbols = 64;
+	uint32_t transfer_len = symbols * __OBJECT_TRACKER_TEST_SYMBOL_LEN;
+	int completions = 0;
+	int failed = 0;
+
+	//odd symbols first with the close object flag on the last one, then the even symbols in reverse
+	for(uint32_t i = 1; i < symbols; i += 2) {
+		if(atsc3_alc_object_tracker_add(atsc3_alc_object_tracker, __OBJECT_TRACKER_TEST_TSI, 2, i * __OBJECT_TRACKER_TEST_SYMBOL_LEN,
+				__OBJECT_TRACKER_TEST_SYMBOL_LEN, transfer_len, i == symbols - 1) != ATSC3_ALC_OBJECT_EVENT_NONE) {
+			printf("test_object_tracker_out_of_order: event before the object was covered, symbol: %u\n", i);
+			failed = 1;
+		}
+	}
+	for(int32_t i = symbols - 2; i >= 0; i -= 2) {
+		if(atsc3_alc_object_tracker_add(atsc3_alc_object_tracker, __OBJECT_TRACKER_TEST_TSI, 2, i * __OBJECT_TRACKER_TEST_SYMBOL_LEN,
+				__OBJECT_TRACKER_TEST_SYMBOL_LEN, 0, false) == ATSC3_ALC_OBJECT_EVENT_COMPLETE) {
+			completions++;
+			if(i) {
+				printf("test_object_tracker_out_of_order: completed with symbol 0 missing, symbol: %d\n", i);
+				failed = 1;
+			}
+		}
+	}
+
+	if(completions != 1 || atsc3_alc_object_tracker->objects_completed != 1) {
+		printf("test_object_tracker_out_of_order: completions: %d\n", completions);
+		failed = 1;
+	}
+
+	atsc3_alc_object_tracker_free(&atsc3_alc_object_tracker);
+	return failed;
+}
+
+int test_object_tracker_duplicates() {
+	atsc3_alc_object_tracker_t* atsc3_alc_object_tracker = atsc3_alc_object_tracker_new();
+	uint32_t transfer_len = 4 * __OBJECT_TRACKER_TEST_SYMBOL_LEN;
+	int failed = 0;
+
+	//symbol 1 twice, then the second half of symbol 1 overlapping into symbol 2 before the object is complete: [1400, 3500)
+	atsc3_alc_object_tracker_add(atsc3_alc_object_tracker, __OBJECT_TRACKER_TEST_TSI, 3, __OBJECT_TRACKER_TEST_SYMBOL_LEN, __OBJECT_TRACKER_TEST_SYMBOL_LEN, transfer_len, false);
+	atsc3_alc_object_tracker_add(atsc3_alc_object_tracker, __OBJECT_TRACKER_TEST_TSI, 3, __OBJECT_TRACKER_TEST_SYMBOL_LEN, __OBJECT_TRACKER_TEST_SYMBOL_LEN, transfer_len, false);
+	atsc3_alc_object_tracker_add(atsc3_alc_object_tracker, __OBJECT_TRACKER_TEST_TSI, 3, __OBJECT_TRACKER_TEST_SYMBOL_LEN * 3 / 2, __OBJECT_TRACKER_TEST_SYMBOL_LEN, transfer_len, false);
+
+	atsc3_alc_object_t* atsc3_alc_object = atsc3_alc_object_tracker_find(atsc3_alc_object_tracker, __OBJECT_TRACKER_TEST_TSI, 3);
+	if(atsc3_alc_object->duplicate_bytes != __OBJECT_TRACKER_TEST_SYMBOL_LEN * 3 / 2 || atsc3_alc_object->received.covered != __OBJECT_TRACKER_TEST_SYMBOL_LEN * 3 / 2) {
+		printf("test_object_tracker_duplicates: duplicate bytes: %llu, covered: %llu\n", (unsigned long long)atsc3_alc_object->duplicate_bytes, (unsigned long long)atsc3_alc_object->received.covered);
+		failed = 1;
+	}
+
+	//whole object in one packet completes, the carousel repeat is a duplicate
+	if(atsc3_alc_object_tracker_add(atsc3_alc_object_tracker, __OBJECT_TRACKER_TEST_TSI, 3, 0, transfer_len, transfer_len, true) != ATSC3_ALC_OBJECT_EVENT_COMPLETE ||
+			atsc3_alc_object_tracker_add(atsc3_alc_object_tracker, __OBJECT_TRACKER_TEST_TSI, 3, 0, __OBJECT_TRACKER_TEST_SYMBOL_LEN, transfer_len, false) != ATSC3_ALC_OBJECT_EVENT_DUPLICATE) {
+		printf("test_object_tracker_duplicates: carousel repeat\n");
+		failed = 1;
+	}
+
+	//1.5 symbols before, the 1.5 already covered by the whole object packet, the repeated symbol
+	uint64_t expected_duplicate_bytes = 4 * __OBJECT_TRACKER_TEST_SYMBOL_LEN;
+	if(atsc3_alc_object->duplicate_bytes != expected_duplicate_bytes || atsc3_alc_object_tracker->duplicate_bytes != expected_duplicate_bytes) {
+		printf("test_object_tracker_duplicates: duplicate bytes: %llu, expected: %llu\n", (unsigned long long)atsc3_alc_object->duplicate_bytes, (unsigned long long)expected_duplicate_bytes);
+		failed = 1;
+	}
+
+	atsc3_alc_object_tracker_free(&atsc3_alc_object_tracker);
+	return failed;
+}
+
+int test_object_tracker_close_object_flag() {
+	atsc3_alc_object_tracker_t* atsc3_alc_object_tracker = atsc3_alc_object_tracker_new();
+	int failed = 0;
+
+	//no transfer_len signalled, the close object packet arrives before symbol 1
+	atsc3_alc_object_tracker_add(atsc3_alc_object_tracker, __OBJECT_TRACKER_TEST_TSI, 4, 0, __OBJECT_TRACKER_TEST_SYMBOL_LEN, 0, false);
+	if(atsc3_alc_object_tracker_add(atsc3_alc_object_tracker, __OBJECT_TRACKER_TEST_TSI, 4, 2 * __OBJECT_TRACKER_TEST_SYMBOL_LEN, 500, 0, true) != ATSC3_ALC_OBJECT_EVENT_NONE) {
+		printf("test_object_tracker_close_object_flag: completed on the close object flag with symbol 1 missing\n");
+		failed = 1;
+	}
+	if(atsc3_alc_object_tracker_add(atsc3_alc_object_tracker, __OBJECT_TRACKER_TEST_TSI, 4, __OBJECT_TRACKER_TEST_SYMBOL_LEN, __OBJECT_TRACKER_TEST_SYMBOL_LEN, 0, false) != ATSC3_ALC_OBJECT_EVENT_COMPLETE) {
+		printf("test_object_tracker_close_object_flag: not completed by symbol 1\n");
+		failed = 1;
+	}
+
+	atsc3_alc_object_t* atsc3_alc_object = atsc3_alc_object_tracker_find(atsc3_alc_object_tracker, __OBJECT_TRACKER_TEST_TSI, 4);
+	if(atsc3_alc_object->transfer_len != 2 * __OBJECT_TRACKER_TEST_SYMBOL_LEN + 500) {
+		printf("test_object_tracker_close_object_flag: transfer_len: %llu\n", (unsigned long long)atsc3_alc_object->transfer_len);
+		failed = 1;
+	}
+
+	atsc3_alc_object_tracker_free(&atsc3_alc_object_tracker);
+	return failed;
+}
+
+int test_object_tracker_eviction() {
+	atsc3_alc_object_tracker_t* atsc3_alc_object_tracker = atsc3_alc_object_tracker_new();
+	int failed = 0;
+
+	//toi 0 stays incomplete and is never touched again, toi 1.. complete
+	atsc3_alc_object_tracker_add(atsc3_alc_object_tracker, __OBJECT_TRACKER_TEST_TSI, 0, 0, 100, 200, false);
+	for(uint32_t toi = 1; toi <= ATSC3_ALC_OBJECT_TRACKER_OBJECTS_MAX * 2; toi++) {
+		atsc3_alc_object_tracker_add(atsc3_alc_object_tracker, __OBJECT_TRACKER_TEST_TSI, toi, 0, 200, 200, true);
+	}
+
+	if(atsc3_alc_object_tracker->objects_n != ATSC3_ALC_OBJECT_TRACKER_OBJECTS_MAX || atsc3_alc_object_tracker->objects_evicted != 1 ||
+			atsc3_alc_object_tracker->objects_completed != ATSC3_ALC_OBJECT_TRACKER_OBJECTS_MAX * 2 ||
+			atsc3_alc_object_tracker_find(atsc3_alc_object_tracker, __OBJECT_TRACKER_TEST_TSI, 0) ||
+			!atsc3_alc_object_tracker_find(atsc3_alc_object_tracker, __OBJECT_TRACKER_TEST_TSI, ATSC3_ALC_OBJECT_TRACKER_OBJECTS_MAX * 2)) {
+		printf("test_object_tracker_eviction: objects: %u, evicted: %llu, completed: %llu\n", atsc3_alc_object_tracker->objects_n,
+				(unsigned long long)atsc3_alc_object_tracker->objects_evicted, (unsigned long long)atsc3_alc_object_tracker->objects_completed);
+		failed = 1;
+	}
+
+	//an evicted object starts over
+	if(atsc3_alc_object_tracker_add(atsc3_alc_object_tracker, __OBJECT_TRACKER_TEST_TSI, 0, 100, 100, 200, false) != ATSC3_ALC_OBJECT_EVENT_NONE) {
+		printf("test_object_tracker_eviction: evicted object completed from stale ranges\n");
+		failed = 1;
+	}
+
+	atsc3_alc_object_tracker_free(&atsc3_alc_object_tracker);
+	return failed;
+}
+
+int test_object_tracker_carousel_repeats() {
+	atsc3_alc_object_tracker_t* atsc3_alc_object_tracker = atsc3_alc_object_tracker_new();
+	atsc3_alc_object_tracker_stats_t stats_before = atsc3_alc_object_tracker_stats;
+	int failed = 0;
+
+	if(atsc3_alc_object_tracker_is_repeat(atsc3_alc_object_tracker, __OBJECT_TRACKER_TEST_TSI, 10, 200)) {
+		printf("test_object_tracker_carousel_repeats: repeat before the object completed\n");
+		failed = 1;
+	}
+	atsc3_alc_object_tracker_announce_version(atsc3_alc_object_tracker, __OBJECT_TRACKER_TEST_TSI, 10, 0x1010);
+	atsc3_alc_object_tracker_add(atsc3_alc_object_tracker, __OBJECT_TRACKER_TEST_TSI, 10, 0, 200, 400, false);
+	atsc3_alc_object_tracker_add(atsc3_alc_object_tracker, __OBJECT_TRACKER_TEST_TSI, 10, 200, 200, 400, true);
+
+	//two carousel passes
+	for(int pass = 0; pass < 2; pass++) {
+		if(!atsc3_alc_object_tracker_is_repeat(atsc3_alc_object_tracker, __OBJECT_TRACKER_TEST_TSI, 10, 200) ||
+				!atsc3_alc_object_tracker_is_repeat(atsc3_alc_object_tracker, __OBJECT_TRACKER_TEST_TSI, 10, 200)) {
+			printf("test_object_tracker_carousel_repeats: pass: %d not recognized\n", pass);
+			failed = 1;
+		}
+	}
+	if(atsc3_alc_object_tracker->repeats_suppressed != 4 || atsc3_alc_object_tracker->repeat_bytes_saved != 800 ||
+			atsc3_alc_object_tracker_stats.repeats_suppressed - stats_before.repeats_suppressed != 4 ||
+			atsc3_alc_object_tracker_stats.repeat_bytes_saved - stats_before.repeat_bytes_saved != 800 ||
+			atsc3_alc_object_tracker_is_repeat(atsc3_alc_object_tracker, __OBJECT_TRACKER_TEST_TSI + 1, 10, 200)) {
+		printf("test_object_tracker_carousel_repeats: suppressed: %llu, saved: %llu\n", (unsigned long long)atsc3_alc_object_tracker->repeats_suppressed,
+				(unsigned long long)atsc3_alc_object_tracker->repeat_bytes_saved);
+		failed = 1;
+	}
+
+	//every FDT-Instance is TOI 0
+	for(int instance = 0; instance < 2; instance++) {
+		if(atsc3_alc_object_tracker_add(atsc3_alc_object_tracker, __OBJECT_TRACKER_TEST_TSI, 0, 0, 300, 300, true) != ATSC3_ALC_OBJECT_EVENT_COMPLETE ||
+				atsc3_alc_object_tracker_is_repeat(atsc3_alc_object_tracker, __OBJECT_TRACKER_TEST_TSI, 0, 300)) {
+			printf("test_object_tracker_carousel_repeats: FDT-Instance: %d not received\n", instance);
+			failed = 1;
+		}
+	}
+
+	//a new consumer needs the objects again
+	atsc3_alc_object_tracker_clear_completed(atsc3_alc_object_tracker);
+	if(atsc3_alc_object_tracker_is_repeat(atsc3_alc_object_tracker, __OBJECT_TRACKER_TEST_TSI, 10, 200) ||
+			atsc3_alc_object_tracker_add(atsc3_alc_object_tracker, __OBJECT_TRACKER_TEST_TSI, 10, 0, 400, 400, true) != ATSC3_ALC_OBJECT_EVENT_COMPLETE) {
+		printf("test_object_tracker_carousel_repeats: still suppressed after clear\n");
+		failed = 1;
+	}
+
+	atsc3_alc_object_tracker_free(&atsc3_alc_object_tracker);
+	return failed;
+}
+
+//the init segment is re-sent under the same TOI without a Content-MD5, new content of the same length must not be dropped
+int test_object_tracker_unversioned_not_cached() {
+	atsc3_alc_object_tracker_t* atsc3_alc_object_tracker = atsc3_alc_object_tracker_new();
+	int failed = 0;
+
+	atsc3_alc_object_tracker_add(atsc3_alc_object_tracker, __OBJECT_TRACKER_TEST_TSI, 30, 0, 200, 200, true);
+	atsc3_alc_object_tracker_announce_version(atsc3_alc_object_tracker, __OBJECT_TRACKER_TEST_TSI, 30, 0);
+	if(atsc3_alc_object_tracker_is_repeat(atsc3_alc_object_tracker, __OBJECT_TRACKER_TEST_TSI, 30, 200) || atsc3_alc_object_tracker->completed_cache.entries_n ||
+			atsc3_alc_object_tracker->repeats_suppressed) {
+		printf("test_object_tracker_unversioned_not_cached: unversioned object cached, entries: %u\n", atsc3_alc_object_tracker->completed_cache.entries_n);
+		failed = 1;
+	}
+
+	//SLS fragments on TSI 0 carry their version in the TOI
+	atsc3_alc_object_tracker_add(atsc3_alc_object_tracker, 0, 30, 0, 200, 200, true);
+	if(!atsc3_alc_object_tracker_is_repeat(atsc3_alc_object_tracker, 0, 30, 200)) {
+		printf("test_object_tracker_unversioned_not_cached: TSI 0 object not cached\n");
+		failed = 1;
+	}
+
+	atsc3_alc_object_tracker_free(&atsc3_alc_object_tracker);
+	return failed;
+}
+
+int test_object_tracker_version_announce() {
+	atsc3_alc_object_tracker_t* atsc3_alc_object_tracker = atsc3_alc_object_tracker_new();
+	int failed = 0;
+
+	//announced before it completes, re-announced unchanged on the next FDT-Instance
+	atsc3_alc_object_tracker_announce_version(atsc3_alc_object_tracker, __OBJECT_TRACKER_TEST_TSI, 20, 0x1111);
+	atsc3_alc_object_tracker_add(atsc3_alc_object_tracker, __OBJECT_TRACKER_TEST_TSI, 20, 0, 100, 100, true);
+	atsc3_alc_object_tracker_announce_version(atsc3_alc_object_tracker, __OBJECT_TRACKER_TEST_TSI, 20, 0x1111);
+	if(!atsc3_alc_object_tracker_is_repeat(atsc3_alc_object_tracker, __OBJECT_TRACKER_TEST_TSI, 20, 100)) {
+		printf("test_object_tracker_version_announce: unchanged version not suppressed\n");
+		failed = 1;
+	}
+
+	//TOI re-used for new content
+	atsc3_alc_object_tracker_announce_version(atsc3_alc_object_tracker, __OBJECT_TRACKER_TEST_TSI, 20, 0x2222);
+	if(atsc3_alc_object_tracker_is_repeat(atsc3_alc_object_tracker, __OBJECT_TRACKER_TEST_TSI, 20, 100) || atsc3_alc_object_tracker->objects_invalidated != 1 ||
+			atsc3_alc_object_tracker_add(atsc3_alc_object_tracker, __OBJECT_TRACKER_TEST_TSI, 20, 0, 50, 100, false) != ATSC3_ALC_OBJECT_EVENT_NONE ||
+			atsc3_alc_object_tracker_add(atsc3_alc_object_tracker, __OBJECT_TRACKER_TEST_TSI, 20, 50, 50, 100, true) != ATSC3_ALC_OBJECT_EVENT_COMPLETE ||
+			!atsc3_alc_object_tracker_is_repeat(atsc3_alc_object_tracker, __OBJECT_TRACKER_TEST_TSI, 20, 100)) {
+		printf("test_object_tracker_version_announce: new version, invalidated: %llu\n", (unsigned long long)atsc3_alc_object_tracker->objects_invalidated);
+		failed = 1;
+	}
+
+	//completed before the first announcement, the version is taken as is
+	atsc3_alc_object_tracker_add(atsc3_alc_object_tracker, __OBJECT_TRACKER_TEST_TSI, 21, 0, 100, 100, true);
+	atsc3_alc_object_tracker_announce_version(atsc3_alc_object_tracker, __OBJECT_TRACKER_TEST_TSI, 21, 0x3333);
+	if(!atsc3_alc_object_tracker_is_repeat(atsc3_alc_object_tracker, __OBJECT_TRACKER_TEST_TSI, 21, 100) || atsc3_alc_object_tracker->objects_invalidated != 1) {
+		printf("test_object_tracker_version_announce: first announcement invalidated the object\n");
+		failed = 1;
+	}
+
+	atsc3_alc_object_tracker_free(&atsc3_alc_object_tracker);
+	return failed;
+}
+
+int test_object_tracker_cache_lru() {
+	atsc3_alc_object_tracker_t* atsc3_alc_object_tracker = atsc3_alc_object_tracker_new();
+	uint32_t objects = ATSC3_ALC_OBJECT_CACHE_MAX + 44;
+	int failed = 0;
+
+	//SLS objects on TSI 0, toi 1 stays recently used through the carousel, toi 2.. age out first
+	for(uint32_t toi = 1; toi <= objects; toi++) {
+		atsc3_alc_object_tracker_add(atsc3_alc_object_tracker, 0, toi, 0, 100, 100, true);
+		atsc3_alc_object_tracker_is_repeat(atsc3_alc_object_tracker, 0, 1, 100);
+	}
+
+	if(atsc3_alc_object_tracker->completed_cache.entries_n != ATSC3_ALC_OBJECT_CACHE_MAX || atsc3_alc_object_tracker->cache_evicted != objects - ATSC3_ALC_OBJECT_CACHE_MAX ||
+			!atsc3_alc_object_tracker_is_repeat(atsc3_alc_object_tracker, 0, 1, 100) ||
+			!atsc3_alc_object_tracker_is_repeat(atsc3_alc_object_tracker, 0, objects, 100)) {
+		printf("test_object_tracker_cache_lru: entries: %u, evicted: %llu\n", atsc3_alc_object_tracker->completed_cache.entries_n, (unsigned long long)atsc3_alc_object_tracker->cache_evicted);
+		failed = 1;
+	}
+
+	//the oldest ones are gone, and dropped from their bucket chains
+	for(uint32_t toi = 2; toi < 2 + objects - ATSC3_ALC_OBJECT_CACHE_MAX; toi++) {
+		if(atsc3_alc_object_tracker_is_repeat(atsc3_alc_object_tracker, 0, toi, 100)) {
+			printf("test_object_tracker_cache_lru: toi: %u still cached\n", toi);
+			failed = 1;
+			break;
+		}
+	}
+	for(uint32_t toi = 2 + objects - ATSC3_ALC_OBJECT_CACHE_MAX; toi <= objects; toi++) {
+		if(!atsc3_alc_object_tracker_is_repeat(atsc3_alc_object_tracker, 0, toi, 100)) {
+			printf("test_object_tracker_cache_lru: toi: %u not cached\n", toi);
+			failed = 1;
+			break;
+		}
+	}
+
+	atsc3_alc_object_tracker_free(&atsc3_alc_object_tracker);
+	return failed;
+}
@@ -159,25 +159,202 @@ typedef struct route_fragment {
 
 } route_fragment_t;
 
+alc_packet_pool_t* alc_packet_pool_create() {
+	return (alc_packet_pool_t*)calloc(1, sizeof(alc_packet_pool_t));
+}
+
+alc_packet_t* alc_packet_pool_get(alc_packet_pool_t* alc_packet_pool) {
+	alc_packet_t* alc_packet = alc_packet_pool->free_list;
+
+	if(alc_packet) {
+		alc_packet_pool->free_list = alc_packet->next;
+		alc_packet_pool->free_n--;
+		alc_packet_pool->packets_reused++;
+		memset(alc_packet, 0, sizeof(alc_packet_t));
+	} else {
+		alc_packet = calloc(1, sizeof(alc_packet_t));
+		alc_packet_pool->packets_allocated++;
+	}
+	alc_packet->alc_packet_pool = alc_packet_pool;
+
+	return alc_packet;
+}
+
+void alc_packet_pool_free(alc_packet_pool_t** alc_packet_pool_p) {
+	alc_packet_pool_t* alc_packet_pool = *alc_packet_pool_p;
+	if(alc_packet_pool) {
+		alc_packet_t* alc_packet = alc_packet_pool->free_list;
+		while(alc_packet) {
+			alc_packet_t* next = alc_packet->next;
+			free(alc_packet);
+			alc_packet = next;
+		}
+
+		free(alc_packet_pool);
+		*alc_packet_pool_p = NULL;
+	}
+}
+
 void alc_packet_free(alc_packet_t** alc_packet_ptr) {
 	alc_packet_t* alc_packet = *alc_packet_ptr;
 	if(alc_packet) {
-		if(alc_packet->def_lct_hdr) {
-			free(alc_packet->def_lct_hdr);
-			alc_packet->def_lct_hdr = NULL;
+		//alc_payload is a view into the source packet, nothing to release unless it is a recovered raptorq object
+		alc_packet->alc_payload = NULL;
+		if(alc_packet->fec_recovered_object) {
+			free(alc_packet->fec_recovered_object);
+			alc_packet->fec_recovered_object = NULL;
+		}
+
+		alc_packet_pool_t* alc_packet_pool = alc_packet->alc_packet_pool;
+		if(alc_packet_pool && alc_packet_pool->free_n < ALC_PACKET_POOL_MAX_FREE) {
+			alc_packet->next = alc_packet_pool->free_list;
+			alc_packet_pool->free_list = alc_packet;
+			alc_packet_pool->free_n++;
+		} else {
+			free(alc_packet);
+		}
+		*alc_packet_ptr = NULL;
+	}
+}
+
+
+void alc_raptorq_session_free(alc_raptorq_session_t** alc_raptorq_session_p) {
+	alc_raptorq_session_t* alc_raptorq_session = *alc_raptorq_session_p;
+	if(alc_raptorq_session) {
+		for(uint32_t i = 0; i < alc_raptorq_session->objects_n; i++) {
+			atsc3_raptorq_object_decoder_free(&alc_raptorq_session->objects[i].atsc3_raptorq_object_decoder);
+		}
+		free(alc_raptorq_session);
+		*alc_raptorq_session_p = NULL;
+	}
+}
+
+static alc_raptorq_object_t* alc_raptorq_object_find(alc_raptorq_session_t* alc_raptorq_session, uint32_t tsi, uint32_t toi) {
+	if(!alc_raptorq_session) {
+		return NULL;
+	}
+	for(uint32_t i = 0; i < alc_raptorq_session->objects_n; i++) {
+		alc_raptorq_object_t* alc_raptorq_object = &alc_raptorq_session->objects[i];
+		if(alc_raptorq_object->tsi == tsi && alc_raptorq_object->toi == toi &&
+				(alc_raptorq_object->atsc3_raptorq_object_decoder || alc_raptorq_object->recovered)) {
+			return alc_raptorq_object;
 		}
+	}
+	return NULL;
+}
 
+static alc_raptorq_object_t* alc_raptorq_object_add(alc_raptorq_session_t* alc_raptorq_session, uint32_t tsi, uint32_t toi, const atsc3_raptorq_oti_t* atsc3_raptorq_oti) {
+	alc_raptorq_object_t* alc_raptorq_object = NULL;
 
-		if(alc_packet->alc_payload) {
-			free(alc_packet->alc_payload);
-			alc_packet->alc_payload = NULL;
+	if(alc_raptorq_session->objects_n < ALC_RAPTORQ_OBJECTS_MAX) {
+		alc_raptorq_object = &alc_raptorq_session->objects[alc_raptorq_session->objects_n++];
+	} else {
+		alc_raptorq_object = &alc_raptorq_session->objects[0];
+		for(uint32_t i = 1; i < ALC_RAPTORQ_OBJECTS_MAX; i++) {
+			if(alc_raptorq_session->objects[i].last_used < alc_raptorq_object->last_used) {
+				alc_raptorq_object = &alc_raptorq_session->objects[i];
+			}
 		}
+		if(alc_raptorq_object->atsc3_raptorq_object_decoder) {
+			ALC_RX_WARN("raptorq: evicting incomplete object, tsi: %u, toi: %u", alc_raptorq_object->tsi, alc_raptorq_object->toi);
+			atsc3_raptorq_object_decoder_free(&alc_raptorq_object->atsc3_raptorq_object_decoder);
+			alc_raptorq_session->objects_evicted++;
+		}
+	}
 
-		free(alc_packet);
-		*alc_packet_ptr = NULL;
+	alc_raptorq_object->tsi = tsi;
+	alc_raptorq_object->toi = toi;
+	alc_raptorq_object->recovered = false;
+	alc_raptorq_object->atsc3_raptorq_object_decoder = atsc3_raptorq_object_decoder_create(atsc3_raptorq_oti);
+
+	return alc_raptorq_object->atsc3_raptorq_object_decoder ? alc_raptorq_object : NULL;
+}
+
+/**
+ * the session object tracker, created on first use. the completed object cache is dropped when
+ * alc_session_reset_object_cache was called since the last packet
+ */
+static atsc3_alc_object_tracker_t* alc_rx_object_tracker_get(alc_session_t* s) {
+	uint32_t completed_cache_epoch = __atomic_load_n(&s->alc_object_cache_epoch, __ATOMIC_ACQUIRE);
+	if(!s->alc_object_tracker) {
+		s->alc_object_tracker = atsc3_alc_object_tracker_new();
+		s->alc_object_tracker->completed_cache_epoch = completed_cache_epoch;
+	} else if(s->alc_object_tracker->completed_cache_epoch != completed_cache_epoch) {
+		atsc3_alc_object_tracker_clear_completed(s->alc_object_tracker);
+		s->alc_object_tracker->completed_cache_epoch = completed_cache_epoch;
+	}
+	return s->alc_object_tracker;
+}
+
+/**
+ * feeds a RaptorQ packet to the session object decoder for its tsi/toi, once the object is complete the packet is
+ * rewritten to carry the whole recovered object, otherwise it is marked fec_pending
+ */
+static void alc_rx_raptorq_recover(alc_session_t* s, alc_packet_t* alc_packet, const atsc3_raptorq_oti_t* atsc3_raptorq_oti) {
+	if(!s->alc_raptorq_session) {
+		s->alc_raptorq_session = (alc_raptorq_session_t*)calloc(1, sizeof(alc_raptorq_session_t));
+	}
+	alc_raptorq_session_t* alc_raptorq_session = s->alc_raptorq_session;
+	uint32_t tsi = alc_packet->def_lct_hdr.tsi;
+	uint32_t toi = alc_packet->def_lct_hdr.toi;
+
+	alc_packet->fec_pending = true;
+
+	alc_raptorq_object_t* alc_raptorq_object = alc_raptorq_object_find(alc_raptorq_session, tsi, toi);
+	if(!alc_raptorq_object) {
+		if(!atsc3_raptorq_oti) {
+			return;
+		}
+		alc_raptorq_object = alc_raptorq_object_add(alc_raptorq_session, tsi, toi, atsc3_raptorq_oti);
+		if(!alc_raptorq_object) {
+			ALC_RX_WARN("raptorq: unable to create object decoder, tsi: %u, toi: %u", tsi, toi);
+			return;
+		}
 	}
+	alc_raptorq_object->last_used = ++alc_raptorq_session->clock;
+
+	atsc3_raptorq_object_decoder_t* atsc3_raptorq_object_decoder = alc_raptorq_object->atsc3_raptorq_object_decoder;
+	if(!atsc3_raptorq_object_decoder) {
+		//already recovered, late repair symbol
+		return;
+	}
+
+	if(!atsc3_raptorq_object_decoder_add_packet(atsc3_raptorq_object_decoder, alc_packet->sbn, alc_packet->esi, alc_packet->alc_payload, alc_packet->alc_len)) {
+		return;
+	}
+
+	uint64_t transfer_len = atsc3_raptorq_object_decoder->oti.transfer_length;
+	alc_packet->fec_recovered_object = atsc3_raptorq_object_decoder_take_object(atsc3_raptorq_object_decoder);
+	atsc3_raptorq_object_decoder_free(&alc_raptorq_object->atsc3_raptorq_object_decoder);
+	alc_raptorq_object->recovered = true;
+	alc_raptorq_session->objects_recovered++;
+
+	ALC_RX_DEBUG("raptorq: recovered tsi: %u, toi: %u, transfer_len: %llu", tsi, toi, (unsigned long long)transfer_len);
+
+	alc_packet->fec_pending = false;
+	alc_packet->use_sbn_esi = false;
+	alc_packet->use_start_offset = true;
+	alc_packet->start_offset = 0;
+	alc_packet->alc_payload = alc_packet->fec_recovered_object;
+	alc_packet->alc_len = transfer_len;
+	alc_packet->transfer_len = transfer_len;
+	alc_packet->close_object_flag = 1;
 }
 
+bool alc_rx_peek_tsi(char* data, int len, uint32_t* tsi) {
+	//V/C/PSI, S/O/H/A/B, HDR_LEN, CP, CCI, TSI
+	if(len < 12) {
+		return false;
+	}
+
+	//TSI is at a fixed offset only with C=0, S=1, H=0, which A/331 A.3.6 requires
+	if(((data[0] >> 2) & 0x3) != 0 || ((data[1] >> 7) & 0x1) != 1 || ((data[1] >> 4) & 0x1) != 0) {
+		return false;
+	}
+
+	*tsi = __readuint32(data, 8);
+	return true;
+}
 
 int alc_rx_analyze_packet_a331_compliant(char *data, int len, alc_channel_t *ch, alc_packet_t** alc_packet_ptr) {
 
@@ -196,7 +373,7 @@ int alc_rx_analyze_packet_a331_compliant(char *data, int len, alc_channel_t *ch,
 
 	/* LCT header upto CCI */
 
-	atsc3_def_lct_hdr_t *def_lct_hdr = NULL;
+	atsc3_def_lct_hdr_t def_lct_hdr;
 
 	/* remaining LCT header fields*/
 
@@ -221,6 +398,9 @@ int alc_rx_analyze_packet_a331_compliant(char *data, int len, alc_channel_t *ch,
 	unsigned short max_nb_of_es = 0; /* max_n */
     
 	int fec_inst_id = 0; /* FEC Instance ID */
+
+	atsc3_raptorq_oti_t raptorq_oti;
+	bool has_raptorq_oti = false;
 //
 //    trans_obj_t *trans_obj = NULL;
 //    trans_block_t *trans_block = NULL;
@@ -248,86 +428,86 @@ int alc_rx_analyze_packet_a331_compliant(char *data, int len, alc_channel_t *ch,
 
 	//fix for endianness.
 	//byte 1
-	def_lct_hdr = calloc(1, sizeof(atsc3_def_lct_hdr_t));
-	def_lct_hdr->version = (data[0] >> 4) & 0xF;
-	def_lct_hdr->flag_c = (data[0] >> 2) & 0x3;
-	def_lct_hdr->psi = (data[0]) & 0x3;
+	memset(&def_lct_hdr, 0, sizeof(atsc3_def_lct_hdr_t));
+	def_lct_hdr.version = (data[0] >> 4) & 0xF;
+	def_lct_hdr.flag_c = (data[0] >> 2) & 0x3;
+	def_lct_hdr.psi = (data[0]) & 0x3;
 
 	//atsc3 A.3.6 LCT specifiation checks
-	if(def_lct_hdr->version != 1) {
-		ALC_RX_ERROR("LCT Header error: Version (v) must be 1, value is: %hu", def_lct_hdr->version);
+	if(def_lct_hdr.version != 1) {
+		ALC_RX_ERROR("LCT Header error: Version (v) must be 1, value is: %hu", def_lct_hdr.version);
 	}
-	if(def_lct_hdr->flag_c != 0) {
-		ALC_RX_ERROR("LCT Header error: Congestion Control (C) must be 0, value is: %hu", def_lct_hdr->flag_c);
+	if(def_lct_hdr.flag_c != 0) {
+		ALC_RX_ERROR("LCT Header error: Congestion Control (C) must be 0, value is: %hu", def_lct_hdr.flag_c);
 	}
-	if(def_lct_hdr->psi != 2) {
+	if(def_lct_hdr.psi != 2) {
 		//e.g. bit 10 pattern
-		ALC_RX_ERROR("LCT Header error: Protocol-Specific Indication (PSI) must be 2, value is: %hu", def_lct_hdr->psi);
+		ALC_RX_ERROR("LCT Header error: Protocol-Specific Indication (PSI) must be 2, value is: %hu", def_lct_hdr.psi);
 	}
 
 	//byte 2, header_pos=1
 	header_pos++;
-	def_lct_hdr->flag_s = (data[header_pos]>>7) & 0x1;
-	if(def_lct_hdr->flag_s != 1) {
-		ALC_RX_ERROR("LCT Header error: Transport Session Identifier flag (S) must be 1, value is: %hu", def_lct_hdr->flag_s);
+	def_lct_hdr.flag_s = (data[header_pos]>>7) & 0x1;
+	if(def_lct_hdr.flag_s != 1) {
+		ALC_RX_ERROR("LCT Header error: Transport Session Identifier flag (S) must be 1, value is: %hu", def_lct_hdr.flag_s);
 	}
 
-	def_lct_hdr->flag_o = (data[header_pos]>>5) & 0x3;
+	def_lct_hdr.flag_o = (data[header_pos]>>5) & 0x3;
 
-	if(def_lct_hdr->flag_o != 1) {
-		ALC_RX_ERROR("LCT Header error: Transport Object Identifier flag (O) must be 1, value is: %hu", def_lct_hdr->flag_o);
+	if(def_lct_hdr.flag_o != 1) {
+		ALC_RX_ERROR("LCT Header error: Transport Object Identifier flag (O) must be 1, value is: %hu", def_lct_hdr.flag_o);
 	}
 
-	def_lct_hdr->flag_h = (data[header_pos]>>4) & 0x1;
-	if(def_lct_hdr->flag_h != 0) {
-		ALC_RX_ERROR("LCT Header error: Half-word flag (H) must be 0, value is: %hu", def_lct_hdr->flag_h);
+	def_lct_hdr.flag_h = (data[header_pos]>>4) & 0x1;
+	if(def_lct_hdr.flag_h != 0) {
+		ALC_RX_ERROR("LCT Header error: Half-word flag (H) must be 0, value is: %hu", def_lct_hdr.flag_h);
 	}
 
-	def_lct_hdr->reserved = (data[header_pos]>>2) & 0x3;
+	def_lct_hdr.reserved = (data[header_pos]>>2) & 0x3;
 
-	if(def_lct_hdr->reserved != 0) {
-		ALC_RX_ERROR("Reserved field not zero - 0x%x", def_lct_hdr->reserved);
+	if(def_lct_hdr.reserved != 0) {
+		ALC_RX_ERROR("Reserved field not zero - 0x%x", def_lct_hdr.reserved);
 		retval = HDR_ERROR;
 		goto error;
 	}
 
-	def_lct_hdr->flag_a = (data[header_pos]>>1) & 0x1; //close session flag
-	def_lct_hdr->flag_b = (data[header_pos]) & 0x1; //close object flag
+	def_lct_hdr.flag_a = (data[header_pos]>>1) & 0x1; //close session flag
+	def_lct_hdr.flag_b = (data[header_pos]) & 0x1; //close object flag
 
 	//byte3
 	header_pos++;
 
-	def_lct_hdr->hdr_len_raw = data[header_pos];
-	def_lct_hdr->hdr_len = data[header_pos] * 4;
+	def_lct_hdr.hdr_len_raw = data[header_pos];
+	def_lct_hdr.hdr_len = data[header_pos] * 4;
 
 	//byte4
 	header_pos++;
 
-	def_lct_hdr->codepoint = data[header_pos];
-	ALC_RX_DEBUG("Codepoint is: %hhu", def_lct_hdr->codepoint);
+	def_lct_hdr.codepoint = data[header_pos];
+	ALC_RX_DEBUG("Codepoint is: %hhu", def_lct_hdr.codepoint);
 
 	//byte 5
 	header_pos++;
 
-	def_lct_hdr->cci = __readuint32(data, header_pos);
-	ALC_RX_DEBUG("def_lct_hdr->flag_c: %d, header_len is: %d, cci is: %u", def_lct_hdr->flag_c, header_pos, def_lct_hdr->cci);
+	def_lct_hdr.cci = __readuint32(data, header_pos);
+	ALC_RX_DEBUG("def_lct_hdr.flag_c: %d, header_len is: %d, cci is: %u", def_lct_hdr.flag_c, header_pos, def_lct_hdr.cci);
 	header_pos += 4;
 
-	def_lct_hdr->tsi = __readuint32(data, header_pos);
+	def_lct_hdr.tsi = __readuint32(data, header_pos);
 	header_pos += 4;
 
-	def_lct_hdr->toi = __readuint32(data, header_pos);
+	def_lct_hdr.toi = __readuint32(data, header_pos);
 	header_pos += 4;
 
-	ALC_RX_DEBUG("tsi_id: %u, toi_id: %u", def_lct_hdr->tsi , def_lct_hdr->toi);
+	ALC_RX_DEBUG("tsi_id: %u, toi_id: %u", def_lct_hdr.tsi , def_lct_hdr.toi);
 
 
-	if(def_lct_hdr->flag_a == 1) {
-		ch->s->state = SAFlagReceived;
+	if(def_lct_hdr.flag_a == 1) {
+		alc_session_set_state(ch->s, SAFlagReceived);
 		ALC_RX_DEBUG("flag_a, close session flag: 1 ");
 	}
 
-	fec_enc_id = def_lct_hdr->codepoint;
+	fec_enc_id = def_lct_hdr.codepoint;
 
 	if(!(fec_enc_id == COM_NO_C_FEC_ENC_ID || fec_enc_id == RS_FEC_ENC_ID ||
 		fec_enc_id == SB_SYS_FEC_ENC_ID || fec_enc_id == SIMPLE_XOR_FEC_ENC_ID)) {
@@ -337,13 +517,13 @@ int alc_rx_analyze_packet_a331_compliant(char *data, int len, alc_channel_t *ch,
 	}
 
 	//if we have extra data in the header we haven't read yet, process it as an extension
-	if(def_lct_hdr->hdr_len > header_pos) {
+	if(def_lct_hdr.hdr_len > header_pos) {
 
 		/* LCT header extensions(EXT_FDT, EXT_CENC, EXT_FTI, EXT_AUTH, EXT_NOP)
 		go through all possible EH */
 
-		exthdrlen = def_lct_hdr->hdr_len - header_pos;
-		ALC_RX_DEBUG("def_lct_hdr->hdr_len: %d, exthdrlen: %d, header_pos:%d", def_lct_hdr->hdr_len, exthdrlen, header_pos);
+		exthdrlen = def_lct_hdr.hdr_len - header_pos;
+		ALC_RX_DEBUG("def_lct_hdr.hdr_len: %d, exthdrlen: %d, header_pos:%d", def_lct_hdr.hdr_len, exthdrlen, header_pos);
 
 		while(exthdrlen > 0) {
 			word = 0x00000000;
@@ -362,12 +542,12 @@ int alc_rx_analyze_packet_a331_compliant(char *data, int len, alc_channel_t *ch,
 			}
 			exthdrlen-=4;
 
-			ALC_RX_DEBUG("def_lct_hdr->hdr_len: %d, exthdrlen: %d, hdrlen:%d, het: %d, hel: %d", def_lct_hdr->hdr_len, exthdrlen, header_pos, het, hel);
+			ALC_RX_DEBUG("def_lct_hdr.hdr_len: %d, exthdrlen: %d, hdrlen:%d, het: %d, hel: %d", def_lct_hdr.hdr_len, exthdrlen, header_pos, het, hel);
 
 			switch(het) {
 
 			  case EXT_FDT:
-				  ALC_RX_DEBUG("EXT_FDT: def_lct_hdr->hdr_len: %d, exthdrlen: %d, hdrlen:%d, het: %d, hel: %d", def_lct_hdr->hdr_len, exthdrlen, header_pos, het, hel);
+				  ALC_RX_DEBUG("EXT_FDT: def_lct_hdr.hdr_len: %d, exthdrlen: %d, hdrlen:%d, het: %d, hel: %d", def_lct_hdr.hdr_len, exthdrlen, header_pos, het, hel);
 
 				  flute_version = (word & 0x00F00000) >> 20;
 				  fdt_instance_id = (word & 0x000FFFFF);
@@ -380,7 +560,7 @@ int alc_rx_analyze_packet_a331_compliant(char *data, int len, alc_channel_t *ch,
 				  break;
 
 			  case EXT_CENC:
-				  ALC_RX_DEBUG("EXT_CENC: def_lct_hdr->hdr_len: %d, exthdrlen: %d, hdrlen:%d, het: %d, hel: %d", def_lct_hdr->hdr_len, exthdrlen, header_pos, het, hel);
+				  ALC_RX_DEBUG("EXT_CENC: def_lct_hdr.hdr_len: %d, exthdrlen: %d, hdrlen:%d, het: %d, hel: %d", def_lct_hdr.hdr_len, exthdrlen, header_pos, het, hel);
 
 				  content_enc_algo = (word & 0x00FF0000) >> 16;
 				  reserved = (word & 0x0000FFFF);
@@ -412,7 +592,21 @@ int alc_rx_analyze_packet_a331_compliant(char *data, int len, alc_channel_t *ch,
 				   * https://tools.ietf.org/html/rfc3926 - FLUTE
 				   */
 
-				  ALC_RX_TRACE("EXT_FTI: %i, def_lct_hdr->hdr_len: %d, exthdrlen: %d, header_pos:%d, het: %d, hel: %d", hel, def_lct_hdr->hdr_len, exthdrlen, header_pos, het, hel);
+				  ALC_RX_TRACE("EXT_FTI: %i, def_lct_hdr.hdr_len: %d, exthdrlen: %d, header_pos:%d, het: %d, hel: %d", hel, def_lct_hdr.hdr_len, exthdrlen, header_pos, het, hel);
+
+				  if(fec_enc_id == RAPTORQ_FEC_ENC_ID) {
+					  //HET HEL | F(40) reserved(8) T(16) | Z(8) N(16) Al(8) | padding(16), RFC 6330 3.3.2 and 3.3.3 OTI
+					  if(hel != 4 || header_pos + 12 > len) {
+						  ALC_RX_WARN("Bad RaptorQ FTI header extension, length: %i", hel);
+						  retval = HDR_ERROR;
+						  goto error;
+					  }
+					  has_raptorq_oti = atsc3_raptorq_oti_parse((uint8_t*)&data[header_pos - 2], ATSC3_RAPTORQ_OTI_LEN, &raptorq_oti);
+					  transfer_len = raptorq_oti.transfer_length;
+					  header_pos += 12;
+					  exthdrlen -= 12;
+					  break;
+				  }
 
 				  if(hel != 4) {
 					  ALC_RX_WARN("Bad FTI header extension, length: %i", hel);
@@ -427,13 +621,13 @@ int alc_rx_analyze_packet_a331_compliant(char *data, int len, alc_channel_t *ch,
 				  header_pos+=4;
 				  exthdrlen-=4;
 				  ALC_RX_DEBUG("Reading FTI TSI: transfer len: %llu", transfer_len);
-				  ALC_RX_TRACE("def_lct_hdr->hdr_len: %d, exthdrlen: %d, header_pos:%d, het: %d, hel: %d", def_lct_hdr->hdr_len, exthdrlen, header_pos, het, hel);
+				  ALC_RX_TRACE("def_lct_hdr.hdr_len: %d, exthdrlen: %d, header_pos:%d, het: %d, hel: %d", def_lct_hdr.hdr_len, exthdrlen, header_pos, het, hel);
 
 
 				  word = __readuint32(data, header_pos);
 				  header_pos+=4;
 				  exthdrlen-=4;
-				  ALC_RX_TRACE("def_lct_hdr->hdr_len: %d, exthdrlen: %d, header_pos:%d, het: %d, hel: %d", def_lct_hdr->hdr_len, exthdrlen, header_pos, het, hel);
+				  ALC_RX_TRACE("def_lct_hdr.hdr_len: %d, exthdrlen: %d, header_pos:%d, het: %d, hel: %d", def_lct_hdr.hdr_len, exthdrlen, header_pos, het, hel);
 
 				  if(fec_enc_id == RS_FEC_ENC_ID) {
 					  finite_field = (word & 0xFF000000) >> 24;
@@ -514,7 +708,7 @@ int alc_rx_analyze_packet_a331_compliant(char *data, int len, alc_channel_t *ch,
 
   				  transfer_len = (word & 0x00FFFFFF);
 
-                  ALC_RX_DEBUG("EXT_TOL, tsi: %u, toi: %u,  het is: %d, hel is: %d, exthdrlen: %d, toi transfer len: %llu", def_lct_hdr->tsi, def_lct_hdr->toi, het,  hel, exthdrlen, transfer_len);
+                  ALC_RX_DEBUG("EXT_TOL, tsi: %u, toi: %u,  het is: %d, hel is: %d, exthdrlen: %d, toi transfer len: %llu", def_lct_hdr.tsi, def_lct_hdr.toi, het,  hel, exthdrlen, transfer_len);
 
                   //no additional read performed here, continue the loop
                   break;
@@ -527,10 +721,10 @@ int alc_rx_analyze_packet_a331_compliant(char *data, int len, alc_channel_t *ch,
 		}
 	}
 
-	if(header_pos != def_lct_hdr->hdr_len) {
+	if(header_pos != def_lct_hdr.hdr_len) {
 		/* Wrong header length */
 		ALC_RX_WARN("analyze_packet: packet header length %d, should be %d", header_pos,
-			def_lct_hdr->hdr_len);
+			def_lct_hdr.hdr_len);
 		  retval = HDR_ERROR;
 		  goto error;
 	}
@@ -543,6 +737,12 @@ int alc_rx_analyze_packet_a331_compliant(char *data, int len, alc_channel_t *ch,
 		goto error;
 	}
 
+	if(len - header_pos < 4) {
+		ALC_RX_WARN("analyze_packet: packet too short for FEC Payload ID, len: %d, header_pos: %d", len, header_pos);
+		retval = HDR_ERROR;
+		goto error;
+	}
+
 	/***
      *
      A.3.5.1 FEC Payload ID for Source Flows
@@ -578,7 +778,11 @@ int alc_rx_analyze_packet_a331_compliant(char *data, int len, alc_channel_t *ch,
 	 *
 	 */
 
-    alc_packet_t* alc_packet = calloc(1, sizeof(alc_packet_t));
+    if(!ch->s->alc_packet_pool) {
+    	ch->s->alc_packet_pool = alc_packet_pool_create();
+    }
+
+    alc_packet_t* alc_packet = alc_packet_pool_get(ch->s->alc_packet_pool);
     *alc_packet_ptr = alc_packet;
 
     alc_packet->def_lct_hdr = def_lct_hdr;
@@ -588,7 +792,10 @@ int alc_rx_analyze_packet_a331_compliant(char *data, int len, alc_channel_t *ch,
 	fec_payload_id_to_parse = __readuint32(data, header_pos);
 	header_pos += 4;
     
-    if(alc_packet->fec_encoding_id == SB_LB_E_FEC_ENC_ID) {
+    //codepoint 6 is also a ROUTE source flow codepoint, only treat it as RaptorQ when we have (or had) the OTI for the object
+    bool is_raptorq = fec_enc_id == RAPTORQ_FEC_ENC_ID && (has_raptorq_oti || alc_raptorq_object_find(ch->s->alc_raptorq_session, def_lct_hdr.tsi, def_lct_hdr.toi));
+
+    if(alc_packet->fec_encoding_id == SB_LB_E_FEC_ENC_ID || is_raptorq) {
         alc_packet->use_sbn_esi = true;
         alc_packet->sbn = (fec_payload_id_to_parse >> 24) & 0xFF;
         alc_packet->esi = (fec_payload_id_to_parse) & 0x00FFFFFF;
@@ -599,24 +806,38 @@ int alc_rx_analyze_packet_a331_compliant(char *data, int len, alc_channel_t *ch,
         ALC_RX_DEBUG("ALC start offset: %u", alc_packet->start_offset);
     }
 
-	alc_packet->close_object_flag = def_lct_hdr->flag_b;
-	alc_packet->close_session_flag = def_lct_hdr->flag_a;
+	alc_packet->close_object_flag = def_lct_hdr.flag_b;
+	alc_packet->close_session_flag = def_lct_hdr.flag_a;
 
 	alc_packet->alc_len = len - header_pos;
     alc_packet->transfer_len = transfer_len;
-	alc_packet->alc_payload = calloc(alc_packet->alc_len, sizeof(uint8_t));
+	alc_packet->alc_payload = (uint8_t*)&data[header_pos];
+
+	//carousel repeat of an object already received in full, dropped before the payload is looked at
+	if(alc_rx_object_tracker_get(ch->s) && atsc3_alc_object_tracker_is_repeat(ch->s->alc_object_tracker, def_lct_hdr.tsi, def_lct_hdr.toi, alc_packet->alc_len)) {
+		alc_packet->object_tracked = true;
+		alc_packet->object_duplicate = true;
+		alc_packet->object_repeat = true;
+		return ALC_OK;
+	}
 
-	memcpy(alc_packet->alc_payload, &data[header_pos], alc_packet->alc_len);
+	if(is_raptorq) {
+		alc_rx_raptorq_recover(ch->s, alc_packet, has_raptorq_oti ? &raptorq_oti : NULL);
+	}
+
+	//SB_LB_E esi's are symbol indexes rather than byte offsets, those objects still complete on the close object flag
+	if(!alc_packet->fec_pending && alc_packet->use_start_offset) {
+		atsc3_alc_object_event_t atsc3_alc_object_event = atsc3_alc_object_tracker_add(ch->s->alc_object_tracker, def_lct_hdr.tsi, def_lct_hdr.toi,
+				alc_packet->start_offset, alc_packet->alc_len, alc_packet->transfer_len, alc_packet->close_object_flag);
+		alc_packet->object_tracked = true;
+		alc_packet->object_complete = atsc3_alc_object_event == ATSC3_ALC_OBJECT_EVENT_COMPLETE;
+		alc_packet->object_duplicate = atsc3_alc_object_event == ATSC3_ALC_OBJECT_EVENT_DUPLICATE;
+	}
 
 	ALC_RX_TRACE("alc_packet is now: %p, started at packet header_pos: %u, fragment start block is: %u, fragment length is: %u", alc_packet, header_pos, alc_packet->sbn, alc_packet->alc_len);
 	return ALC_OK;
 
 error:
-	if(def_lct_hdr) {
-		free(def_lct_hdr);
-		def_lct_hdr = NULL;
-	}
-
 	return retval;
 
 }
@@ -35,6 +35,9 @@
 
 #include "atsc3_utils.h"
 #include "atsc3_lct_hdr.h"
+#include "atsc3_logging.h"
+#include "atsc3_raptorq.h"
+#include "atsc3_alc_object_tracker.h"
 
 
 #ifndef _ALC_RX_H_
@@ -48,14 +51,15 @@
 #define __ALC_RX_PRINTLN(...) printf(__VA_ARGS__);printf("\r\n")
 #define __ALC_RX_PRINTF(...)  printf(__VA_ARGS__);
 
-#define ALC_RX_ERROR(...)   printf("%s:%d:ERROR:",__FILE__,__LINE__);__ALC_RX_PRINTLN(__VA_ARGS__);
-#define ALC_RX_WARN(...)    printf("%s:%d:WARN:",__FILE__,__LINE__);__ALC_RX_PRINTLN(__VA_ARGS__);
-#define ALC_RX_INFO(...)    printf("%s:%d:INFO:",__FILE__,__LINE__);__ALC_RX_PRINTLN(__VA_ARGS__);
+#define ALC_RX_ERROR(...)   __ATSC3_LOG_ERROR(ATSC3_LOG_MODULE_ALC_RX, __VA_ARGS__)
+#define ALC_RX_WARN(...)    __ATSC3_LOG_WARN(ATSC3_LOG_MODULE_ALC_RX, __VA_ARGS__)
+#define ALC_RX_INFO(...)    __ATSC3_LOG_INFO(ATSC3_LOG_MODULE_ALC_RX, __VA_ARGS__)
 
+//per-packet codepoint/cci/tsi/toi logging, keep compiled out unless explicitly requested
 #ifdef __ALC_RX_ENABLE_DEBUG
 
-#define ALC_RX_DEBUG(...)   printf("%s:%d:DEBUG:",__FILE__,__LINE__);__ALC_RX_PRINTLN(__VA_ARGS__);
-#define ALC_RX_DEBUGF(...)  printf("%s:%d:DEBUG:",__FILE__,__LINE__);__ALC_RX_PRINTF(__VA_ARGS__);
+#define ALC_RX_DEBUG(...)   __ATSC3_LOG_DEBUG(ATSC3_LOG_MODULE_ALC_RX, __VA_ARGS__)
+#define ALC_RX_DEBUGF(...)  __ATSC3_LOG_DEBUG(ATSC3_LOG_MODULE_ALC_RX, __VA_ARGS__)
 #define ALC_RX_DEBUGA(...) 	__PRINTF(__VA_ARGS__);
 #define ALC_RX_DEBUGN(...)  __PRINTLN(__VA_ARGS__);
 #else
@@ -66,7 +70,7 @@
 #endif
 
 #ifdef __ALC_RX_ENABLE_TRACE
-#define ALC_RX_TRACE(...)   printf("%s:%d:TRACE:",__FILE__,__LINE__);__ALC_RX_PRINTLN(__VA_ARGS__);
+#define ALC_RX_TRACE(...)   __ATSC3_LOG_TRACE(ATSC3_LOG_MODULE_ALC_RX, __VA_ARGS__)
 #else
 #define ALC_RX_TRACE(...)
 #endif
@@ -84,11 +88,20 @@ extern "C" {
 #endif
 
 
+/*
+ * alc_packet_t's are recycled through a per alc_session_t pool (alc_session->alc_packet_pool), created on the first
+ * packet for the session, so steady state ROUTE parsing does not touch the heap. alc_packet_free returns the packet
+ * to its pool, keeping at most ALC_PACKET_POOL_MAX_FREE idle packets per session.
+ *
+ * the pool is not locked, packets for a session must be parsed and released on the same thread
+ */
+#define ALC_PACKET_POOL_MAX_FREE 64
+
 typedef struct alc_packet {
-	atsc3_def_lct_hdr_t* def_lct_hdr;
+	atsc3_def_lct_hdr_t def_lct_hdr;
 	uint8_t fec_encoding_id;
     
-    //for fec_encoding_id == 128, raptor fec
+    //for fec_encoding_id == 128, raptor fec, and fec_encoding_id == 6, raptorq
     bool use_sbn_esi;
     uint8_t sbn;	//sbn: source block number for fec recovery
 	uint32_t esi; 	//esi: encoding symbol id, our 24bit offset
@@ -103,12 +116,87 @@ typedef struct alc_packet {
     unsigned int alc_len;
     unsigned long long transfer_len;
 
+	//view into the data passed to alc_rx_analyze_packet_a331_compliant (e.g. udp_packet->data), not owned,
+	//only valid until the source udp_packet_t is released
 	uint8_t* alc_payload;
 
+	//raptorq: symbols were taken by the session object decoder, there is nothing to write out for this packet yet
+	bool fec_pending;
+	//raptorq: the recovered object, alc_payload points here when set, released by alc_packet_free
+	uint8_t* fec_recovered_object;
+
+	//start_offset packets: coverage of the object by byte range in alc_session->alc_object_tracker, object_complete is set
+	//on the one packet after which [0, transfer_len) has been received, object_duplicate on packets for an object already completed.
+	//object_repeat when the object is in the tracker's completed_cache, the packet is dropped right after the LCT header
+	bool object_tracked;
+	bool object_complete;
+	bool object_duplicate;
+	bool object_repeat;
+
+	struct alc_packet_pool* alc_packet_pool;	//owning pool, NULL if the packet was allocated outside of a pool
+	struct alc_packet* next;					//free list link while idle in the pool
+
 } alc_packet_t;
 
+typedef struct alc_packet_pool {
+	alc_packet_t*	free_list;
+	uint32_t		free_n;
+
+	uint64_t		packets_allocated;
+	uint64_t		packets_reused;
+} alc_packet_pool_t;
+
+alc_packet_pool_t* alc_packet_pool_create();
+//returns a zeroed alc_packet_t, from the free list if available
+alc_packet_t* alc_packet_pool_get(alc_packet_pool_t* alc_packet_pool);
+//all packets taken from the pool must have been released with alc_packet_free before the pool is freed
+void alc_packet_pool_free(alc_packet_pool_t** alc_packet_pool_p);
+
 void alc_packet_free(alc_packet_t** alc_packet_ptr);
 
+//true if this packet completes its object: by byte range coverage when tracked, otherwise (SB_LB_E, carousel repeats
+//of an already completed object) by the close object flag
+static inline bool alc_packet_completes_object(alc_packet_t* alc_packet) {
+	if(alc_packet->object_tracked && !alc_packet->object_duplicate) {
+		return alc_packet->object_complete;
+	}
+	return alc_packet->close_object_flag;
+}
+
+/*
+ * RaptorQ (FEC Encoding ID 6) objects are recovered in memory per alc_session_t (alc_session->alc_raptorq_session).
+ *
+ * a decoder is started for a tsi/toi on the first packet carrying the RaptorQ OTI in EXT_FTI, every packet for the
+ * object is then marked fec_pending and its symbols are held by the decoder. the packet that completes the last
+ * source block is rewritten as a single whole-object packet (start_offset 0, alc_len = transfer_len, close object
+ * flag set) so the existing object writers and reconstitution path consume it unchanged.
+ *
+ * at most ALC_RAPTORQ_OBJECTS_MAX objects are tracked, the least recently used is evicted. recovered objects keep their
+ * slot (without a decoder) so late repair symbols for them are dropped rather than starting a new decode
+ */
+#define ALC_RAPTORQ_OBJECTS_MAX 16
+
+typedef struct alc_raptorq_object {
+	uint32_t							tsi;
+	uint32_t							toi;
+	atsc3_raptorq_object_decoder_t*		atsc3_raptorq_object_decoder;
+	bool								recovered;
+	uint64_t							last_used;
+} alc_raptorq_object_t;
+
+typedef struct alc_raptorq_session {
+	alc_raptorq_object_t	objects[ALC_RAPTORQ_OBJECTS_MAX];
+	uint32_t				objects_n;
+	uint64_t				clock;
+
+	uint64_t				objects_recovered;
+	uint64_t				objects_evicted;
+} alc_raptorq_session_t;
+
+void alc_raptorq_session_free(alc_raptorq_session_t** alc_raptorq_session_p);
+
+//reads the TSI from the LCT header without parsing the packet, false if the header is too short or not A/331 shaped
+bool alc_rx_peek_tsi(char* data, int len, uint32_t* tsi);
 int alc_rx_analyze_packet_a331_compliant(char *data, int len, alc_channel_t *ch, alc_packet_t** alc_packet_ptr);
 
 /** 
@@ -69,9 +69,16 @@ RFC 5775               ALC Protocol Instantiation             April 2010
 #include "atsc3_lls_sls_monitor_output_buffer_utils.h"
 //shortcut hack
 #include "atsc3_isobmff_tools.h"
+#include "atsc3_latency_histogram.h"
+#include "atsc3_fdt.h"
+#include "atsc3_fdt_parser.h"
+#include "atsc3_route_s_tsid.h"
+#include "atsc3_qsbr.h"
+#include "atsc3_route_s_tsid_parser.h"
 
 
 int _ALC_PACKET_DUMP_TO_OBJECT_ENABLED = 0;
+int _ALC_PACKET_DUMP_TO_OBJECT_FILES_ENABLED = 1;
 
 int _ALC_UTILS_DEBUG_ENABLED=0;
 int _ALC_UTILS_TRACE_ENABLED=0;
@@ -118,9 +125,7 @@ block_t* alc_get_payload_from_filename(char* file_name) {
 char* alc_packet_dump_to_object_get_filename(alc_packet_t* alc_packet) {
 	char* file_name = (char *)calloc(255, sizeof(char));
 
-	if(alc_packet->def_lct_hdr) {
-		snprintf(file_name, 255, "%s%u-%u", __ALC_DUMP_OUTPUT_PATH__, alc_packet->def_lct_hdr->tsi, alc_packet->def_lct_hdr->toi);
-	}
+	snprintf(file_name, 255, "%s%u-%u", __ALC_DUMP_OUTPUT_PATH__, alc_packet->def_lct_hdr.tsi, alc_packet->def_lct_hdr.toi);
 
 	return file_name;
 }
@@ -194,7 +199,7 @@ FILE* alc_object_pre_allocate(char* file_name, alc_packet_t* alc_packet) {
 
 int alc_packet_write_fragment(FILE* f, char* file_name, uint32_t offset, alc_packet_t* alc_packet) {
     
-	__ALC_UTILS_IOTRACE("write fragment: tsi: %u, toi: %u, sbn: %x, esi: %x len: %d, complete: %d, file: %p, file name: %s, offset: %u, size: %u",  alc_packet->def_lct_hdr->tsi, alc_packet->def_lct_hdr->toi,
+	__ALC_UTILS_IOTRACE("write fragment: tsi: %u, toi: %u, sbn: %x, esi: %x len: %d, complete: %d, file: %p, file name: %s, offset: %u, size: %u",  alc_packet->def_lct_hdr.tsi, alc_packet->def_lct_hdr.toi,
         alc_packet->sbn, alc_packet->esi, alc_packet->alc_len, alc_packet->close_object_flag,
         f, file_name, offset, alc_packet->alc_len);
 
@@ -217,7 +222,29 @@ int alc_packet_dump_to_object(alc_packet_t** alc_packet_ptr) {
 	if(!_ALC_PACKET_DUMP_TO_OBJECT_ENABLED) {
         return -1;
     }
-    
+
+    //RaptorQ symbols are held by the session until the whole object is recovered, nothing to write yet
+    if(alc_packet->fec_pending) {
+        return 0;
+    }
+
+	//carousel repeat of a cached object that was already written out and reconstituted, its payload was never looked at
+	if(alc_packet->object_repeat) {
+		return 0;
+	}
+
+	if(__ALC_RECON_MONITOR) {
+		if(alc_packet_completes_object(alc_packet) && __ALC_RECON_MONITOR->lls_alc_session) {
+			__LATENCY_HISTOGRAM_RECORD(__ALC_RECON_MONITOR->lls_alc_session->service_id, ATSC3_LATENCY_STAGE_MPU_OBJECT_COMPLETE);
+		}
+		//hand the payload straight to reconstitution, the completed object never goes through route/
+		alc_recon_monitor_add_packet(__ALC_RECON_MONITOR, alc_packet);
+	}
+
+	if(!_ALC_PACKET_DUMP_TO_OBJECT_FILES_ENABLED) {
+		return 0;
+	}
+
     char* file_name = alc_packet_dump_to_object_get_filename(alc_packet);
     mkdir("route", 0777);
 
@@ -233,7 +260,8 @@ int alc_packet_dump_to_object(alc_packet_t** alc_packet_ptr) {
         }
         if(!f) {
             __ALC_UTILS_WARN("alc_packet_dump_to_object, unable to open file: %s", file_name);
-            return -2;
+            bytesWritten = -2;
+            goto cleanup;
         }
         alc_packet_write_fragment(f, file_name, alc_packet->esi, alc_packet);
         __ALC_UTILS_IOTRACE("raptor_fec: done writing out fragment for %s", file_name);
@@ -248,7 +276,8 @@ int alc_packet_dump_to_object(alc_packet_t** alc_packet_ptr) {
         }
         if(!f) {
             __ALC_UTILS_WARN("alc_packet_dump_to_object, unable to open file: %s", file_name);
-            return -2;
+            bytesWritten = -2;
+            goto cleanup;
         }
         
         alc_packet_write_fragment(f, file_name, alc_packet->start_offset, alc_packet);
@@ -262,35 +291,451 @@ int alc_packet_dump_to_object(alc_packet_t** alc_packet_ptr) {
         fclose(f);
         f = NULL;
     }
-    
-	//also investigate alc_packet->transfer_len if we dont get a close object tag
-	if(alc_packet->close_object_flag) {
-		//__ALC_UTILS_DEBUG("dumping to file done: %s, is complete: %d", file_name, alc_packet->close_object_flag);
+
+cleanup:
+	if(file_name) {
+		free(file_name);
+	}
+
+	return bytesWritten;
+}
+
+/*
+ * in-memory ROUTE/DASH object reconstitution, see atsc3_alc_utils.h
+ */
+
+alc_recon_track_t* alc_recon_track_create(uint32_t tsi, uint32_t toi_init) {
+	alc_recon_track_t* alc_recon_track = (alc_recon_track_t*)calloc(1, sizeof(alc_recon_track_t));
+	alc_recon_track->tsi = tsi;
+	alc_recon_track->toi_init = toi_init;
+
+	return alc_recon_track;
+}
+
+void alc_recon_track_set_tsi_toi_init(alc_recon_track_t* alc_recon_track, uint32_t tsi, uint32_t toi_init) {
+	if(alc_recon_track->tsi == tsi && alc_recon_track->toi_init == toi_init) {
+		return;
+	}
+
+	__ALC_UTILS_DEBUG("alc_recon_track: tsi: %u, toi_init: %u changed to tsi: %u, toi_init: %u, dropping cached objects", alc_recon_track->tsi, alc_recon_track->toi_init, tsi, toi_init);
+
+	//keep the buffers around for reuse, only their contents are stale
+	alc_recon_track->tsi = tsi;
+	alc_recon_track->toi_init = toi_init;
+	alc_recon_track->assembling.toi = 0;
+	if(alc_recon_track->assembling.block) {
+		block_Rewind(alc_recon_track->assembling.block);
+	}
+	alc_recon_track->assembling_gzip = false;
+	block_Release(&alc_recon_track->init.block);
+	alc_recon_track->init.toi = 0;
+	alc_recon_track->init_changed = false;
+	for(int i = 0; i < ALC_RECON_TRACK_FRAGMENTS_MAX; i++) {
+		block_Release(&alc_recon_track->fragments[i].block);
+		alc_recon_track->fragments[i].toi = 0;
+	}
+	alc_recon_track->fragments_next = 0;
+}
+
+bool alc_recon_track_is_object_start(alc_recon_track_t* alc_recon_track, alc_packet_t* alc_packet) {
+	alc_recon_object_t* assembling = &alc_recon_track->assembling;
+	return !assembling->block || assembling->toi != alc_packet->def_lct_hdr.toi || !assembling->block->i_pos;
+}
+
+static void __alc_recon_track_gzip_start(alc_recon_track_t* alc_recon_track, const char* content_encoding) {
+	alc_recon_track->assembling_gzip = content_encoding && !strcasecmp(content_encoding, "gzip");
+	alc_recon_track->gzip_out_of_order = false;
+	alc_recon_track->gzip_next_offset = 0;
+	if(!alc_recon_track->assembling_gzip) {
+		return;
+	}
+
+	if(!alc_recon_track->gzip_stream) {
+		alc_recon_track->gzip_stream = atsc3_gzip_stream_new();
+	}
+	atsc3_gzip_stream_reset(alc_recon_track->gzip_stream);
+
+	if(!alc_recon_track->gzip_output) {
+		alc_recon_track->gzip_output = block_Alloc_flags(GZIP_CHUNK_OUTPUT_BUFFER_SIZE, BLOCK_FLAG_NO_ZERO);
 	} else {
-		//__ALC_UTILS_DEBUG("dumping to file step: %s, is complete: %d", file_name, alc_packet->close_object_flag);
+		block_Rewind(alc_recon_track->gzip_output);
 	}
-	//__ALC_RECON_MONITOR
-	//push our fragments EXCEPT for the mpu fragment box, we will pull that at the start of a
-		if(__ALC_RECON_MONITOR) {
-			__ALC_UTILS_IOTRACE("checking tsi: %u, toi: %u, close_object_flag: %d", alc_packet->def_lct_hdr->tsi, alc_packet->def_lct_hdr->toi, alc_packet->close_object_flag);
+}
 
-			if(alc_packet->close_object_flag && ((alc_packet->def_lct_hdr->tsi == __ALC_RECON_MONITOR->video_tsi && alc_packet->def_lct_hdr->toi != __ALC_RECON_MONITOR->video_toi_init) ||
-					(alc_packet->def_lct_hdr->tsi == __ALC_RECON_MONITOR->audio_tsi && alc_packet->def_lct_hdr->toi != __ALC_RECON_MONITOR->audio_toi_init))) {
+//inflate whatever part of [offset, end) continues the in order compressed prefix
+static void __alc_recon_track_gzip_add(alc_recon_track_t* alc_recon_track, uint32_t offset, uint8_t* payload, uint32_t len) {
+	uint64_t end = (uint64_t)offset + len;
+	if(alc_recon_track->gzip_out_of_order || end <= alc_recon_track->gzip_next_offset) {
+		return;
+	}
+	if(offset > alc_recon_track->gzip_next_offset) {
+		__ALC_UTILS_DEBUG("alc_recon_track: tsi: %u, toi: %u, gzip offset: %u, expected: %u, decoding on completion", alc_recon_track->tsi, alc_recon_track->assembling.toi, offset, alc_recon_track->gzip_next_offset);
+		alc_recon_track->gzip_out_of_order = true;
+		return;
+	}
 
-					alc_recon_file_buffer_struct_monitor_fragment_with_init_box(__ALC_RECON_MONITOR, alc_packet);
-			}
+	uint32_t skip = alc_recon_track->gzip_next_offset - offset;
+	if(atsc3_gzip_stream_inflate(alc_recon_track->gzip_stream, payload + skip, len - skip, alc_recon_track->gzip_output) < 0) {
+		//let the whole object decode on completion report it
+		alc_recon_track->gzip_out_of_order = true;
+		return;
+	}
+	alc_recon_track->gzip_next_offset = (uint32_t)end;
+}
+
+//the decoded object, or NULL if it is not valid gzip
+static block_t* __alc_recon_track_gzip_complete(alc_recon_track_t* alc_recon_track) {
+	block_t* compressed = alc_recon_track->assembling.block;
+
+	if(!alc_recon_track->gzip_out_of_order && alc_recon_track->gzip_stream->finished && alc_recon_track->gzip_next_offset == compressed->i_pos) {
+		return alc_recon_track->gzip_output;
+	}
+
+	if(atsc3_gzip_stream_inflate_all(alc_recon_track->gzip_stream, compressed->p_buffer, compressed->i_pos, alc_recon_track->gzip_output) == 1) {
+		return alc_recon_track->gzip_output;
+	}
+
+	__ALC_UTILS_WARN("alc_recon_track: tsi: %u, toi: %u, unable to gzip decode object, len: %u, keeping it as received", alc_recon_track->tsi, alc_recon_track->assembling.toi, compressed->i_pos);
+	return NULL;
+}
+
+alc_recon_object_t* alc_recon_track_add_packet(alc_recon_track_t* alc_recon_track, alc_packet_t* alc_packet) {
+	return alc_recon_track_add_packet_with_content_encoding(alc_recon_track, alc_packet, NULL);
+}
+
+alc_recon_object_t* alc_recon_track_add_packet_with_content_encoding(alc_recon_track_t* alc_recon_track, alc_packet_t* alc_packet, const char* content_encoding) {
+	//RaptorQ symbols are held by the session until the whole object is recovered
+	if(alc_packet->def_lct_hdr.tsi != alc_recon_track->tsi || alc_packet->fec_pending) {
+		return NULL;
+	}
+
+	uint32_t toi = alc_packet->def_lct_hdr.toi;
+	alc_recon_object_t* assembling = &alc_recon_track->assembling;
+
+	if(alc_recon_track_is_object_start(alc_recon_track, alc_packet)) {
+		__alc_recon_track_gzip_start(alc_recon_track, content_encoding);
+	}
+
+	uint32_t offset = 0;
+	if(alc_packet->use_sbn_esi) {
+		offset = alc_packet->esi;
+	} else if(alc_packet->use_start_offset) {
+		offset = alc_packet->start_offset;
+	}
+
+	//transfer_len comes from the 48 bit FEC OTI (40 bit for RaptorQ), nothing is sized from it
+	uint64_t end = (uint64_t)offset + alc_packet->alc_len;
+	if(end > ALC_RECON_OBJECT_LEN_MAX || alc_packet->transfer_len > ALC_RECON_OBJECT_LEN_MAX) {
+		__ALC_UTILS_WARN("alc_recon_track: tsi: %u, toi: %u, offset: %u, len: %u, transfer_len: %llu past max object len: %u, dropping",
+				alc_recon_track->tsi, toi, offset, alc_packet->alc_len, alc_packet->transfer_len, ALC_RECON_OBJECT_LEN_MAX);
+		return NULL;
+	}
+
+	if(!assembling->block) {
+		assembling->block = block_Alloc(end);
+		assembling->toi = toi;
+	} else if(assembling->toi != toi) {
+		//previous object never saw its close object flag, start over
+		if(assembling->block->i_pos) {
+			__ALC_UTILS_DEBUG("alc_recon_track: tsi: %u, dropping incomplete toi: %u, len: %u", alc_recon_track->tsi, assembling->toi, assembling->block->i_pos);
 		}
+		block_Rewind(assembling->block);
+		assembling->toi = toi;
+	}
 
+	//grow geometrically as the packets arrive, the block reused from an evicted object is usually large enough already
+	if(end > assembling->block->p_size) {
+		uint64_t grow_to = __MIN(__MAX(end, (uint64_t)assembling->block->p_size * 2), ALC_RECON_OBJECT_LEN_MAX);
+		if(!block_Resize(assembling->block, (uint32_t)grow_to) || assembling->block->p_size < end) {
+			return NULL;
+		}
+	}
 
-cleanup:
-	if(file_name) {
-		free(file_name);
+	memcpy(&assembling->block->p_buffer[offset], alc_packet->alc_payload, alc_packet->alc_len);
+	if(end > assembling->block->i_pos) {
+		assembling->block->i_pos = (uint32_t)end;
 	}
 
-	return bytesWritten;
+	if(alc_recon_track->assembling_gzip) {
+		__alc_recon_track_gzip_add(alc_recon_track, offset, alc_packet->alc_payload, alc_packet->alc_len);
+	}
+
+	//the close object flag can arrive ahead of the last missing range, wait for byte range coverage when tracked
+	if(!alc_packet_completes_object(alc_packet)) {
+		return NULL;
+	}
+
+	//the decoded object when gzip, the received bytes otherwise
+	block_t* object = NULL;
+	if(alc_recon_track->assembling_gzip) {
+		object = __alc_recon_track_gzip_complete(alc_recon_track);
+	}
+	if(!object) {
+		object = assembling->block;
+	}
+
+	alc_recon_object_t* completed = NULL;
+
+	if(toi == alc_recon_track->toi_init) {
+		completed = &alc_recon_track->init;
+
+		//carousel repeat of the init segment we already hold, nothing changes downstream
+		if(completed->block && completed->toi == toi && completed->block->i_pos == object->i_pos &&
+				!memcmp(completed->block->p_buffer, object->p_buffer, object->i_pos)) {
+			block_Rewind(assembling->block);
+			assembling->toi = 0;
+			return completed;
+		}
+
+		alc_recon_track->init_changed = completed->block != NULL;
+		__ALC_UTILS_DEBUG("alc_recon_track: tsi: %u, caching init toi: %u, len: %u, changed: %d", alc_recon_track->tsi, toi, object->i_pos, alc_recon_track->init_changed);
+	} else {
+		completed = &alc_recon_track->fragments[alc_recon_track->fragments_next];
+		alc_recon_track->fragments_next = (alc_recon_track->fragments_next + 1) % ALC_RECON_TRACK_FRAGMENTS_MAX;
+	}
+
+	//swap, the evicted buffer is reused for the next object (or the next gzip output, keeping the compressed buffer assembling)
+	block_t* evicted = completed->block;
+	completed->block = object;
+	completed->toi = toi;
+
+	if(object == alc_recon_track->gzip_output) {
+		alc_recon_track->gzip_output = evicted;
+	} else {
+		assembling->block = evicted;
+	}
+	assembling->toi = 0;
+	if(assembling->block) {
+		block_Rewind(assembling->block);
+	}
+
+	return completed;
+}
+
+alc_recon_object_t* alc_recon_track_find_fragment(alc_recon_track_t* alc_recon_track, uint32_t toi) {
+	for(int i = 0; i < ALC_RECON_TRACK_FRAGMENTS_MAX; i++) {
+		if(alc_recon_track->fragments[i].block && alc_recon_track->fragments[i].toi == toi) {
+			return &alc_recon_track->fragments[i];
+		}
+	}
+	return NULL;
+}
+
+void alc_recon_track_free(alc_recon_track_t** alc_recon_track_p) {
+	alc_recon_track_t* alc_recon_track = *alc_recon_track_p;
+	if(!alc_recon_track) {
+		return;
+	}
+
+	block_Release(&alc_recon_track->assembling.block);
+	block_Release(&alc_recon_track->init.block);
+	for(int i = 0; i < ALC_RECON_TRACK_FRAGMENTS_MAX; i++) {
+		block_Release(&alc_recon_track->fragments[i].block);
+	}
+	block_Release(&alc_recon_track->gzip_output);
+	atsc3_gzip_stream_free(&alc_recon_track->gzip_stream);
+	free(alc_recon_track);
+	*alc_recon_track_p = NULL;
+}
+
+static alc_recon_track_t* __alc_recon_track_sync(alc_recon_track_t** alc_recon_track_p, uint32_t tsi, uint32_t toi_init) {
+	if(!*alc_recon_track_p) {
+		*alc_recon_track_p = alc_recon_track_create(tsi, toi_init);
+	} else {
+		alc_recon_track_set_tsi_toi_init(*alc_recon_track_p, tsi, toi_init);
+	}
+	return *alc_recon_track_p;
+}
+
+//Content-MD5 of the File entry, 0 (never cached) without one: equal lengths say nothing about equal content
+static uint32_t __alc_recon_monitor_fdt_file_version(atsc3_fdt_file_t* atsc3_fdt_file) {
+	if(!atsc3_fdt_file->content_md5) {
+		return 0;
+	}
+
+	uint32_t version = 2166136261u;
+	for(const char* c = atsc3_fdt_file->content_md5; *c; c++) {
+		version = (version ^ (uint8_t)*c) * 16777619u;
+	}
+	return version ? version : 1;
+}
+
+//hands the versions of the files in tsi's FDT to the session, so a TOI re-used for new content is not taken for a carousel repeat
+static void __alc_recon_monitor_announce_fdt_versions(lls_sls_alc_monitor_t* lls_sls_alc_monitor, uint32_t tsi) {
+	if(!lls_sls_alc_monitor->lls_alc_session || !lls_sls_alc_monitor->lls_alc_session->alc_session || !lls_sls_alc_monitor->lls_alc_session->alc_session->alc_object_tracker) {
+		return;
+	}
+	atsc3_alc_object_tracker_t* atsc3_alc_object_tracker = lls_sls_alc_monitor->lls_alc_session->alc_session->alc_object_tracker;
+	atsc3_fdt_tsi_cache_t* atsc3_fdt_tsi_cache = atsc3_fdt_cache_find_tsi(lls_sls_alc_monitor->atsc3_fdt_cache, tsi);
+	if(!atsc3_fdt_tsi_cache) {
+		return;
+	}
+
+	for(uint32_t i = 0; i < atsc3_fdt_tsi_cache->toi_table_size; i++) {
+		atsc3_fdt_file_t* atsc3_fdt_file = atsc3_fdt_tsi_cache->toi_table[i].atsc3_fdt_file;
+		if(atsc3_fdt_file) {
+			atsc3_alc_object_tracker_announce_version(atsc3_alc_object_tracker, tsi, atsc3_fdt_file->toi, __alc_recon_monitor_fdt_file_version(atsc3_fdt_file));
+		}
+	}
+}
+
+//FDT-Instance objects are assembled on their own track so they never interrupt the media object in progress
+static void __alc_recon_monitor_add_fdt_packet(lls_sls_alc_monitor_t* lls_sls_alc_monitor, alc_recon_track_t** alc_fdt_recon_track_p, alc_packet_t* alc_packet) {
+	alc_recon_track_t* alc_fdt_recon_track = __alc_recon_track_sync(alc_fdt_recon_track_p, alc_packet->def_lct_hdr.tsi, 0);
+	alc_recon_object_t* completed = alc_recon_track_add_packet(alc_fdt_recon_track, alc_packet);
+	if(!completed) {
+		return;
+	}
+
+	if(!lls_sls_alc_monitor->atsc3_fdt_cache) {
+		lls_sls_alc_monitor->atsc3_fdt_cache = atsc3_fdt_cache_new();
+	}
+
+	if(atsc3_fdt_cache_update_from_payload(lls_sls_alc_monitor->atsc3_fdt_cache, alc_packet->def_lct_hdr.tsi, completed->block->p_buffer, completed->block->i_pos)) {
+		//Expires is in NTP seconds
+		uint32_t purged = atsc3_fdt_cache_purge_expired(lls_sls_alc_monitor->atsc3_fdt_cache, (uint32_t)(time(NULL) + 2208988800UL));
+		__ALC_UTILS_DEBUG("tsi: %u, merged FDT-Instance, len: %u, purged expired files: %u", alc_packet->def_lct_hdr.tsi, completed->block->i_pos, purged);
+		__alc_recon_monitor_announce_fdt_versions(lls_sls_alc_monitor, alc_packet->def_lct_hdr.tsi);
+	}
+}
+
+static void __alc_recon_monitor_s_tsid_free(void* ptr) {
+	atsc3_route_s_tsid_t* atsc3_route_s_tsid = (atsc3_route_s_tsid_t*)ptr;
+	atsc3_route_s_tsid_free(&atsc3_route_s_tsid);
+}
+
+//the S-TSID is authoritative for which LCT channels carry the service's video and audio
+static void __alc_recon_monitor_apply_s_tsid(lls_sls_alc_monitor_t* lls_sls_alc_monitor, atsc3_route_s_tsid_t* atsc3_route_s_tsid) {
+	atsc3_route_s_tsid_rs_ls_t* video = atsc3_route_s_tsid_find_ls_by_content_type(atsc3_route_s_tsid, "video");
+	atsc3_route_s_tsid_rs_ls_t* audio = atsc3_route_s_tsid_find_ls_by_content_type(atsc3_route_s_tsid, "audio");
+
+	if(video) {
+		lls_sls_alc_monitor->video_tsi = video->tsi;
+		if(video->src_flow_init_toi) {
+			lls_sls_alc_monitor->video_toi_init = video->src_flow_init_toi;
+		}
+	}
+	if(audio) {
+		lls_sls_alc_monitor->audio_tsi = audio->tsi;
+		if(audio->src_flow_init_toi) {
+			lls_sls_alc_monitor->audio_toi_init = audio->src_flow_init_toi;
+		}
+	}
+
+	__ALC_UTILS_DEBUG("S-TSID applied, RS count: %u, video_tsi: %u, video_toi_init: %u, audio_tsi: %u, audio_toi_init: %u", atsc3_route_s_tsid->atsc3_route_s_tsid_rs_v.count,
+			lls_sls_alc_monitor->video_tsi, lls_sls_alc_monitor->video_toi_init, lls_sls_alc_monitor->audio_tsi, lls_sls_alc_monitor->audio_toi_init);
+}
+
+//Content-Encoding of the object alc_packet starts from the FDT cache, the FDT lookup is skipped for every other packet
+static const char* __alc_recon_monitor_content_encoding(lls_sls_alc_monitor_t* lls_sls_alc_monitor, alc_recon_track_t* alc_recon_track, alc_packet_t* alc_packet) {
+	if(!lls_sls_alc_monitor->atsc3_fdt_cache || !alc_recon_track_is_object_start(alc_recon_track, alc_packet)) {
+		return NULL;
+	}
+
+	atsc3_fdt_file_t* atsc3_fdt_file = atsc3_fdt_cache_find_file(lls_sls_alc_monitor->atsc3_fdt_cache, alc_packet->def_lct_hdr.tsi, alc_packet->def_lct_hdr.toi);
+	return atsc3_fdt_file ? atsc3_fdt_file->content_encoding : NULL;
+}
+
+//SLS bundles are carried on TSI 0, TOI 0 is its EFDT
+static void __alc_recon_monitor_add_sls_packet(lls_sls_alc_monitor_t* lls_sls_alc_monitor, alc_packet_t* alc_packet) {
+	lls_sls_alc_session_t* lls_sls_alc_session = lls_sls_alc_monitor->lls_alc_session;
+	if(!lls_sls_alc_session) {
+		return;
+	}
+
+	if(!alc_packet->def_lct_hdr.toi) {
+		__alc_recon_monitor_add_fdt_packet(lls_sls_alc_monitor, &lls_sls_alc_monitor->sls_fdt_recon_track, alc_packet);
+		return;
+	}
+
+	alc_recon_track_t* sls_recon_track = __alc_recon_track_sync(&lls_sls_alc_monitor->sls_recon_track, 0, 0);
+	const char* content_encoding = __alc_recon_monitor_content_encoding(lls_sls_alc_monitor, sls_recon_track, alc_packet);
+	alc_recon_object_t* completed = alc_recon_track_add_packet_with_content_encoding(sls_recon_track, alc_packet, content_encoding);
+	if(!completed) {
+		return;
+	}
+
+	atsc3_route_s_tsid_t* atsc3_route_s_tsid = atsc3_route_s_tsid_update_from_sls_payload(lls_sls_alc_session->atsc3_route_s_tsid, completed->block->p_buffer, completed->block->i_pos,
+			lls_sls_alc_session->sls_destination_ip_address, lls_sls_alc_session->sls_destination_udp_port);
+	if(!atsc3_route_s_tsid) {
+		return;
+	}
+
+	//a flow dispatch rebuild on another thread or the TSI filter may still be walking the S-TSID we replace
+	atsc3_qsbr_retire(__atomic_exchange_n(&lls_sls_alc_session->atsc3_route_s_tsid, atsc3_route_s_tsid, __ATOMIC_ACQ_REL), __alc_recon_monitor_s_tsid_free);
+
+	__alc_recon_monitor_apply_s_tsid(lls_sls_alc_monitor, atsc3_route_s_tsid);
+	lls_sls_alc_monitor->atsc3_route_s_tsid_updated = true;
+}
+
+bool alc_recon_monitor_is_tsi_subscribed(lls_sls_alc_monitor_t* lls_sls_alc_monitor, uint32_t dst_ip_addr, uint16_t dst_port, uint32_t tsi) {
+	//the SLS is always needed to follow S-TSID changes
+	if(!tsi) {
+		return true;
+	}
+
+	atsc3_route_s_tsid_t* atsc3_route_s_tsid = lls_sls_alc_monitor->lls_alc_session ? __atomic_load_n(&lls_sls_alc_monitor->lls_alc_session->atsc3_route_s_tsid, __ATOMIC_ACQUIRE) : NULL;
+
+	//with route/ object dumps off, reconstitution of video_tsi and audio_tsi (and their repair flows) is the only consumer
+	if(!_ALC_PACKET_DUMP_TO_OBJECT_FILES_ENABLED && (lls_sls_alc_monitor->video_tsi || lls_sls_alc_monitor->audio_tsi)) {
+		if(tsi == lls_sls_alc_monitor->video_tsi || tsi == lls_sls_alc_monitor->audio_tsi) {
+			return true;
+		}
+		atsc3_route_s_tsid_rs_ls_t* atsc3_route_s_tsid_rs_ls = atsc3_route_s_tsid ? atsc3_route_s_tsid_find_ls(atsc3_route_s_tsid, dst_ip_addr, dst_port, tsi) : NULL;
+		return atsc3_route_s_tsid_rs_ls && atsc3_route_s_tsid_rs_ls->has_rpr_flow && atsc3_route_s_tsid_rs_ls->rpr_flow_protected_tsi &&
+				(atsc3_route_s_tsid_rs_ls->rpr_flow_protected_tsi == lls_sls_alc_monitor->video_tsi || atsc3_route_s_tsid_rs_ls->rpr_flow_protected_tsi == lls_sls_alc_monitor->audio_tsi);
+	}
+
+	//otherwise anything the S-TSID announces, and everything until we have one
+	return !atsc3_route_s_tsid || atsc3_route_s_tsid_find_ls(atsc3_route_s_tsid, dst_ip_addr, dst_port, tsi);
+}
+
+void alc_recon_monitor_add_packet(lls_sls_alc_monitor_t* lls_sls_alc_monitor, alc_packet_t* alc_packet) {
+	uint32_t tsi = alc_packet->def_lct_hdr.tsi;
+	alc_recon_track_t* alc_recon_track = NULL;
+
+	if(!tsi) {
+		__alc_recon_monitor_add_sls_packet(lls_sls_alc_monitor, alc_packet);
+		return;
+	}
+
+	if(tsi == lls_sls_alc_monitor->video_tsi) {
+		if(!alc_packet->def_lct_hdr.toi) {
+			__alc_recon_monitor_add_fdt_packet(lls_sls_alc_monitor, &lls_sls_alc_monitor->video_fdt_recon_track, alc_packet);
+			return;
+		}
+		alc_recon_track = __alc_recon_track_sync(&lls_sls_alc_monitor->video_recon_track, tsi, lls_sls_alc_monitor->video_toi_init);
+	} else if(tsi == lls_sls_alc_monitor->audio_tsi) {
+		if(!alc_packet->def_lct_hdr.toi) {
+			__alc_recon_monitor_add_fdt_packet(lls_sls_alc_monitor, &lls_sls_alc_monitor->audio_fdt_recon_track, alc_packet);
+			return;
+		}
+		alc_recon_track = __alc_recon_track_sync(&lls_sls_alc_monitor->audio_recon_track, tsi, lls_sls_alc_monitor->audio_toi_init);
+	} else {
+		return;
+	}
+
+	__ALC_UTILS_IOTRACE("checking tsi: %u, toi: %u, close_object_flag: %d", tsi, alc_packet->def_lct_hdr.toi, alc_packet->close_object_flag);
+
+	const char* content_encoding = __alc_recon_monitor_content_encoding(lls_sls_alc_monitor, alc_recon_track, alc_packet);
+	alc_recon_object_t* completed = alc_recon_track_add_packet_with_content_encoding(alc_recon_track, alc_packet, content_encoding);
+
+	if(completed && lls_sls_alc_monitor->atsc3_fdt_cache) {
+		atsc3_fdt_file_t* atsc3_fdt_file = atsc3_fdt_cache_find_file(lls_sls_alc_monitor->atsc3_fdt_cache, tsi, completed->toi);
+		if(atsc3_fdt_file) {
+			__ALC_UTILS_DEBUG("tsi: %u, toi: %u completed, location: %s, len: %u, content length: %u, encoding: %s", tsi, completed->toi,
+					atsc3_fdt_file->content_location, completed->block->i_pos, atsc3_fdt_file->content_length, atsc3_fdt_file->content_encoding ? atsc3_fdt_file->content_encoding : "");
+		}
+	}
+
+	//push our fragments EXCEPT for the init box, that is pulled from the track cache when the pair is written out
+	if(completed && completed != &alc_recon_track->init) {
+		alc_recon_file_buffer_struct_monitor_fragment_with_init_box(lls_sls_alc_monitor, alc_packet);
+	}
 }
 
 
+
 void __alc_prepend_fragment_with_init_box(char* file_name, alc_packet_t* alc_packet) {
 
 #if defined(__TESTING_PREPEND_TSI__) && defined(__TESTING_PREPEND_TOI_INIT__)
@@ -369,86 +814,61 @@ cleanup:
 
 bool __ALC_RECON_HAS_WRITTEN_INIT_BOX = false;
 
-void __alc_recon_fragment_with_init_box(char* file_name, alc_packet_t* alc_packet, uint32_t tsi, uint32_t toi_init, const char* to_write_filename) {
-
-
-	char* init_file_name = (char*)calloc(255, sizeof(char));
-	char* recon_file_name = (char*)calloc(255, sizeof(char)); //.m4v == 4
-	FILE* recon_output_file = NULL;
+//the file ptr, file buffer and recon file writers below all follow a single tsi through this track
+alc_recon_track_t* __ALC_RECON_FILE_TRACK = NULL;
 
-	__ALC_UTILS_DEBUG(" alc_recon_fragment_with_init_box: %u, %u,  %d", alc_packet->def_lct_hdr->tsi, alc_packet->def_lct_hdr->toi, alc_packet->close_object_flag);
+/*
+ * these writers must now be called for every packet of the tsi rather than only on the close object flag,
+ * the object is assembled in memory and written out once complete. file_name is no longer read
+ *
+ * returns the completed media segment, or NULL if alc_packet did not complete one
+ */
+static alc_recon_object_t* __alc_recon_file_track_add_packet(alc_packet_t* alc_packet, uint32_t tsi, uint32_t toi_init) {
+	alc_recon_track_t* alc_recon_track = __alc_recon_track_sync(&__ALC_RECON_FILE_TRACK, tsi, toi_init);
+	alc_recon_object_t* completed = alc_recon_track_add_packet(alc_recon_track, alc_packet);
 
-	snprintf(init_file_name, 255, "%s%u-%u", __ALC_DUMP_OUTPUT_PATH__, tsi, toi_init);
-	snprintf(recon_file_name, 255, "%s%s", __ALC_DUMP_OUTPUT_PATH__, to_write_filename );
+	if(completed == &alc_recon_track->init) {
+		return NULL;
+	}
+	if(completed && !alc_recon_track->init.block) {
+		__ALC_UTILS_ERROR("no init object for tsi: %u, toi_init: %u, dropping toi: %u", tsi, toi_init, completed->toi);
+		return NULL;
+	}
+	return completed;
+}
 
-	if(!__ALC_RECON_HAS_WRITTEN_INIT_BOX) {
+void __alc_recon_fragment_with_init_box(char* file_name, alc_packet_t* alc_packet, uint32_t tsi, uint32_t toi_init, const char* to_write_filename) {
+	char* recon_file_name = NULL;
+	FILE* recon_output_file = NULL;
 
+	alc_recon_object_t* fragment = __alc_recon_file_track_add_packet(alc_packet, tsi, toi_init);
+	if(!fragment) {
+		return;
+	}
 
-		if( access( init_file_name, F_OK ) == -1 ) {
-			__ALC_UTILS_ERROR("unable to open init file: %s", init_file_name);
-			return;
-		}
+	__ALC_UTILS_DEBUG(" alc_recon_fragment_with_init_box: %u, %u,  %d", alc_packet->def_lct_hdr.tsi, alc_packet->def_lct_hdr.toi, alc_packet->close_object_flag);
 
-		struct stat st;
-		stat(init_file_name, &st);
+	recon_file_name = (char*)calloc(255, sizeof(char));
+	snprintf(recon_file_name, 255, "%s%s", __ALC_DUMP_OUTPUT_PATH__, to_write_filename);
 
-		uint8_t* init_payload = (uint8_t*)calloc(st.st_size, sizeof(uint8_t));
-		FILE* init_file = fopen(init_file_name, "r");
-		if(!init_file || st.st_size == 0) {
-			__ALC_UTILS_ERROR("unable to open init file: %s", init_file_name);
-			return;
-		}
+	recon_output_file = fopen(recon_file_name, __ALC_RECON_HAS_WRITTEN_INIT_BOX ? "a" : "w");
+	if(!recon_output_file) {
+		__ALC_UTILS_ERROR("unable to open recon_output_file: %s", recon_file_name);
+		goto cleanup;
+	}
 
-		fread(init_payload, st.st_size, 1, init_file);
-		fclose(init_file);
-		recon_output_file = fopen(recon_file_name, "w");
-		if(!recon_output_file) {
-			__ALC_UTILS_ERROR("unable to open recon_output_file for writing: %s", recon_file_name);
-			return;
-		}
-		fwrite(init_payload, st.st_size, 1, recon_output_file);
+	if(!__ALC_RECON_HAS_WRITTEN_INIT_BOX || __ALC_RECON_FILE_TRACK->init_changed) {
+		fwrite(__ALC_RECON_FILE_TRACK->init.block->p_buffer, __ALC_RECON_FILE_TRACK->init.block->i_pos, 1, recon_output_file);
+		__ALC_RECON_FILE_TRACK->init_changed = false;
 		__ALC_RECON_HAS_WRITTEN_INIT_BOX = true;
-
-	} else {
-		recon_output_file = fopen(recon_file_name, "a");
-		if(!recon_output_file) {
-		__ALC_UTILS_ERROR("unable to open recon_output_file for append: %s", recon_file_name);
-		return;
-		}
 	}
 
-	uint64_t block_size = 8192;
+	fwrite(fragment->block->p_buffer, fragment->block->i_pos, 1, recon_output_file);
+	__ALC_UTILS_TRACE("write bytes: %u", fragment->block->i_pos);
+	fclose(recon_output_file);
 
-	FILE* m4v_fragment_input_file = fopen(file_name, "r");
-	uint8_t* m4v_payload = (uint8_t*)calloc(block_size, sizeof(uint8_t));
-	if(!m4v_fragment_input_file) {
-		__ALC_UTILS_ERROR("unable to open m4v fragment input: %s", file_name);
-		return;
-	}
-	struct stat fragment_input_stat;
-	stat(file_name, &fragment_input_stat);
-	uint64_t write_count=0;
-	bool has_eof = false;
-	while(!has_eof) {
-		int read_size = fread(m4v_payload, block_size, 1, m4v_fragment_input_file);
-		uint64_t read_bytes = read_size * block_size;
-		if(!read_bytes && feof(m4v_fragment_input_file)) {
-			read_bytes = fragment_input_stat.st_size - (block_size * write_count);
-			has_eof = true;
-		}
-		__ALC_UTILS_TRACE("read bytes: %llu", read_bytes);
-
-		int write_size = fwrite(m4v_payload, read_bytes, 1, recon_output_file);
-		if(has_eof) {
-			__ALC_UTILS_TRACE("write bytes: %u", write_size);
-
-			fclose(m4v_fragment_input_file);
-			fclose(recon_output_file);
-			break;
-		}
-		write_count++;
-	}
 cleanup:
+	freesafe(recon_file_name);
 	return;
 }
 
@@ -474,98 +894,36 @@ void alc_recon_file_ptr_fragment_with_init_box(FILE* output_file_ptr, alc_packet
 		return;
 	}
 
-	char* file_name = alc_packet_dump_to_object_get_filename(alc_packet);
-	uint32_t toi_init = to_match_toi_init;
-
-	char* init_file_name = (char* )calloc(255, sizeof(char));
-
-	__ALC_UTILS_DEBUG("recon %u, %u, %d", alc_packet->def_lct_hdr->tsi, alc_packet->def_lct_hdr->toi, alc_packet->close_object_flag);
-
-	snprintf(init_file_name, 255, "%s%u-%u", __ALC_DUMP_OUTPUT_PATH__, *__ALC_RECON_FILE_PTR_TSI, toi_init);
-
-	if(!__ALC_RECON_FILE_PTR_HAS_WRITTEN_INIT_BOX) {
-		if( access( init_file_name, F_OK ) == -1 ) {
-			__ALC_UTILS_ERROR("unable to open init file: %s", init_file_name);
-			return;
-		}
-
-		struct stat st;
-		stat(init_file_name, &st);
-
-		uint8_t* init_payload = (uint8_t*)calloc(st.st_size, sizeof(uint8_t));
-		FILE* init_file = fopen(init_file_name, "r");
-		if(!init_file || st.st_size == 0) {
-			__ALC_UTILS_ERROR("unable to open init file: %s", init_file_name);
-			return;
-		}
-
-		fread(init_payload, st.st_size, 1, init_file);
-		fclose(init_file);
-
-		fwrite(init_payload, st.st_size, 1, output_file_ptr);
-		__ALC_RECON_HAS_WRITTEN_INIT_BOX = true;
-
-	} else {
-		//noop here
+	alc_recon_object_t* fragment = __alc_recon_file_track_add_packet(alc_packet, *__ALC_RECON_FILE_PTR_TSI, to_match_toi_init);
+	if(!fragment) {
+		return;
 	}
 
-	uint64_t block_size = 8192;
+	__ALC_UTILS_DEBUG("recon %u, %u, %d", alc_packet->def_lct_hdr.tsi, alc_packet->def_lct_hdr.toi, alc_packet->close_object_flag);
 
-	FILE* m4v_fragment_input_file = fopen(file_name, "r");
-	uint8_t* m4v_payload = (uint8_t*)calloc(block_size, sizeof(uint8_t));
-	if(!m4v_fragment_input_file) {
-		__ALC_UTILS_ERROR("unable to open m4v fragment input: %s", file_name);
-		return;
+	if(!__ALC_RECON_FILE_PTR_HAS_WRITTEN_INIT_BOX || __ALC_RECON_FILE_TRACK->init_changed) {
+		fwrite(__ALC_RECON_FILE_TRACK->init.block->p_buffer, __ALC_RECON_FILE_TRACK->init.block->i_pos, 1, output_file_ptr);
+		__ALC_RECON_FILE_TRACK->init_changed = false;
+		__ALC_RECON_FILE_PTR_HAS_WRITTEN_INIT_BOX = true;
 	}
-	struct stat fragment_input_stat;
-	stat(file_name, &fragment_input_stat);
-	uint64_t write_count=0;
-	bool has_eof = false;
-	while(!has_eof) {
-		int read_size = fread(m4v_payload, block_size, 1, m4v_fragment_input_file);
-		uint64_t read_bytes = read_size * block_size;
-		if(!read_bytes && feof(m4v_fragment_input_file)) {
-			read_bytes = fragment_input_stat.st_size - (block_size * write_count);
-			has_eof = true;
-		}
-		__ALC_UTILS_TRACE("read bytes: %llu", read_bytes);
 
-		if(feof(output_file_ptr)) {
-			goto broken_pipe;
-		}
+	if(feof(output_file_ptr)) {
+		goto broken_pipe;
+	}
 
-		int write_size = fwrite(m4v_payload, read_bytes, 1, output_file_ptr);
-		if(has_eof) {
-			__ALC_UTILS_TRACE("write bytes: %u", write_size);
+	fwrite(fragment->block->p_buffer, fragment->block->i_pos, 1, output_file_ptr);
+	__ALC_UTILS_TRACE("write bytes: %u", fragment->block->i_pos);
 
-			fclose(m4v_fragment_input_file);
-			flush_ret = fflush(output_file_ptr);
-			if(flush_ret || feof(output_file_ptr)) {
-				goto broken_pipe;
-			}
-			break;
-		}
-		write_count++;
+	flush_ret = fflush(output_file_ptr);
+	if(flush_ret || feof(output_file_ptr)) {
+		goto broken_pipe;
 	}
-	goto cleanup;
+	return;
 
 broken_pipe:
 	__ALC_UTILS_ERROR("flush returned: %d, closing pipe", flush_ret);
 	fclose(__ALC_RECON_FILE_PTR);
 	__ALC_RECON_FILE_PTR = NULL;
-
-cleanup:
-	if(m4v_payload) {
-		free(m4v_payload);
-		m4v_payload = NULL;
-	}
-	if(file_name) {
-		free(file_name);
-		file_name = NULL;
-	}
-
-
-	return;
 }
 
 /*
@@ -595,89 +953,36 @@ void alc_recon_file_buffer_struct_set_monitor(lls_sls_alc_monitor_t* lls_sls_alc
 }
 
 
-/*** we take this off of disk for the reassembeled fragment metadta and mpu
+/*** the reassembled fragment and its init box come from the in-memory track, nothing is read back off disk
  *
  *
  */
 void alc_recon_file_buffer_struct_fragment_with_init_box(pipe_ffplay_buffer_t* pipe_ffplay_buffer, alc_packet_t* alc_packet) {
-	int flush_ret = 0;
 	if(!__ALC_RECON_FILE_PTR_TSI || !__ALC_RECON_FILE_PTR_TOI_INIT) {
 		__ALC_UTILS_WARN("alc_recon_file_ptr_fragment_with_init_box - NULL: tsi: %p, toi: %p", __ALC_RECON_FILE_PTR_TSI, __ALC_RECON_FILE_PTR_TOI_INIT);
 		return;
 	}
 
-	char* file_name = alc_packet_dump_to_object_get_filename(alc_packet);
-	uint32_t toi_init = *__ALC_RECON_FILE_PTR_TOI_INIT;
-	char* init_file_name = (char*)calloc(255, sizeof(char));
-
-	__ALC_UTILS_DEBUG("alc_recon_file_buffer_struct_fragment_with_init_box - ENTER - %u, %u,  %d", alc_packet->def_lct_hdr->tsi, alc_packet->def_lct_hdr->toi, alc_packet->close_object_flag);
+	alc_recon_object_t* fragment = __alc_recon_file_track_add_packet(alc_packet, *__ALC_RECON_FILE_PTR_TSI, *__ALC_RECON_FILE_PTR_TOI_INIT);
+	if(!fragment) {
+		return;
+	}
 
-	snprintf(init_file_name, 255, "%s%u-%u", __ALC_DUMP_OUTPUT_PATH__, *__ALC_RECON_FILE_PTR_TSI, toi_init);
+	__ALC_UTILS_DEBUG("alc_recon_file_buffer_struct_fragment_with_init_box - ENTER - %u, %u,  %d", alc_packet->def_lct_hdr.tsi, alc_packet->def_lct_hdr.toi, alc_packet->close_object_flag);
 
 	pipe_buffer_reader_mutex_lock(pipe_ffplay_buffer);
 
-	if(!pipe_ffplay_buffer->has_written_init_box) {
-		if( access( init_file_name, F_OK ) == -1 ) {
-			__ALC_UTILS_ERROR("unable to open init file: %s", init_file_name);
-			return;
-		}
-
-		struct stat st;
-		stat(init_file_name, &st);
-
-		uint8_t* init_payload = (uint8_t*)calloc(st.st_size, sizeof(uint8_t));
-		FILE* init_file = fopen(init_file_name, "r");
-		if(!init_file || st.st_size == 0) {
-			__ALC_UTILS_ERROR("unable to open init file: %s", init_file_name);
-			return;
-		}
-
-		fread(init_payload, st.st_size, 1, init_file);
-		fclose(init_file);
-
-		pipe_buffer_unsafe_push_block(pipe_ffplay_buffer, init_payload, st.st_size);
+	if(!pipe_ffplay_buffer->has_written_init_box || __ALC_RECON_FILE_TRACK->init_changed) {
+		pipe_buffer_unsafe_push_block(pipe_ffplay_buffer, __ALC_RECON_FILE_TRACK->init.block->p_buffer, __ALC_RECON_FILE_TRACK->init.block->i_pos);
+		__ALC_RECON_FILE_TRACK->init_changed = false;
 		pipe_ffplay_buffer->has_written_init_box = true;
-
-	} else {
-		//noop here
-	}
-
-	uint64_t block_size = __PLAYER_FFPLAY_PIPE_WRITER_BLOCKSIZE;
-
-	FILE* m4v_fragment_input_file = fopen(file_name, "r");
-	uint8_t* m4v_payload = (uint8_t*)calloc(block_size, sizeof(uint8_t));
-	if(!m4v_fragment_input_file) {
-		__ALC_UTILS_ERROR("unable to open m4v fragment input: %s", file_name);
-		return;
 	}
-	struct stat fragment_input_stat;
-	stat(file_name, &fragment_input_stat);
-	uint64_t write_count = 0;
-	uint64_t total_bytes_written = 0;
-	bool has_eof = false;
-
-	while(!has_eof) {
-		int read_size = fread(m4v_payload, block_size, 1, m4v_fragment_input_file);
-		uint64_t read_bytes = read_size * block_size;
-		if(!read_bytes && feof(m4v_fragment_input_file)) {
-			read_bytes = fragment_input_stat.st_size - (block_size * write_count);
-			has_eof = true;
-		}
-		total_bytes_written += read_bytes;
-		__ALC_UTILS_TRACE("read bytes: %llu, bytes written: %llu, total filesize: %llu, has eof input: %d", read_bytes, total_bytes_written, fragment_input_stat.st_size, has_eof);
 
-		pipe_buffer_unsafe_push_block(pipe_ffplay_buffer, m4v_payload, read_bytes);
-
-		if(has_eof) {
-			fclose(m4v_fragment_input_file);
-			break;
-		}
-		write_count++;
-
-	}
+	pipe_buffer_unsafe_push_block(pipe_ffplay_buffer, fragment->block->p_buffer, fragment->block->i_pos);
+	__ALC_UTILS_TRACE("bytes written: %u", fragment->block->i_pos);
 
 	//signal and then unlock, docs indicate the only way to ensure a signal is not lost is to send it while holding the lock
-	__ALC_UTILS_DEBUG("alc_recon_file_buffer_struct_fragment_with_init_box - SIGNALING - %u, %u,  %d", alc_packet->def_lct_hdr->tsi, alc_packet->def_lct_hdr->toi, alc_packet->close_object_flag);
+	__ALC_UTILS_DEBUG("alc_recon_file_buffer_struct_fragment_with_init_box - SIGNALING - %u, %u,  %d", alc_packet->def_lct_hdr.tsi, alc_packet->def_lct_hdr.toi, alc_packet->close_object_flag);
 
 	pipe_buffer_notify_semaphore_post(pipe_ffplay_buffer);
 
@@ -685,55 +990,31 @@ void alc_recon_file_buffer_struct_fragment_with_init_box(pipe_ffplay_buffer_t* p
 	pipe_buffer_reader_check_if_shutdown(&pipe_ffplay_buffer);
 
 	pipe_buffer_reader_mutex_unlock(pipe_ffplay_buffer);
-	__ALC_UTILS_DEBUG("alc_recon_file_buffer_struct_fragment_with_init_box - RETURN - %u, %u,  %d", alc_packet->def_lct_hdr->tsi, alc_packet->def_lct_hdr->toi, alc_packet->close_object_flag);
-
-	goto cleanup;
-
-broken_pipe:
-	__ALC_UTILS_ERROR("flush returned: %d, closing pipe", flush_ret);
-	fclose(__ALC_RECON_FILE_PTR);
-	__ALC_RECON_FILE_PTR = NULL;
-
-cleanup:
-	if(m4v_payload) {
-		free(m4v_payload);
-		m4v_payload = NULL;
-	}
-	if(file_name) {
-		free(file_name);
-		file_name = NULL;
-	}
-
-
-	return;
+	__ALC_UTILS_DEBUG("alc_recon_file_buffer_struct_fragment_with_init_box - RETURN - %u, %u,  %d", alc_packet->def_lct_hdr.tsi, alc_packet->def_lct_hdr.toi, alc_packet->close_object_flag);
 }
 
 
 void alc_recon_file_buffer_struct_monitor_fragment_with_init_box(lls_sls_alc_monitor_t* lls_sls_alc_monitor, alc_packet_t* alc_packet) {
-	int flush_ret = 0;
-	char* audio_init_file_name = NULL;
-	char* video_init_file_name = NULL;
-	char* audio_fragment_file_name = NULL;
-	char* video_fragment_file_name = NULL;
-	block_t* audio_fragment_payload = NULL;
-	block_t* video_fragment_payload = NULL;
-	block_t* audio_init_payload = NULL;
-	block_t* video_init_payload = NULL;
-
-	//alc_packet->def_lct_hdr->toi hack
-	if(alc_packet->def_lct_hdr->tsi == lls_sls_alc_monitor->video_tsi) {
-		lls_sls_alc_monitor->last_video_toi = alc_packet->def_lct_hdr->toi;
+	alc_recon_track_t* audio_recon_track = lls_sls_alc_monitor->audio_recon_track;
+	alc_recon_track_t* video_recon_track = lls_sls_alc_monitor->video_recon_track;
+	alc_recon_object_t* audio_fragment = NULL;
+	alc_recon_object_t* video_fragment = NULL;
+	lls_sls_monitor_output_buffer_t* lls_sls_monitor_output_buffer = &lls_sls_alc_monitor->lls_sls_monitor_output_buffer;
+
+	//alc_packet->def_lct_hdr.toi hack
+	if(alc_packet->def_lct_hdr.tsi == lls_sls_alc_monitor->video_tsi) {
+		lls_sls_alc_monitor->last_video_toi = alc_packet->def_lct_hdr.toi;
 	}
-	if(alc_packet->def_lct_hdr->tsi == lls_sls_alc_monitor->audio_tsi) {
-		lls_sls_alc_monitor->last_audio_toi = alc_packet->def_lct_hdr->toi;
+	if(alc_packet->def_lct_hdr.tsi == lls_sls_alc_monitor->audio_tsi) {
+		lls_sls_alc_monitor->last_audio_toi = alc_packet->def_lct_hdr.toi;
 	}
 
     uint32_t audio_toi = lls_sls_alc_monitor->last_audio_toi;
     uint32_t video_toi = lls_sls_alc_monitor->last_video_toi;
     
-    if(!audio_toi || !video_toi) {
+    if(!audio_toi || !video_toi || !audio_recon_track || !video_recon_track) {
         __ALC_UTILS_WARN("audio toi: %u, video toi: %u, bailing", audio_toi, video_toi);
-        goto cleanup;
+        return;
     }
     
 	if(audio_toi != video_toi) {
@@ -745,59 +1026,37 @@ void alc_recon_file_buffer_struct_monitor_fragment_with_init_box(lls_sls_alc_mon
     
     if(lls_sls_alc_monitor->processed_toi && (lls_sls_alc_monitor->processed_toi == audio_toi || lls_sls_alc_monitor->processed_toi ==video_toi)) {
         __ALC_UTILS_WARN("processed toi: %u, audio toi: %u, video toi: %u, bailing for next counterpart", lls_sls_alc_monitor->processed_toi, audio_toi, video_toi);
-        goto cleanup;
+        return;
     }
 
-	audio_init_file_name = alc_packet_dump_to_object_get_filename_tsi_toi(lls_sls_alc_monitor->audio_tsi, lls_sls_alc_monitor->audio_toi_init);
-	video_init_file_name = alc_packet_dump_to_object_get_filename_tsi_toi(lls_sls_alc_monitor->video_tsi, lls_sls_alc_monitor->video_toi_init);
-
-	audio_fragment_file_name = alc_packet_dump_to_object_get_filename_tsi_toi(lls_sls_alc_monitor->audio_tsi, audio_toi);
-	video_fragment_file_name = alc_packet_dump_to_object_get_filename_tsi_toi(lls_sls_alc_monitor->video_tsi, video_toi);
-
-	audio_fragment_payload = alc_get_payload_from_filename(audio_fragment_file_name);
-	video_fragment_payload = alc_get_payload_from_filename(video_fragment_file_name);
+	audio_fragment = alc_recon_track_find_fragment(audio_recon_track, audio_toi);
+	video_fragment = alc_recon_track_find_fragment(video_recon_track, video_toi);
 
-	if(audio_fragment_payload && video_fragment_payload) {
+	if(audio_fragment && video_fragment) {
 
-		__ALC_UTILS_DEBUG("alc_recon_file_buffer_struct_monitor_fragment_with_init_box - audio: %s, video: %s", audio_init_file_name, video_init_file_name);
+		__ALC_UTILS_DEBUG("alc_recon_file_buffer_struct_monitor_fragment_with_init_box - audio toi: %u, video toi: %u", audio_toi, video_toi);
 
-		if(!lls_sls_alc_monitor->lls_sls_monitor_output_buffer.has_written_init_box) {
-			audio_init_payload = alc_get_payload_from_filename(audio_init_file_name);
-			video_init_payload = alc_get_payload_from_filename(video_init_file_name);
-
-			if(audio_init_payload && video_init_payload) {
-				lls_sls_monitor_output_buffer_copy_audio_init_block(&lls_sls_alc_monitor->lls_sls_monitor_output_buffer, audio_init_payload);
-				lls_sls_monitor_output_buffer_copy_video_init_block(&lls_sls_alc_monitor->lls_sls_monitor_output_buffer, video_init_payload);
-
-			} else {
-				__ALC_UTILS_ERROR("missing init payloads, audio: %p, video: %p", audio_init_payload, video_init_payload);
-				goto cleanup;
+		//the init boxes are cached per track, only copied on the first pair or when the sender changes them
+		if(!lls_sls_monitor_output_buffer->has_written_init_box || audio_recon_track->init_changed || video_recon_track->init_changed) {
+			if(!audio_recon_track->init.block || !video_recon_track->init.block) {
+				__ALC_UTILS_ERROR("missing init payloads, audio: %p, video: %p", audio_recon_track->init.block, video_recon_track->init.block);
+				return;
 			}
 
-		} else {
-			//noop here
+			lls_sls_monitor_output_buffer->audio_output_buffer_isobmff.init_box_pos = 0;
+			lls_sls_monitor_output_buffer->video_output_buffer_isobmff.init_box_pos = 0;
+			lls_sls_monitor_output_buffer_copy_audio_init_block(lls_sls_monitor_output_buffer, audio_recon_track->init.block);
+			lls_sls_monitor_output_buffer_copy_video_init_block(lls_sls_monitor_output_buffer, video_recon_track->init.block);
+			audio_recon_track->init_changed = false;
+			video_recon_track->init_changed = false;
 		}
 
-
-		lls_sls_monitor_output_buffer_copy_audio_fragment_block(&lls_sls_alc_monitor->lls_sls_monitor_output_buffer, audio_fragment_payload);
-		lls_sls_monitor_output_buffer_copy_video_fragment_block(&lls_sls_alc_monitor->lls_sls_monitor_output_buffer, video_fragment_payload);
-		lls_sls_alc_monitor->lls_sls_monitor_output_buffer.has_written_init_box = true;
-		lls_sls_alc_monitor->lls_sls_monitor_output_buffer.should_flush_output_buffer = true;
+		lls_sls_monitor_output_buffer_copy_audio_fragment_block(lls_sls_monitor_output_buffer, audio_fragment->block);
+		lls_sls_monitor_output_buffer_copy_video_fragment_block(lls_sls_monitor_output_buffer, video_fragment->block);
+		lls_sls_monitor_output_buffer->has_written_init_box = true;
+		lls_sls_monitor_output_buffer->should_flush_output_buffer = true;
         lls_sls_alc_monitor->processed_toi = audio_toi;
 	}
 
-	__ALC_UTILS_DEBUG("alc_recon_file_buffer_struct_fragment_with_init_box - RETURN - %u, %u,  %d", alc_packet->def_lct_hdr->tsi, alc_packet->def_lct_hdr->toi, alc_packet->close_object_flag);
-
-cleanup:
-	freesafe(audio_init_file_name);
-	freesafe(video_init_file_name);
-	freesafe(audio_fragment_file_name);
-	freesafe(video_fragment_file_name);
-	block_Release(&audio_fragment_payload);
-	block_Release(&video_fragment_payload);
-	block_Release(&audio_init_payload);
-	block_Release(&video_init_payload);
-
-	return;
+	__ALC_UTILS_DEBUG("alc_recon_file_buffer_struct_fragment_with_init_box - RETURN - %u, %u,  %d", alc_packet->def_lct_hdr.tsi, alc_packet->def_lct_hdr.toi, alc_packet->close_object_flag);
 }
-
@@ -17,6 +17,7 @@
 #include "atsc3_player_ffplay.h"
 #include "atsc3_lls_types.h"
 #include "atsc3_lls_sls_monitor_output_buffer.h"
+#include "atsc3_gzip.h"
 
 #ifndef ATSC3_ALC_UTILS_H_
 #define ATSC3_ALC_UTILS_H_
@@ -44,6 +45,8 @@ extern int _ALC_UTILS_TRACE_ENABLED;
 
 //this must be set to 1 for dumps to be written to disk
 extern int _ALC_PACKET_DUMP_TO_OBJECT_ENABLED;
+//route/ object files, playback is reconstituted in memory and does not need them
+extern int _ALC_PACKET_DUMP_TO_OBJECT_FILES_ENABLED;
 
 char* alc_packet_dump_to_object_get_filename(alc_packet_t* alc_packet);
 
@@ -66,6 +69,68 @@ void alc_recon_file_buffer_struct_fragment_with_init_box(pipe_ffplay_buffer_t* p
 char* alc_packet_dump_to_object_get_filename_tsi_toi(uint32_t tsi, uint32_t toi);
 void alc_recon_file_buffer_struct_monitor_fragment_with_init_box(lls_sls_alc_monitor_t* lls_slt_monitor, alc_packet_t* alc_packet);
 void __alc_prepend_fragment_with_init_box(char* file_name, alc_packet_t* alc_packet);
+
+/**
+ * in-memory ROUTE/DASH object reconstitution
+ *
+ * an alc_recon_track_t follows one TSI: packets are assembled into the TOI currently being received, and on the close
+ * object flag that buffer becomes either the cached init segment (toi_init) or one of the last
+ * ALC_RECON_TRACK_FRAGMENTS_MAX completed media segments. buffers are swapped rather than copied, the evicted one is
+ * reused for the next object.
+ *
+ * the init segment is only replaced when toi_init changes or a carousel repeat carries different bytes, in which
+ * case init_changed is set so the output buffer re-copies it. nothing is read back from the route/ dump directory
+ *
+ * objects announced with FDT Content-Encoding: gzip are inflated into gzip_output as their packets arrive in order, so the
+ * decoded object is ready as soon as the close object flag lands. if a packet arrives out of order the rest of the object is
+ * only buffered and decoded as a whole on completion. either way the completed object holds the decoded bytes
+ */
+#define ALC_RECON_TRACK_FRAGMENTS_MAX 4
+
+//packets of larger objects (by transfer_len or offset) are dropped rather than assembled
+#define ALC_RECON_OBJECT_LEN_MAX (64 * 1024 * 1024)
+
+typedef struct alc_recon_object {
+	uint32_t	toi;
+	block_t*	block;		//i_pos is the object length
+} alc_recon_object_t;
+
+typedef struct alc_recon_track {
+	uint32_t			tsi;
+	uint32_t			toi_init;
+
+	alc_recon_object_t	assembling;
+	alc_recon_object_t	init;
+	bool				init_changed;
+
+	alc_recon_object_t	fragments[ALC_RECON_TRACK_FRAGMENTS_MAX];
+	uint32_t			fragments_next;
+
+	//Content-Encoding: gzip of the assembling object
+	bool					assembling_gzip;
+	bool					gzip_out_of_order;
+	uint32_t				gzip_next_offset;	//compressed bytes inflated so far
+	atsc3_gzip_stream_t*	gzip_stream;
+	block_t*				gzip_output;
+} alc_recon_track_t;
+
+alc_recon_track_t* alc_recon_track_create(uint32_t tsi, uint32_t toi_init);
+//drops the cached objects if tsi or toi_init changed
+void alc_recon_track_set_tsi_toi_init(alc_recon_track_t* alc_recon_track, uint32_t tsi, uint32_t toi_init);
+//returns the completed init or media segment when alc_packet closes its object, NULL otherwise
+alc_recon_object_t* alc_recon_track_add_packet(alc_recon_track_t* alc_recon_track, alc_packet_t* alc_packet);
+//as above, content_encoding (e.g. from the FDT-Instance File entry) is only read when alc_packet starts a new object
+alc_recon_object_t* alc_recon_track_add_packet_with_content_encoding(alc_recon_track_t* alc_recon_track, alc_packet_t* alc_packet, const char* content_encoding);
+//true if alc_packet is the first packet of a new object on this track
+bool alc_recon_track_is_object_start(alc_recon_track_t* alc_recon_track, alc_packet_t* alc_packet);
+alc_recon_object_t* alc_recon_track_find_fragment(alc_recon_track_t* alc_recon_track, uint32_t toi);
+void alc_recon_track_free(alc_recon_track_t** alc_recon_track_p);
+
+//feeds the monitored audio/video tracks and pushes each completed audio/video segment pair to the output buffer.
+//SLS objects on TSI 0 are parsed for their S-TSID, which sets video_tsi/audio_tsi and flags atsc3_route_s_tsid_updated
+void alc_recon_monitor_add_packet(lls_sls_alc_monitor_t* lls_sls_alc_monitor, alc_packet_t* alc_packet);
+//false if nothing downstream of the monitor consumes this LCT channel, checked before alc_rx so the packet can be dropped unparsed
+bool alc_recon_monitor_is_tsi_subscribed(lls_sls_alc_monitor_t* lls_sls_alc_monitor, uint32_t dst_ip_addr, uint16_t dst_port, uint32_t tsi);
 void __alc_recon_fragment_with_init_box(char* file_name, alc_packet_t* alc_packet, uint32_t tsi, uint32_t toi_init, const char* to_write_filename);
 
 block_t* alc_get_payload_from_filename(char*);
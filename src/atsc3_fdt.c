@@ -9,3 +9,191 @@
 
 ATSC3_VECTOR_BUILDER_METHODS_IMPLEMENTATION(atsc3_fdt_instance, atsc3_fdt_file)
 
+
+void atsc3_fdt_file_free(atsc3_fdt_file_t** atsc3_fdt_file_p) {
+	atsc3_fdt_file_t* atsc3_fdt_file = *atsc3_fdt_file_p;
+	if(!atsc3_fdt_file) {
+		return;
+	}
+
+	freesafe(atsc3_fdt_file->content_location);
+	freesafe(atsc3_fdt_file->content_type);
+	freesafe(atsc3_fdt_file->content_encoding);
+	freesafe(atsc3_fdt_file->content_md5);
+	freesafe(atsc3_fdt_file->atsc3_fdt_fec_attributes.fec_oti_sceheme_specific_info);
+	free(atsc3_fdt_file);
+	*atsc3_fdt_file_p = NULL;
+}
+
+void atsc3_fdt_instance_free(atsc3_fdt_instance_t** atsc3_fdt_instance_p) {
+	atsc3_fdt_instance_t* atsc3_fdt_instance = *atsc3_fdt_instance_p;
+	if(!atsc3_fdt_instance) {
+		return;
+	}
+
+	for(int i = 0; i < atsc3_fdt_instance->atsc3_fdt_file_v.count; i++) {
+		atsc3_fdt_file_free(&atsc3_fdt_instance->atsc3_fdt_file_v.data[i]);
+	}
+	freesafe(atsc3_fdt_instance->atsc3_fdt_file_v.data);
+	freesafe(atsc3_fdt_instance->content_type);
+	freesafe(atsc3_fdt_instance->content_encoding);
+	freesafe(atsc3_fdt_instance->atsc3_fdt_fec_attributes.fec_oti_sceheme_specific_info);
+	free(atsc3_fdt_instance);
+	*atsc3_fdt_instance_p = NULL;
+}
+
+/*
+ * per TSI FDT cache, see atsc3_fdt.h
+ */
+
+//fibonacci hashing, TOIs are mostly sequential
+static inline uint32_t __atsc3_fdt_tsi_cache_slot_index(atsc3_fdt_tsi_cache_t* atsc3_fdt_tsi_cache, uint32_t toi) {
+	return (toi * 2654435769u) & (atsc3_fdt_tsi_cache->toi_table_size - 1);
+}
+
+static atsc3_fdt_tsi_cache_slot_t* __atsc3_fdt_tsi_cache_find_slot(atsc3_fdt_tsi_cache_t* atsc3_fdt_tsi_cache, uint32_t toi) {
+	uint32_t i = __atsc3_fdt_tsi_cache_slot_index(atsc3_fdt_tsi_cache, toi);
+	while(atsc3_fdt_tsi_cache->toi_table[i].atsc3_fdt_file) {
+		if(atsc3_fdt_tsi_cache->toi_table[i].atsc3_fdt_file->toi == toi) {
+			return &atsc3_fdt_tsi_cache->toi_table[i];
+		}
+		i = (i + 1) & (atsc3_fdt_tsi_cache->toi_table_size - 1);
+	}
+	//empty slot where toi would be inserted
+	return &atsc3_fdt_tsi_cache->toi_table[i];
+}
+
+static void __atsc3_fdt_tsi_cache_resize(atsc3_fdt_tsi_cache_t* atsc3_fdt_tsi_cache, uint32_t toi_table_size) {
+	atsc3_fdt_tsi_cache_slot_t* old_toi_table = atsc3_fdt_tsi_cache->toi_table;
+	uint32_t old_toi_table_size = atsc3_fdt_tsi_cache->toi_table_size;
+
+	atsc3_fdt_tsi_cache->toi_table = calloc(toi_table_size, sizeof(atsc3_fdt_tsi_cache_slot_t));
+	atsc3_fdt_tsi_cache->toi_table_size = toi_table_size;
+
+	for(uint32_t i = 0; i < old_toi_table_size; i++) {
+		if(old_toi_table[i].atsc3_fdt_file) {
+			*__atsc3_fdt_tsi_cache_find_slot(atsc3_fdt_tsi_cache, old_toi_table[i].atsc3_fdt_file->toi) = old_toi_table[i];
+		}
+	}
+	freesafe(old_toi_table);
+}
+
+//backward shift delete, keeps every probe sequence unbroken without tombstones
+static void __atsc3_fdt_tsi_cache_remove_slot(atsc3_fdt_tsi_cache_t* atsc3_fdt_tsi_cache, uint32_t i) {
+	uint32_t mask = atsc3_fdt_tsi_cache->toi_table_size - 1;
+
+	atsc3_fdt_file_free(&atsc3_fdt_tsi_cache->toi_table[i].atsc3_fdt_file);
+	atsc3_fdt_tsi_cache->toi_table_count--;
+
+	uint32_t j = i;
+	while(true) {
+		j = (j + 1) & mask;
+		if(!atsc3_fdt_tsi_cache->toi_table[j].atsc3_fdt_file) {
+			break;
+		}
+		uint32_t home = __atsc3_fdt_tsi_cache_slot_index(atsc3_fdt_tsi_cache, atsc3_fdt_tsi_cache->toi_table[j].atsc3_fdt_file->toi);
+		//move j into the hole at i unless its home lies cyclically in (i, j]
+		if(((j - home) & mask) >= ((j - i) & mask)) {
+			atsc3_fdt_tsi_cache->toi_table[i] = atsc3_fdt_tsi_cache->toi_table[j];
+			atsc3_fdt_tsi_cache->toi_table[j].atsc3_fdt_file = NULL;
+			i = j;
+		}
+	}
+}
+
+void atsc3_fdt_tsi_cache_add_file(atsc3_fdt_tsi_cache_t* atsc3_fdt_tsi_cache, atsc3_fdt_file_t* atsc3_fdt_file, uint32_t expires) {
+	//keep the load factor under 3/4
+	if(!atsc3_fdt_tsi_cache->toi_table_size) {
+		__atsc3_fdt_tsi_cache_resize(atsc3_fdt_tsi_cache, ATSC3_FDT_TSI_CACHE_TOI_TABLE_DEFAULT_SIZE);
+	} else if((atsc3_fdt_tsi_cache->toi_table_count + 1) * 4 > atsc3_fdt_tsi_cache->toi_table_size * 3) {
+		__atsc3_fdt_tsi_cache_resize(atsc3_fdt_tsi_cache, atsc3_fdt_tsi_cache->toi_table_size * 2);
+	}
+
+	atsc3_fdt_tsi_cache_slot_t* atsc3_fdt_tsi_cache_slot = __atsc3_fdt_tsi_cache_find_slot(atsc3_fdt_tsi_cache, atsc3_fdt_file->toi);
+	if(atsc3_fdt_tsi_cache_slot->atsc3_fdt_file) {
+		atsc3_fdt_file_free(&atsc3_fdt_tsi_cache_slot->atsc3_fdt_file);
+	} else {
+		atsc3_fdt_tsi_cache->toi_table_count++;
+	}
+	atsc3_fdt_tsi_cache_slot->atsc3_fdt_file = atsc3_fdt_file;
+	atsc3_fdt_tsi_cache_slot->expires = expires;
+}
+
+atsc3_fdt_file_t* atsc3_fdt_tsi_cache_find_file(atsc3_fdt_tsi_cache_t* atsc3_fdt_tsi_cache, uint32_t toi) {
+	if(!atsc3_fdt_tsi_cache || !atsc3_fdt_tsi_cache->toi_table_count) {
+		return NULL;
+	}
+	return __atsc3_fdt_tsi_cache_find_slot(atsc3_fdt_tsi_cache, toi)->atsc3_fdt_file;
+}
+
+atsc3_fdt_cache_t* atsc3_fdt_cache_new() {
+	return calloc(1, sizeof(atsc3_fdt_cache_t));
+}
+
+atsc3_fdt_tsi_cache_t* atsc3_fdt_cache_find_tsi(atsc3_fdt_cache_t* atsc3_fdt_cache, uint32_t tsi) {
+	//only a handful of TSIs per service
+	for(int i = 0; i < atsc3_fdt_cache->atsc3_fdt_tsi_cache_n; i++) {
+		if(atsc3_fdt_cache->atsc3_fdt_tsi_cache[i]->tsi == tsi) {
+			return atsc3_fdt_cache->atsc3_fdt_tsi_cache[i];
+		}
+	}
+	return NULL;
+}
+
+atsc3_fdt_tsi_cache_t* atsc3_fdt_cache_get_or_create_tsi(atsc3_fdt_cache_t* atsc3_fdt_cache, uint32_t tsi) {
+	atsc3_fdt_tsi_cache_t* atsc3_fdt_tsi_cache = atsc3_fdt_cache_find_tsi(atsc3_fdt_cache, tsi);
+	if(atsc3_fdt_tsi_cache) {
+		return atsc3_fdt_tsi_cache;
+	}
+
+	atsc3_fdt_tsi_cache = calloc(1, sizeof(atsc3_fdt_tsi_cache_t));
+	atsc3_fdt_tsi_cache->tsi = tsi;
+
+	atsc3_fdt_cache->atsc3_fdt_tsi_cache = realloc(atsc3_fdt_cache->atsc3_fdt_tsi_cache, (atsc3_fdt_cache->atsc3_fdt_tsi_cache_n + 1) * sizeof(atsc3_fdt_tsi_cache_t*));
+	atsc3_fdt_cache->atsc3_fdt_tsi_cache[atsc3_fdt_cache->atsc3_fdt_tsi_cache_n++] = atsc3_fdt_tsi_cache;
+
+	return atsc3_fdt_tsi_cache;
+}
+
+atsc3_fdt_file_t* atsc3_fdt_cache_find_file(atsc3_fdt_cache_t* atsc3_fdt_cache, uint32_t tsi, uint32_t toi) {
+	return atsc3_fdt_tsi_cache_find_file(atsc3_fdt_cache_find_tsi(atsc3_fdt_cache, tsi), toi);
+}
+
+uint32_t atsc3_fdt_cache_purge_expired(atsc3_fdt_cache_t* atsc3_fdt_cache, uint32_t now_ntp_seconds) {
+	uint32_t purged = 0;
+
+	for(int i = 0; i < atsc3_fdt_cache->atsc3_fdt_tsi_cache_n; i++) {
+		atsc3_fdt_tsi_cache_t* atsc3_fdt_tsi_cache = atsc3_fdt_cache->atsc3_fdt_tsi_cache[i];
+		uint32_t j = 0;
+		while(j < atsc3_fdt_tsi_cache->toi_table_size) {
+			if(atsc3_fdt_tsi_cache->toi_table[j].atsc3_fdt_file && atsc3_fdt_tsi_cache->toi_table[j].expires < now_ntp_seconds) {
+				//a later slot may be shifted into j, check it again
+				__atsc3_fdt_tsi_cache_remove_slot(atsc3_fdt_tsi_cache, j);
+				purged++;
+			} else {
+				j++;
+			}
+		}
+	}
+
+	return purged;
+}
+
+void atsc3_fdt_cache_free(atsc3_fdt_cache_t** atsc3_fdt_cache_p) {
+	atsc3_fdt_cache_t* atsc3_fdt_cache = *atsc3_fdt_cache_p;
+	if(!atsc3_fdt_cache) {
+		return;
+	}
+
+	for(int i = 0; i < atsc3_fdt_cache->atsc3_fdt_tsi_cache_n; i++) {
+		atsc3_fdt_tsi_cache_t* atsc3_fdt_tsi_cache = atsc3_fdt_cache->atsc3_fdt_tsi_cache[i];
+		for(uint32_t j = 0; j < atsc3_fdt_tsi_cache->toi_table_size; j++) {
+			atsc3_fdt_file_free(&atsc3_fdt_tsi_cache->toi_table[j].atsc3_fdt_file);
+		}
+		freesafe(atsc3_fdt_tsi_cache->toi_table);
+		free(atsc3_fdt_tsi_cache);
+	}
+	freesafe(atsc3_fdt_cache->atsc3_fdt_tsi_cache);
+	free(atsc3_fdt_cache);
+	*atsc3_fdt_cache_p = NULL;
+}
@@ -179,5 +179,64 @@ typedef struct atsc3_fdt_instance {
 
 ATSC3_VECTOR_BUILDER_METHODS_INTERFACE(atsc3_fdt_instance, atsc3_fdt_file)
 
+void atsc3_fdt_file_free(atsc3_fdt_file_t** atsc3_fdt_file_p);
+void atsc3_fdt_instance_free(atsc3_fdt_instance_t** atsc3_fdt_instance_p);
+
+/**
+ * per TSI FDT cache
+ *
+ * the FDT-Instance (TOI 0) is repeated on every carousel pass. atsc3_fdt_cache_update_from_payload (atsc3_fdt_parser.h)
+ * drops a repeat of the last instance on length and hash before any XML parsing, a new instance is merged into the
+ * files already known for the TSI. files are indexed by TOI in an open addressing table so object completion can
+ * resolve Content-Location, length and encoding without scanning the instance.
+ *
+ * a file stays cached until a later instance re-declares its TOI or the Expires of the instance that declared it
+ * passes, see atsc3_fdt_cache_purge_expired
+ */
+#define ATSC3_FDT_TSI_CACHE_TOI_TABLE_DEFAULT_SIZE 16
+
+typedef struct atsc3_fdt_tsi_cache_slot {
+	atsc3_fdt_file_t*	atsc3_fdt_file;		//NULL if the slot is empty
+	uint32_t			expires;
+} atsc3_fdt_tsi_cache_slot_t;
+
+typedef struct atsc3_fdt_tsi_cache {
+	uint32_t						tsi;
+
+	//last merged FDT-Instance
+	bool							has_instance;
+	uint32_t						expires;
+	uint32_t						efdt_version;
+	uint32_t						payload_length;
+	uint32_t						payload_hash;
+
+	//linear probing, size is a power of 2
+	atsc3_fdt_tsi_cache_slot_t*		toi_table;
+	uint32_t						toi_table_size;
+	uint32_t						toi_table_count;
+} atsc3_fdt_tsi_cache_t;
+
+typedef struct atsc3_fdt_cache {
+	atsc3_fdt_tsi_cache_t**			atsc3_fdt_tsi_cache;
+	uint32_t						atsc3_fdt_tsi_cache_n;
+
+	uint32_t						instances_merged;
+	uint32_t						instances_repeated;
+} atsc3_fdt_cache_t;
+
+atsc3_fdt_cache_t* atsc3_fdt_cache_new();
+void atsc3_fdt_cache_free(atsc3_fdt_cache_t** atsc3_fdt_cache_p);
+
+atsc3_fdt_tsi_cache_t* atsc3_fdt_cache_find_tsi(atsc3_fdt_cache_t* atsc3_fdt_cache, uint32_t tsi);
+atsc3_fdt_tsi_cache_t* atsc3_fdt_cache_get_or_create_tsi(atsc3_fdt_cache_t* atsc3_fdt_cache, uint32_t tsi);
+
+//takes ownership of atsc3_fdt_file, replacing (and freeing) any file already cached for its TOI
+void atsc3_fdt_tsi_cache_add_file(atsc3_fdt_tsi_cache_t* atsc3_fdt_tsi_cache, atsc3_fdt_file_t* atsc3_fdt_file, uint32_t expires);
+atsc3_fdt_file_t* atsc3_fdt_tsi_cache_find_file(atsc3_fdt_tsi_cache_t* atsc3_fdt_tsi_cache, uint32_t toi);
+atsc3_fdt_file_t* atsc3_fdt_cache_find_file(atsc3_fdt_cache_t* atsc3_fdt_cache, uint32_t tsi, uint32_t toi);
+
+//removes files whose FDT-Instance Expires (NTP seconds) is before now_ntp_seconds, returns the number removed
+uint32_t atsc3_fdt_cache_purge_expired(atsc3_fdt_cache_t* atsc3_fdt_cache, uint32_t now_ntp_seconds);
+
 
 #endif /* ATSC3_FDT_H_ */
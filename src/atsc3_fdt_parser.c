@@ -25,9 +25,6 @@
 #include "atsc3_fdt_parser.h"
 
 atsc3_fdt_instance_t* atsc3_fdt_instance_parse_from_xml_document(xml_document_t* xml_document) {
-	atsc3_fdt_instance_t* atsc3_fdt_instance = calloc(1, sizeof(atsc3_fdt_instance_t));
-	assert(atsc3_fdt_instance);
-
 	if(!xml_document) {
 		return NULL;
 	}
@@ -41,7 +38,9 @@ atsc3_fdt_instance_t* atsc3_fdt_instance_parse_from_xml_document(xml_document_t*
         _ATSC3_FDT_PARSER_ERROR("atsc3_fdt_instance_parse_from_xml_document: opening tag missing xml preamble");
         return NULL;
     }
-    
+
+	atsc3_fdt_instance_t* atsc3_fdt_instance = calloc(1, sizeof(atsc3_fdt_instance_t));
+	assert(atsc3_fdt_instance);
     
     
     //we should only be expecting either an EFDT or FDT-Instance node here
@@ -88,8 +87,14 @@ atsc3_fdt_instance_t* atsc3_fdt_parse_from_xml_fdt_instance(atsc3_fdt_instance_t
     
     char* matching_attribute = NULL;
     
+    //NTP seconds, 4294967295 does not fit in atoi
     if((matching_attribute = kvp_collection_get(kvp_collection, "expires"))) {
-        atsc3_fdt_instance->expires = atoi(matching_attribute);
+        atsc3_fdt_instance->expires = strtoul(matching_attribute, NULL, 10);
+        free(matching_attribute);
+    }
+
+    if((matching_attribute = kvp_collection_get(kvp_collection, "afdt:efdtVersion"))) {
+        atsc3_fdt_instance->adft_efdt_version = atoi(matching_attribute);
         free(matching_attribute);
     }
     
@@ -108,7 +113,7 @@ atsc3_fdt_instance_t* atsc3_fdt_parse_from_xml_fdt_instance(atsc3_fdt_instance_t
     
     //TODO: remainder of elements are FEC related
 
-
+    kvp_collection_free(kvp_collection);
     free(xml_attributes);    
     return atsc3_fdt_instance;
 }
@@ -206,6 +211,7 @@ atsc3_fdt_file_t* atsc3_fdt_file_parse_from_xml_fdt_instance(xml_node_t* node) {
     }
     //TODO: remainder of elements are FEC related
     
+    kvp_collection_free(kvp_collection);
     free(xml_attributes);
     return atsc3_fdt_file;
 }
@@ -221,3 +227,56 @@ void atsc3_fdt_instance_dump(atsc3_fdt_instance_t* atsc3_fdt_instance) {
 	_ATSC3_FDT_PARSER_DEBUG("---atsc3_fdt_instance: %p, end---",atsc3_fdt_instance);
 
 }
+
+static uint32_t __atsc3_fdt_payload_hash(uint8_t* payload, uint32_t payload_length) {
+	uint32_t hash = 2166136261u;
+	for(uint32_t i = 0; i < payload_length; i++) {
+		hash = (hash ^ payload[i]) * 16777619u;
+	}
+	return hash;
+}
+
+bool atsc3_fdt_cache_update_from_payload(atsc3_fdt_cache_t* atsc3_fdt_cache, uint32_t tsi, uint8_t* payload, uint32_t payload_length) {
+	atsc3_fdt_tsi_cache_t* atsc3_fdt_tsi_cache = atsc3_fdt_cache_get_or_create_tsi(atsc3_fdt_cache, tsi);
+	uint32_t payload_hash = __atsc3_fdt_payload_hash(payload, payload_length);
+
+	//carousel repeat of the instance we already merged
+	if(atsc3_fdt_tsi_cache->has_instance && atsc3_fdt_tsi_cache->payload_length == payload_length && atsc3_fdt_tsi_cache->payload_hash == payload_hash) {
+		atsc3_fdt_cache->instances_repeated++;
+		return false;
+	}
+
+	xml_document_t* xml_document = xml_parse_document(payload, payload_length);
+	atsc3_fdt_instance_t* atsc3_fdt_instance = atsc3_fdt_instance_parse_from_xml_document(xml_document);
+	if(xml_document) {
+		xml_document_free(xml_document, false);
+	}
+	if(!atsc3_fdt_instance) {
+		_ATSC3_FDT_PARSER_WARN("atsc3_fdt_cache_update_from_payload: tsi: %u, unable to parse FDT-Instance, len: %u", tsi, payload_length);
+		return false;
+	}
+
+	//the cache takes the files, instance level Content-Encoding applies to files that do not carry their own
+	for(int i = 0; i < atsc3_fdt_instance->atsc3_fdt_file_v.count; i++) {
+		atsc3_fdt_file_t* atsc3_fdt_file = atsc3_fdt_instance->atsc3_fdt_file_v.data[i];
+		if(!atsc3_fdt_file->content_encoding && atsc3_fdt_instance->content_encoding) {
+			atsc3_fdt_file->content_encoding = strdup(atsc3_fdt_instance->content_encoding);
+		}
+		atsc3_fdt_tsi_cache_add_file(atsc3_fdt_tsi_cache, atsc3_fdt_file, atsc3_fdt_instance->expires);
+		atsc3_fdt_instance->atsc3_fdt_file_v.data[i] = NULL;
+	}
+
+	_ATSC3_FDT_PARSER_DEBUG("atsc3_fdt_cache_update_from_payload: tsi: %u, efdt_version: %u -> %u, expires: %u, merged files: %u, cached files: %u",
+			tsi, atsc3_fdt_tsi_cache->efdt_version, atsc3_fdt_instance->adft_efdt_version, atsc3_fdt_instance->expires,
+			atsc3_fdt_instance->atsc3_fdt_file_v.count, atsc3_fdt_tsi_cache->toi_table_count);
+
+	atsc3_fdt_tsi_cache->has_instance = true;
+	atsc3_fdt_tsi_cache->expires = atsc3_fdt_instance->expires;
+	atsc3_fdt_tsi_cache->efdt_version = atsc3_fdt_instance->adft_efdt_version;
+	atsc3_fdt_tsi_cache->payload_length = payload_length;
+	atsc3_fdt_tsi_cache->payload_hash = payload_hash;
+	atsc3_fdt_cache->instances_merged++;
+
+	atsc3_fdt_instance_free(&atsc3_fdt_instance);
+	return true;
+}
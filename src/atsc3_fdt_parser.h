@@ -23,6 +23,9 @@ atsc3_fdt_file_t* atsc3_fdt_file_parse_from_xml_fdt_instance(xml_node_t* node);
 
 void atsc3_fdt_instance_dump(atsc3_fdt_instance_t* atsc3_fdt_instance);
 
+//merges a completed TOI 0 FDT-Instance object into the tsi cache, returns false for a carousel repeat or a parse failure
+bool atsc3_fdt_cache_update_from_payload(atsc3_fdt_cache_t* atsc3_fdt_cache, uint32_t tsi, uint8_t* payload, uint32_t payload_length);
+
 
 #define _ATSC3_FDT_PARSER_ERROR(...)   printf("%s:%d:ERROR:",__FILE__,__LINE__);_ATSC3_UTILS_PRINTLN(__VA_ARGS__);
 #define _ATSC3_FDT_PARSER_WARN(...)    printf("%s:%d:WARN:",__FILE__,__LINE__);_ATSC3_UTILS_PRINTLN(__VA_ARGS__);
@@ -11,6 +11,7 @@
 #include "atsc3_utils.h"
 #include "atsc3_fdt.h"
 #include "atsc3_fdt_parser.h"
+#include "atsc3_alc_utils.h"
 #include "atsc3_logging_externs.h"
 
 #define _ATSC3_FDT_TEST_UTILS_ERROR(...)   printf("%s:%d:ERROR:",__FILE__,__LINE__);_ATSC3_UTILS_PRINTLN(__VA_ARGS__);
@@ -30,11 +31,229 @@ int parse_fdt(const char* filename) {
 			return -1;
 		}
 		atsc3_fdt_instance_dump(atsc3_fdt_instance);
+		atsc3_fdt_instance_free(&atsc3_fdt_instance);
+		xml_document_free(fdt_xml, true);
+	}
+
+	return ret;
+}
+#define __FDT_CACHE_TEST_TSI 100
+#define __FDT_GZIP_TEST_OBJECT_LEN 262144
+
+static const char* __FDT_CACHE_TEST_INSTANCE_1 = "<?xml version=\"1.0\" encoding=\"UTF-8\"?>"
+		"<FDT-Instance xmlns=\"urn:ietf:params:xml:ns:fdt\" xmlns:afdt=\"tag:atsc.org,2016:XMLSchemas/ATSC3/Delivery/ATSC-FDT/1.0/\" Expires=\"4294967295\" Content-Encoding=\"gzip\" afdt:efdtVersion=\"1\">"
+		"<File Content-Location=\"video-init.mp4\" TOI=\"1\" Content-Length=\"800\" Content-Encoding=\"identity\"/>"
+		"<File Content-Location=\"video-2.m4s\" TOI=\"2\" Content-Length=\"90000\"/>"
+		"</FDT-Instance>";
+
+static const char* __FDT_CACHE_TEST_INSTANCE_2 = "<?xml version=\"1.0\" encoding=\"UTF-8\"?>"
+		"<FDT-Instance xmlns=\"urn:ietf:params:xml:ns:fdt\" xmlns:afdt=\"tag:atsc.org,2016:XMLSchemas/ATSC3/Delivery/ATSC-FDT/1.0/\" Expires=\"4294967295\" afdt:efdtVersion=\"2\">"
+		"<File Content-Location=\"video-3.m4s\" TOI=\"3\" Content-Length=\"91000\"/>"
+		"</FDT-Instance>";
+
+int test_fdt_cache() {
+	atsc3_fdt_cache_t* atsc3_fdt_cache = atsc3_fdt_cache_new();
+
+	if(!atsc3_fdt_cache_update_from_payload(atsc3_fdt_cache, __FDT_CACHE_TEST_TSI, (uint8_t*)__FDT_CACHE_TEST_INSTANCE_1, strlen(__FDT_CACHE_TEST_INSTANCE_1))) {
+		_ATSC3_FDT_TEST_UTILS_ERROR("test_fdt_cache: instance 1 not merged");
+		return -1;
+	}
+	//carousel repeat is not parsed again
+	if(atsc3_fdt_cache_update_from_payload(atsc3_fdt_cache, __FDT_CACHE_TEST_TSI, (uint8_t*)__FDT_CACHE_TEST_INSTANCE_1, strlen(__FDT_CACHE_TEST_INSTANCE_1)) || atsc3_fdt_cache->instances_repeated != 1) {
+		_ATSC3_FDT_TEST_UTILS_ERROR("test_fdt_cache: instance 1 repeat was merged");
+		return -1;
+	}
+	if(!atsc3_fdt_cache_update_from_payload(atsc3_fdt_cache, __FDT_CACHE_TEST_TSI, (uint8_t*)__FDT_CACHE_TEST_INSTANCE_2, strlen(__FDT_CACHE_TEST_INSTANCE_2))) {
+		_ATSC3_FDT_TEST_UTILS_ERROR("test_fdt_cache: instance 2 not merged");
+		return -1;
+	}
+
+	atsc3_fdt_tsi_cache_t* atsc3_fdt_tsi_cache = atsc3_fdt_cache_find_tsi(atsc3_fdt_cache, __FDT_CACHE_TEST_TSI);
+	if(!atsc3_fdt_tsi_cache || atsc3_fdt_tsi_cache->toi_table_count != 3 || atsc3_fdt_tsi_cache->efdt_version != 2 || atsc3_fdt_tsi_cache->expires != 4294967295u) {
+		_ATSC3_FDT_TEST_UTILS_ERROR("test_fdt_cache: unexpected tsi cache state");
+		return -1;
+	}
+
+	atsc3_fdt_file_t* atsc3_fdt_file = atsc3_fdt_cache_find_file(atsc3_fdt_cache, __FDT_CACHE_TEST_TSI, 1);
+	if(!atsc3_fdt_file || strcmp(atsc3_fdt_file->content_location, "video-init.mp4") || strcmp(atsc3_fdt_file->content_encoding, "identity")) {
+		_ATSC3_FDT_TEST_UTILS_ERROR("test_fdt_cache: toi 1 mismatch");
+		return -1;
+	}
+	//instance Content-Encoding is the default
+	atsc3_fdt_file = atsc3_fdt_cache_find_file(atsc3_fdt_cache, __FDT_CACHE_TEST_TSI, 2);
+	if(!atsc3_fdt_file || atsc3_fdt_file->content_length != 90000 || !atsc3_fdt_file->content_encoding || strcmp(atsc3_fdt_file->content_encoding, "gzip")) {
+		_ATSC3_FDT_TEST_UTILS_ERROR("test_fdt_cache: toi 2 mismatch");
+		return -1;
+	}
+	atsc3_fdt_file = atsc3_fdt_cache_find_file(atsc3_fdt_cache, __FDT_CACHE_TEST_TSI, 3);
+	if(!atsc3_fdt_file || strcmp(atsc3_fdt_file->content_location, "video-3.m4s") || atsc3_fdt_file->content_encoding) {
+		_ATSC3_FDT_TEST_UTILS_ERROR("test_fdt_cache: toi 3 mismatch");
+		return -1;
+	}
+	if(atsc3_fdt_cache_find_file(atsc3_fdt_cache, __FDT_CACHE_TEST_TSI, 4) || atsc3_fdt_cache_find_file(atsc3_fdt_cache, __FDT_CACHE_TEST_TSI + 1, 1)) {
+		_ATSC3_FDT_TEST_UTILS_ERROR("test_fdt_cache: found unknown toi");
+		return -1;
+	}
+
+	//grow the toi table, then purge every other toi and make sure the survivors are still reachable
+	atsc3_fdt_tsi_cache = atsc3_fdt_cache_get_or_create_tsi(atsc3_fdt_cache, __FDT_CACHE_TEST_TSI + 1);
+	for(uint32_t toi = 1; toi <= 1000; toi++) {
+		atsc3_fdt_file = atsc3_fdt_file_new();
+		atsc3_fdt_file->toi = toi * 7;
+		atsc3_fdt_tsi_cache_add_file(atsc3_fdt_tsi_cache, atsc3_fdt_file, toi % 2 ? 100 : 4294967295u);
+	}
+	if(atsc3_fdt_cache_purge_expired(atsc3_fdt_cache, 1000) != 500 || atsc3_fdt_tsi_cache->toi_table_count != 500) {
+		_ATSC3_FDT_TEST_UTILS_ERROR("test_fdt_cache: purge mismatch, count: %u", atsc3_fdt_tsi_cache->toi_table_count);
+		return -1;
+	}
+	for(uint32_t toi = 1; toi <= 1000; toi++) {
+		if((atsc3_fdt_tsi_cache_find_file(atsc3_fdt_tsi_cache, toi * 7) == NULL) != (toi % 2)) {
+			_ATSC3_FDT_TEST_UTILS_ERROR("test_fdt_cache: toi %u lookup after purge", toi * 7);
+			return -1;
+		}
+	}
+
+	atsc3_fdt_cache_free(&atsc3_fdt_cache);
+	_ATSC3_FDT_TEST_UTILS_INFO("test_fdt_cache: OK");
+	return 0;
+}
+
+//gzip object of __FDT_GZIP_TEST_OBJECT_LEN bytes, split into packets of packet_len
+static uint32_t __fdt_gzip_test_object(uint8_t** decoded_p, uint8_t** compressed_p) {
+	uint32_t decoded_len = __FDT_GZIP_TEST_OBJECT_LEN;
+	uint8_t* decoded = (uint8_t*)malloc(decoded_len);
+	//16 symbol alphabet, compresses to about half so the object spans many packets
+	uint32_t lcg = 6330;
+	for(uint32_t i = 0; i < decoded_len; i++) {
+		lcg = lcg * 1103515245 + 12345;
+		decoded[i] = 'a' + ((lcg >> 16) & 0x0F);
+	}
+
+	z_stream strm;
+	memset(&strm, 0, sizeof(z_stream));
+	deflateInit2(&strm, Z_DEFAULT_COMPRESSION, Z_DEFLATED, 16+MAX_WBITS, 8, Z_DEFAULT_STRATEGY);
+	uint32_t compressed_max = deflateBound(&strm, decoded_len);
+	uint8_t* compressed = (uint8_t*)malloc(compressed_max);
+	strm.next_in = decoded;
+	strm.avail_in = decoded_len;
+	strm.next_out = compressed;
+	strm.avail_out = compressed_max;
+	deflate(&strm, Z_FINISH);
+	uint32_t compressed_len = compressed_max - strm.avail_out;
+	deflateEnd(&strm);
 
+	*decoded_p = decoded;
+	*compressed_p = compressed;
+	return compressed_len;
+}
+
+static alc_recon_object_t* __fdt_gzip_test_add(alc_recon_track_t* alc_recon_track, uint32_t toi, uint8_t* compressed, uint32_t compressed_len, uint32_t offset, uint32_t len, bool close) {
+	alc_packet_t alc_packet;
+	memset(&alc_packet, 0, sizeof(alc_packet_t));
+	alc_packet.def_lct_hdr.tsi = __FDT_CACHE_TEST_TSI;
+	alc_packet.def_lct_hdr.toi = toi;
+	alc_packet.use_start_offset = true;
+	alc_packet.start_offset = offset;
+	alc_packet.transfer_len = compressed_len;
+	alc_packet.alc_payload = compressed + offset;
+	alc_packet.alc_len = len;
+	alc_packet.close_object_flag = close;
+
+	return alc_recon_track_add_packet_with_content_encoding(alc_recon_track, &alc_packet, "gzip");
+}
+
+int test_fdt_gzip_object() {
+	uint8_t* decoded = NULL;
+	uint8_t* compressed = NULL;
+	uint32_t compressed_len = __fdt_gzip_test_object(&decoded, &compressed);
+	uint32_t packet_len = 1400;
+	uint32_t packets = (compressed_len + packet_len - 1) / packet_len;
+	int ret = -1;
+
+	alc_recon_track_t* alc_recon_track = alc_recon_track_create(__FDT_CACHE_TEST_TSI, 1000);
+	alc_recon_object_t* completed = NULL;
+
+	//in order, inflated while the packets arrive
+	for(uint32_t i = 0; i < packets; i++) {
+		uint32_t offset = i * packet_len;
+		completed = __fdt_gzip_test_add(alc_recon_track, 2, compressed, compressed_len, offset, __MIN(packet_len, compressed_len - offset), i == packets - 1);
+		if(i == packets - 2 && alc_recon_track->gzip_output->i_pos < __FDT_GZIP_TEST_OBJECT_LEN / 2) {
+			_ATSC3_FDT_TEST_UTILS_ERROR("test_fdt_gzip_object: only %u bytes inflated before the last packet", alc_recon_track->gzip_output->i_pos);
+			goto cleanup;
+		}
 	}
+	if(!completed || completed->block->i_pos != __FDT_GZIP_TEST_OBJECT_LEN || memcmp(completed->block->p_buffer, decoded, __FDT_GZIP_TEST_OBJECT_LEN)) {
+		_ATSC3_FDT_TEST_UTILS_ERROR("test_fdt_gzip_object: in order object not decoded");
+		goto cleanup;
+	}
+
+	//last packet first, decoded as a whole on completion
+	uint32_t last_offset = (packets - 1) * packet_len;
+	__fdt_gzip_test_add(alc_recon_track, 3, compressed, compressed_len, last_offset, compressed_len - last_offset, false);
+	for(uint32_t i = 0; i < packets - 1; i++) {
+		completed = __fdt_gzip_test_add(alc_recon_track, 3, compressed, compressed_len, i * packet_len, packet_len, i == packets - 2);
+	}
+	if(!completed || completed->toi != 3 || completed->block->i_pos != __FDT_GZIP_TEST_OBJECT_LEN || memcmp(completed->block->p_buffer, decoded, __FDT_GZIP_TEST_OBJECT_LEN)) {
+		_ATSC3_FDT_TEST_UTILS_ERROR("test_fdt_gzip_object: out of order object not decoded");
+		goto cleanup;
+	}
+
+	//not gzip, handed over as received
+	compressed[0] = 0;
+	completed = __fdt_gzip_test_add(alc_recon_track, 4, compressed, compressed_len, 0, compressed_len, true);
+	if(!completed || completed->block->i_pos != compressed_len) {
+		_ATSC3_FDT_TEST_UTILS_ERROR("test_fdt_gzip_object: corrupt object not kept as received");
+		goto cleanup;
+	}
+
+	_ATSC3_FDT_TEST_UTILS_INFO("test_fdt_gzip_object: OK, compressed: %u, packets: %u", compressed_len, packets);
+	ret = 0;
 
+cleanup:
+	alc_recon_track_free(&alc_recon_track);
+	free(decoded);
+	free(compressed);
 	return ret;
 }
+
+//transfer_len is a 48 bit wire field, it used to size the block and then be truncated to 32 bits on resize
+int test_fdt_recon_oversized_transfer_len() {
+	uint8_t payload[1400];
+	memset(payload, 0xAB, sizeof(payload));
+	int ret = -1;
+
+	alc_recon_track_t* alc_recon_track = alc_recon_track_create(__FDT_CACHE_TEST_TSI, 1000);
+
+	alc_packet_t alc_packet;
+	memset(&alc_packet, 0, sizeof(alc_packet_t));
+	alc_packet.def_lct_hdr.tsi = __FDT_CACHE_TEST_TSI;
+	alc_packet.def_lct_hdr.toi = 5;
+	alc_packet.use_start_offset = true;
+	alc_packet.transfer_len = 0x100000010ULL;
+	alc_packet.alc_payload = payload;
+	alc_packet.alc_len = sizeof(payload);
+
+	if(alc_recon_track_add_packet(alc_recon_track, &alc_packet) || alc_recon_track->assembling.block) {
+		_ATSC3_FDT_TEST_UTILS_ERROR("test_fdt_recon_oversized_transfer_len: packet of a %llu byte object was assembled", alc_packet.transfer_len);
+		goto cleanup;
+	}
+
+	//a sane transfer_len is not allocated up front, the block grows with the packets
+	alc_packet.transfer_len = 16 * 1024 * 1024;
+	alc_recon_track_add_packet(alc_recon_track, &alc_packet);
+	if(!alc_recon_track->assembling.block || alc_recon_track->assembling.block->p_size >= alc_packet.transfer_len) {
+		_ATSC3_FDT_TEST_UTILS_ERROR("test_fdt_recon_oversized_transfer_len: first packet allocated %u bytes", alc_recon_track->assembling.block ? alc_recon_track->assembling.block->p_size : 0);
+		goto cleanup;
+	}
+
+	_ATSC3_FDT_TEST_UTILS_INFO("test_fdt_recon_oversized_transfer_len: OK");
+	ret = 0;
+
+cleanup:
+	alc_recon_track_free(&alc_recon_track);
+	return ret;
+}
+
 int main(int argc, char* argv[] ) {
 
 	 _XML_INFO_ENABLED = 1;
@@ -45,6 +264,11 @@ int main(int argc, char* argv[] ) {
 
 	 //parse_fdt("../test_data/xml_fdt/phx-fdt-0-0.xml");
 	 parse_fdt("../test_data/sba-dash/0-0"); //application/mbms-envelope+xml
-	 return 0;
+
+	 int ret = test_fdt_cache();
+	 ret |= test_fdt_gzip_object();
+	 ret |= test_fdt_recon_oversized_transfer_len();
+
+	 return ret;
 }
 
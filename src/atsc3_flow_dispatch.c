@@ -0,0 +1,172 @@
+/*
+ * atsc3_flow_dispatch.c
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: jjustman
+ */
+
+#include "atsc3_flow_dispatch.h"
+#include "atsc3_route_s_tsid.h"
+
+int _FLOW_DISPATCH_DEBUG_ENABLED = 0;
+
+//serializes rebuilds from the packet thread (SLT updates) and the ncurses thread (service selection)
+static pthread_mutex_t atsc3_flow_dispatch_writer_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+static inline uint32_t __atsc3_flow_dispatch_slot(atsc3_flow_dispatch_table_t* atsc3_flow_dispatch_table, uint32_t dst_ip_addr, uint16_t dst_port) {
+	uint32_t key = dst_ip_addr ^ ((uint32_t)dst_port * 0x9E3779B1u);
+	return (key * 2654435769u) >> 7 & (atsc3_flow_dispatch_table->size - 1);
+}
+
+static inline bool __atsc3_flow_dispatch_entry_matches(atsc3_flow_dispatch_entry_t* atsc3_flow_dispatch_entry, uint32_t src_ip_addr, uint32_t dst_ip_addr, uint16_t dst_port) {
+	return atsc3_flow_dispatch_entry->dst_ip_addr == dst_ip_addr && atsc3_flow_dispatch_entry->dst_port == dst_port &&
+			(!atsc3_flow_dispatch_entry->match_src_ip_addr || atsc3_flow_dispatch_entry->src_ip_addr == src_ip_addr);
+}
+
+//linear probing with no deletes, so entries with the same key are found in insertion order
+static void __atsc3_flow_dispatch_table_add(atsc3_flow_dispatch_table_t* atsc3_flow_dispatch_table, atsc3_flow_dispatch_entry_t* atsc3_flow_dispatch_entry) {
+	uint32_t i = __atsc3_flow_dispatch_slot(atsc3_flow_dispatch_table, atsc3_flow_dispatch_entry->dst_ip_addr, atsc3_flow_dispatch_entry->dst_port);
+	while(atsc3_flow_dispatch_table->entries[i].kind != ATSC3_FLOW_DISPATCH_UNKNOWN) {
+		i = (i + 1) & (atsc3_flow_dispatch_table->size - 1);
+	}
+	atsc3_flow_dispatch_table->entries[i] = *atsc3_flow_dispatch_entry;
+	atsc3_flow_dispatch_table->entries_n++;
+}
+
+static atsc3_flow_dispatch_table_t* __atsc3_flow_dispatch_table_build(lls_slt_monitor_t* lls_slt_monitor) {
+	lls_sls_alc_session_vector_t* lls_sls_alc_session_vector = lls_slt_monitor->lls_sls_alc_session_vector;
+	lls_sls_mmt_session_vector_t* lls_sls_mmt_session_vector = lls_slt_monitor->lls_sls_mmt_session_vector;
+
+	uint32_t entries_n = 2;
+	entries_n += lls_sls_alc_session_vector ? lls_sls_alc_session_vector->lls_slt_alc_sessions_n : 0;
+	for(int i = 0; lls_sls_alc_session_vector && i < lls_sls_alc_session_vector->lls_slt_alc_sessions_n; i++) {
+		atsc3_route_s_tsid_t* atsc3_route_s_tsid = __atomic_load_n(&lls_sls_alc_session_vector->lls_slt_alc_sessions[i]->atsc3_route_s_tsid, __ATOMIC_ACQUIRE);
+		entries_n += atsc3_route_s_tsid ? atsc3_route_s_tsid->atsc3_route_s_tsid_rs_v.count : 0;
+	}
+	entries_n += lls_sls_mmt_session_vector ? lls_sls_mmt_session_vector->lls_slt_mmt_sessions_n : 0;
+
+	//keep the load factor at or under 1/2 so a miss ends quickly
+	uint32_t size = ATSC3_FLOW_DISPATCH_TABLE_MIN_SIZE;
+	while(size < entries_n * 2) {
+		size *= 2;
+	}
+
+	atsc3_flow_dispatch_table_t* atsc3_flow_dispatch_table = calloc(1, sizeof(atsc3_flow_dispatch_table_t) + size * sizeof(atsc3_flow_dispatch_entry_t));
+	atsc3_flow_dispatch_table->size = size;
+	if(lls_slt_monitor->lls_table_slt) {
+		atsc3_flow_dispatch_table->lls_table_version = lls_slt_monitor->lls_table_slt->lls_table_version;
+	}
+
+	atsc3_flow_dispatch_entry_t atsc3_flow_dispatch_entry;
+
+	memset(&atsc3_flow_dispatch_entry, 0, sizeof(atsc3_flow_dispatch_entry_t));
+	atsc3_flow_dispatch_entry.kind = ATSC3_FLOW_DISPATCH_MDNS;
+	atsc3_flow_dispatch_entry.dst_ip_addr = UDP_FILTER_MDNS_IP_ADDRESS;
+	atsc3_flow_dispatch_entry.dst_port = UDP_FILTER_MDNS_PORT;
+	__atsc3_flow_dispatch_table_add(atsc3_flow_dispatch_table, &atsc3_flow_dispatch_entry);
+
+	atsc3_flow_dispatch_entry.kind = ATSC3_FLOW_DISPATCH_LLS;
+	atsc3_flow_dispatch_entry.dst_ip_addr = LLS_DST_ADDR;
+	atsc3_flow_dispatch_entry.dst_port = LLS_DST_PORT;
+	__atsc3_flow_dispatch_table_add(atsc3_flow_dispatch_table, &atsc3_flow_dispatch_entry);
+
+	for(int i = 0; lls_sls_alc_session_vector && i < lls_sls_alc_session_vector->lls_slt_alc_sessions_n; i++) {
+		lls_sls_alc_session_t* lls_sls_alc_session = lls_sls_alc_session_vector->lls_slt_alc_sessions[i];
+
+		memset(&atsc3_flow_dispatch_entry, 0, sizeof(atsc3_flow_dispatch_entry_t));
+		atsc3_flow_dispatch_entry.kind = ATSC3_FLOW_DISPATCH_ALC;
+		atsc3_flow_dispatch_entry.dst_ip_addr = lls_sls_alc_session->sls_destination_ip_address;
+		atsc3_flow_dispatch_entry.dst_port = lls_sls_alc_session->sls_destination_udp_port;
+		atsc3_flow_dispatch_entry.match_src_ip_addr = !lls_sls_alc_session->sls_relax_source_ip_check;
+		atsc3_flow_dispatch_entry.src_ip_addr = lls_sls_alc_session->sls_source_ip_address;
+		atsc3_flow_dispatch_entry.lls_sls_alc_session = lls_sls_alc_session;
+		if(lls_slt_monitor->lls_sls_alc_monitor && lls_slt_monitor->lls_sls_alc_monitor->service_id == lls_sls_alc_session->service_id) {
+			atsc3_flow_dispatch_entry.lls_sls_alc_monitor = lls_slt_monitor->lls_sls_alc_monitor;
+		}
+		__atsc3_flow_dispatch_table_add(atsc3_flow_dispatch_table, &atsc3_flow_dispatch_entry);
+
+		//ROUTE sessions the S-TSID announces on flows other than the SLS, e.g. media on its own multicast group
+		atsc3_route_s_tsid_t* atsc3_route_s_tsid = __atomic_load_n(&lls_sls_alc_session->atsc3_route_s_tsid, __ATOMIC_ACQUIRE);
+		for(int j = 0; atsc3_route_s_tsid && j < atsc3_route_s_tsid->atsc3_route_s_tsid_rs_v.count; j++) {
+			atsc3_route_s_tsid_rs_t* atsc3_route_s_tsid_rs = atsc3_route_s_tsid->atsc3_route_s_tsid_rs_v.data[j];
+			if(atsc3_route_s_tsid_rs->dst_ip_addr == lls_sls_alc_session->sls_destination_ip_address && atsc3_route_s_tsid_rs->dst_port == lls_sls_alc_session->sls_destination_udp_port) {
+				continue;
+			}
+			atsc3_flow_dispatch_entry.dst_ip_addr = atsc3_route_s_tsid_rs->dst_ip_addr;
+			atsc3_flow_dispatch_entry.dst_port = atsc3_route_s_tsid_rs->dst_port;
+			atsc3_flow_dispatch_entry.match_src_ip_addr = atsc3_route_s_tsid_rs->src_ip_addr && !lls_sls_alc_session->sls_relax_source_ip_check;
+			atsc3_flow_dispatch_entry.src_ip_addr = atsc3_route_s_tsid_rs->src_ip_addr;
+			__atsc3_flow_dispatch_table_add(atsc3_flow_dispatch_table, &atsc3_flow_dispatch_entry);
+		}
+	}
+
+	for(int i = 0; lls_sls_mmt_session_vector && i < lls_sls_mmt_session_vector->lls_slt_mmt_sessions_n; i++) {
+		lls_sls_mmt_session_t* lls_sls_mmt_session = lls_sls_mmt_session_vector->lls_slt_mmt_sessions[i];
+
+		memset(&atsc3_flow_dispatch_entry, 0, sizeof(atsc3_flow_dispatch_entry_t));
+		atsc3_flow_dispatch_entry.kind = ATSC3_FLOW_DISPATCH_MMT;
+		atsc3_flow_dispatch_entry.dst_ip_addr = lls_sls_mmt_session->sls_destination_ip_address;
+		atsc3_flow_dispatch_entry.dst_port = lls_sls_mmt_session->sls_destination_udp_port;
+		atsc3_flow_dispatch_entry.lls_sls_mmt_session = lls_sls_mmt_session;
+		if(lls_slt_monitor->lls_sls_mmt_monitor && lls_slt_monitor->lls_sls_mmt_monitor->service_id == lls_sls_mmt_session->service_id) {
+			atsc3_flow_dispatch_entry.lls_sls_mmt_monitor = lls_slt_monitor->lls_sls_mmt_monitor;
+		}
+		__atsc3_flow_dispatch_table_add(atsc3_flow_dispatch_table, &atsc3_flow_dispatch_entry);
+	}
+
+	return atsc3_flow_dispatch_table;
+}
+
+void atsc3_flow_dispatch_rebuild(lls_slt_monitor_t* lls_slt_monitor) {
+	pthread_mutex_lock(&atsc3_flow_dispatch_writer_mutex);
+
+	//the build walks each session's S-TSID, which the packet thread retires through atsc3_qsbr when a new one arrives
+	bool qsbr_registered = atsc3_qsbr_read_section_begin();
+	atsc3_flow_dispatch_table_t* atsc3_flow_dispatch_table = __atsc3_flow_dispatch_table_build(lls_slt_monitor);
+	atsc3_qsbr_read_section_end(qsbr_registered);
+
+	atsc3_flow_dispatch_table_t* replaced = __atomic_exchange_n(&lls_slt_monitor->atsc3_flow_dispatch_table, atsc3_flow_dispatch_table, __ATOMIC_ACQ_REL);
+
+	//rebuilds can come back to back from several threads, only the readers' quiescent states tell when replaced is unreachable
+	atsc3_qsbr_retire(replaced, free);
+
+	__FLOW_DISPATCH_DEBUG("atsc3_flow_dispatch_rebuild: lls_table_version: %u, entries: %u, size: %u", atsc3_flow_dispatch_table->lls_table_version, atsc3_flow_dispatch_table->entries_n, atsc3_flow_dispatch_table->size);
+
+	pthread_mutex_unlock(&atsc3_flow_dispatch_writer_mutex);
+}
+
+atsc3_flow_dispatch_entry_t atsc3_flow_dispatch_find(lls_slt_monitor_t* lls_slt_monitor, uint32_t src_ip_addr, uint32_t dst_ip_addr, uint16_t dst_port) {
+	atsc3_flow_dispatch_entry_t atsc3_flow_dispatch_entry;
+	atsc3_flow_dispatch_table_t* atsc3_flow_dispatch_table = __atomic_load_n(&lls_slt_monitor->atsc3_flow_dispatch_table, __ATOMIC_ACQUIRE);
+
+	if(atsc3_flow_dispatch_table) {
+		uint32_t i = __atsc3_flow_dispatch_slot(atsc3_flow_dispatch_table, dst_ip_addr, dst_port);
+		while(atsc3_flow_dispatch_table->entries[i].kind != ATSC3_FLOW_DISPATCH_UNKNOWN) {
+			if(__atsc3_flow_dispatch_entry_matches(&atsc3_flow_dispatch_table->entries[i], src_ip_addr, dst_ip_addr, dst_port)) {
+				return atsc3_flow_dispatch_table->entries[i];
+			}
+			i = (i + 1) & (atsc3_flow_dispatch_table->size - 1);
+		}
+	}
+
+	memset(&atsc3_flow_dispatch_entry, 0, sizeof(atsc3_flow_dispatch_entry_t));
+	atsc3_flow_dispatch_entry.dst_ip_addr = dst_ip_addr;
+	atsc3_flow_dispatch_entry.dst_port = dst_port;
+
+	//no SLT yet
+	if(!atsc3_flow_dispatch_table) {
+		if(dst_ip_addr == UDP_FILTER_MDNS_IP_ADDRESS && dst_port == UDP_FILTER_MDNS_PORT) {
+			atsc3_flow_dispatch_entry.kind = ATSC3_FLOW_DISPATCH_MDNS;
+		} else if(dst_ip_addr == LLS_DST_ADDR && dst_port == LLS_DST_PORT) {
+			atsc3_flow_dispatch_entry.kind = ATSC3_FLOW_DISPATCH_LLS;
+		}
+	}
+
+	return atsc3_flow_dispatch_entry;
+}
+
+void atsc3_flow_dispatch_free(lls_slt_monitor_t* lls_slt_monitor) {
+	pthread_mutex_lock(&atsc3_flow_dispatch_writer_mutex);
+	atsc3_qsbr_retire(__atomic_exchange_n(&lls_slt_monitor->atsc3_flow_dispatch_table, NULL, __ATOMIC_ACQ_REL), free);
+	pthread_mutex_unlock(&atsc3_flow_dispatch_writer_mutex);
+}
@@ -0,0 +1,85 @@
+/*
+ * atsc3_flow_dispatch.h
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: jjustman
+ *
+ * per packet UDP flow classification
+ *
+ * the mDNS and LLS flows and every ALC and MMT session from the SLT are compiled into one open addressing table
+ * keyed on (dst ip, dst port), an ALC session without sls_relax_source_ip_check also matches on src ip. entries
+ * sharing a key are probed in the order the linear matching used to check them: mDNS, LLS, ALC, then MMT sessions.
+ * once a service's S-TSID has been received, each ROUTE session (RS) it announces on another flow is added as an ALC
+ * entry for the same lls_sls_alc_session_t.
+ *
+ * the table is only rebuilt when the SLT sessions, the selected service monitors or an S-TSID change, and is published with
+ * a release store so readers never lock. a replaced table is handed to atsc3_qsbr_retire, so threads calling
+ * atsc3_flow_dispatch_find must call atsc3_qsbr_quiescent between packets, it is freed once each of them has.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <pthread.h>
+
+#include "atsc3_utils.h"
+#include "atsc3_logging.h"
+#include "atsc3_lls.h"
+#include "atsc3_lls_types.h"
+#include "atsc3_qsbr.h"
+
+#ifndef ATSC3_FLOW_DISPATCH_H_
+#define ATSC3_FLOW_DISPATCH_H_
+
+#if defined (__cplusplus)
+extern "C" {
+#endif
+
+#define ATSC3_FLOW_DISPATCH_TABLE_MIN_SIZE 16
+
+typedef enum {
+	ATSC3_FLOW_DISPATCH_UNKNOWN = 0,
+	ATSC3_FLOW_DISPATCH_MDNS,
+	ATSC3_FLOW_DISPATCH_LLS,
+	ATSC3_FLOW_DISPATCH_ALC,
+	ATSC3_FLOW_DISPATCH_MMT
+} atsc3_flow_dispatch_kind_t;
+
+typedef struct atsc3_flow_dispatch_entry {
+	atsc3_flow_dispatch_kind_t	kind;		//ATSC3_FLOW_DISPATCH_UNKNOWN for an empty slot
+	uint32_t					dst_ip_addr;
+	uint16_t					dst_port;
+	bool						match_src_ip_addr;
+	uint32_t					src_ip_addr;
+
+	lls_sls_alc_session_t*		lls_sls_alc_session;
+	lls_sls_mmt_session_t*		lls_sls_mmt_session;
+	//set when the session belongs to the service currently being monitored
+	lls_sls_alc_monitor_t*		lls_sls_alc_monitor;
+	lls_sls_mmt_monitor_t*		lls_sls_mmt_monitor;
+} atsc3_flow_dispatch_entry_t;
+
+typedef struct atsc3_flow_dispatch_table {
+	uint8_t						lls_table_version;
+	uint32_t					entries_n;
+	uint32_t					size;		//power of 2
+	atsc3_flow_dispatch_entry_t	entries[];
+} atsc3_flow_dispatch_table_t;
+
+//recompiles the table from lls_slt_monitor's sessions and monitors and publishes it, safe to call from any thread
+void atsc3_flow_dispatch_rebuild(lls_slt_monitor_t* lls_slt_monitor);
+
+//one probe of the published table, mDNS and LLS are still classified before the first SLT has been received
+atsc3_flow_dispatch_entry_t atsc3_flow_dispatch_find(lls_slt_monitor_t* lls_slt_monitor, uint32_t src_ip_addr, uint32_t dst_ip_addr, uint16_t dst_port);
+
+void atsc3_flow_dispatch_free(lls_slt_monitor_t* lls_slt_monitor);
+
+#if defined (__cplusplus)
+}
+#endif
+
+#define __FLOW_DISPATCH_DEBUG(...)   if(_FLOW_DISPATCH_DEBUG_ENABLED) { __ATSC3_LOG_DEBUG(ATSC3_LOG_MODULE_FLOW_DISPATCH, __VA_ARGS__); }
+
+extern int _FLOW_DISPATCH_DEBUG_ENABLED;
+
+#endif /* ATSC3_FLOW_DISPATCH_H_ */
@@ -0,0 +1,295 @@
+/*
+ * atsc3_gf256.c
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: jjustman
+ */
+
+#include <string.h>
+#include <pthread.h>
+
+#include "atsc3_gf256.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define __ATSC3_GF256_X86 1
+#endif
+
+#if defined(__aarch64__) && defined(__ARM_NEON)
+#include <arm_neon.h>
+#define __ATSC3_GF256_NEON 1
+#endif
+
+uint8_t atsc3_gf256_exp[510];
+uint8_t atsc3_gf256_log[256];
+
+//split nibble product tables: c * x = mul_lo[c][x & 0xf] ^ mul_hi[c][x >> 4]
+static uint8_t atsc3_gf256_mul_lo[256][16] __attribute__((aligned(16)));
+static uint8_t atsc3_gf256_mul_hi[256][16] __attribute__((aligned(16)));
+
+static pthread_once_t atsc3_gf256_init_once = PTHREAD_ONCE_INIT;
+
+typedef void (*atsc3_gf256_row_add_f)(uint8_t* dst, const uint8_t* src, size_t len);
+typedef void (*atsc3_gf256_row_muladd_f)(uint8_t* dst, const uint8_t* src, uint8_t c, size_t len);
+typedef void (*atsc3_gf256_row_mul_f)(uint8_t* dst, uint8_t c, size_t len);
+
+static atsc3_gf256_row_add_f	atsc3_gf256_row_add_impl = NULL;
+static atsc3_gf256_row_muladd_f	atsc3_gf256_row_muladd_impl = NULL;
+static atsc3_gf256_row_mul_f	atsc3_gf256_row_mul_impl = NULL;
+static const char*				atsc3_gf256_impl = "uninitialized";
+
+/*
+ * portable
+ */
+
+static void atsc3_gf256_row_add_scalar(uint8_t* dst, const uint8_t* src, size_t len) {
+	size_t i = 0;
+	for(; i + 8 <= len; i += 8) {
+		uint64_t d, s;
+		memcpy(&d, dst + i, 8);
+		memcpy(&s, src + i, 8);
+		d ^= s;
+		memcpy(dst + i, &d, 8);
+	}
+	for(; i < len; i++) {
+		dst[i] ^= src[i];
+	}
+}
+
+static void atsc3_gf256_row_muladd_scalar(uint8_t* dst, const uint8_t* src, uint8_t c, size_t len) {
+	const uint8_t* lo = atsc3_gf256_mul_lo[c];
+	const uint8_t* hi = atsc3_gf256_mul_hi[c];
+	for(size_t i = 0; i < len; i++) {
+		dst[i] ^= lo[src[i] & 0xf] ^ hi[src[i] >> 4];
+	}
+}
+
+static void atsc3_gf256_row_mul_scalar(uint8_t* dst, uint8_t c, size_t len) {
+	const uint8_t* lo = atsc3_gf256_mul_lo[c];
+	const uint8_t* hi = atsc3_gf256_mul_hi[c];
+	for(size_t i = 0; i < len; i++) {
+		dst[i] = lo[dst[i] & 0xf] ^ hi[dst[i] >> 4];
+	}
+}
+
+#ifdef __ATSC3_GF256_X86
+
+/*
+ * sse2 (x86_64 baseline) xor, ssse3/avx2 pshufb multiply
+ */
+
+__attribute__((target("sse2")))
+static void atsc3_gf256_row_add_sse2(uint8_t* dst, const uint8_t* src, size_t len) {
+	size_t i = 0;
+	for(; i + 16 <= len; i += 16) {
+		__m128i d = _mm_loadu_si128((const __m128i*)(dst + i));
+		__m128i s = _mm_loadu_si128((const __m128i*)(src + i));
+		_mm_storeu_si128((__m128i*)(dst + i), _mm_xor_si128(d, s));
+	}
+	atsc3_gf256_row_add_scalar(dst + i, src + i, len - i);
+}
+
+__attribute__((target("ssse3")))
+static void atsc3_gf256_row_muladd_ssse3(uint8_t* dst, const uint8_t* src, uint8_t c, size_t len) {
+	const __m128i lo = _mm_load_si128((const __m128i*)atsc3_gf256_mul_lo[c]);
+	const __m128i hi = _mm_load_si128((const __m128i*)atsc3_gf256_mul_hi[c]);
+	const __m128i mask = _mm_set1_epi8(0x0f);
+
+	size_t i = 0;
+	for(; i + 16 <= len; i += 16) {
+		__m128i s = _mm_loadu_si128((const __m128i*)(src + i));
+		__m128i p = _mm_xor_si128(_mm_shuffle_epi8(lo, _mm_and_si128(s, mask)), _mm_shuffle_epi8(hi, _mm_and_si128(_mm_srli_epi64(s, 4), mask)));
+		__m128i d = _mm_loadu_si128((const __m128i*)(dst + i));
+		_mm_storeu_si128((__m128i*)(dst + i), _mm_xor_si128(d, p));
+	}
+	atsc3_gf256_row_muladd_scalar(dst + i, src + i, c, len - i);
+}
+
+__attribute__((target("ssse3")))
+static void atsc3_gf256_row_mul_ssse3(uint8_t* dst, uint8_t c, size_t len) {
+	const __m128i lo = _mm_load_si128((const __m128i*)atsc3_gf256_mul_lo[c]);
+	const __m128i hi = _mm_load_si128((const __m128i*)atsc3_gf256_mul_hi[c]);
+	const __m128i mask = _mm_set1_epi8(0x0f);
+
+	size_t i = 0;
+	for(; i + 16 <= len; i += 16) {
+		__m128i d = _mm_loadu_si128((const __m128i*)(dst + i));
+		__m128i p = _mm_xor_si128(_mm_shuffle_epi8(lo, _mm_and_si128(d, mask)), _mm_shuffle_epi8(hi, _mm_and_si128(_mm_srli_epi64(d, 4), mask)));
+		_mm_storeu_si128((__m128i*)(dst + i), p);
+	}
+	atsc3_gf256_row_mul_scalar(dst + i, c, len - i);
+}
+
+__attribute__((target("avx2")))
+static void atsc3_gf256_row_add_avx2(uint8_t* dst, const uint8_t* src, size_t len) {
+	size_t i = 0;
+	for(; i + 32 <= len; i += 32) {
+		__m256i d = _mm256_loadu_si256((const __m256i*)(dst + i));
+		__m256i s = _mm256_loadu_si256((const __m256i*)(src + i));
+		_mm256_storeu_si256((__m256i*)(dst + i), _mm256_xor_si256(d, s));
+	}
+	atsc3_gf256_row_add_scalar(dst + i, src + i, len - i);
+}
+
+__attribute__((target("avx2")))
+static void atsc3_gf256_row_muladd_avx2(uint8_t* dst, const uint8_t* src, uint8_t c, size_t len) {
+	const __m256i lo = _mm256_broadcastsi128_si256(_mm_load_si128((const __m128i*)atsc3_gf256_mul_lo[c]));
+	const __m256i hi = _mm256_broadcastsi128_si256(_mm_load_si128((const __m128i*)atsc3_gf256_mul_hi[c]));
+	const __m256i mask = _mm256_set1_epi8(0x0f);
+
+	size_t i = 0;
+	for(; i + 32 <= len; i += 32) {
+		__m256i s = _mm256_loadu_si256((const __m256i*)(src + i));
+		__m256i p = _mm256_xor_si256(_mm256_shuffle_epi8(lo, _mm256_and_si256(s, mask)), _mm256_shuffle_epi8(hi, _mm256_and_si256(_mm256_srli_epi64(s, 4), mask)));
+		__m256i d = _mm256_loadu_si256((const __m256i*)(dst + i));
+		_mm256_storeu_si256((__m256i*)(dst + i), _mm256_xor_si256(d, p));
+	}
+	atsc3_gf256_row_muladd_scalar(dst + i, src + i, c, len - i);
+}
+
+__attribute__((target("avx2")))
+static void atsc3_gf256_row_mul_avx2(uint8_t* dst, uint8_t c, size_t len) {
+	const __m256i lo = _mm256_broadcastsi128_si256(_mm_load_si128((const __m128i*)atsc3_gf256_mul_lo[c]));
+	const __m256i hi = _mm256_broadcastsi128_si256(_mm_load_si128((const __m128i*)atsc3_gf256_mul_hi[c]));
+	const __m256i mask = _mm256_set1_epi8(0x0f);
+
+	size_t i = 0;
+	for(; i + 32 <= len; i += 32) {
+		__m256i d = _mm256_loadu_si256((const __m256i*)(dst + i));
+		__m256i p = _mm256_xor_si256(_mm256_shuffle_epi8(lo, _mm256_and_si256(d, mask)), _mm256_shuffle_epi8(hi, _mm256_and_si256(_mm256_srli_epi64(d, 4), mask)));
+		_mm256_storeu_si256((__m256i*)(dst + i), p);
+	}
+	atsc3_gf256_row_mul_scalar(dst + i, c, len - i);
+}
+
+#endif
+
+#ifdef __ATSC3_GF256_NEON
+
+static void atsc3_gf256_row_add_neon(uint8_t* dst, const uint8_t* src, size_t len) {
+	size_t i = 0;
+	for(; i + 16 <= len; i += 16) {
+		vst1q_u8(dst + i, veorq_u8(vld1q_u8(dst + i), vld1q_u8(src + i)));
+	}
+	atsc3_gf256_row_add_scalar(dst + i, src + i, len - i);
+}
+
+static void atsc3_gf256_row_muladd_neon(uint8_t* dst, const uint8_t* src, uint8_t c, size_t len) {
+	const uint8x16_t lo = vld1q_u8(atsc3_gf256_mul_lo[c]);
+	const uint8x16_t hi = vld1q_u8(atsc3_gf256_mul_hi[c]);
+	const uint8x16_t mask = vdupq_n_u8(0x0f);
+
+	size_t i = 0;
+	for(; i + 16 <= len; i += 16) {
+		uint8x16_t s = vld1q_u8(src + i);
+		uint8x16_t p = veorq_u8(vqtbl1q_u8(lo, vandq_u8(s, mask)), vqtbl1q_u8(hi, vshrq_n_u8(s, 4)));
+		vst1q_u8(dst + i, veorq_u8(vld1q_u8(dst + i), p));
+	}
+	atsc3_gf256_row_muladd_scalar(dst + i, src + i, c, len - i);
+}
+
+static void atsc3_gf256_row_mul_neon(uint8_t* dst, uint8_t c, size_t len) {
+	const uint8x16_t lo = vld1q_u8(atsc3_gf256_mul_lo[c]);
+	const uint8x16_t hi = vld1q_u8(atsc3_gf256_mul_hi[c]);
+	const uint8x16_t mask = vdupq_n_u8(0x0f);
+
+	size_t i = 0;
+	for(; i + 16 <= len; i += 16) {
+		uint8x16_t d = vld1q_u8(dst + i);
+		vst1q_u8(dst + i, veorq_u8(vqtbl1q_u8(lo, vandq_u8(d, mask)), vqtbl1q_u8(hi, vshrq_n_u8(d, 4))));
+	}
+	atsc3_gf256_row_mul_scalar(dst + i, c, len - i);
+}
+
+#endif
+
+static void atsc3_gf256_init_tables() {
+	uint32_t x = 1;
+	for(int i = 0; i < 255; i++) {
+		atsc3_gf256_exp[i] = x;
+		atsc3_gf256_exp[i + 255] = x;
+		atsc3_gf256_log[x] = i;
+		x <<= 1;
+		if(x & 0x100) {
+			x ^= ATSC3_GF256_POLYNOMIAL;
+		}
+	}
+	atsc3_gf256_log[0] = 0;
+
+	for(int c = 0; c < 256; c++) {
+		for(int n = 0; n < 16; n++) {
+			atsc3_gf256_mul_lo[c][n] = atsc3_gf256_mul(c, n);
+			atsc3_gf256_mul_hi[c][n] = atsc3_gf256_mul(c, n << 4);
+		}
+	}
+
+	atsc3_gf256_row_add_impl = atsc3_gf256_row_add_scalar;
+	atsc3_gf256_row_muladd_impl = atsc3_gf256_row_muladd_scalar;
+	atsc3_gf256_row_mul_impl = atsc3_gf256_row_mul_scalar;
+	atsc3_gf256_impl = "scalar";
+
+	//ATSC3_GF256_IMPL=scalar pins the portable path for comparison runs
+	const char* impl_override = getenv("ATSC3_GF256_IMPL");
+	if(impl_override && !strcmp(impl_override, "scalar")) {
+		return;
+	}
+
+#ifdef __ATSC3_GF256_X86
+	__builtin_cpu_init();
+	if(__builtin_cpu_supports("avx2")) {
+		atsc3_gf256_row_add_impl = atsc3_gf256_row_add_avx2;
+		atsc3_gf256_row_muladd_impl = atsc3_gf256_row_muladd_avx2;
+		atsc3_gf256_row_mul_impl = atsc3_gf256_row_mul_avx2;
+		atsc3_gf256_impl = "avx2";
+	} else if(__builtin_cpu_supports("ssse3")) {
+		atsc3_gf256_row_add_impl = atsc3_gf256_row_add_sse2;
+		atsc3_gf256_row_muladd_impl = atsc3_gf256_row_muladd_ssse3;
+		atsc3_gf256_row_mul_impl = atsc3_gf256_row_mul_ssse3;
+		atsc3_gf256_impl = "ssse3";
+	} else if(__builtin_cpu_supports("sse2")) {
+		atsc3_gf256_row_add_impl = atsc3_gf256_row_add_sse2;
+		atsc3_gf256_impl = "sse2";
+	}
+#endif
+
+#ifdef __ATSC3_GF256_NEON
+	atsc3_gf256_row_add_impl = atsc3_gf256_row_add_neon;
+	atsc3_gf256_row_muladd_impl = atsc3_gf256_row_muladd_neon;
+	atsc3_gf256_row_mul_impl = atsc3_gf256_row_mul_neon;
+	atsc3_gf256_impl = "neon";
+#endif
+}
+
+void atsc3_gf256_init() {
+	pthread_once(&atsc3_gf256_init_once, atsc3_gf256_init_tables);
+}
+
+const char* atsc3_gf256_impl_name() {
+	return atsc3_gf256_impl;
+}
+
+void atsc3_gf256_row_add(uint8_t* dst, const uint8_t* src, size_t len) {
+	atsc3_gf256_row_add_impl(dst, src, len);
+}
+
+void atsc3_gf256_row_muladd(uint8_t* dst, const uint8_t* src, uint8_t c, size_t len) {
+	if(!c) {
+		return;
+	}
+	if(c == 1) {
+		atsc3_gf256_row_add_impl(dst, src, len);
+		return;
+	}
+	atsc3_gf256_row_muladd_impl(dst, src, c, len);
+}
+
+void atsc3_gf256_row_mul(uint8_t* dst, uint8_t c, size_t len) {
+	if(c == 1) {
+		return;
+	}
+	if(!c) {
+		memset(dst, 0, len);
+		return;
+	}
+	atsc3_gf256_row_mul_impl(dst, c, len);
+}
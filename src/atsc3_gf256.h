@@ -0,0 +1,72 @@
+/*
+ * atsc3_gf256.h
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: jjustman
+ *
+ * GF(256) octet arithmetic for the RaptorQ decoder, RFC 6330 5.7, irreducible polynomial x^8 + x^4 + x^3 + x^2 + 1 (0x11d)
+ *
+ * symbol (row) operations are the hot path of the decoder, they are dispatched once at atsc3_gf256_init():
+ *
+ * 	x86_64:		avx2 or ssse3 split nibble multiply (pshufb on 16 entry lo/hi product tables), sse2 xor baseline
+ * 	aarch64:	neon split nibble multiply (vqtbl1q)
+ * 	otherwise:	portable 64-bit word xor and nibble table multiply
+ *
+ * the x86 variants are built with function target attributes and selected with __builtin_cpu_supports,
+ * so the library does not need to be compiled with -mavx2 to use them. ATSC3_GF256_IMPL=scalar in the
+ * environment forces the portable path
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdlib.h>
+
+#ifndef ATSC3_GF256_H_
+#define ATSC3_GF256_H_
+
+#if defined (__cplusplus)
+extern "C" {
+#endif
+
+#define ATSC3_GF256_POLYNOMIAL	0x11d
+
+//OCT_EXP is doubled so gf256_exp[log(a) + log(b)] does not need a modulo
+extern uint8_t atsc3_gf256_exp[510];
+extern uint8_t atsc3_gf256_log[256];
+
+//safe to call more than once, selects the row operation implementation for this cpu
+void atsc3_gf256_init();
+const char* atsc3_gf256_impl_name();
+
+static inline uint8_t atsc3_gf256_mul(uint8_t a, uint8_t b) {
+	if(!a || !b) {
+		return 0;
+	}
+	return atsc3_gf256_exp[atsc3_gf256_log[a] + atsc3_gf256_log[b]];
+}
+
+//b must be non-zero
+static inline uint8_t atsc3_gf256_div(uint8_t a, uint8_t b) {
+	if(!a) {
+		return 0;
+	}
+	return atsc3_gf256_exp[atsc3_gf256_log[a] - atsc3_gf256_log[b] + 255];
+}
+
+//alpha^^i, RFC 6330 5.7.2
+static inline uint8_t atsc3_gf256_alpha_pow(uint32_t i) {
+	return atsc3_gf256_exp[i % 255];
+}
+
+//dst ^= src
+void atsc3_gf256_row_add(uint8_t* dst, const uint8_t* src, size_t len);
+//dst ^= c * src
+void atsc3_gf256_row_muladd(uint8_t* dst, const uint8_t* src, uint8_t c, size_t len);
+//dst = c * dst
+void atsc3_gf256_row_mul(uint8_t* dst, uint8_t c, size_t len);
+
+#if defined (__cplusplus)
+}
+#endif
+
+#endif /* ATSC3_GF256_H_ */
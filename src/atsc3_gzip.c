@@ -91,3 +91,102 @@ int32_t atsc3_unzip_gzip_payload(uint8_t* input_payload, uint32_t input_payload_
 	return ret == Z_STREAM_END ?  paylod_len : Z_DATA_ERROR;
 
 }
+
+atsc3_gzip_stream_t* atsc3_gzip_stream_new() {
+	return (atsc3_gzip_stream_t*)calloc(1, sizeof(atsc3_gzip_stream_t));
+}
+
+void atsc3_gzip_stream_reset(atsc3_gzip_stream_t* atsc3_gzip_stream) {
+	if(atsc3_gzip_stream->initialized) {
+		inflateReset(&atsc3_gzip_stream->strm);
+	}
+	atsc3_gzip_stream->finished = false;
+	atsc3_gzip_stream->failed = false;
+	atsc3_gzip_stream->consumed = 0;
+}
+
+int atsc3_gzip_stream_inflate(atsc3_gzip_stream_t* atsc3_gzip_stream, const uint8_t* input, uint32_t input_len, block_t* output) {
+	z_stream* strm = &atsc3_gzip_stream->strm;
+
+	if(atsc3_gzip_stream->failed) {
+		return Z_DATA_ERROR;
+	}
+	if(atsc3_gzip_stream->finished) {
+		atsc3_gzip_stream->failed = input_len > 0;
+		return input_len ? Z_DATA_ERROR : 1;
+	}
+
+	if(!atsc3_gzip_stream->initialized) {
+		strm->zalloc = Z_NULL;
+		strm->zfree = Z_NULL;
+		strm->opaque = Z_NULL;
+		strm->avail_in = 0;
+		strm->next_in = Z_NULL;
+		//treat the input as gzip not just deflate
+		if(inflateInit2(strm, 16+MAX_WBITS) != Z_OK) {
+			atsc3_gzip_stream->failed = true;
+			return Z_MEM_ERROR;
+		}
+		atsc3_gzip_stream->initialized = true;
+	}
+
+	strm->next_in = (Bytef*)input;
+	strm->avail_in = input_len;
+	strm->avail_out = 1;
+
+	//inflate straight into the tail of output, keep going while there is input left or the output filled up
+	while(strm->avail_in || !strm->avail_out) {
+		if(output->i_pos == output->p_size && !block_Resize(output, __MAX(GZIP_CHUNK_OUTPUT_BUFFER_SIZE, output->p_size * 2))) {
+			atsc3_gzip_stream->failed = true;
+			return Z_MEM_ERROR;
+		}
+
+		strm->next_out = &output->p_buffer[output->i_pos];
+		strm->avail_out = output->p_size - output->i_pos;
+
+		int ret = inflate(strm, Z_NO_FLUSH);
+		output->i_pos = output->p_size - strm->avail_out;
+
+		if(ret == Z_STREAM_END) {
+			atsc3_gzip_stream->finished = true;
+			atsc3_gzip_stream->consumed += input_len - strm->avail_in;
+			//trailing bytes past the gzip member
+			if(strm->avail_in) {
+				atsc3_gzip_stream->failed = true;
+				return Z_DATA_ERROR;
+			}
+			return 1;
+		}
+		if(ret != Z_OK && ret != Z_BUF_ERROR) {
+			atsc3_gzip_stream->failed = true;
+			return ret == Z_NEED_DICT ? Z_DATA_ERROR : ret;
+		}
+		if(ret == Z_BUF_ERROR && strm->avail_out) {
+			break;
+		}
+	}
+
+	atsc3_gzip_stream->consumed += input_len;
+	return 0;
+}
+
+int atsc3_gzip_stream_inflate_all(atsc3_gzip_stream_t* atsc3_gzip_stream, const uint8_t* input, uint32_t input_len, block_t* output) {
+	atsc3_gzip_stream_reset(atsc3_gzip_stream);
+	block_Rewind(output);
+
+	int ret = atsc3_gzip_stream_inflate(atsc3_gzip_stream, input, input_len, output);
+	return ret == 0 ? Z_DATA_ERROR : ret;
+}
+
+void atsc3_gzip_stream_free(atsc3_gzip_stream_t** atsc3_gzip_stream_p) {
+	atsc3_gzip_stream_t* atsc3_gzip_stream = *atsc3_gzip_stream_p;
+	if(!atsc3_gzip_stream) {
+		return;
+	}
+
+	if(atsc3_gzip_stream->initialized) {
+		(void)inflateEnd(&atsc3_gzip_stream->strm);
+	}
+	free(atsc3_gzip_stream);
+	*atsc3_gzip_stream_p = NULL;
+}
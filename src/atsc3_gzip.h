@@ -9,9 +9,11 @@
 #include <string.h>
 #include <stdlib.h>
 #include <stdio.h>
+#include <stdbool.h>
 
 
 #include "zlib.h"
+#include "atsc3_utils.h"
 
 #ifndef ATSC3_GZIP_H_
 #define ATSC3_GZIP_H_
@@ -27,5 +29,27 @@
 
 int32_t atsc3_unzip_gzip_payload(uint8_t* input_payload, uint32_t input_payload_size, uint8_t **decompressed_payload);
 
+/**
+ * incremental gzip inflate, for objects that arrive in pieces (e.g. ROUTE objects with FDT Content-Encoding: gzip)
+ *
+ * each atsc3_gzip_stream_inflate call consumes all of its input and appends what it decodes to output, which is grown
+ * geometrically with block_Write - there is no input size cap. reset between objects keeps the zlib state allocated.
+ */
+typedef struct atsc3_gzip_stream {
+	z_stream	strm;
+	bool		initialized;
+	bool		finished;		//gzip trailer seen, any further input is an error
+	bool		failed;
+	uint32_t	consumed;		//compressed bytes fed since the last reset
+} atsc3_gzip_stream_t;
+
+atsc3_gzip_stream_t* atsc3_gzip_stream_new();
+void atsc3_gzip_stream_reset(atsc3_gzip_stream_t* atsc3_gzip_stream);
+//returns 1 once the end of the gzip stream is reached, 0 if more input is needed, < 0 on error (the stream stays failed until reset)
+int atsc3_gzip_stream_inflate(atsc3_gzip_stream_t* atsc3_gzip_stream, const uint8_t* input, uint32_t input_len, block_t* output);
+//whole object decode into output, from a reset stream
+int atsc3_gzip_stream_inflate_all(atsc3_gzip_stream_t* atsc3_gzip_stream, const uint8_t* input, uint32_t input_len, block_t* output);
+void atsc3_gzip_stream_free(atsc3_gzip_stream_t** atsc3_gzip_stream_p);
+
 
 #endif /* ATSC3_GZIP_H_ */
@@ -0,0 +1,160 @@
+/*
+ * atsc3_isobmff_cmaf_chunk.c
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: jjustman
+ */
+
+#include "atsc3_isobmff_cmaf_chunk.h"
+
+#define __BOX_TYPE(a, b, c, d) (((uint32_t)(a) << 24) | ((uint32_t)(b) << 16) | ((uint32_t)(c) << 8) | (uint32_t)(d))
+
+#define __TFHD_FLAGS_DEFAULT_BASE_IS_MOOF	0x020000
+#define __TRUN_FLAGS_ONE_FULL_SAMPLE		0x000F01
+
+static uint8_t* __write_u32(uint8_t* p, uint32_t v) {
+	p[0] = v >> 24;
+	p[1] = v >> 16;
+	p[2] = v >> 8;
+	p[3] = v;
+	return p + 4;
+}
+
+static uint8_t* __write_u64(uint8_t* p, uint64_t v) {
+	p = __write_u32(p, (uint32_t)(v >> 32));
+	return __write_u32(p, (uint32_t)v);
+}
+
+static uint8_t* __write_box_header(uint8_t* p, uint32_t size, uint32_t type) {
+	p = __write_u32(p, size);
+	return __write_u32(p, type);
+}
+
+static uint8_t* __write_full_box_header(uint8_t* p, uint32_t size, uint32_t type, uint8_t version, uint32_t flags) {
+	p = __write_box_header(p, size, type);
+	return __write_u32(p, ((uint32_t)version << 24) | (flags & 0xFFFFFF));
+}
+
+static uint32_t __read_u32(uint8_t* p) {
+	return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 8) | (uint32_t)p[3];
+}
+
+block_t* atsc3_isobmff_cmaf_chunk_build(uint32_t sequence_number, atsc3_isobmff_cmaf_chunk_sample_t* atsc3_isobmff_cmaf_chunk_sample, uint8_t* sample, uint32_t sample_size) {
+	block_t* chunk = block_Alloc(ATSC3_ISOBMFF_CMAF_CHUNK_OVERHEAD + sample_size);
+	uint8_t* p = chunk->p_buffer;
+
+	p = __write_box_header(p, ATSC3_ISOBMFF_CMAF_CHUNK_MOOF_SIZE, __BOX_TYPE('m','o','o','f'));
+
+	p = __write_full_box_header(p, 16, __BOX_TYPE('m','f','h','d'), 0, 0);
+	p = __write_u32(p, sequence_number);
+
+	p = __write_box_header(p, 80, __BOX_TYPE('t','r','a','f'));
+
+	p = __write_full_box_header(p, 16, __BOX_TYPE('t','f','h','d'), 0, __TFHD_FLAGS_DEFAULT_BASE_IS_MOOF);
+	p = __write_u32(p, atsc3_isobmff_cmaf_chunk_sample->track_id);
+
+	p = __write_full_box_header(p, 20, __BOX_TYPE('t','f','d','t'), 1, 0);
+	p = __write_u64(p, atsc3_isobmff_cmaf_chunk_sample->base_media_decode_time);
+
+	p = __write_full_box_header(p, 36, __BOX_TYPE('t','r','u','n'), 0, __TRUN_FLAGS_ONE_FULL_SAMPLE);
+	p = __write_u32(p, 1);
+	//relative to the start of the moof, first byte after the mdat header
+	p = __write_u32(p, ATSC3_ISOBMFF_CMAF_CHUNK_OVERHEAD);
+	p = __write_u32(p, atsc3_isobmff_cmaf_chunk_sample->sample_duration);
+	p = __write_u32(p, sample_size);
+	p = __write_u32(p, atsc3_isobmff_cmaf_chunk_sample->sample_flags);
+	p = __write_u32(p, atsc3_isobmff_cmaf_chunk_sample->sample_composition_time_offset);
+
+	p = __write_box_header(p, 8 + sample_size, __BOX_TYPE('m','d','a','t'));
+	if(sample_size) {
+		memcpy(p, sample, sample_size);
+	}
+
+	chunk->i_pos = ATSC3_ISOBMFF_CMAF_CHUNK_OVERHEAD + sample_size;
+	return chunk;
+}
+
+uint32_t atsc3_isobmff_cmaf_init_box_length(uint8_t* buf, uint32_t len) {
+	uint32_t pos = 0;
+	bool has_moov = false;
+
+	while(pos + 8 <= len) {
+		uint32_t box_size = __read_u32(&buf[pos]);
+		uint32_t box_type = __read_u32(&buf[pos + 4]);
+
+		if(box_type == __BOX_TYPE('m','o','o','f')) {
+			break;
+		}
+		if(box_size < 8 || box_size > len - pos) {
+			__ISOBMFF_CMAF_CHUNK_WARN("atsc3_isobmff_cmaf_init_box_length: invalid box size: %u at pos: %u, len: %u", box_size, pos, len);
+			return 0;
+		}
+		if(box_type == __BOX_TYPE('m','o','o','v')) {
+			has_moov = true;
+		}
+		pos += box_size;
+	}
+
+	return has_moov ? pos : 0;
+}
+
+//returns the payload of the first child box of type within [buf, buf + len), NULL if not found
+static uint8_t* __find_child_box(uint8_t* buf, uint32_t len, uint32_t type, uint32_t* child_len) {
+	uint32_t pos = 0;
+
+	while(pos + 8 <= len) {
+		uint32_t box_size = __read_u32(&buf[pos]);
+		if(box_size < 8 || box_size > len - pos) {
+			return NULL;
+		}
+		if(__read_u32(&buf[pos + 4]) == type) {
+			*child_len = box_size - 8;
+			return &buf[pos + 8];
+		}
+		pos += box_size;
+	}
+	return NULL;
+}
+
+bool atsc3_isobmff_cmaf_init_find_track(uint8_t* init_box, uint32_t init_box_len, uint32_t handler_type, uint32_t* track_id, uint32_t* timescale) {
+	uint32_t moov_len = 0;
+	uint8_t* moov = __find_child_box(init_box, init_box_len, __BOX_TYPE('m','o','o','v'), &moov_len);
+	if(!moov) {
+		return false;
+	}
+
+	uint32_t pos = 0;
+	while(pos + 8 <= moov_len) {
+		uint32_t box_size = __read_u32(&moov[pos]);
+		if(box_size < 8 || box_size > moov_len - pos) {
+			return false;
+		}
+
+		if(__read_u32(&moov[pos + 4]) == __BOX_TYPE('t','r','a','k')) {
+			uint8_t* trak = &moov[pos + 8];
+			uint32_t trak_len = box_size - 8;
+			uint32_t tkhd_len = 0, mdia_len = 0, hdlr_len = 0, mdhd_len = 0;
+
+			uint8_t* tkhd = __find_child_box(trak, trak_len, __BOX_TYPE('t','k','h','d'), &tkhd_len);
+			uint8_t* mdia = __find_child_box(trak, trak_len, __BOX_TYPE('m','d','i','a'), &mdia_len);
+			uint8_t* hdlr = mdia ? __find_child_box(mdia, mdia_len, __BOX_TYPE('h','d','l','r'), &hdlr_len) : NULL;
+			uint8_t* mdhd = mdia ? __find_child_box(mdia, mdia_len, __BOX_TYPE('m','d','h','d'), &mdhd_len) : NULL;
+
+			//hdlr: version/flags, pre_defined, handler_type
+			if(tkhd && hdlr && mdhd && hdlr_len >= 12 && __read_u32(&hdlr[8]) == handler_type) {
+				//tkhd/mdhd v1 carry 64 bit creation and modification times
+				uint32_t tkhd_track_id_pos = tkhd[0] == 1 ? 20 : 12;
+				uint32_t mdhd_timescale_pos = mdhd[0] == 1 ? 20 : 12;
+				if(tkhd_len < tkhd_track_id_pos + 4 || mdhd_len < mdhd_timescale_pos + 4) {
+					return false;
+				}
+				*track_id = __read_u32(&tkhd[tkhd_track_id_pos]);
+				*timescale = __read_u32(&mdhd[mdhd_timescale_pos]);
+				return true;
+			}
+		}
+		pos += box_size;
+	}
+
+	return false;
+}
@@ -0,0 +1,71 @@
+/*
+ * atsc3_isobmff_cmaf_chunk.h
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: jjustman
+ *
+ * single sample CMAF chunks (moof + mdat) for the MMT low-latency MFU output mode
+ *
+ * each chunk is a self contained movie fragment:
+ *
+ * 	moof
+ * 		mfhd	sequence_number
+ * 		traf
+ * 			tfhd	track_ID, default-base-is-moof
+ * 			tfdt	v1, baseMediaDecodeTime
+ * 			trun	1 sample: data_offset, duration, size, flags, composition time offset
+ * 	mdat	sample
+ *
+ * the init segment (ftyp + moov) is not built here, it is taken from the leading boxes of the joined
+ * MPU fragment, atsc3_isobmff_cmaf_init_find_track resolves the track_ID and mdhd timescale by handler type
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "atsc3_utils.h"
+#include "atsc3_logging.h"
+
+#ifndef ATSC3_ISOBMFF_CMAF_CHUNK_H_
+#define ATSC3_ISOBMFF_CMAF_CHUNK_H_
+
+#if defined (__cplusplus)
+extern "C" {
+#endif
+
+#define ATSC3_ISOBMFF_CMAF_CHUNK_MOOF_SIZE		104
+#define ATSC3_ISOBMFF_CMAF_CHUNK_OVERHEAD		(ATSC3_ISOBMFF_CMAF_CHUNK_MOOF_SIZE + 8)
+
+#define ATSC3_ISOBMFF_HANDLER_VIDE				0x76696465
+#define ATSC3_ISOBMFF_HANDLER_SOUN				0x736f756e
+
+//trun sample_flags, ISO/IEC 14496-12 8.8.3.1
+#define ATSC3_ISOBMFF_SAMPLE_FLAGS_SYNC			0x02000000
+#define ATSC3_ISOBMFF_SAMPLE_FLAGS_NON_SYNC		0x01010000
+
+typedef struct atsc3_isobmff_cmaf_chunk_sample {
+	uint32_t	track_id;
+	uint64_t	base_media_decode_time;
+	uint32_t	sample_duration;
+	uint32_t	sample_flags;
+	uint32_t	sample_composition_time_offset;
+} atsc3_isobmff_cmaf_chunk_sample_t;
+
+//returns a new block of exactly ATSC3_ISOBMFF_CMAF_CHUNK_OVERHEAD + sample_size bytes, i_pos at the end
+block_t* atsc3_isobmff_cmaf_chunk_build(uint32_t sequence_number, atsc3_isobmff_cmaf_chunk_sample_t* atsc3_isobmff_cmaf_chunk_sample, uint8_t* sample, uint32_t sample_size);
+
+//length of the leading top level boxes before the first moof, 0 if there is no moov
+uint32_t atsc3_isobmff_cmaf_init_box_length(uint8_t* buf, uint32_t len);
+
+//finds the first moov/trak with mdia/hdlr handler_type, returns false if not present
+bool atsc3_isobmff_cmaf_init_find_track(uint8_t* init_box, uint32_t init_box_len, uint32_t handler_type, uint32_t* track_id, uint32_t* timescale);
+
+#if defined (__cplusplus)
+}
+#endif
+
+#define __ISOBMFF_CMAF_CHUNK_WARN(...)    __ATSC3_LOG_WARN(ATSC3_LOG_MODULE_ISOBMFF_CMAF_CHUNK, __VA_ARGS__)
+
+#endif /* ATSC3_ISOBMFF_CMAF_CHUNK_H_ */
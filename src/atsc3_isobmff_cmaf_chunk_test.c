@@ -0,0 +1,166 @@
+/*
+ *
+ * atsc3_isobmff_cmaf_chunk_test.c:  driver for the MFU chunk moof/mdat writer and the ftyp/moov track lookup
+ *
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "atsc3_isobmff_cmaf_chunk.h"
+
+int test_cmaf_chunk_build();
+int test_cmaf_init_find_track();
+
+int main() {
+	int failed = 0;
+
+	failed += test_cmaf_chunk_build();
+	failed += test_cmaf_init_find_track();
+
+	printf("atsc3_isobmff_cmaf_chunk_test: %s\n", failed ? "FAILED" : "OK");
+	return failed;
+}
+
+static uint32_t __read_u32(uint8_t* p) {
+	return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 8) | (uint32_t)p[3];
+}
+
+static uint8_t* __write_u32(uint8_t* p, uint32_t v) {
+	p[0] = v >> 24;
+	p[1] = v >> 16;
+	p[2] = v >> 8;
+	p[3] = v;
+	return p + 4;
+}
+
+static uint8_t* __write_box(uint8_t* p, uint32_t size, const char* type) {
+	p = __write_u32(p, size);
+	memcpy(p, type, 4);
+	return p + 4;
+}
+
+int test_cmaf_chunk_build() {
+	uint8_t sample[333];
+	for(int i = 0; i < sizeof(sample); i++) {
+		sample[i] = i;
+	}
+
+	atsc3_isobmff_cmaf_chunk_sample_t atsc3_isobmff_cmaf_chunk_sample = { 2, 0x123456789ULL, 1001, ATSC3_ISOBMFF_SAMPLE_FLAGS_NON_SYNC, 2002 };
+	block_t* chunk = atsc3_isobmff_cmaf_chunk_build(7, &atsc3_isobmff_cmaf_chunk_sample, sample, sizeof(sample));
+	uint8_t* p = chunk->p_buffer;
+
+	if(chunk->i_pos != ATSC3_ISOBMFF_CMAF_CHUNK_OVERHEAD + sizeof(sample)) {
+		printf("test_cmaf_chunk_build: chunk size: %u\n", chunk->i_pos);
+		return 1;
+	}
+	if(__read_u32(&p[0]) != ATSC3_ISOBMFF_CMAF_CHUNK_MOOF_SIZE || memcmp(&p[4], "moof", 4) ||
+			__read_u32(&p[8]) != 16 || memcmp(&p[12], "mfhd", 4) || __read_u32(&p[20]) != 7 ||
+			__read_u32(&p[24]) != 80 || memcmp(&p[28], "traf", 4)) {
+		printf("test_cmaf_chunk_build: bad moof/mfhd/traf\n");
+		return 1;
+	}
+	if(memcmp(&p[36], "tfhd", 4) || __read_u32(&p[44]) != 2 ||
+			memcmp(&p[52], "tfdt", 4) || p[56] != 1 || __read_u32(&p[60]) != 0x1 || __read_u32(&p[64]) != 0x23456789) {
+		printf("test_cmaf_chunk_build: bad tfhd/tfdt\n");
+		return 1;
+	}
+	if(memcmp(&p[72], "trun", 4) || __read_u32(&p[80]) != 1 || __read_u32(&p[84]) != ATSC3_ISOBMFF_CMAF_CHUNK_OVERHEAD ||
+			__read_u32(&p[88]) != 1001 || __read_u32(&p[92]) != sizeof(sample) || __read_u32(&p[96]) != ATSC3_ISOBMFF_SAMPLE_FLAGS_NON_SYNC || __read_u32(&p[100]) != 2002) {
+		printf("test_cmaf_chunk_build: bad trun\n");
+		return 1;
+	}
+	if(__read_u32(&p[104]) != 8 + sizeof(sample) || memcmp(&p[108], "mdat", 4) || memcmp(&p[112], sample, sizeof(sample))) {
+		printf("test_cmaf_chunk_build: bad mdat\n");
+		return 1;
+	}
+
+	block_Release(&chunk);
+	return 0;
+}
+
+//ftyp + moov{ trak{ tkhd, mdia{ mdhd, hdlr } } x 2 } + moof
+static uint32_t __build_init_box(uint8_t* buf) {
+	uint8_t* p = buf;
+
+	p = __write_box(p, 16, "ftyp");
+	p = __write_u32(p, 0x69736f36);
+	p = __write_u32(p, 0);
+
+	uint8_t* moov = p;
+	p = __write_box(p, 0, "moov");
+
+	for(uint32_t track = 1; track <= 2; track++) {
+		//trak 2 uses v1 tkhd/mdhd
+		uint8_t version = track == 2;
+		uint32_t tkhd_len = version ? 104 : 92;
+		uint32_t mdhd_len = version ? 44 : 32;
+		uint32_t hdlr_len = 33;
+		uint32_t mdia_len = 8 + mdhd_len + hdlr_len;
+
+		p = __write_box(p, 8 + tkhd_len + mdia_len, "trak");
+
+		uint8_t* tkhd = p;
+		memset(tkhd, 0, tkhd_len);
+		p = __write_box(p, tkhd_len, "tkhd");
+		p[0] = version;
+		__write_u32(&p[version ? 20 : 12], track == 1 ? 1 : 3);
+		p = tkhd + tkhd_len;
+
+		p = __write_box(p, mdia_len, "mdia");
+		uint8_t* mdhd = p;
+		memset(mdhd, 0, mdhd_len);
+		p = __write_box(p, mdhd_len, "mdhd");
+		p[0] = version;
+		__write_u32(&p[version ? 20 : 12], track == 1 ? 90000 : 48000);
+		p = mdhd + mdhd_len;
+
+		uint8_t* hdlr = p;
+		memset(hdlr, 0, hdlr_len);
+		p = __write_box(p, hdlr_len, "hdlr");
+		memcpy(&p[8], track == 1 ? "vide" : "soun", 4);
+		p = hdlr + hdlr_len;
+	}
+	__write_u32(moov, p - moov);
+
+	p = __write_box(p, 8, "moof");
+	return p - buf;
+}
+
+int test_cmaf_init_find_track() {
+	uint8_t buf[1024];
+	uint32_t len = __build_init_box(buf);
+	uint32_t track_id = 0;
+	uint32_t timescale = 0;
+
+	uint32_t init_box_len = atsc3_isobmff_cmaf_init_box_length(buf, len);
+	if(init_box_len != len - 8) {
+		printf("test_cmaf_init_find_track: init_box_len: %u, expected: %u\n", init_box_len, len - 8);
+		return 1;
+	}
+	if(atsc3_isobmff_cmaf_init_box_length(buf, 16)) {
+		printf("test_cmaf_init_find_track: ftyp only should not be an init box\n");
+		return 1;
+	}
+
+	if(!atsc3_isobmff_cmaf_init_find_track(buf, init_box_len, ATSC3_ISOBMFF_HANDLER_VIDE, &track_id, &timescale) || track_id != 1 || timescale != 90000) {
+		printf("test_cmaf_init_find_track: vide track_id: %u, timescale: %u\n", track_id, timescale);
+		return 1;
+	}
+	if(!atsc3_isobmff_cmaf_init_find_track(buf, init_box_len, ATSC3_ISOBMFF_HANDLER_SOUN, &track_id, &timescale) || track_id != 3 || timescale != 48000) {
+		printf("test_cmaf_init_find_track: soun track_id: %u, timescale: %u\n", track_id, timescale);
+		return 1;
+	}
+	if(atsc3_isobmff_cmaf_init_find_track(buf, init_box_len, 0x74657874, &track_id, &timescale)) {
+		printf("test_cmaf_init_find_track: unexpected text track\n");
+		return 1;
+	}
+
+	//truncated moov
+	if(atsc3_isobmff_cmaf_init_find_track(buf, init_box_len - 20, ATSC3_ISOBMFF_HANDLER_SOUN, &track_id, &timescale)) {
+		printf("test_cmaf_init_find_track: found track in truncated moov\n");
+		return 1;
+	}
+
+	return 0;
+}
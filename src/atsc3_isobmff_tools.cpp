@@ -70,17 +70,16 @@ lls_sls_monitor_output_buffer_t* atsc3_isobmff_build_mpu_metadata_ftyp_moof_mdat
 
 	block_t* mpu_metadata_output_block_t = NULL;
 
-	udp_flow_latest_mpu_sequence_number_container_t* udp_flow_matching_flows = udp_flow_find_matching_flows(udp_flow_latest_mpu_sequence_number_container, udp_flow);
-
-	if(!udp_flow_latest_mpu_sequence_number_container || !udp_flow_latest_mpu_sequence_number_container->udp_flows_n) {
+	if(!udp_flow_latest_mpu_sequence_number_container || !udp_flow_latest_mpu_sequence_number_first_from_udp_flow(udp_flow_latest_mpu_sequence_number_container, udp_flow)) {
 		__ISOBMFF_TOOLS_ERROR("atsc3_isobmff_build_mpu_metadata_ftyp_box: Unable to find flows for MPU metadata creation from %u:%u", udp_flow->dst_ip_addr, udp_flow->dst_port);
 	}
 
     //build out ftyp/moov init box
 	__ISOBMFF_TOOLS_TRACE("atsc3_isobmff_build_mpu_metadata_ftyp_box: Starting to create MPU Metadata init box from flow: %u:%u", udp_flow->dst_ip_addr, udp_flow->dst_port);
 
-	for(int i=0; i < udp_flow_latest_mpu_sequence_number_container->udp_flows_n; i++) {
-		udp_flow_packet_id_mpu_sequence_tuple_t* udp_flow_packet_id_mpu_sequence_tuple = udp_flow_latest_mpu_sequence_number_container->udp_flows[i];
+	for(udp_flow_packet_id_mpu_sequence_tuple_t* udp_flow_packet_id_mpu_sequence_tuple = udp_flow_latest_mpu_sequence_number_first_from_udp_flow(udp_flow_latest_mpu_sequence_number_container, udp_flow);
+			udp_flow_packet_id_mpu_sequence_tuple;
+			udp_flow_packet_id_mpu_sequence_tuple = udp_flow_latest_mpu_sequence_number_next_from_udp_flow(udp_flow_packet_id_mpu_sequence_tuple, udp_flow)) {
 		bool found_mpu_metadata_fragment = false;
 
 		__ISOBMFF_TOOLS_DEBUG("atsc3_isobmff_build_mpu_metadata_ftyp_box: Searching for MPU Metadata with %u:%u and packet_id: %u", udp_flow->dst_ip_addr, udp_flow->dst_port, udp_flow_packet_id_mpu_sequence_tuple->packet_id);
@@ -147,9 +146,10 @@ lls_sls_monitor_output_buffer_t* atsc3_isobmff_build_mpu_metadata_ftyp_moof_mdat
 		return NULL;
 	}
     
-	for(int i=0; i < udp_flow_latest_mpu_sequence_number_container->udp_flows_n; i++) {
+	for(udp_flow_packet_id_mpu_sequence_tuple_t* udp_flow_packet_id_mpu_sequence_tuple = udp_flow_latest_mpu_sequence_number_first_from_udp_flow(udp_flow_latest_mpu_sequence_number_container, udp_flow);
+			udp_flow_packet_id_mpu_sequence_tuple;
+			udp_flow_packet_id_mpu_sequence_tuple = udp_flow_latest_mpu_sequence_number_next_from_udp_flow(udp_flow_packet_id_mpu_sequence_tuple, udp_flow)) {
         
-		udp_flow_packet_id_mpu_sequence_tuple_t* udp_flow_packet_id_mpu_sequence_tuple = udp_flow_latest_mpu_sequence_number_container->udp_flows[i];
 
         //remember, subflows are built in case of DU fragmentation - korean MMT samples have this edge case
 		mmtp_sub_flow = mmtp_sub_flow_vector_find_packet_id(mmtp_sub_flow_vector, udp_flow_packet_id_mpu_sequence_tuple->packet_id);
@@ -180,8 +180,9 @@ lls_sls_monitor_output_buffer_t* atsc3_isobmff_build_mpu_metadata_ftyp_moof_mdat
         }
     }
    
-	 for(int i=0; i < udp_flow_latest_mpu_sequence_number_container->udp_flows_n; i++) {
-		udp_flow_packet_id_mpu_sequence_tuple_t* udp_flow_packet_id_mpu_sequence_tuple = udp_flow_latest_mpu_sequence_number_container->udp_flows[i];
+	 for(udp_flow_packet_id_mpu_sequence_tuple_t* udp_flow_packet_id_mpu_sequence_tuple = udp_flow_latest_mpu_sequence_number_first_from_udp_flow(udp_flow_latest_mpu_sequence_number_container, udp_flow);
+	 		udp_flow_packet_id_mpu_sequence_tuple;
+	 		udp_flow_packet_id_mpu_sequence_tuple = udp_flow_latest_mpu_sequence_number_next_from_udp_flow(udp_flow_packet_id_mpu_sequence_tuple, udp_flow)) {
 
 		mmtp_sub_flow = mmtp_sub_flow_vector_find_packet_id(mmtp_sub_flow_vector, udp_flow_packet_id_mpu_sequence_tuple->packet_id);
 
@@ -235,9 +236,7 @@ lls_sls_monitor_output_buffer_t* atsc3_isobmff_build_mpu_metadata_ftyp_moof_mdat
     
     block_t* mpu_metadata_output_block_t = NULL;
     
-    udp_flow_latest_mpu_sequence_number_container_t* udp_flow_matching_flows = udp_flow_find_matching_flows(udp_flow_latest_mpu_sequence_number_container, udp_flow);
-    
-    if(!udp_flow_latest_mpu_sequence_number_container || !udp_flow_latest_mpu_sequence_number_container->udp_flows_n) {
+    if(!udp_flow_latest_mpu_sequence_number_container || !udp_flow_latest_mpu_sequence_number_first_from_udp_flow(udp_flow_latest_mpu_sequence_number_container, udp_flow)) {
         __ISOBMFF_TOOLS_ERROR("atsc3_isobmff_build_mpu_metadata_ftyp_box: Unable to find flows for MPU metadata creation from %u:%u", udp_flow->dst_ip_addr, udp_flow->dst_port);
     }
     
@@ -247,8 +246,9 @@ lls_sls_monitor_output_buffer_t* atsc3_isobmff_build_mpu_metadata_ftyp_moof_mdat
 						 mpu_sequence_number_audio,
 						 mpu_sequence_number_video);
 
-	for(int i=0; i < udp_flow_latest_mpu_sequence_number_container->udp_flows_n; i++) {
-		udp_flow_packet_id_mpu_sequence_tuple_t* udp_flow_packet_id_mpu_sequence_tuple = udp_flow_latest_mpu_sequence_number_container->udp_flows[i];
+	for(udp_flow_packet_id_mpu_sequence_tuple_t* udp_flow_packet_id_mpu_sequence_tuple = udp_flow_latest_mpu_sequence_number_first_from_udp_flow(udp_flow_latest_mpu_sequence_number_container, udp_flow);
+			udp_flow_packet_id_mpu_sequence_tuple;
+			udp_flow_packet_id_mpu_sequence_tuple = udp_flow_latest_mpu_sequence_number_next_from_udp_flow(udp_flow_packet_id_mpu_sequence_tuple, udp_flow)) {
 		bool found_mpu_metadata_fragment = false;
 
 		__ISOBMFF_TOOLS_DEBUG("atsc3_isobmff_build_mpu_metadata_ftyp_box: Searching for MPU Metadata with %u:%u and packet_id: %u", udp_flow->dst_ip_addr, udp_flow->dst_port, udp_flow_packet_id_mpu_sequence_tuple->packet_id);
@@ -321,9 +321,10 @@ lls_sls_monitor_output_buffer_t* atsc3_isobmff_build_mpu_metadata_ftyp_moof_mdat
 	}
 
     
-    for(int i=0; i < udp_flow_latest_mpu_sequence_number_container->udp_flows_n; i++) {
+    for(udp_flow_packet_id_mpu_sequence_tuple_t* udp_flow_packet_id_mpu_sequence_tuple = udp_flow_latest_mpu_sequence_number_first_from_udp_flow(udp_flow_latest_mpu_sequence_number_container, udp_flow);
+    		udp_flow_packet_id_mpu_sequence_tuple;
+    		udp_flow_packet_id_mpu_sequence_tuple = udp_flow_latest_mpu_sequence_number_next_from_udp_flow(udp_flow_packet_id_mpu_sequence_tuple, udp_flow)) {
         
-        udp_flow_packet_id_mpu_sequence_tuple_t* udp_flow_packet_id_mpu_sequence_tuple = udp_flow_latest_mpu_sequence_number_container->udp_flows[i];
         
         //remember, subflows are built in case of DU fragmentation - korean MMT samples have this edge case
         mmtp_sub_flow = mmtp_sub_flow_vector_find_packet_id(mmtp_sub_flow_vector, udp_flow_packet_id_mpu_sequence_tuple->packet_id);
@@ -378,8 +379,9 @@ lls_sls_monitor_output_buffer_t* atsc3_isobmff_build_mpu_metadata_ftyp_moof_mdat
     }
     
     
-    for(int i=0; i < udp_flow_latest_mpu_sequence_number_container->udp_flows_n; i++) {
-        udp_flow_packet_id_mpu_sequence_tuple_t* udp_flow_packet_id_mpu_sequence_tuple = udp_flow_latest_mpu_sequence_number_container->udp_flows[i];
+    for(udp_flow_packet_id_mpu_sequence_tuple_t* udp_flow_packet_id_mpu_sequence_tuple = udp_flow_latest_mpu_sequence_number_first_from_udp_flow(udp_flow_latest_mpu_sequence_number_container, udp_flow);
+    		udp_flow_packet_id_mpu_sequence_tuple;
+    		udp_flow_packet_id_mpu_sequence_tuple = udp_flow_latest_mpu_sequence_number_next_from_udp_flow(udp_flow_packet_id_mpu_sequence_tuple, udp_flow)) {
         
         mmtp_sub_flow = mmtp_sub_flow_vector_find_packet_id(mmtp_sub_flow_vector, udp_flow_packet_id_mpu_sequence_tuple->packet_id);
         
@@ -420,10 +422,11 @@ lls_sls_monitor_output_buffer_t* atsc3_isobmff_build_mpu_metadata_ftyp_moof_mdat
     lls_sls_monitor_output_buffer->audio_output_buffer_isobmff.mpu_presentation_time_set = false;
 	lls_sls_monitor_output_buffer->video_output_buffer_isobmff.mpu_presentation_time_set = false;
 
-    for(int f=0; f < udp_flow_latest_mpu_sequence_number_container->udp_flows_n; f++) {
-		__ISOBMFF_TOOLS_WARN("checking flow: %u", f);
+    for(udp_flow_packet_id_mpu_sequence_tuple_t* udp_flow_packet_id_mpu_sequence_tuple = udp_flow_latest_mpu_sequence_number_first_from_udp_flow(udp_flow_latest_mpu_sequence_number_container, udp_flow);
+    		udp_flow_packet_id_mpu_sequence_tuple;
+    		udp_flow_packet_id_mpu_sequence_tuple = udp_flow_latest_mpu_sequence_number_next_from_udp_flow(udp_flow_packet_id_mpu_sequence_tuple, udp_flow)) {
+		__ISOBMFF_TOOLS_WARN("checking flow: packet_id: %u", udp_flow_packet_id_mpu_sequence_tuple->packet_id);
 
-        udp_flow_packet_id_mpu_sequence_tuple_t* udp_flow_packet_id_mpu_sequence_tuple = udp_flow_latest_mpu_sequence_number_container->udp_flows[f];
 
         mmtp_sub_flow = mmtp_sub_flow_vector_find_packet_id(mmtp_sub_flow_vector, udp_flow_packet_id_mpu_sequence_tuple->packet_id);
 
@@ -0,0 +1,206 @@
+/*
+ * atsc3_latency_histogram.c
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: jjustman
+ */
+
+#include <string.h>
+
+#include "atsc3_latency_histogram.h"
+
+uint64_t atsc3_latency_histogram_arrival_ns = 0;
+
+//services are allocated once and never moved, so readers on other threads never see a realloc
+static atsc3_latency_histogram_service_t* atsc3_latency_histogram_services[ATSC3_LATENCY_HISTOGRAM_SERVICES_MAX];
+static uint32_t atsc3_latency_histogram_services_n = 0;
+
+static uint32_t atsc3_latency_histogram_bucket_index(uint64_t value_ns) {
+	if(value_ns < ATSC3_LATENCY_HISTOGRAM_SUB_BUCKETS) {
+		return (uint32_t)value_ns;
+	}
+
+	uint32_t msb = 63 - __builtin_clzll(value_ns);
+	uint32_t shift = msb - ATSC3_LATENCY_HISTOGRAM_SUB_BUCKET_BITS;
+	uint32_t sub_bucket = (uint32_t)(value_ns >> shift) - ATSC3_LATENCY_HISTOGRAM_SUB_BUCKETS;
+
+	return (msb - ATSC3_LATENCY_HISTOGRAM_SUB_BUCKET_BITS + 1) * ATSC3_LATENCY_HISTOGRAM_SUB_BUCKETS + sub_bucket;
+}
+
+static uint64_t atsc3_latency_histogram_bucket_upper_bound(uint32_t index) {
+	if(index < ATSC3_LATENCY_HISTOGRAM_SUB_BUCKETS) {
+		return index;
+	}
+
+	uint32_t msb = index / ATSC3_LATENCY_HISTOGRAM_SUB_BUCKETS + ATSC3_LATENCY_HISTOGRAM_SUB_BUCKET_BITS - 1;
+	uint32_t shift = msb - ATSC3_LATENCY_HISTOGRAM_SUB_BUCKET_BITS;
+	uint64_t lower = (uint64_t)(ATSC3_LATENCY_HISTOGRAM_SUB_BUCKETS + index % ATSC3_LATENCY_HISTOGRAM_SUB_BUCKETS) << shift;
+
+	return lower + ((1ULL << shift) - 1);
+}
+
+void atsc3_latency_histogram_add(atsc3_latency_histogram_t* atsc3_latency_histogram, uint64_t value_ns) {
+	atsc3_latency_histogram->buckets[atsc3_latency_histogram_bucket_index(value_ns)]++;
+
+	if(!atsc3_latency_histogram->count || value_ns < atsc3_latency_histogram->min_ns) {
+		atsc3_latency_histogram->min_ns = value_ns;
+	}
+	if(value_ns > atsc3_latency_histogram->max_ns) {
+		atsc3_latency_histogram->max_ns = value_ns;
+	}
+	atsc3_latency_histogram->total_ns += value_ns;
+	atsc3_latency_histogram->count++;
+}
+
+uint64_t atsc3_latency_histogram_percentile(atsc3_latency_histogram_t* atsc3_latency_histogram, double percentile) {
+	if(!atsc3_latency_histogram->count) {
+		return 0;
+	}
+
+	uint64_t target = (uint64_t)((percentile / 100.0) * atsc3_latency_histogram->count + 0.5);
+	if(target < 1) {
+		target = 1;
+	}
+
+	uint64_t cumulative = 0;
+	for(uint32_t i = 0; i < ATSC3_LATENCY_HISTOGRAM_BUCKETS; i++) {
+		cumulative += atsc3_latency_histogram->buckets[i];
+		if(cumulative >= target) {
+			uint64_t upper_bound = atsc3_latency_histogram_bucket_upper_bound(i);
+			return upper_bound < atsc3_latency_histogram->max_ns ? upper_bound : atsc3_latency_histogram->max_ns;
+		}
+	}
+
+	return atsc3_latency_histogram->max_ns;
+}
+
+void atsc3_latency_histogram_mark_arrival() {
+	atsc3_latency_histogram_arrival_ns = atsc3_latency_histogram_monotonic_ns();
+}
+
+atsc3_latency_histogram_service_t* atsc3_latency_histogram_service_find(uint16_t service_id) {
+	for(uint32_t i = 0; i < atsc3_latency_histogram_services_n; i++) {
+		if(atsc3_latency_histogram_services[i]->service_id == service_id) {
+			return atsc3_latency_histogram_services[i];
+		}
+	}
+	return NULL;
+}
+
+void atsc3_latency_histogram_record(uint16_t service_id, atsc3_latency_stage_id_t stage_id) {
+	atsc3_latency_histogram_record_since(service_id, stage_id, atsc3_latency_histogram_arrival_ns);
+}
+
+void atsc3_latency_histogram_record_since(uint16_t service_id, atsc3_latency_stage_id_t stage_id, uint64_t since_ns) {
+	if(!since_ns) {
+		return;
+	}
+
+	atsc3_latency_histogram_service_t* atsc3_latency_histogram_service = atsc3_latency_histogram_service_find(service_id);
+	if(!atsc3_latency_histogram_service) {
+		if(atsc3_latency_histogram_services_n == ATSC3_LATENCY_HISTOGRAM_SERVICES_MAX) {
+			return;
+		}
+		atsc3_latency_histogram_service = (atsc3_latency_histogram_service_t*)calloc(1, sizeof(atsc3_latency_histogram_service_t));
+		if(!atsc3_latency_histogram_service) {
+			__LATENCY_HISTOGRAM_ERROR("unable to allocate latency histograms for service_id: %u", service_id);
+			return;
+		}
+		atsc3_latency_histogram_service->service_id = service_id;
+		atsc3_latency_histogram_services[atsc3_latency_histogram_services_n] = atsc3_latency_histogram_service;
+		__sync_synchronize();
+		atsc3_latency_histogram_services_n++;
+	}
+
+	atsc3_latency_histogram_add(&atsc3_latency_histogram_service->stages[stage_id], atsc3_latency_histogram_monotonic_ns() - since_ns);
+}
+
+atsc3_latency_histogram_service_t* atsc3_latency_histogram_service_get(uint32_t index) {
+	return index < atsc3_latency_histogram_services_n ? atsc3_latency_histogram_services[index] : NULL;
+}
+
+uint32_t atsc3_latency_histogram_service_count() {
+	return atsc3_latency_histogram_services_n;
+}
+
+void atsc3_latency_histogram_reset() {
+	for(uint32_t i = 0; i < atsc3_latency_histogram_services_n; i++) {
+		uint16_t service_id = atsc3_latency_histogram_services[i]->service_id;
+		memset(atsc3_latency_histogram_services[i], 0, sizeof(atsc3_latency_histogram_service_t));
+		atsc3_latency_histogram_services[i]->service_id = service_id;
+	}
+}
+
+const char* atsc3_latency_histogram_stage_name(atsc3_latency_stage_id_t stage_id) {
+	switch(stage_id) {
+		case ATSC3_LATENCY_STAGE_PARSE:
+			return "parse";
+		case ATSC3_LATENCY_STAGE_MPU_OBJECT_COMPLETE:
+			return "mpu/object complete";
+		case ATSC3_LATENCY_STAGE_ISOBMFF_JOIN:
+			return "isobmff join";
+		case ATSC3_LATENCY_STAGE_SINK_ENQUEUE:
+			return "sink enqueue";
+		case ATSC3_LATENCY_STAGE_MPU_SAMPLE_TO_SINK:
+			return "sample to sink: mpu";
+		case ATSC3_LATENCY_STAGE_MFU_SAMPLE_TO_SINK:
+			return "sample to sink: mfu";
+		default:
+			return "unknown";
+	}
+}
+
+int atsc3_latency_histogram_snprintf(char* buf, size_t buf_len) {
+#ifndef __LATENCY_HISTOGRAM_ENABLED
+	return snprintf(buf, buf_len, "latency histograms disabled, rebuild with -D__LATENCY_HISTOGRAM_ENABLED\n");
+#else
+	size_t pos = 0;
+	int ret = snprintf(buf, buf_len, "%-10s %-20s %10s %10s %10s %10s %10s %10s %10s (usec since packet arrival)\n",
+			"service_id", "stage", "count", "min", "p50", "p90", "p99", "p99.9", "max");
+	if(ret < 0 || (size_t)ret >= buf_len) {
+		return ret;
+	}
+	pos += ret;
+
+	for(uint32_t i = 0; i < atsc3_latency_histogram_service_count(); i++) {
+		atsc3_latency_histogram_service_t* atsc3_latency_histogram_service = atsc3_latency_histogram_service_get(i);
+
+		for(int stage_id = 0; stage_id < ATSC3_LATENCY_STAGE_MAX; stage_id++) {
+			atsc3_latency_histogram_t* atsc3_latency_histogram = &atsc3_latency_histogram_service->stages[stage_id];
+			if(!atsc3_latency_histogram->count) {
+				continue;
+			}
+
+			ret = snprintf(buf + pos, buf_len - pos, "%-10u %-20s %10llu %10.1f %10.1f %10.1f %10.1f %10.1f %10.1f\n",
+					atsc3_latency_histogram_service->service_id,
+					atsc3_latency_histogram_stage_name((atsc3_latency_stage_id_t)stage_id),
+					(unsigned long long)atsc3_latency_histogram->count,
+					atsc3_latency_histogram->min_ns / 1000.0,
+					atsc3_latency_histogram_percentile(atsc3_latency_histogram, 50.0) / 1000.0,
+					atsc3_latency_histogram_percentile(atsc3_latency_histogram, 90.0) / 1000.0,
+					atsc3_latency_histogram_percentile(atsc3_latency_histogram, 99.0) / 1000.0,
+					atsc3_latency_histogram_percentile(atsc3_latency_histogram, 99.9) / 1000.0,
+					atsc3_latency_histogram->max_ns / 1000.0);
+
+			if(ret < 0 || (size_t)ret >= buf_len - pos) {
+				return pos;
+			}
+			pos += ret;
+		}
+	}
+
+	return pos;
+#endif
+}
+
+void atsc3_latency_histogram_dump(FILE* fp) {
+	size_t buf_len = 256 + atsc3_latency_histogram_service_count() * ATSC3_LATENCY_STAGE_MAX * 128;
+	char* buf = (char*)calloc(buf_len, sizeof(char));
+	if(!buf) {
+		return;
+	}
+
+	atsc3_latency_histogram_snprintf(buf, buf_len);
+	fputs(buf, fp);
+	free(buf);
+}
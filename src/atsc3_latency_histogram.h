@@ -0,0 +1,120 @@
+/*
+ * atsc3_latency_histogram.h
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: jjustman
+ *
+ * per-service latency histograms from packet arrival to fragment emission
+ *
+ * each stage records the elapsed time since the arrival of the packet that is currently being processed,
+ * i.e. the packet that completed the parse, MPU/object, ISOBMFF join or sink enqueue:
+ *
+ * 	ATSC3_LATENCY_STAGE_PARSE:					mmtp_packet_parse / alc_rx_analyze_packet_a331_compliant returned
+ * 	ATSC3_LATENCY_STAGE_MPU_OBJECT_COMPLETE:	MMT mpu_sequence_number rolled over / ALC close_object_flag
+ * 	ATSC3_LATENCY_STAGE_ISOBMFF_JOIN:			joined ftyp/moov/moof/mdat fragment built
+ * 	ATSC3_LATENCY_STAGE_SINK_ENQUEUE:			fragment pushed to pipe_buffer_unsafe_push_block or the http output buffer
+ *
+ * the sample to sink stages compare the MMT output modes and are measured from the arrival of the first packet of the
+ * oldest sample in the emitted output instead, i.e. how long a sample waited on the receiver before it was handed to the sink:
+ *
+ * 	ATSC3_LATENCY_STAGE_MPU_SAMPLE_TO_SINK:		joined MPU fragment enqueued (default mode)
+ * 	ATSC3_LATENCY_STAGE_MFU_SAMPLE_TO_SINK:		single sample CMAF chunk enqueued (mfu_chunk_output_enabled)
+ *
+ * buckets are log-linear (hdr style): values < 16ns are exact, otherwise each power of two is split into
+ * 16 linear sub-buckets, giving ~6% relative precision over the full uint64_t ns range in a fixed 7.8KB per stage
+ *
+ * instrumentation is compiled in only with -D__LATENCY_HISTOGRAM_ENABLED (see LATENCY_HISTOGRAM_FLAGS in the makefile),
+ * otherwise the __LATENCY_HISTOGRAM_* macros expand to nothing and the hot path is untouched
+ *
+ * recording is expected from the single pcap ingest thread, the dump functions may be called from the
+ * ncurses or httpd threads and read the counters without locking, same as global_stats
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <time.h>
+
+#ifndef ATSC3_LATENCY_HISTOGRAM_H_
+#define ATSC3_LATENCY_HISTOGRAM_H_
+
+#if defined (__cplusplus)
+extern "C" {
+#endif
+
+typedef enum {
+	ATSC3_LATENCY_STAGE_PARSE = 0,
+	ATSC3_LATENCY_STAGE_MPU_OBJECT_COMPLETE,
+	ATSC3_LATENCY_STAGE_ISOBMFF_JOIN,
+	ATSC3_LATENCY_STAGE_SINK_ENQUEUE,
+	ATSC3_LATENCY_STAGE_MPU_SAMPLE_TO_SINK,
+	ATSC3_LATENCY_STAGE_MFU_SAMPLE_TO_SINK,
+	ATSC3_LATENCY_STAGE_MAX
+} atsc3_latency_stage_id_t;
+
+#define ATSC3_LATENCY_HISTOGRAM_SUB_BUCKET_BITS		4
+#define ATSC3_LATENCY_HISTOGRAM_SUB_BUCKETS			(1 << ATSC3_LATENCY_HISTOGRAM_SUB_BUCKET_BITS)
+#define ATSC3_LATENCY_HISTOGRAM_BUCKETS				((64 - ATSC3_LATENCY_HISTOGRAM_SUB_BUCKET_BITS + 1) * ATSC3_LATENCY_HISTOGRAM_SUB_BUCKETS)
+
+#define ATSC3_LATENCY_HISTOGRAM_SERVICES_MAX		32
+
+typedef struct atsc3_latency_histogram {
+	uint64_t	count;
+	uint64_t	total_ns;
+	uint64_t	min_ns;
+	uint64_t	max_ns;
+	uint64_t	buckets[ATSC3_LATENCY_HISTOGRAM_BUCKETS];
+} atsc3_latency_histogram_t;
+
+typedef struct atsc3_latency_histogram_service {
+	uint16_t					service_id;
+	atsc3_latency_histogram_t	stages[ATSC3_LATENCY_STAGE_MAX];
+} atsc3_latency_histogram_service_t;
+
+//arrival timestamp of the packet currently in process_packet, 0 if not yet marked
+extern uint64_t atsc3_latency_histogram_arrival_ns;
+
+static inline uint64_t atsc3_latency_histogram_monotonic_ns() {
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+void atsc3_latency_histogram_add(atsc3_latency_histogram_t* atsc3_latency_histogram, uint64_t value_ns);
+//value at percentile (0.0 - 100.0), reported as the upper bound of the matching bucket, clamped to max_ns
+uint64_t atsc3_latency_histogram_percentile(atsc3_latency_histogram_t* atsc3_latency_histogram, double percentile);
+
+void atsc3_latency_histogram_mark_arrival();
+void atsc3_latency_histogram_record(uint16_t service_id, atsc3_latency_stage_id_t stage_id);
+//records the elapsed time since since_ns (an earlier atsc3_latency_histogram_arrival_ns), ignored if 0
+void atsc3_latency_histogram_record_since(uint16_t service_id, atsc3_latency_stage_id_t stage_id, uint64_t since_ns);
+
+atsc3_latency_histogram_service_t* atsc3_latency_histogram_service_find(uint16_t service_id);
+atsc3_latency_histogram_service_t* atsc3_latency_histogram_service_get(uint32_t index);
+uint32_t atsc3_latency_histogram_service_count();
+void atsc3_latency_histogram_reset();
+
+const char* atsc3_latency_histogram_stage_name(atsc3_latency_stage_id_t stage_id);
+
+//plain text summary, one line per service and stage: count, min, p50, p90, p99, p99.9, max in usec
+int atsc3_latency_histogram_snprintf(char* buf, size_t buf_len);
+void atsc3_latency_histogram_dump(FILE* fp);
+
+#if defined (__cplusplus)
+}
+#endif
+
+#ifdef __LATENCY_HISTOGRAM_ENABLED
+#define __LATENCY_HISTOGRAM_ARRIVAL() 						atsc3_latency_histogram_mark_arrival()
+#define __LATENCY_HISTOGRAM_RECORD(service_id, stage_id)	atsc3_latency_histogram_record(service_id, stage_id)
+#define __LATENCY_HISTOGRAM_RECORD_SINCE(service_id, stage_id, since_ns)	atsc3_latency_histogram_record_since(service_id, stage_id, since_ns)
+#else
+#define __LATENCY_HISTOGRAM_ARRIVAL()
+#define __LATENCY_HISTOGRAM_RECORD(service_id, stage_id)
+#define __LATENCY_HISTOGRAM_RECORD_SINCE(service_id, stage_id, since_ns)
+#endif
+
+#define __LATENCY_HISTOGRAM_ERROR(...)   printf("%s:%d:ERROR :",__FILE__,__LINE__);printf(__VA_ARGS__);printf("%s%s","\r","\n")
+
+#endif /* ATSC3_LATENCY_HISTOGRAM_H_ */
@@ -6,6 +6,7 @@
  */
 
 #include "atsc3_listener_udp.h"
+#include "atsc3_latency_histogram.h"
 
 udp_packet_t* process_packet_from_pcap(u_char *user, const struct pcap_pkthdr *pkthdr, const u_char *packet) {
 	int i = 0;
@@ -16,6 +17,8 @@ udp_packet_t* process_packet_from_pcap(u_char *user, const struct pcap_pkthdr *p
 	int udp_header_start = 34;
 	udp_packet_t* udp_packet = NULL;
 
+	__LATENCY_HISTOGRAM_ARRIVAL();
+
 	for (i = 0; i < 14; i++) {
 		ethernet_packet[i] = packet[0 + i];
 	}
@@ -52,6 +55,7 @@ udp_packet_t* process_packet_from_pcap(u_char *user, const struct pcap_pkthdr *p
 
 	udp_packet->raw_packet_length = pkthdr->len;
 	udp_packet->data_length = pkthdr->len - (udp_header_start + 8);
+	udp_packet->arrival_timeval = pkthdr->ts;
 
 	if(udp_packet->data_length <=0 || udp_packet->data_length > 1514) {
 		__LISTENER_UDP_ERROR("invalid data length of udp packet: %d", udp_packet->data_length);
@@ -187,6 +191,7 @@ udp_packet_t* udp_packet_duplicate(udp_packet_t* udp_packet) {
 		udp_packet_new->udp_flow.src_port	 = udp_packet->udp_flow.src_port;
 		udp_packet_new->udp_flow.dst_ip_addr = udp_packet->udp_flow.dst_ip_addr;
 		udp_packet_new->udp_flow.dst_port 	 = udp_packet->udp_flow.dst_port;
+		udp_packet_new->arrival_timeval		 = udp_packet->arrival_timeval;
 
 		return udp_packet_new;
 
@@ -236,6 +241,8 @@ udp_packet_t* udp_packet_prepend_if_not_null(udp_packet_t* from_packet, udp_pack
 	udp_packet_new->udp_flow.src_port	 = to_packet->udp_flow.src_port;
 	udp_packet_new->udp_flow.dst_ip_addr = to_packet->udp_flow.dst_ip_addr;
 	udp_packet_new->udp_flow.dst_port 	 = to_packet->udp_flow.dst_port;
+	//reassembled packets are complete when the last fragment arrives
+	udp_packet_new->arrival_timeval		 = to_packet->arrival_timeval;
 
 
 	return udp_packet_new;
@@ -41,6 +41,9 @@ typedef struct udp_packet {
 	//internals
 	int				raw_packet_length;
 
+	//capture time from the pcap header, zero when the packet was not received through process_packet_from_pcap
+	struct timeval	arrival_timeval;
+
 } udp_packet_t;
 
 #define udp_packet_get_remaining_bytes(udp_packet) (__MAX(0, udp_packet->data_length - udp_packet->data_position ))
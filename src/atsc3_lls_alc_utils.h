@@ -49,6 +49,7 @@ lls_sls_alc_session_t* lls_slt_alc_session_find_from_udp_packet(lls_slt_monitor_
 lls_sls_alc_session_t* lls_slt_alc_session_find_from_service_id(lls_slt_monitor_t* lls_slt_monitor, uint16_t service_id);
 
 void lls_slt_alc_session_remove(lls_sls_alc_session_vector_t* lls_slt_alc_session, lls_service_t* lls_service);
+void lls_sls_alc_session_vector_retired_free(lls_sls_alc_session_vector_t* lls_sls_alc_session_vector);
 
 
 lls_sls_alc_monitor_t* lls_monitor_sls_alc_session_create(lls_service_t* lls_service);
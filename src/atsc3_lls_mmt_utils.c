@@ -54,8 +54,39 @@ lls_sls_mmt_session_t* lls_slt_mmt_session_create(lls_service_t* lls_service) {
 	return lls_slt_mmt_session;
 }
 
-void lls_slt_mmt_session_remove(lls_sls_mmt_session_vector_t* lls_slt_mmt_session, lls_service_t* lls_service) {
-	//noop for now
+//unlinks the session from the vector, it is only freed by lls_sls_mmt_session_vector_retired_free as the flow dispatch table may still reference it
+void lls_slt_mmt_session_remove(lls_sls_mmt_session_vector_t* lls_sls_mmt_session_vector, lls_service_t* lls_service) {
+	lls_sls_mmt_session_t* lls_slt_mmt_session = lls_slt_mmt_session_find(lls_sls_mmt_session_vector, lls_service);
+	if(!lls_slt_mmt_session) {
+		return;
+	}
+
+	for(int i=0; i < lls_sls_mmt_session_vector->lls_slt_mmt_sessions_n; i++) {
+		if(lls_sls_mmt_session_vector->lls_slt_mmt_sessions[i] == lls_slt_mmt_session) {
+			memmove(&lls_sls_mmt_session_vector->lls_slt_mmt_sessions[i], &lls_sls_mmt_session_vector->lls_slt_mmt_sessions[i + 1],
+					(lls_sls_mmt_session_vector->lls_slt_mmt_sessions_n - i - 1) * sizeof(lls_sls_mmt_session_t*));
+			lls_sls_mmt_session_vector->lls_slt_mmt_sessions_n--;
+			break;
+		}
+	}
+
+	lls_sls_mmt_session_vector->lls_slt_mmt_sessions_retired = (lls_sls_mmt_session_t**)realloc(lls_sls_mmt_session_vector->lls_slt_mmt_sessions_retired, (lls_sls_mmt_session_vector->lls_slt_mmt_sessions_retired_n + 1) * sizeof(lls_sls_mmt_session_t*));
+	if(!lls_sls_mmt_session_vector->lls_slt_mmt_sessions_retired) {
+		abort();
+	}
+	lls_sls_mmt_session_vector->lls_slt_mmt_sessions_retired[lls_sls_mmt_session_vector->lls_slt_mmt_sessions_retired_n++] = lls_slt_mmt_session;
+
+	__LLSU_MMT_TRACE("removed service_id: %u, dest: %u.%u.%u.%u:%u, remaining: %d", lls_slt_mmt_session->service_id,
+			__toipandportnonstruct(lls_slt_mmt_session->sls_destination_ip_address, lls_slt_mmt_session->sls_destination_udp_port), lls_sls_mmt_session_vector->lls_slt_mmt_sessions_n);
+}
+
+void lls_sls_mmt_session_vector_retired_free(lls_sls_mmt_session_vector_t* lls_sls_mmt_session_vector) {
+	for(int i=0; i < lls_sls_mmt_session_vector->lls_slt_mmt_sessions_retired_n; i++) {
+		lls_sls_mmt_session_free(&lls_sls_mmt_session_vector->lls_slt_mmt_sessions_retired[i]);
+	}
+	freesafe(lls_sls_mmt_session_vector->lls_slt_mmt_sessions_retired);
+	lls_sls_mmt_session_vector->lls_slt_mmt_sessions_retired = NULL;
+	lls_sls_mmt_session_vector->lls_slt_mmt_sessions_retired_n = 0;
 }
 
 
@@ -187,7 +218,8 @@ lls_sls_mmt_session_t* lls_slt_mmt_session_find_or_create(lls_sls_mmt_session_ve
 void lls_sls_mmt_session_free(lls_sls_mmt_session_t** lls_sls_mmt_session_ptr) {
     lls_sls_mmt_session_t* lls_sls_mmt_session = *lls_sls_mmt_session_ptr;
     if(lls_sls_mmt_session) {
-        
+        freesafe(lls_sls_mmt_session->mmt_arguments);
+
         free(lls_sls_mmt_session);
     }
     *lls_sls_mmt_session_ptr = NULL;
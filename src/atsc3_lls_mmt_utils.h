@@ -34,6 +34,7 @@ lls_sls_mmt_session_t* lls_slt_mmt_session_find_from_udp_packet(lls_slt_monitor_
 lls_sls_mmt_session_t* lls_slt_mmt_session_find_from_service_id(lls_slt_monitor_t* lls_slt_monitor, uint16_t service_id);
 
 void lls_slt_mmt_session_remove(lls_sls_mmt_session_vector_t* lls_slt_mmt_session, lls_service_t* lls_service);
+void lls_sls_mmt_session_vector_retired_free(lls_sls_mmt_session_vector_t* lls_sls_mmt_session_vector);
 
 
 lls_sls_mmt_monitor_t* lls_monitor_sls_mmt_session_create(lls_service_t* lls_service);
@@ -24,6 +24,49 @@
 #define _LLS_SLS_MONITOR_OUTPUT_MAX_FRAGMENT_BUFFER 16384000
 
 
+/**
+ * low-latency MFU output mode state for one track
+ *
+ * the data units of each sample are assembled as they arrive and the completed sample is emitted on its own as a
+ * single sample CMAF chunk instead of waiting for the mpu_sequence_number rollover. samples that lose a data unit
+ * are dropped, the next chunk's decode time skips over them.
+ *
+ * the decode time is the MPT mpu_presentation_time of the sample's MPU (in mdhd timescale) plus the durations of the
+ * preceding samples, durations/flags/composition offsets are taken from the last parsed trun as the moof of the
+ * current movie fragment is only delivered after its samples.
+ */
+#define LLS_SLS_MONITOR_MFU_CHUNK_MPU_PRESENTATION_TIME_MAX 4
+
+typedef struct lls_sls_monitor_buffer_isobmff_mfu_chunk {
+	//resolved from the joined init box, no chunks are built until track_id is set
+	uint32_t	track_id;
+	uint32_t	timescale;
+	bool		is_audio;
+
+	//sample being assembled
+	bool		sample_in_progress;
+	uint32_t	mpu_sequence_number;
+	uint32_t	sample_number;
+	uint32_t	last_packet_sequence_number;
+	uint64_t	sample_first_arrival_ns;
+	block_t*	sample_block;
+
+	//last emitted sample
+	bool		has_emitted_sample;
+	uint32_t	last_mpu_sequence_number;
+	uint32_t	last_sample_number;
+	uint64_t	last_base_media_decode_time;
+	uint32_t	last_sample_duration;
+
+	//mpu_timestamp_descriptor entries from the MPT, ring buffer
+	uint32_t	mpu_presentation_time_sequence_number[LLS_SLS_MONITOR_MFU_CHUNK_MPU_PRESENTATION_TIME_MAX];
+	uint64_t	mpu_presentation_time[LLS_SLS_MONITOR_MFU_CHUNK_MPU_PRESENTATION_TIME_MAX];
+	uint32_t	mpu_presentation_time_next;
+
+	uint32_t	chunks_emitted;
+	uint32_t	samples_dropped;
+} lls_sls_monitor_buffer_isobmff_mfu_chunk_t;
+
 typedef struct lls_sls_monitor_buffer_isobmff {
 	uint32_t track_id;
 
@@ -60,6 +103,11 @@ typedef struct lls_sls_monitor_buffer_isobmff {
 
     uint32_t last_fragment_lost_mfu_count;
 
+    //earliest data unit arrival copied into fragment_box since the last reset, for latency accounting
+    uint64_t fragment_first_arrival_ns;
+
+    lls_sls_monitor_buffer_isobmff_mfu_chunk_t mfu_chunk;
+
 } lls_sls_monitor_buffer_isobmff_t;
 
 typedef struct lls_sls_monitor_buffer {
@@ -71,6 +119,11 @@ typedef struct lls_sls_monitor_buffer {
 
     block_t* joined_isobmff_block;
 
+    //low-latency MFU mode: ftyp + moov of the first joined fragment, written once ahead of the first chunk
+    block_t* mfu_chunk_init_block;
+    bool has_written_mfu_chunk_init_box;
+    uint32_t mfu_chunk_sequence_number;
+
 } lls_sls_monitor_output_buffer_t;
 
 //TODO: refactor me
@@ -93,6 +146,8 @@ typedef struct lls_sls_monitor_buffer_mode {
     bool 	file_dump_enabled;
     bool 	ffplay_output_enabled;
     bool 	http_output_enabled;
+    //emit each completed MFU sample as a CMAF chunk instead of one joined fragment per MPU
+    bool	mfu_chunk_output_enabled;
     struct	pipe_ffplay_buffer* pipe_ffplay_buffer; //needed for circular deps
     http_output_buffer_t* http_output_buffer;
 
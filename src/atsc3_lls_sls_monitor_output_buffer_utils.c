@@ -146,6 +146,7 @@ void lls_sls_monitor_output_buffer_reset_moof_and_fragment_position(lls_sls_moni
 	lls_sls_monitor_output_buffer->audio_output_buffer_isobmff.fragment_pos = 0;
 	lls_sls_monitor_output_buffer->audio_output_buffer_isobmff.last_fragment = NULL;
 	lls_sls_monitor_output_buffer->audio_output_buffer_isobmff.last_fragment_lost_mfu_count = 0;
+	lls_sls_monitor_output_buffer->audio_output_buffer_isobmff.fragment_first_arrival_ns = 0;
 
 	lls_sls_monitor_output_buffer->video_output_buffer_isobmff.moof_box_is_from_last_mpu = false;
 	lls_sls_monitor_output_buffer->video_output_buffer_isobmff.moof_box_is_from_last_mpu_processed = false;
@@ -159,6 +160,7 @@ void lls_sls_monitor_output_buffer_reset_moof_and_fragment_position(lls_sls_moni
 	lls_sls_monitor_output_buffer->video_output_buffer_isobmff.fragment_pos = 0;
 	lls_sls_monitor_output_buffer->video_output_buffer_isobmff.last_fragment = NULL;
 	lls_sls_monitor_output_buffer->video_output_buffer_isobmff.last_fragment_lost_mfu_count = 0;
+	lls_sls_monitor_output_buffer->video_output_buffer_isobmff.fragment_first_arrival_ns = 0;
 
     lls_sls_monitor_output_buffer->should_flush_output_buffer = false;
 }
@@ -470,6 +472,9 @@ copy_packet:
 
     lls_sls_monitor_buffer_isobmff->last_fragment = audio_data_unit;
     lls_sls_monitor_buffer_isobmff->last_mpu_sequence_number_last_fragment = audio_data_unit;
+    if(audio_data_unit->mpu_data_unit_payload_fragments_timed.arrival_ns && (!lls_sls_monitor_buffer_isobmff->fragment_first_arrival_ns || audio_data_unit->mpu_data_unit_payload_fragments_timed.arrival_ns < lls_sls_monitor_buffer_isobmff->fragment_first_arrival_ns)) {
+    	lls_sls_monitor_buffer_isobmff->fragment_first_arrival_ns = audio_data_unit->mpu_data_unit_payload_fragments_timed.arrival_ns;
+    }
     return __lls_sls_monitor_output_buffer_check_and_copy(lls_sls_monitor_output_buffer->audio_output_buffer_isobmff.fragment_box, &lls_sls_monitor_output_buffer->audio_output_buffer_isobmff.fragment_pos, _LLS_SLS_MONITOR_OUTPUT_MAX_FRAGMENT_BUFFER, audio_data_unit->mmtp_mpu_type_packet_header.mpu_data_unit_payload);
 }
 
@@ -613,6 +618,9 @@ copy_packet:
 
     lls_sls_monitor_buffer_isobmff->last_fragment = video_data_unit;
     lls_sls_monitor_buffer_isobmff->last_mpu_sequence_number_last_fragment = video_data_unit;
+    if(video_data_unit->mpu_data_unit_payload_fragments_timed.arrival_ns && (!lls_sls_monitor_buffer_isobmff->fragment_first_arrival_ns || video_data_unit->mpu_data_unit_payload_fragments_timed.arrival_ns < lls_sls_monitor_buffer_isobmff->fragment_first_arrival_ns)) {
+    	lls_sls_monitor_buffer_isobmff->fragment_first_arrival_ns = video_data_unit->mpu_data_unit_payload_fragments_timed.arrival_ns;
+    }
 
     return __lls_sls_monitor_output_buffer_check_and_copy(lls_sls_monitor_output_buffer->video_output_buffer_isobmff.fragment_box, &lls_sls_monitor_output_buffer->video_output_buffer_isobmff.fragment_pos, _LLS_SLS_MONITOR_OUTPUT_MAX_FRAGMENT_BUFFER, video_mpu_data_unit_payload);
 }
@@ -820,6 +828,205 @@ void lls_sls_monitor_output_buffer_file_dump(lls_sls_monitor_output_buffer_t* ll
 }
 
 
+/**
+ * low-latency MFU output mode
+ */
+
+bool lls_sls_monitor_output_buffer_mfu_chunk_set_init_block(lls_sls_monitor_output_buffer_t* lls_sls_monitor_output_buffer) {
+	if(lls_sls_monitor_output_buffer->mfu_chunk_init_block) {
+		return true;
+	}
+	if(!lls_sls_monitor_output_buffer->joined_isobmff_block || !lls_sls_monitor_output_buffer->joined_isobmff_block->i_pos) {
+		return false;
+	}
+
+	block_t* joined_isobmff_block = lls_sls_monitor_output_buffer->joined_isobmff_block;
+	uint32_t init_box_len = atsc3_isobmff_cmaf_init_box_length(joined_isobmff_block->p_buffer, joined_isobmff_block->i_pos);
+	if(!init_box_len) {
+		__LLS_SLS_MONITOR_OUTPUT_BUFFER_UTILS_WARN("mfu chunk: no ftyp/moov in joined fragment of size: %u", joined_isobmff_block->i_pos);
+		return false;
+	}
+
+	lls_sls_monitor_buffer_isobmff_mfu_chunk_t* video_mfu_chunk = &lls_sls_monitor_output_buffer->video_output_buffer_isobmff.mfu_chunk;
+	lls_sls_monitor_buffer_isobmff_mfu_chunk_t* audio_mfu_chunk = &lls_sls_monitor_output_buffer->audio_output_buffer_isobmff.mfu_chunk;
+
+	//the joiner may have remapped the audio track_id, so resolve both from the joined moov rather than the per-track init boxes
+	bool has_video = atsc3_isobmff_cmaf_init_find_track(joined_isobmff_block->p_buffer, init_box_len, ATSC3_ISOBMFF_HANDLER_VIDE, &video_mfu_chunk->track_id, &video_mfu_chunk->timescale);
+	bool has_audio = atsc3_isobmff_cmaf_init_find_track(joined_isobmff_block->p_buffer, init_box_len, ATSC3_ISOBMFF_HANDLER_SOUN, &audio_mfu_chunk->track_id, &audio_mfu_chunk->timescale);
+	audio_mfu_chunk->is_audio = true;
+
+	if(!has_video && !has_audio) {
+		__LLS_SLS_MONITOR_OUTPUT_BUFFER_UTILS_WARN("mfu chunk: no audio or video trak in joined moov, init size: %u", init_box_len);
+		return false;
+	}
+
+	lls_sls_monitor_output_buffer->mfu_chunk_init_block = block_Alloc(init_box_len);
+	block_Write(lls_sls_monitor_output_buffer->mfu_chunk_init_block, joined_isobmff_block->p_buffer, init_box_len);
+	lls_sls_monitor_output_buffer->has_written_mfu_chunk_init_box = false;
+
+	__LLS_SLS_MONITOR_OUTPUT_BUFFER_UTILS_INFO("mfu chunk: init size: %u, video track_id: %u, timescale: %u, audio track_id: %u, timescale: %u",
+			init_box_len, video_mfu_chunk->track_id, video_mfu_chunk->timescale, audio_mfu_chunk->track_id, audio_mfu_chunk->timescale);
+
+	return true;
+}
+
+void lls_sls_monitor_buffer_isobmff_mfu_chunk_add_mpu_presentation_time(lls_sls_monitor_buffer_isobmff_t* lls_sls_monitor_buffer_isobmff, uint32_t mpu_sequence_number, uint64_t mpu_presentation_time) {
+	lls_sls_monitor_buffer_isobmff_mfu_chunk_t* mfu_chunk = &lls_sls_monitor_buffer_isobmff->mfu_chunk;
+
+	for(int i = 0; i < LLS_SLS_MONITOR_MFU_CHUNK_MPU_PRESENTATION_TIME_MAX; i++) {
+		if(mfu_chunk->mpu_presentation_time[i] && mfu_chunk->mpu_presentation_time_sequence_number[i] == mpu_sequence_number) {
+			mfu_chunk->mpu_presentation_time[i] = mpu_presentation_time;
+			return;
+		}
+	}
+
+	mfu_chunk->mpu_presentation_time_sequence_number[mfu_chunk->mpu_presentation_time_next] = mpu_sequence_number;
+	mfu_chunk->mpu_presentation_time[mfu_chunk->mpu_presentation_time_next] = mpu_presentation_time;
+	mfu_chunk->mpu_presentation_time_next = (mfu_chunk->mpu_presentation_time_next + 1) % LLS_SLS_MONITOR_MFU_CHUNK_MPU_PRESENTATION_TIME_MAX;
+}
+
+static trun_sample_entry_t* __mfu_chunk_trun_sample_entry(lls_sls_monitor_buffer_isobmff_t* lls_sls_monitor_buffer_isobmff, uint32_t sample_number) {
+	trun_sample_entry_vector_t* trun_sample_entry_vector = lls_sls_monitor_buffer_isobmff->moof_box_trun_sample_entry_vector;
+	if(!trun_sample_entry_vector || !sample_number || sample_number > trun_sample_entry_vector->size) {
+		return NULL;
+	}
+	return trun_sample_entry_vector->data[sample_number - 1];
+}
+
+static uint32_t __mfu_chunk_sample_duration(lls_sls_monitor_buffer_isobmff_t* lls_sls_monitor_buffer_isobmff, uint32_t sample_number) {
+	trun_sample_entry_t* trun_sample_entry = __mfu_chunk_trun_sample_entry(lls_sls_monitor_buffer_isobmff, sample_number);
+	return trun_sample_entry && trun_sample_entry->sample_duration ? trun_sample_entry->sample_duration : lls_sls_monitor_buffer_isobmff->mfu_chunk.last_sample_duration;
+}
+
+static uint64_t __mfu_chunk_base_media_decode_time(lls_sls_monitor_buffer_isobmff_t* lls_sls_monitor_buffer_isobmff) {
+	lls_sls_monitor_buffer_isobmff_mfu_chunk_t* mfu_chunk = &lls_sls_monitor_buffer_isobmff->mfu_chunk;
+	uint64_t mpu_presentation_time = 0;
+
+	for(int i = 0; i < LLS_SLS_MONITOR_MFU_CHUNK_MPU_PRESENTATION_TIME_MAX; i++) {
+		if(mfu_chunk->mpu_presentation_time_sequence_number[i] == mfu_chunk->mpu_sequence_number) {
+			mpu_presentation_time = mfu_chunk->mpu_presentation_time[i];
+		}
+	}
+
+	if(mpu_presentation_time && mfu_chunk->timescale) {
+		uint32_t mpu_presentation_time_s;
+		uint32_t mpu_presentation_time_us;
+		compute_ntp64_to_seconds_microseconds(mpu_presentation_time, &mpu_presentation_time_s, &mpu_presentation_time_us);
+
+		//mpu_presentation_time is the earliest presentation in the MPU, back out the composition offset of that sample
+		int64_t first_sample_presentation_offset = 0;
+		trun_sample_entry_vector_t* trun_sample_entry_vector = lls_sls_monitor_buffer_isobmff->moof_box_trun_sample_entry_vector;
+		if(trun_sample_entry_vector && trun_sample_entry_vector->size) {
+			uint64_t sample_decode_offset = 0;
+			first_sample_presentation_offset = INT64_MAX;
+			for(int i = 0; i < trun_sample_entry_vector->size; i++) {
+				int64_t sample_presentation_offset = sample_decode_offset + trun_sample_entry_vector->data[i]->sample_composition_time_offset;
+				if(sample_presentation_offset < first_sample_presentation_offset) {
+					first_sample_presentation_offset = sample_presentation_offset;
+				}
+				sample_decode_offset += trun_sample_entry_vector->data[i]->sample_duration;
+			}
+		}
+
+		uint64_t base_media_decode_time = (uint64_t)mpu_presentation_time_s * mfu_chunk->timescale + (uint64_t)mpu_presentation_time_us * mfu_chunk->timescale / 1000000;
+		base_media_decode_time -= first_sample_presentation_offset;
+		for(uint32_t i = 1; i < mfu_chunk->sample_number; i++) {
+			base_media_decode_time += __mfu_chunk_sample_duration(lls_sls_monitor_buffer_isobmff, i);
+		}
+		return base_media_decode_time;
+	}
+
+	if(!mfu_chunk->has_emitted_sample) {
+		return 0;
+	}
+
+	//no MPT timestamp for this MPU yet, continue from the last chunk, counting any dropped samples
+	uint32_t samples_since_last = mfu_chunk->sample_number;
+	if(mfu_chunk->mpu_sequence_number == mfu_chunk->last_mpu_sequence_number) {
+		samples_since_last = mfu_chunk->sample_number > mfu_chunk->last_sample_number ? mfu_chunk->sample_number - mfu_chunk->last_sample_number : 1;
+	}
+	return mfu_chunk->last_base_media_decode_time + (uint64_t)mfu_chunk->last_sample_duration * samples_since_last;
+}
+
+block_t* lls_sls_monitor_output_buffer_mfu_chunk_add_data_unit(lls_sls_monitor_output_buffer_t* lls_sls_monitor_output_buffer, lls_sls_monitor_buffer_isobmff_t* lls_sls_monitor_buffer_isobmff, mmtp_payload_fragments_union_t* data_unit) {
+	lls_sls_monitor_buffer_isobmff_mfu_chunk_t* mfu_chunk = &lls_sls_monitor_buffer_isobmff->mfu_chunk;
+	block_t* mpu_data_unit_payload = data_unit->mmtp_mpu_type_packet_header.mpu_data_unit_payload;
+
+	if(!mfu_chunk->track_id || !mpu_data_unit_payload || data_unit->mmtp_mpu_type_packet_header.mpu_fragment_type != 0x2) {
+		return NULL;
+	}
+
+	uint8_t mpu_fragmentation_indicator = data_unit->mpu_data_unit_payload_fragments_timed.mpu_fragmentation_indicator;
+	uint32_t mpu_sequence_number = data_unit->mpu_data_unit_payload_fragments_timed.mpu_sequence_number;
+	uint32_t sample_number = data_unit->mpu_data_unit_payload_fragments_timed.sample_number;
+	uint32_t packet_sequence_number = data_unit->mpu_data_unit_payload_fragments_timed.packet_sequence_number;
+
+	if(mpu_fragmentation_indicator == 0 || mpu_fragmentation_indicator == 1) {
+		if(mfu_chunk->sample_in_progress) {
+			__LLS_SLS_MONITOR_OUTPUT_BUFFER_UTILS_WARN("mfu chunk: track_id: %u, dropping mpu: %u, sample: %u, missing last data unit", mfu_chunk->track_id, mfu_chunk->mpu_sequence_number, mfu_chunk->sample_number);
+			mfu_chunk->samples_dropped++;
+		}
+		if(!mfu_chunk->sample_block) {
+			mfu_chunk->sample_block = block_Alloc_flags(_LLS_SLS_MONITOR_OUTPUT_MAX_MOOF_BUFFER, BLOCK_FLAG_NO_ZERO);
+		} else {
+			block_Rewind(mfu_chunk->sample_block);
+		}
+		mfu_chunk->sample_in_progress = true;
+		mfu_chunk->mpu_sequence_number = mpu_sequence_number;
+		mfu_chunk->sample_number = sample_number;
+		mfu_chunk->sample_first_arrival_ns = data_unit->mpu_data_unit_payload_fragments_timed.arrival_ns;
+
+	} else if(!mfu_chunk->sample_in_progress || mfu_chunk->mpu_sequence_number != mpu_sequence_number || mfu_chunk->sample_number != sample_number ||
+			mfu_chunk->last_packet_sequence_number + 1 != packet_sequence_number) {
+		if(mfu_chunk->sample_in_progress) {
+			__LLS_SLS_MONITOR_OUTPUT_BUFFER_UTILS_WARN("mfu chunk: track_id: %u, dropping mpu: %u, sample: %u, packet_sequence_number: %u, expected: %u",
+					mfu_chunk->track_id, mfu_chunk->mpu_sequence_number, mfu_chunk->sample_number, packet_sequence_number, mfu_chunk->last_packet_sequence_number + 1);
+			mfu_chunk->samples_dropped++;
+			mfu_chunk->sample_in_progress = false;
+		}
+		return NULL;
+	}
+
+	mfu_chunk->last_packet_sequence_number = packet_sequence_number;
+	block_Write(mfu_chunk->sample_block, mpu_data_unit_payload->p_buffer, mpu_data_unit_payload->i_pos);
+
+	if(mpu_fragmentation_indicator != 0 && mpu_fragmentation_indicator != 3) {
+		return NULL;
+	}
+	mfu_chunk->sample_in_progress = false;
+
+	trun_sample_entry_t* trun_sample_entry = __mfu_chunk_trun_sample_entry(lls_sls_monitor_buffer_isobmff, sample_number);
+	atsc3_isobmff_cmaf_chunk_sample_t atsc3_isobmff_cmaf_chunk_sample;
+	atsc3_isobmff_cmaf_chunk_sample.track_id = mfu_chunk->track_id;
+	atsc3_isobmff_cmaf_chunk_sample.base_media_decode_time = __mfu_chunk_base_media_decode_time(lls_sls_monitor_buffer_isobmff);
+	atsc3_isobmff_cmaf_chunk_sample.sample_duration = __mfu_chunk_sample_duration(lls_sls_monitor_buffer_isobmff, sample_number);
+	if(trun_sample_entry) {
+		atsc3_isobmff_cmaf_chunk_sample.sample_flags = trun_sample_entry->sample_flags;
+		atsc3_isobmff_cmaf_chunk_sample.sample_composition_time_offset = trun_sample_entry->sample_composition_time_offset;
+	} else {
+		atsc3_isobmff_cmaf_chunk_sample.sample_flags = mfu_chunk->is_audio || sample_number == 1 ? ATSC3_ISOBMFF_SAMPLE_FLAGS_SYNC : ATSC3_ISOBMFF_SAMPLE_FLAGS_NON_SYNC;
+		atsc3_isobmff_cmaf_chunk_sample.sample_composition_time_offset = 0;
+	}
+
+	block_t* chunk = atsc3_isobmff_cmaf_chunk_build(++lls_sls_monitor_output_buffer->mfu_chunk_sequence_number, &atsc3_isobmff_cmaf_chunk_sample,
+			mfu_chunk->sample_block->p_buffer, mfu_chunk->sample_block->i_pos);
+
+	__LLS_SLS_MONITOR_OUTPUT_BUFFER_UTILS_TRACE("mfu chunk: track_id: %u, mpu: %u, sample: %u, size: %u, decode time: %llu, duration: %u",
+			mfu_chunk->track_id, mpu_sequence_number, sample_number, mfu_chunk->sample_block->i_pos,
+			(unsigned long long)atsc3_isobmff_cmaf_chunk_sample.base_media_decode_time, atsc3_isobmff_cmaf_chunk_sample.sample_duration);
+
+	mfu_chunk->has_emitted_sample = true;
+	mfu_chunk->last_mpu_sequence_number = mpu_sequence_number;
+	mfu_chunk->last_sample_number = sample_number;
+	mfu_chunk->last_base_media_decode_time = atsc3_isobmff_cmaf_chunk_sample.base_media_decode_time;
+	if(atsc3_isobmff_cmaf_chunk_sample.sample_duration) {
+		mfu_chunk->last_sample_duration = atsc3_isobmff_cmaf_chunk_sample.sample_duration;
+	}
+	mfu_chunk->chunks_emitted++;
+
+	return chunk;
+}
+
 //sem_t
 //mutex 	pthread_mutex_t pipe_buffer_reader_mutex_lock;
 
@@ -17,6 +17,8 @@ extern "C" {
 #include "atsc3_mmtp_types.h"
 #include "atsc3_player_ffplay.h"
 #include "atsc3_isobmff_trun_box.h"
+#include "atsc3_isobmff_cmaf_chunk.h"
+#include "atsc3_mmtp_ntp32_to_pts.h"
 #include "bento4/ISOBMFFTrackJoiner_firewall_gpl.h"
 
 
@@ -58,6 +60,13 @@ block_t* lls_sls_monitor_output_buffer_copy_video_moof_fragment_isobmff_box(lls_
 void lls_slt_monitor_check_and_handle_pipe_ffplay_buffer_is_shutdown(lls_slt_monitor_t* lls_slt_monitor);
 void lls_sls_monitor_output_buffer_file_dump(lls_sls_monitor_output_buffer_t* lls_sls_monitor_output_buffer, const char* directory_path, uint32_t mpu_sequence_number_audio,  uint32_t mpu_sequence_number_video);
 
+//low-latency MFU output mode, see lls_sls_monitor_buffer_isobmff_mfu_chunk_t
+//caches the ftyp/moov of the joined fragment and resolves the chunk track_id's, returns false until a joined fragment with a moov is available
+bool lls_sls_monitor_output_buffer_mfu_chunk_set_init_block(lls_sls_monitor_output_buffer_t* lls_sls_monitor_output_buffer);
+void lls_sls_monitor_buffer_isobmff_mfu_chunk_add_mpu_presentation_time(lls_sls_monitor_buffer_isobmff_t* lls_sls_monitor_buffer_isobmff, uint32_t mpu_sequence_number, uint64_t mpu_presentation_time);
+//returns a new moof + mdat chunk when data_unit completes a sample, NULL otherwise
+block_t* lls_sls_monitor_output_buffer_mfu_chunk_add_data_unit(lls_sls_monitor_output_buffer_t* lls_sls_monitor_output_buffer, lls_sls_monitor_buffer_isobmff_t* lls_sls_monitor_buffer_isobmff, mmtp_payload_fragments_union_t* data_unit);
+
 pthread_mutex_t* lls_sls_monitor_reader_mutext_create();
 void lls_sls_monitor_reader_mutex_lock(pthread_mutex_t* pthread_mutex);
 void lls_sls_monitor_reader_mutex_unlock(pthread_mutex_t* pthread_mutex);
@@ -25,6 +25,7 @@ address and destination port of the MMTP session carrying the MMTP- specific SLS
 
 #include "atsc3_lls_slt_parser.h"
 #include "atsc3_lls_sls_parser.h"
+#include "atsc3_flow_dispatch.h"
 
 int _LLS_SLT_PARSER_INFO_ENABLED=0;
 int _LLS_SLT_PARSER_INFO_MMT_ENABLED=0;
@@ -249,43 +250,205 @@ cleanup:
 
 
 
-int lls_slt_table_perform_update(lls_table_t* lls_table, lls_slt_monitor_t* lls_slt_monitor) {
+//a service's ALC or MMT session is keyed on its service_id and broadcast_svc_signaling tuple
+typedef struct lls_slt_service_key {
+	uint16_t		service_id;
+	int				sls_protocol;
+	uint32_t		sls_source_ip_address;
+	uint32_t		sls_destination_ip_address;
+	uint16_t		sls_destination_udp_port;
+	lls_service_t*	lls_service;
+} lls_slt_service_key_t;
 
-    for(int i=0; i < lls_table->slt_table.service_entry_n; i++) {
+static int __lls_slt_service_key_compare(const void* a, const void* b) {
+	const lls_slt_service_key_t* key_a = (const lls_slt_service_key_t*)a;
+	const lls_slt_service_key_t* key_b = (const lls_slt_service_key_t*)b;
+
+	if(key_a->service_id != key_b->service_id) return key_a->service_id < key_b->service_id ? -1 : 1;
+	if(key_a->sls_protocol != key_b->sls_protocol) return key_a->sls_protocol < key_b->sls_protocol ? -1 : 1;
+	if(key_a->sls_destination_ip_address != key_b->sls_destination_ip_address) return key_a->sls_destination_ip_address < key_b->sls_destination_ip_address ? -1 : 1;
+	if(key_a->sls_destination_udp_port != key_b->sls_destination_udp_port) return key_a->sls_destination_udp_port < key_b->sls_destination_udp_port ? -1 : 1;
+	if(key_a->sls_source_ip_address != key_b->sls_source_ip_address) return key_a->sls_source_ip_address < key_b->sls_source_ip_address ? -1 : 1;
+	return 0;
+}
+
+//sorted keys of the ROUTE and MMTP services in lls_table, other sls_protocols have no session
+static lls_slt_service_key_t* __lls_slt_service_keys_create(lls_table_t* lls_table, int* keys_n) {
+	*keys_n = 0;
+	if(!lls_table || !lls_table->slt_table.service_entry_n) {
+		return NULL;
+	}
+
+	lls_slt_service_key_t* keys = (lls_slt_service_key_t*)calloc(lls_table->slt_table.service_entry_n, sizeof(lls_slt_service_key_t));
+	if(!keys) {
+		abort();
+	}
+
+	for(int i=0; i < lls_table->slt_table.service_entry_n; i++) {
 		lls_service_t* lls_service = lls_table->slt_table.service_entry[i];
-		__LLS_SLT_PARSER_DEBUG("checking service: %d", lls_service->service_id);
+		broadcast_svc_signaling_t* broadcast_svc_signaling = &lls_service->broadcast_svc_signaling;
+		if(broadcast_svc_signaling->sls_protocol != SLS_PROTOCOL_ROUTE && broadcast_svc_signaling->sls_protocol != SLS_PROTOCOL_MMTP) {
+			continue;
+		}
 
-		if(lls_service->broadcast_svc_signaling.sls_protocol == SLS_PROTOCOL_ROUTE) {
-            __LLS_SLT_PARSER_INFO_ROUTE("ROUTE: adding service: %u, flow: %s:%s", lls_service->service_id, lls_service->broadcast_svc_signaling.sls_destination_ip_address, lls_service->broadcast_svc_signaling.sls_destination_udp_port);
+		lls_slt_service_key_t* key = &keys[(*keys_n)++];
+		key->service_id = lls_service->service_id;
+		key->sls_protocol = broadcast_svc_signaling->sls_protocol;
+		key->sls_source_ip_address = broadcast_svc_signaling->sls_source_ip_address ? parseIpAddressIntoIntval(broadcast_svc_signaling->sls_source_ip_address) : 0;
+		key->sls_destination_ip_address = broadcast_svc_signaling->sls_destination_ip_address ? parseIpAddressIntoIntval(broadcast_svc_signaling->sls_destination_ip_address) : 0;
+		key->sls_destination_udp_port = broadcast_svc_signaling->sls_destination_udp_port ? parsePortIntoIntval(broadcast_svc_signaling->sls_destination_udp_port) : 0;
+		key->lls_service = lls_service;
+	}
 
-			lls_sls_alc_session_t* lls_sls_alc_session = lls_slt_alc_session_find_or_create(lls_slt_monitor->lls_sls_alc_session_vector, lls_service);
+	qsort(keys, *keys_n, sizeof(lls_slt_service_key_t), __lls_slt_service_key_compare);
 
-			//TODO - we probably need to clear out any missing ALC sessions?
-			if(lls_sls_alc_session && !lls_sls_alc_session->alc_session) {
+	return keys;
+}
+
+static lls_service_t* __lls_slt_service_find_from_service_id(lls_table_t* lls_table, uint16_t service_id) {
+	for(int i=0; lls_table && i < lls_table->slt_table.service_entry_n; i++) {
+		if(lls_table->slt_table.service_entry[i]->service_id == service_id) {
+			return lls_table->slt_table.service_entry[i];
+		}
+	}
+	return NULL;
+}
+
+//lls_service pointers reference the SLT that is about to be freed, and a monitored session may have been removed or moved to a new flow
+static void __lls_slt_monitor_rebind(lls_table_t* lls_table, lls_slt_monitor_t* lls_slt_monitor) {
+	if(lls_slt_monitor->lls_service) {
+		lls_slt_monitor->lls_service = __lls_slt_service_find_from_service_id(lls_table, lls_slt_monitor->lls_service->service_id);
+	}
+
+	lls_sls_alc_monitor_t* lls_sls_alc_monitor = lls_slt_monitor->lls_sls_alc_monitor;
+	if(lls_sls_alc_monitor) {
+		lls_sls_alc_monitor->lls_service = __lls_slt_service_find_from_service_id(lls_table, lls_sls_alc_monitor->service_id);
+		if(lls_sls_alc_monitor->lls_alc_session && lls_slt_monitor->lls_sls_alc_session_vector) {
+			lls_sls_alc_session_t* lls_sls_alc_session = lls_slt_alc_session_find_from_service_id(lls_slt_monitor, lls_sls_alc_monitor->service_id);
+			if(lls_sls_alc_session != lls_sls_alc_monitor->lls_alc_session) {
+				__LLS_SLT_PARSER_INFO_ROUTE("ROUTE: monitored service: %u, session %p replaced with %p", lls_sls_alc_monitor->service_id, lls_sls_alc_monitor->lls_alc_session, lls_sls_alc_session);
+				lls_sls_alc_monitor->lls_alc_session = lls_sls_alc_session;
+				if(lls_sls_alc_session && lls_sls_alc_session->alc_session) {
+					alc_session_reset_object_cache(lls_sls_alc_session->alc_session);
+				}
+			}
+		}
+	}
+
+	lls_sls_mmt_monitor_t* lls_sls_mmt_monitor = lls_slt_monitor->lls_sls_mmt_monitor;
+	if(lls_sls_mmt_monitor) {
+		lls_sls_mmt_monitor->lls_service = __lls_slt_service_find_from_service_id(lls_table, lls_sls_mmt_monitor->service_id);
+		if(lls_sls_mmt_monitor->lls_mmt_session && lls_slt_monitor->lls_sls_mmt_session_vector) {
+			lls_sls_mmt_session_t* lls_sls_mmt_session = lls_slt_mmt_session_find_from_service_id(lls_slt_monitor, lls_sls_mmt_monitor->service_id);
+			if(lls_sls_mmt_session != lls_sls_mmt_monitor->lls_mmt_session) {
+				__LLS_SLT_PARSER_INFO_MMT("MMT: monitored service: %u, session %p replaced with %p", lls_sls_mmt_monitor->service_id, lls_sls_mmt_monitor->lls_mmt_session, lls_sls_mmt_session);
+				lls_sls_mmt_monitor->lls_mmt_session = lls_sls_mmt_session;
+			}
+		}
+	}
+}
+
+/**
+ * diffs lls_table against lls_table_previous (NULL for the first SLT) on each service's service_id and broadcast_svc_signaling
+ * tuple: only the sessions of services that were removed or whose signaling flow changed are closed, and only those of new or
+ * changed services are opened, sessions of unchanged services keep their state. the flow dispatch table is only rebuilt, and
+ * lls_slt_sessions_generation only incremented, when a session was added or removed.
+ *
+ * removed sessions are retired rather than freed, as the previously published flow dispatch table may still reference them,
+ * and are freed on the next update that adds or removes a session.
+ *
+ * lls_table_previous must stay valid until this returns, monitor lls_service references are moved over to lls_table.
+ */
+int lls_slt_table_perform_update(lls_table_t* lls_table_previous, lls_table_t* lls_table, lls_slt_monitor_t* lls_slt_monitor) {
+	int ret = 0;
+	int keys_previous_n = 0;
+	int keys_n = 0;
+	lls_slt_service_key_t* keys_previous = __lls_slt_service_keys_create(lls_table_previous, &keys_previous_n);
+	lls_slt_service_key_t* keys = __lls_slt_service_keys_create(lls_table, &keys_n);
+
+	//merge the two sorted key lists, a key only in the previous SLT is removed, one only in the new SLT is added
+	lls_service_t** services_removed = (lls_service_t**)calloc(keys_previous_n + 1, sizeof(lls_service_t*));
+	lls_service_t** services_added = (lls_service_t**)calloc(keys_n + 1, sizeof(lls_service_t*));
+	if(!services_removed || !services_added) {
+		abort();
+	}
+	int services_removed_n = 0;
+	int services_added_n = 0;
+
+	int i = 0;
+	int j = 0;
+	while(i < keys_previous_n || j < keys_n) {
+		int compare = i == keys_previous_n ? 1 : j == keys_n ? -1 : __lls_slt_service_key_compare(&keys_previous[i], &keys[j]);
+		if(compare < 0) {
+			services_removed[services_removed_n++] = keys_previous[i++].lls_service;
+		} else if(compare > 0) {
+			services_added[services_added_n++] = keys[j++].lls_service;
+		} else {
+			i++;
+			j++;
+		}
+	}
+
+	__LLS_SLT_PARSER_DEBUG("lls_slt_table_perform_update: services: %d, removed: %d, added: %d", keys_n, services_removed_n, services_added_n);
+
+	bool sessions_changed = services_removed_n || services_added_n;
+	if(sessions_changed) {
+		//the sessions retired last time have had a full flow dispatch rebuild interval to drain
+		lls_sls_alc_session_vector_retired_free(lls_slt_monitor->lls_sls_alc_session_vector);
+		lls_sls_mmt_session_vector_retired_free(lls_slt_monitor->lls_sls_mmt_session_vector);
+
+		for(i=0; i < services_removed_n; i++) {
+			lls_service_t* lls_service = services_removed[i];
+
+			if(lls_service->broadcast_svc_signaling.sls_protocol == SLS_PROTOCOL_ROUTE) {
+				__LLS_SLT_PARSER_INFO_ROUTE("ROUTE: removing service: %u, flow: %s:%s", lls_service->service_id, lls_service->broadcast_svc_signaling.sls_destination_ip_address, lls_service->broadcast_svc_signaling.sls_destination_udp_port);
 				lls_slt_alc_session_remove(lls_slt_monitor->lls_sls_alc_session_vector, lls_service);
-                __LLS_SLT_PARSER_ERROR("ROUTE: Unable to instantiate alc session for service_id: %d via SLS_PROTOCOL_ROUTE", lls_service->service_id);
-				goto cleanup;
-		  	}
+			} else {
+				__LLS_SLT_PARSER_INFO_MMT("MMT: removing service: %u, flow: %s:%s", lls_service->service_id, lls_service->broadcast_svc_signaling.sls_destination_ip_address, lls_service->broadcast_svc_signaling.sls_destination_udp_port);
+				lls_slt_mmt_session_remove(lls_slt_monitor->lls_sls_mmt_session_vector, lls_service);
+			}
+		}
+
+		for(i=0; i < services_added_n; i++) {
+			lls_service_t* lls_service = services_added[i];
+
+			if(lls_service->broadcast_svc_signaling.sls_protocol == SLS_PROTOCOL_ROUTE) {
+				__LLS_SLT_PARSER_INFO_ROUTE("ROUTE: adding service: %u, flow: %s:%s", lls_service->service_id, lls_service->broadcast_svc_signaling.sls_destination_ip_address, lls_service->broadcast_svc_signaling.sls_destination_udp_port);
+
+				lls_sls_alc_session_t* lls_sls_alc_session = lls_slt_alc_session_find_or_create(lls_slt_monitor->lls_sls_alc_session_vector, lls_service);
+				if(lls_sls_alc_session && !lls_sls_alc_session->alc_session) {
+					lls_slt_alc_session_remove(lls_slt_monitor->lls_sls_alc_session_vector, lls_service);
+					__LLS_SLT_PARSER_ERROR("ROUTE: Unable to instantiate alc session for service_id: %d via SLS_PROTOCOL_ROUTE", lls_service->service_id);
+					ret = -1;
+					break;
+				}
+			} else {
+				__LLS_SLT_PARSER_INFO_MMT("MMT: adding service: %u, flow: %s:%s", lls_service->service_id, lls_service->broadcast_svc_signaling.sls_destination_ip_address, lls_service->broadcast_svc_signaling.sls_destination_udp_port);
+
+				lls_sls_mmt_session_t* lls_sls_mmt_session = lls_slt_mmt_session_find_or_create(lls_slt_monitor->lls_sls_mmt_session_vector, lls_service);
+				if(!lls_sls_mmt_session) {
+					__LLS_SLT_PARSER_ERROR("MMT: Unable to instantiate session for service_id: %d via SLS_PROTOCOL_MMTP", lls_service->service_id);
+					ret = -1;
+					break;
+				}
+			}
 		}
-        
-        if(lls_service->broadcast_svc_signaling.sls_protocol == SLS_PROTOCOL_MMTP) {
-            __LLS_SLT_PARSER_INFO_MMT("MMT: adding service: %u, flow: %s:%s", lls_service->service_id, lls_service->broadcast_svc_signaling.sls_destination_ip_address, lls_service->broadcast_svc_signaling.sls_destination_udp_port);
-            
-            lls_sls_mmt_session_t* lls_sls_mmt_session = lls_slt_mmt_session_find_or_create(lls_slt_monitor->lls_sls_mmt_session_vector, lls_service);
-            
-            //TODO - clear out any dropped mmt sessions?
-            if(!lls_sls_mmt_session) {
-                lls_slt_mmt_session_remove(lls_slt_monitor->lls_sls_mmt_session_vector, lls_service);
-                __LLS_SLT_PARSER_ERROR("MMT: Unable to instantiate session for service_id: %d via SLS_PROTOCOL_MMTP", lls_service->service_id);
-                goto cleanup;
-            }
-        }
 	}
 
-	return 0;
+	__lls_slt_monitor_rebind(lls_table, lls_slt_monitor);
 
-cleanup:
-	return -1;
+	//sessions added before a failing service are still live, so publish them as well
+	if(sessions_changed) {
+		lls_slt_monitor->lls_slt_sessions_generation++;
+		atsc3_flow_dispatch_rebuild(lls_slt_monitor);
+	}
+
+	freesafe(keys_previous);
+	freesafe(keys);
+	freesafe(services_removed);
+	freesafe(services_added);
+
+	return ret;
 }
 
 
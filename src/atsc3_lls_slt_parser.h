@@ -43,7 +43,7 @@ extern "C" {
 lls_slt_monitor_t* lls_slt_monitor_create(void);
 
 int lls_slt_table_check_process_update(lls_table_t* lls_table, lls_slt_monitor_t* lls_slt_monitor);
-int lls_slt_table_perform_update(lls_table_t* lls_table, lls_slt_monitor_t* lls_slt_monitor);
+int lls_slt_table_perform_update(lls_table_t* lls_table_previous, lls_table_t* lls_table, lls_slt_monitor_t* lls_slt_monitor);
 
 
 //etst methods
@@ -29,6 +29,8 @@
 #include <stdlib.h>
 
 #include "atsc3_lls.h"
+#include "atsc3_lls_slt_parser.h"
+#include "atsc3_flow_dispatch.h"
 #include "xml.h"
 
 #define __UNIT_TEST 1
@@ -37,15 +39,19 @@
 extern int _LLS_DEBUG_ENABLED;
 
 void test_parse_xml(char* xml);
+int test_slt_table_perform_update_diff();
 
 char* test_slt_table = "<?xml version=\"1.0\" encoding=\"UTF-8\"?><SLT xmlns=\"tag:atsc.org,2016:XMLSchemas/ATSC3/Delivery/SLT/1.0/\" bsid=\"50\"><Service serviceId=\"1001\" globalServiceID=\"urn:atsc:serviceid:ateme_mmt_1\" majorChannelNo=\"10\" minorChannelNo=\"1\" serviceCategory=\"1\" shortServiceName=\"ATEME MMT 1\" sltSvcSeqNum=\"0\"><BroadcastSvcSignaling slsProtocol=\"2\" slsDestinationIpAddress=\"239.255.10.1\" slsDestinationUdpPort=\"51001\" slsSourceIpAddress=\"172.16.200.1\"/></Service><Service serviceId=\"1002\" globalServiceID=\"urn:atsc:serviceid:ateme_mmt_2\" majorChannelNo=\"10\" minorChannelNo=\"2\" serviceCategory=\"1\" shortServiceName=\"ATEME MMT 2\" sltSvcSeqNum=\"0\"><BroadcastSvcSignaling slsProtocol=\"2\" slsDestinationIpAddress=\"239.255.10.2\" slsDestinationUdpPort=\"51002\" slsSourceIpAddress=\"172.16.200.1\"/></Service><Service serviceId=\"1003\" globalServiceID=\"urn:atsc:serviceid:ateme_mmt_3\" majorChannelNo=\"10\" minorChannelNo=\"3\" serviceCategory=\"1\" shortServiceName=\"ATEME MMT 3\" sltSvcSeqNum=\"0\"><BroadcastSvcSignaling slsProtocol=\"2\" slsDestinationIpAddress=\"239.255.10.3\" slsDestinationUdpPort=\"51003\" slsSourceIpAddress=\"172.16.200.1\"/></Service><Service serviceId=\"1004\" globalServiceID=\"urn:atsc:serviceid:ateme_mmt_4\" majorChannelNo=\"10\" minorChannelNo=\"4\" serviceCategory=\"1\" shortServiceName=\"ATEME MMT 4\" sltSvcSeqNum=\"0\"><BroadcastSvcSignaling slsProtocol=\"2\" slsDestinationIpAddress=\"239.255.10.4\" slsDestinationUdpPort=\"51004\" slsSourceIpAddress=\"172.16.200.1\"/></Service><Service serviceId=\"5009\" globalServiceID=\"urn:atsc:serviceid:esg\" serviceCategory=\"4\" shortServiceName=\"ESG\" sltSvcSeqNum=\"0\"><BroadcastSvcSignaling slsProtocol=\"1\" slsDestinationIpAddress=\"239.255.20.9\" slsDestinationUdpPort=\"52009\" slsSourceIpAddress=\"172.16.200.1\"/></Service></SLT>";
 
 
 int main() {
+	int failed = 0;
 
 	test_parse_xml(test_slt_table);
+	failed += test_slt_table_perform_update_diff();
 
-	return 0;
+	printf("atsc3_lls_slt_parser_test: %s\n", failed ? "FAILED" : "OK");
+	return failed;
 }
 
 void test_parse_xml(char* xml) {
@@ -80,6 +86,126 @@ void test_parse_xml(char* xml) {
 	}
 }
 
+//service_id, slsProtocol, slsDestinationIpAddress, slsDestinationUdpPort
+typedef struct test_slt_service {
+	uint16_t	service_id;
+	int			sls_protocol;
+	char*		sls_destination_ip_address;
+	char*		sls_destination_udp_port;
+} test_slt_service_t;
+
+lls_table_t* test_slt_table_create(uint8_t lls_table_version, test_slt_service_t* test_slt_services, int test_slt_services_n) {
+	lls_table_t* lls_table = (lls_table_t*)calloc(1, sizeof(lls_table_t));
+	lls_table->lls_table_id = SLT;
+	lls_table->lls_table_version = lls_table_version;
+	lls_table->slt_table.service_entry_n = test_slt_services_n;
+	lls_table->slt_table.service_entry = (lls_service_t**)calloc(test_slt_services_n, sizeof(lls_service_t*));
+
+	for(int i=0; i < test_slt_services_n; i++) {
+		lls_service_t* lls_service = (lls_service_t*)calloc(1, sizeof(lls_service_t));
+		lls_service->service_id = test_slt_services[i].service_id;
+		lls_service->broadcast_svc_signaling.sls_protocol = test_slt_services[i].sls_protocol;
+		lls_service->broadcast_svc_signaling.sls_source_ip_address = strdup("172.16.200.1");
+		lls_service->broadcast_svc_signaling.sls_destination_ip_address = strdup(test_slt_services[i].sls_destination_ip_address);
+		lls_service->broadcast_svc_signaling.sls_destination_udp_port = strdup(test_slt_services[i].sls_destination_udp_port);
+		lls_table->slt_table.service_entry[i] = lls_service;
+	}
+	return lls_table;
+}
+
+//replaces lls_slt_monitor's SLT the same way lls_table_create_or_update_from_lls_slt_monitor does
+int test_slt_table_update(lls_slt_monitor_t* lls_slt_monitor, lls_table_t* lls_table) {
+	lls_table_t* lls_table_previous = lls_slt_monitor->lls_table_slt;
+	lls_slt_monitor->lls_table_slt = lls_table;
+	int ret = lls_slt_table_perform_update(lls_table_previous, lls_table, lls_slt_monitor);
+	if(lls_table_previous) {
+		lls_table_free(&lls_table_previous);
+	}
+	return ret;
+}
+
+int test_slt_table_perform_update_diff() {
+	lls_slt_monitor_t* lls_slt_monitor = lls_slt_monitor_create();
+
+	test_slt_service_t slt_v1[] = {
+		{ 1001, SLS_PROTOCOL_MMTP, "239.255.10.1", "51001" },
+		{ 1002, SLS_PROTOCOL_MMTP, "239.255.10.2", "51002" },
+		{ 5004, SLS_PROTOCOL_ROUTE, "239.255.20.4", "52004" },
+		{ 5009, SLS_PROTOCOL_ROUTE, "239.255.20.9", "52009" },
+	};
+	if(test_slt_table_update(lls_slt_monitor, test_slt_table_create(1, slt_v1, 4)) ||
+			lls_slt_monitor->lls_sls_mmt_session_vector->lls_slt_mmt_sessions_n != 2 || lls_slt_monitor->lls_sls_alc_session_vector->lls_slt_alc_sessions_n != 2 ||
+			lls_slt_monitor->lls_slt_sessions_generation != 1 || !lls_slt_monitor->atsc3_flow_dispatch_table) {
+		printf("test_slt_table_perform_update_diff: initial SLT\n");
+		return 1;
+	}
+
+	lls_sls_mmt_session_t* lls_sls_mmt_session_1002 = lls_slt_mmt_session_find_from_service_id(lls_slt_monitor, 1002);
+	lls_sls_alc_session_t* lls_sls_alc_session_5009 = lls_slt_alc_session_find_from_service_id(lls_slt_monitor, 5009);
+
+	lls_sls_mmt_monitor_t* lls_sls_mmt_monitor = lls_sls_mmt_monitor_create();
+	lls_sls_mmt_monitor->service_id = 1002;
+	lls_sls_mmt_monitor->lls_mmt_session = lls_sls_mmt_session_1002;
+	lls_slt_monitor->lls_sls_mmt_monitor = lls_sls_mmt_monitor;
+
+	//new version with the same services and flows: nothing is reopened and the dispatch table is kept
+	struct atsc3_flow_dispatch_table* atsc3_flow_dispatch_table = lls_slt_monitor->atsc3_flow_dispatch_table;
+	test_slt_table_update(lls_slt_monitor, test_slt_table_create(2, slt_v1, 4));
+	if(lls_slt_monitor->lls_slt_sessions_generation != 1 || lls_slt_monitor->atsc3_flow_dispatch_table != atsc3_flow_dispatch_table ||
+			lls_slt_mmt_session_find_from_service_id(lls_slt_monitor, 1002) != lls_sls_mmt_session_1002 ||
+			lls_sls_mmt_monitor->lls_service != lls_slt_monitor->lls_table_slt->slt_table.service_entry[1]) {
+		printf("test_slt_table_perform_update_diff: unchanged SLT was rebuilt\n");
+		return 1;
+	}
+
+	//1002 moves to a new port, 5004 is dropped and 5010 is added
+	test_slt_service_t slt_v3[] = {
+		{ 1001, SLS_PROTOCOL_MMTP, "239.255.10.1", "51001" },
+		{ 1002, SLS_PROTOCOL_MMTP, "239.255.10.2", "51012" },
+		{ 5009, SLS_PROTOCOL_ROUTE, "239.255.20.9", "52009" },
+		{ 5010, SLS_PROTOCOL_ROUTE, "239.255.20.10", "52010" },
+	};
+	test_slt_table_update(lls_slt_monitor, test_slt_table_create(3, slt_v3, 4));
+
+	lls_sls_mmt_session_t* lls_sls_mmt_session_1002_moved = lls_slt_mmt_session_find_from_service_id(lls_slt_monitor, 1002);
+	if(lls_slt_monitor->lls_slt_sessions_generation != 2 ||
+			lls_slt_monitor->lls_sls_mmt_session_vector->lls_slt_mmt_sessions_n != 2 || lls_slt_monitor->lls_sls_mmt_session_vector->lls_slt_mmt_sessions_retired_n != 1 ||
+			lls_slt_monitor->lls_sls_alc_session_vector->lls_slt_alc_sessions_n != 2 || lls_slt_monitor->lls_sls_alc_session_vector->lls_slt_alc_sessions_retired_n != 1 ||
+			lls_slt_alc_session_find_from_service_id(lls_slt_monitor, 5004) || lls_slt_alc_session_find_from_service_id(lls_slt_monitor, 5009) != lls_sls_alc_session_5009 ||
+			!lls_sls_mmt_session_1002_moved || lls_sls_mmt_session_1002_moved->sls_destination_udp_port != 51012 || lls_sls_mmt_monitor->lls_mmt_session != lls_sls_mmt_session_1002_moved) {
+		printf("test_slt_table_perform_update_diff: targeted add/remove, generation: %u\n", lls_slt_monitor->lls_slt_sessions_generation);
+		return 1;
+	}
+
+	atsc3_flow_dispatch_entry_t atsc3_flow_dispatch_entry = atsc3_flow_dispatch_find(lls_slt_monitor, 0, parseIpAddressIntoIntval("239.255.10.2"), 51002);
+	if(atsc3_flow_dispatch_entry.kind != ATSC3_FLOW_DISPATCH_UNKNOWN) {
+		printf("test_slt_table_perform_update_diff: removed flow still dispatched\n");
+		return 1;
+	}
+	atsc3_flow_dispatch_entry = atsc3_flow_dispatch_find(lls_slt_monitor, 0, parseIpAddressIntoIntval("239.255.10.2"), 51012);
+	if(atsc3_flow_dispatch_entry.kind != ATSC3_FLOW_DISPATCH_MMT || atsc3_flow_dispatch_entry.lls_sls_mmt_monitor != lls_sls_mmt_monitor) {
+		printf("test_slt_table_perform_update_diff: moved flow not dispatched to the monitor\n");
+		return 1;
+	}
+
+	//the next change frees the sessions retired above, 1002 is no longer announced
+	test_slt_table_update(lls_slt_monitor, test_slt_table_create(4, slt_v3, 1));
+	if(lls_slt_monitor->lls_slt_sessions_generation != 3 ||
+			lls_slt_monitor->lls_sls_mmt_session_vector->lls_slt_mmt_sessions_n != 1 || lls_slt_monitor->lls_sls_mmt_session_vector->lls_slt_mmt_sessions_retired_n != 1 ||
+			lls_slt_monitor->lls_sls_alc_session_vector->lls_slt_alc_sessions_n != 0 || lls_slt_monitor->lls_sls_alc_session_vector->lls_slt_alc_sessions_retired_n != 2 ||
+			lls_sls_mmt_monitor->lls_mmt_session || lls_sls_mmt_monitor->lls_service) {
+		printf("test_slt_table_perform_update_diff: removal of the monitored service\n");
+		return 1;
+	}
+
+	lls_slt_monitor->lls_sls_mmt_monitor = NULL;
+	free(lls_sls_mmt_monitor);
+	lls_sls_alc_session_vector_retired_free(lls_slt_monitor->lls_sls_alc_session_vector);
+	lls_sls_mmt_session_vector_retired_free(lls_slt_monitor->lls_sls_mmt_session_vector);
+
+	return 0;
+}
+
 #endif
 
 
@@ -308,14 +308,29 @@ typedef struct udp_flow_packet_id_mpu_sequence_tuple {
     uint32_t    mpu_sequence_number_negative_discontinuity;
     uint32_t    mpu_sequence_number_negative_discontinuity_received_fragments;
     bool   		has_sent_init_box;
-    
+
+    //hash chains owned by udp_flow_latest_mpu_sequence_number_container_t, not valid on clones
+    struct udp_flow_packet_id_mpu_sequence_tuple* packet_id_bucket_next;
+    struct udp_flow_packet_id_mpu_sequence_tuple* udp_flow_bucket_next;
+
 } udp_flow_packet_id_mpu_sequence_tuple_t;
 
-//we'll just keep a linear search of these, it should pretty straightforard to iterate thru for now..
+/**
+ * udp_flows holds the tuples in insertion order, each tuple is allocated once so pointers stay stable.
+ *
+ * lookups go through two chained hash indexes of udp_flow_buckets_n buckets (power of 2):
+ *  packet_id_buckets:	<dst_ip, dst_port, packet_id>, per-packet tracking
+ *  udp_flow_buckets:	<dst_ip, dst_port>, fan-out to all packet_ids of a flow during reconstitution
+ */
 typedef struct udp_flow_latest_mpu_sequence_number_container {
     uint32_t udp_flows_n;
     udp_flow_packet_id_mpu_sequence_tuple_t** udp_flows;
-    
+    uint32_t udp_flows_capacity;
+
+    uint32_t udp_flow_buckets_n;
+    udp_flow_packet_id_mpu_sequence_tuple_t** packet_id_buckets;
+    udp_flow_packet_id_mpu_sequence_tuple_t** udp_flow_buckets;
+
 } udp_flow_latest_mpu_sequence_number_container_t;
 
 
@@ -376,6 +391,10 @@ typedef struct lls_sls_mmt_session_vector {
     
     int lls_slt_mmt_sessions_n;
     lls_sls_mmt_session_t** lls_slt_mmt_sessions;
+
+    //removed by an SLT update, freed on the next update that adds or removes a session
+    int lls_slt_mmt_sessions_retired_n;
+    lls_sls_mmt_session_t** lls_slt_mmt_sessions_retired;
     
 } lls_sls_mmt_session_vector_t;
 
@@ -406,6 +425,9 @@ typedef struct lls_sls_alc_session {
 	alc_arguments_t* alc_arguments;
 	alc_session_t* alc_session;
 
+	//from the SLS on TSI 0, published with __atomic_exchange_n, the replaced S-TSID is retired through atsc3_qsbr
+	struct atsc3_route_s_tsid* atsc3_route_s_tsid;
+
 } lls_sls_alc_session_t;
 
 /**
@@ -449,6 +471,10 @@ typedef struct lls_sls_alc_session_vector {
 	int lls_slt_alc_sessions_n;
 	lls_sls_alc_session_t** lls_slt_alc_sessions;
 
+	//removed by an SLT update, freed on the next update that adds or removes a session
+	int lls_slt_alc_sessions_retired_n;
+	lls_sls_alc_session_t** lls_slt_alc_sessions_retired;
+
 } lls_sls_alc_session_vector_t;
 
 
@@ -494,6 +520,22 @@ typedef struct lls_sls_alc_monitor {
     lls_sls_monitor_output_buffer_t lls_sls_monitor_output_buffer;
     lls_sls_monitor_output_buffer_mode_t lls_sls_monitor_output_buffer_mode;
 
+    //in-memory object reconstitution for video_tsi and audio_tsi, see alc_recon_monitor_add_packet
+    struct alc_recon_track* video_recon_track;
+    struct alc_recon_track* audio_recon_track;
+
+    //TOI 0 FDT-Instance objects on video_tsi and audio_tsi, merged into atsc3_fdt_cache
+    struct alc_recon_track* video_fdt_recon_track;
+    struct alc_recon_track* audio_fdt_recon_track;
+    struct atsc3_fdt_cache* atsc3_fdt_cache;
+
+    //SLS objects on TSI 0, the S-TSID is parsed out of each new bundle onto lls_alc_session
+    struct alc_recon_track* sls_recon_track;
+    //TOI 0 EFDT on TSI 0, announces the Content-Encoding of the SLS objects
+    struct alc_recon_track* sls_fdt_recon_track;
+    //set when a new S-TSID was applied, the packet loop rebuilds the flow dispatch table and clears it
+    bool atsc3_route_s_tsid_updated;
+
 } lls_sls_alc_monitor_t;
 
 
@@ -507,6 +549,12 @@ typedef struct lls_slt_monitor {
 
 	lls_table_t* lls_table_slt;
 
+	//published by atsc3_flow_dispatch_rebuild, the previously published table is retired through atsc3_qsbr
+	struct atsc3_flow_dispatch_table* atsc3_flow_dispatch_table;
+
+	//incremented by lls_slt_table_perform_update whenever an SLT update adds or removes a session
+	uint32_t lls_slt_sessions_generation;
+
 } lls_slt_monitor_t;
 
 
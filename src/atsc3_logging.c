@@ -0,0 +1,632 @@
+/*
+ * atsc3_logging.c
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: jjustman
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <stddef.h>
+#include <unistd.h>
+#include <pthread.h>
+
+#include "atsc3_logging.h"
+
+int atsc3_log_module_levels[ATSC3_LOG_MODULE_MAX] = { [0 ... ATSC3_LOG_MODULE_MAX - 1] = ATSC3_LOG_LEVEL_DEBUG };
+
+typedef enum {
+	ATSC3_LOG_ARG_INT = 0,
+	ATSC3_LOG_ARG_DOUBLE,
+	ATSC3_LOG_ARG_POINTER,
+	ATSC3_LOG_ARG_STRING
+} atsc3_log_arg_type_t;
+
+typedef enum {
+	ATSC3_LOG_LENGTH_NONE = 0,
+	ATSC3_LOG_LENGTH_HH,
+	ATSC3_LOG_LENGTH_H,
+	ATSC3_LOG_LENGTH_L,
+	ATSC3_LOG_LENGTH_LL,
+	ATSC3_LOG_LENGTH_Z,
+	ATSC3_LOG_LENGTH_J,
+	ATSC3_LOG_LENGTH_T,
+	ATSC3_LOG_LENGTH_LONG_DOUBLE
+} atsc3_log_length_t;
+
+typedef struct atsc3_log_arg {
+	union {
+		int64_t			i;
+		uint64_t		u;
+		double			d;
+		const void*		p;
+		uint32_t		string_offset;
+	};
+} atsc3_log_arg_t;
+
+typedef struct atsc3_log_record {
+	const char*			file;
+	const char*			format;
+	int					line;
+	uint8_t				level;
+	uint8_t				module;
+	uint8_t				args_n;
+	bool				truncated;
+	uint16_t			strings_used;
+	atsc3_log_arg_t		args[ATSC3_LOG_RECORD_ARGS_MAX];
+	char				strings[ATSC3_LOG_RECORD_STRINGS_MAX];
+} atsc3_log_record_t;
+
+typedef struct atsc3_log_ring {
+	uint32_t				head;		//written by the producing thread only
+	uint32_t				tail;		//written by the writer thread only
+	uint64_t				dropped;
+	uint64_t				truncated;
+	bool					orphaned;	//producing thread has exited
+	struct atsc3_log_ring*	next;
+	atsc3_log_record_t		records[ATSC3_LOG_RING_RECORDS];
+} atsc3_log_ring_t;
+
+//one conversion specification, e.g. %-10.*llu
+typedef struct atsc3_log_format_spec {
+	const char*			start;
+	const char*			end;		//one past the conversion character
+	bool				star_width;
+	bool				star_precision;
+	atsc3_log_length_t	length;
+	char				conversion;
+} atsc3_log_format_spec_t;
+
+static FILE* atsc3_log_output = NULL;
+
+static pthread_mutex_t atsc3_log_rings_mutex = PTHREAD_MUTEX_INITIALIZER;
+static atsc3_log_ring_t* atsc3_log_rings = NULL;
+static uint32_t atsc3_log_rings_n = 0;
+static uint64_t atsc3_log_rings_released_dropped = 0;
+static uint64_t atsc3_log_rings_released_truncated = 0;
+
+static pthread_key_t atsc3_log_ring_key;
+static pthread_once_t atsc3_log_ring_key_once = PTHREAD_ONCE_INIT;
+static __thread atsc3_log_ring_t* atsc3_log_ring_tls = NULL;
+
+static pthread_t atsc3_log_writer_thread_id;
+static bool atsc3_log_writer_running = false;
+static uint64_t atsc3_log_records_written = 0;
+
+void atsc3_log_module_level_set(atsc3_log_module_t module, int level) {
+	if(module < ATSC3_LOG_MODULE_MAX) {
+		atsc3_log_module_levels[module] = level;
+	}
+}
+
+int atsc3_log_module_level_get(atsc3_log_module_t module) {
+	return module < ATSC3_LOG_MODULE_MAX ? atsc3_log_module_levels[module] : ATSC3_LOG_LEVEL_NONE;
+}
+
+void atsc3_log_output_set(FILE* output) {
+	atsc3_log_output = output;
+}
+
+const char* atsc3_log_level_name(int level) {
+	switch(level) {
+		case ATSC3_LOG_LEVEL_TRACE:
+			return "TRACE";
+		case ATSC3_LOG_LEVEL_DEBUG:
+			return "DEBUG";
+		case ATSC3_LOG_LEVEL_INFO:
+			return "INFO";
+		case ATSC3_LOG_LEVEL_WARN:
+			return "WARN";
+		case ATSC3_LOG_LEVEL_ERROR:
+			return "ERROR";
+		default:
+			return "NONE";
+	}
+}
+
+static void atsc3_log_emit(const char* line) {
+	if(atsc3_log_output) {
+		fputs(line, atsc3_log_output);
+	} else {
+		printf("%s", line);
+	}
+}
+
+static int atsc3_log_prefix(char* buf, size_t buf_len, const char* file, int line, int level) {
+	int ret = snprintf(buf, buf_len, "%s:%d:%s:", file, line, atsc3_log_level_name(level));
+	if(ret < 0) {
+		return 0;
+	}
+	return (size_t)ret < buf_len ? ret : (int)buf_len - 1;
+}
+
+/**
+ * parse one conversion specification starting at the '%', this must be the same walk for
+ * capture (producer) and render (writer) so the stored args line up
+ */
+static const char* atsc3_log_format_spec_parse(const char* p, atsc3_log_format_spec_t* spec) {
+	memset(spec, 0, sizeof(atsc3_log_format_spec_t));
+	spec->start = p++;
+
+	while(*p && strchr("-+ #0'", *p)) {
+		p++;
+	}
+
+	if(*p == '*') {
+		spec->star_width = true;
+		p++;
+	} else {
+		while(*p >= '0' && *p <= '9') {
+			p++;
+		}
+	}
+
+	if(*p == '.') {
+		p++;
+		if(*p == '*') {
+			spec->star_precision = true;
+			p++;
+		} else {
+			while(*p >= '0' && *p <= '9') {
+				p++;
+			}
+		}
+	}
+
+	switch(*p) {
+		case 'h':
+			p++;
+			if(*p == 'h') {
+				spec->length = ATSC3_LOG_LENGTH_HH;
+				p++;
+			} else {
+				spec->length = ATSC3_LOG_LENGTH_H;
+			}
+			break;
+		case 'l':
+			p++;
+			if(*p == 'l') {
+				spec->length = ATSC3_LOG_LENGTH_LL;
+				p++;
+			} else {
+				spec->length = ATSC3_LOG_LENGTH_L;
+			}
+			break;
+		case 'q':
+			spec->length = ATSC3_LOG_LENGTH_LL;
+			p++;
+			break;
+		case 'z':
+			spec->length = ATSC3_LOG_LENGTH_Z;
+			p++;
+			break;
+		case 'j':
+			spec->length = ATSC3_LOG_LENGTH_J;
+			p++;
+			break;
+		case 't':
+			spec->length = ATSC3_LOG_LENGTH_T;
+			p++;
+			break;
+		case 'L':
+			spec->length = ATSC3_LOG_LENGTH_LONG_DOUBLE;
+			p++;
+			break;
+	}
+
+	spec->conversion = *p;
+	if(*p) {
+		p++;
+	}
+	spec->end = p;
+
+	return p;
+}
+
+static atsc3_log_arg_type_t atsc3_log_format_spec_arg_type(atsc3_log_format_spec_t* spec) {
+	switch(spec->conversion) {
+		case 'f': case 'F': case 'e': case 'E': case 'g': case 'G': case 'a': case 'A':
+			return ATSC3_LOG_ARG_DOUBLE;
+		case 'p':
+			return ATSC3_LOG_ARG_POINTER;
+		case 's':
+			return spec->length == ATSC3_LOG_LENGTH_L ? ATSC3_LOG_ARG_POINTER : ATSC3_LOG_ARG_STRING;
+		default:
+			return ATSC3_LOG_ARG_INT;
+	}
+}
+
+static bool atsc3_log_format_spec_is_signed(atsc3_log_format_spec_t* spec) {
+	return spec->conversion == 'd' || spec->conversion == 'i' || spec->conversion == 'c';
+}
+
+static bool atsc3_log_record_push_int(atsc3_log_record_t* record, int64_t value) {
+	if(record->args_n == ATSC3_LOG_RECORD_ARGS_MAX) {
+		record->truncated = true;
+		return false;
+	}
+	record->args[record->args_n++].i = value;
+	return true;
+}
+
+//capture the raw argument values for format, no formatting happens here
+static void atsc3_log_record_capture(atsc3_log_record_t* record, const char* format, va_list args) {
+	const char* p = format;
+	atsc3_log_format_spec_t spec;
+
+	while(*p && !record->truncated) {
+		if(*p != '%') {
+			p++;
+			continue;
+		}
+		if(p[1] == '%') {
+			p += 2;
+			continue;
+		}
+
+		p = atsc3_log_format_spec_parse(p, &spec);
+		if(!spec.conversion || spec.conversion == 'n') {
+			record->truncated = true;
+			break;
+		}
+
+		if(spec.star_width && !atsc3_log_record_push_int(record, va_arg(args, int))) {
+			break;
+		}
+		if(spec.star_precision && !atsc3_log_record_push_int(record, va_arg(args, int))) {
+			break;
+		}
+
+		if(record->args_n == ATSC3_LOG_RECORD_ARGS_MAX) {
+			record->truncated = true;
+			break;
+		}
+		atsc3_log_arg_t* arg = &record->args[record->args_n];
+
+		switch(atsc3_log_format_spec_arg_type(&spec)) {
+			case ATSC3_LOG_ARG_DOUBLE:
+				arg->d = spec.length == ATSC3_LOG_LENGTH_LONG_DOUBLE ? (double)va_arg(args, long double) : va_arg(args, double);
+				break;
+
+			case ATSC3_LOG_ARG_POINTER:
+				arg->p = va_arg(args, const void*);
+				break;
+
+			case ATSC3_LOG_ARG_STRING: {
+				const char* str = va_arg(args, const char*);
+				if(!str) {
+					str = "(null)";
+				}
+				size_t remaining = ATSC3_LOG_RECORD_STRINGS_MAX - record->strings_used;
+				size_t str_len = strlen(str);
+				if(!remaining) {
+					record->truncated = true;
+					return;
+				}
+				if(str_len >= remaining) {
+					str_len = remaining - 1;
+					record->truncated = true;
+				}
+				memcpy(&record->strings[record->strings_used], str, str_len);
+				record->strings[record->strings_used + str_len] = '\0';
+				arg->string_offset = record->strings_used;
+				record->strings_used += str_len + 1;
+				break;
+			}
+
+			case ATSC3_LOG_ARG_INT:
+			default:
+				switch(spec.length) {
+					case ATSC3_LOG_LENGTH_L:
+						arg->i = atsc3_log_format_spec_is_signed(&spec) ? (int64_t)va_arg(args, long) : (int64_t)va_arg(args, unsigned long);
+						break;
+					case ATSC3_LOG_LENGTH_LL:
+						arg->i = atsc3_log_format_spec_is_signed(&spec) ? (int64_t)va_arg(args, long long) : (int64_t)va_arg(args, unsigned long long);
+						break;
+					case ATSC3_LOG_LENGTH_Z:
+						arg->u = va_arg(args, size_t);
+						break;
+					case ATSC3_LOG_LENGTH_J:
+						arg->i = va_arg(args, intmax_t);
+						break;
+					case ATSC3_LOG_LENGTH_T:
+						arg->i = va_arg(args, ptrdiff_t);
+						break;
+					default:
+						arg->i = atsc3_log_format_spec_is_signed(&spec) ? (int64_t)va_arg(args, int) : (int64_t)va_arg(args, unsigned int);
+						break;
+				}
+				break;
+		}
+		record->args_n++;
+	}
+}
+
+//format a single conversion with its stored argument(s), returns chars written
+static int atsc3_log_render_spec(char* out, size_t out_len, atsc3_log_format_spec_t* spec, atsc3_log_record_t* record, uint8_t* arg_index) {
+	char spec_str[32];
+	size_t spec_len = spec->end - spec->start;
+	int star[2];
+	int stars_n = 0;
+
+	if(spec_len >= sizeof(spec_str)) {
+		return 0;
+	}
+	memcpy(spec_str, spec->start, spec_len);
+	spec_str[spec_len] = '\0';
+
+	//doubles are stored narrowed, drop the L modifier
+	if(spec->length == ATSC3_LOG_LENGTH_LONG_DOUBLE) {
+		char* l = strrchr(spec_str, 'L');
+		if(l) {
+			memmove(l, l + 1, strlen(l));
+		}
+	}
+
+	if(spec->star_width) {
+		star[stars_n++] = (int)record->args[(*arg_index)++].i;
+	}
+	if(spec->star_precision) {
+		star[stars_n++] = (int)record->args[(*arg_index)++].i;
+	}
+
+	atsc3_log_arg_t* arg = &record->args[(*arg_index)++];
+
+#define __ATSC3_LOG_RENDER(value) 	(stars_n == 2 ? snprintf(out, out_len, spec_str, star[0], star[1], value) : \
+									 stars_n == 1 ? snprintf(out, out_len, spec_str, star[0], value) : \
+									 snprintf(out, out_len, spec_str, value))
+
+	switch(atsc3_log_format_spec_arg_type(spec)) {
+		case ATSC3_LOG_ARG_DOUBLE:
+			return __ATSC3_LOG_RENDER(arg->d);
+		case ATSC3_LOG_ARG_POINTER:
+			if(spec->conversion == 's') {
+				return snprintf(out, out_len, "(wstr)");
+			}
+			return __ATSC3_LOG_RENDER(arg->p);
+		case ATSC3_LOG_ARG_STRING:
+			return __ATSC3_LOG_RENDER(&record->strings[arg->string_offset]);
+		case ATSC3_LOG_ARG_INT:
+		default:
+			switch(spec->length) {
+				case ATSC3_LOG_LENGTH_L:
+					return atsc3_log_format_spec_is_signed(spec) ? __ATSC3_LOG_RENDER((long)arg->i) : __ATSC3_LOG_RENDER((unsigned long)arg->u);
+				case ATSC3_LOG_LENGTH_LL:
+					return atsc3_log_format_spec_is_signed(spec) ? __ATSC3_LOG_RENDER((long long)arg->i) : __ATSC3_LOG_RENDER((unsigned long long)arg->u);
+				case ATSC3_LOG_LENGTH_Z:
+					return __ATSC3_LOG_RENDER((size_t)arg->u);
+				case ATSC3_LOG_LENGTH_J:
+					return __ATSC3_LOG_RENDER((intmax_t)arg->i);
+				case ATSC3_LOG_LENGTH_T:
+					return __ATSC3_LOG_RENDER((ptrdiff_t)arg->i);
+				default:
+					return atsc3_log_format_spec_is_signed(spec) ? __ATSC3_LOG_RENDER((int)arg->i) : __ATSC3_LOG_RENDER((unsigned int)arg->u);
+			}
+	}
+#undef __ATSC3_LOG_RENDER
+}
+
+static void atsc3_log_record_render(atsc3_log_record_t* record, char* line, size_t line_len) {
+	size_t pos = atsc3_log_prefix(line, line_len, record->file, record->line, record->level);
+	const char* p = record->format;
+	uint8_t arg_index = 0;
+	atsc3_log_format_spec_t spec;
+
+	//leave room for the trailing "...\r\n"
+	size_t line_max = line_len - 6;
+
+	while(*p && pos < line_max) {
+		if(*p != '%') {
+			line[pos++] = *p++;
+			continue;
+		}
+		if(p[1] == '%') {
+			line[pos++] = '%';
+			p += 2;
+			continue;
+		}
+
+		p = atsc3_log_format_spec_parse(p, &spec);
+		uint8_t args_needed = 1 + spec.star_width + spec.star_precision;
+		if(!spec.conversion || spec.conversion == 'n' || arg_index + args_needed > record->args_n) {
+			break;
+		}
+
+		int ret = atsc3_log_render_spec(&line[pos], line_max - pos, &spec, record, &arg_index);
+		if(ret > 0) {
+			pos += (size_t)ret < line_max - pos ? (size_t)ret : line_max - pos - 1;
+		}
+	}
+
+	if(record->truncated || *p) {
+		memcpy(&line[pos], "...", 3);
+		pos += 3;
+	}
+	memcpy(&line[pos], "\r\n", 3);
+}
+
+static void atsc3_log_ring_key_destructor(void* ring_ptr) {
+	atsc3_log_ring_t* atsc3_log_ring = (atsc3_log_ring_t*)ring_ptr;
+	__atomic_store_n(&atsc3_log_ring->orphaned, true, __ATOMIC_RELEASE);
+}
+
+static void atsc3_log_ring_key_create() {
+	pthread_key_create(&atsc3_log_ring_key, atsc3_log_ring_key_destructor);
+}
+
+static atsc3_log_ring_t* atsc3_log_ring_get_or_create() {
+	if(atsc3_log_ring_tls) {
+		return atsc3_log_ring_tls;
+	}
+
+	atsc3_log_ring_t* atsc3_log_ring = (atsc3_log_ring_t*)calloc(1, sizeof(atsc3_log_ring_t));
+	if(!atsc3_log_ring) {
+		return NULL;
+	}
+
+	pthread_once(&atsc3_log_ring_key_once, atsc3_log_ring_key_create);
+	pthread_setspecific(atsc3_log_ring_key, atsc3_log_ring);
+
+	pthread_mutex_lock(&atsc3_log_rings_mutex);
+	atsc3_log_ring->next = atsc3_log_rings;
+	atsc3_log_rings = atsc3_log_ring;
+	atsc3_log_rings_n++;
+	pthread_mutex_unlock(&atsc3_log_rings_mutex);
+
+	atsc3_log_ring_tls = atsc3_log_ring;
+	return atsc3_log_ring;
+}
+
+static void atsc3_log_write_sync(int level, const char* file, int line, const char* format, va_list args) {
+	char line_buf[ATSC3_LOG_LINE_MAX];
+	size_t pos = atsc3_log_prefix(line_buf, sizeof(line_buf), file, line, level);
+
+	int ret = vsnprintf(&line_buf[pos], sizeof(line_buf) - pos - 2, format, args);
+	if(ret > 0) {
+		pos += (size_t)ret < sizeof(line_buf) - pos - 2 ? (size_t)ret : sizeof(line_buf) - pos - 3;
+	}
+	memcpy(&line_buf[pos], "\r\n", 3);
+	atsc3_log_emit(line_buf);
+}
+
+void atsc3_log_write(atsc3_log_module_t module, int level, const char* file, int line, const char* format, ...) {
+	va_list args;
+	va_start(args, format);
+
+	atsc3_log_ring_t* atsc3_log_ring = NULL;
+	if(!__atomic_load_n(&atsc3_log_writer_running, __ATOMIC_ACQUIRE) || !(atsc3_log_ring = atsc3_log_ring_get_or_create())) {
+		atsc3_log_write_sync(level, file, line, format, args);
+		va_end(args);
+		return;
+	}
+
+	uint32_t head = atsc3_log_ring->head;
+	uint32_t tail = __atomic_load_n(&atsc3_log_ring->tail, __ATOMIC_ACQUIRE);
+	if(head - tail >= ATSC3_LOG_RING_RECORDS) {
+		__atomic_fetch_add(&atsc3_log_ring->dropped, 1, __ATOMIC_RELAXED);
+		va_end(args);
+		return;
+	}
+
+	atsc3_log_record_t* record = &atsc3_log_ring->records[head & (ATSC3_LOG_RING_RECORDS - 1)];
+	record->file = file;
+	record->format = format;
+	record->line = line;
+	record->level = level;
+	record->module = module;
+	record->args_n = 0;
+	record->truncated = false;
+	record->strings_used = 0;
+
+	atsc3_log_record_capture(record, format, args);
+	va_end(args);
+
+	if(record->truncated) {
+		__atomic_fetch_add(&atsc3_log_ring->truncated, 1, __ATOMIC_RELAXED);
+	}
+
+	__atomic_store_n(&atsc3_log_ring->head, head + 1, __ATOMIC_RELEASE);
+}
+
+//returns the number of records written
+static uint32_t atsc3_log_rings_drain() {
+	char line[ATSC3_LOG_LINE_MAX];
+	uint32_t drained = 0;
+
+	pthread_mutex_lock(&atsc3_log_rings_mutex);
+	atsc3_log_ring_t** atsc3_log_ring_p = &atsc3_log_rings;
+
+	while(*atsc3_log_ring_p) {
+		atsc3_log_ring_t* atsc3_log_ring = *atsc3_log_ring_p;
+		bool orphaned = __atomic_load_n(&atsc3_log_ring->orphaned, __ATOMIC_ACQUIRE);
+		uint32_t tail = atsc3_log_ring->tail;
+		uint32_t head = __atomic_load_n(&atsc3_log_ring->head, __ATOMIC_ACQUIRE);
+
+		for(; tail != head; tail++) {
+			atsc3_log_record_render(&atsc3_log_ring->records[tail & (ATSC3_LOG_RING_RECORDS - 1)], line, sizeof(line));
+			atsc3_log_emit(line);
+			drained++;
+		}
+		__atomic_store_n(&atsc3_log_ring->tail, tail, __ATOMIC_RELEASE);
+
+		//producing thread is gone and everything it wrote before exiting has been drained
+		if(orphaned) {
+			*atsc3_log_ring_p = atsc3_log_ring->next;
+			atsc3_log_rings_released_dropped += atsc3_log_ring->dropped;
+			atsc3_log_rings_released_truncated += atsc3_log_ring->truncated;
+			atsc3_log_rings_n--;
+			free(atsc3_log_ring);
+			continue;
+		}
+		atsc3_log_ring_p = &atsc3_log_ring->next;
+	}
+	pthread_mutex_unlock(&atsc3_log_rings_mutex);
+
+	if(drained) {
+		__atomic_fetch_add(&atsc3_log_records_written, drained, __ATOMIC_RELAXED);
+		if(atsc3_log_output) {
+			fflush(atsc3_log_output);
+		}
+	}
+
+	return drained;
+}
+
+static void* atsc3_log_writer_run_thread(void* arg) {
+	(void)arg;
+
+	while(__atomic_load_n(&atsc3_log_writer_running, __ATOMIC_ACQUIRE)) {
+		if(!atsc3_log_rings_drain()) {
+			usleep(ATSC3_LOG_WRITER_IDLE_USEC);
+		}
+	}
+
+	atsc3_log_rings_drain();
+	return NULL;
+}
+
+int atsc3_log_async_start() {
+	if(__atomic_load_n(&atsc3_log_writer_running, __ATOMIC_ACQUIRE)) {
+		return 0;
+	}
+
+	__atomic_store_n(&atsc3_log_writer_running, true, __ATOMIC_RELEASE);
+	if(pthread_create(&atsc3_log_writer_thread_id, NULL, atsc3_log_writer_run_thread, NULL)) {
+		__atomic_store_n(&atsc3_log_writer_running, false, __ATOMIC_RELEASE);
+		return -1;
+	}
+
+	return 0;
+}
+
+void atsc3_log_async_stop() {
+	if(!__atomic_load_n(&atsc3_log_writer_running, __ATOMIC_ACQUIRE)) {
+		return;
+	}
+
+	__atomic_store_n(&atsc3_log_writer_running, false, __ATOMIC_RELEASE);
+	pthread_join(atsc3_log_writer_thread_id, NULL);
+
+	//anything enqueued after the writer exited
+	atsc3_log_rings_drain();
+}
+
+bool atsc3_log_async_is_running() {
+	return __atomic_load_n(&atsc3_log_writer_running, __ATOMIC_ACQUIRE);
+}
+
+void atsc3_log_statistics_get(atsc3_log_statistics_t* atsc3_log_statistics) {
+	memset(atsc3_log_statistics, 0, sizeof(atsc3_log_statistics_t));
+
+	pthread_mutex_lock(&atsc3_log_rings_mutex);
+	atsc3_log_statistics->records_dropped = atsc3_log_rings_released_dropped;
+	atsc3_log_statistics->records_truncated = atsc3_log_rings_released_truncated;
+	for(atsc3_log_ring_t* atsc3_log_ring = atsc3_log_rings; atsc3_log_ring; atsc3_log_ring = atsc3_log_ring->next) {
+		atsc3_log_statistics->records_dropped += __atomic_load_n(&atsc3_log_ring->dropped, __ATOMIC_RELAXED);
+		atsc3_log_statistics->records_truncated += __atomic_load_n(&atsc3_log_ring->truncated, __ATOMIC_RELAXED);
+	}
+	atsc3_log_statistics->rings_n = atsc3_log_rings_n;
+	pthread_mutex_unlock(&atsc3_log_rings_mutex);
+
+	atsc3_log_statistics->records_written = __atomic_load_n(&atsc3_log_records_written, __ATOMIC_RELAXED);
+}
@@ -0,0 +1,134 @@
+/*
+ * atsc3_logging.h
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: jjustman
+ *
+ * unified logging layer to get printf off the packet path
+ *
+ * 	compile time:	__ATSC3_LOG_MIN_LEVEL (default ATSC3_LOG_LEVEL_DEBUG), levels below it compile to nothing,
+ * 					e.g. -D__ATSC3_LOG_MIN_LEVEL=ATSC3_LOG_LEVEL_INFO for production receivers
+ *
+ * 	runtime:		per-module minimum level, atsc3_log_module_level_set(ATSC3_LOG_MODULE_MMTP, ATSC3_LOG_LEVEL_TRACE)
+ *
+ * 	async:			after atsc3_log_async_start(), each producing thread appends fixed size records to its own
+ * 					single-producer/single-consumer ring: the format pointer (must be a string literal) and the raw
+ * 					argument values, %s arguments are copied inline. a background writer drains all rings,
+ * 					formats and writes the lines. when a ring is full the record is dropped and counted,
+ * 					the packet path never blocks on stdout.
+ *
+ * 					without atsc3_log_async_start(), records are formatted and written synchronously as before.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdarg.h>
+
+#ifndef ATSC3_LOGGING_H_
+#define ATSC3_LOGGING_H_
+
+#if defined (__cplusplus)
+extern "C" {
+#endif
+
+#define ATSC3_LOG_LEVEL_TRACE	0
+#define ATSC3_LOG_LEVEL_DEBUG	1
+#define ATSC3_LOG_LEVEL_INFO	2
+#define ATSC3_LOG_LEVEL_WARN	3
+#define ATSC3_LOG_LEVEL_ERROR	4
+#define ATSC3_LOG_LEVEL_NONE	5
+
+#ifndef __ATSC3_LOG_MIN_LEVEL
+#define __ATSC3_LOG_MIN_LEVEL ATSC3_LOG_LEVEL_DEBUG
+#endif
+
+typedef enum {
+	ATSC3_LOG_MODULE_LISTENER = 0,
+	ATSC3_LOG_MODULE_MMTP,
+	ATSC3_LOG_MODULE_MPU,
+	ATSC3_LOG_MODULE_MMT_MPU,
+	ATSC3_LOG_MODULE_ALC_RX,
+	ATSC3_LOG_MODULE_AF_PACKET_CAPTURE,
+	ATSC3_LOG_MODULE_MULTICAST_RECEIVER,
+	ATSC3_LOG_MODULE_RAPTORQ,
+	ATSC3_LOG_MODULE_ISOBMFF_CMAF_CHUNK,
+	ATSC3_LOG_MODULE_FLOW_DISPATCH,
+	ATSC3_LOG_MODULE_QSBR,
+	ATSC3_LOG_MODULE_ROUTE_S_TSID_PARSER,
+	ATSC3_LOG_MODULE_MAX
+} atsc3_log_module_t;
+
+#define ATSC3_LOG_RING_RECORDS			1024	//per thread, power of 2
+#define ATSC3_LOG_RECORD_ARGS_MAX		16
+#define ATSC3_LOG_RECORD_STRINGS_MAX	128
+#define ATSC3_LOG_LINE_MAX				1024
+#define ATSC3_LOG_WRITER_IDLE_USEC		1000
+
+extern int atsc3_log_module_levels[ATSC3_LOG_MODULE_MAX];
+
+typedef struct atsc3_log_statistics {
+	uint64_t	records_written;
+	uint64_t	records_dropped;
+	uint64_t	records_truncated;	//too many args or inline %s bytes
+	uint32_t	rings_n;
+} atsc3_log_statistics_t;
+
+void atsc3_log_module_level_set(atsc3_log_module_t module, int level);
+int atsc3_log_module_level_get(atsc3_log_module_t module);
+
+//NULL writes through printf, e.g. for the debug.log redirection in atsc3_logging_externs.c
+void atsc3_log_output_set(FILE* output);
+
+int atsc3_log_async_start();
+//drains every ring before returning
+void atsc3_log_async_stop();
+bool atsc3_log_async_is_running();
+
+void atsc3_log_statistics_get(atsc3_log_statistics_t* atsc3_log_statistics);
+
+const char* atsc3_log_level_name(int level);
+
+void atsc3_log_write(atsc3_log_module_t module, int level, const char* file, int line, const char* format, ...)
+#if defined(__GNUC__)
+	__attribute__((format(printf, 5, 6)))
+#endif
+;
+
+#if defined (__cplusplus)
+}
+#endif
+
+#define __ATSC3_LOG(module, level, ...) do { if((level) >= atsc3_log_module_levels[module]) { atsc3_log_write(module, level, __FILE__, __LINE__, __VA_ARGS__); } } while(0)
+
+#if __ATSC3_LOG_MIN_LEVEL <= ATSC3_LOG_LEVEL_TRACE
+#define __ATSC3_LOG_TRACE(module, ...) __ATSC3_LOG(module, ATSC3_LOG_LEVEL_TRACE, __VA_ARGS__)
+#else
+#define __ATSC3_LOG_TRACE(module, ...)
+#endif
+
+#if __ATSC3_LOG_MIN_LEVEL <= ATSC3_LOG_LEVEL_DEBUG
+#define __ATSC3_LOG_DEBUG(module, ...) __ATSC3_LOG(module, ATSC3_LOG_LEVEL_DEBUG, __VA_ARGS__)
+#else
+#define __ATSC3_LOG_DEBUG(module, ...)
+#endif
+
+#if __ATSC3_LOG_MIN_LEVEL <= ATSC3_LOG_LEVEL_INFO
+#define __ATSC3_LOG_INFO(module, ...) __ATSC3_LOG(module, ATSC3_LOG_LEVEL_INFO, __VA_ARGS__)
+#else
+#define __ATSC3_LOG_INFO(module, ...)
+#endif
+
+#if __ATSC3_LOG_MIN_LEVEL <= ATSC3_LOG_LEVEL_WARN
+#define __ATSC3_LOG_WARN(module, ...) __ATSC3_LOG(module, ATSC3_LOG_LEVEL_WARN, __VA_ARGS__)
+#else
+#define __ATSC3_LOG_WARN(module, ...)
+#endif
+
+#if __ATSC3_LOG_MIN_LEVEL <= ATSC3_LOG_LEVEL_ERROR
+#define __ATSC3_LOG_ERROR(module, ...) __ATSC3_LOG(module, ATSC3_LOG_LEVEL_ERROR, __VA_ARGS__)
+#else
+#define __ATSC3_LOG_ERROR(module, ...)
+#endif
+
+#endif /* ATSC3_LOGGING_H_ */
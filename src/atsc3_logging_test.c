@@ -0,0 +1,104 @@
+/*
+ *
+ * atsc3_logging_test.c:  driver for the async logging rings, deferred formatting and drop counter
+ *
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <unistd.h>
+
+#include "atsc3_logging.h"
+
+#define __TEST_THREADS 4
+#define __TEST_RECORDS_PER_THREAD 50000
+
+int test_logging_sync_and_async_format_match();
+int test_logging_multiple_producers_with_drops();
+
+int main() {
+	int failed = 0;
+
+	failed += test_logging_sync_and_async_format_match();
+	failed += test_logging_multiple_producers_with_drops();
+
+	printf("atsc3_logging_test: %s\n", failed ? "FAILED" : "OK");
+	return failed;
+}
+
+static void __log_format_cases() {
+	const char* str = "tsi";
+	const char* null_str = getenv("__ATSC3_LOGGING_TEST_UNSET");
+	__ATSC3_LOG_INFO(ATSC3_LOG_MODULE_LISTENER, "codepoint: %hhu, cci: %u, %s: %-6u|, toi: %llu, len: %zu",
+			(uint8_t)300, 0xdeadbeef, str, 3000, 18446744073709551615ULL, (size_t)1514);
+	__ATSC3_LOG_WARN(ATSC3_LOG_MODULE_MMTP, "packet_id: %5d, neg: %ld, hex: 0x%08x, pct: 100%%, f: %.3f, star: %*d|%.*s|", 35, -42L, 0xbeef, 3.14159, 4, 7, 2, "abcdef");
+	__ATSC3_LOG_ERROR(ATSC3_LOG_MODULE_MPU, "null str: %s, char: %c", null_str, 'x');
+}
+
+int test_logging_sync_and_async_format_match() {
+	char* sync_buf = NULL;
+	char* async_buf = NULL;
+	size_t sync_len = 0;
+	size_t async_len = 0;
+
+	FILE* sync_output = open_memstream(&sync_buf, &sync_len);
+	atsc3_log_output_set(sync_output);
+	__log_format_cases();
+	fclose(sync_output);
+
+	FILE* async_output = open_memstream(&async_buf, &async_len);
+	atsc3_log_output_set(async_output);
+	atsc3_log_async_start();
+	__log_format_cases();
+	atsc3_log_async_stop();
+	fclose(async_output);
+	atsc3_log_output_set(NULL);
+
+	int ret = (sync_len != async_len || strcmp(sync_buf, async_buf));
+	if(ret) {
+		printf("test_logging_sync_and_async_format_match: mismatch\nsync:\n%s\nasync:\n%s\n", sync_buf, async_buf);
+	}
+
+	free(sync_buf);
+	free(async_buf);
+	return ret;
+}
+
+static void* __log_producer_thread(void* arg) {
+	for(int i = 0; i < __TEST_RECORDS_PER_THREAD; i++) {
+		__ATSC3_LOG_DEBUG(ATSC3_LOG_MODULE_ALC_RX, "producer: %lu, record: %d", (unsigned long)(uintptr_t)arg, i);
+	}
+	return NULL;
+}
+
+int test_logging_multiple_producers_with_drops() {
+	pthread_t threads[__TEST_THREADS];
+	atsc3_log_statistics_t before;
+	atsc3_log_statistics_t after;
+
+	FILE* devnull = fopen("/dev/null", "w");
+	atsc3_log_output_set(devnull);
+	atsc3_log_statistics_get(&before);
+	atsc3_log_async_start();
+
+	for(uintptr_t i = 0; i < __TEST_THREADS; i++) {
+		pthread_create(&threads[i], NULL, __log_producer_thread, (void*)i);
+	}
+	for(int i = 0; i < __TEST_THREADS; i++) {
+		pthread_join(threads[i], NULL);
+	}
+
+	atsc3_log_async_stop();
+	atsc3_log_statistics_get(&after);
+	atsc3_log_output_set(NULL);
+	fclose(devnull);
+
+	uint64_t written = after.records_written - before.records_written;
+	uint64_t dropped = after.records_dropped - before.records_dropped;
+
+	printf("test_logging_multiple_producers_with_drops: written: %llu, dropped: %llu, rings: %u\n", (unsigned long long)written, (unsigned long long)dropped, after.rings_n);
+
+	//every record is either written or counted as dropped, and exited producer rings are released
+	return (written + dropped != __TEST_THREADS * __TEST_RECORDS_PER_THREAD) || after.rings_n > before.rings_n;
+}
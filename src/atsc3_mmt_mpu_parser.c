@@ -11,11 +11,19 @@
 
 #include "atsc3_mmtp_types.h"
 #include "atsc3_mmtp_parser.h"
+#include "atsc3_mmtp_header_decoder.h"
 #include "atsc3_mmt_mpu_parser.h"
 
-int _MPU_DEBUG_ENABLED = 1;
+int _MPU_DEBUG_ENABLED = 0;
 int _MPU_TRACE_ENABLED = 0;
 
+mpu_retention_policy_t mpu_retention_policy = { MPU_RETENTION_DEFAULT_MAX_MPUS_PER_SUB_FLOW, MPU_RETENTION_DEFAULT_MAX_AGE_MS, MPU_RETENTION_DEFAULT_MAX_BYTES_HELD };
+mpu_retention_stats_t  mpu_retention_stats;
+
+//global list of retained MPUs across all sub-flows, oldest first
+static mpu_retention_entry_t* mpu_retention_global_head = NULL;
+static mpu_retention_entry_t* mpu_retention_global_tail = NULL;
+
 uint8_t* mmt_mpu_parse_payload(mmtp_sub_flow_vector_t* mmtp_sub_flow_vector, mmtp_payload_fragments_union_t* mmtp_packet_header, uint8_t* udp_raw_buf, int udp_raw_buf_size) {
 
 	mmtp_sub_flow_t *mmtp_sub_flow = NULL;
@@ -38,84 +46,49 @@ uint8_t* mmt_mpu_parse_payload(mmtp_sub_flow_vector_t* mmtp_sub_flow_vector, mmt
 	mmtp_sub_flow = mmtp_sub_flow_vector_get_or_set_packet_id(mmtp_sub_flow_vector, mmtp_packet_header->mmtp_packet_header.mmtp_packet_id);
 	_MPU_DEBUG("mmtp_demuxer - mmtp_sub_flow is: %p, mmtp_sub_flow->mpu_fragments: %p", mmtp_sub_flow, mmtp_sub_flow->mpu_fragments);
 
-	//push this to
-	//if our header extension length is set, then block (uint8_t*)extract the header extension length, adn we should be at our payload data
-	uint8_t *mmtp_header_extension_value = NULL;
-
-	if(mmtp_packet_header->mmtp_packet_header.mmtp_header_extension_flag & 0x1) {
-		//clamp mmtp_header_extension_length
-		mmtp_packet_header->mmtp_packet_header.mmtp_header_extension_length = MIN(mmtp_packet_header->mmtp_packet_header.mmtp_header_extension_length, 2^16);
-
-		_MPU_DEBUG( "mmtp_header_extension_flag, header extension size: %d, packet version: %d, payload_type: 0x%X, packet_id 0x%hu, timestamp: 0x%X, packet_sequence_number: 0x%X, packet_counter: 0x%X",
-				mmtp_packet_header->mmtp_packet_header.mmtp_packet_version,
-				mmtp_packet_header->mmtp_packet_header.mmtp_header_extension_length,
-				mmtp_packet_header->mmtp_packet_header.mmtp_payload_type,
-				mmtp_packet_header->mmtp_packet_header.mmtp_packet_id,
-				mmtp_packet_header->mmtp_packet_header.mmtp_timestamp,
-				mmtp_packet_header->mmtp_packet_header.packet_sequence_number,
-				mmtp_packet_header->mmtp_packet_header.packet_counter);
-
-		mmtp_packet_header->mmtp_packet_header.mmtp_header_extension_value = (uint8_t*)malloc(mmtp_packet_header->mmtp_packet_header.mmtp_header_extension_length);
-		//read the header extension value up to the extension length field 2^16
-		buf = (uint8_t*)extract(buf, (uint8_t*)&mmtp_packet_header->mmtp_packet_header.mmtp_header_extension_value, mmtp_packet_header->mmtp_packet_header.mmtp_header_extension_length);
-	}
+	//the header extension value, if any, has already been consumed by mmtp_packet_header_parse_from_raw_packet
 
 	if(mmtp_packet_header->mmtp_packet_header.mmtp_payload_type == 0x0) {
 		//VECTOR:  TODO - refactor this into helper method
 
 		//pull the mpu and frag iformation
-
-		uint8_t mpu_payload_length_block[2];
-		uint16_t mpu_payload_length = 0;
-
-		//msg_Warn( p_demux, "buf pos before mpu_payload_length (uint8_t*)extract is: %p", (void *)buf);
-		buf = (uint8_t*)extract(buf, (uint8_t*)&mpu_payload_length_block, 2);
-		mmtp_packet_header->mmtp_mpu_type_packet_header.mpu_payload_length = (mpu_payload_length_block[0] << 8) | mpu_payload_length_block[1];
-		//_MPU_DEBUG( p_demux, "mmtp_demuxer - doing mpu_payload_length: %hu (0x%X 0x%X)",  mpu_payload_length, mpu_payload_length_block[0], mpu_payload_length_block[1]);
-
-		uint8_t mpu_fragmentation_info;
-		//msg_Warn( p_demux, "buf pos before (uint8_t*)extract is: %p", (void *)buf);
-		buf = (uint8_t*)extract(buf, &mpu_fragmentation_info, 1);
-
-		mmtp_packet_header->mmtp_mpu_type_packet_header.mpu_fragment_type = (mpu_fragmentation_info & 0xF0) >> 4;
-		mmtp_packet_header->mmtp_mpu_type_packet_header.mpu_timed_flag = (mpu_fragmentation_info & 0x8) >> 3;
-		mmtp_packet_header->mmtp_mpu_type_packet_header.mpu_fragmentation_indicator = (mpu_fragmentation_info & 0x6) >> 1;
-		mmtp_packet_header->mmtp_mpu_type_packet_header.mpu_aggregation_flag = (mpu_fragmentation_info & 0x1);
-
-
-		_MPU_DEBUG("Mpu fragment type: %d :mmtp_demuxer - mmtp packet: mpu_fragmentation_info is: 0x%x, mpu_fragment_type: 0x%x, mpu_timed_flag: 0x%x, mpu_fragmentation_indicator: 0x%x, mpu_aggregation_flag: 0x%x",
-			mmtp_packet_header->mmtp_mpu_type_packet_header.mpu_fragment_type,
-			mpu_fragmentation_info,
-			mmtp_packet_header->mmtp_mpu_type_packet_header.mpu_fragment_type,
-			mmtp_packet_header->mmtp_mpu_type_packet_header.mpu_timed_flag,
-			mmtp_packet_header->mmtp_mpu_type_packet_header.mpu_fragmentation_indicator,
-			mmtp_packet_header->mmtp_mpu_type_packet_header.mpu_aggregation_flag);
-
-
-
-		uint8_t mpu_fragmentation_counter;
-		//msg_Warn( p_demux, "buf pos before (uint8_t*)extract is: %p", (void *)buf);
-		buf = (uint8_t*)extract(buf, &mpu_fragmentation_counter, 1);
-		mmtp_packet_header->mmtp_mpu_type_packet_header.mpu_fragmentation_counter = mpu_fragmentation_counter;
-
-		//re-fanagle
-		uint8_t mpu_sequence_number_block[4];
-
-		buf = (uint8_t*)extract(buf, (uint8_t*)&mpu_sequence_number_block, 4);
-		mmtp_packet_header->mmtp_mpu_type_packet_header.mpu_sequence_number = (mpu_sequence_number_block[0] << 24)  | (mpu_sequence_number_block[1] <<16) | (mpu_sequence_number_block[2] << 8) | (mpu_sequence_number_block[3]);
-		_MPU_DEBUG("mmtp_demuxer - mmtp packet: mpu_payload_length: %hu (0x%X 0x%X), mpu_fragmentation_counter: %d, mpu_sequence_number: %d",
+		mmt_mpu_payload_header_fixed_t mmt_mpu_payload_header_fixed;
+		uint32_t mpu_payload_header_length = mmt_mpu_payload_header_fixed_decode(buf, udp_raw_buf_size, &mmt_mpu_payload_header_fixed);
+		if(!mpu_payload_header_length) {
+			_MPU_ERROR("mmt_mpu_parse_payload: packet_id: %d, remaining len: %d is too short for the MPU payload header",
+					mmtp_packet_header->mmtp_packet_header.mmtp_packet_id, udp_raw_buf_size);
+			return NULL;
+		}
+		buf += mpu_payload_header_length;
+
+		//copy the MPU payload out of the udp packet once, every data unit below is a zero-copy slice of it
+		block_t* raw_packet = block_Alloc_flags(udp_raw_buf_size, BLOCK_FLAG_NO_ZERO);
+		memcpy(raw_packet->p_buffer, udp_raw_buf, udp_raw_buf_size);
+		raw_packet->i_pos = udp_raw_buf_size;
+		block_Release(&mmtp_packet_header->mmtp_mpu_type_packet_header.raw_packet);
+		mmtp_packet_header->mmtp_mpu_type_packet_header.raw_packet = raw_packet;
+
+		mmtp_packet_header->mmtp_mpu_type_packet_header.mpu_payload_length = mmt_mpu_payload_header_fixed.mpu_payload_length;
+		mmtp_packet_header->mmtp_mpu_type_packet_header.mpu_fragment_type = mmt_mpu_payload_header_fixed.mpu_fragment_type;
+		mmtp_packet_header->mmtp_mpu_type_packet_header.mpu_timed_flag = mmt_mpu_payload_header_fixed.mpu_timed_flag;
+		mmtp_packet_header->mmtp_mpu_type_packet_header.mpu_fragmentation_indicator = mmt_mpu_payload_header_fixed.mpu_fragmentation_indicator;
+		mmtp_packet_header->mmtp_mpu_type_packet_header.mpu_aggregation_flag = mmt_mpu_payload_header_fixed.mpu_aggregation_flag;
+		mmtp_packet_header->mmtp_mpu_type_packet_header.mpu_fragmentation_counter = mmt_mpu_payload_header_fixed.mpu_fragmentation_counter;
+		mmtp_packet_header->mmtp_mpu_type_packet_header.mpu_sequence_number = mmt_mpu_payload_header_fixed.mpu_sequence_number;
+
+		_MPU_DEBUG("mmtp_demuxer - mmtp packet: mpu_payload_length: %hu, mpu_fragment_type: 0x%x, mpu_timed_flag: 0x%x, mpu_fragmentation_indicator: 0x%x, mpu_aggregation_flag: 0x%x, mpu_fragmentation_counter: %d, mpu_sequence_number: %d",
 				mmtp_packet_header->mmtp_mpu_type_packet_header.mpu_payload_length,
-				mpu_payload_length_block[0],
-				mpu_payload_length_block[1],
+				mmtp_packet_header->mmtp_mpu_type_packet_header.mpu_fragment_type,
+				mmtp_packet_header->mmtp_mpu_type_packet_header.mpu_timed_flag,
+				mmtp_packet_header->mmtp_mpu_type_packet_header.mpu_fragmentation_indicator,
+				mmtp_packet_header->mmtp_mpu_type_packet_header.mpu_aggregation_flag,
 				mmtp_packet_header->mmtp_mpu_type_packet_header.mpu_fragmentation_counter,
 				mmtp_packet_header->mmtp_mpu_type_packet_header.mpu_sequence_number);
 
-
-		mpu_fragments_assign_to_payload_vector(mmtp_sub_flow, mmtp_packet_header);
-
 		//VECTOR: assign data unit payload once parsed, eventually replacing processMpuPacket
 
 		int remainingPacketLen = -1;
+		uint32_t data_unit_bytes = 0;
 
 		//todo - if FEC_type != 0, parse out source_FEC_payload_ID trailing bits...
 		do {
@@ -142,13 +115,17 @@ uint8_t* mmt_mpu_parse_payload(mmtp_sub_flow_vector_t* mmtp_sub_flow_vector, mmt
 			if(mmtp_packet_header->mmtp_mpu_type_packet_header.mpu_fragment_type != 0x2) {
 				//read our packet length just as a mpu metadata fragment or movie fragment metadata
 				//read our packet length without any mfu
-				block_t *tmp_mpu_fragment = block_Alloc(to_read_packet_length);
+				block_t *tmp_mpu_fragment = block_Slice(raw_packet, buf - raw_buf, to_read_packet_length);
+				if(!tmp_mpu_fragment) {
+					_MPU_ERROR("mmt_mpu_parse_payload: packet_id: %d, data unit length: %d is past the end of the packet", mmtp_packet_header->mmtp_packet_header.mmtp_packet_id, to_read_packet_length);
+					return NULL;
+				}
 				_MPU_DEBUG("creating tmp_mpu_fragment, setting block_t->i_buffer to: %d", to_read_packet_length);
+				buf += to_read_packet_length;
 
-				buf = (uint8_t*)extract(buf, tmp_mpu_fragment->p_buffer, to_read_packet_length);
-				tmp_mpu_fragment->i_pos = to_read_packet_length;
-
+				block_Release(&mmtp_packet_header->mmtp_mpu_type_packet_header.mpu_data_unit_payload);
 				mmtp_packet_header->mmtp_mpu_type_packet_header.mpu_data_unit_payload = tmp_mpu_fragment;
+				data_unit_bytes += to_read_packet_length;
 
 				remainingPacketLen = udp_raw_buf_size - (buf - raw_buf);
 				//this should only be non-zero if mpu_aggregration_flag=1
@@ -224,14 +201,20 @@ uint8_t* mmt_mpu_parse_payload(mmtp_sub_flow_vector_t* mmtp_sub_flow_vector, mmt
 					//mmtp_packet_header->mpu_data_unit_payload_fragments_timed.pts = pts;
 
 					//112 bits in aggregate, 14 bytes
-					uint8_t timed_mfu_block[14];
-					buf = (uint8_t*)extract(buf, timed_mfu_block, 14);
-
-					mmtp_packet_header->mpu_data_unit_payload_fragments_timed.movie_fragment_sequence_number 	= (timed_mfu_block[0] << 24) | (timed_mfu_block[1] << 16) | (timed_mfu_block[2]  << 8) | (timed_mfu_block[3]);
-					mmtp_packet_header->mpu_data_unit_payload_fragments_timed.sample_number				 	  	= (timed_mfu_block[4] << 24) | (timed_mfu_block[5] << 16) | (timed_mfu_block[6]  << 8) | (timed_mfu_block[7]);
-					mmtp_packet_header->mpu_data_unit_payload_fragments_timed.offset     					  	= (timed_mfu_block[8] << 24) | (timed_mfu_block[9] << 16) | (timed_mfu_block[10] << 8) | (timed_mfu_block[11]);
-					mmtp_packet_header->mpu_data_unit_payload_fragments_timed.priority 							= timed_mfu_block[12];
-					mmtp_packet_header->mpu_data_unit_payload_fragments_timed.dep_counter						= timed_mfu_block[13];
+					mmt_mfu_timed_header_fixed_t mmt_mfu_timed_header_fixed;
+					uint32_t mfu_timed_header_length = mmt_mfu_timed_header_fixed_decode(buf, udp_raw_buf_size - (buf - raw_buf), &mmt_mfu_timed_header_fixed);
+					if(!mfu_timed_header_length) {
+						_MPU_ERROR("mmt_mpu_parse_payload: packet_id: %d, mpu_sequence_number: %u, remaining len: %ld is too short for the timed MFU header",
+								mmtp_packet_header->mmtp_packet_header.mmtp_packet_id, mmtp_packet_header->mmtp_mpu_type_packet_header.mpu_sequence_number, (long)(udp_raw_buf_size - (buf - raw_buf)));
+						return NULL;
+					}
+					buf += mfu_timed_header_length;
+
+					mmtp_packet_header->mpu_data_unit_payload_fragments_timed.movie_fragment_sequence_number 	= mmt_mfu_timed_header_fixed.movie_fragment_sequence_number;
+					mmtp_packet_header->mpu_data_unit_payload_fragments_timed.sample_number				 	  	= mmt_mfu_timed_header_fixed.sample_number;
+					mmtp_packet_header->mpu_data_unit_payload_fragments_timed.offset     					  	= mmt_mfu_timed_header_fixed.offset;
+					mmtp_packet_header->mpu_data_unit_payload_fragments_timed.priority 							= mmt_mfu_timed_header_fixed.priority;
+					mmtp_packet_header->mpu_data_unit_payload_fragments_timed.dep_counter						= mmt_mfu_timed_header_fixed.dep_counter;
 					uint8_t* rewind_buf = buf;
 
                     //see if bento4 will handle this?
@@ -318,14 +301,17 @@ uint8_t* mmt_mpu_parse_payload(mmtp_sub_flow_vector_t* mmtp_sub_flow_vector, mmt
 						buf,
 						raw_buf);
 
-				block_t *tmp_mpu_fragment = block_Alloc(to_read_packet_length);
+				block_t *tmp_mpu_fragment = block_Slice(raw_packet, buf - raw_buf, to_read_packet_length);
+				if(!tmp_mpu_fragment) {
+					_MPU_ERROR("mmt_mpu_parse_payload: packet_id: %d, mfu length: %d is past the end of the packet", mmtp_packet_header->mmtp_packet_header.mmtp_packet_id, to_read_packet_length);
+					return NULL;
+				}
 				_MPU_TRACE("creating tmp_mpu_fragment, setting block_t->i_buffer to: %d", to_read_packet_length);
+				buf += to_read_packet_length;
 
-				buf = (uint8_t*)extract(buf, tmp_mpu_fragment->p_buffer, to_read_packet_length);
-				tmp_mpu_fragment->i_pos = to_read_packet_length;
-
-
+				block_Release(&mmtp_packet_header->mmtp_mpu_type_packet_header.mpu_data_unit_payload);
 				mmtp_packet_header->mmtp_mpu_type_packet_header.mpu_data_unit_payload = tmp_mpu_fragment;
+				data_unit_bytes += to_read_packet_length;
 
 				//send off only the CLEAN mdat payload from our MFU
 				remainingPacketLen = udp_raw_buf_size - (buf - raw_buf);
@@ -334,6 +320,12 @@ uint8_t* mmt_mpu_parse_payload(mmtp_sub_flow_vector_t* mmtp_sub_flow_vector, mmt
 			}
 
 		} while(mmtp_packet_header->mmtp_mpu_type_packet_header.mpu_aggregation_flag && remainingPacketLen>0);
+
+		//only file the packet under its MPU once every data unit has sliced cleanly, on a NULL return the caller frees it
+		mpu_fragments_assign_to_payload_vector(mmtp_sub_flow, mmtp_packet_header);
+		mpu_fragments_retention_add_bytes(mmtp_packet_header, data_unit_bytes);
+
+		mpu_fragments_retention_enforce(mmtp_sub_flow->mpu_fragments, mmtp_packet_header->mmtp_mpu_type_packet_header.mpu_sequence_number);
 	}
 
 	__LOG_TRACE(p_demux, "%d:demux - return", __LINE__);
@@ -361,8 +353,18 @@ void mmtp_sub_flow_mpu_fragments_allocate(mmtp_sub_flow_t* entry) {
 
 
 mpu_data_unit_payload_fragments_t* mpu_data_unit_payload_fragments_find_mpu_sequence_number(mpu_data_unit_payload_fragments_vector_t *vec, uint32_t mpu_sequence_number) {
+	mpu_data_unit_payload_fragments_t *mpu_fragments = vec->mpu_sequence_number_ring[mpu_sequence_number % MPU_SEQUENCE_NUMBER_RING_WINDOW];
+	if(mpu_fragments && mpu_fragments->mpu_sequence_number == mpu_sequence_number) {
+		return mpu_fragments;
+	}
+
+	//only walk the vector if an entry has been pushed out of its ring slot
+	if(!vec->mpu_sequence_number_ring_displaced_n) {
+		return NULL;
+	}
+
 	for (size_t i = 0; i < vec->size; ++i) {
-		mpu_data_unit_payload_fragments_t *mpu_fragments = vec->data[i];
+		mpu_fragments = vec->data[i];
 
 		if (mpu_fragments->mpu_sequence_number == mpu_sequence_number) {
 			return vec->data[i];
@@ -382,11 +384,50 @@ mpu_data_unit_payload_fragments_t* mpu_data_unit_payload_fragments_get_or_set_mp
 		atsc3_vector_init(&entry->timed_fragments_vector);
 		atsc3_vector_init(&entry->nontimed_fragments_vector);
 		atsc3_vector_push(vec, entry);
+
+		//newest mpu_sequence_number wins the slot, as that is the one ingest and reconstitution will ask for next
+		mpu_data_unit_payload_fragments_t** ring_slot = &vec->mpu_sequence_number_ring[entry->mpu_sequence_number % MPU_SEQUENCE_NUMBER_RING_WINDOW];
+		if(*ring_slot) {
+			vec->mpu_sequence_number_ring_displaced_n++;
+			_MPU_DEBUG("mpu_sequence_number ring: mpu_sequence_number: %u displaced %u, displaced_n: %u", entry->mpu_sequence_number, (*ring_slot)->mpu_sequence_number, vec->mpu_sequence_number_ring_displaced_n);
+		}
+		*ring_slot = entry;
 	}
 
 	return entry;
 }
 
+void mpu_data_unit_payload_fragments_remove(mpu_data_unit_payload_fragments_vector_t *vec, mpu_data_unit_payload_fragments_t* mpu_data_unit_payload_fragments) {
+	ssize_t index = -1;
+	atsc3_vector_index_of(vec, mpu_data_unit_payload_fragments, &index);
+	if(index < 0) {
+		return;
+	}
+	atsc3_vector_remove(vec, index);
+
+	uint32_t ring_index = mpu_data_unit_payload_fragments->mpu_sequence_number % MPU_SEQUENCE_NUMBER_RING_WINDOW;
+	mpu_data_unit_payload_fragments_t** ring_slot = &vec->mpu_sequence_number_ring[ring_index];
+	if(*ring_slot != mpu_data_unit_payload_fragments) {
+		if(vec->mpu_sequence_number_ring_displaced_n) {
+			vec->mpu_sequence_number_ring_displaced_n--;
+		}
+		return;
+	}
+	*ring_slot = NULL;
+
+	//re-seat the newest entry this one displaced, so displaced_n drains back to 0 once the window catches up
+	if(!vec->mpu_sequence_number_ring_displaced_n) {
+		return;
+	}
+	for(ssize_t i = (ssize_t)vec->size - 1; i >= 0; i--) {
+		if(vec->data[i]->mpu_sequence_number % MPU_SEQUENCE_NUMBER_RING_WINDOW == ring_index) {
+			*ring_slot = vec->data[i];
+			vec->mpu_sequence_number_ring_displaced_n--;
+			break;
+		}
+	}
+}
+
 
 //push this to mpu_fragments_vector->all_fragments_vector first,
 // 	then re-assign once fragment_type and fragmentation info are parsed
@@ -440,6 +481,16 @@ void mpu_fragments_assign_to_payload_vector(mmtp_sub_flow_t* mmtp_sub_flow, mmtp
 
 
 	if(to_assign_payload_vector) {
+		mpu_retention_entry_t* mpu_retention_entry = mpu_fragments_retention_get_or_set_mpu_sequence_number(mpu_fragments, to_assign_payload_vector->mpu_sequence_number);
+		if(mpu_type_packet->mmtp_mpu_type_packet_header.mpu_fragment_type == 0x00) {
+			mpu_retention_entry->mpu_metadata_fragments = to_assign_payload_vector;
+		} else if(mpu_type_packet->mmtp_mpu_type_packet_header.mpu_fragment_type == 0x01) {
+			mpu_retention_entry->movie_fragment_metadata = to_assign_payload_vector;
+		} else {
+			mpu_retention_entry->media_fragment_unit = to_assign_payload_vector;
+		}
+		mpu_fragments_retention_link_packet(mpu_retention_entry, mpu_type_packet);
+
 		_MPU_DEBUG("%d:mpu_fragments_assign_to_payload_vector: %p - packet_counter: %u, packet_id: %d, sequence_number: %d, fragment type: %d, mpu_fragments is: %p, all_mpu_frags_vector.size: %zu\n", __LINE__, to_assign_payload_vector, mpu_type_packet->mmtp_packet_header.packet_counter, mpu_type_packet->mmtp_mpu_type_packet_header.mmtp_packet_id,  mpu_type_packet->mmtp_mpu_type_packet_header.mpu_sequence_number, mpu_type_packet->mmtp_mpu_type_packet_header.mpu_fragment_type, mpu_fragments, mpu_fragments->all_mpu_fragments_vector.size);
 
 		//__PRINTF_TRACE("%d: to_assign_payload_vector, sequence_number: %d, size is: %zu\n", __LINE__, mpu_type_packet->mmtp_mpu_type_packet_header.mpu_sequence_number, to_assign_payload_vector->timed_fragments_vector.size);
@@ -490,3 +541,267 @@ void mmt_mpu_free_payload(mmtp_payload_fragments_union_t* mmtp_payload_fragments
 	}
 
 }
+
+
+void mpu_retention_policy_set(uint32_t max_mpus_per_sub_flow, uint32_t max_age_ms, uint64_t max_bytes_held) {
+	mpu_retention_policy.max_mpus_per_sub_flow = max_mpus_per_sub_flow;
+	mpu_retention_policy.max_age_ms = max_age_ms;
+	mpu_retention_policy.max_bytes_held = max_bytes_held;
+
+	_MPU_INFO("mpu_retention_policy_set: max_mpus_per_sub_flow: %u, max_age_ms: %u, max_bytes_held: %llu",
+			max_mpus_per_sub_flow, max_age_ms, (unsigned long long)max_bytes_held);
+}
+
+//mpu_sequence_numbers arrive in order, so walk backwards from the newest entry
+mpu_retention_entry_t* mpu_fragments_retention_find_mpu_sequence_number(mpu_fragments_t* mpu_fragments, uint32_t mpu_sequence_number) {
+	mpu_retention_entry_t* mpu_retention_entry = mpu_fragments->mpu_retention_tail;
+	while(mpu_retention_entry) {
+		if(mpu_retention_entry->mpu_sequence_number == mpu_sequence_number) {
+			return mpu_retention_entry;
+		}
+		mpu_retention_entry = mpu_retention_entry->sub_flow_prev;
+	}
+	return NULL;
+}
+
+mpu_retention_entry_t* mpu_fragments_retention_get_or_set_mpu_sequence_number(mpu_fragments_t* mpu_fragments, uint32_t mpu_sequence_number) {
+	mpu_retention_entry_t* mpu_retention_entry = mpu_fragments_retention_find_mpu_sequence_number(mpu_fragments, mpu_sequence_number);
+	if(mpu_retention_entry) {
+		return mpu_retention_entry;
+	}
+
+	mpu_retention_entry = (mpu_retention_entry_t*)calloc(1, sizeof(mpu_retention_entry_t));
+	mpu_retention_entry->mpu_fragments = mpu_fragments;
+	mpu_retention_entry->mpu_sequence_number = mpu_sequence_number;
+	gettimeofday(&mpu_retention_entry->first_received, NULL);
+
+	//append to our sub-flow
+	mpu_retention_entry->sub_flow_prev = mpu_fragments->mpu_retention_tail;
+	if(mpu_fragments->mpu_retention_tail) {
+		mpu_fragments->mpu_retention_tail->sub_flow_next = mpu_retention_entry;
+	} else {
+		mpu_fragments->mpu_retention_head = mpu_retention_entry;
+	}
+	mpu_fragments->mpu_retention_tail = mpu_retention_entry;
+	mpu_fragments->mpu_retention_count++;
+
+	//and to the global list
+	mpu_retention_entry->global_prev = mpu_retention_global_tail;
+	if(mpu_retention_global_tail) {
+		mpu_retention_global_tail->global_next = mpu_retention_entry;
+	} else {
+		mpu_retention_global_head = mpu_retention_entry;
+	}
+	mpu_retention_global_tail = mpu_retention_entry;
+	mpu_retention_stats.mpus_held++;
+
+	return mpu_retention_entry;
+}
+
+//appends the packet to its MPU's retention entry, the entry then owns it until it is evicted or released
+void mpu_fragments_retention_link_packet(mpu_retention_entry_t* mpu_retention_entry, mmtp_payload_fragments_union_t* mpu_type_packet) {
+	if(mpu_type_packet->mmtp_mpu_type_packet_header.mpu_retention_entry) {
+		return;
+	}
+
+	mpu_type_packet->mmtp_mpu_type_packet_header.mpu_retention_entry = mpu_retention_entry;
+	mpu_type_packet->mmtp_mpu_type_packet_header.mpu_retention_prev = mpu_retention_entry->packets_tail;
+	mpu_type_packet->mmtp_mpu_type_packet_header.mpu_retention_next = NULL;
+	if(mpu_retention_entry->packets_tail) {
+		mpu_retention_entry->packets_tail->mmtp_mpu_type_packet_header.mpu_retention_next = mpu_type_packet;
+	} else {
+		mpu_retention_entry->packets_head = mpu_type_packet;
+	}
+	mpu_retention_entry->packets_tail = mpu_type_packet;
+}
+
+void mpu_fragments_retention_add_bytes(mmtp_payload_fragments_union_t* mpu_type_packet, uint32_t bytes) {
+	mpu_retention_entry_t* mpu_retention_entry = mpu_type_packet->mmtp_mpu_type_packet_header.mpu_retention_entry;
+	if(!mpu_retention_entry) {
+		return;
+	}
+
+	mpu_type_packet->mmtp_mpu_type_packet_header.mpu_retention_bytes += bytes;
+	mpu_retention_entry->bytes_held += bytes;
+	mpu_retention_entry->mpu_fragments->bytes_held += bytes;
+	mpu_retention_stats.bytes_held += bytes;
+}
+
+/**
+ * take a packet out of all_mpu_fragments_vector (the last packet is swapped into its slot) and out of its
+ * retention entry, with its bytes.  every path that frees an MPU packet comes through here, see
+ * mmtp_payload_fragments_union_free, so the retention entries and bytes_held never refer to a freed packet.
+ *
+ * the packet is not freed, and stays in its mpu_data_unit_payload_fragments_t vectors
+ */
+void mpu_fragments_retention_release_packet(mpu_fragments_t* mpu_fragments, mmtp_payload_fragments_union_t* mpu_type_packet) {
+	mpu_type_packet_header_fields_vector_t* all_mpu_fragments_vector = &mpu_fragments->all_mpu_fragments_vector;
+	size_t index = mpu_type_packet->mmtp_mpu_type_packet_header.all_mpu_fragments_index;
+
+	//the index is kept current on every push and swap, all_mpu_fragments_vector is never removed from any other way
+	if(index != MPU_FRAGMENTS_INDEX_NONE) {
+		assert(index < all_mpu_fragments_vector->size && all_mpu_fragments_vector->data[index] == mpu_type_packet);
+		atsc3_vector_swap_remove(all_mpu_fragments_vector, index);
+		if(index < all_mpu_fragments_vector->size) {
+			all_mpu_fragments_vector->data[index]->mmtp_mpu_type_packet_header.all_mpu_fragments_index = index;
+		}
+		mpu_type_packet->mmtp_mpu_type_packet_header.all_mpu_fragments_index = MPU_FRAGMENTS_INDEX_NONE;
+	}
+
+	mpu_retention_entry_t* mpu_retention_entry = mpu_type_packet->mmtp_mpu_type_packet_header.mpu_retention_entry;
+	if(!mpu_retention_entry) {
+		return;
+	}
+
+	mmtp_payload_fragments_union_t* prev = mpu_type_packet->mmtp_mpu_type_packet_header.mpu_retention_prev;
+	mmtp_payload_fragments_union_t* next = mpu_type_packet->mmtp_mpu_type_packet_header.mpu_retention_next;
+	if(prev) {
+		prev->mmtp_mpu_type_packet_header.mpu_retention_next = next;
+	} else {
+		mpu_retention_entry->packets_head = next;
+	}
+	if(next) {
+		next->mmtp_mpu_type_packet_header.mpu_retention_prev = prev;
+	} else {
+		mpu_retention_entry->packets_tail = prev;
+	}
+
+	uint32_t bytes = mpu_type_packet->mmtp_mpu_type_packet_header.mpu_retention_bytes;
+	mpu_retention_entry->bytes_held -= bytes;
+	mpu_retention_entry->mpu_fragments->bytes_held -= bytes;
+	mpu_retention_stats.bytes_held -= bytes;
+
+	mpu_type_packet->mmtp_mpu_type_packet_header.mpu_retention_entry = NULL;
+	mpu_type_packet->mmtp_mpu_type_packet_header.mpu_retention_prev = NULL;
+	mpu_type_packet->mmtp_mpu_type_packet_header.mpu_retention_next = NULL;
+	mpu_type_packet->mmtp_mpu_type_packet_header.mpu_retention_bytes = 0;
+}
+
+static void mpu_data_unit_payload_fragments_vector_remove(mpu_data_unit_payload_fragments_vector_t* vec, mpu_data_unit_payload_fragments_t* mpu_data_unit_payload_fragments) {
+	if(!mpu_data_unit_payload_fragments) {
+		return;
+	}
+
+	mpu_data_unit_payload_fragments_remove(vec, mpu_data_unit_payload_fragments);
+
+	//the packets themselves are owned by all_mpu_fragments_vector
+	atsc3_vector_clear(&mpu_data_unit_payload_fragments->timed_fragments_vector);
+	atsc3_vector_clear(&mpu_data_unit_payload_fragments->nontimed_fragments_vector);
+	free(mpu_data_unit_payload_fragments);
+}
+
+/**
+ * drop the media_fragment_unit container once its data units have been cleared, leaving the rest of the MPU retained
+ */
+void mpu_fragments_retention_remove_media_fragment_unit(mpu_retention_entry_t* mpu_retention_entry) {
+	mpu_data_unit_payload_fragments_vector_remove(&mpu_retention_entry->mpu_fragments->media_fragment_unit_vector, mpu_retention_entry->media_fragment_unit);
+	mpu_retention_entry->media_fragment_unit = NULL;
+}
+
+/**
+ * evict a whole MPU: walks only the entry's own packets, each leaving all_mpu_fragments_vector in O(1)
+ *
+ * returns the number of fragments freed
+ */
+int mpu_fragments_retention_evict(mpu_retention_entry_t* mpu_retention_entry) {
+	mpu_fragments_t* mpu_fragments = mpu_retention_entry->mpu_fragments;
+	uint32_t bytes_held = mpu_retention_entry->bytes_held;
+	int evicted_count = 0;
+
+	while(mpu_retention_entry->packets_head) {
+		mmtp_payload_fragments_union_t* packet = mpu_retention_entry->packets_head;
+		mpu_fragments_retention_release_packet(mpu_fragments, packet);
+		mmtp_payload_fragments_union_free(&packet);
+		evicted_count++;
+	}
+	atsc3_vector_autoshrink(&mpu_fragments->all_mpu_fragments_vector);
+
+	mpu_data_unit_payload_fragments_vector_remove(&mpu_fragments->mpu_metadata_fragments_vector, mpu_retention_entry->mpu_metadata_fragments);
+	mpu_data_unit_payload_fragments_vector_remove(&mpu_fragments->movie_fragment_metadata_vector, mpu_retention_entry->movie_fragment_metadata);
+	mpu_data_unit_payload_fragments_vector_remove(&mpu_fragments->media_fragment_unit_vector, mpu_retention_entry->media_fragment_unit);
+
+	//unlink from our sub-flow
+	if(mpu_retention_entry->sub_flow_prev) {
+		mpu_retention_entry->sub_flow_prev->sub_flow_next = mpu_retention_entry->sub_flow_next;
+	} else {
+		mpu_fragments->mpu_retention_head = mpu_retention_entry->sub_flow_next;
+	}
+	if(mpu_retention_entry->sub_flow_next) {
+		mpu_retention_entry->sub_flow_next->sub_flow_prev = mpu_retention_entry->sub_flow_prev;
+	} else {
+		mpu_fragments->mpu_retention_tail = mpu_retention_entry->sub_flow_prev;
+	}
+	mpu_fragments->mpu_retention_count--;
+
+	//and from the global list
+	if(mpu_retention_entry->global_prev) {
+		mpu_retention_entry->global_prev->global_next = mpu_retention_entry->global_next;
+	} else {
+		mpu_retention_global_head = mpu_retention_entry->global_next;
+	}
+	if(mpu_retention_entry->global_next) {
+		mpu_retention_entry->global_next->global_prev = mpu_retention_entry->global_prev;
+	} else {
+		mpu_retention_global_tail = mpu_retention_entry->global_prev;
+	}
+
+	//bytes_held was already given back packet by packet
+	mpu_fragments->bytes_evicted += bytes_held;
+	mpu_fragments->mpus_evicted++;
+
+	mpu_retention_stats.bytes_evicted += bytes_held;
+	mpu_retention_stats.mpus_held--;
+	mpu_retention_stats.mpus_evicted++;
+	mpu_retention_stats.fragments_evicted += evicted_count;
+
+	_MPU_DEBUG("mpu_fragments_retention_evict: packet_id: %u, mpu_sequence_number: %u, fragments: %d, bytes: %u, sub_flow bytes_held: %llu, global bytes_held: %llu",
+			mpu_fragments->mmtp_packet_id,
+			mpu_retention_entry->mpu_sequence_number,
+			evicted_count,
+			bytes_held,
+			(unsigned long long)mpu_fragments->bytes_held,
+			(unsigned long long)mpu_retention_stats.bytes_held);
+
+	free(mpu_retention_entry);
+
+	return evicted_count;
+}
+
+/**
+ * apply mpu_retention_policy after a packet for current_mpu_sequence_number has been parsed,
+ * always evicting the oldest MPU first, either from this sub-flow (count/age) or globally (bytes)
+ *
+ * returns the number of MPUs evicted
+ */
+int mpu_fragments_retention_enforce(mpu_fragments_t* mpu_fragments, uint32_t current_mpu_sequence_number) {
+	int mpus_evicted = 0;
+
+	if(mpu_retention_policy.max_mpus_per_sub_flow) {
+		while(mpu_fragments->mpu_retention_count > mpu_retention_policy.max_mpus_per_sub_flow &&
+			  mpu_fragments->mpu_retention_head->mpu_sequence_number != current_mpu_sequence_number) {
+			mpu_fragments_retention_evict(mpu_fragments->mpu_retention_head);
+			mpus_evicted++;
+		}
+	}
+
+	if(mpu_retention_policy.max_age_ms) {
+		struct timeval now;
+		gettimeofday(&now, NULL);
+		while(mpu_fragments->mpu_retention_head &&
+			  mpu_fragments->mpu_retention_head->mpu_sequence_number != current_mpu_sequence_number &&
+			  timediff(now, mpu_fragments->mpu_retention_head->first_received) > mpu_retention_policy.max_age_ms * 1000LL) {
+			mpu_fragments_retention_evict(mpu_fragments->mpu_retention_head);
+			mpus_evicted++;
+		}
+	}
+
+	if(mpu_retention_policy.max_bytes_held) {
+		while(mpu_retention_stats.bytes_held > mpu_retention_policy.max_bytes_held && mpu_retention_global_head &&
+			  !(mpu_retention_global_head->mpu_fragments == mpu_fragments && mpu_retention_global_head->mpu_sequence_number == current_mpu_sequence_number)) {
+			mpu_fragments_retention_evict(mpu_retention_global_head);
+			mpus_evicted++;
+		}
+	}
+
+	return mpus_evicted;
+}
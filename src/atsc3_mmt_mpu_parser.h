@@ -8,30 +8,63 @@
 #ifndef ATSC3_MMT_MPU_PARSER_H_
 #define ATSC3_MMT_MPU_PARSER_H_
 
+#include "atsc3_logging.h"
 
 #define _MPU_PRINTLN(...) printf(__VA_ARGS__);printf("\r\n")
-#define _MPU_ERROR(...)   printf("%s:%d:ERROR:",__FILE__,__LINE__);_MPU_PRINTLN(__VA_ARGS__);
-#define _MPU_WARN(...)    printf("%s:%d:WARN:",__FILE__,__LINE__);_MPU_PRINTLN(__VA_ARGS__);
-#define _MPU_INFO(...)    printf("%s:%d:INFO:",__FILE__,__LINE__);_MPU_PRINTLN(__VA_ARGS__);
+#define _MPU_ERROR(...)   __ATSC3_LOG_ERROR(ATSC3_LOG_MODULE_MPU, __VA_ARGS__)
+#define _MPU_WARN(...)    __ATSC3_LOG_WARN(ATSC3_LOG_MODULE_MPU, __VA_ARGS__)
+#define _MPU_INFO(...)    __ATSC3_LOG_INFO(ATSC3_LOG_MODULE_MPU, __VA_ARGS__)
 
-#define _MPU_DEBUG(...)   if(_MPU_DEBUG_ENABLED) { printf("%s:%d:DEBUG:",__FILE__,__LINE__);_MPU_PRINTLN(__VA_ARGS__); }
-#define _MPU_TRACE(...)   if(_MPU_TRACE_ENABLED) { printf("%s:%d:TRACE:",__FILE__,__LINE__);_MPU_PRINTLN(__VA_ARGS__); }
+#define _MPU_DEBUG(...)   if(_MPU_DEBUG_ENABLED) { __ATSC3_LOG_DEBUG(ATSC3_LOG_MODULE_MPU, __VA_ARGS__); }
+#define _MPU_TRACE(...)   if(_MPU_TRACE_ENABLED) { __ATSC3_LOG_TRACE(ATSC3_LOG_MODULE_MPU, __VA_ARGS__); }
 
 //packet type=v0/v1 have an upper bound of ~1432
 #define UPPER_BOUND_MPU_FRAGMENT_SIZE 1432
 #define MPU_REASSEMBLE_MAX_BUFFER 8192000
 #define MIN(a,b) (((a)<(b))?(a):(b))
 
+//reconstitution joins mpu_sequence_number - 2, keep a few MPUs of headroom behind that
+#define MPU_RETENTION_DEFAULT_MAX_MPUS_PER_SUB_FLOW	8
+#define MPU_RETENTION_DEFAULT_MAX_AGE_MS			0
+#define MPU_RETENTION_DEFAULT_MAX_BYTES_HELD		(64 * 1024 * 1024)
+
 
 #if defined (__cplusplus)
 extern "C" {
 #endif
 
+/**
+ * MPU retention policy, applied to every packet_id sub-flow from mmt_mpu_parse_payload
+ *
+ * a limit of 0 is unbounded, the policy starts out at the MPU_RETENTION_DEFAULT_* bounds, override
+ * them via mpu_retention_policy_set.  callers that free their own packets with
+ * mmtp_payload_fragments_union_free release them from retention first, so they are never freed twice.
+ *
+ * the MPU of the packet currently being parsed is never evicted.
+ */
+typedef struct mpu_retention_policy {
+	uint32_t max_mpus_per_sub_flow;		//keep the last K mpu_sequence_numbers per packet_id
+	uint32_t max_age_ms;				//keep the MPUs first received within the last T ms
+	uint64_t max_bytes_held;			//global data unit payload budget across all sub-flows
+} mpu_retention_policy_t;
+
+typedef struct mpu_retention_stats {
+	uint64_t bytes_held;
+	uint64_t bytes_evicted;
+	uint32_t mpus_held;
+	uint32_t mpus_evicted;
+	uint32_t fragments_evicted;
+} mpu_retention_stats_t;
+
+extern mpu_retention_policy_t mpu_retention_policy;
+extern mpu_retention_stats_t  mpu_retention_stats;
+
 
 uint8_t* mmt_mpu_parse_payload(mmtp_sub_flow_vector_t* mmtp_sub_flow_vector, mmtp_payload_fragments_union_t* mmt_payload, uint8_t* udp_raw_buf, int udp_raw_buf_size);
 void mmtp_sub_flow_mpu_fragments_allocate(mmtp_sub_flow_t* entry);
 mpu_data_unit_payload_fragments_t* mpu_data_unit_payload_fragments_find_mpu_sequence_number(mpu_data_unit_payload_fragments_vector_t *vec, uint32_t mpu_sequence_number);
 mpu_data_unit_payload_fragments_t* mpu_data_unit_payload_fragments_get_or_set_mpu_sequence_number_from_packet(mpu_data_unit_payload_fragments_vector_t *vec, mmtp_payload_fragments_union_t *mpu_type_packet);
+void mpu_data_unit_payload_fragments_remove(mpu_data_unit_payload_fragments_vector_t *vec, mpu_data_unit_payload_fragments_t* mpu_data_unit_payload_fragments);
 
 mpu_fragments_t* mpu_fragments_get_or_set_packet_id(mmtp_sub_flow_t* mmtp_sub_flow, uint16_t mmtp_packet_id);
 void mpu_fragments_assign_to_payload_vector(mmtp_sub_flow_t* mmtp_sub_flow, mmtp_payload_fragments_union_t* mpu_type_packet);
@@ -39,6 +72,16 @@ mpu_fragments_t* mpu_fragments_find_packet_id(mmtp_sub_flow_vector_t *vec, uint1
 
 void mmt_mpu_free_payload(mmtp_payload_fragments_union_t* mmtp_payload_fragments);
 
+void mpu_retention_policy_set(uint32_t max_mpus_per_sub_flow, uint32_t max_age_ms, uint64_t max_bytes_held);
+mpu_retention_entry_t* mpu_fragments_retention_find_mpu_sequence_number(mpu_fragments_t* mpu_fragments, uint32_t mpu_sequence_number);
+mpu_retention_entry_t* mpu_fragments_retention_get_or_set_mpu_sequence_number(mpu_fragments_t* mpu_fragments, uint32_t mpu_sequence_number);
+void mpu_fragments_retention_link_packet(mpu_retention_entry_t* mpu_retention_entry, mmtp_payload_fragments_union_t* mpu_type_packet);
+void mpu_fragments_retention_add_bytes(mmtp_payload_fragments_union_t* mpu_type_packet, uint32_t bytes);
+void mpu_fragments_retention_release_packet(mpu_fragments_t* mpu_fragments, mmtp_payload_fragments_union_t* mpu_type_packet);
+void mpu_fragments_retention_remove_media_fragment_unit(mpu_retention_entry_t* mpu_retention_entry);
+int mpu_fragments_retention_evict(mpu_retention_entry_t* mpu_retention_entry);
+int mpu_fragments_retention_enforce(mpu_fragments_t* mpu_fragments, uint32_t current_mpu_sequence_number);
+
 #if defined (__cplusplus)
 }
 #endif
@@ -10,42 +10,129 @@
 int _MMT_MPU_DEBUG_ENABLED = 0;
 
 
+#define UDP_FLOW_LATEST_MPU_SEQUENCE_NUMBER_BUCKETS_INITIAL 16
+
+static uint32_t udp_flow_hash(uint32_t dst_ip_addr, uint16_t dst_port) {
+	uint32_t hash = (dst_ip_addr * 2654435761U) ^ ((uint32_t)dst_port * 2246822519U);
+	return hash ^ (hash >> 15);
+}
+
+static uint32_t udp_flow_packet_id_hash(uint32_t dst_ip_addr, uint16_t dst_port, uint16_t packet_id) {
+	uint32_t hash = udp_flow_hash(dst_ip_addr, dst_port) ^ ((uint32_t)packet_id * 3266489917U);
+	return hash ^ (hash >> 13);
+}
+
+static void udp_flow_latest_mpu_sequence_number_index_insert(udp_flow_latest_mpu_sequence_number_container_t* udp_flow_latest_mpu_sequence_number_container, udp_flow_packet_id_mpu_sequence_tuple_t* udp_flow_packet_id_mpu_sequence_tuple) {
+	uint32_t mask = udp_flow_latest_mpu_sequence_number_container->udp_flow_buckets_n - 1;
+
+	uint32_t packet_id_bucket = udp_flow_packet_id_hash(udp_flow_packet_id_mpu_sequence_tuple->udp_flow.dst_ip_addr, udp_flow_packet_id_mpu_sequence_tuple->udp_flow.dst_port, udp_flow_packet_id_mpu_sequence_tuple->packet_id) & mask;
+	udp_flow_packet_id_mpu_sequence_tuple->packet_id_bucket_next = udp_flow_latest_mpu_sequence_number_container->packet_id_buckets[packet_id_bucket];
+	udp_flow_latest_mpu_sequence_number_container->packet_id_buckets[packet_id_bucket] = udp_flow_packet_id_mpu_sequence_tuple;
+
+	uint32_t udp_flow_bucket = udp_flow_hash(udp_flow_packet_id_mpu_sequence_tuple->udp_flow.dst_ip_addr, udp_flow_packet_id_mpu_sequence_tuple->udp_flow.dst_port) & mask;
+	udp_flow_packet_id_mpu_sequence_tuple->udp_flow_bucket_next = udp_flow_latest_mpu_sequence_number_container->udp_flow_buckets[udp_flow_bucket];
+	udp_flow_latest_mpu_sequence_number_container->udp_flow_buckets[udp_flow_bucket] = udp_flow_packet_id_mpu_sequence_tuple;
+}
+
+//keep the load factor <= 1, the tuples themselves never move so outstanding pointers stay valid
+static void udp_flow_latest_mpu_sequence_number_index_rehash(udp_flow_latest_mpu_sequence_number_container_t* udp_flow_latest_mpu_sequence_number_container, uint32_t udp_flow_buckets_n) {
+	free(udp_flow_latest_mpu_sequence_number_container->packet_id_buckets);
+	free(udp_flow_latest_mpu_sequence_number_container->udp_flow_buckets);
+
+	udp_flow_latest_mpu_sequence_number_container->udp_flow_buckets_n = udp_flow_buckets_n;
+	udp_flow_latest_mpu_sequence_number_container->packet_id_buckets = calloc(udp_flow_buckets_n, sizeof(*udp_flow_latest_mpu_sequence_number_container->packet_id_buckets));
+	udp_flow_latest_mpu_sequence_number_container->udp_flow_buckets = calloc(udp_flow_buckets_n, sizeof(*udp_flow_latest_mpu_sequence_number_container->udp_flow_buckets));
+	assert(udp_flow_latest_mpu_sequence_number_container->packet_id_buckets);
+	assert(udp_flow_latest_mpu_sequence_number_container->udp_flow_buckets);
+
+	for(int i=0; i < udp_flow_latest_mpu_sequence_number_container->udp_flows_n; i++) {
+		udp_flow_latest_mpu_sequence_number_index_insert(udp_flow_latest_mpu_sequence_number_container, udp_flow_latest_mpu_sequence_number_container->udp_flows[i]);
+	}
+}
+
 udp_flow_latest_mpu_sequence_number_container_t* udp_flow_latest_mpu_sequence_number_container_t_init() {
 	udp_flow_latest_mpu_sequence_number_container_t* udp_flow_latest_mpu_sequence_number_container = calloc(1, sizeof(udp_flow_latest_mpu_sequence_number_container_t));
+	udp_flow_latest_mpu_sequence_number_index_rehash(udp_flow_latest_mpu_sequence_number_container, UDP_FLOW_LATEST_MPU_SEQUENCE_NUMBER_BUCKETS_INITIAL);
+
 	return udp_flow_latest_mpu_sequence_number_container;
 }
 
-udp_flow_latest_mpu_sequence_number_container_t* udp_flow_find_matching_flows(udp_flow_latest_mpu_sequence_number_container_t* udp_flow_latest_mpu_sequence_number_container, udp_flow_t* udp_flow_to_search) {
-	udp_flow_latest_mpu_sequence_number_container_t* my_matching_flows = udp_flow_latest_mpu_sequence_number_container_t_init();
+/*
+ * walk the <dst_ip, dst_port> index, e.g.
+ *
+ * 	for(udp_flow_packet_id_mpu_sequence_tuple_t* tuple = udp_flow_latest_mpu_sequence_number_first_from_udp_flow(container, udp_flow);
+ * 		tuple; tuple = udp_flow_latest_mpu_sequence_number_next_from_udp_flow(tuple, udp_flow)) { ... }
+ */
+udp_flow_packet_id_mpu_sequence_tuple_t* udp_flow_latest_mpu_sequence_number_first_from_udp_flow(udp_flow_latest_mpu_sequence_number_container_t* udp_flow_latest_mpu_sequence_number_container, udp_flow_t* udp_flow_to_search) {
+	if(!udp_flow_latest_mpu_sequence_number_container->udp_flow_buckets_n) {
+		return NULL;
+	}
 
-	//do 2 passes, one to collect the matching counts and a second to build a collection** without havint to remalloc
-	my_matching_flows->udp_flows_n = 0;
+	uint32_t udp_flow_bucket = udp_flow_hash(udp_flow_to_search->dst_ip_addr, udp_flow_to_search->dst_port) & (udp_flow_latest_mpu_sequence_number_container->udp_flow_buckets_n - 1);
+	udp_flow_packet_id_mpu_sequence_tuple_t* udp_flow_packet_id_mpu_sequence_tuple = udp_flow_latest_mpu_sequence_number_container->udp_flow_buckets[udp_flow_bucket];
 
-	for(int i=0; i < udp_flow_latest_mpu_sequence_number_container->udp_flows_n; i++) {
-		udp_flow_packet_id_mpu_sequence_tuple_t* udp_flow_packet_id_mpu_sequence_tuple = udp_flow_latest_mpu_sequence_number_container->udp_flows[i];
-		if(udp_flow_match_from_udp_flow_t(udp_flow_packet_id_mpu_sequence_tuple, udp_flow_to_search)) {
-			my_matching_flows->udp_flows_n++;
-		}
+	while(udp_flow_packet_id_mpu_sequence_tuple && !udp_flow_match_from_udp_flow_t(udp_flow_packet_id_mpu_sequence_tuple, udp_flow_to_search)) {
+		udp_flow_packet_id_mpu_sequence_tuple = udp_flow_packet_id_mpu_sequence_tuple->udp_flow_bucket_next;
 	}
 
-	if(!my_matching_flows->udp_flows_n) {
-		return NULL;
+	return udp_flow_packet_id_mpu_sequence_tuple;
+}
+
+udp_flow_packet_id_mpu_sequence_tuple_t* udp_flow_latest_mpu_sequence_number_next_from_udp_flow(udp_flow_packet_id_mpu_sequence_tuple_t* udp_flow_packet_id_mpu_sequence_tuple, udp_flow_t* udp_flow_to_search) {
+	udp_flow_packet_id_mpu_sequence_tuple = udp_flow_packet_id_mpu_sequence_tuple->udp_flow_bucket_next;
+
+	while(udp_flow_packet_id_mpu_sequence_tuple && !udp_flow_match_from_udp_flow_t(udp_flow_packet_id_mpu_sequence_tuple, udp_flow_to_search)) {
+		udp_flow_packet_id_mpu_sequence_tuple = udp_flow_packet_id_mpu_sequence_tuple->udp_flow_bucket_next;
 	}
 
-	my_matching_flows->udp_flows = calloc(my_matching_flows->udp_flows_n, sizeof(my_matching_flows->udp_flows));
+	return udp_flow_packet_id_mpu_sequence_tuple;
+}
 
-	int flow_position = 0;
-	//copy the actual flows over
-	for(int i=0; i < udp_flow_latest_mpu_sequence_number_container->udp_flows_n; i++) {
-		udp_flow_packet_id_mpu_sequence_tuple_t* udp_flow_packet_id_mpu_sequence_tuple = udp_flow_latest_mpu_sequence_number_container->udp_flows[i];
-		if(udp_flow_match_from_udp_flow_t(udp_flow_packet_id_mpu_sequence_tuple, udp_flow_to_search)) {
-			my_matching_flows->udp_flows[flow_position] = calloc(1, sizeof(udp_flow_packet_id_mpu_sequence_tuple_t));
-			memcpy(my_matching_flows->udp_flows[flow_position], udp_flow_packet_id_mpu_sequence_tuple, sizeof(udp_flow_packet_id_mpu_sequence_tuple_t));
+udp_flow_packet_id_mpu_sequence_tuple_t* udp_flow_latest_mpu_sequence_number_find(udp_flow_latest_mpu_sequence_number_container_t* udp_flow_latest_mpu_sequence_number_container, udp_flow_t* udp_flow, uint16_t packet_id) {
+	if(!udp_flow_latest_mpu_sequence_number_container->udp_flow_buckets_n) {
+		return NULL;
+	}
 
-			flow_position++;
+	uint32_t packet_id_bucket = udp_flow_packet_id_hash(udp_flow->dst_ip_addr, udp_flow->dst_port, packet_id) & (udp_flow_latest_mpu_sequence_number_container->udp_flow_buckets_n - 1);
+	udp_flow_packet_id_mpu_sequence_tuple_t* udp_flow_packet_id_mpu_sequence_tuple = udp_flow_latest_mpu_sequence_number_container->packet_id_buckets[packet_id_bucket];
+
+	while(udp_flow_packet_id_mpu_sequence_tuple) {
+		if(udp_flow_match_from_udp_flow_t(udp_flow_packet_id_mpu_sequence_tuple, udp_flow) && udp_flow_packet_id_mpu_sequence_tuple->packet_id == packet_id) {
+			return udp_flow_packet_id_mpu_sequence_tuple;
 		}
+		udp_flow_packet_id_mpu_sequence_tuple = udp_flow_packet_id_mpu_sequence_tuple->packet_id_bucket_next;
 	}
 
+	return NULL;
+}
+
+/*
+ * returns a snapshot (cloned tuples, no hash index) of all packet_id's on this <dst_ip, dst_port>,
+ * prefer udp_flow_latest_mpu_sequence_number_first_from_udp_flow/next_from_udp_flow to avoid the copy
+ */
+udp_flow_latest_mpu_sequence_number_container_t* udp_flow_find_matching_flows(udp_flow_latest_mpu_sequence_number_container_t* udp_flow_latest_mpu_sequence_number_container, udp_flow_t* udp_flow_to_search) {
+	uint32_t matching_flows_n = 0;
+	udp_flow_packet_id_mpu_sequence_tuple_t* udp_flow_packet_id_mpu_sequence_tuple = NULL;
+
+	for(udp_flow_packet_id_mpu_sequence_tuple = udp_flow_latest_mpu_sequence_number_first_from_udp_flow(udp_flow_latest_mpu_sequence_number_container, udp_flow_to_search);
+			udp_flow_packet_id_mpu_sequence_tuple;
+			udp_flow_packet_id_mpu_sequence_tuple = udp_flow_latest_mpu_sequence_number_next_from_udp_flow(udp_flow_packet_id_mpu_sequence_tuple, udp_flow_to_search)) {
+		matching_flows_n++;
+	}
+
+	if(!matching_flows_n) {
+		return NULL;
+	}
+
+	udp_flow_latest_mpu_sequence_number_container_t* my_matching_flows = calloc(1, sizeof(udp_flow_latest_mpu_sequence_number_container_t));
+	my_matching_flows->udp_flows = calloc(matching_flows_n, sizeof(*my_matching_flows->udp_flows));
+	my_matching_flows->udp_flows_capacity = matching_flows_n;
+
+	for(udp_flow_packet_id_mpu_sequence_tuple = udp_flow_latest_mpu_sequence_number_first_from_udp_flow(udp_flow_latest_mpu_sequence_number_container, udp_flow_to_search);
+			udp_flow_packet_id_mpu_sequence_tuple;
+			udp_flow_packet_id_mpu_sequence_tuple = udp_flow_latest_mpu_sequence_number_next_from_udp_flow(udp_flow_packet_id_mpu_sequence_tuple, udp_flow_to_search)) {
+		my_matching_flows->udp_flows[my_matching_flows->udp_flows_n++] = udp_flow_packet_id_mpu_sequence_tuple_clone(udp_flow_packet_id_mpu_sequence_tuple);
+	}
 
 	return my_matching_flows;
 }
@@ -62,6 +149,9 @@ void udp_flow_latest_mpu_sequence_number_container_t_release(udp_flow_latest_mpu
 	}
 	udp_flow_latest_mpu_sequence_number_container->udp_flows_n = 0;
 
+	free(udp_flow_latest_mpu_sequence_number_container->udp_flows);
+	free(udp_flow_latest_mpu_sequence_number_container->packet_id_buckets);
+	free(udp_flow_latest_mpu_sequence_number_container->udp_flow_buckets);
 	free(udp_flow_latest_mpu_sequence_number_container);
 }
 
@@ -70,16 +160,7 @@ void udp_flow_latest_mpu_sequence_number_container_t_release(udp_flow_latest_mpu
  */
 
 udp_flow_packet_id_mpu_sequence_tuple_t* udp_flow_latest_mpu_sequence_number_from_packet_id(udp_flow_latest_mpu_sequence_number_container_t* udp_flow_latest_mpu_sequence_number_container, udp_packet_t* udp_packet, uint32_t packet_id) {
-
-	udp_flow_packet_id_mpu_sequence_tuple_t* udp_flow_packet_id_mpu_sequence_tuple_in_collection = NULL;
-
-	for(int i=0; i < udp_flow_latest_mpu_sequence_number_container->udp_flows_n; i++) {
-		udp_flow_packet_id_mpu_sequence_tuple_in_collection = udp_flow_latest_mpu_sequence_number_container->udp_flows[i];
-		if(udp_flow_match(udp_flow_packet_id_mpu_sequence_tuple_in_collection, udp_packet) && (udp_flow_packet_id_mpu_sequence_tuple_in_collection->packet_id == packet_id)) {
-			return udp_flow_packet_id_mpu_sequence_tuple_in_collection;
-		}
-	}
-	return NULL;
+	return udp_flow_latest_mpu_sequence_number_find(udp_flow_latest_mpu_sequence_number_container, &udp_packet->udp_flow, packet_id);
 }
 
 /*
@@ -104,13 +185,9 @@ udp_flow_packet_id_mpu_sequence_tuple_t* udp_flow_latest_mpu_sequence_number_add
 	udp_flow_packet_id_mpu_sequence_tuple_t** udp_flow_packet_id_mpu_sequence_tuple_in_collection = NULL;
 	udp_flow_packet_id_mpu_sequence_tuple_t** udp_flow_packet_id_mpu_sequence_matching_pkt_id = NULL;
 
-
-    for(int i=0; i < udp_flow_latest_mpu_sequence_number_container->udp_flows_n; i++) {
-		udp_flow_packet_id_mpu_sequence_tuple_in_collection = &udp_flow_latest_mpu_sequence_number_container->udp_flows[i];
-
-		if(udp_flow_match((*udp_flow_packet_id_mpu_sequence_tuple_in_collection), udp_packet) && ((*udp_flow_packet_id_mpu_sequence_tuple_in_collection)->packet_id == mmtp_packet->mmtp_mpu_type_packet_header.mmtp_packet_id)) {
-			udp_flow_packet_id_mpu_sequence_matching_pkt_id = udp_flow_packet_id_mpu_sequence_tuple_in_collection;
-		}
+	udp_flow_packet_id_mpu_sequence_tuple_t* udp_flow_packet_id_mpu_sequence_tuple_found = udp_flow_latest_mpu_sequence_number_find(udp_flow_latest_mpu_sequence_number_container, &udp_packet->udp_flow, mmtp_packet->mmtp_mpu_type_packet_header.mmtp_packet_id);
+	if(udp_flow_packet_id_mpu_sequence_tuple_found) {
+		udp_flow_packet_id_mpu_sequence_matching_pkt_id = &udp_flow_packet_id_mpu_sequence_tuple_found;
 	}
 
 	//if we have a candidate <dip, dport, packet_id>, then check who has the largest mpu_sequence_number
@@ -155,11 +232,11 @@ udp_flow_packet_id_mpu_sequence_tuple_t* udp_flow_latest_mpu_sequence_number_add
             return *udp_flow_packet_id_mpu_sequence_matching_pkt_id;
 		}
 	} else {
-		if(udp_flow_latest_mpu_sequence_number_container->udp_flows_n) {
-			udp_flow_latest_mpu_sequence_number_container->udp_flows = realloc(udp_flow_latest_mpu_sequence_number_container->udp_flows, (udp_flow_latest_mpu_sequence_number_container->udp_flows_n + 1) * sizeof(udp_flow_latest_mpu_sequence_number_container->udp_flows));
-			//realloc here
-		} else {
-			udp_flow_latest_mpu_sequence_number_container->udp_flows = calloc(1, sizeof(*udp_flow_latest_mpu_sequence_number_container->udp_flows));
+		if(udp_flow_latest_mpu_sequence_number_container->udp_flows_n == udp_flow_latest_mpu_sequence_number_container->udp_flows_capacity) {
+			uint32_t udp_flows_capacity = udp_flow_latest_mpu_sequence_number_container->udp_flows_capacity ? udp_flow_latest_mpu_sequence_number_container->udp_flows_capacity * 2 : UDP_FLOW_LATEST_MPU_SEQUENCE_NUMBER_BUCKETS_INITIAL;
+			udp_flow_latest_mpu_sequence_number_container->udp_flows = realloc(udp_flow_latest_mpu_sequence_number_container->udp_flows, udp_flows_capacity * sizeof(*udp_flow_latest_mpu_sequence_number_container->udp_flows));
+			assert(udp_flow_latest_mpu_sequence_number_container->udp_flows);
+			udp_flow_latest_mpu_sequence_number_container->udp_flows_capacity = udp_flows_capacity;
 		}
 		udp_flow_latest_mpu_sequence_number_container->udp_flows[udp_flow_latest_mpu_sequence_number_container->udp_flows_n] = calloc(1, sizeof(udp_flow_packet_id_mpu_sequence_tuple_t));
 		udp_flow_packet_id_mpu_sequence_tuple_in_collection = &udp_flow_latest_mpu_sequence_number_container->udp_flows[udp_flow_latest_mpu_sequence_number_container->udp_flows_n];
@@ -172,6 +249,12 @@ udp_flow_packet_id_mpu_sequence_tuple_t* udp_flow_latest_mpu_sequence_number_add
 		(*udp_flow_packet_id_mpu_sequence_tuple_in_collection)->mpu_sequence_number_evict_range_start = mmtp_packet->mmtp_mpu_type_packet_header.mpu_sequence_number;
 
 		udp_flow_latest_mpu_sequence_number_container->udp_flows_n++;
+
+		if(udp_flow_latest_mpu_sequence_number_container->udp_flows_n > udp_flow_latest_mpu_sequence_number_container->udp_flow_buckets_n) {
+			udp_flow_latest_mpu_sequence_number_index_rehash(udp_flow_latest_mpu_sequence_number_container, udp_flow_latest_mpu_sequence_number_container->udp_flow_buckets_n ? udp_flow_latest_mpu_sequence_number_container->udp_flow_buckets_n * 2 : UDP_FLOW_LATEST_MPU_SEQUENCE_NUMBER_BUCKETS_INITIAL);
+		} else {
+			udp_flow_latest_mpu_sequence_number_index_insert(udp_flow_latest_mpu_sequence_number_container, *udp_flow_packet_id_mpu_sequence_tuple_in_collection);
+		}
 	}
 
 	return (*udp_flow_packet_id_mpu_sequence_tuple_in_collection);
@@ -181,7 +264,9 @@ udp_flow_packet_id_mpu_sequence_tuple_t* udp_flow_packet_id_mpu_sequence_tuple_c
     udp_flow_packet_id_mpu_sequence_tuple_t* to_udp_flow_packet_id_mpu_sequence_tuple = (udp_flow_packet_id_mpu_sequence_tuple_t*) calloc(1, sizeof(udp_flow_packet_id_mpu_sequence_tuple_t));
     assert(to_udp_flow_packet_id_mpu_sequence_tuple);
     memcpy(to_udp_flow_packet_id_mpu_sequence_tuple, from_udp_flow_packet_id_mpu_sequence_tuple, sizeof(udp_flow_packet_id_mpu_sequence_tuple_t));
-    
+    to_udp_flow_packet_id_mpu_sequence_tuple->packet_id_bucket_next = NULL;
+    to_udp_flow_packet_id_mpu_sequence_tuple->udp_flow_bucket_next = NULL;
+
     return to_udp_flow_packet_id_mpu_sequence_tuple;
 }
 
@@ -256,57 +341,27 @@ int atsc3_mmt_mpu_clear_data_unit_from_packet_subflow(mmtp_payload_fragments_uni
 
 
 int atsc3_mmt_mpu_clear_data_unit_payload_fragments(mmtp_sub_flow_t* mmtp_sub_flow, mpu_fragments_t* mpu_fragments, mpu_data_unit_payload_fragments_timed_vector_t* data_unit_payload_fragments) {
-	//clear out matching packets from allpackets,
-	ssize_t* all_packets_index = (long*) calloc(1, sizeof(ssize_t));
 	int evicted_count = 0;
 
+	//every data unit here is one mpu_sequence_number, so one retention entry
+	mpu_retention_entry_t* mpu_retention_entry = data_unit_payload_fragments->size ? data_unit_payload_fragments->data[0]->mmtp_mpu_type_packet_header.mpu_retention_entry : NULL;
+
 	//clear out any mfu's in queue if we are here
 	//remove our packets from the subflow and free block allocs, as mpu_push_to_output_buffer_no_locking will copy the p_buffer to a slab
 	for(int i=0; i < data_unit_payload_fragments->size; i++) {
 
 		mmtp_payload_fragments_union_t* packet = data_unit_payload_fragments->data[i];
 
-
-		//free the sub-flow fragment
-		atsc3_vector_index_of(&mmtp_sub_flow->mpu_fragments->all_mpu_fragments_vector, packet, all_packets_index);
-		__MMT_MPU_DEBUG("freeing container: mmtp_sub_flow->mpu_fragments->all_mpu_fragments_vector: %p, payload : %p, packet_counter: %u, mpu_sequence_number: %u, at index: %ld",
+		__MMT_MPU_DEBUG("freeing container: mmtp_sub_flow->mpu_fragments->all_mpu_fragments_vector: %p, payload : %p, packet_counter: %u, mpu_sequence_number: %u, at index: %zu",
 										&mmtp_sub_flow->mpu_fragments->all_mpu_fragments_vector,
 										packet,
 										packet->mmtp_mpu_type_packet_header.packet_counter,
 										packet->mmtp_mpu_type_packet_header.mpu_sequence_number,
-										*all_packets_index);
+										packet->mmtp_mpu_type_packet_header.all_mpu_fragments_index);
 
-		if(*all_packets_index >-1) {
-			__MMT_MPU_DEBUG("freeing payload from all_mpu_fragments_vector via vector_remove_noshrkink at index: %ld", *all_packets_index);
-			atsc3_vector_remove_noshrink(&mmtp_sub_flow->mpu_fragments->all_mpu_fragments_vector, *all_packets_index);
-			evicted_count++;
-		}
-
-		if(mpu_fragments) {
-			//free global fragment
-			atsc3_vector_index_of(&mpu_fragments->all_mpu_fragments_vector, packet, all_packets_index);
-			__MMT_MPU_DEBUG("freeing container: mpu_fragments->all_mpu_fragments_vector: %p, payload : %p, packet_counter: %u, mpu_sequence_number: %u, at index: %ld",
-													&mpu_fragments->all_mpu_fragments_vector,
-													packet,
-													packet->mmtp_mpu_type_packet_header.packet_counter,
-													packet->mmtp_mpu_type_packet_header.mpu_sequence_number,
-													*all_packets_index);
-
-			if(*all_packets_index >-1) {
-				atsc3_vector_remove_noshrink(&mpu_fragments->all_mpu_fragments_vector, *all_packets_index);
-				evicted_count++;
-			}
-			__MMT_MPU_DEBUG("packet flow all_mpu_Fragments_vector is: %p, size: %lu, mmtp_sub_flow->mpu_fragments is: %p, global mpu_fragments->all_mpu_fragments is: %p, and size is: %lu",
-					&packet->mmtp_mpu_type_packet_header.mmtp_sub_flow->mpu_fragments->all_mpu_fragments_vector,
-					packet->mmtp_mpu_type_packet_header.mmtp_sub_flow->mpu_fragments->all_mpu_fragments_vector.size,
-					&mmtp_sub_flow->mpu_fragments->all_mpu_fragments_vector,
-					&mpu_fragments->all_mpu_fragments_vector,
-					mpu_fragments->all_mpu_fragments_vector.size);
-
-		}
-
-		//clear out any block_t allocs
+		//leaves all_mpu_fragments_vector and its retention entry (and bytes_held) before its block_t allocs are freed
 		mmtp_payload_fragments_union_free(&packet);
+		evicted_count++;
 	}
 
 	mpu_fragments_vector_shrink_to_fit(mmtp_sub_flow->mpu_fragments);
@@ -317,6 +372,15 @@ int atsc3_mmt_mpu_clear_data_unit_payload_fragments(mmtp_sub_flow_t* mmtp_sub_fl
 
 	//clear out all of the data uint fragments here...
 	atsc3_vector_clear(data_unit_payload_fragments);
+
+	//nothing left of this MPU, drop the entry (and its now empty fragment vectors) rather than hold it until the policy gets to it,
+	//otherwise drop just the emptied data unit container so it stops holding its mpu_sequence_number ring slot
+	if(mpu_retention_entry && !mpu_retention_entry->packets_head) {
+		mpu_fragments_retention_evict(mpu_retention_entry);
+	} else if(mpu_retention_entry && mpu_retention_entry->media_fragment_unit && &mpu_retention_entry->media_fragment_unit->timed_fragments_vector == data_unit_payload_fragments) {
+		mpu_fragments_retention_remove_media_fragment_unit(mpu_retention_entry);
+	}
+
 	return evicted_count;
 }
 
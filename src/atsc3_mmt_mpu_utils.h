@@ -6,6 +6,7 @@
  */
 #include <stdbool.h>
 #include "atsc3_listener_udp.h"
+#include "atsc3_logging.h"
 
 #include "atsc3_lls_types.h"
 #include "atsc3_mmtp_types.h"
@@ -64,6 +65,9 @@ extern "C" {
 udp_flow_latest_mpu_sequence_number_container_t* udp_flow_latest_mpu_sequence_number_container_t_init();
 udp_flow_latest_mpu_sequence_number_container_t* udp_flow_find_matching_flows(udp_flow_latest_mpu_sequence_number_container_t* udp_flow_latest_mpu_sequence_number_container, udp_flow_t* udp_flow_to_search);
 void udp_flow_latest_mpu_sequence_number_container_t_release(udp_flow_latest_mpu_sequence_number_container_t* udp_flow_latest_mpu_sequence_number_container);
+udp_flow_packet_id_mpu_sequence_tuple_t* udp_flow_latest_mpu_sequence_number_find(udp_flow_latest_mpu_sequence_number_container_t* udp_flow_latest_mpu_sequence_number_container, udp_flow_t* udp_flow, uint16_t packet_id);
+udp_flow_packet_id_mpu_sequence_tuple_t* udp_flow_latest_mpu_sequence_number_first_from_udp_flow(udp_flow_latest_mpu_sequence_number_container_t* udp_flow_latest_mpu_sequence_number_container, udp_flow_t* udp_flow_to_search);
+udp_flow_packet_id_mpu_sequence_tuple_t* udp_flow_latest_mpu_sequence_number_next_from_udp_flow(udp_flow_packet_id_mpu_sequence_tuple_t* udp_flow_packet_id_mpu_sequence_tuple, udp_flow_t* udp_flow_to_search);
 udp_flow_packet_id_mpu_sequence_tuple_t* udp_flow_latest_mpu_sequence_number_from_packet_id(udp_flow_latest_mpu_sequence_number_container_t* udp_flow_latest_mpu_sequence_number_container, udp_packet_t* udp_packet, uint32_t packet_id);
 udp_flow_packet_id_mpu_sequence_tuple_t* udp_flow_latest_mpu_sequence_number_add_or_replace(udp_flow_latest_mpu_sequence_number_container_t* udp_flow_latest_mpu_sequence_number_container, udp_packet_t* udp_packet, mmtp_payload_fragments_union_t* mmtp_packet);
 
@@ -71,6 +75,7 @@ void udp_flow_force_negative_mpu_discontinuity_value(udp_flow_packet_id_mpu_sequ
 void udp_flow_reset_negative_mpu_discontinuity_counters(udp_flow_packet_id_mpu_sequence_tuple_t* udp_flow_packet_id_mpu_sequence_matching_pkt_id);
 
 int atsc3_mmt_mpu_clear_data_unit_from_packet_subflow(mmtp_payload_fragments_union_t* mmtp_payload_fragments_union, uint32_t evict_range_start, uint32_t evict_range_end);
+//frees the packets through the MPU retention bookkeeping, data_unit_payload_fragments is freed along with its data unit container
 int atsc3_mmt_mpu_clear_data_unit_payload_fragments(mmtp_sub_flow_t* mmtp_sub_flow, mpu_fragments_t* mpu_fragments, mpu_data_unit_payload_fragments_timed_vector_t* data_unit_payload_fragments);
 
 void mpu_dump_header(mmtp_payload_fragments_union_t* mmtp_payload);
@@ -92,9 +97,9 @@ void udp_flow_packet_id_mpu_sequence_tuple_free_and_clone(udp_flow_packet_id_mpu
 #endif
 
 
-#define __MMT_MPU_ERROR(...)   printf("%s:%d:ERROR :",__FILE__,__LINE__);printf(__VA_ARGS__);printf("%s%s","\r","\n")
-#define __MMT_MPU_WARN(...)    printf("%s:%d:WARN: ",__FILE__,__LINE__);printf(__VA_ARGS__);printf("%s%s","\r","\n")
-#define __MMT_MPU_INFO(...)    printf("%s:%d: ",__FILE__,__LINE__);printf(__VA_ARGS__);printf("%s%s","\r","\n")
-#define __MMT_MPU_DEBUG(...)   if(_MMT_MPU_DEBUG_ENABLED) {printf("%s:%d:DEBUG: ",__FILE__,__LINE__);printf(__VA_ARGS__);printf("%s%s","\r","\n"); }
+#define __MMT_MPU_ERROR(...)   __ATSC3_LOG_ERROR(ATSC3_LOG_MODULE_MMT_MPU, __VA_ARGS__)
+#define __MMT_MPU_WARN(...)    __ATSC3_LOG_WARN(ATSC3_LOG_MODULE_MMT_MPU, __VA_ARGS__)
+#define __MMT_MPU_INFO(...)    __ATSC3_LOG_INFO(ATSC3_LOG_MODULE_MMT_MPU, __VA_ARGS__)
+#define __MMT_MPU_DEBUG(...)   if(_MMT_MPU_DEBUG_ENABLED) { __ATSC3_LOG_DEBUG(ATSC3_LOG_MODULE_MMT_MPU, __VA_ARGS__); }
 
 #endif /* ATSC3_MMT_MPU_UTILS_H_ */
@@ -36,10 +36,91 @@ MPU_timestamp_descriptor: 0x0001
  */
 
 #include "atsc3_mmt_reconstitution_from_media_sample.h"
+#include "atsc3_latency_histogram.h"
 
 int _MMT_RECON_FROM_SAMPLE_DEBUG_ENABLED = 0;
 int _MMT_RECON_FROM_SAMPLE_TRACE_ENABLED = 0;
 
+//appends output_block to the http and ffplay pipe outputs, if enabled
+static void mmtp_process_output_block_to_sinks(lls_slt_monitor_t* lls_slt_monitor, uint16_t service_id, block_t* output_block) {
+	lls_sls_monitor_output_buffer_mode_t* lls_sls_monitor_output_buffer_mode = &lls_slt_monitor->lls_sls_mmt_monitor->lls_sls_monitor_output_buffer_mode;
+
+	//http support output
+	if(lls_sls_monitor_output_buffer_mode->http_output_enabled &&
+			lls_sls_monitor_output_buffer_mode->http_output_buffer &&
+			lls_sls_monitor_output_buffer_mode->http_output_buffer->http_output_conntected) {
+
+		lls_sls_monitor_reader_mutex_lock(lls_sls_monitor_output_buffer_mode->http_output_buffer->http_payload_buffer_mutex);
+		lls_sls_monitor_output_buffer_mode->http_output_buffer->total_fragments_incoming_written++;
+
+		if(!lls_sls_monitor_output_buffer_mode->http_output_buffer->http_payload_buffer_incoming) {
+			lls_sls_monitor_output_buffer_mode->http_output_buffer->http_payload_buffer_incoming = block_Duplicate(output_block);
+		} else {
+			//block_Duplicate leaves i_pos at 0, append after everything not yet picked up by the http writer
+			lls_sls_monitor_output_buffer_mode->http_output_buffer->http_payload_buffer_incoming->i_pos = lls_sls_monitor_output_buffer_mode->http_output_buffer->http_payload_buffer_incoming->p_size;
+			block_Write(lls_sls_monitor_output_buffer_mode->http_output_buffer->http_payload_buffer_incoming, output_block->p_buffer, output_block->i_pos);
+		}
+		__LATENCY_HISTOGRAM_RECORD(service_id, ATSC3_LATENCY_STAGE_SINK_ENQUEUE);
+
+		lls_sls_monitor_reader_mutex_unlock(lls_sls_monitor_output_buffer_mode->http_output_buffer->http_payload_buffer_mutex);
+	}
+
+	//ffplay pipe output
+	if(lls_sls_monitor_output_buffer_mode->ffplay_output_enabled && lls_sls_monitor_output_buffer_mode->pipe_ffplay_buffer) {
+
+		pipe_buffer_reader_mutex_lock(lls_sls_monitor_output_buffer_mode->pipe_ffplay_buffer);
+
+		pipe_buffer_unsafe_push_block(lls_sls_monitor_output_buffer_mode->pipe_ffplay_buffer, output_block->p_buffer, output_block->i_pos);
+		__LATENCY_HISTOGRAM_RECORD(service_id, ATSC3_LATENCY_STAGE_SINK_ENQUEUE);
+
+		pipe_buffer_notify_semaphore_post(lls_sls_monitor_output_buffer_mode->pipe_ffplay_buffer);
+
+		//check to see if we have shutdown
+		lls_slt_monitor_check_and_handle_pipe_ffplay_buffer_is_shutdown(lls_slt_monitor);
+
+		pipe_buffer_reader_mutex_unlock(lls_sls_monitor_output_buffer_mode->pipe_ffplay_buffer);
+	}
+}
+
+//low-latency output: emits a moof + mdat chunk as soon as data_unit completes an audio or video sample
+static void mmtp_process_mfu_chunk_to_sinks(lls_slt_monitor_t* lls_slt_monitor, uint16_t service_id, mmtp_payload_fragments_union_t* data_unit) {
+	lls_sls_mmt_monitor_t* lls_sls_mmt_monitor = lls_slt_monitor->lls_sls_mmt_monitor;
+	lls_sls_monitor_output_buffer_t* lls_sls_monitor_output_buffer = &lls_sls_mmt_monitor->lls_sls_monitor_output_buffer;
+	lls_sls_monitor_buffer_isobmff_t* lls_sls_monitor_buffer_isobmff = NULL;
+
+	if(data_unit->mmtp_mpu_type_packet_header.mmtp_packet_id == lls_sls_mmt_monitor->video_packet_id) {
+		lls_sls_monitor_buffer_isobmff = &lls_sls_monitor_output_buffer->video_output_buffer_isobmff;
+	} else if(data_unit->mmtp_mpu_type_packet_header.mmtp_packet_id == lls_sls_mmt_monitor->audio_packet_id) {
+		lls_sls_monitor_buffer_isobmff = &lls_sls_monitor_output_buffer->audio_output_buffer_isobmff;
+	} else {
+		return;
+	}
+
+	//the init box comes from the first joined MPU fragment, nothing is emitted until then
+	if(!lls_sls_monitor_output_buffer->mfu_chunk_init_block) {
+		return;
+	}
+
+	block_t* chunk = lls_sls_monitor_output_buffer_mfu_chunk_add_data_unit(lls_sls_monitor_output_buffer, lls_sls_monitor_buffer_isobmff, data_unit);
+	if(!chunk) {
+		return;
+	}
+
+	if(!lls_sls_monitor_output_buffer->has_written_mfu_chunk_init_box) {
+		block_t* init_and_chunk = block_Duplicate(lls_sls_monitor_output_buffer->mfu_chunk_init_block);
+		init_and_chunk->i_pos = lls_sls_monitor_output_buffer->mfu_chunk_init_block->i_pos;
+		block_Write(init_and_chunk, chunk->p_buffer, chunk->i_pos);
+		block_Release(&chunk);
+		chunk = init_and_chunk;
+		lls_sls_monitor_output_buffer->has_written_mfu_chunk_init_box = true;
+	}
+
+	mmtp_process_output_block_to_sinks(lls_slt_monitor, service_id, chunk);
+	__LATENCY_HISTOGRAM_RECORD_SINCE(service_id, ATSC3_LATENCY_STAGE_MFU_SAMPLE_TO_SINK, lls_sls_monitor_buffer_isobmff->mfu_chunk.sample_first_arrival_ns);
+
+	block_Release(&chunk);
+}
+
 mmtp_payload_fragments_union_t* mmtp_process_from_payload(mmtp_sub_flow_vector_t* mmtp_sub_flow_vector,
 		udp_flow_latest_mpu_sequence_number_container_t* udp_flow_latest_mpu_sequence_number_container,
 		lls_slt_monitor_t* lls_slt_monitor,
@@ -55,6 +136,8 @@ mmtp_payload_fragments_union_t* mmtp_process_from_payload(mmtp_sub_flow_vector_t
     mpu_data_unit_payload_fragments_t* movie_metadata_fragments  = NULL;
     mmtp_sub_flow_t* mmtp_sub_flow = NULL;
 
+    __LATENCY_HISTOGRAM_RECORD(matching_lls_slt_mmt_session->service_id, ATSC3_LATENCY_STAGE_PARSE);
+
     //dump header, then dump applicable packet type
     //mmtp_packet_header_dump(mmtp_payload);
 
@@ -63,6 +146,7 @@ mmtp_payload_fragments_union_t* mmtp_process_from_payload(mmtp_sub_flow_vector_t
 
         if(mmtp_payload->mmtp_mpu_type_packet_header.mpu_timed_flag == 1) {
             global_stats->packet_counter_mmt_timed_mpu++;
+            mmtp_payload->mpu_data_unit_payload_fragments_timed.arrival_ns = atsc3_latency_histogram_arrival_ns;
 
             if(lls_slt_monitor && lls_slt_monitor->lls_sls_mmt_monitor && lls_slt_monitor->lls_sls_mmt_monitor->service_id == matching_lls_slt_mmt_session->service_id) {
 
@@ -95,6 +179,8 @@ mmtp_payload_fragments_union_t* mmtp_process_from_payload(mmtp_sub_flow_vector_t
                      mmtp_payload->mmtp_mpu_type_packet_header.mmtp_packet_id == matching_lls_slt_mmt_session->last_udp_flow_packet_id_mpu_sequence_tuple_video->packet_id && matching_lls_slt_mmt_session->last_udp_flow_packet_id_mpu_sequence_tuple_video->mpu_sequence_number < mmtp_payload->mmtp_mpu_type_packet_header.mpu_sequence_number)
                     )) {
 
+                       __LATENCY_HISTOGRAM_RECORD(matching_lls_slt_mmt_session->service_id, ATSC3_LATENCY_STAGE_MPU_OBJECT_COMPLETE);
+
                        uint32_t min_mpu_sequence_number = __MIN(matching_lls_slt_mmt_session->to_process_udp_flow_packet_id_mpu_sequence_tuple_audio->mpu_sequence_number, matching_lls_slt_mmt_session->to_process_udp_flow_packet_id_mpu_sequence_tuple_video->mpu_sequence_number);
                        __MMT_RECON_FROM_SAMPLE_INFO("Starting re-fragmenting because packet_id:mpu_sequence number changed, from a: %u:%u, v: %u:%u with %u:%u, processing a: %u:%u, v: %u:%u, min: %u",
                               matching_lls_slt_mmt_session->last_udp_flow_packet_id_mpu_sequence_tuple_audio->packet_id,
@@ -120,6 +206,8 @@ mmtp_payload_fragments_union_t* mmtp_process_from_payload(mmtp_sub_flow_vector_t
 							   mmtp_sub_flow_vector, lls_slt_monitor->lls_sls_mmt_monitor);
 
                         if(lls_sls_monitor_output_buffer_final_muxed_payload) {
+                            __LATENCY_HISTOGRAM_RECORD(matching_lls_slt_mmt_session->service_id, ATSC3_LATENCY_STAGE_ISOBMFF_JOIN);
+
                             //mark both of these flows as having been processed
                             matching_lls_slt_mmt_session->last_udp_flow_packet_id_mpu_sequence_tuple_audio_processed = true;
                             matching_lls_slt_mmt_session->last_udp_flow_packet_id_mpu_sequence_tuple_video_processed = true;
@@ -133,46 +221,30 @@ mmtp_payload_fragments_union_t* mmtp_process_from_payload(mmtp_sub_flow_vector_t
                              		matching_lls_slt_mmt_session->to_process_udp_flow_packet_id_mpu_sequence_tuple_video->mpu_sequence_number + mpu_sequence_number_offset);
                             }
 
-                            //http support output
-                            if(lls_slt_monitor->lls_sls_mmt_monitor->lls_sls_monitor_output_buffer_mode.http_output_enabled &&
-                            		lls_slt_monitor->lls_sls_mmt_monitor->lls_sls_monitor_output_buffer_mode.http_output_buffer &&
-                            		lls_slt_monitor->lls_sls_mmt_monitor->lls_sls_monitor_output_buffer_mode.http_output_buffer->http_output_conntected) {
-                            	//&& lls_slt_monitor->lls_sls_mmt_monitor->lls_sls_monitor_output_buffer_mode.pipe_ffplay_buffer) {
-
-                            	lls_sls_monitor_reader_mutex_lock(lls_slt_monitor->lls_sls_mmt_monitor->lls_sls_monitor_output_buffer_mode.http_output_buffer->http_payload_buffer_mutex);
-                            	lls_slt_monitor->lls_sls_mmt_monitor->lls_sls_monitor_output_buffer_mode.http_output_buffer->total_fragments_incoming_written++;
-
-								if(!lls_slt_monitor->lls_sls_mmt_monitor->lls_sls_monitor_output_buffer_mode.http_output_buffer->http_payload_buffer_incoming) {
-									lls_slt_monitor->lls_sls_mmt_monitor->lls_sls_monitor_output_buffer_mode.http_output_buffer->http_payload_buffer_incoming =  block_Duplicate(lls_sls_monitor_output_buffer_final_muxed_payload->joined_isobmff_block);
-								} else {
-									  block_Resize(lls_slt_monitor->lls_sls_mmt_monitor->lls_sls_monitor_output_buffer_mode.http_output_buffer->http_payload_buffer_incoming, lls_slt_monitor->lls_sls_mmt_monitor->lls_sls_monitor_output_buffer_mode.http_output_buffer->http_payload_buffer_incoming->p_size + lls_sls_monitor_output_buffer_final_muxed_payload->joined_isobmff_block->p_size);
-									  block_Write(lls_slt_monitor->lls_sls_mmt_monitor->lls_sls_monitor_output_buffer_mode.http_output_buffer->http_payload_buffer_incoming, lls_sls_monitor_output_buffer_final_muxed_payload->joined_isobmff_block->p_buffer, lls_sls_monitor_output_buffer_final_muxed_payload->joined_isobmff_block->p_size);
-								}
-
-								lls_sls_monitor_reader_mutex_unlock(lls_slt_monitor->lls_sls_mmt_monitor->lls_sls_monitor_output_buffer_mode.http_output_buffer->http_payload_buffer_mutex);
-							}
-
-                            //ffplay pipe output
-                            if(lls_slt_monitor->lls_sls_mmt_monitor->lls_sls_monitor_output_buffer_mode.ffplay_output_enabled && lls_slt_monitor->lls_sls_mmt_monitor->lls_sls_monitor_output_buffer_mode.pipe_ffplay_buffer) {
-
-                                pipe_buffer_reader_mutex_lock(lls_slt_monitor->lls_sls_mmt_monitor->lls_sls_monitor_output_buffer_mode.pipe_ffplay_buffer);
-
-                                pipe_buffer_unsafe_push_block(lls_slt_monitor->lls_sls_mmt_monitor->lls_sls_monitor_output_buffer_mode.pipe_ffplay_buffer, lls_sls_monitor_output_buffer_final_muxed_payload->joined_isobmff_block->p_buffer, lls_sls_monitor_output_buffer_final_muxed_payload->joined_isobmff_block->i_pos);
-
-                                lls_slt_monitor->lls_sls_mmt_monitor->lls_sls_monitor_output_buffer.has_written_init_box = true;
-
-                                pipe_buffer_notify_semaphore_post(lls_slt_monitor->lls_sls_mmt_monitor->lls_sls_monitor_output_buffer_mode.pipe_ffplay_buffer);
-
-                                //check to see if we have shutdown
-                                lls_slt_monitor_check_and_handle_pipe_ffplay_buffer_is_shutdown(lls_slt_monitor);
-
-                                pipe_buffer_reader_mutex_unlock(lls_slt_monitor->lls_sls_mmt_monitor->lls_sls_monitor_output_buffer_mode.pipe_ffplay_buffer);
-
+                            if(lls_slt_monitor->lls_sls_mmt_monitor->lls_sls_monitor_output_buffer_mode.mfu_chunk_output_enabled) {
+                            	//MFU chunks are emitted as each sample completes, the joined fragment only provides the init box
+                            	lls_sls_monitor_output_buffer_mfu_chunk_set_init_block(lls_sls_monitor_output_buffer_final_muxed_payload);
+                            } else {
+                            	mmtp_process_output_block_to_sinks(lls_slt_monitor, matching_lls_slt_mmt_session->service_id, lls_sls_monitor_output_buffer_final_muxed_payload->joined_isobmff_block);
+
+                            	if(lls_slt_monitor->lls_sls_mmt_monitor->lls_sls_monitor_output_buffer_mode.ffplay_output_enabled && lls_slt_monitor->lls_sls_mmt_monitor->lls_sls_monitor_output_buffer_mode.pipe_ffplay_buffer) {
+                            		lls_slt_monitor->lls_sls_mmt_monitor->lls_sls_monitor_output_buffer.has_written_init_box = true;
+                            	}
+
+                            	uint64_t fragment_first_arrival_ns = lls_sls_monitor_output_buffer_final_muxed_payload->video_output_buffer_isobmff.fragment_first_arrival_ns;
+                            	if(!fragment_first_arrival_ns || (lls_sls_monitor_output_buffer_final_muxed_payload->audio_output_buffer_isobmff.fragment_first_arrival_ns && lls_sls_monitor_output_buffer_final_muxed_payload->audio_output_buffer_isobmff.fragment_first_arrival_ns < fragment_first_arrival_ns)) {
+                            		fragment_first_arrival_ns = lls_sls_monitor_output_buffer_final_muxed_payload->audio_output_buffer_isobmff.fragment_first_arrival_ns;
+                            	}
+                            	__LATENCY_HISTOGRAM_RECORD_SINCE(matching_lls_slt_mmt_session->service_id, ATSC3_LATENCY_STAGE_MPU_SAMPLE_TO_SINK, fragment_first_arrival_ns);
                             }
                         }
                     }
 
 
+                if(lls_slt_monitor->lls_sls_mmt_monitor->lls_sls_monitor_output_buffer_mode.mfu_chunk_output_enabled && mmtp_payload->mmtp_mpu_type_packet_header.mpu_fragment_type == 0x2) {
+                	mmtp_process_mfu_chunk_to_sinks(lls_slt_monitor, matching_lls_slt_mmt_session->service_id, mmtp_payload);
+                }
+
                 //update our last references for mpu_sequence rollover until we process packet_id signaling messages only if our mpu_sequence_number has changed due to malloc/copy the flow reference
                 if(lls_slt_monitor->lls_sls_mmt_monitor->audio_packet_id == last_flow_reference->packet_id &&
                    (!matching_lls_slt_mmt_session->last_udp_flow_packet_id_mpu_sequence_tuple_audio || matching_lls_slt_mmt_session->last_udp_flow_packet_id_mpu_sequence_tuple_audio->mpu_sequence_number != last_flow_reference->mpu_sequence_number )) {
@@ -273,8 +345,9 @@ mmtp_payload_fragments_union_t* mmtp_process_from_payload(mmtp_sub_flow_vector_t
 			mmt_signalling_message_header_and_payload_t* mmt_signalling_message_header_and_payload = mmtp_payload->mmtp_signalling_message_fragments.mmt_signalling_message_vector.messages[i];
 			if(mmt_signalling_message_header_and_payload->message_header.MESSAGE_id_type == MPT_message) {
 				mp_table_t* mp_table = &mmt_signalling_message_header_and_payload->message_payload.mp_table;
-				//update our lls_sls_mmt_session
-				if(matching_lls_slt_mmt_session && mp_table->number_of_assets) {
+				//update our lls_sls_mmt_session, carousel repeats of an unchanged MPT are skipped unless we have not picked up the assets yet
+				bool mpt_changed = mmtp_payload->mmtp_signalling_message_fragments.si_mpt_changed;
+				if(matching_lls_slt_mmt_session && mp_table->number_of_assets && (mpt_changed || (!matching_lls_slt_mmt_session->video_packet_id && !matching_lls_slt_mmt_session->audio_packet_id))) {
 					for(int i=0; i < mp_table->number_of_assets; i++) {
 						//slight hack, check the asset types and default_asset = 1
 						mp_table_asset_row_t* mp_table_asset_row = &mp_table->mp_table_asset_row[i];
@@ -288,6 +361,29 @@ mmtp_payload_fragments_union_t* mmtp_process_from_payload(mmtp_sub_flow_vector_t
 					}
 				}
 
+				//the MFU chunk decode times are anchored on the MPU presentation times, every MPT carries them, not just changed ones
+				if(matching_lls_slt_mmt_session && lls_slt_monitor && lls_slt_monitor->lls_sls_mmt_monitor && lls_slt_monitor->lls_sls_mmt_monitor->service_id == matching_lls_slt_mmt_session->service_id &&
+						lls_slt_monitor->lls_sls_mmt_monitor->lls_sls_monitor_output_buffer_mode.mfu_chunk_output_enabled) {
+					lls_sls_mmt_monitor_t* lls_sls_mmt_monitor = lls_slt_monitor->lls_sls_mmt_monitor;
+					for(int i=0; i < mp_table->number_of_assets; i++) {
+						mp_table_asset_row_t* mp_table_asset_row = &mp_table->mp_table_asset_row[i];
+						lls_sls_monitor_buffer_isobmff_t* lls_sls_monitor_buffer_isobmff = NULL;
+
+						if(mp_table_asset_row->mmt_general_location_info.packet_id == lls_sls_mmt_monitor->video_packet_id) {
+							lls_sls_monitor_buffer_isobmff = &lls_sls_mmt_monitor->lls_sls_monitor_output_buffer.video_output_buffer_isobmff;
+						} else if(mp_table_asset_row->mmt_general_location_info.packet_id == lls_sls_mmt_monitor->audio_packet_id) {
+							lls_sls_monitor_buffer_isobmff = &lls_sls_mmt_monitor->lls_sls_monitor_output_buffer.audio_output_buffer_isobmff;
+						}
+
+						if(lls_sls_monitor_buffer_isobmff && mp_table_asset_row->mmt_signaling_message_mpu_timestamp_descriptor) {
+							for(int j=0; j < mp_table_asset_row->mmt_signaling_message_mpu_timestamp_descriptor->mpu_tuple_n; j++) {
+								mmt_signaling_message_mpu_tuple_t* mmt_signaling_message_mpu_tuple = &mp_table_asset_row->mmt_signaling_message_mpu_timestamp_descriptor->mpu_tuple[j];
+								lls_sls_monitor_buffer_isobmff_mfu_chunk_add_mpu_presentation_time(lls_sls_monitor_buffer_isobmff, mmt_signaling_message_mpu_tuple->mpu_sequence_number, mmt_signaling_message_mpu_tuple->mpu_presentation_time);
+							}
+						}
+					}
+				}
+
 			} else {
 				__MMT_RECON_FROM_SAMPLE_INFO("mmtp_packet_parse: Ignoring signal: 0x%x", mmt_signalling_message_header_and_payload->message_header.MESSAGE_id_type);
 			}
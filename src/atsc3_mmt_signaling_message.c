@@ -35,6 +35,7 @@ mmt_signalling_message_header_and_payload_t* mmt_signalling_message_header_and_p
 	mmt_signalling_message_header_and_payload_t* mmt_signalling_message_header_and_payload = calloc(1, sizeof(mmt_signalling_message_header_and_payload_t));
 	mmt_signalling_message_header_and_payload->message_header.message_id = message_id;
 	mmt_signalling_message_header_and_payload->message_header.version = version;
+	mmt_signalling_message_header_and_payload->ref_count = 1;
 
 	return mmt_signalling_message_header_and_payload;
 }
@@ -54,10 +55,34 @@ void mmt_signalling_message_vector_free(mmt_signalling_message_vector_t** mmt_si
 	}
 }
 
+static void __mmt_signalling_message_mp_table_free(mp_table_t* mp_table) {
+	freesafe(mp_table->mmt_package_id.mmt_package_id);
+	freesafe(mp_table->mp_table_descriptors.mp_table_descriptors_byte);
+
+	for(int i=0; i < mp_table->number_of_assets && mp_table->mp_table_asset_row; i++) {
+		mp_table_asset_row_t* row = &mp_table->mp_table_asset_row[i];
+		freesafe(row->identifier_mapping.asset_id.asset_id);
+		freesafe(row->asset_descriptors_payload);
+		if(row->mmt_signaling_message_mpu_timestamp_descriptor) {
+			freesafe(row->mmt_signaling_message_mpu_timestamp_descriptor->mpu_tuple);
+			freesafe(row->mmt_signaling_message_mpu_timestamp_descriptor);
+		}
+	}
+	freesafe(mp_table->mp_table_asset_row);
+	mp_table->mp_table_asset_row = NULL;
+}
+
 void mmt_signalling_message_header_and_payload_free(mmt_signalling_message_header_and_payload_t** mmt_signalling_message_header_and_payload_p) {
 	mmt_signalling_message_header_and_payload_t* mmt_signalling_message_header_and_payload = *mmt_signalling_message_header_and_payload_p;
 	if(mmt_signalling_message_header_and_payload) {
 
+		//still referenced by the signalling message cache or another packet
+		if(mmt_signalling_message_header_and_payload->ref_count > 1) {
+			mmt_signalling_message_header_and_payload->ref_count--;
+			*mmt_signalling_message_header_and_payload_p = NULL;
+			return;
+		}
+
 		//determine if we have any internal mallocs to clear
 		if(mmt_signalling_message_header_and_payload->message_header.message_id == MMT_ATSC3_MESSAGE_ID) {
 			if(mmt_signalling_message_header_and_payload->message_payload.mmt_atsc3_message_payload.URI_payload) {
@@ -68,6 +93,8 @@ void mmt_signalling_message_header_and_payload_free(mmt_signalling_message_heade
 				free(mmt_signalling_message_header_and_payload->message_payload.mmt_atsc3_message_payload.atsc3_message_content);
 				mmt_signalling_message_header_and_payload->message_payload.mmt_atsc3_message_payload.atsc3_message_content = NULL;
 			}
+		} else if(mmt_signalling_message_header_and_payload->message_header.MESSAGE_id_type == MPT_message) {
+			__mmt_signalling_message_mp_table_free(&mmt_signalling_message_header_and_payload->message_payload.mp_table);
 		}
 
 finally:
@@ -78,6 +105,97 @@ finally:
 }
 
 
+mmt_signalling_message_cache_t* mmt_signalling_message_cache_create() {
+	mmt_signalling_message_cache_t* mmt_signalling_message_cache = calloc(1, sizeof(mmt_signalling_message_cache_t));
+	assert(mmt_signalling_message_cache);
+
+	return mmt_signalling_message_cache;
+}
+
+mmt_signalling_message_header_and_payload_t* mmt_signalling_message_cache_find(mmt_signalling_message_cache_t* mmt_signalling_message_cache, uint16_t message_id, uint8_t version, uint32_t payload_length, uint32_t payload_hash) {
+	for(int i=0; i < mmt_signalling_message_cache->entries_n; i++) {
+		mmt_signalling_message_cache_entry_t* entry = &mmt_signalling_message_cache->entries[i];
+		if(entry->message_id != message_id) {
+			continue;
+		}
+
+		if(entry->version == version && entry->payload_length == payload_length && entry->payload_hash == payload_hash) {
+			entry->hit_count++;
+			mmt_signalling_message_cache->hit_count++;
+			entry->mmt_signalling_message_header_and_payload->ref_count++;
+			return entry->mmt_signalling_message_header_and_payload;
+		}
+		break;
+	}
+
+	mmt_signalling_message_cache->miss_count++;
+	return NULL;
+}
+
+bool mmt_signalling_message_cache_add(mmt_signalling_message_cache_t* mmt_signalling_message_cache, mmt_signalling_message_header_and_payload_t* mmt_signalling_message_header_and_payload, uint32_t payload_length, uint32_t payload_hash) {
+	uint16_t message_id = mmt_signalling_message_header_and_payload->message_header.message_id;
+	mmt_signalling_message_cache_entry_t* entry = NULL;
+	bool replaced = false;
+
+	for(int i=0; i < mmt_signalling_message_cache->entries_n && !entry; i++) {
+		if(mmt_signalling_message_cache->entries[i].message_id == message_id) {
+			entry = &mmt_signalling_message_cache->entries[i];
+			replaced = true;
+		}
+	}
+
+	if(!entry) {
+		if(mmt_signalling_message_cache->entries_n < MMT_SIGNALLING_MESSAGE_CACHE_ENTRIES_MAX) {
+			entry = &mmt_signalling_message_cache->entries[mmt_signalling_message_cache->entries_n++];
+		} else {
+			entry = &mmt_signalling_message_cache->entries[mmt_signalling_message_cache->entries_next_evict];
+			mmt_signalling_message_cache->entries_next_evict = (mmt_signalling_message_cache->entries_next_evict + 1) % MMT_SIGNALLING_MESSAGE_CACHE_ENTRIES_MAX;
+		}
+	}
+
+	//packets still holding the previous message keep their own reference
+	mmt_signalling_message_header_and_payload_free(&entry->mmt_signalling_message_header_and_payload);
+
+	entry->message_id = message_id;
+	entry->version = mmt_signalling_message_header_and_payload->message_header.version;
+	entry->payload_length = payload_length;
+	entry->payload_hash = payload_hash;
+	entry->hit_count = 0;
+	entry->mmt_signalling_message_header_and_payload = mmt_signalling_message_header_and_payload;
+	mmt_signalling_message_header_and_payload->ref_count++;
+
+	if(mmt_signalling_message_header_and_payload->message_header.MESSAGE_id_type == MPT_message) {
+		mmt_signalling_message_cache->mpt_change_count++;
+	}
+
+	return replaced;
+}
+
+void mmt_signalling_message_cache_free(mmt_signalling_message_cache_t** mmt_signalling_message_cache_p) {
+	mmt_signalling_message_cache_t* mmt_signalling_message_cache = *mmt_signalling_message_cache_p;
+	if(mmt_signalling_message_cache) {
+		for(int i=0; i < mmt_signalling_message_cache->entries_n; i++) {
+			mmt_signalling_message_header_and_payload_free(&mmt_signalling_message_cache->entries[i].mmt_signalling_message_header_and_payload);
+		}
+		free(mmt_signalling_message_cache);
+		*mmt_signalling_message_cache_p = NULL;
+	}
+}
+
+//PA and MPI carry a 32 bit length, every other cached message a 16 bit length
+static bool __mmt_signalling_message_is_cacheable(uint16_t message_id) {
+	return message_id == PA_message || (message_id >= MPI_message_start && message_id < MPI_message_end) || (message_id >= MPT_message_start && message_id <= MPT_message_end);
+}
+
+//FNV-1a over the length field and message body
+static uint32_t __mmt_signalling_message_payload_hash(uint8_t* buf, uint32_t len) {
+	uint32_t hash = 2166136261u;
+	for(uint32_t i=0; i < len; i++) {
+		hash = (hash ^ buf[i]) * 16777619u;
+	}
+	return hash;
+}
+
 /**
  *
  * MPU_timestamp_descriptor message example
@@ -209,6 +327,43 @@ uint8_t* mmt_signaling_message_parse_id_type(mmtp_payload_fragments_union_t *mmt
 	uint8_t version;
 	buf = extract(buf, &version, 1);
 
+	//repeats of an unchanged PA/MPI/MPT are handed the previously parsed message, see mmt_signalling_message_cache_t
+	mmtp_sub_flow_t* mmtp_sub_flow = mmtp_signalling_packet->mmtp_packet_header.mmtp_sub_flow;
+	mmt_signalling_message_cache_t* mmt_signalling_message_cache = NULL;
+	uint32_t payload_length = 0;
+	uint32_t payload_hash = 0;
+	uint32_t remaining = buf_size > (buf - raw_buf) ? buf_size - (buf - raw_buf) : 0;
+
+	if(mmtp_sub_flow && __mmt_signalling_message_is_cacheable(message_id)) {
+		uint32_t length_field_size = message_id < MPT_message_start ? 4 : 2;
+		if(remaining >= length_field_size) {
+			uint32_t length;
+			if(length_field_size == 4) {
+				uint32_t length_long;
+				memcpy(&length_long, buf, 4);
+				length = ntohl(length_long);
+			} else {
+				uint16_t length_short;
+				memcpy(&length_short, buf, 2);
+				length = ntohs(length_short);
+			}
+			payload_length = __MIN(length_field_size + length, remaining);
+			payload_hash = __mmt_signalling_message_payload_hash(buf, payload_length);
+
+			if(!mmtp_sub_flow->mmt_signalling_message_cache) {
+				mmtp_sub_flow->mmt_signalling_message_cache = mmt_signalling_message_cache_create();
+			}
+			mmt_signalling_message_cache = mmtp_sub_flow->mmt_signalling_message_cache;
+
+			mmt_signalling_message_header_and_payload_t* mmt_signalling_message_header_and_payload_cached = mmt_signalling_message_cache_find(mmt_signalling_message_cache, message_id, version, payload_length, payload_hash);
+			if(mmt_signalling_message_header_and_payload_cached) {
+				_MMSM_TRACE("signalling message cache hit: packet_id: %u, message_id: 0x%04x, version: %u, length: %u", mmtp_sub_flow->mmtp_packet_id, message_id, version, payload_length);
+				mmt_signalling_message_vector_add(&mmtp_signalling_packet->mmtp_signalling_message_fragments.mmt_signalling_message_vector, mmt_signalling_message_header_and_payload_cached);
+				return buf + payload_length;
+			}
+		}
+	}
+
 	mmt_signalling_message_header_and_payload_t* mmt_signalling_message_header_and_payload = mmt_signalling_message_header_and_payload_create(message_id, version);
 	mmt_signalling_message_vector_add(&mmtp_signalling_packet->mmtp_signalling_message_fragments.mmt_signalling_message_vector, mmt_signalling_message_header_and_payload);
 	mmt_signalling_message_header_t* mmt_signalling_message_header = &mmt_signalling_message_header_and_payload->message_header;
@@ -311,6 +466,15 @@ uint8_t* mmt_signaling_message_parse_id_type(mmtp_payload_fragments_union_t *mmt
 		buf = si_message_not_supported(mmt_signalling_message_header_and_payload, buf, buf_size);
 	}
 
+	if(mmt_signalling_message_header_and_payload->message_header.MESSAGE_id_type == MPT_message) {
+		mmtp_signalling_packet->mmtp_signalling_message_fragments.si_mpt_changed = 1;
+	}
+
+	if(mmt_signalling_message_cache) {
+		bool replaced = mmt_signalling_message_cache_add(mmt_signalling_message_cache, mmt_signalling_message_header_and_payload, payload_length, payload_hash);
+		_MMSM_DEBUG("signalling message cache %s: packet_id: %u, message_id: 0x%04x, version: %u, length: %u", replaced ? "update" : "add", mmtp_sub_flow->mmtp_packet_id, message_id, version, payload_length);
+	}
+
 	return buf;
 
 }
@@ -463,7 +627,7 @@ uint8_t* mpt_message_parse(mmt_signalling_message_header_and_payload_t* mmt_sign
             //TODO: bounds check this untrusted read..
             _MMSM_DEBUG("reading mp_table_descriptors size: %u", mp_table->mp_table_descriptors.mp_table_descriptors_length);
             mp_table->mp_table_descriptors.mp_table_descriptors_byte = calloc(mp_table->mp_table_descriptors.mp_table_descriptors_length, sizeof(uint8_t));
-            buf = extract(buf, (uint8_t*)&mp_table->mp_table_descriptors.mp_table_descriptors_byte, mp_table->mp_table_descriptors.mp_table_descriptors_length);
+            buf = extract(buf, mp_table->mp_table_descriptors.mp_table_descriptors_byte, mp_table->mp_table_descriptors.mp_table_descriptors_length);
         }
     }
 
@@ -97,6 +97,13 @@ mmt_signalling_message_header_and_payload_t* mmt_signalling_message_header_and_p
 
 void mmt_signalling_message_vector_free(mmt_signalling_message_vector_t**);
 
+mmt_signalling_message_cache_t* mmt_signalling_message_cache_create();
+//returns a new reference to the cached message if version, length and payload hash all match, NULL otherwise
+mmt_signalling_message_header_and_payload_t* mmt_signalling_message_cache_find(mmt_signalling_message_cache_t* mmt_signalling_message_cache, uint16_t message_id, uint8_t version, uint32_t payload_length, uint32_t payload_hash);
+//takes a reference to a freshly parsed message, returns true if it replaced an older one for the same message_id
+bool mmt_signalling_message_cache_add(mmt_signalling_message_cache_t* mmt_signalling_message_cache, mmt_signalling_message_header_and_payload_t* mmt_signalling_message_header_and_payload, uint32_t payload_length, uint32_t payload_hash);
+void mmt_signalling_message_cache_free(mmt_signalling_message_cache_t** mmt_signalling_message_cache_p);
+
 uint8_t* mmt_signaling_message_parse_packet_header(mmtp_payload_fragments_union_t* si_message, uint8_t* udp_raw_buf, uint32_t udp_raw_buf_size);
 uint8_t* mmt_signaling_message_parse_packet(mmtp_payload_fragments_union_t *si_message, uint8_t* udp_raw_buf, uint32_t udp_raw_buf_size);
 uint8_t* mmt_signaling_message_parse_id_type(mmtp_payload_fragments_union_t *si_message, uint8_t* udp_raw_buf, uint32_t udp_raw_buf_size);
@@ -29,6 +29,7 @@ static char* __get_test_mmt_signaling_message_mpt_table_mpu_timestamp_descriptor
 
 void __create_binary_payload(char *test_payload_base64, uint8_t **binary_payload, int * binary_payload_size);
 int test_mmt_signaling_message_mpu_timestamp_descriptor_table(char* base64_payload);
+int test_mmt_signaling_message_mpt_cache(char* base64_payload);
 
 int main() {
 	_MMT_SIGNALLING_MESSAGE_DEBUG_ENABLED = 1;
@@ -36,7 +37,7 @@ int main() {
 //	test_mmt_signaling_message_mpu_timestamp_descriptor_table(__get_test_mmt_signaling_message_mpu_timestamp_descriptor());
     test_mmt_signaling_message_mpu_timestamp_descriptor_table(__get_test_mmt_signaling_message_mpt_table_mpu_timestamp_descriptor_with_ac4_audio());
 
-    return 0;
+    return test_mmt_signaling_message_mpt_cache(__get_test_mmt_signaling_message_mpt_table_mpu_timestamp_descriptor_with_ac4_audio());
 }
 
 
@@ -67,6 +68,52 @@ int test_mmt_signaling_message_mpu_timestamp_descriptor_table(char* base64_paylo
 	return 0;
 }
 
+/**
+ * the same MPT on the same sub flow must come back from the cache, a changed mpu_presentation_time must not
+ */
+int test_mmt_signaling_message_mpt_cache(char* base64_payload) {
+	uint8_t* binary_payload;
+	int binary_payload_size;
+
+	__create_binary_payload(base64_payload, &binary_payload, &binary_payload_size);
+
+	mmtp_sub_flow_vector_t* mmtp_sub_flow_vector = calloc(1, sizeof(mmtp_sub_flow_vector_t));
+	mmtp_sub_flow_vector_init(mmtp_sub_flow_vector);
+
+	mmtp_payload_fragments_union_t* first = mmtp_packet_parse(mmtp_sub_flow_vector, binary_payload, binary_payload_size);
+	mmtp_payload_fragments_union_t* repeat = mmtp_packet_parse(mmtp_sub_flow_vector, binary_payload, binary_payload_size);
+
+	//last byte of the mpu_presentation_time in the mpu_timestamp_descriptor, the MPT version is unchanged
+	binary_payload[binary_payload_size - 2] ^= 0x01;
+	mmtp_payload_fragments_union_t* changed = mmtp_packet_parse(mmtp_sub_flow_vector, binary_payload, binary_payload_size);
+
+	if(!first || !repeat || !changed) {
+		_MMSM_ERROR("test_mmt_signaling_message_mpt_cache - parse failed");
+		return -1;
+	}
+
+	mmt_signalling_message_header_and_payload_t* first_mpt = first->mmtp_signalling_message_fragments.mmt_signalling_message_vector.messages[0];
+	mmt_signalling_message_header_and_payload_t* repeat_mpt = repeat->mmtp_signalling_message_fragments.mmt_signalling_message_vector.messages[0];
+	mmt_signalling_message_header_and_payload_t* changed_mpt = changed->mmtp_signalling_message_fragments.mmt_signalling_message_vector.messages[0];
+
+	if(!first->mmtp_signalling_message_fragments.si_mpt_changed || first_mpt->message_header.MESSAGE_id_type != MPT_message) {
+		_MMSM_ERROR("test_mmt_signaling_message_mpt_cache - first MPT not flagged as changed");
+		return -1;
+	}
+	if(repeat_mpt != first_mpt || repeat->mmtp_signalling_message_fragments.si_mpt_changed) {
+		_MMSM_ERROR("test_mmt_signaling_message_mpt_cache - repeated MPT was reparsed, first: %p, repeat: %p", first_mpt, repeat_mpt);
+		return -1;
+	}
+	if(changed_mpt == first_mpt || !changed->mmtp_signalling_message_fragments.si_mpt_changed ||
+			changed_mpt->message_payload.mp_table.mp_table_asset_row[0].mmt_signaling_message_mpu_timestamp_descriptor->mpu_tuple[0].mpu_presentation_time ==
+			first_mpt->message_payload.mp_table.mp_table_asset_row[0].mmt_signaling_message_mpu_timestamp_descriptor->mpu_tuple[0].mpu_presentation_time) {
+		_MMSM_ERROR("test_mmt_signaling_message_mpt_cache - changed MPT was not reparsed");
+		return -1;
+	}
+
+	_MMSM_INFO("test_mmt_signaling_message_mpt_cache - OK, first ref_count: %u, changed ref_count: %u", first_mpt->ref_count, changed_mpt->ref_count);
+	return 0;
+}
 
 void __create_binary_payload(char *test_payload_base64, uint8_t **binary_payload, int * binary_payload_size) {
 	int test_payload_base64_length = strlen(test_payload_base64);
@@ -319,6 +319,9 @@ typedef union mmt_signalling_message_type {
 typedef struct mmt_signalling_message_id_type {
 	mmt_signalling_message_header_t 	message_header;
 	mmt_signalling_message_payload_u 	message_payload;
+
+	//a cached message is shared by the cache and every packet it was handed to, freed when this drops to 0
+	uint32_t							ref_count;
 } mmt_signalling_message_header_and_payload_t;
 
 typedef struct mmt_signalling_message_vector {
@@ -326,4 +329,32 @@ typedef struct mmt_signalling_message_vector {
 	mmt_signalling_message_header_and_payload_t** 	messages;
 } mmt_signalling_message_vector_t;
 
+/**
+ * versioned signalling message cache, one per mmtp_sub_flow (flow + packet_id), one entry per message_id
+ *
+ * PA, MPI and MPT messages are repeated on every carousel interval, usually unchanged. a repeat whose version, length
+ * and payload hash all match the entry is handed back as the previously parsed message. the version alone is not
+ * enough, the MPT mpu_timestamp_descriptor moves forward on every MPU without a version bump.
+ */
+#define MMT_SIGNALLING_MESSAGE_CACHE_ENTRIES_MAX 8
+
+typedef struct mmt_signalling_message_cache_entry {
+	uint16_t										message_id;
+	uint8_t											version;
+	uint32_t										payload_length;
+	uint32_t										payload_hash;
+	uint32_t										hit_count;
+	mmt_signalling_message_header_and_payload_t*	mmt_signalling_message_header_and_payload;
+} mmt_signalling_message_cache_entry_t;
+
+typedef struct mmt_signalling_message_cache {
+	mmt_signalling_message_cache_entry_t	entries[MMT_SIGNALLING_MESSAGE_CACHE_ENTRIES_MAX];
+	uint32_t								entries_n;
+	uint32_t								entries_next_evict;
+
+	uint32_t								hit_count;
+	uint32_t								miss_count;
+	uint32_t								mpt_change_count;
+} mmt_signalling_message_cache_t;
+
 #endif /* ATSC3_MMT_SIGNALLING_MESSAGE_TYPES_H_ */
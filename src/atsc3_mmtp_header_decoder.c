@@ -0,0 +1,114 @@
+/*
+ * atsc3_mmtp_header_decoder.c
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: jjustman
+ */
+
+#include "atsc3_mmtp_header_decoder.h"
+
+uint32_t mmtp_packet_header_fixed_decode(const uint8_t* buf, uint32_t buf_len, mmtp_packet_header_fixed_t* mmtp_packet_header_fixed) {
+	if(buf_len < MMTP_PACKET_HEADER_FIXED_MIN_LEN) {
+		return 0;
+	}
+
+	//V C FEC X R Q | F E B I type | packet_id | timestamp
+	uint64_t word0 = atsc3_load_be64(buf);
+	uint8_t byte0 = word0 >> 56;
+
+	//A/331 8.1.2.1.3: the value of the version field of MMTP packets shall be '01'
+	if((byte0 >> 6) != 0x1) {
+		return 0;
+	}
+
+	uint32_t packet_counter_flag = (byte0 >> 5) & 0x1;
+	uint32_t header_extension_flag = (byte0 >> 2) & 0x1;
+
+	uint32_t qos_offset = 12 + (packet_counter_flag << 2);
+	uint32_t header_length = qos_offset + 2 + (header_extension_flag << 2);
+	if(buf_len < header_length) {
+		return 0;
+	}
+
+	uint8_t byte1 = word0 >> 48;
+
+	mmtp_packet_header_fixed->mmtp_packet_version				= byte0 >> 6;
+	mmtp_packet_header_fixed->packet_counter_flag				= packet_counter_flag;
+	mmtp_packet_header_fixed->fec_type							= (byte0 >> 3) & 0x3;
+	mmtp_packet_header_fixed->mmtp_header_extension_flag		= header_extension_flag;
+	mmtp_packet_header_fixed->mmtp_rap_flag						= (byte0 >> 1) & 0x1;
+	mmtp_packet_header_fixed->mmtp_qos_flag						= byte0 & 0x1;
+
+	mmtp_packet_header_fixed->mmtp_flow_identifer_flag			= (byte1 >> 7) & 0x1;
+	mmtp_packet_header_fixed->mmtp_flow_extension_flag			= (byte1 >> 6) & 0x1;
+	mmtp_packet_header_fixed->mmtp_header_compression			= (byte1 >> 5) & 0x1;
+	mmtp_packet_header_fixed->mmtp_indicator_ref_header_flag	= (byte1 >> 4) & 0x1;
+	mmtp_packet_header_fixed->mmtp_payload_type					= byte1 & 0xF;
+
+	mmtp_packet_header_fixed->mmtp_packet_id					= (word0 >> 32) & 0xFFFF;
+	mmtp_packet_header_fixed->mmtp_timestamp					= word0 & 0xFFFFFFFF;
+	mmtp_packet_header_fixed->packet_sequence_number			= atsc3_load_be32(buf + 8);
+	mmtp_packet_header_fixed->packet_counter					= packet_counter_flag ? atsc3_load_be32(buf + 12) : 0;
+
+	//r(1) TB(2) DS(3) TP(3) flow_label(7)
+	uint16_t qos = atsc3_load_be16(buf + qos_offset);
+	mmtp_packet_header_fixed->mmtp_type_of_bitrate				= (qos >> 13) & 0x3;
+	mmtp_packet_header_fixed->mmtp_delay_sensitivity			= (qos >> 10) & 0x7;
+	mmtp_packet_header_fixed->mmtp_transmission_priority		= (qos >> 7) & 0x7;
+	mmtp_packet_header_fixed->flow_label						= qos & 0x7F;
+
+	if(header_extension_flag) {
+		uint32_t header_extension = atsc3_load_be32(buf + qos_offset + 2);
+		mmtp_packet_header_fixed->mmtp_header_extension_type	= header_extension >> 16;
+		mmtp_packet_header_fixed->mmtp_header_extension_length	= header_extension & 0xFFFF;
+
+		header_length += mmtp_packet_header_fixed->mmtp_header_extension_length;
+		if(buf_len < header_length) {
+			return 0;
+		}
+	} else {
+		mmtp_packet_header_fixed->mmtp_header_extension_type	= 0;
+		mmtp_packet_header_fixed->mmtp_header_extension_length	= 0;
+	}
+
+	mmtp_packet_header_fixed->header_length = header_length;
+
+	return header_length;
+}
+
+uint32_t mmt_mpu_payload_header_fixed_decode(const uint8_t* buf, uint32_t buf_len, mmt_mpu_payload_header_fixed_t* mmt_mpu_payload_header_fixed) {
+	if(buf_len < MMT_MPU_PAYLOAD_HEADER_LEN) {
+		return 0;
+	}
+
+	uint64_t word0 = atsc3_load_be64(buf);
+	uint8_t fragmentation_info = word0 >> 40;
+
+	mmt_mpu_payload_header_fixed->mpu_payload_length			= word0 >> 48;
+	mmt_mpu_payload_header_fixed->mpu_fragment_type				= fragmentation_info >> 4;
+	mmt_mpu_payload_header_fixed->mpu_timed_flag				= (fragmentation_info >> 3) & 0x1;
+	mmt_mpu_payload_header_fixed->mpu_fragmentation_indicator	= (fragmentation_info >> 1) & 0x3;
+	mmt_mpu_payload_header_fixed->mpu_aggregation_flag			= fragmentation_info & 0x1;
+	mmt_mpu_payload_header_fixed->mpu_fragmentation_counter		= (word0 >> 32) & 0xFF;
+	mmt_mpu_payload_header_fixed->mpu_sequence_number			= word0 & 0xFFFFFFFF;
+
+	return MMT_MPU_PAYLOAD_HEADER_LEN;
+}
+
+uint32_t mmt_mfu_timed_header_fixed_decode(const uint8_t* buf, uint32_t buf_len, mmt_mfu_timed_header_fixed_t* mmt_mfu_timed_header_fixed) {
+	if(buf_len < MMT_MFU_TIMED_HEADER_LEN) {
+		return 0;
+	}
+
+	uint64_t word0 = atsc3_load_be64(buf);
+	uint32_t word1 = atsc3_load_be32(buf + 8);
+	uint16_t word2 = atsc3_load_be16(buf + 12);
+
+	mmt_mfu_timed_header_fixed->movie_fragment_sequence_number	= word0 >> 32;
+	mmt_mfu_timed_header_fixed->sample_number					= word0 & 0xFFFFFFFF;
+	mmt_mfu_timed_header_fixed->offset							= word1;
+	mmt_mfu_timed_header_fixed->priority						= word2 >> 8;
+	mmt_mfu_timed_header_fixed->dep_counter						= word2 & 0xFF;
+
+	return MMT_MFU_TIMED_HEADER_LEN;
+}
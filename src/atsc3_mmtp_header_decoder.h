@@ -0,0 +1,124 @@
+/*
+ * atsc3_mmtp_header_decoder.h
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: jjustman
+ *
+ * fixed layout decoders for the MMTP packet header, MPU payload header and timed MFU data unit header
+ *
+ * each header is read with unaligned 16/32/64-bit big-endian loads into a compact POD struct in one step,
+ * instead of extract() into stack arrays followed by per byte shifts. the version is checked on the first
+ * byte and anything other than '01' (A/331 8.1.2.1.3) is rejected before the rest of the header is touched.
+ *
+ * all decoders return the number of bytes consumed, or 0 if buf is too short or the header is invalid
+ *
+ * MMTP packet header, ISO/IEC 23008-1 clause 9.2.2, V=1:
+ *
+ * 	 0: V(2) C(1) FEC(2) X(1) R(1) Q(1)		1: F(1) E(1) B(1) I(1) type(4)		2: packet_id(16)
+ * 	 4: timestamp(32)
+ * 	 8: packet_sequence_number(32)
+ * 	12: packet_counter(32), only if C=1
+ * 	 +: r(1) TB(2) DS(3) TP(3) flow_label(7)
+ * 	 +: header_extension type(16) length(16) value(length bytes), only if X=1
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#ifndef ATSC3_MMTP_HEADER_DECODER_H_
+#define ATSC3_MMTP_HEADER_DECODER_H_
+
+#if defined (__cplusplus)
+extern "C" {
+#endif
+
+//C=0, X=0
+#define MMTP_PACKET_HEADER_FIXED_MIN_LEN	14
+#define MMT_MPU_PAYLOAD_HEADER_LEN			8
+#define MMT_MFU_TIMED_HEADER_LEN			14
+
+typedef struct mmtp_packet_header_fixed {
+	uint32_t	mmtp_timestamp;
+	uint32_t	packet_sequence_number;
+	uint32_t	packet_counter;
+	uint16_t	mmtp_packet_id;
+	uint16_t	mmtp_header_extension_type;
+	uint16_t	mmtp_header_extension_length;
+	uint16_t	header_length;					//including the header extension value
+	uint8_t		mmtp_packet_version;
+	uint8_t		mmtp_payload_type;
+	uint8_t		packet_counter_flag;
+	uint8_t		fec_type;
+	uint8_t		mmtp_header_extension_flag;
+	uint8_t		mmtp_rap_flag;
+	uint8_t		mmtp_qos_flag;
+	uint8_t		mmtp_flow_identifer_flag;
+	uint8_t		mmtp_flow_extension_flag;
+	uint8_t		mmtp_header_compression;
+	uint8_t		mmtp_indicator_ref_header_flag;
+	uint8_t		mmtp_type_of_bitrate;
+	uint8_t		mmtp_delay_sensitivity;
+	uint8_t		mmtp_transmission_priority;
+	uint8_t		flow_label;
+} mmtp_packet_header_fixed_t;
+
+//payload_length(16) FT(4) T(1) f_i(2) A(1) fragment_counter(8) mpu_sequence_number(32)
+typedef struct mmt_mpu_payload_header_fixed {
+	uint32_t	mpu_sequence_number;
+	uint16_t	mpu_payload_length;
+	uint8_t		mpu_fragment_type;
+	uint8_t		mpu_timed_flag;
+	uint8_t		mpu_fragmentation_indicator;
+	uint8_t		mpu_aggregation_flag;
+	uint8_t		mpu_fragmentation_counter;
+} mmt_mpu_payload_header_fixed_t;
+
+//movie_fragment_sequence_number(32) sample_number(32) offset(32) priority(8) dep_counter(8)
+typedef struct mmt_mfu_timed_header_fixed {
+	uint32_t	movie_fragment_sequence_number;
+	uint32_t	sample_number;
+	uint32_t	offset;
+	uint8_t		priority;
+	uint8_t		dep_counter;
+} mmt_mfu_timed_header_fixed_t;
+
+static inline uint16_t atsc3_load_be16(const uint8_t* buf) {
+	uint16_t value;
+	memcpy(&value, buf, sizeof(value));
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+	return value;
+#else
+	return __builtin_bswap16(value);
+#endif
+}
+
+static inline uint32_t atsc3_load_be32(const uint8_t* buf) {
+	uint32_t value;
+	memcpy(&value, buf, sizeof(value));
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+	return value;
+#else
+	return __builtin_bswap32(value);
+#endif
+}
+
+static inline uint64_t atsc3_load_be64(const uint8_t* buf) {
+	uint64_t value;
+	memcpy(&value, buf, sizeof(value));
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+	return value;
+#else
+	return __builtin_bswap64(value);
+#endif
+}
+
+uint32_t mmtp_packet_header_fixed_decode(const uint8_t* buf, uint32_t buf_len, mmtp_packet_header_fixed_t* mmtp_packet_header_fixed);
+uint32_t mmt_mpu_payload_header_fixed_decode(const uint8_t* buf, uint32_t buf_len, mmt_mpu_payload_header_fixed_t* mmt_mpu_payload_header_fixed);
+uint32_t mmt_mfu_timed_header_fixed_decode(const uint8_t* buf, uint32_t buf_len, mmt_mfu_timed_header_fixed_t* mmt_mfu_timed_header_fixed);
+
+#if defined (__cplusplus)
+}
+#endif
+
+#endif /* ATSC3_MMTP_HEADER_DECODER_H_ */
@@ -43,6 +43,18 @@ void compute_ntp64_to_seconds_microseconds(uint64_t timestamp, uint32_t *seconds
 	*microseconds = (uint32_t)( (double)tmp_mmtp_fractional_s * 1.0e6 / (double)(1LL<<32) );
 
 }
+uint64_t compute_ntp32_to_microseconds(uint32_t timestamp) {
+	return (uint64_t)(timestamp >> 16) * 1000000ULL + (((uint64_t)(timestamp & 0xFFFF) * 1000000ULL) >> 16);
+}
+
+uint64_t compute_ntp64_to_microseconds(uint64_t timestamp) {
+	return (timestamp >> 32) * 1000000ULL + (((timestamp & 0xFFFFFFFF) * 1000000ULL) >> 32);
+}
+
+uint64_t compute_timeval_to_ntp64_microseconds(const struct timeval* tv) {
+	return ((uint64_t)tv->tv_sec + NTP_UNIX_EPOCH_OFFSET_S) * 1000000ULL + tv->tv_usec;
+}
+
 /*
  *
  * make sure to call above to un-fractionalize fractions
@@ -10,6 +10,7 @@
 
 #include "atsc3_utils.h"
 #include <time.h>
+#include <sys/time.h>
 #include <stdio.h>
 
 
@@ -26,6 +27,10 @@
  */
 #define REBASE_PTS_OFFSET 0
 
+//seconds from the ntp epoch (1900) to the unix epoch (1970)
+#define NTP_UNIX_EPOCH_OFFSET_S 2208988800ULL
+#define NTP32_SHORT_FORMAT_ERA_US (65536ULL * 1000000ULL)
+
 #if defined (__cplusplus)
 extern "C" {
 #endif
@@ -33,6 +38,12 @@ extern "C" {
 void compute_ntp32_to_seconds_microseconds(uint32_t timestamp, uint16_t *seconds, uint16_t *microseconds);
 void compute_ntp64_to_seconds_microseconds(uint64_t timestamp, uint32_t *seconds, uint32_t *microseconds);
 
+//full precision microseconds, ntp32 is relative to the start of its 65536s short-format era
+uint64_t compute_ntp32_to_microseconds(uint32_t timestamp);
+uint64_t compute_ntp64_to_microseconds(uint64_t timestamp);
+//wall clock (e.g. pcap capture time) as microseconds since the ntp epoch
+uint64_t compute_timeval_to_ntp64_microseconds(const struct timeval* tv);
+
 uint64_t compute_relative_ntp32_pts(uint64_t first_pts, uint16_t mmtp_timestamp_s, uint16_t mmtp_timestamp_microseconds);
 int64_t rebase_now_with_ntp32(uint16_t mmtp_timestamp_s, uint16_t mmtp_timestamp_microseconds);
 
@@ -12,10 +12,11 @@
 
 #include "atsc3_mmtp_types.h"
 #include "atsc3_mmtp_parser.h"
+#include "atsc3_mmtp_header_decoder.h"
 #include "atsc3_mmt_mpu_parser.h"
 #include "atsc3_mmt_signaling_message.h"
 
-int _MMTP_DEBUG_ENABLED = 1;
+int _MMTP_DEBUG_ENABLED = 0;
 int _MMTP_TRACE_ENABLED = 0;
 
 /*
@@ -23,8 +24,6 @@ int _MMTP_TRACE_ENABLED = 0;
    The value of the version field of MMTP packets shall be '01'.
  */
 
-#define _ISO23008_1_MMTP_VERSION_0x00_SUPPORT_ false
-
 /*
  * The value of the packet_id field of MMTP packets shall be between 0x0010 and 0x1FFE for easy conversion of an MMTP stream to an MPEG-2 TS.
  * The value of the packet_id field of MMTP packets for each content component can be randomly assigned, but the value of the packet_id field of
@@ -57,106 +56,55 @@ int _MMTP_TRACE_ENABLED = 0;
  */
 
 
-//returns pointer from udp_raw_buf where we completed header parsing
+//returns pointer from udp_raw_buf where we completed header parsing, i.e. after the header extension if present
 uint8_t* mmtp_packet_header_parse_from_raw_packet(mmtp_payload_fragments_union_t *mmtp_packet, uint8_t* udp_raw_buf, int udp_raw_buf_size) {
-	if(udp_raw_buf_size < 20) {
-		//bail, the min header is at least 20 bytes
-		_MMTP_ERROR("mmtp_packet_header_parse_from_raw_packet, udp_raw_buf size is: %d, need at least 20 bytes", udp_raw_buf_size);
+	mmtp_packet_header_fixed_t mmtp_packet_header_fixed;
+
+	if(udp_raw_buf_size < MMTP_PACKET_HEADER_FIXED_MIN_LEN) {
+		//bail, the min header is at least 14 bytes (no packet_counter and no header extension)
+		_MMTP_ERROR("mmtp_packet_header_parse_from_raw_packet, udp_raw_buf size is: %d, need at least %d bytes", udp_raw_buf_size, MMTP_PACKET_HEADER_FIXED_MIN_LEN);
 		return NULL;
 	}
 
-	uint8_t *raw_buf = udp_raw_buf;
-	uint8_t *buf = udp_raw_buf;
-
-	uint8_t mmtp_packet_preamble[20];
-
-	//msg_Warn( p_demux, "buf pos before extract is: %p", (void *)buf);
-	buf = extract(buf, mmtp_packet_preamble, 20);
-
 	//A/331 Section 8.1.2.1.3 Constraints on MMTP
 	// The value of the version field of MMTP packets shall be '01'.
-#if !_ISO23008_1_MMTP_VERSION_0x00_SUPPORT_
-	mmtp_packet->mmtp_packet_header.mmtp_packet_version = (mmtp_packet_preamble[0] & 0xC0) >> 6;
-	if(mmtp_packet->mmtp_packet_header.mmtp_packet_version != 0x1) {
-		_MMTP_ERROR("MMTP version field != 0x1, value is 0x%x, bailing!", mmtp_packet->mmtp_packet_header.mmtp_packet_version);
-		goto error;
+	uint32_t header_length = mmtp_packet_header_fixed_decode(udp_raw_buf, udp_raw_buf_size, &mmtp_packet_header_fixed);
+	if(!header_length) {
+		_MMTP_ERROR("mmtp_packet_header_parse_from_raw_packet: invalid header, version: 0x%x, udp_raw_buf_size: %d", (udp_raw_buf[0] >> 6) & 0x3, udp_raw_buf_size);
+		return NULL;
 	}
-#endif
-
-	mmtp_packet->mmtp_packet_header.packet_counter_flag = (mmtp_packet_preamble[0] & 0x20) >> 5;
-	mmtp_packet->mmtp_packet_header.fec_type = (mmtp_packet_preamble[0] & 0x18) >> 3;
-
-#if _ISO23008_1_MMTP_VERSION_0x00_SUPPORT_
-
-	if(mmtp_packet->mmtp_packet_header.mmtp_packet_version == 0x00) {
-		//after fec_type, with v=0, next bitmask is 0x4 >>2
-		//0000 0010
-		//V0CF E-XR
-		mmtp_packet->mmtp_packet_header.mmtp_header_extension_flag = (mmtp_packet_preamble[0] & 0x2) >> 1;
-		mmtp_packet->mmtp_packet_header.mmtp_rap_flag = mmtp_packet_preamble[0] & 0x1;
-
-		//6 bits right aligned
-		mmtp_packet->mmtp_packet_header.mmtp_payload_type = mmtp_packet_preamble[1] & 0x3f;
-		if(mmtp_packet->mmtp_packet_header.mmtp_header_extension_flag & 0x1) {
-			mmtp_packet->mmtp_packet_header.mmtp_header_extension_type = (mmtp_packet_preamble[16]) << 8 | mmtp_packet_preamble[17];
-			mmtp_packet->mmtp_packet_header.mmtp_header_extension_length = (mmtp_packet_preamble[18]) << 8 | mmtp_packet_preamble[19];
-		} else {
-			//walk back by 4 bytes
-			buf-=4;
-		}
-	} else
-
-#endif
-
-	if(mmtp_packet->mmtp_packet_header.mmtp_packet_version == 0x01) {
-		//bitmask is 0000 00
-		//0000 0100
-		//V1CF EXRQ
-		mmtp_packet->mmtp_packet_header.mmtp_header_extension_flag = mmtp_packet_preamble[0] & 0x4 >> 2; //X
-		mmtp_packet->mmtp_packet_header.mmtp_rap_flag = (mmtp_packet_preamble[0] & 0x2) >> 1;				//RAP
-		mmtp_packet->mmtp_packet_header.mmtp_qos_flag = mmtp_packet_preamble[0] & 0x1;					//QOS
-		//0000 0000
-		//FEBI TYPE
-		//4 bits for preamble right aligned
-
-		mmtp_packet->mmtp_packet_header.mmtp_flow_identifer_flag = ((mmtp_packet_preamble[1]) & 0x80) >> 7;			//F
-		mmtp_packet->mmtp_packet_header.mmtp_flow_extension_flag = ((mmtp_packet_preamble[1]) & 0x40) >> 6;			//E
-		mmtp_packet->mmtp_packet_header.mmtp_header_compression = ((mmtp_packet_preamble[1]) &  0x20) >> 5; 		//B
-		mmtp_packet->mmtp_packet_header.mmtp_indicator_ref_header_flag = ((mmtp_packet_preamble[1]) & 0x10) >> 4;	//I
-
-		mmtp_packet->mmtp_packet_header.mmtp_payload_type = mmtp_packet_preamble[1] & 0xF;
-
-		//TB 2 bits
-		mmtp_packet->mmtp_packet_header.mmtp_type_of_bitrate = ((mmtp_packet_preamble[16] & 0x40) >> 6) | ((mmtp_packet_preamble[16] & 0x20) >> 5);
-
-		//DS 3 bits
-		mmtp_packet->mmtp_packet_header.mmtp_delay_sensitivity = ((mmtp_packet_preamble[16] & 0x10) >> 4) | ((mmtp_packet_preamble[16] & 0x8) >> 3) | ((mmtp_packet_preamble[16] & 0x4) >> 2);
-
-		//TP 3 bits
-		mmtp_packet->mmtp_packet_header.mmtp_transmission_priority =(( mmtp_packet_preamble[16] & 0x02) << 2) | ((mmtp_packet_preamble[16] & 0x1) << 1) | ((mmtp_packet_preamble[17] & 0x80) >>7);
-
-		mmtp_packet->mmtp_packet_header.flow_label = mmtp_packet_preamble[17] & 0x7f;
-
-		//header extension is offset by 2 bytes in v=1, so an additional block chain read is needed to get extension length
-		if(mmtp_packet->mmtp_packet_header.mmtp_header_extension_flag & 0x1) {
-			mmtp_packet->mmtp_packet_header.mmtp_header_extension_type = (mmtp_packet_preamble[18] << 8) | mmtp_packet_preamble[19];
 
-			_MMTP_TRACE("mmtp_demuxer - dping mmtp_header_extension_length_bytes: %d",  mmtp_packet->mmtp_packet_header.mmtp_header_extension_type);
-
-			uint8_t mmtp_header_extension_length_bytes[2];
-			buf = extract(buf, mmtp_header_extension_length_bytes, 2);
-
-			mmtp_packet->mmtp_packet_header.mmtp_header_extension_length = mmtp_header_extension_length_bytes[0] << 8 | mmtp_header_extension_length_bytes[1];
-		} else {
-			//walk us back for mmtp payload type header parsing
-			buf-=2;
-		}
-	} else {
-		_MMTP_ERROR("mmtp_demuxer - unknown packet version of 0x%X", mmtp_packet->mmtp_packet_header.mmtp_packet_version);
-		goto error;
+	mmtp_packet->mmtp_packet_header.mmtp_packet_version				= mmtp_packet_header_fixed.mmtp_packet_version;
+	mmtp_packet->mmtp_packet_header.packet_counter_flag				= mmtp_packet_header_fixed.packet_counter_flag;
+	mmtp_packet->mmtp_packet_header.fec_type						= mmtp_packet_header_fixed.fec_type;
+	mmtp_packet->mmtp_packet_header.mmtp_header_extension_flag		= mmtp_packet_header_fixed.mmtp_header_extension_flag;
+	mmtp_packet->mmtp_packet_header.mmtp_rap_flag					= mmtp_packet_header_fixed.mmtp_rap_flag;
+	mmtp_packet->mmtp_packet_header.mmtp_qos_flag					= mmtp_packet_header_fixed.mmtp_qos_flag;
+	mmtp_packet->mmtp_packet_header.mmtp_flow_identifer_flag		= mmtp_packet_header_fixed.mmtp_flow_identifer_flag;
+	mmtp_packet->mmtp_packet_header.mmtp_flow_extension_flag		= mmtp_packet_header_fixed.mmtp_flow_extension_flag;
+	mmtp_packet->mmtp_packet_header.mmtp_header_compression			= mmtp_packet_header_fixed.mmtp_header_compression;
+	mmtp_packet->mmtp_packet_header.mmtp_indicator_ref_header_flag	= mmtp_packet_header_fixed.mmtp_indicator_ref_header_flag;
+	mmtp_packet->mmtp_packet_header.mmtp_payload_type				= mmtp_packet_header_fixed.mmtp_payload_type;
+	mmtp_packet->mmtp_packet_header.mmtp_type_of_bitrate			= mmtp_packet_header_fixed.mmtp_type_of_bitrate;
+	mmtp_packet->mmtp_packet_header.mmtp_delay_sensitivity			= mmtp_packet_header_fixed.mmtp_delay_sensitivity;
+	mmtp_packet->mmtp_packet_header.mmtp_transmission_priority		= mmtp_packet_header_fixed.mmtp_transmission_priority;
+	mmtp_packet->mmtp_packet_header.flow_label						= mmtp_packet_header_fixed.flow_label;
+	mmtp_packet->mmtp_packet_header.mmtp_header_extension_type		= mmtp_packet_header_fixed.mmtp_header_extension_type;
+	mmtp_packet->mmtp_packet_header.mmtp_header_extension_length	= mmtp_packet_header_fixed.mmtp_header_extension_length;
+	mmtp_packet->mmtp_packet_header.mmtp_packet_id					= mmtp_packet_header_fixed.mmtp_packet_id;
+	mmtp_packet->mmtp_packet_header.mmtp_timestamp					= mmtp_packet_header_fixed.mmtp_timestamp;
+	mmtp_packet->mmtp_packet_header.packet_sequence_number			= mmtp_packet_header_fixed.packet_sequence_number;
+	//korean MMT may not set packet_counter_flag
+	mmtp_packet->mmtp_packet_header.packet_counter					= mmtp_packet_header_fixed.packet_counter;
+
+	//the union is calloc'd, index 0 would be a valid slot, only the MPU layout has this field
+	if(mmtp_packet->mmtp_packet_header.mmtp_payload_type == 0x0) {
+		mmtp_packet->mmtp_mpu_type_packet_header.all_mpu_fragments_index = MPU_FRAGMENTS_INDEX_NONE;
 	}
 
-	mmtp_packet->mmtp_packet_header.mmtp_packet_id			= mmtp_packet_preamble[2]  << 8  | mmtp_packet_preamble[3];
+	if(mmtp_packet_header_fixed.mmtp_header_extension_flag) {
+		_MMTP_TRACE("mmtp_demuxer - header extension type: %d, length: %d", mmtp_packet_header_fixed.mmtp_header_extension_type, mmtp_packet_header_fixed.mmtp_header_extension_length);
+	}
 
 #if _ATSC3_MMT_PACKET_ID_MPEGTS_COMPATIBILITY_
 	//exception for MMT signaling, See A/331 7.2.3.
@@ -164,26 +112,14 @@ uint8_t* mmtp_packet_header_parse_from_raw_packet(mmtp_payload_fragments_union_t
 	if(!(mmtp_packet->mmtp_packet_header.mmtp_packet_id == 0x0000 && mmtp_packet->mmtp_packet_header.mmtp_payload_type == 0x2)) {
 		if(!(mmtp_packet->mmtp_packet_header.mmtp_packet_id >= 0x0010 && mmtp_packet->mmtp_packet_header.mmtp_packet_id <= 0x1FFE)) {
 			_MMTP_ERROR("MMTP packet_id is not compliant with A/331 8.1.2.1.3 - MPEG2 conversion compatibility, packet_id: %-10hu (0x%04x)", mmtp_packet->mmtp_packet_header.mmtp_packet_id, mmtp_packet->mmtp_packet_header.mmtp_packet_id);
-			goto error;
+			return NULL;
 		}
 	}
 #endif
-	mmtp_packet->mmtp_packet_header.mmtp_timestamp 			= mmtp_packet_preamble[4]  << 24 | mmtp_packet_preamble[5]  << 16 | mmtp_packet_preamble[6]   << 8 | mmtp_packet_preamble[7];
-	compute_ntp32_to_seconds_microseconds(mmtp_packet->mmtp_packet_header.mmtp_timestamp, &mmtp_packet->mmtp_packet_header.mmtp_timestamp_s, &mmtp_packet->mmtp_packet_header.mmtp_timestamp_us);
-
-	mmtp_packet->mmtp_packet_header.packet_sequence_number	= mmtp_packet_preamble[8]  << 24 | mmtp_packet_preamble[9]  << 16 | mmtp_packet_preamble[10]  << 8 | mmtp_packet_preamble[11];
-   
-    if(mmtp_packet->mmtp_packet_header.packet_counter_flag) {
-        mmtp_packet->mmtp_packet_header.packet_counter 			= mmtp_packet_preamble[12] << 24 | mmtp_packet_preamble[13] << 16 | mmtp_packet_preamble[14]  << 8 | mmtp_packet_preamble[15];
-    } else {
-        //walk back our buff by 4 bytes, korean MMT may not set this.
-        buf-=4;
-    }
 
-	return buf;
+	compute_ntp32_to_seconds_microseconds(mmtp_packet->mmtp_packet_header.mmtp_timestamp, &mmtp_packet->mmtp_packet_header.mmtp_timestamp_s, &mmtp_packet->mmtp_packet_header.mmtp_timestamp_us);
 
-error:
-	return NULL;
+	return udp_raw_buf + header_length;
 }
 
 
@@ -224,7 +160,11 @@ mmtp_payload_fragments_union_t* mmtp_packet_parse(mmtp_sub_flow_vector_t* mmtp_s
 		_MMTP_DEBUG("before: mmt_parse_payload: udp raw buf size: %d, raw_packet_ptr: %p, udp_raw_buf: %p", udp_raw_buf_size, raw_packet_ptr, udp_raw_buf);
 		int new_size = udp_raw_buf_size - (raw_packet_ptr - udp_raw_buf);
 
-		mmt_mpu_parse_payload(mmtp_sub_flow_vector, mmtp_payload_fragments, raw_packet_ptr, new_size);
+		if(!mmt_mpu_parse_payload(mmtp_sub_flow_vector, mmtp_payload_fragments, raw_packet_ptr, new_size)) {
+			//already in all_mpu_fragments_vector, but not yet in any MPU's data unit vectors
+			mmtp_payload_fragments_union_free(&mmtp_payload_fragments);
+			return NULL;
+		}
 	} else
 #if _ISO230081_1_MMTP_GFD_SUPPORT_
 	if(mmtp_payload_fragments->mmtp_packet_header.mmtp_payload_type == 0x1) {
@@ -260,6 +200,8 @@ failed:
 void mmtp_sub_flow_vector_init(mmtp_sub_flow_vector_t *mmtp_sub_flow_vector) {
 	__PRINTF_DEBUG("%d:mmtp_sub_flow_vector_init: %p\n", __LINE__, mmtp_sub_flow_vector);
 	atsc3_vector_init(mmtp_sub_flow_vector);
+	memset(mmtp_sub_flow_vector->packet_id_index, 0, sizeof(mmtp_sub_flow_vector->packet_id_index));
+	mmtp_sub_flow_vector->packet_id_index_displaced_n = 0;
 	__PRINTF_DEBUG("%d:mmtp_sub_flow_vector_init: %p\n", __LINE__, mmtp_sub_flow_vector);
 }
 void mmtp_payload_fragments_union_free(mmtp_payload_fragments_union_t** mmtp_payload_fragments_p) {
@@ -267,6 +209,10 @@ void mmtp_payload_fragments_union_free(mmtp_payload_fragments_union_t** mmtp_pay
         mmtp_payload_fragments_union_t* mmtp_payload_fragment = *mmtp_payload_fragments_p;
         if(mmtp_payload_fragment) {
             if(mmtp_payload_fragment->mmtp_packet_header.mmtp_payload_type == 0x0) {
+                //out of all_mpu_fragments_vector and its retention entry before it is gone
+                if(mmtp_payload_fragment->mmtp_packet_header.mmtp_sub_flow && mmtp_payload_fragment->mmtp_packet_header.mmtp_sub_flow->mpu_fragments) {
+                    mpu_fragments_retention_release_packet(mmtp_payload_fragment->mmtp_packet_header.mmtp_sub_flow->mpu_fragments, mmtp_payload_fragment);
+                }
                 //clean up data block allocs
                 mmt_mpu_free_payload(mmtp_payload_fragment);
             }
@@ -302,8 +248,17 @@ vlc_player_program_vector_FindById(vlc_player_program_vector *vec, int id,
 
 
 mmtp_sub_flow_t* mmtp_sub_flow_vector_find_packet_id(mmtp_sub_flow_vector_t *vec, uint16_t mmtp_packet_id) {
+	mmtp_sub_flow_t *mmtp_sub_flow = vec->packet_id_index[mmtp_packet_id % MMTP_SUB_FLOW_PACKET_ID_INDEX_SIZE];
+	if(mmtp_sub_flow && mmtp_sub_flow->mmtp_packet_id == mmtp_packet_id) {
+		return mmtp_sub_flow;
+	}
+
+	if(!vec->packet_id_index_displaced_n) {
+		return NULL;
+	}
+
 	for (size_t i = 0; i < vec->size; ++i) {
-		mmtp_sub_flow_t *mmtp_sub_flow = vec->data[i];
+		mmtp_sub_flow = vec->data[i];
 
 		if (mmtp_sub_flow->mmtp_packet_id == mmtp_packet_id) {
 			return mmtp_sub_flow;
@@ -325,6 +280,13 @@ mmtp_sub_flow_t* mmtp_sub_flow_vector_get_or_set_packet_id(mmtp_sub_flow_vector_
 		atsc3_vector_init(&entry->mmtp_signalling_message_fragements_vector);
 		atsc3_vector_init(&entry->mmtp_repair_symbol_vector);
 		atsc3_vector_push(vec, entry);
+
+		//first packet_id keeps the slot, sub-flows are never removed
+		if(vec->packet_id_index[mmtp_packet_id % MMTP_SUB_FLOW_PACKET_ID_INDEX_SIZE]) {
+			vec->packet_id_index_displaced_n++;
+		} else {
+			vec->packet_id_index[mmtp_packet_id % MMTP_SUB_FLOW_PACKET_ID_INDEX_SIZE] = entry;
+		}
 	}
 
 	return entry;
@@ -369,6 +331,9 @@ mmtp_payload_fragments_union_t* mmtp_packet_create(block_t * raw_packet,
 	entry->mmtp_packet_header.packet_sequence_number = packet_sequence_number;
 	entry->mmtp_packet_header.packet_counter = packet_counter;
 	entry->mmtp_packet_header.mmtp_timestamp = mmtp_timestamp;
+	if(mmtp_payload_type == 0x0) {
+		entry->mmtp_mpu_type_packet_header.all_mpu_fragments_index = MPU_FRAGMENTS_INDEX_NONE;
+	}
 
 	return entry;
 }
@@ -381,6 +346,7 @@ void mmtp_sub_flow_push_mmtp_packet(mmtp_sub_flow_t *mmtp_sub_flow, mmtp_payload
 		//(mmtp_mpu_type_packet_header_fields_t*, defer, we don;'t know enough about the type
 
 		mpu_fragments_t *mpu_fragments = mpu_fragments_get_or_set_packet_id(mmtp_sub_flow, mmtp_packet->mmtp_packet_header.mmtp_packet_id);
+		mmtp_packet->mmtp_mpu_type_packet_header.all_mpu_fragments_index = mpu_fragments->all_mpu_fragments_vector.size;
 		atsc3_vector_push(&mpu_fragments->all_mpu_fragments_vector, mmtp_packet);
 	} else if(mmtp_packet->mmtp_packet_header.mmtp_payload_type == 0x01) {
 		atsc3_vector_push(&mmtp_sub_flow->mmtp_generic_object_fragments_vector, mmtp_packet);
@@ -414,10 +380,7 @@ void mmtp_sub_flow_remove_mmtp_packet(mmtp_sub_flow_t *mmtp_sub_flow, mmtp_paylo
 		mpu_fragments_t* mpu_fragments = mmtp_sub_flow->mpu_fragments;
 		if(mpu_fragments) {
 
-				atsc3_vector_index_of(&mpu_fragments->all_mpu_fragments_vector, mmtp_packet, index);
-				if(*index >-1) {
-					atsc3_vector_remove_noshrink(&mpu_fragments->all_mpu_fragments_vector, *index);
-				}
+				mpu_fragments_retention_release_packet(mpu_fragments, mmtp_packet);
 			}
 			mpu_data_unit_payload_fragments_t* mpu_metadata_fragments_vector = mpu_data_unit_payload_fragments_find_mpu_sequence_number(&mmtp_sub_flow->mpu_fragments->mpu_metadata_fragments_vector, mmtp_packet->mmtp_mpu_type_packet_header.mpu_sequence_number);
 
@@ -6,6 +6,9 @@
  */
 #include <assert.h>
 #include <limits.h>
+#include <sys/time.h>
+
+#include "atsc3_logging.h"
 
 #ifndef MODULES_DEMUX_MMT_MMTP_TYPES_H_
 #define MODULES_DEMUX_MMT_MMTP_TYPES_H_
@@ -100,6 +103,14 @@ typedef struct {
 	uint32_t mpu_sequence_number;			\
 	uint16_t data_unit_length;				\
 	block_t* mpu_data_unit_payload;			\
+	size_t all_mpu_fragments_index;			\
+	struct mpu_retention_entry* mpu_retention_entry;	\
+	union mmtp_payload_fragments_union* mpu_retention_prev;	\
+	union mmtp_payload_fragments_union* mpu_retention_next;	\
+	uint32_t mpu_retention_bytes;			\
+
+//all_mpu_fragments_index of a packet that is not in mpu_fragments->all_mpu_fragments_vector
+#define MPU_FRAGMENTS_INDEX_NONE SIZE_MAX
 
 //DO NOT REFERENCE INTEREMDIATE STRUCTS DIRECTLY
 typedef struct {
@@ -116,6 +127,7 @@ typedef struct {
 	uint8_t dep_counter;
 	uint64_t pts;
 	uint64_t last_pts;
+	uint64_t arrival_ns;	//atsc3_latency_histogram_arrival_ns of this packet, 0 unless latency histograms are enabled
 } __mpu_data_unit_payload_fragments_timed_t;
 
 //DO NOT REFERENCE INTEREMDIATE STRUCTS DIRECTLY
@@ -142,6 +154,7 @@ typedef struct {
 	uint8_t		si_fragmentation_counter;    //8 bits
 	uint16_t	si_aggregation_message_length; //only set if si_aggregation_flag==1
 	mmt_signalling_message_vector_t mmt_signalling_message_vector;
+	uint8_t		si_mpt_changed;				 //an MPT in this packet differs from the last one cached for the sub flow
 
 } __signalling_message_fragments_t;
 
@@ -183,7 +196,25 @@ typedef struct {
 
 } mpu_data_unit_payload_fragments_t;
 
-typedef struct ATSC3_VECTOR(mpu_data_unit_payload_fragments_t *) mpu_data_unit_payload_fragments_vector_t;
+/**
+ * mpu_sequence_numbers are monotonic per packet_id, so alongside the vector keep a ring indexed by
+ * mpu_sequence_number % MPU_SEQUENCE_NUMBER_RING_WINDOW for O(1) lookups.
+ *
+ * the first three members must stay layout compatible with ATSC3_VECTOR() so the atsc3_vector_* macros apply.
+ * entries that lose their slot (more than a window of MPUs held, or a discontinuity/loop in mpu_sequence_numbers)
+ * are counted in mpu_sequence_number_ring_displaced_n, and only then do lookups fall back to a linear scan.
+ * removing a slot's owner re-seats the newest entry it displaced, so the count drains once eviction catches up.
+ */
+#define MPU_SEQUENCE_NUMBER_RING_WINDOW 64
+
+typedef struct {
+	size_t 								cap;
+	size_t 								size;
+	mpu_data_unit_payload_fragments_t**	data;
+
+	mpu_data_unit_payload_fragments_t*	mpu_sequence_number_ring[MPU_SEQUENCE_NUMBER_RING_WINDOW];
+	uint32_t							mpu_sequence_number_ring_displaced_n;
+} mpu_data_unit_payload_fragments_vector_t;
 
 
 //partial refactoring from vlc to libatsc3
@@ -227,7 +258,38 @@ typedef struct {
 } mpu_isobmff_fragment_parameters_t;
 #endif
 
-typedef struct {
+typedef struct mpu_fragments mpu_fragments_t;
+
+/**
+ * bounded retention of whole MPUs, see mpu_fragments_retention_enforce
+ *
+ * one entry per mpu_sequence_number, linked into both its packet_id sub-flow and the global list
+ * across all sub-flows (oldest first), so the per-flow and global budgets each find their victim in O(1)
+ *
+ * the entry's packets are chained through their mpu_retention_prev/next fields, and each packet keeps its
+ * all_mpu_fragments_index, so a packet leaves all_mpu_fragments_vector and its entry in O(1), see
+ * mpu_fragments_retention_release_packet
+ */
+typedef struct mpu_retention_entry {
+	mpu_fragments_t*						mpu_fragments;
+	uint32_t								mpu_sequence_number;
+	struct timeval							first_received;
+	uint32_t								bytes_held;
+
+	mmtp_payload_fragments_union_t*			packets_head;
+	mmtp_payload_fragments_union_t*			packets_tail;
+
+	mpu_data_unit_payload_fragments_t*		mpu_metadata_fragments;
+	mpu_data_unit_payload_fragments_t*		movie_fragment_metadata;
+	mpu_data_unit_payload_fragments_t*		media_fragment_unit;
+
+	struct mpu_retention_entry*				sub_flow_prev;
+	struct mpu_retention_entry*				sub_flow_next;
+	struct mpu_retention_entry*				global_prev;
+	struct mpu_retention_entry*				global_next;
+} mpu_retention_entry_t;
+
+struct mpu_fragments {
 	mmtp_sub_flow_t *mmtp_sub_flow;
 	uint16_t mmtp_packet_id;
 
@@ -246,7 +308,16 @@ typedef struct {
 
 	mpu_isobmff_fragment_parameters_t			mpu_isobmff_fragment_parameters;
 
-} mpu_fragments_t;
+	//retained MPUs for this packet_id, oldest first
+	mpu_retention_entry_t*						mpu_retention_head;
+	mpu_retention_entry_t*						mpu_retention_tail;
+	uint32_t									mpu_retention_count;
+
+	uint64_t									bytes_held;
+	uint64_t									bytes_evicted;
+	uint32_t									mpus_evicted;
+
+};
 
 /**
  * todo:  impl's
@@ -267,6 +338,7 @@ typedef struct mmtp_sub_flow {
 
 	//signalling message: 						payload_type=0x02
 	mmtp_signalling_message_fragments_vector_t 	mmtp_signalling_message_fragements_vector;
+	mmt_signalling_message_cache_t*				mmt_signalling_message_cache;
 
 	//repair symbol:							payload_type==0x03
 	mmtp_repair_symbol_vector_t 				mmtp_repair_symbol_vector;
@@ -277,16 +349,29 @@ typedef struct mmtp_sub_flow {
 //todo - refactor mpu_fragments to vector, create a new tuple class for mmtp_sub_flow_sequence
 
 
-typedef struct ATSC3_VECTOR(mmtp_sub_flow_t*) mmtp_sub_flow_vector_t;
+/**
+ * same approach as mpu_data_unit_payload_fragments_vector_t, direct-mapped on the low bits of packet_id,
+ * sub-flows are never removed so a displaced entry stays displaced
+ */
+#define MMTP_SUB_FLOW_PACKET_ID_INDEX_SIZE 256
+
+typedef struct {
+	size_t 				cap;
+	size_t 				size;
+	mmtp_sub_flow_t**	data;
+
+	mmtp_sub_flow_t*	packet_id_index[MMTP_SUB_FLOW_PACKET_ID_INDEX_SIZE];
+	uint32_t			packet_id_index_displaced_n;
+} mmtp_sub_flow_vector_t;
 
 
 #define _MMTP_PRINTLN(...) printf(__VA_ARGS__);printf("\r\n")
-#define _MMTP_ERROR(...)   printf("%s:%d:ERROR:",__FILE__,__LINE__);_MMTP_PRINTLN(__VA_ARGS__);
-#define _MMTP_WARN(...)    printf("%s:%d:WARN:",__FILE__,__LINE__);_MMTP_PRINTLN(__VA_ARGS__);
+#define _MMTP_ERROR(...)   __ATSC3_LOG_ERROR(ATSC3_LOG_MODULE_MMTP, __VA_ARGS__)
+#define _MMTP_WARN(...)    __ATSC3_LOG_WARN(ATSC3_LOG_MODULE_MMTP, __VA_ARGS__)
 #define _MMTP_INFO(...)    //printf("%s:%d:INFO ",__FILE__,__LINE__);_MMTP_PRINTLN(__VA_ARGS__);
 
-#define _MMTP_DEBUG(...)   if(_MMTP_DEBUG_ENABLED) { printf("%s:%d:DEBUG :",__FILE__,__LINE__);_MMTP_PRINTLN(__VA_ARGS__); }
-#define _MMTP_TRACE(...)   if(_MMTP_TRACE_ENABLED) { printf("%s:%d:TRACE :",__FILE__,__LINE__);_MMTP_PRINTLN(__VA_ARGS__); }
+#define _MMTP_DEBUG(...)   if(_MMTP_DEBUG_ENABLED) { __ATSC3_LOG_DEBUG(ATSC3_LOG_MODULE_MMTP, __VA_ARGS__); }
+#define _MMTP_TRACE(...)   if(_MMTP_TRACE_ENABLED) { __ATSC3_LOG_TRACE(ATSC3_LOG_MODULE_MMTP, __VA_ARGS__); }
 #define __LOG_MPU_REASSEMBLY(...) printf(__VA_ARGS__)
 
 #define __LOG_DEBUG(...) printf(__VA_ARGS__)
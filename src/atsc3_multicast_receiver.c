@@ -0,0 +1,459 @@
+/*
+ * atsc3_multicast_receiver.c
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: jjustman
+ */
+
+//recvmmsg
+#if defined(__linux__) && !defined(_GNU_SOURCE)
+#define _GNU_SOURCE
+#endif
+
+#include <string.h>
+#include <errno.h>
+#include <poll.h>
+#include <sys/time.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <net/if.h>
+
+#include "atsc3_multicast_receiver.h"
+#include "atsc3_lls.h"
+
+#define ATSC3_MULTICAST_RECEIVER_PAYLOAD_MAX (MAX_PCAP_LEN - ATSC3_MULTICAST_RECEIVER_FRAME_HEADER_LEN)
+
+bool atsc3_multicast_receiver_is_dev(const char* dev) {
+	return dev && !strncmp(dev, ATSC3_MULTICAST_RECEIVER_DEV_PREFIX, strlen(ATSC3_MULTICAST_RECEIVER_DEV_PREFIX));
+}
+
+static atsc3_multicast_receiver_flow_t* atsc3_multicast_receiver_flow_find(atsc3_multicast_receiver_t* atsc3_multicast_receiver, uint32_t dst_ip_addr, uint16_t dst_port) {
+	for(uint32_t i = 0; i < atsc3_multicast_receiver->flows_n; i++) {
+		if(atsc3_multicast_receiver->flows[i].dst_ip_addr == dst_ip_addr && atsc3_multicast_receiver->flows[i].dst_port == dst_port) {
+			return &atsc3_multicast_receiver->flows[i];
+		}
+	}
+	return NULL;
+}
+
+static void atsc3_multicast_receiver_sockaddr_in(struct sockaddr_storage* sockaddr_storage, uint32_t ip_addr, uint16_t port) {
+	struct sockaddr_in* sockaddr_in = (struct sockaddr_in*)sockaddr_storage;
+	memset(sockaddr_storage, 0, sizeof(struct sockaddr_storage));
+	sockaddr_in->sin_family = AF_INET;
+	sockaddr_in->sin_addr.s_addr = htonl(ip_addr);
+	sockaddr_in->sin_port = htons(port);
+}
+
+static int atsc3_multicast_receiver_socket_open(atsc3_multicast_receiver_t* atsc3_multicast_receiver, uint32_t src_ip_addr, uint32_t dst_ip_addr, uint16_t dst_port) {
+	struct sockaddr_in bind_addr;
+	int optval = 1;
+	int fd = socket(AF_INET, SOCK_DGRAM, 0);
+
+	if(fd < 0) {
+		__MULTICAST_RECEIVER_ERROR("socket: %s", strerror(errno));
+		return -1;
+	}
+
+	setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &optval, sizeof(optval));
+#ifdef SO_REUSEPORT
+	setsockopt(fd, SOL_SOCKET, SO_REUSEPORT, &optval, sizeof(optval));
+#endif
+	optval = ATSC3_MULTICAST_RECEIVER_SO_RCVBUF;
+	setsockopt(fd, SOL_SOCKET, SO_RCVBUF, &optval, sizeof(optval));
+#ifdef IP_MULTICAST_ALL
+	//only deliver the group this socket joined, not every group joined on dst_port
+	optval = 0;
+	setsockopt(fd, IPPROTO_IP, IP_MULTICAST_ALL, &optval, sizeof(optval));
+#endif
+
+	//bind to the group so the kernel filters by dst_ip as well as dst_port
+	memset(&bind_addr, 0, sizeof(bind_addr));
+	bind_addr.sin_family = AF_INET;
+	bind_addr.sin_addr.s_addr = htonl(dst_ip_addr);
+	bind_addr.sin_port = htons(dst_port);
+	if(bind(fd, (struct sockaddr*)&bind_addr, sizeof(bind_addr)) < 0) {
+		__MULTICAST_RECEIVER_ERROR("bind: %u.%u.%u.%u:%u: %s", __toipandportnonstruct(dst_ip_addr, dst_port), strerror(errno));
+		close(fd);
+		return -1;
+	}
+
+	if(src_ip_addr) {
+		struct group_source_req group_source_req;
+		memset(&group_source_req, 0, sizeof(group_source_req));
+		group_source_req.gsr_interface = atsc3_multicast_receiver->ifindex;
+		atsc3_multicast_receiver_sockaddr_in(&group_source_req.gsr_group, dst_ip_addr, 0);
+		atsc3_multicast_receiver_sockaddr_in(&group_source_req.gsr_source, src_ip_addr, 0);
+		if(setsockopt(fd, IPPROTO_IP, MCAST_JOIN_SOURCE_GROUP, &group_source_req, sizeof(group_source_req)) < 0) {
+			__MULTICAST_RECEIVER_ERROR("MCAST_JOIN_SOURCE_GROUP: %u.%u.%u.%u -> %u.%u.%u.%u:%u: %s", __toipnonstruct(src_ip_addr), __toipandportnonstruct(dst_ip_addr, dst_port), strerror(errno));
+			close(fd);
+			return -1;
+		}
+	} else {
+		struct group_req group_req;
+		memset(&group_req, 0, sizeof(group_req));
+		group_req.gr_interface = atsc3_multicast_receiver->ifindex;
+		atsc3_multicast_receiver_sockaddr_in(&group_req.gr_group, dst_ip_addr, 0);
+		if(setsockopt(fd, IPPROTO_IP, MCAST_JOIN_GROUP, &group_req, sizeof(group_req)) < 0) {
+			__MULTICAST_RECEIVER_ERROR("MCAST_JOIN_GROUP: %u.%u.%u.%u:%u: %s", __toipandportnonstruct(dst_ip_addr, dst_port), strerror(errno));
+			close(fd);
+			return -1;
+		}
+	}
+
+	return fd;
+}
+
+int atsc3_multicast_receiver_join(atsc3_multicast_receiver_t* atsc3_multicast_receiver, uint32_t src_ip_addr, uint32_t dst_ip_addr, uint16_t dst_port) {
+	atsc3_multicast_receiver_flow_t* atsc3_multicast_receiver_flow = atsc3_multicast_receiver_flow_find(atsc3_multicast_receiver, dst_ip_addr, dst_port);
+
+	if(atsc3_multicast_receiver_flow) {
+		if(atsc3_multicast_receiver_flow->src_ip_addr == src_ip_addr) {
+			return 0;
+		}
+		//source changed in the SLT, re-join
+		atsc3_multicast_receiver_leave(atsc3_multicast_receiver, dst_ip_addr, dst_port);
+	}
+
+	if(atsc3_multicast_receiver->flows_n == ATSC3_MULTICAST_RECEIVER_FLOWS_MAX) {
+		__MULTICAST_RECEIVER_WARN("unable to join: %u.%u.%u.%u:%u, max flows: %u reached", __toipandportnonstruct(dst_ip_addr, dst_port), ATSC3_MULTICAST_RECEIVER_FLOWS_MAX);
+		atsc3_multicast_receiver->statistics.join_errors++;
+		return -1;
+	}
+
+	int fd = atsc3_multicast_receiver_socket_open(atsc3_multicast_receiver, src_ip_addr, dst_ip_addr, dst_port);
+	if(fd < 0) {
+		atsc3_multicast_receiver->statistics.join_errors++;
+		return -1;
+	}
+
+	atsc3_multicast_receiver_flow = &atsc3_multicast_receiver->flows[atsc3_multicast_receiver->flows_n++];
+	memset(atsc3_multicast_receiver_flow, 0, sizeof(atsc3_multicast_receiver_flow_t));
+	atsc3_multicast_receiver_flow->src_ip_addr = src_ip_addr;
+	atsc3_multicast_receiver_flow->dst_ip_addr = dst_ip_addr;
+	atsc3_multicast_receiver_flow->dst_port = dst_port;
+	atsc3_multicast_receiver_flow->fd = fd;
+	atsc3_multicast_receiver_flow->is_lls = (dst_ip_addr == LLS_DST_ADDR && dst_port == LLS_DST_PORT);
+
+	atsc3_multicast_receiver->statistics.flows_joined++;
+
+	__MULTICAST_RECEIVER_INFO("joined: %u.%u.%u.%u -> %u.%u.%u.%u:%u", __toipnonstruct(src_ip_addr), __toipandportnonstruct(dst_ip_addr, dst_port));
+
+	return 1;
+}
+
+int atsc3_multicast_receiver_leave(atsc3_multicast_receiver_t* atsc3_multicast_receiver, uint32_t dst_ip_addr, uint16_t dst_port) {
+	atsc3_multicast_receiver_flow_t* atsc3_multicast_receiver_flow = atsc3_multicast_receiver_flow_find(atsc3_multicast_receiver, dst_ip_addr, dst_port);
+	if(!atsc3_multicast_receiver_flow) {
+		return 0;
+	}
+
+	//closing the socket drops its membership
+	close(atsc3_multicast_receiver_flow->fd);
+
+	*atsc3_multicast_receiver_flow = atsc3_multicast_receiver->flows[--atsc3_multicast_receiver->flows_n];
+	atsc3_multicast_receiver->statistics.flows_left++;
+
+	__MULTICAST_RECEIVER_INFO("left: %u.%u.%u.%u:%u", __toipandportnonstruct(dst_ip_addr, dst_port));
+
+	return 1;
+}
+
+static int atsc3_multicast_receiver_slt_sync_flow(atsc3_multicast_receiver_t* atsc3_multicast_receiver, uint32_t src_ip_addr, uint32_t dst_ip_addr, uint16_t dst_port) {
+	if(!dst_ip_addr || !dst_port) {
+		return 0;
+	}
+
+	int changed = atsc3_multicast_receiver_join(atsc3_multicast_receiver, src_ip_addr, dst_ip_addr, dst_port) > 0;
+
+	atsc3_multicast_receiver_flow_t* atsc3_multicast_receiver_flow = atsc3_multicast_receiver_flow_find(atsc3_multicast_receiver, dst_ip_addr, dst_port);
+	if(atsc3_multicast_receiver_flow) {
+		atsc3_multicast_receiver_flow->slt_announced = true;
+	}
+
+	return changed;
+}
+
+int atsc3_multicast_receiver_slt_sync(atsc3_multicast_receiver_t* atsc3_multicast_receiver, lls_slt_monitor_t* lls_slt_monitor) {
+	int changed = 0;
+
+	for(uint32_t i = 0; i < atsc3_multicast_receiver->flows_n; i++) {
+		atsc3_multicast_receiver->flows[i].slt_announced = atsc3_multicast_receiver->flows[i].is_lls;
+	}
+
+	if(lls_slt_monitor->lls_sls_mmt_session_vector) {
+		for(int i = 0; i < lls_slt_monitor->lls_sls_mmt_session_vector->lls_slt_mmt_sessions_n; i++) {
+			lls_sls_mmt_session_t* lls_sls_mmt_session = lls_slt_monitor->lls_sls_mmt_session_vector->lls_slt_mmt_sessions[i];
+			changed += atsc3_multicast_receiver_slt_sync_flow(atsc3_multicast_receiver, lls_sls_mmt_session->sls_source_ip_address,
+					lls_sls_mmt_session->sls_destination_ip_address, lls_sls_mmt_session->sls_destination_udp_port);
+		}
+	}
+
+	if(lls_slt_monitor->lls_sls_alc_session_vector) {
+		for(int i = 0; i < lls_slt_monitor->lls_sls_alc_session_vector->lls_slt_alc_sessions_n; i++) {
+			lls_sls_alc_session_t* lls_sls_alc_session = lls_slt_monitor->lls_sls_alc_session_vector->lls_slt_alc_sessions[i];
+			changed += atsc3_multicast_receiver_slt_sync_flow(atsc3_multicast_receiver, lls_sls_alc_session->sls_relax_source_ip_check ? 0 : lls_sls_alc_session->sls_source_ip_address,
+					lls_sls_alc_session->sls_destination_ip_address, lls_sls_alc_session->sls_destination_udp_port);
+		}
+	}
+
+	//leave swaps the last flow into the removed slot, so walk backwards
+	for(int i = (int)atsc3_multicast_receiver->flows_n - 1; i >= 0; i--) {
+		if(!atsc3_multicast_receiver->flows[i].slt_announced) {
+			changed += atsc3_multicast_receiver_leave(atsc3_multicast_receiver, atsc3_multicast_receiver->flows[i].dst_ip_addr, atsc3_multicast_receiver->flows[i].dst_port);
+		}
+	}
+
+	return changed;
+}
+
+atsc3_multicast_receiver_t* atsc3_multicast_receiver_create(const char* ifname) {
+	atsc3_multicast_receiver_t* atsc3_multicast_receiver = (atsc3_multicast_receiver_t*)calloc(1, sizeof(atsc3_multicast_receiver_t));
+
+	if(ifname && strlen(ifname)) {
+		atsc3_multicast_receiver->ifname = strdup(ifname);
+		atsc3_multicast_receiver->ifindex = if_nametoindex(ifname);
+		if(!atsc3_multicast_receiver->ifindex) {
+			__MULTICAST_RECEIVER_ERROR("if_nametoindex: %s: %s", ifname, strerror(errno));
+			atsc3_multicast_receiver_free(&atsc3_multicast_receiver);
+			return NULL;
+		}
+	}
+
+	for(int i = 0; i < ATSC3_MULTICAST_RECEIVER_BATCH_MAX; i++) {
+		atsc3_multicast_receiver->frames[i] = (uint8_t*)calloc(MAX_PCAP_LEN, sizeof(uint8_t));
+	}
+
+	if(atsc3_multicast_receiver_join(atsc3_multicast_receiver, 0, LLS_DST_ADDR, LLS_DST_PORT) < 0) {
+		atsc3_multicast_receiver_free(&atsc3_multicast_receiver);
+		return NULL;
+	}
+
+	return atsc3_multicast_receiver;
+}
+
+void atsc3_multicast_receiver_breakloop(atsc3_multicast_receiver_t* atsc3_multicast_receiver) {
+	atsc3_multicast_receiver->breakloop = 1;
+}
+
+//ethernet (ipv4 ethertype), ipv4 without options and udp header in front of the payload for process_packet_from_pcap
+static void atsc3_multicast_receiver_frame_header_write(uint8_t* frame, uint32_t src_ip_addr, uint16_t src_port, uint32_t dst_ip_addr, uint16_t dst_port, uint32_t payload_len) {
+	uint16_t ip_total_len = 20 + 8 + payload_len;
+	uint16_t udp_len = 8 + payload_len;
+
+	memset(frame, 0, 12);
+	frame[12] = 0x08;
+	frame[13] = 0x00;
+
+	uint8_t* ip_header = &frame[14];
+	ip_header[0] = 0x45;
+	ip_header[1] = 0;
+	ip_header[2] = ip_total_len >> 8;
+	ip_header[3] = ip_total_len & 0xFF;
+	memset(&ip_header[4], 0, 4);
+	ip_header[8] = 1;
+	ip_header[9] = 0x11;
+	ip_header[10] = 0;
+	ip_header[11] = 0;
+	ip_header[12] = (src_ip_addr >> 24) & 0xFF;
+	ip_header[13] = (src_ip_addr >> 16) & 0xFF;
+	ip_header[14] = (src_ip_addr >> 8) & 0xFF;
+	ip_header[15] = src_ip_addr & 0xFF;
+	ip_header[16] = (dst_ip_addr >> 24) & 0xFF;
+	ip_header[17] = (dst_ip_addr >> 16) & 0xFF;
+	ip_header[18] = (dst_ip_addr >> 8) & 0xFF;
+	ip_header[19] = dst_ip_addr & 0xFF;
+
+	uint8_t* udp_header = &frame[34];
+	udp_header[0] = src_port >> 8;
+	udp_header[1] = src_port & 0xFF;
+	udp_header[2] = dst_port >> 8;
+	udp_header[3] = dst_port & 0xFF;
+	udp_header[4] = udp_len >> 8;
+	udp_header[5] = udp_len & 0xFF;
+	udp_header[6] = 0;
+	udp_header[7] = 0;
+}
+
+//drain up to ATSC3_MULTICAST_RECEIVER_BATCH_MAX datagrams from one flow, returns the number delivered
+static int atsc3_multicast_receiver_flow_recv_batch(atsc3_multicast_receiver_t* atsc3_multicast_receiver, atsc3_multicast_receiver_flow_t* atsc3_multicast_receiver_flow, pcap_handler callback) {
+	struct iovec iovecs[ATSC3_MULTICAST_RECEIVER_BATCH_MAX];
+	struct sockaddr_in src_addrs[ATSC3_MULTICAST_RECEIVER_BATCH_MAX];
+	struct pcap_pkthdr pkthdr;
+	int datagrams_n = 0;
+
+#if defined(__linux__)
+	struct mmsghdr mmsghdrs[ATSC3_MULTICAST_RECEIVER_BATCH_MAX];
+
+	memset(mmsghdrs, 0, sizeof(mmsghdrs));
+	for(int i = 0; i < ATSC3_MULTICAST_RECEIVER_BATCH_MAX; i++) {
+		iovecs[i].iov_base = atsc3_multicast_receiver->frames[i] + ATSC3_MULTICAST_RECEIVER_FRAME_HEADER_LEN;
+		iovecs[i].iov_len = ATSC3_MULTICAST_RECEIVER_PAYLOAD_MAX;
+		mmsghdrs[i].msg_hdr.msg_iov = &iovecs[i];
+		mmsghdrs[i].msg_hdr.msg_iovlen = 1;
+		mmsghdrs[i].msg_hdr.msg_name = &src_addrs[i];
+		mmsghdrs[i].msg_hdr.msg_namelen = sizeof(struct sockaddr_in);
+	}
+
+	datagrams_n = recvmmsg(atsc3_multicast_receiver_flow->fd, mmsghdrs, ATSC3_MULTICAST_RECEIVER_BATCH_MAX, MSG_DONTWAIT, NULL);
+	if(datagrams_n < 0) {
+		return (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR) ? 0 : -1;
+	}
+#else
+	struct msghdr msghdrs[ATSC3_MULTICAST_RECEIVER_BATCH_MAX];
+	uint32_t msg_lens[ATSC3_MULTICAST_RECEIVER_BATCH_MAX];
+
+	for(; datagrams_n < ATSC3_MULTICAST_RECEIVER_BATCH_MAX; datagrams_n++) {
+		memset(&msghdrs[datagrams_n], 0, sizeof(struct msghdr));
+		iovecs[datagrams_n].iov_base = atsc3_multicast_receiver->frames[datagrams_n] + ATSC3_MULTICAST_RECEIVER_FRAME_HEADER_LEN;
+		iovecs[datagrams_n].iov_len = ATSC3_MULTICAST_RECEIVER_PAYLOAD_MAX;
+		msghdrs[datagrams_n].msg_iov = &iovecs[datagrams_n];
+		msghdrs[datagrams_n].msg_iovlen = 1;
+		msghdrs[datagrams_n].msg_name = &src_addrs[datagrams_n];
+		msghdrs[datagrams_n].msg_namelen = sizeof(struct sockaddr_in);
+
+		ssize_t ret = recvmsg(atsc3_multicast_receiver_flow->fd, &msghdrs[datagrams_n], MSG_DONTWAIT);
+		if(ret < 0) {
+			if(!datagrams_n && !(errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR)) {
+				return -1;
+			}
+			break;
+		}
+		msg_lens[datagrams_n] = ret;
+	}
+#endif
+
+	if(!datagrams_n) {
+		return 0;
+	}
+
+	gettimeofday(&pkthdr.ts, NULL);
+
+	for(int i = 0; i < datagrams_n; i++) {
+#if defined(__linux__)
+		uint32_t payload_len = mmsghdrs[i].msg_len;
+		bool truncated = mmsghdrs[i].msg_hdr.msg_flags & MSG_TRUNC;
+#else
+		uint32_t payload_len = msg_lens[i];
+		bool truncated = msghdrs[i].msg_flags & MSG_TRUNC;
+#endif
+		if(truncated) {
+			atsc3_multicast_receiver->statistics.datagrams_truncated++;
+		}
+
+		atsc3_multicast_receiver_frame_header_write(atsc3_multicast_receiver->frames[i], ntohl(src_addrs[i].sin_addr.s_addr), ntohs(src_addrs[i].sin_port),
+				atsc3_multicast_receiver_flow->dst_ip_addr, atsc3_multicast_receiver_flow->dst_port, payload_len);
+
+		pkthdr.caplen = ATSC3_MULTICAST_RECEIVER_FRAME_HEADER_LEN + payload_len;
+		pkthdr.len = pkthdr.caplen;
+
+		atsc3_multicast_receiver->statistics.bytes_received += payload_len;
+
+		callback(NULL, &pkthdr, atsc3_multicast_receiver->frames[i]);
+	}
+
+	atsc3_multicast_receiver->statistics.datagrams_received += datagrams_n;
+	atsc3_multicast_receiver->statistics.batches_received++;
+
+	return datagrams_n;
+}
+
+int64_t atsc3_multicast_receiver_loop(atsc3_multicast_receiver_t* atsc3_multicast_receiver, pcap_handler callback, lls_slt_monitor_t* lls_slt_monitor) {
+	struct pollfd pfds[ATSC3_MULTICAST_RECEIVER_FLOWS_MAX];
+	int64_t datagrams_delivered = 0;
+
+	while(!atsc3_multicast_receiver->breakloop) {
+		//snapshot the flows, the SLT sync below may join or leave after any batch
+		uint32_t pfds_n = atsc3_multicast_receiver->flows_n;
+		for(uint32_t i = 0; i < pfds_n; i++) {
+			pfds[i].fd = atsc3_multicast_receiver->flows[i].fd;
+			pfds[i].events = POLLIN;
+			pfds[i].revents = 0;
+		}
+
+		int ret = poll(pfds, pfds_n, ATSC3_MULTICAST_RECEIVER_POLL_TIMEOUT_MS);
+		if(ret < 0) {
+			if(errno == EINTR) {
+				continue;
+			}
+			__MULTICAST_RECEIVER_ERROR("poll: %s", strerror(errno));
+			return -1;
+		}
+
+		bool lls_received = false;
+		for(uint32_t i = 0; i < pfds_n && ret > 0; i++) {
+			if(!(pfds[i].revents & (POLLIN | POLLERR))) {
+				continue;
+			}
+
+			atsc3_multicast_receiver_flow_t* atsc3_multicast_receiver_flow = NULL;
+			for(uint32_t j = 0; j < atsc3_multicast_receiver->flows_n; j++) {
+				if(atsc3_multicast_receiver->flows[j].fd == pfds[i].fd) {
+					atsc3_multicast_receiver_flow = &atsc3_multicast_receiver->flows[j];
+					break;
+				}
+			}
+			if(!atsc3_multicast_receiver_flow) {
+				continue;
+			}
+
+			int datagrams_n = atsc3_multicast_receiver_flow_recv_batch(atsc3_multicast_receiver, atsc3_multicast_receiver_flow, callback);
+			if(datagrams_n < 0) {
+				__MULTICAST_RECEIVER_ERROR("recvmmsg: %u.%u.%u.%u:%u: %s", __toipandportnonstruct(atsc3_multicast_receiver_flow->dst_ip_addr, atsc3_multicast_receiver_flow->dst_port), strerror(errno));
+				continue;
+			}
+			datagrams_delivered += datagrams_n;
+			if(datagrams_n && atsc3_multicast_receiver_flow->is_lls) {
+				lls_received = true;
+			}
+		}
+
+		//unchanged SLT sessions need no sync, a flow that failed to join is retried on every LLS batch
+		if(lls_received && lls_slt_monitor && lls_slt_monitor->lls_slt_sessions_generation != atsc3_multicast_receiver->slt_sessions_generation) {
+			uint32_t join_errors = atsc3_multicast_receiver->statistics.join_errors;
+			atsc3_multicast_receiver_slt_sync(atsc3_multicast_receiver, lls_slt_monitor);
+			if(atsc3_multicast_receiver->statistics.join_errors == join_errors) {
+				atsc3_multicast_receiver->slt_sessions_generation = lls_slt_monitor->lls_slt_sessions_generation;
+			}
+		}
+	}
+
+	return datagrams_delivered;
+}
+
+void atsc3_multicast_receiver_free(atsc3_multicast_receiver_t** atsc3_multicast_receiver_p) {
+	if(atsc3_multicast_receiver_p) {
+		atsc3_multicast_receiver_t* atsc3_multicast_receiver = *atsc3_multicast_receiver_p;
+		if(atsc3_multicast_receiver) {
+			for(uint32_t i = 0; i < atsc3_multicast_receiver->flows_n; i++) {
+				close(atsc3_multicast_receiver->flows[i].fd);
+			}
+			for(int i = 0; i < ATSC3_MULTICAST_RECEIVER_BATCH_MAX; i++) {
+				freesafe(atsc3_multicast_receiver->frames[i]);
+			}
+			freesafe(atsc3_multicast_receiver->ifname);
+			free(atsc3_multicast_receiver);
+		}
+		*atsc3_multicast_receiver_p = NULL;
+	}
+}
+
+int atsc3_multicast_receiver_run(const char* dev, pcap_handler callback, lls_slt_monitor_t* lls_slt_monitor) {
+	const char* ifname = atsc3_multicast_receiver_is_dev(dev) ? dev + strlen(ATSC3_MULTICAST_RECEIVER_DEV_PREFIX) : dev;
+
+	atsc3_multicast_receiver_t* atsc3_multicast_receiver = atsc3_multicast_receiver_create(ifname);
+	if(!atsc3_multicast_receiver) {
+		return -1;
+	}
+
+	int64_t ret = atsc3_multicast_receiver_loop(atsc3_multicast_receiver, callback, lls_slt_monitor);
+
+	__MULTICAST_RECEIVER_INFO("multicast receiver: datagrams: %llu, batches: %llu, truncated: %llu, joined: %u, left: %u, join errors: %u",
+			(unsigned long long)atsc3_multicast_receiver->statistics.datagrams_received, (unsigned long long)atsc3_multicast_receiver->statistics.batches_received,
+			(unsigned long long)atsc3_multicast_receiver->statistics.datagrams_truncated, atsc3_multicast_receiver->statistics.flows_joined,
+			atsc3_multicast_receiver->statistics.flows_left, atsc3_multicast_receiver->statistics.join_errors);
+
+	atsc3_multicast_receiver_free(&atsc3_multicast_receiver);
+
+	return ret < 0 ? -1 : 0;
+}
@@ -0,0 +1,119 @@
+/*
+ * atsc3_multicast_receiver.h
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: jjustman
+ *
+ * native udp multicast receiver, an alternative to promiscuous pcap capture for production receivers
+ *
+ * joins the LLS group (224.0.23.60:4937) on create, then atsc3_multicast_receiver_slt_sync() joins exactly the
+ * SLS flows announced in the SLT (lls_sls_mmt_session_t / lls_sls_alc_session_t) and leaves the ones that are
+ * no longer announced. flows with an sls_source_ip_address are joined source specific (MCAST_JOIN_SOURCE_GROUP),
+ * otherwise any source (MCAST_JOIN_GROUP), e.g. for alc sessions with sls_relax_source_ip_check
+ *
+ * each flow has its own socket bound to dst_ip:dst_port, datagrams are read with recvmmsg into a preallocated
+ * batch of MAX_PCAP_LEN buffers. the kernel writes the udp payload after ATSC3_MULTICAST_RECEIVER_FRAME_HEADER_LEN
+ * bytes of headroom, an ethernet/ipv4/udp header is synthesized in front of it so the same pcap_handler
+ * (e.g. process_packet) used for live and offline capture is called without another copy
+ *
+ * atsc3_multicast_receiver_loop() re-syncs the SLT joins after a batch that carried an LLS datagram once an SLT update
+ * has added or removed a session (lls_slt_sessions_generation), the same thread calls process_packet and reads
+ * lls_slt_monitor, so no locking is needed
+ *
+ * listener tools select this receiver in place of libpcap with a dev of multicast:<interface>
+ */
+
+#include <pcap.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <signal.h>
+
+#include "atsc3_utils.h"
+#include "atsc3_logging.h"
+#include "atsc3_listener_udp.h"
+#include "atsc3_lls_types.h"
+
+#ifndef ATSC3_MULTICAST_RECEIVER_H_
+#define ATSC3_MULTICAST_RECEIVER_H_
+
+#if defined (__cplusplus)
+extern "C" {
+#endif
+
+#define ATSC3_MULTICAST_RECEIVER_DEV_PREFIX			"multicast:"
+
+#define ATSC3_MULTICAST_RECEIVER_FLOWS_MAX			64
+#define ATSC3_MULTICAST_RECEIVER_BATCH_MAX			64
+//ethernet + ipv4 (no options) + udp
+#define ATSC3_MULTICAST_RECEIVER_FRAME_HEADER_LEN	42
+#define ATSC3_MULTICAST_RECEIVER_SO_RCVBUF			(8 * 1024 * 1024)
+#define ATSC3_MULTICAST_RECEIVER_POLL_TIMEOUT_MS	100
+
+typedef struct atsc3_multicast_receiver_flow {
+	uint32_t		src_ip_addr;	//0 for any source
+	uint32_t		dst_ip_addr;
+	uint16_t		dst_port;
+	int				fd;
+	bool			is_lls;
+	bool			slt_announced;	//scratch for atsc3_multicast_receiver_slt_sync
+} atsc3_multicast_receiver_flow_t;
+
+typedef struct atsc3_multicast_receiver_statistics {
+	uint64_t	datagrams_received;
+	uint64_t	bytes_received;
+	uint64_t	batches_received;
+	uint64_t	datagrams_truncated;
+	uint32_t	flows_joined;
+	uint32_t	flows_left;
+	uint32_t	join_errors;
+} atsc3_multicast_receiver_statistics_t;
+
+typedef struct atsc3_multicast_receiver {
+	char*								ifname;
+	unsigned int						ifindex;		//0 lets the kernel pick the interface
+
+	atsc3_multicast_receiver_flow_t		flows[ATSC3_MULTICAST_RECEIVER_FLOWS_MAX];
+	uint32_t							flows_n;
+
+	//recvmmsg batch, frames[i] is MAX_PCAP_LEN with the udp payload at ATSC3_MULTICAST_RECEIVER_FRAME_HEADER_LEN
+	uint8_t*							frames[ATSC3_MULTICAST_RECEIVER_BATCH_MAX];
+
+	volatile sig_atomic_t				breakloop;
+
+	//lls_slt_sessions_generation of the last atsc3_multicast_receiver_slt_sync without join errors
+	uint32_t							slt_sessions_generation;
+
+	atsc3_multicast_receiver_statistics_t	statistics;
+} atsc3_multicast_receiver_t;
+
+bool atsc3_multicast_receiver_is_dev(const char* dev);
+
+//ifname may be NULL for the default multicast interface, joins the LLS group
+atsc3_multicast_receiver_t* atsc3_multicast_receiver_create(const char* ifname);
+
+//returns 1 if joined, 0 if the flow was already joined, -1 on error
+int atsc3_multicast_receiver_join(atsc3_multicast_receiver_t* atsc3_multicast_receiver, uint32_t src_ip_addr, uint32_t dst_ip_addr, uint16_t dst_port);
+int atsc3_multicast_receiver_leave(atsc3_multicast_receiver_t* atsc3_multicast_receiver, uint32_t dst_ip_addr, uint16_t dst_port);
+
+//join every flow announced by the SLT and leave the ones no longer announced, returns the number of flows changed
+int atsc3_multicast_receiver_slt_sync(atsc3_multicast_receiver_t* atsc3_multicast_receiver, lls_slt_monitor_t* lls_slt_monitor);
+
+//lls_slt_monitor may be NULL to only receive the joined flows, returns the number of datagrams delivered or -1 on error
+int64_t atsc3_multicast_receiver_loop(atsc3_multicast_receiver_t* atsc3_multicast_receiver, pcap_handler callback, lls_slt_monitor_t* lls_slt_monitor);
+void atsc3_multicast_receiver_breakloop(atsc3_multicast_receiver_t* atsc3_multicast_receiver);
+
+void atsc3_multicast_receiver_free(atsc3_multicast_receiver_t** atsc3_multicast_receiver_p);
+
+//create from dev (multicast:<interface>), loop on the calling thread and release, for listener tools
+int atsc3_multicast_receiver_run(const char* dev, pcap_handler callback, lls_slt_monitor_t* lls_slt_monitor);
+
+#if defined (__cplusplus)
+}
+#endif
+
+#define __MULTICAST_RECEIVER_ERROR(...)   __ATSC3_LOG_ERROR(ATSC3_LOG_MODULE_MULTICAST_RECEIVER, __VA_ARGS__)
+#define __MULTICAST_RECEIVER_WARN(...)    __ATSC3_LOG_WARN(ATSC3_LOG_MODULE_MULTICAST_RECEIVER, __VA_ARGS__)
+#define __MULTICAST_RECEIVER_INFO(...)    __ATSC3_LOG_INFO(ATSC3_LOG_MODULE_MULTICAST_RECEIVER, __VA_ARGS__)
+
+#endif /* ATSC3_MULTICAST_RECEIVER_H_ */
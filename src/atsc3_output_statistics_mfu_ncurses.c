@@ -11,6 +11,7 @@
 #include "atsc3_alc_utils.h"
 #include "atsc3_output_statistics_ncurses_windows.h"
 #include "atsc3_lls_sls_monitor_output_buffer_utils.h"
+#include "atsc3_flow_dispatch.h"
 
 
 //TODO - get rid of me...
@@ -186,6 +187,7 @@ void* ncurses_input_run_thread(void* lls_slt_monitor_ptr) {
 
                         lls_sls_mmt_monitor->lls_sls_monitor_output_buffer.has_written_init_box = false;
                         lls_slt_monitor->lls_sls_mmt_monitor = lls_sls_mmt_monitor;
+                        atsc3_flow_dispatch_rebuild(lls_slt_monitor);
                         
                         wprintw(my_window, "Monitoring Service ID: %u, video packet_id: %u, audio packet_id: %u",  my_service_id, lls_sls_mmt_monitor->video_packet_id, lls_sls_mmt_monitor->audio_packet_id);
                     }
@@ -216,6 +218,8 @@ void* ncurses_input_run_thread(void* lls_slt_monitor_ptr) {
                     lls_slt_monitor->lls_sls_alc_monitor->lls_sls_monitor_output_buffer_mode.pipe_ffplay_buffer = pipe_create_ffplay_resolve_fps(&lls_slt_monitor->lls_sls_alc_monitor->lls_sls_monitor_output_buffer.video_output_buffer_isobmff);
 
                     alc_recon_file_buffer_struct_set_monitor(lls_slt_monitor->lls_sls_alc_monitor);
+                    //segments are reconstituted in memory, skip writing every object out to route/
+                    _ALC_PACKET_DUMP_TO_OBJECT_FILES_ENABLED = 0;
                     
                      lls_slt_monitor->lls_sls_alc_monitor->lls_sls_monitor_output_buffer_mode.ffplay_output_enabled = true;
                 }
@@ -228,6 +232,22 @@ void* ncurses_input_run_thread(void* lls_slt_monitor_ptr) {
             }
         }
         
+        if(ch == 'l') {
+            //toggle low-latency MFU chunk output, the init box is re-sent on each enable
+            if(lls_slt_monitor->lls_sls_mmt_monitor) {
+                if(!lls_slt_monitor->lls_sls_mmt_monitor->lls_sls_monitor_output_buffer_mode.mfu_chunk_output_enabled) {
+                    lls_slt_monitor->lls_sls_mmt_monitor->lls_sls_monitor_output_buffer.has_written_mfu_chunk_init_box = false;
+                    lls_slt_monitor->lls_sls_mmt_monitor->lls_sls_monitor_output_buffer.audio_output_buffer_isobmff.mfu_chunk.sample_in_progress = false;
+                    lls_slt_monitor->lls_sls_mmt_monitor->lls_sls_monitor_output_buffer.video_output_buffer_isobmff.mfu_chunk.sample_in_progress = false;
+                    lls_slt_monitor->lls_sls_mmt_monitor->lls_sls_monitor_output_buffer_mode.mfu_chunk_output_enabled = true;
+                      wprintw(my_window, "MMT: Starting MFU chunk output for service_id: %u, video packet_id: %u, audio packet_id: %u", lls_slt_monitor->lls_sls_mmt_monitor->service_id, lls_slt_monitor->lls_sls_mmt_monitor->video_packet_id, lls_slt_monitor->lls_sls_mmt_monitor->audio_packet_id);
+                } else {
+                    lls_slt_monitor->lls_sls_mmt_monitor->lls_sls_monitor_output_buffer_mode.mfu_chunk_output_enabled = false;
+                      wprintw(my_window, "MMT: Ending MFU chunk output for service_id: %u, video packet_id: %u, audio packet_id: %u", lls_slt_monitor->lls_sls_mmt_monitor->service_id, lls_slt_monitor->lls_sls_mmt_monitor->video_packet_id, lls_slt_monitor->lls_sls_mmt_monitor->audio_packet_id);
+                }
+            }
+        }
+
         if(ch == 'd') {
             //set mode to dump
             if(lls_slt_monitor->lls_sls_mmt_monitor) {
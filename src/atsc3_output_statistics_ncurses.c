@@ -11,6 +11,7 @@
 #include "atsc3_alc_utils.h"
 #include "atsc3_output_statistics_ncurses_windows.h"
 #include "atsc3_lls_sls_monitor_output_buffer_utils.h"
+#include "atsc3_flow_dispatch.h"
 
 //TODO - get rid of me...
 extern int _ALC_PACKET_DUMP_TO_OBJECT_ENABLED;
@@ -175,6 +176,7 @@ void* ncurses_input_run_thread(void* lls_slt_monitor_ptr) {
 
                         lls_sls_mmt_monitor->lls_sls_monitor_output_buffer.has_written_init_box = false;
                         lls_slt_monitor->lls_sls_mmt_monitor = lls_sls_mmt_monitor;
+                        atsc3_flow_dispatch_rebuild(lls_slt_monitor);
                         
                         wprintw(my_window, "Monitoring Service ID: %u, video packet_id: %u, audio packet_id: %u",  my_service_id, lls_sls_mmt_monitor->video_packet_id, lls_sls_mmt_monitor->audio_packet_id);
                     }
@@ -232,10 +234,15 @@ void* ncurses_input_run_thread(void* lls_slt_monitor_ptr) {
                         //TODO - free and teardown if we already have an active monitoring
 						//build our alc_session map
 						lls_sls_alc_monitor = lls_sls_alc_monitor_create();
+						lls_sls_alc_monitor->service_id = my_service_id;
 						lls_sls_alc_monitor->lls_alc_session = lls_sls_alc_session;
+						//objects the session completed before it was monitored were never reconstituted
+						if(lls_sls_alc_session->alc_session) {
+							alc_session_reset_object_cache(lls_sls_alc_session->alc_session);
+						}
 
+                        //defaults until the service's S-TSID arrives on the SLS, see alc_recon_monitor_add_packet
                         if(my_service_id == 1) {
-                            //todo - wire up to mbms signaling
                             lls_sls_alc_monitor->video_tsi = 1;
                             lls_sls_alc_monitor->video_toi_init = 2100000000;
 
@@ -264,6 +271,7 @@ void* ncurses_input_run_thread(void* lls_slt_monitor_ptr) {
                         }
 						lls_sls_alc_monitor->lls_sls_monitor_output_buffer.has_written_init_box = false;
 						lls_slt_monitor->lls_sls_alc_monitor = lls_sls_alc_monitor;
+						atsc3_flow_dispatch_rebuild(lls_slt_monitor);
 						//todo, find our service_id map here
 						//lls_slt_monitor->lls_service =
 					}
@@ -338,6 +346,8 @@ void* ncurses_input_run_thread(void* lls_slt_monitor_ptr) {
                     lls_slt_monitor->lls_sls_alc_monitor->lls_sls_monitor_output_buffer_mode.pipe_ffplay_buffer = pipe_create_ffplay_resolve_fps(&lls_slt_monitor->lls_sls_alc_monitor->lls_sls_monitor_output_buffer.video_output_buffer_isobmff);
 
                     alc_recon_file_buffer_struct_set_monitor(lls_slt_monitor->lls_sls_alc_monitor);
+                    //segments are reconstituted in memory, skip writing every object out to route/
+                    _ALC_PACKET_DUMP_TO_OBJECT_FILES_ENABLED = 0;
                     
                      lls_slt_monitor->lls_sls_alc_monitor->lls_sls_monitor_output_buffer_mode.ffplay_output_enabled = true;
                 }
@@ -350,6 +360,22 @@ void* ncurses_input_run_thread(void* lls_slt_monitor_ptr) {
             }
         }
         
+        if(ch == 'l') {
+            //toggle low-latency MFU chunk output, the init box is re-sent on each enable
+            if(lls_slt_monitor->lls_sls_mmt_monitor) {
+                if(!lls_slt_monitor->lls_sls_mmt_monitor->lls_sls_monitor_output_buffer_mode.mfu_chunk_output_enabled) {
+                    lls_slt_monitor->lls_sls_mmt_monitor->lls_sls_monitor_output_buffer.has_written_mfu_chunk_init_box = false;
+                    lls_slt_monitor->lls_sls_mmt_monitor->lls_sls_monitor_output_buffer.audio_output_buffer_isobmff.mfu_chunk.sample_in_progress = false;
+                    lls_slt_monitor->lls_sls_mmt_monitor->lls_sls_monitor_output_buffer.video_output_buffer_isobmff.mfu_chunk.sample_in_progress = false;
+                    lls_slt_monitor->lls_sls_mmt_monitor->lls_sls_monitor_output_buffer_mode.mfu_chunk_output_enabled = true;
+                      wprintw(my_window, "MMT: Starting MFU chunk output for service_id: %u, video packet_id: %u, audio packet_id: %u", lls_slt_monitor->lls_sls_mmt_monitor->service_id, lls_slt_monitor->lls_sls_mmt_monitor->video_packet_id, lls_slt_monitor->lls_sls_mmt_monitor->audio_packet_id);
+                } else {
+                    lls_slt_monitor->lls_sls_mmt_monitor->lls_sls_monitor_output_buffer_mode.mfu_chunk_output_enabled = false;
+                      wprintw(my_window, "MMT: Ending MFU chunk output for service_id: %u, video packet_id: %u, audio packet_id: %u", lls_slt_monitor->lls_sls_mmt_monitor->service_id, lls_slt_monitor->lls_sls_mmt_monitor->video_packet_id, lls_slt_monitor->lls_sls_mmt_monitor->audio_packet_id);
+                }
+            }
+        }
+
         if(ch == 'd') {
             //set mode to dump
             if(lls_slt_monitor->lls_sls_mmt_monitor) {
@@ -0,0 +1,158 @@
+/*
+ * atsc3_packet_loss_window.c
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: jjustman
+ */
+
+#include "atsc3_packet_loss_window.h"
+
+#define __LOSS_WINDOW_WORD(sequence_number)	(((sequence_number) & (ATSC3_PACKET_LOSS_WINDOW_BITS - 1)) >> 6)
+#define __LOSS_WINDOW_MASK(sequence_number)	(1ULL << ((sequence_number) & 63))
+
+static inline bool __loss_window_test(atsc3_packet_loss_window_t* atsc3_packet_loss_window, uint32_t sequence_number) {
+	return atsc3_packet_loss_window->bitmap[__LOSS_WINDOW_WORD(sequence_number)] & __LOSS_WINDOW_MASK(sequence_number);
+}
+
+static inline void __loss_window_set(atsc3_packet_loss_window_t* atsc3_packet_loss_window, uint32_t sequence_number) {
+	atsc3_packet_loss_window->bitmap[__LOSS_WINDOW_WORD(sequence_number)] |= __LOSS_WINDOW_MASK(sequence_number);
+}
+
+static inline void __loss_window_clear(atsc3_packet_loss_window_t* atsc3_packet_loss_window, uint32_t sequence_number) {
+	atsc3_packet_loss_window->bitmap[__LOSS_WINDOW_WORD(sequence_number)] &= ~__LOSS_WINDOW_MASK(sequence_number);
+}
+
+static void __loss_window_burst_close(atsc3_packet_loss_window_t* atsc3_packet_loss_window) {
+	uint32_t burst_run = atsc3_packet_loss_window->burst_run;
+	if(!burst_run) {
+		return;
+	}
+
+	int bucket = 0;
+	if(burst_run > 1) {
+		bucket = 32 - __builtin_clz(burst_run - 1);
+		if(bucket >= ATSC3_PACKET_LOSS_WINDOW_BURST_BUCKETS) {
+			bucket = ATSC3_PACKET_LOSS_WINDOW_BURST_BUCKETS - 1;
+		}
+	}
+	atsc3_packet_loss_window->burst_histogram[bucket]++;
+	if(burst_run > atsc3_packet_loss_window->burst_max) {
+		atsc3_packet_loss_window->burst_max = burst_run;
+	}
+	atsc3_packet_loss_window->burst_run = 0;
+}
+
+//slide the n oldest sequence numbers out of the window, holes among them are final
+static void __loss_window_exit_oldest(atsc3_packet_loss_window_t* atsc3_packet_loss_window, uint32_t n) {
+	for(uint32_t i = 0; i < n; i++) {
+		uint32_t oldest = atsc3_packet_loss_window->highest - atsc3_packet_loss_window->tracked + 1;
+		if(__loss_window_test(atsc3_packet_loss_window, oldest)) {
+			__loss_window_burst_close(atsc3_packet_loss_window);
+		} else {
+			atsc3_packet_loss_window->lost++;
+			atsc3_packet_loss_window->pending--;
+			atsc3_packet_loss_window->burst_run++;
+		}
+		atsc3_packet_loss_window->tracked--;
+	}
+}
+
+static void __loss_window_flush(atsc3_packet_loss_window_t* atsc3_packet_loss_window) {
+	__loss_window_exit_oldest(atsc3_packet_loss_window, atsc3_packet_loss_window->tracked);
+	__loss_window_burst_close(atsc3_packet_loss_window);
+}
+
+void atsc3_packet_loss_window_init(atsc3_packet_loss_window_t* atsc3_packet_loss_window) {
+	memset(atsc3_packet_loss_window, 0, sizeof(atsc3_packet_loss_window_t));
+}
+
+uint32_t atsc3_packet_loss_window_add(atsc3_packet_loss_window_t* atsc3_packet_loss_window, uint32_t sequence_number) {
+	if(atsc3_packet_loss_window->has_highest) {
+		int32_t diff = (int32_t)(sequence_number - atsc3_packet_loss_window->highest);
+		if(diff >= ATSC3_PACKET_LOSS_WINDOW_DISCONTINUITY || diff <= -ATSC3_PACKET_LOSS_WINDOW_DISCONTINUITY) {
+			atsc3_packet_loss_window->discontinuities++;
+			__loss_window_flush(atsc3_packet_loss_window);
+			atsc3_packet_loss_window->has_highest = false;
+		}
+	}
+
+	if(!atsc3_packet_loss_window->has_highest) {
+		atsc3_packet_loss_window->has_highest = true;
+		atsc3_packet_loss_window->highest = sequence_number;
+		atsc3_packet_loss_window->tracked = 1;
+		__loss_window_set(atsc3_packet_loss_window, sequence_number);
+		atsc3_packet_loss_window->received++;
+		return 0;
+	}
+
+	int32_t diff = (int32_t)(sequence_number - atsc3_packet_loss_window->highest);
+
+	if(diff <= 0) {
+		uint32_t depth = (uint32_t)-diff;
+		if(depth >= atsc3_packet_loss_window->tracked) {
+			atsc3_packet_loss_window->late++;
+		} else if(__loss_window_test(atsc3_packet_loss_window, sequence_number)) {
+			atsc3_packet_loss_window->duplicates++;
+		} else {
+			__loss_window_set(atsc3_packet_loss_window, sequence_number);
+			atsc3_packet_loss_window->received++;
+			atsc3_packet_loss_window->pending--;
+			atsc3_packet_loss_window->reordered++;
+			if(depth > atsc3_packet_loss_window->reorder_depth_max) {
+				atsc3_packet_loss_window->reorder_depth_max = depth;
+			}
+		}
+		return 0;
+	}
+
+	//advance: make room for the d new sequence numbers, the last of which is this packet
+	uint32_t d = (uint32_t)diff;
+	uint32_t total = atsc3_packet_loss_window->tracked + d;
+	uint32_t exiting = total > ATSC3_PACKET_LOSS_WINDOW_BITS ? total - ATSC3_PACKET_LOSS_WINDOW_BITS : 0;
+	uint32_t exiting_tracked = exiting < atsc3_packet_loss_window->tracked ? exiting : atsc3_packet_loss_window->tracked;
+
+	__loss_window_exit_oldest(atsc3_packet_loss_window, exiting_tracked);
+
+	//gap wider than the window: the oldest of the new holes never enter it
+	uint32_t exiting_new = exiting - exiting_tracked;
+	if(exiting_new) {
+		atsc3_packet_loss_window->lost += exiting_new;
+		atsc3_packet_loss_window->burst_run += exiting_new;
+	}
+
+	uint32_t entering = d - exiting_new;
+	if(entering == ATSC3_PACKET_LOSS_WINDOW_BITS) {
+		memset(atsc3_packet_loss_window->bitmap, 0, sizeof(atsc3_packet_loss_window->bitmap));
+	} else {
+		for(uint32_t i = 0; i < entering; i++) {
+			__loss_window_clear(atsc3_packet_loss_window, sequence_number - i);
+		}
+	}
+
+	atsc3_packet_loss_window->pending += entering - 1;
+	atsc3_packet_loss_window->tracked += entering;
+	atsc3_packet_loss_window->highest = sequence_number;
+	__loss_window_set(atsc3_packet_loss_window, sequence_number);
+	atsc3_packet_loss_window->received++;
+
+	return d - 1;
+}
+
+void atsc3_packet_loss_window_rebase(atsc3_packet_loss_window_t* atsc3_packet_loss_window, uint32_t first_sequence_number) {
+	__loss_window_flush(atsc3_packet_loss_window);
+
+	atsc3_packet_loss_window->has_highest = true;
+	atsc3_packet_loss_window->highest = first_sequence_number - 1;
+	atsc3_packet_loss_window->tracked = 0;
+}
+
+double atsc3_packet_loss_window_loss_rate(atsc3_packet_loss_window_t* atsc3_packet_loss_window) {
+	uint64_t missing = atsc3_packet_loss_window_missing(atsc3_packet_loss_window);
+	uint64_t expected = atsc3_packet_loss_window->received + missing;
+
+	return expected ? (double)missing / expected : 0.0;
+}
+
+uint32_t atsc3_packet_loss_window_burst_bucket_min(int i) {
+	return i ? (1U << (i - 1)) + 1 : 1;
+}
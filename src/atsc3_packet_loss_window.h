@@ -0,0 +1,94 @@
+/*
+ * atsc3_packet_loss_window.h
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: jjustman
+ *
+ * fixed size sliding window loss and reorder tracking for a single sequence space, i.e.
+ *
+ * 	MMTP packet_id:	packet_sequence_number
+ * 	MMTP flow:		packet_counter
+ * 	ALC TSI:		ESI (or start_offset / symbol length) within the current TOI
+ *
+ * the window holds one bit per sequence number for the ATSC3_PACKET_LOSS_WINDOW_BITS numbers up to and including the
+ * highest one seen. a sequence number still missing when it slides out of the window is counted as lost, and runs of
+ * consecutive lost numbers are recorded in a log2 burst length histogram. packets arriving below the highest sequence
+ * number fill their hole (reordered, with reorder depth = highest - sequence number), hit an already set bit (duplicate),
+ * or fall behind the window (late, already counted as lost).
+ *
+ * memory is constant per window, each packet costs O(1) amortized: a sequence number is scanned once as it enters and once
+ * as it leaves the window, a single jump is bounded by 2 * ATSC3_PACKET_LOSS_WINDOW_BITS bit operations.
+ *
+ * jumps of ATSC3_PACKET_LOSS_WINDOW_DISCONTINUITY or more in either direction (sender restart, new TOI, etc.) flush the
+ * window and re-anchor on the new sequence number without counting the jump as loss.
+ *
+ * not locked, same as global_stats: updated from the pcap ingest thread, the counters may be read from the ncurses thread.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#ifndef ATSC3_PACKET_LOSS_WINDOW_H_
+#define ATSC3_PACKET_LOSS_WINDOW_H_
+
+#if defined (__cplusplus)
+extern "C" {
+#endif
+
+#define ATSC3_PACKET_LOSS_WINDOW_BITS				1024
+#define ATSC3_PACKET_LOSS_WINDOW_WORDS				(ATSC3_PACKET_LOSS_WINDOW_BITS / 64)
+#define ATSC3_PACKET_LOSS_WINDOW_DISCONTINUITY		0x10000
+
+//burst lengths 1, 2, 3-4, 5-8, 9-16, 17-32, 33-64, 65+
+#define ATSC3_PACKET_LOSS_WINDOW_BURST_BUCKETS		8
+
+typedef struct atsc3_packet_loss_window {
+	bool		has_highest;
+	uint32_t	highest;			//highest sequence number seen, the newest bit in the window
+	uint32_t	tracked;			//sequence numbers currently in the window, <= ATSC3_PACKET_LOSS_WINDOW_BITS
+	uint32_t	burst_run;			//consecutive lost sequence numbers at the trailing edge of the window
+	uint64_t	bitmap[ATSC3_PACKET_LOSS_WINDOW_WORDS];
+
+	uint64_t	received;			//unique sequence numbers received
+	uint64_t	lost;				//slid out of the window without being received
+	uint32_t	pending;			//holes currently in the window, still may be filled by a reordered packet
+	uint64_t	reordered;			//holes filled by a packet arriving below the highest sequence number
+	uint32_t	reorder_depth_max;
+	uint64_t	duplicates;
+	uint64_t	late;				//arrived after sliding out of the window, already counted in lost
+	uint32_t	discontinuities;
+
+	uint32_t	burst_max;
+	uint64_t	burst_histogram[ATSC3_PACKET_LOSS_WINDOW_BURST_BUCKETS];
+} atsc3_packet_loss_window_t;
+
+void atsc3_packet_loss_window_init(atsc3_packet_loss_window_t* atsc3_packet_loss_window);
+
+/*
+ * records sequence_number as received, returns the number of new holes opened ahead of it,
+ * i.e. the gap since the previous highest sequence number, 0 for in order, reordered, duplicate or late packets
+ */
+uint32_t atsc3_packet_loss_window_add(atsc3_packet_loss_window_t* atsc3_packet_loss_window, uint32_t sequence_number);
+
+/*
+ * starts a new sequence space (e.g. the next TOI on an ALC TSI): the window is flushed, holes still pending are counted
+ * as lost, and the next sequence number is expected to be first_sequence_number, anything skipped before it is a hole
+ */
+void atsc3_packet_loss_window_rebase(atsc3_packet_loss_window_t* atsc3_packet_loss_window, uint32_t first_sequence_number);
+
+//lost + pending over expected (received + lost + pending), 0.0 to 1.0
+double atsc3_packet_loss_window_loss_rate(atsc3_packet_loss_window_t* atsc3_packet_loss_window);
+
+static inline uint64_t atsc3_packet_loss_window_missing(atsc3_packet_loss_window_t* atsc3_packet_loss_window) {
+	return atsc3_packet_loss_window->lost + atsc3_packet_loss_window->pending;
+}
+
+//lower bound of the burst lengths in bucket i, for labels
+uint32_t atsc3_packet_loss_window_burst_bucket_min(int i);
+
+#if defined (__cplusplus)
+}
+#endif
+
+#endif /* ATSC3_PACKET_LOSS_WINDOW_H_ */
@@ -0,0 +1,153 @@
+/*
+ *
+ * atsc3_packet_loss_window_test.c:  driver for sliding window loss, burst, reorder and duplicate accounting
+ *
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+
+#include "atsc3_packet_loss_window.h"
+
+int test_loss_window_in_order();
+int test_loss_window_loss_and_bursts();
+int test_loss_window_reorder_and_duplicates();
+int test_loss_window_wide_gap_and_discontinuity();
+int test_loss_window_rebase();
+
+int main() {
+	int failed = 0;
+
+	failed += test_loss_window_in_order();
+	failed += test_loss_window_loss_and_bursts();
+	failed += test_loss_window_reorder_and_duplicates();
+	failed += test_loss_window_wide_gap_and_discontinuity();
+	failed += test_loss_window_rebase();
+
+	printf("atsc3_packet_loss_window_test: %s\n", failed ? "FAILED" : "OK");
+	return failed;
+}
+
+int test_loss_window_in_order() {
+	atsc3_packet_loss_window_t loss_window;
+	atsc3_packet_loss_window_init(&loss_window);
+
+	//across the 32bit sequence number rollover
+	for(uint32_t i = 0; i < 10 * ATSC3_PACKET_LOSS_WINDOW_BITS; i++) {
+		if(atsc3_packet_loss_window_add(&loss_window, 0xFFFFF000 + i)) {
+			printf("test_loss_window_in_order: gap at %u\n", i);
+			return 1;
+		}
+	}
+
+	if(loss_window.received != 10 * ATSC3_PACKET_LOSS_WINDOW_BITS || atsc3_packet_loss_window_missing(&loss_window) || loss_window.duplicates || loss_window.reordered || loss_window.discontinuities) {
+		printf("test_loss_window_in_order: received: %llu, missing: %llu\n", (unsigned long long)loss_window.received, (unsigned long long)atsc3_packet_loss_window_missing(&loss_window));
+		return 1;
+	}
+	return 0;
+}
+
+int test_loss_window_loss_and_bursts() {
+	atsc3_packet_loss_window_t loss_window;
+	atsc3_packet_loss_window_init(&loss_window);
+
+	//drop 1 of 0..99, 2 of 100..199, 5 of 200..299, 100 of 300..499
+	uint32_t sequence_number = 0;
+	for(; sequence_number < 2000; sequence_number++) {
+		if(sequence_number == 50 || (sequence_number >= 150 && sequence_number < 152) ||
+				(sequence_number >= 250 && sequence_number < 255) || (sequence_number >= 350 && sequence_number < 450)) {
+			continue;
+		}
+		uint32_t gap = atsc3_packet_loss_window_add(&loss_window, sequence_number);
+		if((sequence_number == 51 && gap != 1) || (sequence_number == 450 && gap != 100)) {
+			printf("test_loss_window_loss_and_bursts: gap %u at %u\n", gap, sequence_number);
+			return 1;
+		}
+	}
+
+	//all holes have left the window
+	if(loss_window.lost != 108 || loss_window.pending || loss_window.burst_max != 100 ||
+			loss_window.burst_histogram[0] != 1 || loss_window.burst_histogram[1] != 1 ||
+			loss_window.burst_histogram[3] != 1 || loss_window.burst_histogram[7] != 1) {
+		printf("test_loss_window_loss_and_bursts: lost: %llu, pending: %u, burst_max: %u\n", (unsigned long long)loss_window.lost, loss_window.pending, loss_window.burst_max);
+		return 1;
+	}
+
+	double loss_rate = atsc3_packet_loss_window_loss_rate(&loss_window);
+	if(loss_rate < 0.0539 || loss_rate > 0.0541) {
+		printf("test_loss_window_loss_and_bursts: loss rate: %f\n", loss_rate);
+		return 1;
+	}
+	return 0;
+}
+
+int test_loss_window_reorder_and_duplicates() {
+	atsc3_packet_loss_window_t loss_window;
+	atsc3_packet_loss_window_init(&loss_window);
+
+	uint32_t sequence[] = { 1, 2, 5, 3, 4, 4, 6, 10, 7, 9, 8, 8 };
+	for(int i = 0; i < sizeof(sequence) / sizeof(uint32_t); i++) {
+		atsc3_packet_loss_window_add(&loss_window, sequence[i]);
+	}
+
+	if(loss_window.received != 10 || loss_window.duplicates != 2 || loss_window.reordered != 5 ||
+			loss_window.reorder_depth_max != 3 || atsc3_packet_loss_window_missing(&loss_window)) {
+		printf("test_loss_window_reorder_and_duplicates: received: %llu, duplicates: %llu, reordered: %llu, depth: %u\n",
+				(unsigned long long)loss_window.received, (unsigned long long)loss_window.duplicates, (unsigned long long)loss_window.reordered, loss_window.reorder_depth_max);
+		return 1;
+	}
+
+	//behind the window, already counted as lost
+	atsc3_packet_loss_window_add(&loss_window, 10 + ATSC3_PACKET_LOSS_WINDOW_BITS + 1);
+	atsc3_packet_loss_window_add(&loss_window, 11);
+	if(loss_window.late != 1 || loss_window.reordered != 5) {
+		printf("test_loss_window_reorder_and_duplicates: late: %llu\n", (unsigned long long)loss_window.late);
+		return 1;
+	}
+	return 0;
+}
+
+int test_loss_window_wide_gap_and_discontinuity() {
+	atsc3_packet_loss_window_t loss_window;
+	atsc3_packet_loss_window_init(&loss_window);
+
+	atsc3_packet_loss_window_add(&loss_window, 0);
+	atsc3_packet_loss_window_add(&loss_window, 5000);
+	if(loss_window.lost + loss_window.pending != 4999 || loss_window.pending != ATSC3_PACKET_LOSS_WINDOW_BITS - 1) {
+		printf("test_loss_window_wide_gap_and_discontinuity: lost: %llu, pending: %u\n", (unsigned long long)loss_window.lost, loss_window.pending);
+		return 1;
+	}
+
+	//sender restart, not counted as loss
+	atsc3_packet_loss_window_add(&loss_window, 0x80000000);
+	atsc3_packet_loss_window_add(&loss_window, 0x80000001);
+	if(loss_window.discontinuities != 1 || atsc3_packet_loss_window_missing(&loss_window) != 4999 || loss_window.burst_max != 4999) {
+		printf("test_loss_window_wide_gap_and_discontinuity: discontinuities: %u, missing: %llu\n", loss_window.discontinuities, (unsigned long long)atsc3_packet_loss_window_missing(&loss_window));
+		return 1;
+	}
+	return 0;
+}
+
+int test_loss_window_rebase() {
+	atsc3_packet_loss_window_t loss_window;
+	atsc3_packet_loss_window_init(&loss_window);
+
+	//first object: esi 0..9 with 5 missing
+	for(uint32_t esi = 0; esi < 10; esi++) {
+		if(esi != 5) {
+			atsc3_packet_loss_window_add(&loss_window, esi);
+		}
+	}
+
+	//next object starts at esi 0, its first two packets are lost
+	atsc3_packet_loss_window_rebase(&loss_window, 0);
+	if(loss_window.lost != 1 || loss_window.pending) {
+		printf("test_loss_window_rebase: hole not final after rebase, lost: %llu\n", (unsigned long long)loss_window.lost);
+		return 1;
+	}
+	if(atsc3_packet_loss_window_add(&loss_window, 2) != 2 || loss_window.pending != 2 || loss_window.late) {
+		printf("test_loss_window_rebase: leading loss, pending: %u\n", loss_window.pending);
+		return 1;
+	}
+	return 0;
+}
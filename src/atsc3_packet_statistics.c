@@ -7,6 +7,13 @@
 
 #include "atsc3_listener_udp.h"
 #include "atsc3_packet_statistics.h"
+#include "atsc3_mmt_mpu_parser.h"
+#include "atsc3_mmt_signaling_message.h"
+#include "atsc3_alc_rx.h"
+#include "atsc3_alc_object_tracker.h"
+#include "atsc3_latency_histogram.h"
+#include "atsc3_logging.h"
+#include "atsc3_af_packet_capture.h"
 int global_mmt_loss_count;
 bool __LOSS_DISPLAY_ENABLED = true;
 
@@ -133,6 +140,57 @@ packet_id_mmt_stats_t* find_or_create_packet_id(uint32_t ip, uint16_t port, uint
 
 	return packet_mmt_stats;
 }
+packet_flow_t* find_or_create_packet_flow(uint32_t ip, uint16_t port) {
+	packet_flow_t* packet_flow = find_packet_flow(ip, port);
+	if(!packet_flow) {
+		global_stats->packet_flow_vector = (packet_flow_t**)realloc(global_stats->packet_flow_vector, (global_stats->packet_flow_n + 1) * sizeof(packet_flow_t*));
+		if(!global_stats->packet_flow_vector) {
+			abort();
+		}
+
+		packet_flow = global_stats->packet_flow_vector[global_stats->packet_flow_n++] = (packet_flow_t*)calloc(1, sizeof(packet_flow_t));
+		if(!packet_flow) {
+			abort();
+		}
+		packet_flow->ip = ip;
+		packet_flow->port = port;
+		atsc3_packet_loss_window_init(&packet_flow->packet_counter_loss_window);
+	}
+
+	return packet_flow;
+}
+
+packet_alc_tsi_stats_t* find_packet_alc_tsi(uint32_t ip, uint16_t port, uint32_t tsi) {
+	for(int i=0; i < global_stats->packet_alc_tsi_n; i++ ) {
+		packet_alc_tsi_stats_t* packet_alc_tsi_stats = global_stats->packet_alc_tsi_vector[i];
+		if(packet_alc_tsi_stats->ip == ip && packet_alc_tsi_stats->port == port && packet_alc_tsi_stats->tsi == tsi) {
+			return packet_alc_tsi_stats;
+		}
+	}
+	return NULL;
+}
+
+packet_alc_tsi_stats_t* find_or_create_packet_alc_tsi(uint32_t ip, uint16_t port, uint32_t tsi) {
+	packet_alc_tsi_stats_t* packet_alc_tsi_stats = find_packet_alc_tsi(ip, port, tsi);
+	if(!packet_alc_tsi_stats) {
+		global_stats->packet_alc_tsi_vector = (packet_alc_tsi_stats_t**)realloc(global_stats->packet_alc_tsi_vector, (global_stats->packet_alc_tsi_n + 1) * sizeof(packet_alc_tsi_stats_t*));
+		if(!global_stats->packet_alc_tsi_vector) {
+			abort();
+		}
+
+		packet_alc_tsi_stats = global_stats->packet_alc_tsi_vector[global_stats->packet_alc_tsi_n++] = (packet_alc_tsi_stats_t*)calloc(1, sizeof(packet_alc_tsi_stats_t));
+		if(!packet_alc_tsi_stats) {
+			abort();
+		}
+		packet_alc_tsi_stats->ip = ip;
+		packet_alc_tsi_stats->port = port;
+		packet_alc_tsi_stats->tsi = tsi;
+		atsc3_packet_loss_window_init(&packet_alc_tsi_stats->esi_loss_window);
+	}
+
+	return packet_alc_tsi_stats;
+}
+
 void atsc3_packet_statistics_mmt_timed_mpu_stats_populate(mmtp_payload_fragments_union_t* mmtp_payload, packet_id_mmt_stats_t* packet_mmt_stats) {
 	packet_mmt_stats->mpu_stats_timed_sample_interval->mpu_timed_total++;
 
@@ -183,6 +241,32 @@ void atsc3_packet_statistics_mmt_timed_mpu_stats_populate(mmtp_payload_fragments
 
 }
 
+//hand the MPT mpu_timestamp_descriptor tuples to the packet_id each asset is carried on, for the presentation margin
+void atsc3_packet_statistics_mmt_mpu_presentation_time_populate(udp_packet_t* udp_packet, mmtp_payload_fragments_union_t* mmtp_payload) {
+	mmt_signalling_message_vector_t* mmt_signalling_message_vector = &mmtp_payload->mmtp_signalling_message_fragments.mmt_signalling_message_vector;
+
+	for(int i = 0; i < mmt_signalling_message_vector->messages_n; i++) {
+		mmt_signalling_message_header_and_payload_t* mmt_signalling_message_header_and_payload = mmt_signalling_message_vector->messages[i];
+		if(mmt_signalling_message_header_and_payload->message_header.MESSAGE_id_type != MPT_message) {
+			continue;
+		}
+
+		mp_table_t* mp_table = &mmt_signalling_message_header_and_payload->message_payload.mp_table;
+		for(int j = 0; j < mp_table->number_of_assets; j++) {
+			mp_table_asset_row_t* mp_table_asset_row = &mp_table->mp_table_asset_row[j];
+			if(!mp_table_asset_row->mmt_signaling_message_mpu_timestamp_descriptor) {
+				continue;
+			}
+
+			packet_id_mmt_stats_t* packet_mmt_stats = find_or_create_packet_id(udp_packet->udp_flow.dst_ip_addr, udp_packet->udp_flow.dst_port, mp_table_asset_row->mmt_general_location_info.packet_id);
+			for(int k = 0; k < mp_table_asset_row->mmt_signaling_message_mpu_timestamp_descriptor->mpu_tuple_n; k++) {
+				mmt_signaling_message_mpu_tuple_t* mmt_signaling_message_mpu_tuple = &mp_table_asset_row->mmt_signaling_message_mpu_timestamp_descriptor->mpu_tuple[k];
+				atsc3_packet_timing_add_mpu_presentation_time(&packet_mmt_stats->packet_timing, mmt_signaling_message_mpu_tuple->mpu_sequence_number, mmt_signaling_message_mpu_tuple->mpu_presentation_time);
+			}
+		}
+	}
+}
+
 int global_loss_count;
 int __INVOKE_ATSC3_PACKET_STATISTICS_MMT_STATS_POPULATE_COUNT = 0;
 
@@ -206,13 +290,21 @@ void atsc3_packet_statistics_mmt_stats_populate(udp_packet_t* udp_packet, mmtp_p
 
 #endif
 
-					//top level flow check from our new mmtp payload packet and our "current" reference packet
+	if(mmtp_payload->mmtp_packet_header.packet_counter_flag) {
+		packet_flow_t* packet_flow = find_or_create_packet_flow(udp_packet->udp_flow.dst_ip_addr, udp_packet->udp_flow.dst_port);
+		packet_flow->packet_counter_sample_interval_processed++;
+		packet_flow->packet_counter_lifetime_processed++;
+		atsc3_packet_loss_window_add(&packet_flow->packet_counter_loss_window, mmtp_payload->mmtp_packet_header.packet_counter);
+	}
+
+	//top level flow check from our new mmtp payload packet and our "current" reference packet,
+	//reordered and duplicate packets no longer show up as a 4 billion packet gap
+	uint32_t packet_sequence_number_gap = atsc3_packet_loss_window_add(&packet_mmt_stats->packet_sequence_number_loss_window, mmtp_payload->mmtp_packet_header.packet_sequence_number);
 
-	if(packet_mmt_stats->has_packet_sequence_number &&
-		mmtp_payload->mmtp_packet_header.packet_sequence_number != packet_mmt_stats->packet_sequence_number + 1) {
+	if(packet_sequence_number_gap) {
 
-		//compute our intra packet gap, remember to add 1 because we have the anchor packets
-		packet_mmt_stats->packet_sequence_number_last_gap = mmtp_payload->mmtp_packet_header.packet_sequence_number - packet_mmt_stats->packet_sequence_number - 1;
+		//compute our intra packet gap
+		packet_mmt_stats->packet_sequence_number_last_gap = packet_sequence_number_gap;
 
 		//compute our sample interval gap
 		packet_mmt_stats->packet_sequence_number_sample_interval_gap += packet_mmt_stats->packet_sequence_number_last_gap;
@@ -221,9 +313,8 @@ void atsc3_packet_statistics_mmt_stats_populate(udp_packet_t* udp_packet, mmtp_p
 			packet_mmt_stats->packet_sequence_number_max_gap = packet_mmt_stats->packet_sequence_number_last_gap;
 		}
 
-		//add this gap into the total count of mmt packets missing
+		//add this gap into the total count of mmt packets missing, lifetime missing is lost + pending from the loss window
 		packet_mmt_stats->packet_sequence_number_sample_interval_missing += packet_mmt_stats->packet_sequence_number_last_gap;
-		packet_mmt_stats->packet_sequence_number_lifetime_missing += packet_mmt_stats->packet_sequence_number_last_gap;
 		global_stats->packet_counter_mmtp_packets_missing += packet_mmt_stats->packet_sequence_number_last_gap;
 
 
@@ -349,12 +440,15 @@ void atsc3_packet_statistics_mmt_stats_populate(udp_packet_t* udp_packet, mmtp_p
 		}
 	}
 
+	atsc3_packet_timing_add(&packet_mmt_stats->packet_timing, mmtp_payload->mmtp_packet_header.mmtp_timestamp, &udp_packet->arrival_timeval);
+
 	//mpu metadata
 	if(mmtp_payload->mmtp_packet_header.mmtp_payload_type == 0x0) {
 
 		//assign our timed mpu stats
 		if(mmtp_payload->mmtp_mpu_type_packet_header.mpu_timed_flag == 1) {
 			atsc3_packet_statistics_mmt_timed_mpu_stats_populate(mmtp_payload, packet_mmt_stats);
+			atsc3_packet_timing_add_mpu_packet(&packet_mmt_stats->packet_timing, mmtp_payload->mmtp_mpu_type_packet_header.mpu_sequence_number, &udp_packet->arrival_timeval);
 
 		} else {
 			//assign our non-timed stats here
@@ -363,11 +457,46 @@ void atsc3_packet_statistics_mmt_stats_populate(udp_packet_t* udp_packet, mmtp_p
 	} else if(mmtp_payload->mmtp_packet_header.mmtp_payload_type == 0x2) {
 		//assign our signalling stats here
 		packet_mmt_stats->signalling_stats_sample_interval->signalling_messages_total++;
+		atsc3_packet_statistics_mmt_mpu_presentation_time_populate(udp_packet, mmtp_payload);
 	}
 
 	global_stats->packet_id_delta = packet_mmt_stats;
 }
 
+void atsc3_packet_statistics_alc_stats_populate(udp_packet_t* udp_packet, alc_packet_t* alc_packet) {
+	//in-band FDT-Instances are interleaved with the objects they describe and carry no ESI sequence of their own
+	if(alc_packet->def_lct_hdr.toi == 0) {
+		return;
+	}
+
+	packet_alc_tsi_stats_t* packet_alc_tsi_stats = find_or_create_packet_alc_tsi(udp_packet->udp_flow.dst_ip_addr, udp_packet->udp_flow.dst_port, alc_packet->def_lct_hdr.tsi);
+	packet_alc_tsi_stats->packet_counter_lifetime_processed++;
+
+	//a RaptorQ recovered object arrives rewritten as one start_offset packet carrying the whole object, its esi is still the
+	//last symbol the decoder took, and its alc_len is the transfer_len, not a symbol length
+	uint32_t esi = alc_packet->esi;
+	if(!alc_packet->use_sbn_esi && !alc_packet->fec_recovered_object) {
+		//compact no-code fec, start_offset is in bytes, every packet but the last of the object carries a full symbol
+		if(alc_packet->alc_len > packet_alc_tsi_stats->symbol_length) {
+			packet_alc_tsi_stats->symbol_length = alc_packet->alc_len;
+		}
+		esi = packet_alc_tsi_stats->symbol_length ? alc_packet->start_offset / packet_alc_tsi_stats->symbol_length : 0;
+	}
+
+	uint32_t toi = alc_packet->def_lct_hdr.toi;
+	if(!packet_alc_tsi_stats->has_toi || toi != packet_alc_tsi_stats->toi) {
+		//next object: holes left in the previous one are final, losses at its tail are not visible.
+		//a new TOI is expected from ESI 0, returning to the TOI we just left (e.g. around an interleaved init segment) re-anchors on this ESI
+		bool is_toi_previous = packet_alc_tsi_stats->has_toi && toi == packet_alc_tsi_stats->toi_previous;
+		packet_alc_tsi_stats->toi_previous = packet_alc_tsi_stats->toi;
+		packet_alc_tsi_stats->toi = toi;
+		packet_alc_tsi_stats->has_toi = true;
+		atsc3_packet_loss_window_rebase(&packet_alc_tsi_stats->esi_loss_window, is_toi_previous ? esi : 0);
+	}
+
+	atsc3_packet_loss_window_add(&packet_alc_tsi_stats->esi_loss_window, esi);
+}
+
 int DUMP_COUNTER=0;
 int DUMP_COUNTER_2=0;
 
@@ -394,24 +523,77 @@ void atsc3_packet_statistics_dump_global_stats(){
 	__PS_STATS_GLOBAL("- type=0x? Other            : %'-u",	global_stats->packet_counter_mmt_unknown);
 	__PS_STATS_GLOBAL("> parsed errors             : %'-u",	global_stats->packet_counter_mmtp_packets_parsed_error);
 	__PS_STATS_GLOBAL("> missing packets           : %'-u",	global_stats->packet_counter_mmtp_packets_missing);
+	__PS_STATS_GLOBAL("- MPUs held / evicted       : %'-u / %'-u", mpu_retention_stats.mpus_held, mpu_retention_stats.mpus_evicted);
+	__PS_STATS_GLOBAL("  - bytes held / evicted    : %'-llu / %'-llu", (unsigned long long)mpu_retention_stats.bytes_held, (unsigned long long)mpu_retention_stats.bytes_evicted);
+	//packet_counter loss per flow: loss % / reordered / duplicate
+	for(int i=0; i < global_stats->packet_flow_n; i++ ) {
+		packet_flow_t* packet_flow = global_stats->packet_flow_vector[i];
+		__PS_STATS_GLOBAL("- %u.%u.%u.%u:%-5u loss/reord/dup: %.3f%% / %'-llu / %'-llu", __toip(packet_flow),
+				100.0 * atsc3_packet_loss_window_loss_rate(&packet_flow->packet_counter_loss_window),
+				(unsigned long long)packet_flow->packet_counter_loss_window.reordered, (unsigned long long)packet_flow->packet_counter_loss_window.duplicates);
+	}
 	__PS_STATS_GLOBAL("");
 	__PS_STATS_GLOBAL("ALC total packets received  : %'-u",	global_stats->packet_counter_alc_recv);
 	__PS_STATS_GLOBAL("> parsed good               : %'-u",	global_stats->packet_counter_alc_packets_parsed);
 	__PS_STATS_GLOBAL("> parsed errors             : %'-u",	global_stats->packet_counter_alc_packets_parsed_error);
+	__PS_STATS_GLOBAL("> filtered (unsubscribed)   : %'-u",	global_stats->packet_counter_alc_packets_filtered);
+	__PS_STATS_GLOBAL("- objects completed/evicted : %'-llu / %'-llu", (unsigned long long)atsc3_alc_object_tracker_stats.objects_completed, (unsigned long long)atsc3_alc_object_tracker_stats.objects_evicted);
+	__PS_STATS_GLOBAL("  - duplicate bytes         : %'-llu", (unsigned long long)atsc3_alc_object_tracker_stats.duplicate_bytes);
+	__PS_STATS_GLOBAL("- repeats suppressed/saved  : %'-llu / %'-llu", (unsigned long long)atsc3_alc_object_tracker_stats.repeats_suppressed, (unsigned long long)atsc3_alc_object_tracker_stats.repeat_bytes_saved);
+	__PS_STATS_GLOBAL("  - invalidated / evicted   : %'-llu / %'-llu", (unsigned long long)atsc3_alc_object_tracker_stats.objects_invalidated, (unsigned long long)atsc3_alc_object_tracker_stats.cache_evicted);
+	//ESI loss per TSI: loss % / reordered / duplicate, max burst
+	for(int i=0; i < global_stats->packet_alc_tsi_n; i++ ) {
+		packet_alc_tsi_stats_t* packet_alc_tsi_stats = global_stats->packet_alc_tsi_vector[i];
+		atsc3_packet_loss_window_t* loss_window = &packet_alc_tsi_stats->esi_loss_window;
+		__PS_STATS_GLOBAL("- tsi: %-5u toi: %-10u loss/reord/dup: %.3f%% / %'-llu / %'-llu  max burst: %u", packet_alc_tsi_stats->tsi, packet_alc_tsi_stats->toi,
+				100.0 * atsc3_packet_loss_window_loss_rate(loss_window), (unsigned long long)loss_window->reordered, (unsigned long long)loss_window->duplicates, loss_window->burst_max);
+	}
 	__PS_STATS_GLOBAL("")
 	__PS_STATS_GLOBAL("Non ATSC3 Packets           : %'-u", global_stats->packet_counter_filtered_ipv4);
 	__PS_STATS_GLOBAL("");
 	__PS_STATS_GLOBAL("");
 	__PS_STATS_GLOBAL("Total Mulicast Packets RX   : %'-u", global_stats->packets_total_received);
 
+	if(atsc3_af_packet_capture_is_running()) {
+		atsc3_af_packet_capture_statistics_t atsc3_af_packet_capture_statistics;
+		atsc3_af_packet_capture_statistics_get(&atsc3_af_packet_capture_statistics);
+		__PS_STATS_GLOBAL("");
+		__PS_STATS_GLOBAL("AF_PACKET frames / blocks   : %'-llu / %'-llu", (unsigned long long)atsc3_af_packet_capture_statistics.frames_received, (unsigned long long)atsc3_af_packet_capture_statistics.blocks_received);
+		__PS_STATS_GLOBAL("> kernel drops / freezes    : %'-llu / %'-llu", (unsigned long long)atsc3_af_packet_capture_statistics.kernel_drops, (unsigned long long)atsc3_af_packet_capture_statistics.kernel_freeze_q_cnt);
+	}
+
+	if(atsc3_log_async_is_running()) {
+		atsc3_log_statistics_t atsc3_log_statistics;
+		atsc3_log_statistics_get(&atsc3_log_statistics);
+		__PS_STATS_GLOBAL("");
+		__PS_STATS_GLOBAL("Log records written/dropped : %'-llu / %'-llu", (unsigned long long)atsc3_log_statistics.records_written, (unsigned long long)atsc3_log_statistics.records_dropped);
+	}
+
+#ifdef __LATENCY_HISTOGRAM_ENABLED
+	//arrival to stage latency, p50 / p99 / max in msec
+	for(uint32_t i = 0; i < atsc3_latency_histogram_service_count(); i++) {
+		atsc3_latency_histogram_service_t* atsc3_latency_histogram_service = atsc3_latency_histogram_service_get(i);
+		__PS_STATS_GLOBAL("");
+		__PS_STATS_GLOBAL("Latency service_id: %-5u   : p50 / p99 / max ms", atsc3_latency_histogram_service->service_id);
+		for(int stage_id = 0; stage_id < ATSC3_LATENCY_STAGE_MAX; stage_id++) {
+			atsc3_latency_histogram_t* atsc3_latency_histogram = &atsc3_latency_histogram_service->stages[stage_id];
+			if(!atsc3_latency_histogram->count) {
+				continue;
+			}
+			__PS_STATS_GLOBAL("- %-25s : %.2f / %.2f / %.2f", atsc3_latency_histogram_stage_name((atsc3_latency_stage_id_t)stage_id),
+					atsc3_latency_histogram_percentile(atsc3_latency_histogram, 50.0) / 1000000.0,
+					atsc3_latency_histogram_percentile(atsc3_latency_histogram, 99.0) / 1000000.0,
+					atsc3_latency_histogram->max_ns / 1000000.0);
+		}
+	}
+#endif
+
 	//dump flow status
 	for(int i=0; i < global_stats->packet_id_n; i++ ) {
 		packet_id_mmt_stats_t* packet_mmt_stats = global_stats->packet_id_vector[i];
 
-		double computed_flow_packet_loss = 0;
-		if(packet_mmt_stats->packet_sequence_number_lifetime_processed && packet_mmt_stats->packet_sequence_number_lifetime_missing) {
-			computed_flow_packet_loss = 100.0 * (packet_mmt_stats->packet_sequence_number_lifetime_missing / packet_mmt_stats->packet_sequence_number_lifetime_processed);
-		}
+		atsc3_packet_loss_window_t* loss_window = &packet_mmt_stats->packet_sequence_number_loss_window;
+		double computed_flow_packet_loss = 100.0 * atsc3_packet_loss_window_loss_rate(loss_window);
 		uint16_t seconds;
 		uint16_t microseconds;
 		compute_ntp32_to_seconds_microseconds(packet_mmt_stats->timestamp, &seconds, &microseconds);
@@ -437,7 +619,20 @@ void atsc3_packet_statistics_dump_global_stats(){
 
 		__PS_STATS_FLOW("Lifetime NTP            : %u.%03u  to %u.%03u  (%-10u to %-10u)    Loss Pct: %f",packet_mmt_stats->timestamp_lifetime_start_s, packet_mmt_stats->timestamp_lifetime_start_us/100, seconds, microseconds/100, packet_mmt_stats->timestamp_lifetime_start, packet_mmt_stats->timestamp, computed_flow_packet_loss);
 		__PS_STATS_FLOW("packet_seq_numbers      : %-10u to %-10u (0x%08x to 0x%08x)    max sequence gap: %-6d ",	packet_mmt_stats->packet_sequence_number_lifetime_start,  packet_mmt_stats->packet_sequence_number, packet_mmt_stats->packet_sequence_number_lifetime_start, packet_mmt_stats->packet_sequence_number, packet_mmt_stats->packet_sequence_number_max_gap);
-		__PS_STATS_FLOW("Total packets RX        : %-6u     missing: %-6u",	packet_mmt_stats->packet_sequence_number_lifetime_processed, packet_mmt_stats->packet_sequence_number_lifetime_missing);
+		__PS_STATS_FLOW("Total packets RX        : %-6u     missing: %-6llu (lost: %llu, pending: %u)",	packet_mmt_stats->packet_sequence_number_lifetime_processed,
+				(unsigned long long)atsc3_packet_loss_window_missing(loss_window), (unsigned long long)loss_window->lost, loss_window->pending);
+		__PS_STATS_FLOW("reordered / duplicate   : %-6llu / %-6llu  max reorder depth: %-6u  late: %llu", (unsigned long long)loss_window->reordered,
+				(unsigned long long)loss_window->duplicates, loss_window->reorder_depth_max, (unsigned long long)loss_window->late);
+		atsc3_packet_timing_t* packet_timing = &packet_mmt_stats->packet_timing;
+		__PS_STATS_FLOW("latency ms avg/min/max  : %.3f / %.3f / %.3f   jitter ms: %.3f", atsc3_packet_timing_latency_mean_us(packet_timing) / 1000.0,
+				packet_timing->latency_min_us / 1000.0, packet_timing->latency_max_us / 1000.0, atsc3_packet_timing_jitter_us(packet_timing) / 1000.0);
+		__PS_STATS_FLOW("mpu margin ms last/avg/min: %.3f / %.3f / %.3f   late mpus: %u of %u", packet_timing->margin_last_us / 1000.0,
+				atsc3_packet_timing_margin_mean_us(packet_timing) / 1000.0, packet_timing->margin_min_us / 1000.0, packet_timing->margin_late_count, packet_timing->margin_count);
+		__PS_STATS_FLOW("loss bursts 1/2/3-4/5-8/9-16/17-32/33-64/65+: %llu/%llu/%llu/%llu/%llu/%llu/%llu/%llu  max: %u",
+				(unsigned long long)loss_window->burst_histogram[0], (unsigned long long)loss_window->burst_histogram[1],
+				(unsigned long long)loss_window->burst_histogram[2], (unsigned long long)loss_window->burst_histogram[3],
+				(unsigned long long)loss_window->burst_histogram[4], (unsigned long long)loss_window->burst_histogram[5],
+				(unsigned long long)loss_window->burst_histogram[6], (unsigned long long)loss_window->burst_histogram[7], loss_window->burst_max);
 
 		int row, col;
 		getyx(pkt_flow_stats_mmt_window, row, col);
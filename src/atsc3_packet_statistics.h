@@ -15,6 +15,8 @@
 #include "atsc3_utils.h"
 #include "atsc3_lls.h"
 #include "atsc3_mmtp_types.h"
+#include "atsc3_packet_loss_window.h"
+#include "atsc3_packet_timing.h"
 #include "atsc3_output_statistics_ncurses.h"
 
 #ifndef ATSC3_MMT_PACKET_STATISTICS_H_
@@ -67,16 +69,6 @@ typedef struct packet_id_signalling_stats {
 
 } packet_id_signalling_stats_t;
 
-typedef struct packet_id_missing {
-	uint32_t packet_sequence_number_present_oldest;
-	uint32_t timestamp_oldest;
-	uint32_t packet_sequence_number_missing_oldest;
-	uint32_t packet_sequence_number_missing_newest;
-	uint32_t packet_sequence_number_present_newest;
-	uint32_t timestamp_newest;
-	uint32_t missing_count;
-} packet_id_missing_t;
-
 //remember, many of these values can roll over
 //needed: uint33_t for nullables :)
 typedef struct packet_id_mmt_stats {
@@ -122,7 +114,6 @@ typedef struct packet_id_mmt_stats {
 	uint32_t packet_sequence_number_sample_interval_missing;
 
 	uint32_t packet_sequence_number_lifetime_processed;
-	uint32_t packet_sequence_number_lifetime_missing;
 
 	packet_id_mmt_timed_mpu_stats_t* 		mpu_stats_timed_sample_interval;
 	packet_id_mmt_nontimed_mpu_stats_t* 	mpu_stats_nontimed_sample_interval;
@@ -133,8 +124,10 @@ typedef struct packet_id_mmt_stats {
 	packet_id_signalling_stats_t* 			signalling_stats_lifetime;
 
 	uint32_t				packet_counter_value;
-	int						packet_id_missing_n;
-	packet_id_missing_t**	packet_id_missing_vector;
+	//keyed on packet_sequence_number, loss, burst, reorder and duplicate accounting in constant memory
+	atsc3_packet_loss_window_t	packet_sequence_number_loss_window;
+	//delivery latency and jitter from mmtp_timestamp vs. arrival, MPU presentation margin from the MPT
+	atsc3_packet_timing_t		packet_timing;
 
 } packet_id_mmt_stats_t;
 
@@ -147,9 +140,32 @@ typedef struct packet_flow {
 	uint32_t packet_counter_lifetime_processed;
 
 
+	//keyed on the MMTP packet_counter, which spans all packet_id's on the flow, only present with packet_counter_flag
+	atsc3_packet_loss_window_t	packet_counter_loss_window;
+
 	int	packet_id_n;
 	packet_id_mmt_stats_t* packet_id_vector;
 } packet_flow_t;
+
+/*
+ * ALC has no packet sequence number, loss is tracked on the ESI within the current TOI:
+ * for compact no-code FEC (start_offset) the ESI is start_offset / symbol_length, where symbol_length is the
+ * largest alc_len seen on the TSI's source symbol packets (a RaptorQ recovered object rewritten as one start_offset packet
+ * keeps its own ESI and never widens it). the window is rebased on every TOI change, TOI 0 (FDT-Instance) packets are not tracked.
+ */
+typedef struct packet_alc_tsi_stats {
+	uint32_t ip;
+	uint16_t port;
+	uint32_t tsi;
+
+	bool	 has_toi;
+	uint32_t toi;
+	uint32_t toi_previous;
+	uint32_t symbol_length;
+
+	uint32_t packet_counter_lifetime_processed;
+	atsc3_packet_loss_window_t	esi_loss_window;
+} packet_alc_tsi_stats_t;
 /*
  *
  * todo: capture these on a mmtp flow
@@ -162,9 +178,6 @@ typedef struct packet_flow {
 	uint32_t packet_counter_totalf
  */
 
-/*
- * also capture ALC flow tsi information
- */
 typedef struct global_atsc3_stats {
 
 	uint32_t packet_counter_lls_packets_received;
@@ -188,7 +201,7 @@ typedef struct global_atsc3_stats {
     
 
 	int packet_flow_n;
-	packet_flow_t** packet_flow_vector; //not used yet
+	packet_flow_t** packet_flow_vector;
 
 	int	packet_id_n;
 	packet_id_mmt_stats_t** packet_id_vector;
@@ -197,6 +210,11 @@ typedef struct global_atsc3_stats {
 	uint32_t packet_counter_alc_recv;
 	uint32_t packet_counter_alc_packets_parsed;
 	uint32_t packet_counter_alc_packets_parsed_error;
+	//unmonitored service or unsubscribed TSI, dropped before alc_rx
+	uint32_t packet_counter_alc_packets_filtered;
+
+	int packet_alc_tsi_n;
+	packet_alc_tsi_stats_t** packet_alc_tsi_vector;
 
 	uint32_t packet_counter_filtered_ipv4;
     uint32_t packet_counter_udp_unknown;
@@ -209,14 +227,19 @@ typedef struct global_atsc3_stats {
 
 extern global_atsc3_stats_t* global_stats;
 
+struct alc_packet;
+
 
 
 packet_id_mmt_stats_t* find_packet_id(uint32_t ip, uint16_t port, uint32_t packet_id);
 packet_id_mmt_stats_t* find_or_create_packet_id(uint32_t ip, uint16_t port, uint32_t packet_id);
+packet_flow_t* find_or_create_packet_flow(uint32_t ip, uint16_t port);
+packet_alc_tsi_stats_t* find_or_create_packet_alc_tsi(uint32_t ip, uint16_t port, uint32_t tsi);
 
 void atsc3_packet_statistics_dump_global_stats();
 void atsc3_packet_statistics_dump_mfu_stats();
 void atsc3_packet_statistics_mmt_stats_populate(udp_packet_t* udp_packet, mmtp_payload_fragments_union_t* mmtp_payload);
+void atsc3_packet_statistics_alc_stats_populate(udp_packet_t* udp_packet, struct alc_packet* alc_packet);
 void *print_global_statistics_thread(void *vargp);
 void *print_mfu_statistics_thread(void *vargp);
 
@@ -0,0 +1,101 @@
+/*
+ * atsc3_packet_timing.c
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: jjustman
+ */
+
+#include "atsc3_packet_timing.h"
+#include "atsc3_mmtp_ntp32_to_pts.h"
+
+void atsc3_packet_timing_init(atsc3_packet_timing_t* atsc3_packet_timing) {
+	memset(atsc3_packet_timing, 0, sizeof(atsc3_packet_timing_t));
+}
+
+void atsc3_packet_timing_add(atsc3_packet_timing_t* atsc3_packet_timing, uint32_t mmtp_timestamp, const struct timeval* arrival_timeval) {
+	if(!mmtp_timestamp || !arrival_timeval->tv_sec) {
+		return;
+	}
+
+	//bring the arrival into the same 65536s era as the ntp32 short-format timestamp, then take the nearest wrap
+	int64_t arrival_us = compute_timeval_to_ntp64_microseconds(arrival_timeval) % NTP32_SHORT_FORMAT_ERA_US;
+	int64_t transit_us = arrival_us - (int64_t)compute_ntp32_to_microseconds(mmtp_timestamp);
+	if(transit_us >= (int64_t)NTP32_SHORT_FORMAT_ERA_US / 2) {
+		transit_us -= NTP32_SHORT_FORMAT_ERA_US;
+	} else if(transit_us < -(int64_t)NTP32_SHORT_FORMAT_ERA_US / 2) {
+		transit_us += NTP32_SHORT_FORMAT_ERA_US;
+	}
+
+	if(!atsc3_packet_timing->latency_count || transit_us < atsc3_packet_timing->latency_min_us) {
+		atsc3_packet_timing->latency_min_us = transit_us;
+	}
+	if(!atsc3_packet_timing->latency_count || transit_us > atsc3_packet_timing->latency_max_us) {
+		atsc3_packet_timing->latency_max_us = transit_us;
+	}
+	atsc3_packet_timing->latency_count++;
+	atsc3_packet_timing->latency_last_us = transit_us;
+	atsc3_packet_timing->latency_sum_us += transit_us;
+
+	if(atsc3_packet_timing->has_transit) {
+		int64_t d = transit_us - atsc3_packet_timing->transit_last_us;
+		if(d < 0) {
+			d = -d;
+		}
+		atsc3_packet_timing->jitter_us_q4 += d - ((atsc3_packet_timing->jitter_us_q4 + 8) >> 4);
+	}
+	atsc3_packet_timing->has_transit = true;
+	atsc3_packet_timing->transit_last_us = transit_us;
+}
+
+void atsc3_packet_timing_add_mpu_presentation_time(atsc3_packet_timing_t* atsc3_packet_timing, uint32_t mpu_sequence_number, uint64_t mpu_presentation_time) {
+	for(int i = 0; i < ATSC3_PACKET_TIMING_MPU_PRESENTATION_TIME_MAX; i++) {
+		if(atsc3_packet_timing->mpu_presentation_time[i] && atsc3_packet_timing->mpu_presentation_time_sequence_number[i] == mpu_sequence_number) {
+			atsc3_packet_timing->mpu_presentation_time[i] = mpu_presentation_time;
+			return;
+		}
+	}
+
+	atsc3_packet_timing->mpu_presentation_time_sequence_number[atsc3_packet_timing->mpu_presentation_time_next] = mpu_sequence_number;
+	atsc3_packet_timing->mpu_presentation_time[atsc3_packet_timing->mpu_presentation_time_next] = mpu_presentation_time;
+	atsc3_packet_timing->mpu_presentation_time_next = (atsc3_packet_timing->mpu_presentation_time_next + 1) % ATSC3_PACKET_TIMING_MPU_PRESENTATION_TIME_MAX;
+}
+
+static void __packet_timing_margin_commit(atsc3_packet_timing_t* atsc3_packet_timing) {
+	if(!atsc3_packet_timing->has_margin_current) {
+		return;
+	}
+
+	int64_t margin_us = atsc3_packet_timing->margin_current_us;
+	if(!atsc3_packet_timing->margin_count || margin_us < atsc3_packet_timing->margin_min_us) {
+		atsc3_packet_timing->margin_min_us = margin_us;
+	}
+	if(margin_us < 0) {
+		atsc3_packet_timing->margin_late_count++;
+	}
+	atsc3_packet_timing->margin_count++;
+	atsc3_packet_timing->margin_last_us = margin_us;
+	atsc3_packet_timing->margin_sum_us += margin_us;
+	atsc3_packet_timing->has_margin_current = false;
+}
+
+void atsc3_packet_timing_add_mpu_packet(atsc3_packet_timing_t* atsc3_packet_timing, uint32_t mpu_sequence_number, const struct timeval* arrival_timeval) {
+	if(!atsc3_packet_timing->has_mpu_sequence_number || atsc3_packet_timing->mpu_sequence_number != mpu_sequence_number) {
+		__packet_timing_margin_commit(atsc3_packet_timing);
+		atsc3_packet_timing->has_mpu_sequence_number = true;
+		atsc3_packet_timing->mpu_sequence_number = mpu_sequence_number;
+	}
+
+	if(!arrival_timeval->tv_sec) {
+		return;
+	}
+
+	//the MPT carrying this MPU's tuple may only show up after its first packets, look it up on every packet
+	for(int i = 0; i < ATSC3_PACKET_TIMING_MPU_PRESENTATION_TIME_MAX; i++) {
+		if(atsc3_packet_timing->mpu_presentation_time[i] && atsc3_packet_timing->mpu_presentation_time_sequence_number[i] == mpu_sequence_number) {
+			atsc3_packet_timing->margin_current_us = (int64_t)compute_ntp64_to_microseconds(atsc3_packet_timing->mpu_presentation_time[i]) -
+					(int64_t)compute_timeval_to_ntp64_microseconds(arrival_timeval);
+			atsc3_packet_timing->has_margin_current = true;
+			return;
+		}
+	}
+}
@@ -0,0 +1,94 @@
+/*
+ * atsc3_packet_timing.h
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: jjustman
+ *
+ * per flow arrival timing from the MMTP ntp32 sender timestamp versus the capture time of the packet:
+ *
+ * 	delivery latency:	arrival - mmtp_timestamp, both in the 65536s ntp short-format era, only meaningful with the
+ * 						capture host clock locked to the same time base as the sender (NTP/PTP on the STL or IP link)
+ * 	jitter:				RFC 3550 section 6.4.1 interarrival jitter, J += (|D(i-1,i)| - J) / 16 on the transit time,
+ * 						independent of any fixed clock offset
+ * 	presentation margin: MPU timestamp descriptor mpu_presentation_time - arrival of the last packet of that MPU,
+ * 						negative margins are MPUs that completed after they should have been presented
+ *
+ * each update is O(1) with constant memory, the mpu_presentation_time lookup is a fixed ring of the most recent
+ * ATSC3_PACKET_TIMING_MPU_PRESENTATION_TIME_MAX MPT mpu_tuples.
+ *
+ * not locked, same as global_stats: updated from the pcap ingest thread, the counters may be read from the ncurses thread.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <sys/time.h>
+
+#ifndef ATSC3_PACKET_TIMING_H_
+#define ATSC3_PACKET_TIMING_H_
+
+#if defined (__cplusplus)
+extern "C" {
+#endif
+
+#define ATSC3_PACKET_TIMING_MPU_PRESENTATION_TIME_MAX 8
+
+typedef struct atsc3_packet_timing {
+	//delivery latency, arrival - mmtp_timestamp
+	uint32_t	latency_count;
+	int64_t		latency_last_us;
+	int64_t		latency_min_us;
+	int64_t		latency_max_us;
+	int64_t		latency_sum_us;
+
+	//RFC 3550 interarrival jitter, in us scaled by 16 as in A.8
+	bool		has_transit;
+	int64_t		transit_last_us;
+	uint64_t	jitter_us_q4;
+
+	//MPT mpu_timestamp_descriptor tuples seen for this packet_id
+	uint32_t	mpu_presentation_time_sequence_number[ATSC3_PACKET_TIMING_MPU_PRESENTATION_TIME_MAX];
+	uint64_t	mpu_presentation_time[ATSC3_PACKET_TIMING_MPU_PRESENTATION_TIME_MAX];
+	int			mpu_presentation_time_next;
+
+	//margin of the MPU currently being received, committed when the mpu_sequence_number changes
+	bool		has_mpu_sequence_number;
+	uint32_t	mpu_sequence_number;
+	bool		has_margin_current;
+	int64_t		margin_current_us;
+
+	uint32_t	margin_count;
+	int64_t		margin_last_us;
+	int64_t		margin_min_us;
+	int64_t		margin_sum_us;
+	uint32_t	margin_late_count;
+} atsc3_packet_timing_t;
+
+void atsc3_packet_timing_init(atsc3_packet_timing_t* atsc3_packet_timing);
+
+//mmtp_timestamp (ntp32 short-format) against the arrival wall clock, ignored if either is unset
+void atsc3_packet_timing_add(atsc3_packet_timing_t* atsc3_packet_timing, uint32_t mmtp_timestamp, const struct timeval* arrival_timeval);
+
+//mpu_presentation_time (ntp64) from an MPT mpu_timestamp_descriptor mpu_tuple
+void atsc3_packet_timing_add_mpu_presentation_time(atsc3_packet_timing_t* atsc3_packet_timing, uint32_t mpu_sequence_number, uint64_t mpu_presentation_time);
+
+//arrival of an MPU mode packet, commits the margin of the previous MPU on mpu_sequence_number change
+void atsc3_packet_timing_add_mpu_packet(atsc3_packet_timing_t* atsc3_packet_timing, uint32_t mpu_sequence_number, const struct timeval* arrival_timeval);
+
+static inline uint64_t atsc3_packet_timing_jitter_us(atsc3_packet_timing_t* atsc3_packet_timing) {
+	return atsc3_packet_timing->jitter_us_q4 >> 4;
+}
+
+static inline int64_t atsc3_packet_timing_latency_mean_us(atsc3_packet_timing_t* atsc3_packet_timing) {
+	return atsc3_packet_timing->latency_count ? atsc3_packet_timing->latency_sum_us / atsc3_packet_timing->latency_count : 0;
+}
+
+static inline int64_t atsc3_packet_timing_margin_mean_us(atsc3_packet_timing_t* atsc3_packet_timing) {
+	return atsc3_packet_timing->margin_count ? atsc3_packet_timing->margin_sum_us / atsc3_packet_timing->margin_count : 0;
+}
+
+#if defined (__cplusplus)
+}
+#endif
+
+#endif /* ATSC3_PACKET_TIMING_H_ */
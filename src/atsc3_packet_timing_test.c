@@ -0,0 +1,162 @@
+/*
+ *
+ * atsc3_packet_timing_test.c:  driver for MMTP delivery latency, RFC 3550 jitter and MPU presentation margin
+ *
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+
+#include "atsc3_packet_timing.h"
+#include "atsc3_mmtp_ntp32_to_pts.h"
+
+//2026-10-18T00:00:00Z
+#define __PACKET_TIMING_TEST_UNIX_S 1792281600
+
+int test_packet_timing_ntp_conversion();
+int test_packet_timing_latency_and_jitter();
+int test_packet_timing_era_wrap();
+int test_packet_timing_mpu_presentation_margin();
+
+int main() {
+	int failed = 0;
+
+	failed += test_packet_timing_ntp_conversion();
+	failed += test_packet_timing_latency_and_jitter();
+	failed += test_packet_timing_era_wrap();
+	failed += test_packet_timing_mpu_presentation_margin();
+
+	printf("atsc3_packet_timing_test: %s\n", failed ? "FAILED" : "OK");
+	return failed;
+}
+
+//ntp32 short-format for a unix wall clock time
+uint32_t __ntp32_from_unix_us(uint64_t unix_us) {
+	uint64_t ntp_s = unix_us / 1000000 + NTP_UNIX_EPOCH_OFFSET_S;
+	uint64_t fraction = ((unix_us % 1000000) << 16) / 1000000;
+	return (uint32_t)((ntp_s & 0xFFFF) << 16 | fraction);
+}
+
+uint64_t __ntp64_from_unix_us(uint64_t unix_us) {
+	uint64_t ntp_s = unix_us / 1000000 + NTP_UNIX_EPOCH_OFFSET_S;
+	uint64_t fraction = ((unix_us % 1000000) << 32) / 1000000;
+	return ntp_s << 32 | fraction;
+}
+
+struct timeval __timeval_from_unix_us(uint64_t unix_us) {
+	struct timeval tv;
+	tv.tv_sec = unix_us / 1000000;
+	tv.tv_usec = unix_us % 1000000;
+	return tv;
+}
+
+int test_packet_timing_ntp_conversion() {
+	if(compute_ntp32_to_microseconds(0x00018000) != 1500000 || compute_ntp64_to_microseconds(0x0000000280000000ULL) != 2500000) {
+		printf("test_packet_timing_ntp_conversion: ntp32: %llu, ntp64: %llu\n", (unsigned long long)compute_ntp32_to_microseconds(0x00018000), (unsigned long long)compute_ntp64_to_microseconds(0x0000000280000000ULL));
+		return 1;
+	}
+
+	struct timeval tv = { 0, 250 };
+	if(compute_timeval_to_ntp64_microseconds(&tv) != NTP_UNIX_EPOCH_OFFSET_S * 1000000 + 250) {
+		printf("test_packet_timing_ntp_conversion: unix epoch\n");
+		return 1;
+	}
+	return 0;
+}
+
+int test_packet_timing_latency_and_jitter() {
+	atsc3_packet_timing_t packet_timing;
+	atsc3_packet_timing_init(&packet_timing);
+
+	//20ms transit, sent every 10ms
+	uint64_t sent_us = (uint64_t)__PACKET_TIMING_TEST_UNIX_S * 1000000;
+	for(int i = 0; i < 1000; i++) {
+		struct timeval arrival = __timeval_from_unix_us(sent_us + 20000);
+		atsc3_packet_timing_add(&packet_timing, __ntp32_from_unix_us(sent_us), &arrival);
+		sent_us += 10000;
+	}
+
+	//ntp32 fractions are 15.26us, allow for the truncation
+	if(packet_timing.latency_count != 1000 || packet_timing.latency_min_us < 19984 || packet_timing.latency_max_us > 20016 || atsc3_packet_timing_jitter_us(&packet_timing) > 20) {
+		printf("test_packet_timing_latency_and_jitter: constant transit, min: %lld, max: %lld, jitter: %llu\n",
+				(long long)packet_timing.latency_min_us, (long long)packet_timing.latency_max_us, (unsigned long long)atsc3_packet_timing_jitter_us(&packet_timing));
+		return 1;
+	}
+
+	//alternate 20ms / 24ms transit: |D| is 4ms on every packet, J converges to 4ms
+	for(int i = 0; i < 1000; i++) {
+		struct timeval arrival = __timeval_from_unix_us(sent_us + 20000 + (i % 2) * 4000);
+		atsc3_packet_timing_add(&packet_timing, __ntp32_from_unix_us(sent_us), &arrival);
+		sent_us += 10000;
+	}
+
+	uint64_t jitter_us = atsc3_packet_timing_jitter_us(&packet_timing);
+	if(jitter_us < 3950 || jitter_us > 4050 || packet_timing.latency_max_us < 23990) {
+		printf("test_packet_timing_latency_and_jitter: alternating transit, jitter: %llu\n", (unsigned long long)jitter_us);
+		return 1;
+	}
+
+	//no capture time, ignored
+	struct timeval no_arrival = { 0, 0 };
+	atsc3_packet_timing_add(&packet_timing, __ntp32_from_unix_us(sent_us), &no_arrival);
+	if(packet_timing.latency_count != 2000) {
+		printf("test_packet_timing_latency_and_jitter: packet without arrival time counted\n");
+		return 1;
+	}
+	return 0;
+}
+
+int test_packet_timing_era_wrap() {
+	atsc3_packet_timing_t packet_timing;
+	atsc3_packet_timing_init(&packet_timing);
+
+	//sent just before the ntp short-format seconds wrap, arrives just after
+	uint64_t era_start_unix_s = ((((uint64_t)__PACKET_TIMING_TEST_UNIX_S + NTP_UNIX_EPOCH_OFFSET_S) | 0xFFFF) + 1) - NTP_UNIX_EPOCH_OFFSET_S;
+	uint64_t sent_us = era_start_unix_s * 1000000 - 5000;
+	struct timeval arrival = __timeval_from_unix_us(sent_us + 15000);
+	atsc3_packet_timing_add(&packet_timing, __ntp32_from_unix_us(sent_us), &arrival);
+
+	if(packet_timing.latency_last_us < 14984 || packet_timing.latency_last_us > 15016) {
+		printf("test_packet_timing_era_wrap: latency: %lld\n", (long long)packet_timing.latency_last_us);
+		return 1;
+	}
+	return 0;
+}
+
+int test_packet_timing_mpu_presentation_margin() {
+	atsc3_packet_timing_t packet_timing;
+	atsc3_packet_timing_init(&packet_timing);
+
+	uint64_t now_us = (uint64_t)__PACKET_TIMING_TEST_UNIX_S * 1000000;
+
+	//MPU 100 presented 500ms after its last packet, MPU 101 completes 100ms late
+	atsc3_packet_timing_add_mpu_presentation_time(&packet_timing, 100, __ntp64_from_unix_us(now_us + 600000));
+	atsc3_packet_timing_add_mpu_presentation_time(&packet_timing, 101, __ntp64_from_unix_us(now_us + 1100000));
+
+	for(int i = 0; i <= 100; i++) {
+		struct timeval arrival = __timeval_from_unix_us(now_us + i * 1000);
+		atsc3_packet_timing_add_mpu_packet(&packet_timing, 100, &arrival);
+	}
+	if(packet_timing.margin_count) {
+		printf("test_packet_timing_mpu_presentation_margin: committed before the MPU changed\n");
+		return 1;
+	}
+
+	for(int i = 0; i <= 100; i++) {
+		struct timeval arrival = __timeval_from_unix_us(now_us + 1100000 + i * 1000);
+		atsc3_packet_timing_add_mpu_packet(&packet_timing, 101, &arrival);
+	}
+	if(packet_timing.margin_count != 1 || packet_timing.margin_last_us < 499990 || packet_timing.margin_last_us > 500010) {
+		printf("test_packet_timing_mpu_presentation_margin: MPU 100 margin: %lld\n", (long long)packet_timing.margin_last_us);
+		return 1;
+	}
+
+	//MPU 102 has no tuple yet, MPU 101 is committed late
+	struct timeval arrival = __timeval_from_unix_us(now_us + 1300000);
+	atsc3_packet_timing_add_mpu_packet(&packet_timing, 102, &arrival);
+	if(packet_timing.margin_count != 2 || packet_timing.margin_late_count != 1 || packet_timing.margin_min_us > -99990 || packet_timing.has_margin_current) {
+		printf("test_packet_timing_mpu_presentation_margin: MPU 101 margin: %lld, late: %u\n", (long long)packet_timing.margin_last_us, packet_timing.margin_late_count);
+		return 1;
+	}
+	return 0;
+}
@@ -0,0 +1,513 @@
+/*
+ * atsc3_pcap_replay.c
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: jjustman
+ *
+ * pcap:	https://wiki.wireshark.org/Development/LibpcapFileFormat
+ * pcapng:	https://www.ietf.org/id/draft-tuexen-opsawg-pcapng
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <inttypes.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "atsc3_pcap_replay.h"
+
+#define PCAP_MAGIC_USEC			0xA1B2C3D4
+#define PCAP_MAGIC_NSEC			0xA1B23C4D
+#define PCAP_GLOBAL_HEADER_LEN	24
+#define PCAP_RECORD_HEADER_LEN	16
+
+#define PCAPNG_BLOCK_TYPE_SHB	0x0A0D0D0A
+#define PCAPNG_BLOCK_TYPE_IDB	0x00000001
+#define PCAPNG_BLOCK_TYPE_SPB	0x00000003
+#define PCAPNG_BLOCK_TYPE_EPB	0x00000006
+#define PCAPNG_BYTE_ORDER_MAGIC	0x1A2B3C4D
+#define PCAPNG_OPTION_IF_TSRESOL 9
+
+#define LINKTYPE_NULL			0
+#define LINKTYPE_ETHERNET		1
+#define LINKTYPE_RAW_BSD		12
+#define LINKTYPE_RAW_OPENBSD	14
+#define LINKTYPE_RAW			101
+#define LINKTYPE_LOOP			108
+#define LINKTYPE_LINUX_SLL		113
+
+#define ETHERNET_HEADER_LEN		14
+
+//wake up this far ahead of the target and spin out the remainder, nanosleep granularity is too coarse for sub-ms pacing
+#define PCAP_REPLAY_PACING_SPIN_NS	200000ULL
+
+static const char* atsc3_pcap_replay_stage_names[ATSC3_PCAP_REPLAY_STAGE_MAX] = {
+	"udp",
+	"lls",
+	"alc",
+	"mmtp",
+	"mmt reconstitution"
+};
+
+const char* atsc3_pcap_replay_stage_name(atsc3_pcap_replay_stage_id_t stage_id) {
+	if(stage_id < ATSC3_PCAP_REPLAY_STAGE_MAX) {
+		return atsc3_pcap_replay_stage_names[stage_id];
+	}
+	return "unknown";
+}
+
+static uint16_t atsc3_pcap_replay_read_u16(atsc3_pcap_replay_context_t* atsc3_pcap_replay_context, size_t pos) {
+	uint8_t* p = &atsc3_pcap_replay_context->map[pos];
+	if(atsc3_pcap_replay_context->file_big_endian) {
+		return (p[0] << 8) | p[1];
+	}
+	return (p[1] << 8) | p[0];
+}
+
+static uint32_t atsc3_pcap_replay_read_u32(atsc3_pcap_replay_context_t* atsc3_pcap_replay_context, size_t pos) {
+	uint8_t* p = &atsc3_pcap_replay_context->map[pos];
+	if(atsc3_pcap_replay_context->file_big_endian) {
+		return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 8) | p[3];
+	}
+	return ((uint32_t)p[3] << 24) | ((uint32_t)p[2] << 16) | ((uint32_t)p[1] << 8) | p[0];
+}
+
+bool atsc3_pcap_replay_is_file(const char* dev) {
+	struct stat st;
+	return dev && !stat(dev, &st) && S_ISREG(st.st_mode);
+}
+
+static bool atsc3_pcap_replay_pcapng_parse_shb(atsc3_pcap_replay_context_t* atsc3_pcap_replay_context, size_t pos) {
+	uint8_t* p = &atsc3_pcap_replay_context->map[pos + 8];
+
+	if(p[0] == 0x1A && p[1] == 0x2B && p[2] == 0x3C && p[3] == 0x4D) {
+		atsc3_pcap_replay_context->file_big_endian = true;
+	} else if(p[0] == 0x4D && p[1] == 0x3C && p[2] == 0x2B && p[3] == 0x1A) {
+		atsc3_pcap_replay_context->file_big_endian = false;
+	} else {
+		__PCAP_REPLAY_ERROR("pcapng: invalid section header byte order magic: 0x%02x%02x%02x%02x", p[0], p[1], p[2], p[3]);
+		return false;
+	}
+
+	//interface ids are scoped to their section
+	atsc3_pcap_replay_context->pcapng_interfaces_n = 0;
+	return true;
+}
+
+static void atsc3_pcap_replay_pcapng_parse_idb(atsc3_pcap_replay_context_t* atsc3_pcap_replay_context, size_t pos, uint32_t block_len) {
+	if(atsc3_pcap_replay_context->pcapng_interfaces_n >= ATSC3_PCAP_REPLAY_PCAPNG_INTERFACES_MAX) {
+		__PCAP_REPLAY_WARN("pcapng: more than %u interfaces, ignoring interface description", ATSC3_PCAP_REPLAY_PCAPNG_INTERFACES_MAX);
+		return;
+	}
+
+	atsc3_pcap_replay_pcapng_interface_t* interface = &atsc3_pcap_replay_context->pcapng_interfaces[atsc3_pcap_replay_context->pcapng_interfaces_n++];
+	interface->link_type = atsc3_pcap_replay_read_u16(atsc3_pcap_replay_context, pos + 8);
+	interface->ts_resolution_pow2 = false;
+	interface->ts_resolution_exponent = 6;
+
+	size_t option_pos = pos + 16;
+	size_t option_end = pos + block_len - 4;
+
+	while(option_pos + 4 <= option_end) {
+		uint16_t option_code = atsc3_pcap_replay_read_u16(atsc3_pcap_replay_context, option_pos);
+		uint16_t option_len = atsc3_pcap_replay_read_u16(atsc3_pcap_replay_context, option_pos + 2);
+
+		if(option_code == 0 || option_pos + 4 + option_len > option_end) {
+			break;
+		}
+		if(option_code == PCAPNG_OPTION_IF_TSRESOL && option_len >= 1) {
+			uint8_t if_tsresol = atsc3_pcap_replay_context->map[option_pos + 4];
+			interface->ts_resolution_pow2 = (if_tsresol & 0x80) != 0;
+			interface->ts_resolution_exponent = if_tsresol & 0x7F;
+		}
+		option_pos += 4 + ((option_len + 3) & ~3);
+	}
+}
+
+static uint64_t atsc3_pcap_replay_pcapng_ts_to_ns(atsc3_pcap_replay_pcapng_interface_t* interface, uint64_t ts) {
+	if(interface->ts_resolution_pow2) {
+		uint8_t exponent = interface->ts_resolution_exponent > 63 ? 63 : interface->ts_resolution_exponent;
+		uint64_t mask = (1ULL << exponent) - 1;
+		return (ts >> exponent) * 1000000000ULL + (((ts & mask) * 1000000000ULL) >> exponent);
+	}
+
+	uint64_t ns = ts;
+	for(int i = interface->ts_resolution_exponent; i < 9; i++) {
+		ns *= 10;
+	}
+	for(int i = 9; i < interface->ts_resolution_exponent; i++) {
+		ns /= 10;
+	}
+	return ns;
+}
+
+atsc3_pcap_replay_context_t* atsc3_pcap_replay_open_from_file(const char* filename, atsc3_pcap_replay_mode_t mode) {
+	struct stat st;
+
+	int fd = open(filename, O_RDONLY);
+	if(fd < 0) {
+		__PCAP_REPLAY_ERROR("unable to open capture: %s, errno: %d", filename, errno);
+		return NULL;
+	}
+
+	if(fstat(fd, &st) || st.st_size < PCAP_GLOBAL_HEADER_LEN) {
+		__PCAP_REPLAY_ERROR("capture: %s is too short to be a pcap/pcapng file", filename);
+		close(fd);
+		return NULL;
+	}
+
+	uint8_t* map = (uint8_t*)mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	if(map == MAP_FAILED) {
+		__PCAP_REPLAY_ERROR("unable to mmap capture: %s, errno: %d", filename, errno);
+		close(fd);
+		return NULL;
+	}
+	madvise(map, st.st_size, MADV_SEQUENTIAL);
+
+	atsc3_pcap_replay_context_t* atsc3_pcap_replay_context = (atsc3_pcap_replay_context_t*)calloc(1, sizeof(atsc3_pcap_replay_context_t));
+	assert(atsc3_pcap_replay_context);
+
+	atsc3_pcap_replay_context->filename = strdup(filename);
+	atsc3_pcap_replay_context->mode = mode;
+	atsc3_pcap_replay_context->fd = fd;
+	atsc3_pcap_replay_context->map = map;
+	atsc3_pcap_replay_context->map_len = st.st_size;
+
+	//classic pcap magic is written in the capturing host byte order
+	uint32_t magic_be = ((uint32_t)map[0] << 24) | ((uint32_t)map[1] << 16) | ((uint32_t)map[2] << 8) | map[3];
+	uint32_t magic_le = ((uint32_t)map[3] << 24) | ((uint32_t)map[2] << 16) | ((uint32_t)map[1] << 8) | map[0];
+
+	if(magic_be == PCAPNG_BLOCK_TYPE_SHB) {
+		atsc3_pcap_replay_context->file_format = ATSC3_PCAP_REPLAY_FILE_FORMAT_PCAPNG;
+		if(!atsc3_pcap_replay_pcapng_parse_shb(atsc3_pcap_replay_context, 0)) {
+			atsc3_pcap_replay_free(&atsc3_pcap_replay_context);
+			return NULL;
+		}
+		atsc3_pcap_replay_context->map_pos = 0;
+	} else if(magic_le == PCAP_MAGIC_USEC || magic_be == PCAP_MAGIC_USEC || magic_le == PCAP_MAGIC_NSEC || magic_be == PCAP_MAGIC_NSEC) {
+		atsc3_pcap_replay_context->file_big_endian = (magic_be == PCAP_MAGIC_USEC || magic_be == PCAP_MAGIC_NSEC);
+		atsc3_pcap_replay_context->file_format = (magic_le == PCAP_MAGIC_NSEC || magic_be == PCAP_MAGIC_NSEC) ? ATSC3_PCAP_REPLAY_FILE_FORMAT_PCAP_NSEC : ATSC3_PCAP_REPLAY_FILE_FORMAT_PCAP;
+		atsc3_pcap_replay_context->link_type = atsc3_pcap_replay_read_u32(atsc3_pcap_replay_context, 20) & 0x0FFFFFFF;
+		atsc3_pcap_replay_context->map_pos = PCAP_GLOBAL_HEADER_LEN;
+	} else {
+		__PCAP_REPLAY_ERROR("capture: %s has unknown magic: 0x%08x", filename, magic_be);
+		atsc3_pcap_replay_free(&atsc3_pcap_replay_context);
+		return NULL;
+	}
+
+	__PCAP_REPLAY_INFO("opened capture: %s, format: %s, size: %zu bytes, mode: %s", filename,
+			atsc3_pcap_replay_context->file_format == ATSC3_PCAP_REPLAY_FILE_FORMAT_PCAPNG ? "pcapng" : "pcap",
+			atsc3_pcap_replay_context->map_len,
+			mode == ATSC3_PCAP_REPLAY_MODE_PACED ? "paced" : "max speed");
+
+	return atsc3_pcap_replay_context;
+}
+
+/**
+ * returns 1 with a record, 0 at end of file, -1 for a malformed capture
+ */
+static int atsc3_pcap_replay_next_record(atsc3_pcap_replay_context_t* atsc3_pcap_replay_context, uint64_t* capture_ns, uint32_t* link_type, uint8_t** data, uint32_t* caplen, uint32_t* len) {
+	size_t pos = atsc3_pcap_replay_context->map_pos;
+	size_t map_len = atsc3_pcap_replay_context->map_len;
+
+	if(atsc3_pcap_replay_context->file_format != ATSC3_PCAP_REPLAY_FILE_FORMAT_PCAPNG) {
+		if(pos + PCAP_RECORD_HEADER_LEN > map_len) {
+			return 0;
+		}
+		uint32_t ts_sec = atsc3_pcap_replay_read_u32(atsc3_pcap_replay_context, pos);
+		uint32_t ts_frac = atsc3_pcap_replay_read_u32(atsc3_pcap_replay_context, pos + 4);
+		*caplen = atsc3_pcap_replay_read_u32(atsc3_pcap_replay_context, pos + 8);
+		*len = atsc3_pcap_replay_read_u32(atsc3_pcap_replay_context, pos + 12);
+
+		if(*caplen > map_len - pos - PCAP_RECORD_HEADER_LEN) {
+			__PCAP_REPLAY_WARN("capture truncated at offset: %zu, record caplen: %u", pos, *caplen);
+			return 0;
+		}
+
+		*capture_ns = (uint64_t)ts_sec * 1000000000ULL + (atsc3_pcap_replay_context->file_format == ATSC3_PCAP_REPLAY_FILE_FORMAT_PCAP_NSEC ? ts_frac : (uint64_t)ts_frac * 1000);
+		*link_type = atsc3_pcap_replay_context->link_type;
+		*data = &atsc3_pcap_replay_context->map[pos + PCAP_RECORD_HEADER_LEN];
+		atsc3_pcap_replay_context->map_pos = pos + PCAP_RECORD_HEADER_LEN + *caplen;
+
+		return 1;
+	}
+
+	while(pos + 12 <= map_len) {
+		uint32_t block_type = atsc3_pcap_replay_read_u32(atsc3_pcap_replay_context, pos);
+
+		if(block_type == PCAPNG_BLOCK_TYPE_SHB && !atsc3_pcap_replay_pcapng_parse_shb(atsc3_pcap_replay_context, pos)) {
+			return -1;
+		}
+
+		uint32_t block_len = atsc3_pcap_replay_read_u32(atsc3_pcap_replay_context, pos + 4);
+		if(block_len < 12 || (block_len & 3) || block_len > map_len - pos) {
+			__PCAP_REPLAY_ERROR("pcapng: invalid block length: %u at offset: %zu", block_len, pos);
+			return -1;
+		}
+
+		atsc3_pcap_replay_context->map_pos = pos + block_len;
+
+		if(block_type == PCAPNG_BLOCK_TYPE_IDB && block_len >= 20) {
+			atsc3_pcap_replay_pcapng_parse_idb(atsc3_pcap_replay_context, pos, block_len);
+
+		} else if(block_type == PCAPNG_BLOCK_TYPE_EPB && block_len >= 32) {
+			uint32_t interface_id = atsc3_pcap_replay_read_u32(atsc3_pcap_replay_context, pos + 8);
+			if(interface_id >= atsc3_pcap_replay_context->pcapng_interfaces_n) {
+				__PCAP_REPLAY_WARN("pcapng: enhanced packet block references unknown interface: %u", interface_id);
+				pos += block_len;
+				continue;
+			}
+			atsc3_pcap_replay_pcapng_interface_t* interface = &atsc3_pcap_replay_context->pcapng_interfaces[interface_id];
+
+			uint64_t ts = ((uint64_t)atsc3_pcap_replay_read_u32(atsc3_pcap_replay_context, pos + 12) << 32) | atsc3_pcap_replay_read_u32(atsc3_pcap_replay_context, pos + 16);
+			*caplen = atsc3_pcap_replay_read_u32(atsc3_pcap_replay_context, pos + 20);
+			*len = atsc3_pcap_replay_read_u32(atsc3_pcap_replay_context, pos + 24);
+
+			//block_len >= 32 here, compare against the room left rather than summing caplen which can wrap
+			if(*caplen > block_len - 32) {
+				__PCAP_REPLAY_ERROR("pcapng: enhanced packet block caplen: %u exceeds block length: %u", *caplen, block_len);
+				return -1;
+			}
+
+			*capture_ns = atsc3_pcap_replay_pcapng_ts_to_ns(interface, ts);
+			*link_type = interface->link_type;
+			*data = &atsc3_pcap_replay_context->map[pos + 28];
+			return 1;
+
+		} else if(block_type == PCAPNG_BLOCK_TYPE_SPB && block_len >= 16 && atsc3_pcap_replay_context->pcapng_interfaces_n) {
+			//simple packet blocks carry no timestamp, deliver them at the previous packet time
+			*len = atsc3_pcap_replay_read_u32(atsc3_pcap_replay_context, pos + 8);
+			*caplen = __MIN(*len, block_len - 16);
+			*capture_ns = atsc3_pcap_replay_context->last_capture_ns;
+			*link_type = atsc3_pcap_replay_context->pcapng_interfaces[0].link_type;
+			*data = &atsc3_pcap_replay_context->map[pos + 12];
+			return 1;
+		}
+
+		pos += block_len;
+	}
+
+	return 0;
+}
+
+/**
+ * process_packet_from_pcap expects an ethernet frame carrying ipv4, re-frame anything else into frame_buffer
+ */
+static uint8_t* atsc3_pcap_replay_frame_as_ethernet(atsc3_pcap_replay_context_t* atsc3_pcap_replay_context, uint32_t link_type, uint8_t* data, uint32_t* caplen) {
+	uint32_t l3_offset = 0;
+
+	switch(link_type) {
+		case LINKTYPE_ETHERNET:
+			return data;
+
+		case LINKTYPE_RAW:
+		case LINKTYPE_RAW_BSD:
+		case LINKTYPE_RAW_OPENBSD:
+			l3_offset = 0;
+			break;
+
+		case LINKTYPE_NULL:
+		case LINKTYPE_LOOP:
+			l3_offset = 4;
+			break;
+
+		case LINKTYPE_LINUX_SLL:
+			l3_offset = 16;
+			break;
+
+		default:
+			return NULL;
+	}
+
+	if(*caplen <= l3_offset || (data[l3_offset] >> 4) != 4 || *caplen - l3_offset + ETHERNET_HEADER_LEN > sizeof(atsc3_pcap_replay_context->frame_buffer)) {
+		return NULL;
+	}
+
+	memset(atsc3_pcap_replay_context->frame_buffer, 0, ETHERNET_HEADER_LEN);
+	atsc3_pcap_replay_context->frame_buffer[12] = 0x08;
+	atsc3_pcap_replay_context->frame_buffer[13] = 0x00;
+	memcpy(&atsc3_pcap_replay_context->frame_buffer[ETHERNET_HEADER_LEN], &data[l3_offset], *caplen - l3_offset);
+	*caplen = *caplen - l3_offset + ETHERNET_HEADER_LEN;
+
+	return atsc3_pcap_replay_context->frame_buffer;
+}
+
+static uint64_t atsc3_pcap_replay_wait_until(uint64_t target_ns) {
+	uint64_t wait_start_ns = atsc3_pcap_replay_monotonic_ns();
+	uint64_t now_ns = wait_start_ns;
+
+	while(now_ns < target_ns) {
+		uint64_t remaining_ns = target_ns - now_ns;
+		if(remaining_ns > PCAP_REPLAY_PACING_SPIN_NS) {
+			struct timespec sleep_ts;
+			uint64_t sleep_ns = remaining_ns - PCAP_REPLAY_PACING_SPIN_NS / 2;
+			sleep_ts.tv_sec = sleep_ns / 1000000000ULL;
+			sleep_ts.tv_nsec = sleep_ns % 1000000000ULL;
+			nanosleep(&sleep_ts, NULL);
+		}
+		now_ns = atsc3_pcap_replay_monotonic_ns();
+	}
+
+	return now_ns - wait_start_ns;
+}
+
+int atsc3_pcap_replay_loop(atsc3_pcap_replay_context_t* atsc3_pcap_replay_context, pcap_handler callback, int max_packets) {
+	int packets_delivered = 0;
+	int ret = 0;
+
+	uint64_t	capture_ns = 0;
+	uint32_t	link_type = 0;
+	uint8_t*	data = NULL;
+	uint32_t	caplen = 0;
+	uint32_t	len = 0;
+	struct pcap_pkthdr pkthdr;
+
+	atsc3_pcap_replay_context->breakloop = 0;
+	if(!atsc3_pcap_replay_context->wall_start_ns) {
+		atsc3_pcap_replay_context->wall_start_ns = atsc3_pcap_replay_monotonic_ns();
+	}
+
+	while(!atsc3_pcap_replay_context->breakloop && (max_packets <= 0 || packets_delivered < max_packets)) {
+		uint64_t ingest_start_ns = atsc3_pcap_replay_monotonic_ns();
+
+		ret = atsc3_pcap_replay_next_record(atsc3_pcap_replay_context, &capture_ns, &link_type, &data, &caplen, &len);
+		if(ret <= 0) {
+			break;
+		}
+
+		if(!atsc3_pcap_replay_context->packets_processed) {
+			atsc3_pcap_replay_context->first_capture_ns = capture_ns;
+		}
+		atsc3_pcap_replay_context->last_capture_ns = capture_ns;
+
+		//process_packet_from_pcap trusts pkthdr->len, so snaplen truncated records can't be delivered
+		if(caplen < len) {
+			atsc3_pcap_replay_context->packets_skipped_truncated++;
+			continue;
+		}
+
+		uint8_t* frame = atsc3_pcap_replay_frame_as_ethernet(atsc3_pcap_replay_context, link_type, data, &caplen);
+		if(!frame) {
+			atsc3_pcap_replay_context->packets_skipped_link_type++;
+			continue;
+		}
+
+		pkthdr.ts.tv_sec = capture_ns / 1000000000ULL;
+		pkthdr.ts.tv_usec = (capture_ns % 1000000000ULL) / 1000;
+		pkthdr.caplen = caplen;
+		pkthdr.len = caplen;
+
+		uint64_t ingest_end_ns = atsc3_pcap_replay_monotonic_ns();
+		atsc3_pcap_replay_context->ingest_ns += ingest_end_ns - ingest_start_ns;
+
+		if(atsc3_pcap_replay_context->mode == ATSC3_PCAP_REPLAY_MODE_PACED) {
+			if(!atsc3_pcap_replay_context->pacing_has_origin) {
+				atsc3_pcap_replay_context->pacing_has_origin = true;
+				atsc3_pcap_replay_context->pacing_origin_capture_ns = capture_ns;
+				atsc3_pcap_replay_context->pacing_origin_wall_ns = ingest_end_ns;
+			}
+
+			//captures may step backwards (e.g. merged files), deliver those immediately
+			uint64_t target_ns = atsc3_pcap_replay_context->pacing_origin_wall_ns;
+			if(capture_ns > atsc3_pcap_replay_context->pacing_origin_capture_ns) {
+				target_ns += capture_ns - atsc3_pcap_replay_context->pacing_origin_capture_ns;
+			}
+
+			atsc3_pcap_replay_context->pacing_wait_ns += atsc3_pcap_replay_wait_until(target_ns);
+
+			uint64_t late_ns = atsc3_pcap_replay_monotonic_ns() - target_ns;
+			atsc3_pcap_replay_context->pacing_late_total_ns += late_ns;
+			if(late_ns > atsc3_pcap_replay_context->pacing_late_max_ns) {
+				atsc3_pcap_replay_context->pacing_late_max_ns = late_ns;
+			}
+		}
+
+		uint64_t process_start_ns = atsc3_pcap_replay_monotonic_ns();
+		callback((u_char*)atsc3_pcap_replay_context, &pkthdr, frame);
+		atsc3_pcap_replay_context->process_packet_ns += atsc3_pcap_replay_monotonic_ns() - process_start_ns;
+
+		atsc3_pcap_replay_context->packets_processed++;
+		atsc3_pcap_replay_context->bytes_processed += pkthdr.len;
+		packets_delivered++;
+	}
+
+	atsc3_pcap_replay_context->wall_end_ns = atsc3_pcap_replay_monotonic_ns();
+
+	return ret < 0 ? -1 : packets_delivered;
+}
+
+void atsc3_pcap_replay_breakloop(atsc3_pcap_replay_context_t* atsc3_pcap_replay_context) {
+	atsc3_pcap_replay_context->breakloop = 1;
+}
+
+void atsc3_pcap_replay_dump_statistics(atsc3_pcap_replay_context_t* atsc3_pcap_replay_context) {
+	double wall_s = (atsc3_pcap_replay_context->wall_end_ns - atsc3_pcap_replay_context->wall_start_ns) / 1000000000.0;
+	double capture_s = (atsc3_pcap_replay_context->last_capture_ns - atsc3_pcap_replay_context->first_capture_ns) / 1000000000.0;
+	uint64_t packets = atsc3_pcap_replay_context->packets_processed;
+
+	if(wall_s <= 0) {
+		wall_s = 1e-9;
+	}
+
+	__PCAP_REPLAY_STATS("---pcap replay: %s (%s)---", atsc3_pcap_replay_context->filename, atsc3_pcap_replay_context->mode == ATSC3_PCAP_REPLAY_MODE_PACED ? "paced" : "max speed");
+	__PCAP_REPLAY_STATS(" packets delivered       : %"PRIu64", skipped link type: %"PRIu64", skipped truncated: %"PRIu64,
+			packets, atsc3_pcap_replay_context->packets_skipped_link_type, atsc3_pcap_replay_context->packets_skipped_truncated);
+	__PCAP_REPLAY_STATS(" bytes delivered         : %"PRIu64, atsc3_pcap_replay_context->bytes_processed);
+	__PCAP_REPLAY_STATS(" elapsed                 : %.3f s wall, %.3f s capture", wall_s, capture_s);
+	__PCAP_REPLAY_STATS(" throughput              : %.0f packets/s, %.0f bytes/s (%.2f Mbit/s)",
+			packets / wall_s, atsc3_pcap_replay_context->bytes_processed / wall_s, atsc3_pcap_replay_context->bytes_processed * 8 / wall_s / 1000000.0);
+
+	if(!packets) {
+		return;
+	}
+
+	__PCAP_REPLAY_STATS(" ingest                  : %10.3f ms, %8"PRIu64" ns/packet", atsc3_pcap_replay_context->ingest_ns / 1000000.0, atsc3_pcap_replay_context->ingest_ns / packets);
+	__PCAP_REPLAY_STATS(" process_packet          : %10.3f ms, %8"PRIu64" ns/packet", atsc3_pcap_replay_context->process_packet_ns / 1000000.0, atsc3_pcap_replay_context->process_packet_ns / packets);
+
+	for(int i=0; i < ATSC3_PCAP_REPLAY_STAGE_MAX; i++) {
+		atsc3_pcap_replay_stage_t* stage = &atsc3_pcap_replay_context->stages[i];
+		if(!stage->count) {
+			continue;
+		}
+		__PCAP_REPLAY_STATS("  stage %-18s: %10.3f ms, %8"PRIu64" calls, %8"PRIu64" ns avg, %8"PRIu64" ns max, %5.1f%% of process_packet",
+				atsc3_pcap_replay_stage_name((atsc3_pcap_replay_stage_id_t)i),
+				stage->total_ns / 1000000.0, stage->count, stage->total_ns / stage->count, stage->max_ns,
+				atsc3_pcap_replay_context->process_packet_ns ? 100.0 * stage->total_ns / atsc3_pcap_replay_context->process_packet_ns : 0);
+	}
+
+	if(atsc3_pcap_replay_context->mode == ATSC3_PCAP_REPLAY_MODE_PACED) {
+		__PCAP_REPLAY_STATS(" pacing wait             : %10.3f ms, late avg: %"PRIu64" ns, late max: %"PRIu64" ns",
+				atsc3_pcap_replay_context->pacing_wait_ns / 1000000.0, atsc3_pcap_replay_context->pacing_late_total_ns / packets, atsc3_pcap_replay_context->pacing_late_max_ns);
+	}
+}
+
+void atsc3_pcap_replay_free(atsc3_pcap_replay_context_t** atsc3_pcap_replay_context_p) {
+	atsc3_pcap_replay_context_t* atsc3_pcap_replay_context = *atsc3_pcap_replay_context_p;
+	if(atsc3_pcap_replay_context) {
+		if(atsc3_pcap_replay_context->map) {
+			munmap(atsc3_pcap_replay_context->map, atsc3_pcap_replay_context->map_len);
+		}
+		if(atsc3_pcap_replay_context->fd >= 0) {
+			close(atsc3_pcap_replay_context->fd);
+		}
+		freesafe(atsc3_pcap_replay_context->filename);
+		free(atsc3_pcap_replay_context);
+	}
+	*atsc3_pcap_replay_context_p = NULL;
+}
+
+int atsc3_pcap_replay_run_from_file(const char* filename, atsc3_pcap_replay_mode_t mode, pcap_handler callback) {
+	atsc3_pcap_replay_context_t* atsc3_pcap_replay_context = atsc3_pcap_replay_open_from_file(filename, mode);
+	if(!atsc3_pcap_replay_context) {
+		return -1;
+	}
+
+	int packets_delivered = atsc3_pcap_replay_loop(atsc3_pcap_replay_context, callback, 0);
+	atsc3_pcap_replay_dump_statistics(atsc3_pcap_replay_context);
+	atsc3_pcap_replay_free(&atsc3_pcap_replay_context);
+
+	return packets_delivered;
+}
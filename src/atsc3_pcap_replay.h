@@ -0,0 +1,173 @@
+/*
+ * atsc3_pcap_replay.h
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: jjustman
+ *
+ * offline ingest of pcap/pcapng captures for repeatable receive chain measurements
+ *
+ * the capture file is mmap'd and each record is handed to a pcap_handler (e.g. process_packet) with a
+ * synthesized pcap_pkthdr, so listener tools can use the same callback for live and offline ingest:
+ *
+ * 	ATSC3_PCAP_REPLAY_MODE_PACED:		deliver each packet at its original capture time offset, for latency/jitter studies
+ * 	ATSC3_PCAP_REPLAY_MODE_MAX_SPEED:	deliver packets back to back, for throughput regression benchmarks
+ *
+ * the replay context is passed as the pcap_handler user param, process_packet may wrap its
+ * parsing stages with atsc3_pcap_replay_stage_start/stop((atsc3_pcap_replay_context_t*)user, stage)
+ * to attribute time per stage, these are no-ops when user is NULL (e.g. pcap_loop from a live interface)
+ *
+ * supported link types: ethernet, raw ipv4, bsd loopback (null/loop) and linux cooked (sll), non-ethernet
+ * frames are re-framed with a synthetic ethernet header for process_packet_from_pcap
+ */
+
+#include <pcap.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <signal.h>
+#include <time.h>
+
+#include "atsc3_utils.h"
+#include "atsc3_listener_udp.h"
+
+#ifndef ATSC3_PCAP_REPLAY_H_
+#define ATSC3_PCAP_REPLAY_H_
+
+#if defined (__cplusplus)
+extern "C" {
+#endif
+
+typedef enum {
+	ATSC3_PCAP_REPLAY_MODE_PACED = 0,
+	ATSC3_PCAP_REPLAY_MODE_MAX_SPEED
+} atsc3_pcap_replay_mode_t;
+
+typedef enum {
+	ATSC3_PCAP_REPLAY_FILE_FORMAT_PCAP = 0,
+	ATSC3_PCAP_REPLAY_FILE_FORMAT_PCAP_NSEC,
+	ATSC3_PCAP_REPLAY_FILE_FORMAT_PCAPNG
+} atsc3_pcap_replay_file_format_t;
+
+//receive chain stages, attributed from process_packet
+typedef enum {
+	ATSC3_PCAP_REPLAY_STAGE_UDP = 0,
+	ATSC3_PCAP_REPLAY_STAGE_LLS,
+	ATSC3_PCAP_REPLAY_STAGE_ALC,
+	ATSC3_PCAP_REPLAY_STAGE_MMTP,
+	ATSC3_PCAP_REPLAY_STAGE_MMT_RECONSTITUTION,
+	ATSC3_PCAP_REPLAY_STAGE_MAX
+} atsc3_pcap_replay_stage_id_t;
+
+typedef struct atsc3_pcap_replay_stage {
+	uint64_t	started_ns;
+	uint64_t	total_ns;
+	uint64_t	max_ns;
+	uint64_t	count;
+} atsc3_pcap_replay_stage_t;
+
+#define ATSC3_PCAP_REPLAY_PCAPNG_INTERFACES_MAX 16
+
+typedef struct atsc3_pcap_replay_pcapng_interface {
+	uint16_t	link_type;
+	bool		ts_resolution_pow2;
+	uint8_t		ts_resolution_exponent;	//10^-n or 2^-n seconds per tick, default 10^-6
+} atsc3_pcap_replay_pcapng_interface_t;
+
+typedef struct atsc3_pcap_replay_context {
+	char*								filename;
+	atsc3_pcap_replay_mode_t			mode;
+	atsc3_pcap_replay_file_format_t		file_format;
+
+	//mmap'd capture
+	int									fd;
+	uint8_t*							map;
+	size_t								map_len;
+	size_t								map_pos;
+	bool								file_big_endian;
+
+	uint32_t							link_type;
+	atsc3_pcap_replay_pcapng_interface_t	pcapng_interfaces[ATSC3_PCAP_REPLAY_PCAPNG_INTERFACES_MAX];
+	uint32_t							pcapng_interfaces_n;
+
+	//re-framing buffer for non-ethernet link types
+	uint8_t								frame_buffer[MAX_PCAP_LEN + 64];
+
+	volatile sig_atomic_t				breakloop;
+
+	//pacing
+	bool								pacing_has_origin;
+	uint64_t							pacing_origin_capture_ns;
+	uint64_t							pacing_origin_wall_ns;
+	uint64_t							last_capture_ns;
+
+	//statistics
+	uint64_t							packets_processed;
+	uint64_t							bytes_processed;
+	uint64_t							packets_skipped_link_type;
+	uint64_t							packets_skipped_truncated;
+	uint64_t							first_capture_ns;
+
+	uint64_t							wall_start_ns;
+	uint64_t							wall_end_ns;
+	uint64_t							ingest_ns;
+	uint64_t							pacing_wait_ns;
+	uint64_t							pacing_late_total_ns;
+	uint64_t							pacing_late_max_ns;
+	uint64_t							process_packet_ns;
+
+	atsc3_pcap_replay_stage_t			stages[ATSC3_PCAP_REPLAY_STAGE_MAX];
+
+} atsc3_pcap_replay_context_t;
+
+static inline uint64_t atsc3_pcap_replay_monotonic_ns() {
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+static inline void atsc3_pcap_replay_stage_start(atsc3_pcap_replay_context_t* atsc3_pcap_replay_context, atsc3_pcap_replay_stage_id_t stage_id) {
+	if(atsc3_pcap_replay_context) {
+		atsc3_pcap_replay_context->stages[stage_id].started_ns = atsc3_pcap_replay_monotonic_ns();
+	}
+}
+
+static inline void atsc3_pcap_replay_stage_stop(atsc3_pcap_replay_context_t* atsc3_pcap_replay_context, atsc3_pcap_replay_stage_id_t stage_id) {
+	if(atsc3_pcap_replay_context && atsc3_pcap_replay_context->stages[stage_id].started_ns) {
+		atsc3_pcap_replay_stage_t* stage = &atsc3_pcap_replay_context->stages[stage_id];
+		uint64_t elapsed_ns = atsc3_pcap_replay_monotonic_ns() - stage->started_ns;
+
+		stage->total_ns += elapsed_ns;
+		if(elapsed_ns > stage->max_ns) {
+			stage->max_ns = elapsed_ns;
+		}
+		stage->count++;
+		stage->started_ns = 0;
+	}
+}
+
+bool atsc3_pcap_replay_is_file(const char* dev);
+
+atsc3_pcap_replay_context_t* atsc3_pcap_replay_open_from_file(const char* filename, atsc3_pcap_replay_mode_t mode);
+
+//returns the number of packets delivered to callback, or -1 on a malformed capture; max_packets <= 0 replays the whole file
+int atsc3_pcap_replay_loop(atsc3_pcap_replay_context_t* atsc3_pcap_replay_context, pcap_handler callback, int max_packets);
+void atsc3_pcap_replay_breakloop(atsc3_pcap_replay_context_t* atsc3_pcap_replay_context);
+
+void atsc3_pcap_replay_dump_statistics(atsc3_pcap_replay_context_t* atsc3_pcap_replay_context);
+void atsc3_pcap_replay_free(atsc3_pcap_replay_context_t** atsc3_pcap_replay_context_p);
+
+//open, replay, dump statistics and release in one shot for listener tools
+int atsc3_pcap_replay_run_from_file(const char* filename, atsc3_pcap_replay_mode_t mode, pcap_handler callback);
+
+const char* atsc3_pcap_replay_stage_name(atsc3_pcap_replay_stage_id_t stage_id);
+
+#if defined (__cplusplus)
+}
+#endif
+
+#define __PCAP_REPLAY_ERROR(...)   printf("%s:%d:ERROR :",__FILE__,__LINE__);printf(__VA_ARGS__);printf("%s%s","\r","\n")
+#define __PCAP_REPLAY_WARN(...)    printf("%s:%d:WARN: ",__FILE__,__LINE__);printf(__VA_ARGS__);printf("%s%s","\r","\n")
+#define __PCAP_REPLAY_INFO(...)    printf("%s:%d: ",__FILE__,__LINE__);printf(__VA_ARGS__);printf("%s%s","\r","\n")
+#define __PCAP_REPLAY_STATS(...)   printf(__VA_ARGS__);printf("%s%s","\r","\n")
+
+#endif /* ATSC3_PCAP_REPLAY_H_ */
@@ -0,0 +1,150 @@
+/*
+ * atsc3_qsbr.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: jjustman
+ */
+
+#include "atsc3_qsbr.h"
+
+typedef struct atsc3_qsbr_retired {
+	void*				ptr;
+	atsc3_qsbr_free_f	free_f;
+	uint64_t			epoch;
+} atsc3_qsbr_retired_t;
+
+//0 for a free reader slot, the global epoch starts at 1 so a registered reader is never 0
+static uint64_t atsc3_qsbr_epoch = 1;
+static uint64_t atsc3_qsbr_reader_epoch[ATSC3_QSBR_MAX_READERS];
+static __thread int atsc3_qsbr_reader_slot = -1;
+
+//serializes registration, retire and reclaim, readers only take it when their epoch has moved
+static pthread_mutex_t atsc3_qsbr_mutex = PTHREAD_MUTEX_INITIALIZER;
+static atsc3_qsbr_retired_t* atsc3_qsbr_retired = NULL;
+static uint32_t atsc3_qsbr_retired_n = 0;
+static uint32_t atsc3_qsbr_retired_allocated = 0;
+
+static void __atsc3_qsbr_register_locked() {
+	for(int i = 0; i < ATSC3_QSBR_MAX_READERS; i++) {
+		if(!atsc3_qsbr_reader_epoch[i]) {
+			atsc3_qsbr_reader_slot = i;
+			__atomic_store_n(&atsc3_qsbr_reader_epoch[i], __atomic_load_n(&atsc3_qsbr_epoch, __ATOMIC_ACQUIRE), __ATOMIC_RELEASE);
+			return;
+		}
+	}
+	__QSBR_ERROR("atsc3_qsbr: more than %d reader threads", ATSC3_QSBR_MAX_READERS);
+	abort();
+}
+
+uint32_t atsc3_qsbr_reclaim() {
+	atsc3_qsbr_retired_t* to_free = NULL;
+	uint32_t to_free_n = 0;
+	uint32_t pending_n;
+
+	pthread_mutex_lock(&atsc3_qsbr_mutex);
+
+	uint64_t min_epoch = UINT64_MAX;
+	for(int i = 0; i < ATSC3_QSBR_MAX_READERS; i++) {
+		uint64_t reader_epoch = __atomic_load_n(&atsc3_qsbr_reader_epoch[i], __ATOMIC_ACQUIRE);
+		if(reader_epoch && reader_epoch < min_epoch) {
+			min_epoch = reader_epoch;
+		}
+	}
+
+	uint32_t kept_n = 0;
+	for(uint32_t i = 0; i < atsc3_qsbr_retired_n; i++) {
+		if(atsc3_qsbr_retired[i].epoch <= min_epoch) {
+			if(!to_free) {
+				to_free = (atsc3_qsbr_retired_t*)malloc(atsc3_qsbr_retired_n * sizeof(atsc3_qsbr_retired_t));
+				if(!to_free) {
+					abort();
+				}
+			}
+			to_free[to_free_n++] = atsc3_qsbr_retired[i];
+		} else {
+			atsc3_qsbr_retired[kept_n++] = atsc3_qsbr_retired[i];
+		}
+	}
+	__atomic_store_n(&atsc3_qsbr_retired_n, kept_n, __ATOMIC_RELAXED);
+	pending_n = kept_n;
+
+	pthread_mutex_unlock(&atsc3_qsbr_mutex);
+
+	//outside the lock, a free function may retire something of its own
+	for(uint32_t i = 0; i < to_free_n; i++) {
+		to_free[i].free_f(to_free[i].ptr);
+	}
+	free(to_free);
+
+	return pending_n;
+}
+
+void atsc3_qsbr_quiescent() {
+	if(atsc3_qsbr_reader_slot < 0) {
+		pthread_mutex_lock(&atsc3_qsbr_mutex);
+		__atsc3_qsbr_register_locked();
+		pthread_mutex_unlock(&atsc3_qsbr_mutex);
+	}
+
+	uint64_t epoch = __atomic_load_n(&atsc3_qsbr_epoch, __ATOMIC_ACQUIRE);
+	if(__atomic_load_n(&atsc3_qsbr_reader_epoch[atsc3_qsbr_reader_slot], __ATOMIC_RELAXED) == epoch) {
+		return;
+	}
+	__atomic_store_n(&atsc3_qsbr_reader_epoch[atsc3_qsbr_reader_slot], epoch, __ATOMIC_RELEASE);
+
+	//this reader may have been the last one holding back a retired pointer
+	if(__atomic_load_n(&atsc3_qsbr_retired_n, __ATOMIC_RELAXED)) {
+		atsc3_qsbr_reclaim();
+	}
+}
+
+void atsc3_qsbr_thread_offline() {
+	if(atsc3_qsbr_reader_slot < 0) {
+		return;
+	}
+
+	pthread_mutex_lock(&atsc3_qsbr_mutex);
+	__atomic_store_n(&atsc3_qsbr_reader_epoch[atsc3_qsbr_reader_slot], 0, __ATOMIC_RELEASE);
+	atsc3_qsbr_reader_slot = -1;
+	pthread_mutex_unlock(&atsc3_qsbr_mutex);
+
+	atsc3_qsbr_reclaim();
+}
+
+bool atsc3_qsbr_read_section_begin() {
+	if(atsc3_qsbr_reader_slot >= 0) {
+		return false;
+	}
+	atsc3_qsbr_quiescent();
+	return true;
+}
+
+void atsc3_qsbr_read_section_end(bool registered) {
+	if(registered) {
+		atsc3_qsbr_thread_offline();
+	}
+}
+
+void atsc3_qsbr_retire(void* ptr, atsc3_qsbr_free_f free_f) {
+	if(!ptr) {
+		return;
+	}
+
+	pthread_mutex_lock(&atsc3_qsbr_mutex);
+	if(atsc3_qsbr_retired_n == atsc3_qsbr_retired_allocated) {
+		atsc3_qsbr_retired_allocated = atsc3_qsbr_retired_allocated ? atsc3_qsbr_retired_allocated * 2 : 16;
+		atsc3_qsbr_retired = (atsc3_qsbr_retired_t*)realloc(atsc3_qsbr_retired, atsc3_qsbr_retired_allocated * sizeof(atsc3_qsbr_retired_t));
+		if(!atsc3_qsbr_retired) {
+			abort();
+		}
+	}
+
+	//the caller's unpublish happens before this increment, a reader that observes the new epoch can no longer reach ptr
+	atsc3_qsbr_retired[atsc3_qsbr_retired_n].ptr = ptr;
+	atsc3_qsbr_retired[atsc3_qsbr_retired_n].free_f = free_f;
+	atsc3_qsbr_retired[atsc3_qsbr_retired_n].epoch = __atomic_add_fetch(&atsc3_qsbr_epoch, 1, __ATOMIC_SEQ_CST);
+	__atomic_store_n(&atsc3_qsbr_retired_n, atsc3_qsbr_retired_n + 1, __ATOMIC_RELAXED);
+	pthread_mutex_unlock(&atsc3_qsbr_mutex);
+
+	atsc3_qsbr_reclaim();
+}
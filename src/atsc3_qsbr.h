@@ -0,0 +1,64 @@
+/*
+ * atsc3_qsbr.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: jjustman
+ *
+ * quiescent state based reclamation for the structures the packet thread reads without a lock (flow dispatch tables,
+ * S-TSIDs, ALC sessions in the session registry)
+ *
+ * a writer unpublishes a pointer with an atomic store and hands it to atsc3_qsbr_retire, which advances the global epoch
+ * and tags the pointer with it. every reader thread calls atsc3_qsbr_quiescent at a point where it holds no reference into
+ * any of these structures (between packets), publishing the epoch it observed. a retired pointer is only freed once every
+ * registered reader has published an epoch at or past its tag, i.e. has passed a quiescent point after the unpublish, no
+ * matter how many times the structure was replaced in between.
+ *
+ * a thread registers on its first atsc3_qsbr_quiescent call, so it must make that call before its first lockless read.
+ * threads that only write or only read under their own locks never need to register. a registered reader that stops
+ * calling atsc3_qsbr_quiescent (e.g. capture idle) delays reclamation, it never makes it unsafe, call
+ * atsc3_qsbr_thread_offline before the thread exits or blocks for good.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <pthread.h>
+
+#include "atsc3_logging.h"
+
+#ifndef ATSC3_QSBR_H_
+#define ATSC3_QSBR_H_
+
+#if defined (__cplusplus)
+extern "C" {
+#endif
+
+#define ATSC3_QSBR_MAX_READERS		16
+
+typedef void (*atsc3_qsbr_free_f)(void* ptr);
+
+//marks the calling thread quiescent, registering it as a reader on first use, and frees whatever is now safe to free
+void atsc3_qsbr_quiescent();
+
+//unregisters the calling thread, it must not hold or take lockless references until its next atsc3_qsbr_quiescent call
+void atsc3_qsbr_thread_offline();
+
+//for threads that only read now and then (e.g. a flow dispatch rebuild from the ncurses thread): registers the calling thread
+//for one read section unless it already is a reader, pass the result to atsc3_qsbr_read_section_end
+bool atsc3_qsbr_read_section_begin();
+void atsc3_qsbr_read_section_end(bool registered);
+
+//ptr must already be unreachable for new readers, free_f(ptr) runs once every registered reader has been quiescent since
+void atsc3_qsbr_retire(void* ptr, atsc3_qsbr_free_f free_f);
+
+//frees the retired pointers every registered reader has moved past, returns how many are still pending
+uint32_t atsc3_qsbr_reclaim();
+
+#if defined (__cplusplus)
+}
+#endif
+
+#define __QSBR_ERROR(...)   __ATSC3_LOG_ERROR(ATSC3_LOG_MODULE_QSBR, __VA_ARGS__)
+
+#endif /* ATSC3_QSBR_H_ */
@@ -0,0 +1,129 @@
+/*
+ *
+ * atsc3_qsbr_test.c:  driver for quiescent state based reclamation of retired lockless structures
+ *
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <pthread.h>
+
+#include "atsc3_qsbr.h"
+
+int test_qsbr_no_readers_frees_immediately();
+int test_qsbr_back_to_back_retires_wait_for_reader();
+int test_qsbr_second_reader_holds_back_free();
+
+static int freed_n = 0;
+
+static void count_free(void* ptr) {
+	freed_n++;
+	free(ptr);
+}
+
+int main() {
+	int failed = 0;
+
+	failed += test_qsbr_no_readers_frees_immediately();
+	failed += test_qsbr_back_to_back_retires_wait_for_reader();
+	failed += test_qsbr_second_reader_holds_back_free();
+
+	printf("atsc3_qsbr_test: %s\n", failed ? "FAILED" : "OK");
+	return failed;
+}
+
+int test_qsbr_no_readers_frees_immediately() {
+	freed_n = 0;
+	atsc3_qsbr_retire(malloc(16), count_free);
+	if(freed_n != 1) {
+		printf("test_qsbr_no_readers_frees_immediately: freed: %d, expected 1\n", freed_n);
+		return 1;
+	}
+	return 0;
+}
+
+//the old one-rebuild grace period freed the first table on the second retire while the reader was still on it
+int test_qsbr_back_to_back_retires_wait_for_reader() {
+	freed_n = 0;
+	atsc3_qsbr_quiescent();
+
+	atsc3_qsbr_retire(malloc(16), count_free);
+	atsc3_qsbr_retire(malloc(16), count_free);
+	atsc3_qsbr_retire(malloc(16), count_free);
+	if(freed_n != 0) {
+		printf("test_qsbr_back_to_back_retires_wait_for_reader: freed: %d before the reader was quiescent\n", freed_n);
+		atsc3_qsbr_thread_offline();
+		return 1;
+	}
+
+	atsc3_qsbr_quiescent();
+	int ret = freed_n != 3;
+	if(ret) {
+		printf("test_qsbr_back_to_back_retires_wait_for_reader: freed: %d after quiescent, expected 3\n", freed_n);
+	}
+	atsc3_qsbr_thread_offline();
+	return ret;
+}
+
+static pthread_mutex_t reader_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t reader_cond = PTHREAD_COND_INITIALIZER;
+static int reader_step = 0;
+
+static void reader_wait_for_step(int step) {
+	pthread_mutex_lock(&reader_mutex);
+	while(reader_step < step) {
+		pthread_cond_wait(&reader_cond, &reader_mutex);
+	}
+	pthread_mutex_unlock(&reader_mutex);
+}
+
+static void reader_set_step(int step) {
+	pthread_mutex_lock(&reader_mutex);
+	reader_step = step;
+	pthread_cond_broadcast(&reader_cond);
+	pthread_mutex_unlock(&reader_mutex);
+}
+
+static void* reader_thread(void* arg) {
+	atsc3_qsbr_quiescent();
+	reader_set_step(1);
+
+	reader_wait_for_step(2);
+	atsc3_qsbr_quiescent();
+	reader_set_step(3);
+
+	reader_wait_for_step(4);
+	atsc3_qsbr_thread_offline();
+	return NULL;
+}
+
+int test_qsbr_second_reader_holds_back_free() {
+	pthread_t reader;
+	int ret = 0;
+
+	freed_n = 0;
+	reader_step = 0;
+	pthread_create(&reader, NULL, reader_thread, NULL);
+	reader_wait_for_step(1);
+
+	//this thread is a reader too, and quiescent right after the retire
+	atsc3_qsbr_quiescent();
+	atsc3_qsbr_retire(malloc(16), count_free);
+	atsc3_qsbr_quiescent();
+	if(freed_n != 0) {
+		printf("test_qsbr_second_reader_holds_back_free: freed while the other reader had not been quiescent\n");
+		ret = 1;
+	}
+
+	reader_set_step(2);
+	reader_wait_for_step(3);
+	if(!ret && freed_n != 1) {
+		printf("test_qsbr_second_reader_holds_back_free: freed: %d after both readers were quiescent, expected 1\n", freed_n);
+		ret = 1;
+	}
+
+	reader_set_step(4);
+	pthread_join(reader, NULL);
+	atsc3_qsbr_thread_offline();
+	return ret;
+}
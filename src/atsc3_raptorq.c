@@ -0,0 +1,615 @@
+/*
+ * atsc3_raptorq.c
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: jjustman
+ */
+
+#include "atsc3_raptorq.h"
+
+//RFC 6330 5.3.5.2 degree distribution
+static const uint32_t atsc3_raptorq_deg_f[31] = {
+	0, 5243, 529531, 704294, 791675, 844104, 879057, 904023, 922747, 937311, 948962,
+	958494, 966438, 973160, 978921, 983914, 988283, 992138, 995565, 998631, 1001391,
+	1003887, 1006157, 1008229, 1010129, 1011876, 1013490, 1014983, 1016370, 1017662, 1048576
+};
+
+typedef struct atsc3_raptorq_tuple {
+	uint32_t d;
+	uint32_t a;
+	uint32_t b;
+	uint32_t d1;
+	uint32_t a1;
+	uint32_t b1;
+} atsc3_raptorq_tuple_t;
+
+//RFC 6330 5.3.5.1
+static inline uint32_t atsc3_raptorq_rand(uint32_t y, uint32_t i, uint32_t m) {
+	return (atsc3_raptorq_v0[(y + i) & 0xFF] ^
+			atsc3_raptorq_v1[((y >> 8) + i) & 0xFF] ^
+			atsc3_raptorq_v2[((y >> 16) + i) & 0xFF] ^
+			atsc3_raptorq_v3[((y >> 24) + i) & 0xFF]) % m;
+}
+
+static uint32_t atsc3_raptorq_deg(uint32_t v, uint32_t w) {
+	uint32_t d = 1;
+	while(d < 30 && v >= atsc3_raptorq_deg_f[d]) {
+		d++;
+	}
+	return d < w - 2 ? d : w - 2;
+}
+
+//RFC 6330 5.3.5.4, y is computed mod 2^32 by unsigned overflow
+static void atsc3_raptorq_tuple(const atsc3_raptorq_params_t* params, uint32_t x, atsc3_raptorq_tuple_t* tuple) {
+	uint32_t a = 53591 + params->j * 997;
+	if(!(a & 0x1)) {
+		a++;
+	}
+	uint32_t b = 10267 * (params->j + 1);
+	uint32_t y = b + x * a;
+
+	tuple->d = atsc3_raptorq_deg(atsc3_raptorq_rand(y, 0, 1 << 20), params->w);
+	tuple->a = 1 + atsc3_raptorq_rand(y, 1, params->w - 1);
+	tuple->b = atsc3_raptorq_rand(y, 2, params->w);
+	tuple->d1 = tuple->d < 4 ? 2 + atsc3_raptorq_rand(x, 3, 2) : 2;
+	tuple->a1 = 1 + atsc3_raptorq_rand(x, 4, params->p1 - 1);
+	tuple->b1 = atsc3_raptorq_rand(x, 5, params->p1);
+}
+
+/*
+ * intermediate symbol indexes combined by Enc[] for isi (RFC 6330 5.3.5.3), cols must hold at least d + d1 entries.
+ * an index can repeat, callers xor/toggle so repeats cancel the same way they do in Enc[]
+ */
+static uint32_t atsc3_raptorq_enc_columns(const atsc3_raptorq_params_t* params, uint32_t isi, uint32_t* cols) {
+	atsc3_raptorq_tuple_t tuple;
+	atsc3_raptorq_tuple(params, isi, &tuple);
+
+	uint32_t n = 0;
+	uint32_t b = tuple.b;
+	cols[n++] = b;
+	for(uint32_t j = 1; j < tuple.d; j++) {
+		b = (b + tuple.a) % params->w;
+		cols[n++] = b;
+	}
+
+	uint32_t b1 = tuple.b1;
+	while(b1 >= params->p) {
+		b1 = (b1 + tuple.a1) % params->p1;
+	}
+	cols[n++] = params->w + b1;
+	for(uint32_t j = 1; j < tuple.d1; j++) {
+		b1 = (b1 + tuple.a1) % params->p1;
+		while(b1 >= params->p) {
+			b1 = (b1 + tuple.a1) % params->p1;
+		}
+		cols[n++] = params->w + b1;
+	}
+	return n;
+}
+
+static bool atsc3_raptorq_is_prime(uint32_t n) {
+	if(n < 2) {
+		return false;
+	}
+	for(uint32_t i = 2; i * i <= n; i++) {
+		if(n % i == 0) {
+			return false;
+		}
+	}
+	return true;
+}
+
+bool atsc3_raptorq_oti_parse(const uint8_t* buf, uint32_t len, atsc3_raptorq_oti_t* atsc3_raptorq_oti) {
+	if(len < ATSC3_RAPTORQ_OTI_LEN) {
+		return false;
+	}
+
+	//F(40) reserved(8) T(16) | Z(8) N(16) Al(8)
+	atsc3_raptorq_oti->transfer_length = ((uint64_t)buf[0] << 32) | ((uint64_t)buf[1] << 24) | ((uint64_t)buf[2] << 16) | ((uint64_t)buf[3] << 8) | buf[4];
+	atsc3_raptorq_oti->symbol_size = (buf[6] << 8) | buf[7];
+	atsc3_raptorq_oti->source_blocks = buf[8];
+	atsc3_raptorq_oti->sub_blocks = (buf[9] << 8) | buf[10];
+	atsc3_raptorq_oti->alignment = buf[11];
+
+	if(!atsc3_raptorq_oti->transfer_length || !atsc3_raptorq_oti->symbol_size || !atsc3_raptorq_oti->source_blocks || !atsc3_raptorq_oti->sub_blocks) {
+		return false;
+	}
+	return true;
+}
+
+bool atsc3_raptorq_tables_available() {
+	return atsc3_raptorq_systematic_indices_n > 0;
+}
+
+bool atsc3_raptorq_params_init(uint32_t k, atsc3_raptorq_params_t* atsc3_raptorq_params) {
+	if(!k || k > ATSC3_RAPTORQ_MAX_K) {
+		return false;
+	}
+
+	const atsc3_raptorq_systematic_index_t* entry = NULL;
+	for(uint32_t i = 0; i < atsc3_raptorq_systematic_indices_n; i++) {
+		if(atsc3_raptorq_systematic_indices[i].k_prime >= k) {
+			entry = &atsc3_raptorq_systematic_indices[i];
+			break;
+		}
+	}
+	if(!entry) {
+		return false;
+	}
+
+	atsc3_raptorq_params->k = k;
+	atsc3_raptorq_params->k_prime = entry->k_prime;
+	atsc3_raptorq_params->j = entry->j;
+	atsc3_raptorq_params->s = entry->s;
+	atsc3_raptorq_params->h = entry->h;
+	atsc3_raptorq_params->w = entry->w;
+	atsc3_raptorq_params->l = entry->k_prime + entry->s + entry->h;
+	atsc3_raptorq_params->p = atsc3_raptorq_params->l - entry->w;
+	atsc3_raptorq_params->b = entry->w - entry->s;
+
+	uint32_t p1 = atsc3_raptorq_params->p;
+	while(!atsc3_raptorq_is_prime(p1)) {
+		p1++;
+	}
+	atsc3_raptorq_params->p1 = p1;
+
+	return true;
+}
+
+/*
+ * fills the S LDPC rows and H HDPC rows of the constraint matrix (RFC 6330 5.3.3.3), each row is L bytes
+ */
+static void atsc3_raptorq_precode_rows(const atsc3_raptorq_params_t* params, uint8_t** ldpc_rows, uint8_t** hdpc_rows) {
+	uint32_t s = params->s;
+	uint32_t h = params->h;
+	uint32_t b = params->b;
+	uint32_t w = params->w;
+	uint32_t p = params->p;
+	uint32_t ks = params->k_prime + s;
+
+	for(uint32_t i = 0; i < b; i++) {
+		uint32_t a = 1 + i / s;
+		uint32_t r = i % s;
+		ldpc_rows[r][i] ^= 1;
+		r = (r + a) % s;
+		ldpc_rows[r][i] ^= 1;
+		r = (r + a) % s;
+		ldpc_rows[r][i] ^= 1;
+	}
+	for(uint32_t i = 0; i < s; i++) {
+		ldpc_rows[i][b + i] = 1;
+		ldpc_rows[i][w + (i % p)] ^= 1;
+		ldpc_rows[i][w + ((i + 1) % p)] ^= 1;
+	}
+
+	//MT has two ones per column (rows Rand[j+1, 6, H] and the follow-on row), last column alpha^^i
+	uint32_t* mt_rows = (uint32_t*)calloc(2 * ks, sizeof(uint32_t));
+	for(uint32_t j = 0; j + 1 < ks; j++) {
+		uint32_t i1 = atsc3_raptorq_rand(j + 1, 6, h);
+		uint32_t i2 = (i1 + atsc3_raptorq_rand(j + 1, 7, h - 1) + 1) % h;
+		mt_rows[2 * j] = i1;
+		mt_rows[2 * j + 1] = i2;
+	}
+
+	//MT * GAMMA, GAMMA[i][j] = alpha^^(i-j) for i >= j, evaluated horner style from the last column
+	for(uint32_t i = 0; i < h; i++) {
+		uint8_t acc = 0;
+		for(uint32_t j = ks; j-- > 0; ) {
+			uint8_t mt;
+			if(j == ks - 1) {
+				mt = atsc3_gf256_alpha_pow(i);
+			} else {
+				mt = (mt_rows[2 * j] == i || mt_rows[2 * j + 1] == i) ? 1 : 0;
+			}
+			acc = atsc3_gf256_mul(acc, 2) ^ mt;
+			hdpc_rows[i][j] = acc;
+		}
+		hdpc_rows[i][ks + i] = 1;
+	}
+
+	free(mt_rows);
+}
+
+static void atsc3_raptorq_lt_row(const atsc3_raptorq_params_t* params, uint32_t isi, uint8_t* row) {
+	uint32_t cols[64];
+	uint32_t n = atsc3_raptorq_enc_columns(params, isi, cols);
+	for(uint32_t i = 0; i < n; i++) {
+		row[cols[i]] ^= 1;
+	}
+}
+
+/*
+ * gaussian elimination of the m x L system A * C = D, m >= L, rows are swapped by pointer.
+ *
+ * on success d_rows[0..L-1] hold the intermediate symbols C[0..L-1]
+ */
+static bool atsc3_raptorq_solve(uint32_t l, uint8_t** a_rows, uint8_t** d_rows, uint32_t m, uint16_t symbol_size) {
+	for(uint32_t c = 0; c < l; c++) {
+		uint32_t r = c;
+		while(r < m && !a_rows[r][c]) {
+			r++;
+		}
+		if(r == m) {
+			return false;
+		}
+		if(r != c) {
+			uint8_t* tmp = a_rows[c];
+			a_rows[c] = a_rows[r];
+			a_rows[r] = tmp;
+			tmp = d_rows[c];
+			d_rows[c] = d_rows[r];
+			d_rows[r] = tmp;
+		}
+
+		uint8_t pivot = a_rows[c][c];
+		if(pivot != 1) {
+			uint8_t inv = atsc3_gf256_div(1, pivot);
+			atsc3_gf256_row_mul(a_rows[c] + c, inv, l - c);
+			atsc3_gf256_row_mul(d_rows[c], inv, symbol_size);
+		}
+
+		for(r = c + 1; r < m; r++) {
+			uint8_t f = a_rows[r][c];
+			if(f) {
+				atsc3_gf256_row_muladd(a_rows[r] + c, a_rows[c] + c, f, l - c);
+				atsc3_gf256_row_muladd(d_rows[r], d_rows[c], f, symbol_size);
+			}
+		}
+	}
+
+	//A is now upper triangular with a unit diagonal, only the symbol rows need back substitution
+	for(uint32_t c = l; c-- > 1; ) {
+		for(uint32_t r = 0; r < c; r++) {
+			uint8_t f = a_rows[r][c];
+			if(f) {
+				atsc3_gf256_row_muladd(d_rows[r], d_rows[c], f, symbol_size);
+			}
+		}
+	}
+
+	return true;
+}
+
+/*
+ * builds and solves the constraint system for the given ISIs, symbols[i] is the encoding symbol for isis[i].
+ * the padding ISIs K..K'-1 are added as known zero symbols. returns a malloc'd L * T intermediate symbol buffer or NULL
+ */
+static uint8_t* atsc3_raptorq_solve_intermediate(const atsc3_raptorq_params_t* params, const uint32_t* isis, const uint8_t* symbols, uint32_t n, uint16_t symbol_size) {
+	uint32_t l = params->l;
+	uint32_t padding = params->k_prime - params->k;
+	uint32_t m = n + padding + params->s + params->h;
+
+	uint8_t* a = (uint8_t*)calloc((size_t)m, l);
+	uint8_t* d = (uint8_t*)calloc((size_t)m, symbol_size);
+	uint8_t** a_rows = (uint8_t**)calloc(m, sizeof(uint8_t*));
+	uint8_t** d_rows = (uint8_t**)calloc(m, sizeof(uint8_t*));
+	uint8_t* intermediate = NULL;
+
+	if(!a || !d || !a_rows || !d_rows) {
+		__RAPTORQ_ERROR("solve: unable to allocate %u x %u constraint matrix", m, l);
+		goto cleanup;
+	}
+
+	for(uint32_t i = 0; i < m; i++) {
+		a_rows[i] = a + (size_t)i * l;
+		d_rows[i] = d + (size_t)i * symbol_size;
+	}
+
+	//LT rows first, LDPC next and the dense HDPC rows last so they are only picked as pivots when nothing sparser is left
+	for(uint32_t i = 0; i < n; i++) {
+		atsc3_raptorq_lt_row(params, isis[i], a_rows[i]);
+		memcpy(d_rows[i], symbols + (size_t)i * symbol_size, symbol_size);
+	}
+	for(uint32_t i = 0; i < padding; i++) {
+		atsc3_raptorq_lt_row(params, params->k + i, a_rows[n + i]);
+	}
+	atsc3_raptorq_precode_rows(params, &a_rows[n + padding], &a_rows[n + padding + params->s]);
+
+	if(!atsc3_raptorq_solve(l, a_rows, d_rows, m, symbol_size)) {
+		goto cleanup;
+	}
+
+	intermediate = (uint8_t*)malloc((size_t)l * symbol_size);
+	for(uint32_t i = 0; i < l; i++) {
+		memcpy(intermediate + (size_t)i * symbol_size, d_rows[i], symbol_size);
+	}
+
+cleanup:
+	free(a);
+	free(d);
+	free(a_rows);
+	free(d_rows);
+	return intermediate;
+}
+
+uint8_t* atsc3_raptorq_encode_intermediate(const atsc3_raptorq_params_t* atsc3_raptorq_params, const uint8_t* source, uint16_t symbol_size) {
+	atsc3_gf256_init();
+
+	uint32_t k = atsc3_raptorq_params->k;
+	uint32_t* isis = (uint32_t*)malloc(k * sizeof(uint32_t));
+	for(uint32_t i = 0; i < k; i++) {
+		isis[i] = i;
+	}
+	uint8_t* intermediate = atsc3_raptorq_solve_intermediate(atsc3_raptorq_params, isis, source, k, symbol_size);
+	free(isis);
+
+	if(!intermediate) {
+		__RAPTORQ_ERROR("encode: constraint matrix is singular for K: %u", k);
+	}
+	return intermediate;
+}
+
+void atsc3_raptorq_encode_symbol(const atsc3_raptorq_params_t* atsc3_raptorq_params, const uint8_t* intermediate, uint16_t symbol_size, uint32_t esi, uint8_t* symbol) {
+	uint32_t isi = esi < atsc3_raptorq_params->k ? esi : esi + atsc3_raptorq_params->k_prime - atsc3_raptorq_params->k;
+	uint32_t cols[64];
+	uint32_t n = atsc3_raptorq_enc_columns(atsc3_raptorq_params, isi, cols);
+
+	memcpy(symbol, intermediate + (size_t)cols[0] * symbol_size, symbol_size);
+	for(uint32_t i = 1; i < n; i++) {
+		atsc3_gf256_row_add(symbol, intermediate + (size_t)cols[i] * symbol_size, symbol_size);
+	}
+}
+
+atsc3_raptorq_block_decoder_t* atsc3_raptorq_block_decoder_create(uint32_t k, uint16_t symbol_size) {
+	if(!symbol_size) {
+		return NULL;
+	}
+
+	atsc3_gf256_init();
+
+	atsc3_raptorq_block_decoder_t* atsc3_raptorq_block_decoder = (atsc3_raptorq_block_decoder_t*)calloc(1, sizeof(atsc3_raptorq_block_decoder_t));
+	if(!atsc3_raptorq_params_init(k, &atsc3_raptorq_block_decoder->params)) {
+		__RAPTORQ_ERROR("block_decoder_create: unsupported K: %u", k);
+		free(atsc3_raptorq_block_decoder);
+		return NULL;
+	}
+
+	atsc3_raptorq_block_decoder->symbol_size = symbol_size;
+	atsc3_raptorq_block_decoder->source_symbol_index = (int32_t*)malloc(k * sizeof(int32_t));
+	for(uint32_t i = 0; i < k; i++) {
+		atsc3_raptorq_block_decoder->source_symbol_index[i] = -1;
+	}
+
+	return atsc3_raptorq_block_decoder;
+}
+
+int atsc3_raptorq_block_decoder_add_symbol(atsc3_raptorq_block_decoder_t* atsc3_raptorq_block_decoder, uint32_t esi, const uint8_t* symbol) {
+	atsc3_raptorq_block_decoder_t* dec = atsc3_raptorq_block_decoder;
+	if(dec->decoded) {
+		return 0;
+	}
+	//ESIs are 24 bits in the FEC payload id
+	if(esi > 0xFFFFFF) {
+		return -1;
+	}
+
+	if(esi < dec->params.k) {
+		if(dec->source_symbol_index[esi] >= 0) {
+			return 0;
+		}
+	} else {
+		//repair symbols are a small fraction of the block, a linear scan is cheaper than keeping another index
+		for(uint32_t i = 0; i < dec->symbols_n; i++) {
+			if(dec->esi[i] == esi) {
+				return 0;
+			}
+		}
+	}
+
+	if(dec->symbols_n == dec->symbols_allocated) {
+		uint32_t to_allocate = dec->symbols_allocated ? dec->symbols_allocated * 2 : dec->params.k + 8;
+		uint32_t* esi_new = (uint32_t*)realloc(dec->esi, to_allocate * sizeof(uint32_t));
+		if(!esi_new) {
+			return -1;
+		}
+		dec->esi = esi_new;
+		uint8_t* symbols_new = (uint8_t*)realloc(dec->symbols, (size_t)to_allocate * dec->symbol_size);
+		if(!symbols_new) {
+			return -1;
+		}
+		dec->symbols = symbols_new;
+		dec->symbols_allocated = to_allocate;
+	}
+
+	dec->esi[dec->symbols_n] = esi;
+	memcpy(dec->symbols + (size_t)dec->symbols_n * dec->symbol_size, symbol, dec->symbol_size);
+	if(esi < dec->params.k) {
+		dec->source_symbol_index[esi] = dec->symbols_n;
+		dec->source_received_n++;
+	}
+	dec->symbols_n++;
+
+	return 1;
+}
+
+atsc3_raptorq_decode_status_t atsc3_raptorq_block_decoder_decode(atsc3_raptorq_block_decoder_t* atsc3_raptorq_block_decoder) {
+	atsc3_raptorq_block_decoder_t* dec = atsc3_raptorq_block_decoder;
+	if(dec->decoded) {
+		return ATSC3_RAPTORQ_DECODE_OK;
+	}
+
+	uint32_t k = dec->params.k;
+	uint16_t t = dec->symbol_size;
+
+	if(dec->symbols_n < k || dec->symbols_n == dec->symbols_n_at_last_attempt) {
+		return ATSC3_RAPTORQ_DECODE_NEED_MORE;
+	}
+	dec->symbols_n_at_last_attempt = dec->symbols_n;
+
+	dec->source = (uint8_t*)malloc((size_t)k * t);
+	if(!dec->source) {
+		return ATSC3_RAPTORQ_DECODE_ERROR;
+	}
+
+	//systematic fast path, nothing was lost
+	if(dec->source_received_n == k) {
+		for(uint32_t i = 0; i < k; i++) {
+			memcpy(dec->source + (size_t)i * t, dec->symbols + (size_t)dec->source_symbol_index[i] * t, t);
+		}
+		goto decoded;
+	}
+
+	uint32_t* isis = (uint32_t*)malloc(dec->symbols_n * sizeof(uint32_t));
+	for(uint32_t i = 0; i < dec->symbols_n; i++) {
+		isis[i] = dec->esi[i] < k ? dec->esi[i] : dec->esi[i] + dec->params.k_prime - k;
+	}
+
+	uint8_t* intermediate = atsc3_raptorq_solve_intermediate(&dec->params, isis, dec->symbols, dec->symbols_n, t);
+	free(isis);
+
+	if(!intermediate) {
+		free(dec->source);
+		dec->source = NULL;
+		return ATSC3_RAPTORQ_DECODE_NEED_MORE;
+	}
+
+	for(uint32_t i = 0; i < k; i++) {
+		if(dec->source_symbol_index[i] >= 0) {
+			memcpy(dec->source + (size_t)i * t, dec->symbols + (size_t)dec->source_symbol_index[i] * t, t);
+		} else {
+			atsc3_raptorq_encode_symbol(&dec->params, intermediate, t, i, dec->source + (size_t)i * t);
+		}
+	}
+	free(intermediate);
+
+decoded:
+	dec->decoded = true;
+
+	//received symbols are no longer needed once the source block is recovered
+	free(dec->esi);
+	dec->esi = NULL;
+	free(dec->symbols);
+	dec->symbols = NULL;
+	dec->symbols_allocated = 0;
+
+	return ATSC3_RAPTORQ_DECODE_OK;
+}
+
+void atsc3_raptorq_block_decoder_free(atsc3_raptorq_block_decoder_t** atsc3_raptorq_block_decoder_p) {
+	atsc3_raptorq_block_decoder_t* atsc3_raptorq_block_decoder = *atsc3_raptorq_block_decoder_p;
+	if(atsc3_raptorq_block_decoder) {
+		free(atsc3_raptorq_block_decoder->esi);
+		free(atsc3_raptorq_block_decoder->symbols);
+		free(atsc3_raptorq_block_decoder->source_symbol_index);
+		free(atsc3_raptorq_block_decoder->source);
+		free(atsc3_raptorq_block_decoder);
+	}
+	*atsc3_raptorq_block_decoder_p = NULL;
+}
+
+atsc3_raptorq_object_decoder_t* atsc3_raptorq_object_decoder_create(const atsc3_raptorq_oti_t* atsc3_raptorq_oti) {
+	uint64_t f = atsc3_raptorq_oti->transfer_length;
+	uint32_t t = atsc3_raptorq_oti->symbol_size;
+	uint32_t z = atsc3_raptorq_oti->source_blocks;
+
+	if(!f || !t || !z || f > UINT32_MAX) {
+		__RAPTORQ_ERROR("object_decoder_create: invalid OTI, F: %llu, T: %u, Z: %u", (unsigned long long)f, t, z);
+		return NULL;
+	}
+	if(!atsc3_raptorq_tables_available()) {
+		__RAPTORQ_ERROR("object_decoder_create: no RFC 6330 tables, regenerate atsc3_raptorq_tables.c with support_scripts/rfc6330_tables.py");
+		return NULL;
+	}
+	if(atsc3_raptorq_oti->sub_blocks != 1) {
+		__RAPTORQ_ERROR("object_decoder_create: sub-blocking is not supported, N: %u", atsc3_raptorq_oti->sub_blocks);
+		return NULL;
+	}
+
+	uint64_t kt = (f + t - 1) / t;
+	uint64_t kl = (kt + z - 1) / z;
+	if(kl > ATSC3_RAPTORQ_MAX_K || kt < z) {
+		__RAPTORQ_ERROR("object_decoder_create: unsupported partitioning, Kt: %llu, Z: %u", (unsigned long long)kt, z);
+		return NULL;
+	}
+
+	atsc3_raptorq_object_decoder_t* atsc3_raptorq_object_decoder = (atsc3_raptorq_object_decoder_t*)calloc(1, sizeof(atsc3_raptorq_object_decoder_t));
+	atsc3_raptorq_object_decoder->oti = *atsc3_raptorq_oti;
+	atsc3_raptorq_object_decoder->kt = kt;
+	atsc3_raptorq_object_decoder->kl = kl;
+	atsc3_raptorq_object_decoder->ks = kt / z;
+	atsc3_raptorq_object_decoder->zl = kt - atsc3_raptorq_object_decoder->ks * z;
+	atsc3_raptorq_object_decoder->blocks = (atsc3_raptorq_block_decoder_t**)calloc(z, sizeof(atsc3_raptorq_block_decoder_t*));
+	atsc3_raptorq_object_decoder->object = (uint8_t*)malloc(f);
+
+	if(!atsc3_raptorq_object_decoder->blocks || !atsc3_raptorq_object_decoder->object) {
+		atsc3_raptorq_object_decoder_free(&atsc3_raptorq_object_decoder);
+	}
+
+	return atsc3_raptorq_object_decoder;
+}
+
+bool atsc3_raptorq_object_decoder_add_packet(atsc3_raptorq_object_decoder_t* atsc3_raptorq_object_decoder, uint8_t sbn, uint32_t esi, const uint8_t* payload, uint32_t payload_len) {
+	atsc3_raptorq_object_decoder_t* obj = atsc3_raptorq_object_decoder;
+	uint32_t t = obj->oti.symbol_size;
+
+	if(sbn >= obj->oti.source_blocks) {
+		__RAPTORQ_WARN("add_packet: SBN: %u out of range, Z: %u", sbn, obj->oti.source_blocks);
+		return atsc3_raptorq_object_decoder_is_complete(obj);
+	}
+
+	//first ZL blocks carry KL source symbols, the rest KS
+	uint32_t k = sbn < obj->zl ? obj->kl : obj->ks;
+	uint64_t first_symbol = sbn < obj->zl ? (uint64_t)sbn * obj->kl : (uint64_t)obj->zl * obj->kl + (uint64_t)(sbn - obj->zl) * obj->ks;
+
+	if(!obj->blocks[sbn]) {
+		obj->blocks[sbn] = atsc3_raptorq_block_decoder_create(k, t);
+		if(!obj->blocks[sbn]) {
+			return false;
+		}
+	}
+	atsc3_raptorq_block_decoder_t* block = obj->blocks[sbn];
+	if(block->decoded) {
+		return atsc3_raptorq_object_decoder_is_complete(obj);
+	}
+
+	bool added = false;
+	for(uint32_t i = 0; i + t <= payload_len; i += t) {
+		if(atsc3_raptorq_block_decoder_add_symbol(block, esi++, payload + i) > 0) {
+			added = true;
+		}
+	}
+
+	if(added && atsc3_raptorq_block_decoder_decode(block) == ATSC3_RAPTORQ_DECODE_OK) {
+		//the last source symbol of the object is zero padded past F
+		uint64_t offset = first_symbol * t;
+		uint64_t len = (uint64_t)k * t;
+		if(offset + len > obj->oti.transfer_length) {
+			len = obj->oti.transfer_length - offset;
+		}
+		memcpy(obj->object + offset, block->source, len);
+
+		free(block->source);
+		block->source = NULL;
+		obj->blocks_decoded_n++;
+	}
+
+	return atsc3_raptorq_object_decoder_is_complete(obj);
+}
+
+bool atsc3_raptorq_object_decoder_is_complete(atsc3_raptorq_object_decoder_t* atsc3_raptorq_object_decoder) {
+	return atsc3_raptorq_object_decoder->blocks_decoded_n == atsc3_raptorq_object_decoder->oti.source_blocks;
+}
+
+uint8_t* atsc3_raptorq_object_decoder_take_object(atsc3_raptorq_object_decoder_t* atsc3_raptorq_object_decoder) {
+	if(!atsc3_raptorq_object_decoder_is_complete(atsc3_raptorq_object_decoder)) {
+		return NULL;
+	}
+	uint8_t* object = atsc3_raptorq_object_decoder->object;
+	atsc3_raptorq_object_decoder->object = NULL;
+	return object;
+}
+
+void atsc3_raptorq_object_decoder_free(atsc3_raptorq_object_decoder_t** atsc3_raptorq_object_decoder_p) {
+	atsc3_raptorq_object_decoder_t* atsc3_raptorq_object_decoder = *atsc3_raptorq_object_decoder_p;
+	if(atsc3_raptorq_object_decoder) {
+		if(atsc3_raptorq_object_decoder->blocks) {
+			for(uint32_t i = 0; i < atsc3_raptorq_object_decoder->oti.source_blocks; i++) {
+				atsc3_raptorq_block_decoder_free(&atsc3_raptorq_object_decoder->blocks[i]);
+			}
+			free(atsc3_raptorq_object_decoder->blocks);
+		}
+		free(atsc3_raptorq_object_decoder->object);
+		free(atsc3_raptorq_object_decoder);
+	}
+	*atsc3_raptorq_object_decoder_p = NULL;
+}
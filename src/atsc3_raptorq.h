@@ -0,0 +1,174 @@
+/*
+ * atsc3_raptorq.h
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: jjustman
+ *
+ * RaptorQ (RFC 6330) FEC decoder for ALC/ROUTE objects delivered with SBN/ESI FEC Payload IDs
+ *
+ * source block decoder:
+ *
+ * 	source and repair symbols for one source block are collected by ESI (duplicates ignored), once at least K symbols
+ * 	are present the L x L constraint matrix (LDPC, HDPC and the LT rows for each received ISI, RFC 6330 5.3.3.4) is
+ * 	solved for the intermediate symbols by gaussian elimination over GF(256), the missing source symbols are then
+ * 	re-encoded from the intermediate symbols. elimination uses the atsc3_gf256 vectorized row operations for both the
+ * 	matrix rows and the symbol rows. if the received set is singular (~1% with no overhead) decode returns
+ * 	ATSC3_RAPTORQ_DECODE_NEED_MORE and is retried when more symbols arrive
+ *
+ * object decoder:
+ *
+ * 	splits the transfer length into Z source blocks per the OTI (RFC 6330 4.4.1.2), only N = 1 (no sub-blocking) is
+ * 	supported, which is what ROUTE senders use. the recovered object is handed back as a single buffer of F bytes
+ *
+ * the normative tables (V0..V3 and the systematic index table) live in atsc3_raptorq_tables.c, which is generated
+ * from the RFC text by support_scripts/rfc6330_tables.py rather than being transcribed by hand. the generated file is
+ * committed, a --placeholder build has no entries, atsc3_raptorq_tables_available() then returns false and
+ * atsc3_raptorq_test fails until the file is regenerated
+ *
+ * decoding cost grows with L^2, source blocks are limited to ATSC3_RAPTORQ_MAX_K source symbols
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+
+#include "atsc3_gf256.h"
+#include "atsc3_logging.h"
+
+#ifndef ATSC3_RAPTORQ_H_
+#define ATSC3_RAPTORQ_H_
+
+#if defined (__cplusplus)
+extern "C" {
+#endif
+
+//FEC Encoding ID, RFC 6330 3.1
+#define ATSC3_RAPTORQ_FEC_ENCODING_ID		6
+
+//common (8 bytes) + scheme specific (4 bytes) FEC OTI, RFC 6330 3.3.2 and 3.3.3
+#define ATSC3_RAPTORQ_OTI_LEN				12
+
+#define ATSC3_RAPTORQ_MAX_K					4096
+#define ATSC3_RAPTORQ_MAX_SYMBOL_SIZE		65535
+
+typedef enum {
+	ATSC3_RAPTORQ_DECODE_OK = 0,
+	ATSC3_RAPTORQ_DECODE_NEED_MORE = 1,
+	ATSC3_RAPTORQ_DECODE_ERROR = -1
+} atsc3_raptorq_decode_status_t;
+
+typedef struct atsc3_raptorq_oti {
+	uint64_t	transfer_length;	//F, 40 bits
+	uint16_t	symbol_size;		//T
+	uint8_t		source_blocks;		//Z
+	uint16_t	sub_blocks;			//N
+	uint8_t		alignment;			//Al
+} atsc3_raptorq_oti_t;
+
+//RFC 6330 5.6 Table 2
+typedef struct atsc3_raptorq_systematic_index {
+	uint32_t	k_prime;
+	uint32_t	j;
+	uint32_t	s;
+	uint32_t	h;
+	uint32_t	w;
+} atsc3_raptorq_systematic_index_t;
+
+//atsc3_raptorq_tables.c
+extern const uint32_t atsc3_raptorq_v0[256];
+extern const uint32_t atsc3_raptorq_v1[256];
+extern const uint32_t atsc3_raptorq_v2[256];
+extern const uint32_t atsc3_raptorq_v3[256];
+extern const atsc3_raptorq_systematic_index_t atsc3_raptorq_systematic_indices[];
+extern const uint32_t atsc3_raptorq_systematic_indices_n;
+
+//derived code parameters for a source block of K symbols, RFC 6330 5.3.3.3
+typedef struct atsc3_raptorq_params {
+	uint32_t	k;
+	uint32_t	k_prime;
+	uint32_t	j;
+	uint32_t	s;
+	uint32_t	h;
+	uint32_t	w;
+	uint32_t	l;
+	uint32_t	p;
+	uint32_t	p1;
+	uint32_t	b;
+} atsc3_raptorq_params_t;
+
+typedef struct atsc3_raptorq_block_decoder {
+	atsc3_raptorq_params_t	params;
+	uint16_t				symbol_size;
+
+	//received symbols in arrival order, esi[i] -> symbols + i * symbol_size
+	uint32_t*				esi;
+	uint8_t*				symbols;
+	uint32_t				symbols_n;
+	uint32_t				symbols_allocated;
+
+	//K entries, index into esi/symbols of each source symbol received, -1 if missing
+	int32_t*				source_symbol_index;
+	uint32_t				source_received_n;
+
+	uint32_t				symbols_n_at_last_attempt;
+	bool					decoded;
+	uint8_t*				source;		//K * symbol_size once decoded
+} atsc3_raptorq_block_decoder_t;
+
+typedef struct atsc3_raptorq_object_decoder {
+	atsc3_raptorq_oti_t				oti;
+
+	//RFC 6330 4.4.1.2 partition of Kt source symbols into ZL blocks of KL and ZS blocks of KS
+	uint32_t						kt;
+	uint32_t						kl;
+	uint32_t						ks;
+	uint32_t						zl;
+
+	atsc3_raptorq_block_decoder_t**	blocks;		//Z, created on the first symbol for the block
+	uint32_t						blocks_decoded_n;
+
+	uint8_t*						object;		//F bytes, source blocks are copied in as they decode
+} atsc3_raptorq_object_decoder_t;
+
+bool atsc3_raptorq_oti_parse(const uint8_t* buf, uint32_t len, atsc3_raptorq_oti_t* atsc3_raptorq_oti);
+
+//returns false if K is out of range
+//false when atsc3_raptorq_tables.c was generated without the RFC 6330 tables, no block can be decoded
+bool atsc3_raptorq_tables_available();
+
+bool atsc3_raptorq_params_init(uint32_t k, atsc3_raptorq_params_t* atsc3_raptorq_params);
+
+atsc3_raptorq_block_decoder_t* atsc3_raptorq_block_decoder_create(uint32_t k, uint16_t symbol_size);
+//returns 1 if the symbol was added, 0 if it was a duplicate or the block is already decoded, -1 on error
+int atsc3_raptorq_block_decoder_add_symbol(atsc3_raptorq_block_decoder_t* atsc3_raptorq_block_decoder, uint32_t esi, const uint8_t* symbol);
+atsc3_raptorq_decode_status_t atsc3_raptorq_block_decoder_decode(atsc3_raptorq_block_decoder_t* atsc3_raptorq_block_decoder);
+void atsc3_raptorq_block_decoder_free(atsc3_raptorq_block_decoder_t** atsc3_raptorq_block_decoder_p);
+
+atsc3_raptorq_object_decoder_t* atsc3_raptorq_object_decoder_create(const atsc3_raptorq_oti_t* atsc3_raptorq_oti);
+//payload may carry several consecutive symbols starting at esi, returns true once every source block is decoded
+bool atsc3_raptorq_object_decoder_add_packet(atsc3_raptorq_object_decoder_t* atsc3_raptorq_object_decoder, uint8_t sbn, uint32_t esi, const uint8_t* payload, uint32_t payload_len);
+bool atsc3_raptorq_object_decoder_is_complete(atsc3_raptorq_object_decoder_t* atsc3_raptorq_object_decoder);
+//hands the recovered F byte object to the caller, who must free() it
+uint8_t* atsc3_raptorq_object_decoder_take_object(atsc3_raptorq_object_decoder_t* atsc3_raptorq_object_decoder);
+void atsc3_raptorq_object_decoder_free(atsc3_raptorq_object_decoder_t** atsc3_raptorq_object_decoder_p);
+
+/*
+ * encoder side, used by the unit test and benchmark to produce repair symbols
+ */
+
+//solves for the L intermediate symbols (L * symbol_size bytes) from the K source symbols, returns NULL on error
+uint8_t* atsc3_raptorq_encode_intermediate(const atsc3_raptorq_params_t* atsc3_raptorq_params, const uint8_t* source, uint16_t symbol_size);
+//writes the encoding symbol for esi (source or repair) into symbol
+void atsc3_raptorq_encode_symbol(const atsc3_raptorq_params_t* atsc3_raptorq_params, const uint8_t* intermediate, uint16_t symbol_size, uint32_t esi, uint8_t* symbol);
+
+#if defined (__cplusplus)
+}
+#endif
+
+#define __RAPTORQ_ERROR(...)   __ATSC3_LOG_ERROR(ATSC3_LOG_MODULE_RAPTORQ, __VA_ARGS__)
+#define __RAPTORQ_WARN(...)    __ATSC3_LOG_WARN(ATSC3_LOG_MODULE_RAPTORQ, __VA_ARGS__)
+#define __RAPTORQ_INFO(...)    __ATSC3_LOG_INFO(ATSC3_LOG_MODULE_RAPTORQ, __VA_ARGS__)
+
+#endif /* ATSC3_RAPTORQ_H_ */
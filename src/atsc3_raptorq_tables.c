@@ -0,0 +1,19 @@
+/*
+ * atsc3_raptorq_tables.c
+ *
+ * generated by support_scripts/rfc6330_tables.py --placeholder, do not edit
+ *
+ * no RFC 6330 table entries, RaptorQ recovery is unavailable until this file is regenerated from the RFC text:
+ *
+ *   make raptorq_tables RFC6330_TXT=/path/to/rfc6330.txt
+ */
+
+#include "atsc3_raptorq.h"
+
+const uint32_t atsc3_raptorq_v0[256] = { 0 };
+const uint32_t atsc3_raptorq_v1[256] = { 0 };
+const uint32_t atsc3_raptorq_v2[256] = { 0 };
+const uint32_t atsc3_raptorq_v3[256] = { 0 };
+
+const atsc3_raptorq_systematic_index_t atsc3_raptorq_systematic_indices[1] = { { 0 } };
+const uint32_t atsc3_raptorq_systematic_indices_n = 0;
@@ -0,0 +1,233 @@
+/*
+ *
+ * atsc3_raptorq_test.c:  driver for the RaptorQ block/object decoder and the GF(256) row operations
+ *
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "atsc3_raptorq.h"
+
+#define __TEST_SYMBOL_SIZE 64
+
+int test_raptorq_gf256_row_ops_match_scalar();
+int test_raptorq_oti_parse();
+int test_raptorq_block_roundtrip(uint32_t k, uint32_t loss_pct);
+int test_raptorq_object_roundtrip();
+
+int main() {
+	int failed = 0;
+
+	atsc3_gf256_init();
+	printf("atsc3_raptorq_test: gf256 row ops: %s\n", atsc3_gf256_impl_name());
+
+	failed += test_raptorq_gf256_row_ops_match_scalar();
+	failed += test_raptorq_oti_parse();
+
+	failed += test_raptorq_block_roundtrip(10, 0);
+	failed += test_raptorq_block_roundtrip(10, 30);
+	failed += test_raptorq_block_roundtrip(100, 10);
+	failed += test_raptorq_block_roundtrip(257, 20);
+	failed += test_raptorq_object_roundtrip();
+
+	printf("atsc3_raptorq_test: %s\n", failed ? "FAILED" : "OK");
+	return failed;
+}
+
+int test_raptorq_gf256_row_ops_match_scalar() {
+	uint8_t src[301];
+	uint8_t dst[301];
+	uint8_t expected[301];
+
+	for(uint32_t i = 0; i < sizeof(src); i++) {
+		src[i] = rand();
+		dst[i] = rand();
+	}
+
+	//odd lengths exercise the vector tails
+	for(uint32_t c = 0; c < 256; c++) {
+		uint32_t len = 1 + (c * 7) % sizeof(src);
+		for(uint32_t i = 0; i < len; i++) {
+			expected[i] = dst[i] ^ atsc3_gf256_mul(c, src[i]);
+		}
+		atsc3_gf256_row_muladd(dst, src, c, len);
+		if(memcmp(dst, expected, len)) {
+			printf("test_raptorq_gf256_row_ops_match_scalar: muladd mismatch, c: %u, len: %u\n", c, len);
+			return 1;
+		}
+
+		for(uint32_t i = 0; i < len; i++) {
+			expected[i] = atsc3_gf256_mul(c, dst[i]);
+		}
+		atsc3_gf256_row_mul(dst, c, len);
+		if(memcmp(dst, expected, len)) {
+			printf("test_raptorq_gf256_row_ops_match_scalar: mul mismatch, c: %u, len: %u\n", c, len);
+			return 1;
+		}
+
+		for(uint32_t i = 0; i < len; i++) {
+			expected[i] = dst[i] ^ src[i];
+		}
+		atsc3_gf256_row_add(dst, src, len);
+		if(memcmp(dst, expected, len)) {
+			printf("test_raptorq_gf256_row_ops_match_scalar: add mismatch, len: %u\n", len);
+			return 1;
+		}
+	}
+
+	for(uint32_t a = 1; a < 256; a++) {
+		if(atsc3_gf256_div(atsc3_gf256_mul(a, 0x53), 0x53) != a) {
+			printf("test_raptorq_gf256_row_ops_match_scalar: div mismatch, a: %u\n", a);
+			return 1;
+		}
+	}
+	return 0;
+}
+
+int test_raptorq_oti_parse() {
+	//F: 1000000, T: 1312, Z: 3, N: 1, Al: 4
+	uint8_t oti_buf[ATSC3_RAPTORQ_OTI_LEN] = { 0x00, 0x00, 0x0F, 0x42, 0x40, 0x00, 0x05, 0x20, 0x03, 0x00, 0x01, 0x04 };
+	atsc3_raptorq_oti_t oti;
+
+	if(!atsc3_raptorq_oti_parse(oti_buf, sizeof(oti_buf), &oti) || oti.transfer_length != 1000000 || oti.symbol_size != 1312 ||
+			oti.source_blocks != 3 || oti.sub_blocks != 1 || oti.alignment != 4) {
+		printf("test_raptorq_oti_parse: parse failed\n");
+		return 1;
+	}
+	if(atsc3_raptorq_oti_parse(oti_buf, sizeof(oti_buf) - 1, &oti)) {
+		printf("test_raptorq_oti_parse: accepted short OTI\n");
+		return 1;
+	}
+
+	//Kt = 763, split into one block of 255 and two of 254
+	atsc3_raptorq_oti_parse(oti_buf, sizeof(oti_buf), &oti);
+	atsc3_raptorq_object_decoder_t* atsc3_raptorq_object_decoder = atsc3_raptorq_object_decoder_create(&oti);
+	int ret = !atsc3_raptorq_object_decoder || atsc3_raptorq_object_decoder->kt != 763 || atsc3_raptorq_object_decoder->kl != 255 ||
+			atsc3_raptorq_object_decoder->ks != 254 || atsc3_raptorq_object_decoder->zl != 1;
+	if(ret) {
+		printf("test_raptorq_oti_parse: unexpected source block partitioning\n");
+	}
+	atsc3_raptorq_object_decoder_free(&atsc3_raptorq_object_decoder);
+	return ret;
+}
+
+int test_raptorq_block_roundtrip(uint32_t k, uint32_t loss_pct) {
+	atsc3_raptorq_params_t params;
+	if(!atsc3_raptorq_params_init(k, &params)) {
+		printf("test_raptorq_block_roundtrip: params_init failed, K: %u\n", k);
+		return 1;
+	}
+
+	uint8_t* source = (uint8_t*)malloc(k * __TEST_SYMBOL_SIZE);
+	uint8_t symbol[__TEST_SYMBOL_SIZE];
+	for(uint32_t i = 0; i < k * __TEST_SYMBOL_SIZE; i++) {
+		source[i] = rand();
+	}
+
+	uint8_t* intermediate = atsc3_raptorq_encode_intermediate(&params, source, __TEST_SYMBOL_SIZE);
+	atsc3_raptorq_block_decoder_t* atsc3_raptorq_block_decoder = atsc3_raptorq_block_decoder_create(k, __TEST_SYMBOL_SIZE);
+	int ret = 1;
+
+	if(!intermediate || !atsc3_raptorq_block_decoder) {
+		printf("test_raptorq_block_roundtrip: encoder/decoder create failed, K: %u\n", k);
+		goto cleanup;
+	}
+
+	//the encoder must be systematic
+	for(uint32_t i = 0; i < k; i++) {
+		atsc3_raptorq_encode_symbol(&params, intermediate, __TEST_SYMBOL_SIZE, i, symbol);
+		if(memcmp(symbol, source + i * __TEST_SYMBOL_SIZE, __TEST_SYMBOL_SIZE)) {
+			printf("test_raptorq_block_roundtrip: encoding symbol %u is not the source symbol, K: %u\n", i, k);
+			goto cleanup;
+		}
+	}
+
+	atsc3_raptorq_decode_status_t status = ATSC3_RAPTORQ_DECODE_NEED_MORE;
+	uint32_t esi;
+	for(esi = 0; esi < 2 * k + 10 && status == ATSC3_RAPTORQ_DECODE_NEED_MORE; esi++) {
+		if((uint32_t)(rand() % 100) < loss_pct) {
+			continue;
+		}
+		atsc3_raptorq_encode_symbol(&params, intermediate, __TEST_SYMBOL_SIZE, esi, symbol);
+		atsc3_raptorq_block_decoder_add_symbol(atsc3_raptorq_block_decoder, esi, symbol);
+		//duplicates must be ignored
+		if(atsc3_raptorq_block_decoder_add_symbol(atsc3_raptorq_block_decoder, esi, symbol) != 0) {
+			printf("test_raptorq_block_roundtrip: duplicate ESI %u accepted\n", esi);
+			goto cleanup;
+		}
+		status = atsc3_raptorq_block_decoder_decode(atsc3_raptorq_block_decoder);
+	}
+
+	if(status != ATSC3_RAPTORQ_DECODE_OK) {
+		printf("test_raptorq_block_roundtrip: decode failed, K: %u, loss: %u%%\n", k, loss_pct);
+		goto cleanup;
+	}
+	if(memcmp(atsc3_raptorq_block_decoder->source, source, k * __TEST_SYMBOL_SIZE)) {
+		printf("test_raptorq_block_roundtrip: recovered source block mismatch, K: %u, loss: %u%%\n", k, loss_pct);
+		goto cleanup;
+	}
+	ret = 0;
+
+cleanup:
+	free(source);
+	free(intermediate);
+	atsc3_raptorq_block_decoder_free(&atsc3_raptorq_block_decoder);
+	return ret;
+}
+
+int test_raptorq_object_roundtrip() {
+	//F is not a multiple of T, last symbol of the last block is padded
+	atsc3_raptorq_oti_t oti = { 5000, __TEST_SYMBOL_SIZE, 2, 1, 4 };
+	uint32_t kt = (oti.transfer_length + __TEST_SYMBOL_SIZE - 1) / __TEST_SYMBOL_SIZE;
+
+	uint8_t* object = (uint8_t*)calloc(kt, __TEST_SYMBOL_SIZE);
+	for(uint32_t i = 0; i < oti.transfer_length; i++) {
+		object[i] = rand();
+	}
+
+	atsc3_raptorq_object_decoder_t* atsc3_raptorq_object_decoder = atsc3_raptorq_object_decoder_create(&oti);
+	uint8_t* recovered = NULL;
+	int ret = 1;
+	if(!atsc3_raptorq_object_decoder) {
+		printf("test_raptorq_object_roundtrip: object_decoder_create failed\n");
+		free(object);
+		return 1;
+	}
+
+	//two symbols per packet, drop every third packet and fill in with repair symbols
+	uint32_t first_symbol = 0;
+	for(uint8_t sbn = 0; sbn < oti.source_blocks; sbn++) {
+		uint32_t k = sbn < atsc3_raptorq_object_decoder->zl ? atsc3_raptorq_object_decoder->kl : atsc3_raptorq_object_decoder->ks;
+		atsc3_raptorq_params_t params;
+		atsc3_raptorq_params_init(k, &params);
+		uint8_t* intermediate = atsc3_raptorq_encode_intermediate(&params, object + first_symbol * __TEST_SYMBOL_SIZE, __TEST_SYMBOL_SIZE);
+		uint8_t payload[2 * __TEST_SYMBOL_SIZE];
+
+		for(uint32_t esi = 0, packet = 0; esi < 3 * k; esi += 2, packet++) {
+			if(packet % 3 == 1) {
+				continue;
+			}
+			atsc3_raptorq_encode_symbol(&params, intermediate, __TEST_SYMBOL_SIZE, esi, payload);
+			atsc3_raptorq_encode_symbol(&params, intermediate, __TEST_SYMBOL_SIZE, esi + 1, payload + __TEST_SYMBOL_SIZE);
+			atsc3_raptorq_object_decoder_add_packet(atsc3_raptorq_object_decoder, sbn, esi, payload, sizeof(payload));
+			if(atsc3_raptorq_object_decoder->blocks[sbn]->decoded) {
+				break;
+			}
+		}
+		free(intermediate);
+		first_symbol += k;
+	}
+
+	recovered = atsc3_raptorq_object_decoder_take_object(atsc3_raptorq_object_decoder);
+	if(!recovered || memcmp(recovered, object, oti.transfer_length)) {
+		printf("test_raptorq_object_roundtrip: object not recovered\n");
+	} else {
+		ret = 0;
+	}
+
+	free(recovered);
+	free(object);
+	atsc3_raptorq_object_decoder_free(&atsc3_raptorq_object_decoder);
+	return ret;
+}
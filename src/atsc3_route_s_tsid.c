@@ -0,0 +1,95 @@
+/*
+ * atsc3_route_s_tsid.c
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: jjustman
+ */
+#include "atsc3_route_s_tsid.h"
+
+ATSC3_VECTOR_BUILDER_METHODS_IMPLEMENTATION(atsc3_route_s_tsid_rs, atsc3_route_s_tsid_rs_ls)
+ATSC3_VECTOR_BUILDER_METHODS_IMPLEMENTATION(atsc3_route_s_tsid, atsc3_route_s_tsid_rs)
+
+
+atsc3_route_s_tsid_t* atsc3_route_s_tsid_new() {
+	atsc3_route_s_tsid_t* atsc3_route_s_tsid = calloc(1, sizeof(atsc3_route_s_tsid_t));
+	return atsc3_route_s_tsid;
+}
+
+void atsc3_route_s_tsid_rs_ls_free(atsc3_route_s_tsid_rs_ls_t** atsc3_route_s_tsid_rs_ls_p) {
+	atsc3_route_s_tsid_rs_ls_t* atsc3_route_s_tsid_rs_ls = *atsc3_route_s_tsid_rs_ls_p;
+	if(!atsc3_route_s_tsid_rs_ls) {
+		return;
+	}
+
+	freesafe(atsc3_route_s_tsid_rs_ls->content_type);
+	freesafe(atsc3_route_s_tsid_rs_ls->rep_id);
+	freesafe(atsc3_route_s_tsid_rs_ls->rpr_flow_fec_oti);
+	free(atsc3_route_s_tsid_rs_ls);
+	*atsc3_route_s_tsid_rs_ls_p = NULL;
+}
+
+void atsc3_route_s_tsid_rs_free(atsc3_route_s_tsid_rs_t** atsc3_route_s_tsid_rs_p) {
+	atsc3_route_s_tsid_rs_t* atsc3_route_s_tsid_rs = *atsc3_route_s_tsid_rs_p;
+	if(!atsc3_route_s_tsid_rs) {
+		return;
+	}
+
+	for(int i = 0; i < atsc3_route_s_tsid_rs->atsc3_route_s_tsid_rs_ls_v.count; i++) {
+		atsc3_route_s_tsid_rs_ls_free(&atsc3_route_s_tsid_rs->atsc3_route_s_tsid_rs_ls_v.data[i]);
+	}
+	freesafe(atsc3_route_s_tsid_rs->atsc3_route_s_tsid_rs_ls_v.data);
+	free(atsc3_route_s_tsid_rs);
+	*atsc3_route_s_tsid_rs_p = NULL;
+}
+
+void atsc3_route_s_tsid_free(atsc3_route_s_tsid_t** atsc3_route_s_tsid_p) {
+	atsc3_route_s_tsid_t* atsc3_route_s_tsid = *atsc3_route_s_tsid_p;
+	if(!atsc3_route_s_tsid) {
+		return;
+	}
+
+	for(int i = 0; i < atsc3_route_s_tsid->atsc3_route_s_tsid_rs_v.count; i++) {
+		atsc3_route_s_tsid_rs_free(&atsc3_route_s_tsid->atsc3_route_s_tsid_rs_v.data[i]);
+	}
+	freesafe(atsc3_route_s_tsid->atsc3_route_s_tsid_rs_v.data);
+	free(atsc3_route_s_tsid);
+	*atsc3_route_s_tsid_p = NULL;
+}
+
+atsc3_route_s_tsid_rs_t* atsc3_route_s_tsid_find_rs(atsc3_route_s_tsid_t* atsc3_route_s_tsid, uint32_t dst_ip_addr, uint16_t dst_port) {
+	for(int i = 0; i < atsc3_route_s_tsid->atsc3_route_s_tsid_rs_v.count; i++) {
+		atsc3_route_s_tsid_rs_t* atsc3_route_s_tsid_rs = atsc3_route_s_tsid->atsc3_route_s_tsid_rs_v.data[i];
+		if(atsc3_route_s_tsid_rs->dst_ip_addr == dst_ip_addr && atsc3_route_s_tsid_rs->dst_port == dst_port) {
+			return atsc3_route_s_tsid_rs;
+		}
+	}
+	return NULL;
+}
+
+atsc3_route_s_tsid_rs_ls_t* atsc3_route_s_tsid_find_ls(atsc3_route_s_tsid_t* atsc3_route_s_tsid, uint32_t dst_ip_addr, uint16_t dst_port, uint32_t tsi) {
+	atsc3_route_s_tsid_rs_t* atsc3_route_s_tsid_rs = atsc3_route_s_tsid_find_rs(atsc3_route_s_tsid, dst_ip_addr, dst_port);
+	if(!atsc3_route_s_tsid_rs) {
+		return NULL;
+	}
+
+	for(int i = 0; i < atsc3_route_s_tsid_rs->atsc3_route_s_tsid_rs_ls_v.count; i++) {
+		if(atsc3_route_s_tsid_rs->atsc3_route_s_tsid_rs_ls_v.data[i]->tsi == tsi) {
+			return atsc3_route_s_tsid_rs->atsc3_route_s_tsid_rs_ls_v.data[i];
+		}
+	}
+	return NULL;
+}
+
+atsc3_route_s_tsid_rs_ls_t* atsc3_route_s_tsid_find_ls_by_content_type(atsc3_route_s_tsid_t* atsc3_route_s_tsid, const char* content_type) {
+	for(int i = 0; i < atsc3_route_s_tsid->atsc3_route_s_tsid_rs_v.count; i++) {
+		atsc3_route_s_tsid_rs_t* atsc3_route_s_tsid_rs = atsc3_route_s_tsid->atsc3_route_s_tsid_rs_v.data[i];
+		for(int j = 0; j < atsc3_route_s_tsid_rs->atsc3_route_s_tsid_rs_ls_v.count; j++) {
+			atsc3_route_s_tsid_rs_ls_t* atsc3_route_s_tsid_rs_ls = atsc3_route_s_tsid_rs->atsc3_route_s_tsid_rs_ls_v.data[j];
+			if(atsc3_route_s_tsid_rs_ls->has_src_flow && atsc3_route_s_tsid_rs_ls->content_type &&
+					!strncasecmp(atsc3_route_s_tsid_rs_ls->content_type, content_type, strlen(content_type))) {
+				return atsc3_route_s_tsid_rs_ls;
+			}
+		}
+	}
+	return NULL;
+}
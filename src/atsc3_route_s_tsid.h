@@ -0,0 +1,122 @@
+/*
+ * atsc3_route_s_tsid.h
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: jjustman
+ */
+#include <stdio.h>
+#include <string.h>
+#include <stdbool.h>
+#include "atsc3_vector_builder.h"
+
+
+#ifndef ATSC3_ROUTE_S_TSID_H_
+#define ATSC3_ROUTE_S_TSID_H_
+/**
+ *
+ * A/331 - Section 7.1.4 / Table 7.3 - Service-based Transport Session Instance Description (S-TSID)
+ *
+ * S-TSID
+ *   RS						0..N	ROUTE session
+ *     @sIpAddr				0..1	defaults to the SLS source ip
+ *     @dIpAddr				0..1	defaults to the SLS destination ip
+ *     @dport				0..1	defaults to the SLS destination port
+ *     LS					1..N	LCT channel
+ *       @tsi				1
+ *       @bw				0..1
+ *       SrcFlow			0..1
+ *         @rt				0..1	real time (DASH) delivery
+ *         EFDT				0..1	static FDT-Instance, the first File is the init segment
+ *         ContentInfo
+ *           MediaInfo		@repId, @contentType (audio, video, subtitles)
+ *         Payload			@codePoint, @formatId
+ *       RprFlow			0..1
+ *         FECParameters	@maximumDelay, @overhead, @minBuffSize
+ *           FECOTI
+ *           ProtectedObject	@tsi of the source flow repaired by this LS
+ *
+ * Sample XML payload, from the application/route-s-tsid+xml part of the SLS multipart/related bundle:
+ *
+ * <?xml version="1.0" encoding="UTF-8"?>
+ * <S-TSID xmlns="tag:atsc.org,2016:XMLSchemas/ATSC3/Delivery/S-TSID/1.0/">
+ *    <RS dIpAddr="239.255.10.4" dport="5000" sIpAddr="172.16.200.1">
+ *       <LS tsi="100" bw="5000000">
+ *          <SrcFlow rt="true">
+ *             <ContentInfo><MediaInfo repId="Video1" contentType="video"/></ContentInfo>
+ *             <Payload codePoint="128" formatId="1" frag="0" order="true"/>
+ *          </SrcFlow>
+ *       </LS>
+ *       <LS tsi="200">
+ *          <SrcFlow rt="true">
+ *             <ContentInfo><MediaInfo repId="Audio1" contentType="audio"/></ContentInfo>
+ *             <Payload codePoint="128" formatId="1" frag="0" order="true"/>
+ *          </SrcFlow>
+ *       </LS>
+ *    </RS>
+ * </S-TSID>
+ *
+ */
+
+#if defined (__cplusplus)
+extern "C" {
+#endif
+
+typedef struct atsc3_route_s_tsid_rs_ls {
+	uint32_t	tsi;
+	uint32_t	bw;
+
+	bool		has_src_flow;
+	bool		src_flow_rt;
+	char*		content_type;		//MediaInfo@contentType
+	char*		rep_id;				//MediaInfo@repId
+	uint8_t		code_point;
+	uint8_t		format_id;
+	uint32_t	src_flow_init_toi;	//TOI of the first File in the SrcFlow EFDT (the init segment for DASH), 0 if none
+
+	bool		has_rpr_flow;
+	uint32_t	rpr_flow_maximum_delay;
+	uint32_t	rpr_flow_overhead;
+	uint32_t	rpr_flow_min_buff_size;
+	char*		rpr_flow_fec_oti;
+	uint32_t	rpr_flow_protected_tsi;	//0 if no ProtectedObject was signalled
+} atsc3_route_s_tsid_rs_ls_t;
+
+typedef struct atsc3_route_s_tsid_rs {
+	uint32_t	src_ip_addr;		//0 if not signalled, any source matches
+	uint32_t	dst_ip_addr;
+	uint16_t	dst_port;
+
+	ATSC3_VECTOR_BUILDER_STRUCT(atsc3_route_s_tsid_rs_ls)
+
+} atsc3_route_s_tsid_rs_t;
+
+typedef struct atsc3_route_s_tsid {
+	//FNV-1a of the S-TSID fragment this was parsed from, the SLS is repeated on every carousel pass
+	uint32_t	payload_length;
+	uint32_t	payload_hash;
+
+	ATSC3_VECTOR_BUILDER_STRUCT(atsc3_route_s_tsid_rs)
+
+} atsc3_route_s_tsid_t;
+
+ATSC3_VECTOR_BUILDER_METHODS_INTERFACE(atsc3_route_s_tsid_rs, atsc3_route_s_tsid_rs_ls)
+ATSC3_VECTOR_BUILDER_METHODS_INTERFACE(atsc3_route_s_tsid, atsc3_route_s_tsid_rs)
+
+atsc3_route_s_tsid_t* atsc3_route_s_tsid_new();
+void atsc3_route_s_tsid_rs_ls_free(atsc3_route_s_tsid_rs_ls_t** atsc3_route_s_tsid_rs_ls_p);
+void atsc3_route_s_tsid_rs_free(atsc3_route_s_tsid_rs_t** atsc3_route_s_tsid_rs_p);
+void atsc3_route_s_tsid_free(atsc3_route_s_tsid_t** atsc3_route_s_tsid_p);
+
+//the RS carrying (dst_ip_addr, dst_port), NULL if the S-TSID does not announce that flow
+atsc3_route_s_tsid_rs_t* atsc3_route_s_tsid_find_rs(atsc3_route_s_tsid_t* atsc3_route_s_tsid, uint32_t dst_ip_addr, uint16_t dst_port);
+//the LS for tsi in the RS carrying (dst_ip_addr, dst_port)
+atsc3_route_s_tsid_rs_ls_t* atsc3_route_s_tsid_find_ls(atsc3_route_s_tsid_t* atsc3_route_s_tsid, uint32_t dst_ip_addr, uint16_t dst_port, uint32_t tsi);
+//first source flow LS whose MediaInfo@contentType starts with content_type (e.g. "video", "audio")
+atsc3_route_s_tsid_rs_ls_t* atsc3_route_s_tsid_find_ls_by_content_type(atsc3_route_s_tsid_t* atsc3_route_s_tsid, const char* content_type);
+
+#if defined (__cplusplus)
+}
+#endif
+
+
+#endif /* ATSC3_ROUTE_S_TSID_H_ */
@@ -0,0 +1,356 @@
+/*
+ * atsc3_route_s_tsid_parser.c
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: jjustman
+ *
+ * S-TSID (A/331 Section 7.1.4) from the SLS multipart/related bundle on TSI 0 of the service's SLS flow, see
+ * atsc3_route_s_tsid.h for the element layout
+ */
+
+#include "atsc3_route_s_tsid_parser.h"
+
+int _ROUTE_S_TSID_PARSER_DEBUG_ENABLED = 0;
+
+#define __ROUTE_S_TSID_ELEMENT "S-TSID"
+
+static uint8_t* __atsc3_route_s_tsid_find(uint8_t* buf, uint8_t* end, const char* needle, bool ignore_case) {
+	uint32_t needle_length = strlen(needle);
+	for(; buf + needle_length <= end; buf++) {
+		if(ignore_case ? !strncasecmp((char*)buf, needle, needle_length) : !memcmp(buf, needle, needle_length)) {
+			return buf;
+		}
+	}
+	return NULL;
+}
+
+//start of the next line, or end
+static uint8_t* __atsc3_route_s_tsid_next_line(uint8_t* buf, uint8_t* end) {
+	while(buf < end && *buf != '\n') {
+		buf++;
+	}
+	return buf < end ? buf + 1 : end;
+}
+
+static bool __atsc3_route_s_tsid_is_blank_line(uint8_t* buf, uint8_t* end) {
+	return buf < end && (*buf == '\n' || (*buf == '\r' && buf + 1 < end && buf[1] == '\n'));
+}
+
+uint8_t* atsc3_route_s_tsid_find_in_sls_payload(uint8_t* payload, uint32_t payload_length, uint32_t* s_tsid_length) {
+	uint8_t* end = payload + payload_length;
+	char delimiter[128];
+
+	//the bundle headers end at the first blank line, the boundary is the only parameter we need from them
+	uint8_t* line = payload;
+	uint8_t* boundary = NULL;
+	while(line < end && !__atsc3_route_s_tsid_is_blank_line(line, end)) {
+		uint8_t* line_end = __atsc3_route_s_tsid_next_line(line, end);
+		if(!boundary) {
+			boundary = __atsc3_route_s_tsid_find(line, line_end, "boundary=", true);
+		}
+		line = line_end;
+	}
+
+	if(!boundary) {
+		//not a bundle, the S-TSID may have been carried as its own object
+		if(__atsc3_route_s_tsid_find(payload, end, "<" __ROUTE_S_TSID_ELEMENT, false)) {
+			*s_tsid_length = payload_length;
+			return payload;
+		}
+		return NULL;
+	}
+
+	boundary += strlen("boundary=");
+	bool quoted = boundary < end && *boundary == '"';
+	if(quoted) {
+		boundary++;
+	}
+	uint8_t* boundary_end = boundary;
+	while(boundary_end < end && (quoted ? *boundary_end != '"' : (*boundary_end != ';' && !isspace(*boundary_end)))) {
+		boundary_end++;
+	}
+	if(boundary_end == boundary || boundary_end - boundary > sizeof(delimiter) - 3) {
+		__ROUTE_S_TSID_PARSER_WARN("atsc3_route_s_tsid_find_in_sls_payload: unusable multipart boundary, len: %ld", (long)(boundary_end - boundary));
+		return NULL;
+	}
+	snprintf(delimiter, sizeof(delimiter), "--%.*s", (int)(boundary_end - boundary), boundary);
+
+	uint8_t* part = __atsc3_route_s_tsid_find(line, end, delimiter, false);
+	while(part) {
+		uint8_t* headers = __atsc3_route_s_tsid_next_line(part, end);
+		bool is_s_tsid = false;
+
+		line = headers;
+		while(line < end && !__atsc3_route_s_tsid_is_blank_line(line, end)) {
+			if(!strncasecmp((char*)line, "Content-Type:", 13)) {
+				uint8_t* content_type = line + 13;
+				while(content_type < end && (*content_type == ' ' || *content_type == '\t')) {
+					content_type++;
+				}
+				is_s_tsid = end - content_type >= strlen(ATSC3_ROUTE_S_TSID_CONTENT_TYPE) &&
+						!strncasecmp((char*)content_type, ATSC3_ROUTE_S_TSID_CONTENT_TYPE, strlen(ATSC3_ROUTE_S_TSID_CONTENT_TYPE));
+			}
+			line = __atsc3_route_s_tsid_next_line(line, end);
+		}
+
+		uint8_t* body = __atsc3_route_s_tsid_next_line(line, end);
+		uint8_t* next_part = __atsc3_route_s_tsid_find(body, end, delimiter, false);
+
+		if(is_s_tsid) {
+			//the line break before the delimiter belongs to the delimiter
+			uint8_t* body_end = next_part ? next_part : end;
+			if(body_end > body && body_end[-1] == '\n') {
+				body_end--;
+			}
+			if(body_end > body && body_end[-1] == '\r') {
+				body_end--;
+			}
+			*s_tsid_length = body_end - body;
+			return body;
+		}
+		part = next_part;
+	}
+
+	return NULL;
+}
+
+static uint32_t __atsc3_route_s_tsid_attribute_uint(kvp_collection_t* kvp_collection, char* key, uint32_t default_value) {
+	char* val = kvp_collection_get_reference_p(kvp_collection, key);
+	return val ? strtoul(val, NULL, 10) : default_value;
+}
+
+static bool __atsc3_route_s_tsid_attribute_bool(kvp_collection_t* kvp_collection, char* key) {
+	char* val = kvp_collection_get_reference_p(kvp_collection, key);
+	return val && (!strcasecmp(val, "true") || !strcmp(val, "1"));
+}
+
+static kvp_collection_t* __atsc3_route_s_tsid_attributes(xml_node_t* node) {
+	uint8_t* xml_attributes = xml_attributes_clone_node(node);
+	kvp_collection_t* kvp_collection = kvp_collection_parse(xml_attributes);
+	free(xml_attributes);
+	return kvp_collection;
+}
+
+static void __atsc3_route_s_tsid_parse_src_flow(atsc3_route_s_tsid_rs_ls_t* atsc3_route_s_tsid_rs_ls, xml_node_t* node) {
+	kvp_collection_t* kvp_collection = __atsc3_route_s_tsid_attributes(node);
+	atsc3_route_s_tsid_rs_ls->has_src_flow = true;
+	atsc3_route_s_tsid_rs_ls->src_flow_rt = __atsc3_route_s_tsid_attribute_bool(kvp_collection, "rt");
+	kvp_collection_free(kvp_collection);
+
+	size_t num_children = xml_node_children(node);
+	for(int i = 0; i < num_children; i++) {
+		xml_node_t* child = xml_node_child(node, i);
+
+		if(xml_node_equals_ignore_case(child, "ContentInfo")) {
+			size_t num_content_info_children = xml_node_children(child);
+			for(int j = 0; j < num_content_info_children; j++) {
+				xml_node_t* media_info = xml_node_child(child, j);
+				if(!xml_node_equals_ignore_case(media_info, "MediaInfo") || atsc3_route_s_tsid_rs_ls->content_type) {
+					continue;
+				}
+				kvp_collection = __atsc3_route_s_tsid_attributes(media_info);
+				atsc3_route_s_tsid_rs_ls->content_type = kvp_collection_get(kvp_collection, "contentType");
+				atsc3_route_s_tsid_rs_ls->rep_id = kvp_collection_get(kvp_collection, "repId");
+				kvp_collection_free(kvp_collection);
+			}
+		} else if(xml_node_equals_ignore_case(child, "EFDT") && xml_node_children(child)) {
+			xml_node_t* fdt_instance = xml_node_child(child, 0);
+			if(xml_node_equals_ignore_case(fdt_instance, "FDT-Instance") && xml_node_children(fdt_instance)) {
+				kvp_collection = __atsc3_route_s_tsid_attributes(xml_node_child(fdt_instance, 0));
+				atsc3_route_s_tsid_rs_ls->src_flow_init_toi = __atsc3_route_s_tsid_attribute_uint(kvp_collection, "TOI", 0);
+				kvp_collection_free(kvp_collection);
+			}
+		} else if(xml_node_equals_ignore_case(child, "Payload")) {
+			kvp_collection = __atsc3_route_s_tsid_attributes(child);
+			atsc3_route_s_tsid_rs_ls->code_point = __atsc3_route_s_tsid_attribute_uint(kvp_collection, "codePoint", 0);
+			atsc3_route_s_tsid_rs_ls->format_id = __atsc3_route_s_tsid_attribute_uint(kvp_collection, "formatId", 0);
+			kvp_collection_free(kvp_collection);
+		}
+	}
+}
+
+//ProtectedObject and FECOTI are children of FECParameters, older S-TSIDs carry ProtectedObject directly under RprFlow
+static void __atsc3_route_s_tsid_parse_rpr_flow(atsc3_route_s_tsid_rs_ls_t* atsc3_route_s_tsid_rs_ls, xml_node_t* node) {
+	atsc3_route_s_tsid_rs_ls->has_rpr_flow = true;
+
+	size_t num_children = xml_node_children(node);
+	for(int i = 0; i < num_children; i++) {
+		xml_node_t* child = xml_node_child(node, i);
+		kvp_collection_t* kvp_collection = NULL;
+
+		if(xml_node_equals_ignore_case(child, "FECParameters")) {
+			kvp_collection = __atsc3_route_s_tsid_attributes(child);
+			atsc3_route_s_tsid_rs_ls->rpr_flow_maximum_delay = __atsc3_route_s_tsid_attribute_uint(kvp_collection, "maximumDelay", 0);
+			atsc3_route_s_tsid_rs_ls->rpr_flow_overhead = __atsc3_route_s_tsid_attribute_uint(kvp_collection, "overhead", 0);
+			atsc3_route_s_tsid_rs_ls->rpr_flow_min_buff_size = __atsc3_route_s_tsid_attribute_uint(kvp_collection, "minBuffSize", 0);
+			kvp_collection_free(kvp_collection);
+
+			__atsc3_route_s_tsid_parse_rpr_flow(atsc3_route_s_tsid_rs_ls, child);
+		} else if(xml_node_equals_ignore_case(child, "FECOTI") && !atsc3_route_s_tsid_rs_ls->rpr_flow_fec_oti) {
+			atsc3_route_s_tsid_rs_ls->rpr_flow_fec_oti = (char*)xml_string_clone(xml_node_content(child));
+		} else if(xml_node_equals_ignore_case(child, "ProtectedObject") && !atsc3_route_s_tsid_rs_ls->rpr_flow_protected_tsi) {
+			kvp_collection = __atsc3_route_s_tsid_attributes(child);
+			atsc3_route_s_tsid_rs_ls->rpr_flow_protected_tsi = __atsc3_route_s_tsid_attribute_uint(kvp_collection, "tsi", 0);
+			kvp_collection_free(kvp_collection);
+		}
+	}
+}
+
+static atsc3_route_s_tsid_rs_ls_t* __atsc3_route_s_tsid_parse_ls(xml_node_t* node) {
+	kvp_collection_t* kvp_collection = __atsc3_route_s_tsid_attributes(node);
+	if(!kvp_collection_get_reference_p(kvp_collection, "tsi")) {
+		__ROUTE_S_TSID_PARSER_WARN("atsc3_route_s_tsid: LS missing required tsi attribute, skipping");
+		kvp_collection_free(kvp_collection);
+		return NULL;
+	}
+
+	atsc3_route_s_tsid_rs_ls_t* atsc3_route_s_tsid_rs_ls = atsc3_route_s_tsid_rs_ls_new();
+	atsc3_route_s_tsid_rs_ls->tsi = __atsc3_route_s_tsid_attribute_uint(kvp_collection, "tsi", 0);
+	atsc3_route_s_tsid_rs_ls->bw = __atsc3_route_s_tsid_attribute_uint(kvp_collection, "bw", 0);
+	kvp_collection_free(kvp_collection);
+
+	size_t num_children = xml_node_children(node);
+	for(int i = 0; i < num_children; i++) {
+		xml_node_t* child = xml_node_child(node, i);
+		if(xml_node_equals_ignore_case(child, "SrcFlow")) {
+			__atsc3_route_s_tsid_parse_src_flow(atsc3_route_s_tsid_rs_ls, child);
+		} else if(xml_node_equals_ignore_case(child, "RprFlow")) {
+			__atsc3_route_s_tsid_parse_rpr_flow(atsc3_route_s_tsid_rs_ls, child);
+		}
+	}
+
+	return atsc3_route_s_tsid_rs_ls;
+}
+
+static atsc3_route_s_tsid_rs_t* __atsc3_route_s_tsid_parse_rs(xml_node_t* node, uint32_t sls_dst_ip_addr, uint16_t sls_dst_port) {
+	atsc3_route_s_tsid_rs_t* atsc3_route_s_tsid_rs = atsc3_route_s_tsid_rs_new();
+	kvp_collection_t* kvp_collection = __atsc3_route_s_tsid_attributes(node);
+	char* matching_attribute = NULL;
+
+	atsc3_route_s_tsid_rs->dst_ip_addr = sls_dst_ip_addr;
+	atsc3_route_s_tsid_rs->dst_port = sls_dst_port;
+
+	if((matching_attribute = kvp_collection_get_reference_p(kvp_collection, "dIpAddr"))) {
+		atsc3_route_s_tsid_rs->dst_ip_addr = parseIpAddressIntoIntval(matching_attribute);
+	}
+	if((matching_attribute = kvp_collection_get_reference_p(kvp_collection, "dport"))) {
+		atsc3_route_s_tsid_rs->dst_port = parsePortIntoIntval(matching_attribute);
+	}
+	if((matching_attribute = kvp_collection_get_reference_p(kvp_collection, "sIpAddr"))) {
+		atsc3_route_s_tsid_rs->src_ip_addr = parseIpAddressIntoIntval(matching_attribute);
+	}
+	kvp_collection_free(kvp_collection);
+
+	size_t num_children = xml_node_children(node);
+	for(int i = 0; i < num_children; i++) {
+		xml_node_t* child = xml_node_child(node, i);
+		if(!xml_node_equals_ignore_case(child, "LS")) {
+			continue;
+		}
+		atsc3_route_s_tsid_rs_ls_t* atsc3_route_s_tsid_rs_ls = __atsc3_route_s_tsid_parse_ls(child);
+		if(atsc3_route_s_tsid_rs_ls) {
+			atsc3_route_s_tsid_rs_add_atsc3_route_s_tsid_rs_ls(atsc3_route_s_tsid_rs, atsc3_route_s_tsid_rs_ls);
+		}
+	}
+
+	return atsc3_route_s_tsid_rs;
+}
+
+atsc3_route_s_tsid_t* atsc3_route_s_tsid_parse_from_xml_document(xml_document_t* xml_document, uint32_t sls_dst_ip_addr, uint16_t sls_dst_port) {
+	if(!xml_document) {
+		return NULL;
+	}
+
+	xml_node_t* s_tsid_node = xml_document_root(xml_document);
+	if(s_tsid_node && xml_string_equals_ignore_case(xml_node_name(s_tsid_node), "xml")) {
+		xml_node_t* xml_preamble_node = s_tsid_node;
+		s_tsid_node = NULL;
+
+		size_t num_root_children = xml_node_children(xml_preamble_node);
+		for(int i = 0; i < num_root_children && !s_tsid_node; i++) {
+			xml_node_t* root_child = xml_node_child(xml_preamble_node, i);
+			if(xml_node_equals_ignore_case(root_child, __ROUTE_S_TSID_ELEMENT)) {
+				s_tsid_node = root_child;
+			}
+		}
+	} else if(s_tsid_node && !xml_node_equals_ignore_case(s_tsid_node, __ROUTE_S_TSID_ELEMENT)) {
+		s_tsid_node = NULL;
+	}
+
+	if(!s_tsid_node) {
+		__ROUTE_S_TSID_PARSER_ERROR("atsc3_route_s_tsid_parse_from_xml_document: no S-TSID element");
+		return NULL;
+	}
+
+	atsc3_route_s_tsid_t* atsc3_route_s_tsid = atsc3_route_s_tsid_new();
+
+	size_t num_children = xml_node_children(s_tsid_node);
+	for(int i = 0; i < num_children; i++) {
+		xml_node_t* child = xml_node_child(s_tsid_node, i);
+		if(xml_node_equals_ignore_case(child, "RS")) {
+			atsc3_route_s_tsid_add_atsc3_route_s_tsid_rs(atsc3_route_s_tsid, __atsc3_route_s_tsid_parse_rs(child, sls_dst_ip_addr, sls_dst_port));
+		}
+	}
+
+	return atsc3_route_s_tsid;
+}
+
+atsc3_route_s_tsid_t* atsc3_route_s_tsid_parse_from_payload(uint8_t* payload, uint32_t payload_length, uint32_t sls_dst_ip_addr, uint16_t sls_dst_port) {
+	xml_document_t* xml_document = xml_parse_document(payload, payload_length);
+	atsc3_route_s_tsid_t* atsc3_route_s_tsid = atsc3_route_s_tsid_parse_from_xml_document(xml_document, sls_dst_ip_addr, sls_dst_port);
+	if(xml_document) {
+		xml_document_free(xml_document, false);
+	}
+	return atsc3_route_s_tsid;
+}
+
+static uint32_t __atsc3_route_s_tsid_payload_hash(uint8_t* payload, uint32_t payload_length) {
+	uint32_t hash = 2166136261u;
+	for(uint32_t i = 0; i < payload_length; i++) {
+		hash = (hash ^ payload[i]) * 16777619u;
+	}
+	return hash;
+}
+
+atsc3_route_s_tsid_t* atsc3_route_s_tsid_update_from_sls_payload(atsc3_route_s_tsid_t* current, uint8_t* payload, uint32_t payload_length, uint32_t sls_dst_ip_addr, uint16_t sls_dst_port) {
+	uint32_t s_tsid_length = 0;
+	uint8_t* s_tsid = atsc3_route_s_tsid_find_in_sls_payload(payload, payload_length, &s_tsid_length);
+	if(!s_tsid) {
+		return NULL;
+	}
+
+	//carousel repeat of the S-TSID we already hold
+	uint32_t s_tsid_hash = __atsc3_route_s_tsid_payload_hash(s_tsid, s_tsid_length);
+	if(current && current->payload_length == s_tsid_length && current->payload_hash == s_tsid_hash) {
+		return NULL;
+	}
+
+	atsc3_route_s_tsid_t* atsc3_route_s_tsid = atsc3_route_s_tsid_parse_from_payload(s_tsid, s_tsid_length, sls_dst_ip_addr, sls_dst_port);
+	if(!atsc3_route_s_tsid) {
+		__ROUTE_S_TSID_PARSER_WARN("atsc3_route_s_tsid_update_from_sls_payload: unable to parse S-TSID, len: %u", s_tsid_length);
+		return NULL;
+	}
+	atsc3_route_s_tsid->payload_length = s_tsid_length;
+	atsc3_route_s_tsid->payload_hash = s_tsid_hash;
+
+	__ROUTE_S_TSID_PARSER_DEBUG("atsc3_route_s_tsid_update_from_sls_payload: new S-TSID, len: %u, RS count: %u", s_tsid_length, atsc3_route_s_tsid->atsc3_route_s_tsid_rs_v.count);
+
+	return atsc3_route_s_tsid;
+}
+
+void atsc3_route_s_tsid_dump(atsc3_route_s_tsid_t* atsc3_route_s_tsid) {
+	for(int i = 0; i < atsc3_route_s_tsid->atsc3_route_s_tsid_rs_v.count; i++) {
+		atsc3_route_s_tsid_rs_t* atsc3_route_s_tsid_rs = atsc3_route_s_tsid->atsc3_route_s_tsid_rs_v.data[i];
+		_ATSC3_UTILS_PRINTLN("RS[%d]: src: %u.%u.%u.%u, dst: %u.%u.%u.%u:%u", i, __toipnonstruct(atsc3_route_s_tsid_rs->src_ip_addr),
+				__toipandportnonstruct(atsc3_route_s_tsid_rs->dst_ip_addr, atsc3_route_s_tsid_rs->dst_port));
+
+		for(int j = 0; j < atsc3_route_s_tsid_rs->atsc3_route_s_tsid_rs_ls_v.count; j++) {
+			atsc3_route_s_tsid_rs_ls_t* atsc3_route_s_tsid_rs_ls = atsc3_route_s_tsid_rs->atsc3_route_s_tsid_rs_ls_v.data[j];
+			_ATSC3_UTILS_PRINTLN("  LS[%d]: tsi: %u, bw: %u, src flow: %d (content type: %s, rep id: %s, code point: %u, init toi: %u), repair flow: %d (protected tsi: %u, max delay: %u)", j,
+					atsc3_route_s_tsid_rs_ls->tsi, atsc3_route_s_tsid_rs_ls->bw, atsc3_route_s_tsid_rs_ls->has_src_flow,
+					atsc3_route_s_tsid_rs_ls->content_type ? atsc3_route_s_tsid_rs_ls->content_type : "",
+					atsc3_route_s_tsid_rs_ls->rep_id ? atsc3_route_s_tsid_rs_ls->rep_id : "", atsc3_route_s_tsid_rs_ls->code_point, atsc3_route_s_tsid_rs_ls->src_flow_init_toi,
+					atsc3_route_s_tsid_rs_ls->has_rpr_flow, atsc3_route_s_tsid_rs_ls->rpr_flow_protected_tsi, atsc3_route_s_tsid_rs_ls->rpr_flow_maximum_delay);
+		}
+	}
+}
@@ -0,0 +1,51 @@
+/*
+ * atsc3_route_s_tsid_parser.h
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: jjustman
+ */
+#include <stdio.h>
+#include <string.h>
+#include <strings.h>
+
+#ifndef ATSC3_ROUTE_S_TSID_PARSER_H_
+#define ATSC3_ROUTE_S_TSID_PARSER_H_
+
+#include "xml.h"
+#include "atsc3_utils.h"
+#include "atsc3_logging.h"
+#include "atsc3_route_s_tsid.h"
+
+#if defined (__cplusplus)
+extern "C" {
+#endif
+
+#define ATSC3_ROUTE_S_TSID_CONTENT_TYPE "application/route-s-tsid+xml"
+
+//RS@dIpAddr and RS@dport default to the SLS flow the S-TSID was carried on
+atsc3_route_s_tsid_t* atsc3_route_s_tsid_parse_from_xml_document(xml_document_t* xml_document, uint32_t sls_dst_ip_addr, uint16_t sls_dst_port);
+atsc3_route_s_tsid_t* atsc3_route_s_tsid_parse_from_payload(uint8_t* payload, uint32_t payload_length, uint32_t sls_dst_ip_addr, uint16_t sls_dst_port);
+
+/*
+ * locates the S-TSID fragment in a completed SLS object without copying it: either the application/route-s-tsid+xml
+ * part of a multipart/related bundle, or the whole object when it is a bare S-TSID document.
+ * returns a pointer into payload and sets s_tsid_length, NULL if the object carries no S-TSID.
+ */
+uint8_t* atsc3_route_s_tsid_find_in_sls_payload(uint8_t* payload, uint32_t payload_length, uint32_t* s_tsid_length);
+
+//returns the newly parsed S-TSID if the SLS object carries one that differs from current (by length and hash), NULL otherwise
+atsc3_route_s_tsid_t* atsc3_route_s_tsid_update_from_sls_payload(atsc3_route_s_tsid_t* current, uint8_t* payload, uint32_t payload_length, uint32_t sls_dst_ip_addr, uint16_t sls_dst_port);
+
+void atsc3_route_s_tsid_dump(atsc3_route_s_tsid_t* atsc3_route_s_tsid);
+
+#if defined (__cplusplus)
+}
+#endif
+
+#define __ROUTE_S_TSID_PARSER_ERROR(...)   __ATSC3_LOG_ERROR(ATSC3_LOG_MODULE_ROUTE_S_TSID_PARSER, __VA_ARGS__)
+#define __ROUTE_S_TSID_PARSER_WARN(...)    __ATSC3_LOG_WARN(ATSC3_LOG_MODULE_ROUTE_S_TSID_PARSER, __VA_ARGS__)
+#define __ROUTE_S_TSID_PARSER_DEBUG(...)   if(_ROUTE_S_TSID_PARSER_DEBUG_ENABLED) { __ATSC3_LOG_DEBUG(ATSC3_LOG_MODULE_ROUTE_S_TSID_PARSER, __VA_ARGS__); }
+
+extern int _ROUTE_S_TSID_PARSER_DEBUG_ENABLED;
+
+#endif /* ATSC3_ROUTE_S_TSID_PARSER_H_ */
@@ -0,0 +1,197 @@
+/*
+ *
+ * atsc3_route_s_tsid_test.c:  driver for S-TSID extraction from the SLS bundle and RS/LS parsing
+ *
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "atsc3_utils.h"
+#include "atsc3_route_s_tsid.h"
+#include "atsc3_route_s_tsid_parser.h"
+
+#define __S_TSID_TEST_SLS_DST_IP_ADDR (239u << 24 | 255 << 16 | 10 << 8 | 1)
+#define __S_TSID_TEST_SLS_DST_PORT 5000
+
+static const char* __S_TSID_TEST_BUNDLE = "Content-Type: multipart/related; type=\"application/mbms-envelope+xml\";\r\n"
+		"\tboundary=\"----=_Part_1\"\r\n"
+		"\r\n"
+		"------=_Part_1\r\n"
+		"Content-Type: application/route-usd+xml\r\n"
+		"Content-Location: usbd.xml\r\n"
+		"\r\n"
+		"<?xml version=\"1.0\" encoding=\"UTF-8\"?>\r\n"
+		"<BundleDescriptionROUTE><UserServiceDescription serviceId=\"5004\"/></BundleDescriptionROUTE>\r\n"
+		"------=_Part_1\r\n"
+		"Content-Type: application/route-s-tsid+xml\r\n"
+		"Content-Location: stsid.xml\r\n"
+		"\r\n"
+		"<?xml version=\"1.0\" encoding=\"UTF-8\"?>\r\n"
+		"<S-TSID xmlns=\"tag:atsc.org,2016:XMLSchemas/ATSC3/Delivery/S-TSID/1.0/\">\r\n"
+		"  <RS>\r\n"
+		"    <LS tsi=\"10\" bw=\"4000000\">\r\n"
+		"      <SrcFlow rt=\"true\">\r\n"
+		"        <ContentInfo><MediaInfo repId=\"Video1\" contentType=\"video\"/></ContentInfo>\r\n"
+		"        <Payload codePoint=\"128\" formatId=\"1\" frag=\"0\" order=\"true\"/>\r\n"
+		"      </SrcFlow>\r\n"
+		"    </LS>\r\n"
+		"  </RS>\r\n"
+		"  <RS dIpAddr=\"239.255.10.2\" dPort=\"5002\" sIpAddr=\"172.16.0.1\">\r\n"
+		"    <LS tsi=\"20\">\r\n"
+		"      <SrcFlow rt=\"true\">\r\n"
+		"        <ContentInfo><MediaInfo repId=\"Audio1\" contentType=\"audio\"/></ContentInfo>\r\n"
+		"        <Payload codePoint=\"128\" formatId=\"1\"/>\r\n"
+		"      </SrcFlow>\r\n"
+		"    </LS>\r\n"
+		"    <LS tsi=\"21\">\r\n"
+		"      <RprFlow>\r\n"
+		"        <FECParameters maximumDelay=\"500\" overhead=\"10\" minBuffSize=\"65536\">\r\n"
+		"          <FECOTI>000000a0</FECOTI>\r\n"
+		"          <ProtectedObject tsi=\"20\"/>\r\n"
+		"        </FECParameters>\r\n"
+		"      </RprFlow>\r\n"
+		"    </LS>\r\n"
+		"  </RS>\r\n"
+		"</S-TSID>\r\n"
+		"------=_Part_1\r\n"
+		"Content-Type: application/dash+xml\r\n"
+		"Content-Location: mpd.xml\r\n"
+		"\r\n"
+		"<?xml version=\"1.0\" encoding=\"UTF-8\"?><MPD/>\r\n"
+		"------=_Part_1--\r\n";
+
+int test_s_tsid_find_in_sls_payload();
+int test_s_tsid_parse();
+int test_s_tsid_update_from_sls_payload();
+int test_s_tsid_parse_from_file(const char* filename);
+
+int main() {
+	int failed = 0;
+
+	failed += test_s_tsid_find_in_sls_payload();
+	failed += test_s_tsid_parse();
+	failed += test_s_tsid_update_from_sls_payload();
+	failed += test_s_tsid_parse_from_file("../test_data/sba-dash/0-4653138");
+
+	printf("atsc3_route_s_tsid_test: %s\n", failed ? "FAILED" : "OK");
+	return failed;
+}
+
+int test_s_tsid_find_in_sls_payload() {
+	uint32_t s_tsid_length = 0;
+	uint8_t* s_tsid = atsc3_route_s_tsid_find_in_sls_payload((uint8_t*)__S_TSID_TEST_BUNDLE, strlen(__S_TSID_TEST_BUNDLE), &s_tsid_length);
+
+	if(!s_tsid || strncmp((char*)s_tsid, "<?xml", 5) || s_tsid_length < 9 || strncmp((char*)&s_tsid[s_tsid_length - 9], "</S-TSID>", 9)) {
+		printf("test_s_tsid_find_in_sls_payload: S-TSID part not found, len: %u\n", s_tsid_length);
+		return 1;
+	}
+
+	//a bare S-TSID object is returned whole, other SLS fragments are not matched
+	const char* bare = "<?xml version=\"1.0\"?><S-TSID><RS><LS tsi=\"1\"/></RS></S-TSID>";
+	if(atsc3_route_s_tsid_find_in_sls_payload((uint8_t*)bare, strlen(bare), &s_tsid_length) != (uint8_t*)bare || s_tsid_length != strlen(bare)) {
+		printf("test_s_tsid_find_in_sls_payload: bare S-TSID not returned\n");
+		return 1;
+	}
+	const char* mpd = "<?xml version=\"1.0\"?><MPD/>";
+	if(atsc3_route_s_tsid_find_in_sls_payload((uint8_t*)mpd, strlen(mpd), &s_tsid_length)) {
+		printf("test_s_tsid_find_in_sls_payload: MPD matched as S-TSID\n");
+		return 1;
+	}
+
+	return 0;
+}
+
+int test_s_tsid_parse() {
+	uint32_t s_tsid_length = 0;
+	uint8_t* s_tsid = atsc3_route_s_tsid_find_in_sls_payload((uint8_t*)__S_TSID_TEST_BUNDLE, strlen(__S_TSID_TEST_BUNDLE), &s_tsid_length);
+	atsc3_route_s_tsid_t* atsc3_route_s_tsid = atsc3_route_s_tsid_parse_from_payload(s_tsid, s_tsid_length, __S_TSID_TEST_SLS_DST_IP_ADDR, __S_TSID_TEST_SLS_DST_PORT);
+
+	if(!atsc3_route_s_tsid || atsc3_route_s_tsid->atsc3_route_s_tsid_rs_v.count != 2) {
+		printf("test_s_tsid_parse: expected 2 RS\n");
+		return 1;
+	}
+	atsc3_route_s_tsid_dump(atsc3_route_s_tsid);
+
+	//the first RS takes the SLS flow as its default
+	atsc3_route_s_tsid_rs_ls_t* video = atsc3_route_s_tsid_find_ls(atsc3_route_s_tsid, __S_TSID_TEST_SLS_DST_IP_ADDR, __S_TSID_TEST_SLS_DST_PORT, 10);
+	if(!video || !video->has_src_flow || !video->src_flow_rt || strcmp(video->content_type, "video") || strcmp(video->rep_id, "Video1") || video->code_point != 128 || video->bw != 4000000) {
+		printf("test_s_tsid_parse: bad video LS\n");
+		return 1;
+	}
+
+	atsc3_route_s_tsid_rs_t* atsc3_route_s_tsid_rs = atsc3_route_s_tsid->atsc3_route_s_tsid_rs_v.data[1];
+	if(atsc3_route_s_tsid_rs->dst_ip_addr != (239u << 24 | 255 << 16 | 10 << 8 | 2) || atsc3_route_s_tsid_rs->dst_port != 5002 || atsc3_route_s_tsid_rs->src_ip_addr != (172u << 24 | 16 << 16 | 1)) {
+		printf("test_s_tsid_parse: bad RS addressing\n");
+		return 1;
+	}
+
+	atsc3_route_s_tsid_rs_ls_t* repair = atsc3_route_s_tsid_find_ls(atsc3_route_s_tsid, atsc3_route_s_tsid_rs->dst_ip_addr, 5002, 21);
+	if(!repair || repair->has_src_flow || !repair->has_rpr_flow || repair->rpr_flow_protected_tsi != 20 || repair->rpr_flow_maximum_delay != 500 ||
+			repair->rpr_flow_min_buff_size != 65536 || !repair->rpr_flow_fec_oti || strcmp(repair->rpr_flow_fec_oti, "000000a0")) {
+		printf("test_s_tsid_parse: bad repair LS\n");
+		return 1;
+	}
+
+	if(atsc3_route_s_tsid_find_ls_by_content_type(atsc3_route_s_tsid, "audio")->tsi != 20 || atsc3_route_s_tsid_find_ls(atsc3_route_s_tsid, __S_TSID_TEST_SLS_DST_IP_ADDR, __S_TSID_TEST_SLS_DST_PORT, 20)) {
+		printf("test_s_tsid_parse: audio LS lookup\n");
+		return 1;
+	}
+
+	atsc3_route_s_tsid_free(&atsc3_route_s_tsid);
+	return 0;
+}
+
+int test_s_tsid_update_from_sls_payload() {
+	atsc3_route_s_tsid_t* atsc3_route_s_tsid = atsc3_route_s_tsid_update_from_sls_payload(NULL, (uint8_t*)__S_TSID_TEST_BUNDLE, strlen(__S_TSID_TEST_BUNDLE), __S_TSID_TEST_SLS_DST_IP_ADDR, __S_TSID_TEST_SLS_DST_PORT);
+	if(!atsc3_route_s_tsid) {
+		printf("test_s_tsid_update_from_sls_payload: first S-TSID not parsed\n");
+		return 1;
+	}
+
+	//carousel repeat is not parsed again
+	if(atsc3_route_s_tsid_update_from_sls_payload(atsc3_route_s_tsid, (uint8_t*)__S_TSID_TEST_BUNDLE, strlen(__S_TSID_TEST_BUNDLE), __S_TSID_TEST_SLS_DST_IP_ADDR, __S_TSID_TEST_SLS_DST_PORT)) {
+		printf("test_s_tsid_update_from_sls_payload: repeat was parsed\n");
+		return 1;
+	}
+
+	atsc3_route_s_tsid_free(&atsc3_route_s_tsid);
+	return 0;
+}
+
+int test_s_tsid_parse_from_file(const char* filename) {
+	block_t* sls = NULL;
+	uint8_t buf[4096];
+	size_t read_n = 0;
+
+	FILE* fp = fopen(filename, "r");
+	if(!fp) {
+		printf("test_s_tsid_parse_from_file: %s not found, skipping\n", filename);
+		return 0;
+	}
+	sls = block_Alloc(sizeof(buf));
+	while((read_n = fread(buf, 1, sizeof(buf), fp)) > 0) {
+		block_Write(sls, buf, read_n);
+	}
+	fclose(fp);
+
+	atsc3_route_s_tsid_t* atsc3_route_s_tsid = atsc3_route_s_tsid_update_from_sls_payload(NULL, sls->p_buffer, sls->i_pos, 0, 0);
+	block_Release(&sls);
+
+	if(!atsc3_route_s_tsid) {
+		printf("test_s_tsid_parse_from_file: %s, no S-TSID\n", filename);
+		return 1;
+	}
+	atsc3_route_s_tsid_dump(atsc3_route_s_tsid);
+
+	atsc3_route_s_tsid_rs_ls_t* video = atsc3_route_s_tsid_find_ls_by_content_type(atsc3_route_s_tsid, "video");
+	atsc3_route_s_tsid_rs_ls_t* audio = atsc3_route_s_tsid_find_ls_by_content_type(atsc3_route_s_tsid, "audio");
+	if(!video || video->tsi != 1 || video->src_flow_init_toi != 2100000000 || !audio || audio->tsi != 2 ||
+			!atsc3_route_s_tsid_find_rs(atsc3_route_s_tsid, (239u << 24 | 255 << 16 | 17 << 8 | 1), 8000)) {
+		printf("test_s_tsid_parse_from_file: %s, unexpected RS/LS\n", filename);
+		return 1;
+	}
+
+	atsc3_route_s_tsid_free(&atsc3_route_s_tsid);
+	return 0;
+}
@@ -73,6 +73,8 @@ udp_packet_t* atsc3_stltp_udp_packet_fragment_check_marker(atsc3_stltp_tunnel_pa
 			__STLTP_PARSER_ERROR("unable to parse outer packet");
 			return NULL;
 		}
+		//inner packets arrive with their tunnel packet
+		atsc3_stltp_tunnel_packet->udp_packet_inner->arrival_timeval = atsc3_stltp_tunnel_packet->udp_packet_outer->arrival_timeval;
 	} else {
 		atsc3_stltp_tunnel_packet->udp_packet_inner = udp_packet_duplicate(atsc3_stltp_tunnel_packet->udp_packet_outer);
 	}
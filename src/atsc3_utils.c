@@ -27,7 +27,7 @@ void* extract(uint8_t *bufPosPtr, uint8_t *dest, int size) {
 }
 
 void kvp_collection_free(kvp_collection_t* collection) {
-	if(!collection || !collection->size_n) return;
+	if(!collection) return;
 
 	//free each entry and their corresponding key/val char*
 	for(int i=0; i < collection->size_n; i++) {
@@ -179,15 +179,28 @@ kvp_collection_t* kvp_collection_parse(uint8_t* input_string) {
 
 
 block_t* block_Alloc(int len) {
+	return block_Alloc_flags(len, 0);
+}
+
+block_t* block_Alloc_flags(int len, uint8_t flags) {
 	block_t* new_block = (block_t*)calloc(1, sizeof(block_t));
 	assert(new_block);
 
 	//calloc an extra byte in case we forget to add in null padding for strings, but don't update the p_size with this margin of saftey
-	new_block->p_buffer = (uint8_t*)calloc(len + 8, sizeof(uint8_t));
-	assert(new_block->p_buffer);
+	if(flags & BLOCK_FLAG_NO_ZERO) {
+		new_block->p_buffer = (uint8_t*)malloc(len + 8);
+		assert(new_block->p_buffer);
+		memset(&new_block->p_buffer[len], 0, 8);
+	} else {
+		new_block->p_buffer = (uint8_t*)calloc(len + 8, sizeof(uint8_t));
+		assert(new_block->p_buffer);
+	}
 
 	new_block->p_size = len;
+	new_block->a_size = len;
 	new_block->i_pos = 0;
+	new_block->refcnt = 1;
+	new_block->flags = flags & BLOCK_FLAG_NO_ZERO;
 
 	return new_block;
 }
@@ -230,13 +243,43 @@ block_t* __block_check_bounaries(const char* method_name, block_t* src) {
 	return src;
 }
 
+//slices are read-only, and a buffer with live slices can't move
+static bool __block_check_writable(const char* method_name, block_t* src) {
+	if(src->flags & BLOCK_FLAG_SLICE) {
+		_ATSC3_UTILS_ERROR("%s: block: %p is a read-only slice of: %p", method_name, src, src->parent);
+		return false;
+	}
+	return true;
+}
+
+//grows the allocation to at least a_size_required, p_size is left to the caller
+static block_t* __block_realloc(const char* method_name, block_t* src, uint32_t a_size_required) {
+	if(src->slices_n) {
+		_ATSC3_UTILS_ERROR("%s: block: %p, unable to realloc from %u to %u, p_buffer: %p is shared with %u slices", method_name, src, src->a_size, a_size_required, src->p_buffer, src->slices_n);
+		return NULL;
+	}
+
+	//always over alloc by 8 bytes for a null pad
+	void* new_block = realloc(src->p_buffer, a_size_required + 8);
+	if(!new_block) {
+		_ATSC3_UTILS_ERROR("%s: block: %p realloc to %u failed, returning NULL", method_name, src, a_size_required);
+		return NULL;
+	}
+	_ATSC3_UTILS_TRACE("%s: block: %p, p_buffer was: %p, now: %p, realloc from %u to %u", method_name, src, src->p_buffer, new_block, src->a_size, a_size_required);
+	src->p_buffer = (uint8_t*) new_block;
+	src->a_size = a_size_required;
+
+	return src;
+}
+
 block_t* block_Write(block_t* dest, uint8_t* src_buf, uint32_t src_size) {
 	if(!__block_check_bounaries(__FUNCTION__, dest)) return NULL;
+	if(!__block_check_writable(__FUNCTION__, dest)) return NULL;
 
-	int dest_size_required = dest->i_pos + src_size;
-	if(dest->p_size < dest_size_required) {
-		block_t* ret_block = block_Resize(dest, dest_size_required);
-		if(!ret_block) {
+	uint32_t dest_size_required = dest->i_pos + src_size;
+	if(dest->a_size < dest_size_required) {
+		//double so appending n fragments is O(n) copies instead of O(n^2)
+		if(!__block_realloc(__FUNCTION__, dest, __MAX(dest_size_required, dest->a_size * 2))) {
 			_ATSC3_UTILS_ERROR("block_Write: block: %p, unable to realloc from size: %u to %u, returning NULL", dest, dest->p_size, dest_size_required);
 			return NULL;
 		}
@@ -244,13 +287,18 @@ block_t* block_Write(block_t* dest, uint8_t* src_buf, uint32_t src_size) {
 	memcpy(&dest->p_buffer[dest->i_pos], src_buf, src_size);
 	dest->i_pos += src_size;
 
+	if(dest->p_size < dest_size_required) {
+		dest->p_size = dest_size_required;
+		memset(&dest->p_buffer[dest->p_size], 0, 8);
+	}
+
 	return dest;
 }
 
 block_t* block_Rewind(block_t* dest) {
 	if(!__block_check_bounaries(__FUNCTION__, dest)) return NULL;
 
-	if(dest->i_pos) {
+	if(dest->i_pos && !(dest->flags & (BLOCK_FLAG_NO_ZERO | BLOCK_FLAG_SLICE))) {
 		uint32_t to_scrub_len = dest->i_pos > 0 ?  __CLIP(dest->i_pos, 0, dest->p_size) : dest->p_size;
 		_ATSC3_UTILS_TRACE("block_Rewind, block: %p, zeroing out %u bytes", dest, to_scrub_len)
 		memset(dest->p_buffer, 0, to_scrub_len);
@@ -266,13 +314,15 @@ block_t* block_Rewind(block_t* dest) {
 /**
  * note, this will duplicate the full block size and update i_pos in the dest payload
  * if you need a subset of the payload, use block_Duplicate_from_position
+ *
+ * the copy is always writable, use block_Retain or block_Slice to share the buffer instead
  */
 block_t* block_Duplicate(block_t* src) {
 	if(!__block_check_bounaries(__FUNCTION__, src)) return NULL;
 
 	uint32_t to_alloc_size = src->p_size;
 
-	block_t* dest = block_Alloc(to_alloc_size);
+	block_t* dest = block_Alloc_flags(to_alloc_size, BLOCK_FLAG_NO_ZERO);
 	memcpy(dest->p_buffer, src->p_buffer, to_alloc_size);
 	dest->i_pos = 0;
 
@@ -292,7 +342,7 @@ block_t* block_Duplicate_from_position(block_t* src) {
 		return NULL;
 	}
 
-	block_t* dest = block_Alloc(to_alloc_size);
+	block_t* dest = block_Alloc_flags(to_alloc_size, BLOCK_FLAG_NO_ZERO);
 	memcpy(dest->p_buffer, &src->p_buffer[src->i_pos], to_alloc_size);
 	dest->i_pos = 0;
 
@@ -303,44 +353,86 @@ block_t* block_Duplicate_from_position(block_t* src) {
 //this has not been tested with shrinking down the size...
 block_t* block_Resize(block_t* src, uint32_t src_size_requested) {
 	if(!__block_check_bounaries(__FUNCTION__, src)) return NULL;
+	if(!__block_check_writable(__FUNCTION__, src)) return NULL;
 
 	uint32_t src_size_required = __MAX(64, src_size_requested);
 
-	//always over alloc by 1 byte for a null pad
-	void* new_block = realloc(src->p_buffer, src_size_required + 8);
-	if(!new_block) {
+	//shrinking, or growing inside of a previous geometric block_Write allocation, keeps p_buffer in place
+	if(src_size_required > src->a_size && !__block_realloc(__FUNCTION__, src, src_size_required)) {
 		_ATSC3_UTILS_ERROR("block_Resize: block: %p resize to %u failed, returning NULL", src, src_size_required);
 		return NULL;
+	}
+
+	_ATSC3_UTILS_TRACE("block_Resize: block: %p, resize from %u to %u", src, src->p_size, src_size_required);
+	src->p_size = src_size_required;
+	uint32_t to_check_new_i_pos = __MIN(src->p_size - 1, src->i_pos);
+	if(to_check_new_i_pos != src->i_pos) {
+		_ATSC3_UTILS_WARN("block_Resize: block: %p resize to %u, old pos %u past end of new size, updating to %u", src, src->p_size, src->i_pos, to_check_new_i_pos);
+		src->i_pos = to_check_new_i_pos;
+		memset(&src->p_buffer[src->p_size], 0, 8);
+	} else if(src->flags & BLOCK_FLAG_NO_ZERO) {
+		memset(&src->p_buffer[src->p_size], 0, 8);
 	} else {
-		_ATSC3_UTILS_TRACE("block_Resize: block: %p, p_buffer was: %p, now: %p, resize from %u to %u", src, src->p_buffer, new_block, src->p_size, src_size_required);
-		src->p_buffer = (uint8_t*) new_block;
-		src->p_size = src_size_required;
-		uint32_t to_check_new_i_pos = __MIN(src->p_size - 1, src->i_pos);
-		if(to_check_new_i_pos != src->i_pos) {
-			_ATSC3_UTILS_WARN("block_Resize: block: %p resize to %u, old pos %u past end of new size, updating to %u", src, src->p_size, src->i_pos, to_check_new_i_pos);
-			src->i_pos = to_check_new_i_pos;
-		} else {
-			_ATSC3_UTILS_TRACE("block_Resize: block: %p, zeroing out from: %u to %u", src, src->i_pos, src->p_size);
-			uint32_t to_scrub_len = __MAX(0, (src->p_size - 1 - src->i_pos));
-			memset(&src->p_buffer[src->i_pos], 0, to_scrub_len + 8);
-		}
+		_ATSC3_UTILS_TRACE("block_Resize: block: %p, zeroing out from: %u to %u", src, src->i_pos, src->p_size);
+		uint32_t to_scrub_len = __MAX(0, (src->p_size - 1 - src->i_pos));
+		memset(&src->p_buffer[src->i_pos], 0, to_scrub_len + 8);
 	}
 
 	return src;
 }
 
+block_t* block_Slice(block_t* parent, uint32_t offset, uint32_t len) {
+	if(!parent->p_buffer || offset > parent->p_size || len > parent->p_size - offset) {
+		_ATSC3_UTILS_ERROR("block_Slice: block: %p, slice offset: %u, len: %u is outside of p_size: %u", parent, offset, len, parent->p_size);
+		return NULL;
+	}
+
+	//slices of slices point at the block that owns the buffer
+	if(parent->flags & BLOCK_FLAG_SLICE) {
+		offset += parent->p_buffer - parent->parent->p_buffer;
+		parent = parent->parent;
+	}
+
+	block_t* slice = (block_t*)calloc(1, sizeof(block_t));
+	assert(slice);
+
+	slice->p_buffer = &parent->p_buffer[offset];
+	slice->p_size = len;
+	slice->a_size = len;
+	slice->i_pos = len;
+	slice->refcnt = 1;
+	slice->flags = BLOCK_FLAG_SLICE;
+	slice->parent = block_Retain(parent);
+	__atomic_add_fetch(&parent->slices_n, 1, __ATOMIC_RELAXED);
+
+	return slice;
+}
+
+block_t* block_Retain(block_t* a) {
+	if(a) {
+		__atomic_add_fetch(&a->refcnt, 1, __ATOMIC_RELAXED);
+	}
+	return a;
+}
 
 void block_Release(block_t** a_ptr) {
 	block_t* a = *a_ptr;
 	if(a) {
-		if(a->p_buffer && a->p_size) {
-			a->i_pos = 0;
-			a->p_size = 0;
-			free(a->p_buffer);
-			a->p_buffer = NULL;
+		*a_ptr = NULL;
+		if(__atomic_sub_fetch(&a->refcnt, 1, __ATOMIC_ACQ_REL)) {
+			return;
 		}
+
+		if(a->flags & BLOCK_FLAG_SLICE) {
+			__atomic_sub_fetch(&a->parent->slices_n, 1, __ATOMIC_RELAXED);
+			block_Release(&a->parent);
+		} else {
+			freesafe(a->p_buffer);
+		}
+		a->p_buffer = NULL;
+		a->i_pos = 0;
+		a->p_size = 0;
 		free(a);
-		*a_ptr = NULL;
 	}
 }
 
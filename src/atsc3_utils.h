@@ -13,6 +13,7 @@
 #include <stdlib.h>
 #include <stdio.h>
 #include <stdint.h>
+#include <stdbool.h>
 #include <signal.h>
 #include <string.h>
 #include <strings.h>
@@ -83,18 +84,38 @@ char* kvp_collection_get_reference_p(kvp_collection_t *collection, char* key);
 void kvp_collection_free(kvp_collection_t* collection);
 
 //or block_t as in VLC?
+
+//skip the memset in block_Alloc, block_Rewind and block_Resize for blocks that are always written before they are read
+#define BLOCK_FLAG_NO_ZERO	0x01
+//read-only view into another block's p_buffer, see block_Slice
+#define BLOCK_FLAG_SLICE	0x02
+
 typedef struct atsc3_block {
 	uint8_t* p_buffer;
 	uint32_t p_size;
 	uint32_t i_pos;
+
+	//allocated length of p_buffer (not counting the null pad), block_Write grows this geometrically, p_size stays the written length
+	uint32_t a_size;
+	uint32_t refcnt;
+	uint32_t slices_n;
+	uint8_t  flags;
+	struct atsc3_block* parent;
 } block_t;
 
 block_t* block_Alloc(int len);
+block_t* block_Alloc_flags(int len, uint8_t flags);
 block_t* block_Write(block_t* dest, uint8_t* buf, uint32_t size);
 block_t* block_Rewind(block_t* dest);
 block_t* block_Resize(block_t* dest, uint32_t dest_size_required);
 block_t* block_Duplicate(block_t* a);
 block_t* block_Duplicate_from_position(block_t* a);
+
+//shares p_buffer with parent for len bytes from offset, i_pos at the end of the view.
+//the parent is retained until the slice is released and can not be reallocated while slices are live
+block_t* block_Slice(block_t* parent, uint32_t offset, uint32_t len);
+block_t* block_Retain(block_t* a);
+//drops one reference, the block (and its buffer, or its retain on the parent for slices) is freed with the last one
 void block_Release(block_t** a);
 
 //alloc and copy - note limited to 16k
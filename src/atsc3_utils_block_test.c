@@ -0,0 +1,152 @@
+/*
+ *
+ * atsc3_utils_block_test.c:  driver for block_t growth, refcounting and slices
+ *
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "atsc3_utils.h"
+
+int test_block_write_growth();
+int test_block_retain_release();
+int test_block_slice();
+
+int main() {
+	int failed = 0;
+
+	failed += test_block_write_growth();
+	failed += test_block_retain_release();
+	failed += test_block_slice();
+
+	printf("atsc3_utils_block_test: %s\n", failed ? "FAILED" : "OK");
+	return failed;
+}
+
+int test_block_write_growth() {
+	uint8_t fragment[100];
+	for(int i = 0; i < sizeof(fragment); i++) {
+		fragment[i] = i;
+	}
+
+	block_t* block = block_Alloc(16);
+	uint32_t reallocs = 0;
+	uint32_t last_a_size = block->a_size;
+
+	for(int i = 0; i < 1000; i++) {
+		block_Write(block, fragment, sizeof(fragment));
+		if(block->a_size != last_a_size) {
+			reallocs++;
+			last_a_size = block->a_size;
+		}
+	}
+
+	//p_size is the written length, the allocation doubles underneath it
+	if(block->p_size != 1000 * sizeof(fragment) || block->i_pos != block->p_size || block->a_size < block->p_size) {
+		printf("test_block_write_growth: p_size: %u, i_pos: %u, a_size: %u\n", block->p_size, block->i_pos, block->a_size);
+		return 1;
+	}
+	if(reallocs > 16) {
+		printf("test_block_write_growth: %u reallocs for 1000 writes\n", reallocs);
+		return 1;
+	}
+	for(int i = 0; i < 1000; i++) {
+		if(memcmp(&block->p_buffer[i * sizeof(fragment)], fragment, sizeof(fragment))) {
+			printf("test_block_write_growth: fragment %d mismatch\n", i);
+			return 1;
+		}
+	}
+	if(block->p_buffer[block->p_size]) {
+		printf("test_block_write_growth: missing null pad\n");
+		return 1;
+	}
+	block_Release(&block);
+
+	//no zero blocks keep their bytes across a rewind
+	block = block_Alloc_flags(8, BLOCK_FLAG_NO_ZERO);
+	block_Write(block, fragment, 8);
+	block_Rewind(block);
+	if(block->i_pos || memcmp(block->p_buffer, fragment, 8)) {
+		printf("test_block_write_growth: no zero block was scrubbed on rewind\n");
+		return 1;
+	}
+	block_Release(&block);
+
+	block = block_Alloc(8);
+	block_Write(block, fragment, 8);
+	block_Rewind(block);
+	if(block->p_buffer[7]) {
+		printf("test_block_write_growth: block was not scrubbed on rewind\n");
+		return 1;
+	}
+	block_Release(&block);
+
+	return 0;
+}
+
+int test_block_retain_release() {
+	block_t* block = block_Alloc(32);
+	block_t* shared = block_Retain(block);
+
+	block_Release(&block);
+	if(block || shared->refcnt != 1 || !shared->p_buffer) {
+		printf("test_block_retain_release: shared block freed with a reference outstanding\n");
+		return 1;
+	}
+	block_Release(&shared);
+	if(shared) {
+		printf("test_block_retain_release: release did not null the reference\n");
+		return 1;
+	}
+
+	return 0;
+}
+
+int test_block_slice() {
+	uint8_t packet[64];
+	for(int i = 0; i < sizeof(packet); i++) {
+		packet[i] = 0xA0 + i;
+	}
+
+	block_t* parent = block_Alloc(sizeof(packet));
+	block_Write(parent, packet, sizeof(packet));
+
+	block_t* slice = block_Slice(parent, 10, 20);
+	if(!slice || slice->p_buffer != &parent->p_buffer[10] || slice->p_size != 20 || slice->i_pos != 20 || parent->slices_n != 1 || parent->refcnt != 2) {
+		printf("test_block_slice: bad slice\n");
+		return 1;
+	}
+
+	block_t* slice_of_slice = block_Slice(slice, 5, 5);
+	if(!slice_of_slice || slice_of_slice->p_buffer != &parent->p_buffer[15] || slice_of_slice->parent != parent || parent->slices_n != 2) {
+		printf("test_block_slice: bad slice of slice\n");
+		return 1;
+	}
+
+	if(block_Slice(parent, 60, 5)) {
+		printf("test_block_slice: slice past the end of the parent\n");
+		return 1;
+	}
+
+	//slices are read-only and pin the parent buffer
+	if(block_Write(slice, packet, 4) || block_Resize(slice, 128)) {
+		printf("test_block_slice: slice was writable\n");
+		return 1;
+	}
+	if(block_Write(parent, packet, sizeof(packet))) {
+		printf("test_block_slice: parent buffer moved with live slices\n");
+		return 1;
+	}
+
+	//the parent outlives its last owner until the slices are released
+	block_Release(&parent);
+	if(memcmp(slice->p_buffer, &packet[10], 20) || memcmp(slice_of_slice->p_buffer, &packet[15], 5)) {
+		printf("test_block_slice: slice contents changed\n");
+		return 1;
+	}
+	block_Release(&slice);
+	block_Release(&slice_of_slice);
+
+	return 0;
+}
@@ -83,6 +83,7 @@ extern "C" {
 #define SB_LB_E_FEC_ENC_ID		128		/**< Small Block, Large Block and Expandable FEC scheme */
 #define SB_SYS_FEC_ENC_ID		129		/**< Small Block Systematic FEC scheme */
 #define COM_FEC_ENC_ID			130		/**< Compact FEC scheme */
+#define RAPTORQ_FEC_ENC_ID		6		/**< RaptorQ FEC scheme, RFC 6330 */
 
 #define REED_SOL_FEC_INST_ID	0		/**< Reed-Solomon instance id, when Small Block Systematic FEC scheme is used */
 
@@ -82,7 +82,7 @@ void process_packet(u_char *user, const struct pcap_pkthdr *pkthdr, const u_char
 	        if(!retval) {
 				alc_packet_dump_to_object(&alc_packet);
 
-				if(!alc_packet->def_lct_hdr->toi) {
+				if(!alc_packet->def_lct_hdr.toi) {
 
 					//if no TOI, dump our EFDT
 //                    char* toi_file_name = alc_packet_dump_to_object_get_filename(alc_packet);
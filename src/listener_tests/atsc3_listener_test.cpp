@@ -39,6 +39,7 @@ int PACKET_COUNTER=0;
 #include <sys/stat.h>
 
 #include "atsc3_listener_udp.h"
+#include "atsc3_pcap_replay.h"
 #include "atsc3_mmtp_types.h"
 #include "atsc3_lls.h"
 #include "atsc3_mmtp_parser.h"
@@ -298,7 +299,7 @@ int main(int argc,char **argv) {
     	println("%s - a udp mulitcast listener test harness for atsc3 mmt messages", argv[0]);
     	println("---");
     	println("args: dev (dst_ip) (dst_port)");
-    	println(" dev: device to listen for udp multicast, default listen to 0.0.0.0:0");
+    	println(" dev: device to listen for udp multicast, default listen to 0.0.0.0:0, or a pcap/pcapng capture file to replay");
     	println(" (dst_ip): optional, filter to specific ip address");
     	println(" (dst_port): optional, filter to specific port");
     	println("");
@@ -309,6 +310,12 @@ int main(int argc,char **argv) {
 
     mkdir("mpu", 0777);
 
+    //offline ingest, replay a pcap/pcapng capture at its original timestamps
+    if(atsc3_pcap_replay_is_file(dev)) {
+        atsc3_pcap_replay_run_from_file(dev, ATSC3_PCAP_REPLAY_MODE_PACED, process_packet);
+        return 0;
+    }
+
     pcap_lookupnet(dev, &netp, &maskp, errbuf);
     descr = pcap_open_live(dev, MAX_PCAP_LEN, 1, 0, errbuf);
 
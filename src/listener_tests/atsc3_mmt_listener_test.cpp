@@ -21,6 +21,7 @@
 #include <pthread.h>
 
 #include "../atsc3_listener_udp.h"
+#include "../atsc3_pcap_replay.h"
 #include "../atsc3_utils.h"
 
 #include "../atsc3_lls.h"
@@ -257,6 +258,12 @@ cleanup:
 void* pcap_loop_run_thread(void* dev_pointer) {
 	char* dev = (char*) dev_pointer;
 
+	//offline ingest, replay a pcap/pcapng capture at its original timestamps
+	if(atsc3_pcap_replay_is_file(dev)) {
+		atsc3_pcap_replay_run_from_file(dev, ATSC3_PCAP_REPLAY_MODE_PACED, process_packet);
+		return 0;
+	}
+
 	char errbuf[PCAP_ERRBUF_SIZE];
 	pcap_t* descr;
 	struct bpf_program fp;
@@ -361,7 +368,7 @@ int main(int argc,char **argv) {
     	println("%s - a udp mulitcast listener test harness for atsc3 mmt messages", argv[0]);
     	println("---");
     	println("args: dev (dst_ip) (dst_port)");
-    	println(" dev: device to listen for udp multicast, default listen to 0.0.0.0:0");
+    	println(" dev: device to listen for udp multicast, default listen to 0.0.0.0:0, or a pcap/pcapng capture file to replay");
     	println(" (dst_ip): optional, filter to specific ip address");
     	println(" (dst_port): optional, filter to specific port");
     	println("");
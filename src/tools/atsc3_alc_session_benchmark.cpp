@@ -0,0 +1,198 @@
+/*
+ * atsc3_alc_session_benchmark.cpp
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: jjustman
+ *
+ * ALC session scalability: N sessions parsed on N threads
+ *
+ * each thread opens its own ALC session and runs synthetic A/331 LCT packets through
+ * alc_rx_analyze_packet_a331_compliant / alc_packet_free as fast as it can, for 1, 2, 4.. max threads.
+ * throughput is total packets per second across all threads, scaling is relative to 1 thread.
+ *
+ * 	handle:			the worker passes its alc_session_t* directly, no shared state is touched per packet
+ * 	registry:		each packet also does a get_session_state(s_id) control plane lookup in the session registry
+ * 	global_lock:	each packet is serialized on one process wide mutex, as every session access was
+ * 					with the previous alc_session_list / session_variables_semaphore
+ *
+ * usage:
+ *
+ * 	./atsc3_alc_session_benchmark (max_threads) (packets_per_thread)
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include <pthread.h>
+#include <unistd.h>
+
+#include "../alc_session.h"
+#include "../alc_channel.h"
+#include "../atsc3_alc_rx.h"
+
+#define ALC_SESSION_BENCHMARK_DEFAULT_PACKETS	1000000
+#define ALC_SESSION_BENCHMARK_PAYLOAD_LEN		1400
+#define ALC_SESSION_BENCHMARK_PACKET_LEN		(16 + ALC_SESSION_BENCHMARK_PAYLOAD_LEN)
+
+enum alc_session_benchmark_mode {
+	ALC_SESSION_BENCHMARK_HANDLE,
+	ALC_SESSION_BENCHMARK_REGISTRY,
+	ALC_SESSION_BENCHMARK_GLOBAL_LOCK,
+};
+
+static const char* benchmark_mode_name[] = { "handle", "registry", "global_lock" };
+
+typedef struct alc_session_benchmark_worker {
+	pthread_t						thread_id;
+	enum alc_session_benchmark_mode	mode;
+	alc_session_t*					alc_session;
+	uint32_t						packets;
+	uint32_t						parsed;
+	uint32_t						errors;
+} alc_session_benchmark_worker_t;
+
+static pthread_mutex_t benchmark_global_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_barrier_t benchmark_start_barrier;
+
+static double now_sec() {
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+//LCT header: V=1, C=0, PSI=0b10, S=1, O=0, H=0, hdr_len 16 bytes, codepoint 0 (compact no-code), cci, tsi, toi, start_offset
+static void benchmark_alc_packet_build(uint8_t* packet, uint32_t tsi, uint32_t toi, uint32_t start_offset) {
+	memset(packet, 0, ALC_SESSION_BENCHMARK_PACKET_LEN);
+	packet[0] = 0x12;
+	packet[1] = 0xA0;
+	packet[2] = 4;
+	packet[3] = 0;
+
+	uint32_t fields[] = { tsi, toi, start_offset };
+	for(int i = 0; i < 3; i++) {
+		packet[8 + i * 4 + 0] = fields[i] >> 24;
+		packet[8 + i * 4 + 1] = fields[i] >> 16;
+		packet[8 + i * 4 + 2] = fields[i] >> 8;
+		packet[8 + i * 4 + 3] = fields[i];
+	}
+	memset(packet + 16, 0x47, ALC_SESSION_BENCHMARK_PAYLOAD_LEN);
+}
+
+static void* benchmark_worker_thread(void* arg) {
+	alc_session_benchmark_worker_t* worker = (alc_session_benchmark_worker_t*)arg;
+	uint8_t packet[ALC_SESSION_BENCHMARK_PACKET_LEN];
+
+	alc_channel_t ch;
+	memset(&ch, 0, sizeof(alc_channel_t));
+	ch.s = worker->alc_session;
+
+	pthread_barrier_wait(&benchmark_start_barrier);
+
+	for(uint32_t i = 0; i < worker->packets; i++) {
+		benchmark_alc_packet_build(packet, worker->alc_session->tsi, i >> 10, (i & 1023) * ALC_SESSION_BENCHMARK_PAYLOAD_LEN);
+
+		if(worker->mode == ALC_SESSION_BENCHMARK_GLOBAL_LOCK) {
+			pthread_mutex_lock(&benchmark_global_lock);
+		} else if(worker->mode == ALC_SESSION_BENCHMARK_REGISTRY && get_session_state(worker->alc_session->s_id) != SActive) {
+			worker->errors++;
+			continue;
+		}
+
+		alc_packet_t* alc_packet = NULL;
+		if(!alc_rx_analyze_packet_a331_compliant((char*)packet, ALC_SESSION_BENCHMARK_PACKET_LEN, &ch, &alc_packet)) {
+			worker->parsed++;
+		} else {
+			worker->errors++;
+		}
+		alc_packet_free(&alc_packet);
+
+		if(worker->mode == ALC_SESSION_BENCHMARK_GLOBAL_LOCK) {
+			pthread_mutex_unlock(&benchmark_global_lock);
+		}
+	}
+
+	return NULL;
+}
+
+//returns total packets per second, or 0 on error
+static double benchmark_run(enum alc_session_benchmark_mode mode, uint32_t threads, uint32_t packets) {
+	alc_session_benchmark_worker_t* workers = (alc_session_benchmark_worker_t*)calloc(threads, sizeof(alc_session_benchmark_worker_t));
+	alc_arguments_t* alc_arguments = (alc_arguments_t*)calloc(threads, sizeof(alc_arguments_t));
+	double pps = 0;
+
+	for(uint32_t i = 0; i < threads; i++) {
+		alc_arguments[i].tsi = 1000 + i;
+		workers[i].mode = mode;
+		workers[i].packets = packets;
+		workers[i].alc_session = open_alc_session(&alc_arguments[i]);
+		if(!workers[i].alc_session) {
+			printf("atsc3_alc_session_benchmark: open_alc_session failed for thread: %u\n", i);
+			threads = i;
+			goto cleanup;
+		}
+	}
+
+	{
+		pthread_barrier_init(&benchmark_start_barrier, NULL, threads + 1);
+		for(uint32_t i = 0; i < threads; i++) {
+			pthread_create(&workers[i].thread_id, NULL, benchmark_worker_thread, &workers[i]);
+		}
+
+		pthread_barrier_wait(&benchmark_start_barrier);
+		double start = now_sec();
+		for(uint32_t i = 0; i < threads; i++) {
+			pthread_join(workers[i].thread_id, NULL);
+		}
+		double elapsed = now_sec() - start;
+		pthread_barrier_destroy(&benchmark_start_barrier);
+
+		uint64_t parsed = 0;
+		uint32_t errors = 0;
+		for(uint32_t i = 0; i < threads; i++) {
+			parsed += workers[i].parsed;
+			errors += workers[i].errors;
+		}
+		if(errors) {
+			printf("atsc3_alc_session_benchmark: %s, threads: %u, %u packets not parsed\n", benchmark_mode_name[mode], threads, errors);
+		} else {
+			pps = parsed / elapsed;
+		}
+	}
+
+cleanup:
+	for(uint32_t i = 0; i < threads; i++) {
+		alc_session_close(workers[i].alc_session);
+	}
+	free(alc_arguments);
+	free(workers);
+
+	return pps;
+}
+
+int main(int argc, char* argv[]) {
+	long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+	uint32_t max_threads = argc > 1 ? atoi(argv[1]) : (cpus > 0 ? cpus : 1);
+	uint32_t packets = argc > 2 ? atoi(argv[2]) : ALC_SESSION_BENCHMARK_DEFAULT_PACKETS;
+	if(!max_threads || !packets || max_threads > MAX_ALC_SESSIONS) {
+		printf("usage: %s (max_threads, up to %d) (packets_per_thread)\n", argv[0], MAX_ALC_SESSIONS);
+		return 1;
+	}
+
+	printf("atsc3_alc_session_benchmark: packets/thread: %u, payload: %u, registry shards: %u\n", packets, ALC_SESSION_BENCHMARK_PAYLOAD_LEN, ALC_SESSION_REGISTRY_SHARDS);
+	printf("%12s %8s %14s %10s\n", "mode", "threads", "pkts/s", "scaling");
+
+	for(int mode = ALC_SESSION_BENCHMARK_HANDLE; mode <= ALC_SESSION_BENCHMARK_GLOBAL_LOCK; mode++) {
+		double pps_single = 0;
+		for(uint32_t threads = 1; threads <= max_threads; threads = threads < max_threads && threads * 2 > max_threads ? max_threads : threads * 2) {
+			double pps = benchmark_run((enum alc_session_benchmark_mode)mode, threads, packets);
+			if(threads == 1) {
+				pps_single = pps;
+			}
+			printf("%12s %8u %14.0f %9.2fx\n", benchmark_mode_name[mode], threads, pps, pps_single ? pps / pps_single : 0);
+		}
+	}
+
+	return 0;
+}
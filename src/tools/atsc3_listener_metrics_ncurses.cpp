@@ -76,12 +76,16 @@ int PACKET_COUNTER=0;
 #include "../atsc3_isobmff_tools.h"
 
 #include "../atsc3_listener_udp.h"
+#include "../atsc3_pcap_replay.h"
+#include "../atsc3_af_packet_capture.h"
+#include "../atsc3_multicast_receiver.h"
 #include "../atsc3_utils.h"
 
 #include "../atsc3_lls.h"
 #include "../atsc3_lls_alc_utils.h"
 
 #include "../atsc3_lls_slt_parser.h"
+#include "../atsc3_flow_dispatch.h"
 #include "../atsc3_lls_sls_monitor_output_buffer_utils.h"
 
 #include "../atsc3_mmtp_types.h"
@@ -96,9 +100,11 @@ int PACKET_COUNTER=0;
 
 #include "../atsc3_bandwidth_statistics.h"
 #include "../atsc3_packet_statistics.h"
+#include "../atsc3_latency_histogram.h"
 
 #include "../atsc3_output_statistics_ncurses.h"
 
+#include "../atsc3_logging.h"
 #include "../atsc3_logging_externs.h"
 
 
@@ -158,6 +164,7 @@ static void route_process_from_alc_packet(alc_packet_t **alc_packet) {
     if(lls_slt_monitor->lls_sls_alc_monitor->lls_sls_monitor_output_buffer.has_written_init_box && lls_slt_monitor->lls_sls_alc_monitor->lls_sls_monitor_output_buffer.should_flush_output_buffer) {
      
         lls_sls_monitor_output_buffer_t* lls_sls_monitor_output_buffer_final_muxed_payload = atsc3_isobmff_build_joined_isobmff_fragment(&lls_slt_monitor->lls_sls_alc_monitor->lls_sls_monitor_output_buffer);
+        __LATENCY_HISTOGRAM_RECORD(lls_slt_monitor->lls_sls_alc_monitor->lls_alc_session->service_id, ATSC3_LATENCY_STAGE_ISOBMFF_JOIN);
         
         if(true || lls_slt_monitor->lls_sls_alc_monitor->lls_sls_monitor_output_buffer_mode.file_dump_enabled) {
             lls_sls_monitor_output_buffer_file_dump(lls_sls_monitor_output_buffer_final_muxed_payload, "route/", lls_slt_monitor->lls_sls_alc_monitor->processed_toi, lls_slt_monitor->lls_sls_alc_monitor->processed_toi);
@@ -170,6 +177,7 @@ static void route_process_from_alc_packet(alc_packet_t **alc_packet) {
         	pipe_buffer_reader_mutex_lock(pipe_ffplay_buffer);
         
         	pipe_buffer_unsafe_push_block(pipe_ffplay_buffer, lls_sls_monitor_output_buffer_final_muxed_payload->joined_isobmff_block->p_buffer, lls_sls_monitor_output_buffer_final_muxed_payload->joined_isobmff_block->i_pos);
+        	__LATENCY_HISTOGRAM_RECORD(lls_slt_monitor->lls_sls_alc_monitor->lls_alc_session->service_id, ATSC3_LATENCY_STAGE_SINK_ENQUEUE);
         
         	pipe_buffer_notify_semaphore_post(pipe_ffplay_buffer);
         
@@ -197,6 +205,8 @@ alc_packet_t* route_parse_from_udp_packet(lls_sls_alc_session_t *matching_lls_sl
         int retval = alc_rx_analyze_packet_a331_compliant((char*)udp_packet->data, udp_packet->data_length, &ch, &alc_packet);
         if(!retval) {
             global_stats->packet_counter_alc_packets_parsed++;
+            atsc3_packet_statistics_alc_stats_populate(udp_packet, alc_packet);
+            __LATENCY_HISTOGRAM_RECORD(matching_lls_slt_alc_session->service_id, ATSC3_LATENCY_STAGE_PARSE);
             
             //don't dump unless this is pointing to our monitor session
             if(lls_slt_monitor->lls_sls_alc_monitor &&  lls_slt_monitor->lls_sls_alc_monitor->lls_alc_session && lls_slt_monitor->lls_sls_alc_monitor->lls_alc_session->service_id == matching_lls_slt_alc_session->service_id) {
@@ -224,6 +234,9 @@ ret:
 }
 
 void process_packet(u_char *user, const struct pcap_pkthdr *pkthdr, const u_char *packet) {
+	//nothing from the previous packet is still referenced here, lets retired flow dispatch tables be freed
+	atsc3_qsbr_quiescent();
+
 	udp_packet_t* udp_packet = process_packet_from_pcap(user, pkthdr, packet);
 
 	if(!udp_packet) {
@@ -237,8 +250,11 @@ void process_packet(u_char *user, const struct pcap_pkthdr *pkthdr, const u_char
 	global_bandwidth_statistics->grand_total_packets_rx++;
 	global_stats->packets_total_received++;
 
+	//one probe of the compiled SLT flow table instead of walking the ALC and MMT session vectors
+	atsc3_flow_dispatch_entry_t atsc3_flow_dispatch_entry = atsc3_flow_dispatch_find(lls_slt_monitor, udp_packet->udp_flow.src_ip_addr, udp_packet->udp_flow.dst_ip_addr, udp_packet->udp_flow.dst_port);
+
 	//drop mdNS
-	if(udp_packet->udp_flow.dst_ip_addr == UDP_FILTER_MDNS_IP_ADDRESS && udp_packet->udp_flow.dst_port == UDP_FILTER_MDNS_PORT) {
+	if(atsc3_flow_dispatch_entry.kind == ATSC3_FLOW_DISPATCH_MDNS) {
 		global_stats->packet_counter_filtered_ipv4++;
 		//printf("setting dns current_bytes_rx: %d, packets_rx: %d", global_bandwidth_statistics->interval_filtered_current_bytes_rx, global_bandwidth_statistics->interval_filtered_current_packets_rx);
 		global_bandwidth_statistics->interval_filtered_current_bytes_rx += udp_packet->data_length;
@@ -247,7 +263,7 @@ void process_packet(u_char *user, const struct pcap_pkthdr *pkthdr, const u_char
 		return cleanup(&udp_packet);
 	}
 
-	if(udp_packet->udp_flow.dst_ip_addr == LLS_DST_ADDR && udp_packet->udp_flow.dst_port == LLS_DST_PORT) {
+	if(atsc3_flow_dispatch_entry.kind == ATSC3_FLOW_DISPATCH_LLS) {
 		global_bandwidth_statistics->interval_lls_current_bytes_rx += udp_packet->data_length;
 		global_bandwidth_statistics->interval_lls_current_packets_rx++;
 
@@ -261,13 +277,8 @@ void process_packet(u_char *user, const struct pcap_pkthdr *pkthdr, const u_char
 			if(lls_table->lls_table_id == SLT) {
 
 				global_stats->packet_counter_lls_slt_packets_parsed++;
-				int retval = lls_slt_table_perform_update(lls_table, lls_slt_monitor);
-
-				if(!retval) {
-					global_stats->packet_counter_lls_slt_update_processed++;
-				} else {
-					global_stats->packet_counter_lls_slt_packets_parsed_error++;
-				}
+				//create_or_update has already applied the SLT and rebuilt the flow table
+				global_stats->packet_counter_lls_slt_update_processed++;
 			}
 		}
 
@@ -290,24 +301,40 @@ void process_packet(u_char *user, const struct pcap_pkthdr *pkthdr, const u_char
     }
 
 	//ALC (ROUTE) - If this flow is registered from the SLT, process it as ALC, otherwise run the flow thru MMT
-	lls_sls_alc_session_t* matching_lls_slt_alc_session = lls_slt_alc_session_find_from_udp_packet(lls_slt_monitor, udp_packet->udp_flow.src_ip_addr, udp_packet->udp_flow.dst_ip_addr, udp_packet->udp_flow.dst_port);
-	if(matching_lls_slt_alc_session) {
+	if(atsc3_flow_dispatch_entry.kind == ATSC3_FLOW_DISPATCH_ALC) {
+		lls_sls_alc_session_t* matching_lls_slt_alc_session = atsc3_flow_dispatch_entry.lls_sls_alc_session;
 		global_bandwidth_statistics->interval_alc_current_bytes_rx += udp_packet->data_length;
 		global_bandwidth_statistics->interval_alc_current_packets_rx++;
 		global_stats->packet_counter_alc_recv++;
 
+        //for the monitored service, drop LCT channels nothing consumes before alc_rx parses them. unmonitored services
+        //keep going through alc_rx for their ALC stats and route/ object dumps
+        uint32_t tsi = 0;
+        if(atsc3_flow_dispatch_entry.lls_sls_alc_monitor &&
+        		alc_rx_peek_tsi((char*)udp_packet->data, udp_packet->data_length, &tsi) &&
+        		!alc_recon_monitor_is_tsi_subscribed(atsc3_flow_dispatch_entry.lls_sls_alc_monitor, udp_packet->udp_flow.dst_ip_addr, udp_packet->udp_flow.dst_port, tsi)) {
+        	global_stats->packet_counter_alc_packets_filtered++;
+        	return cleanup(&udp_packet);
+        }
+
         alc_packet_t* alc_packet = route_parse_from_udp_packet(matching_lls_slt_alc_session, udp_packet);
         if(alc_packet) {
             route_process_from_alc_packet(&alc_packet);
             alc_packet_free(&alc_packet);
         }
+
+        //a new S-TSID may announce ROUTE sessions on other flows
+        if(atsc3_flow_dispatch_entry.lls_sls_alc_monitor && atsc3_flow_dispatch_entry.lls_sls_alc_monitor->atsc3_route_s_tsid_updated) {
+        	atsc3_flow_dispatch_entry.lls_sls_alc_monitor->atsc3_route_s_tsid_updated = false;
+        	atsc3_flow_dispatch_rebuild(lls_slt_monitor);
+        }
         
         return cleanup(&udp_packet);
 	}
 
 	//find our matching MMT flow and push it to reconsitution
-    lls_sls_mmt_session_t* matching_lls_slt_mmt_session = lls_slt_mmt_session_find_from_udp_packet(lls_slt_monitor, udp_packet->udp_flow.src_ip_addr, udp_packet->udp_flow.dst_ip_addr, udp_packet->udp_flow.dst_port);
-    if(matching_lls_slt_mmt_session) {
+    if(atsc3_flow_dispatch_entry.kind == ATSC3_FLOW_DISPATCH_MMT) {
+        lls_sls_mmt_session_t* matching_lls_slt_mmt_session = atsc3_flow_dispatch_entry.lls_sls_mmt_session;
         __TRACE("data len: %d", udp_packet->data_length)
         mmtp_payload_fragments_union_t * mmtp_payload = mmtp_parse_from_udp_packet(udp_packet);
 
@@ -338,6 +365,24 @@ cleanup:
 void* pcap_loop_run_thread(void* dev_pointer) {
 	char* dev = (char*) dev_pointer;
 
+	//offline ingest, replay a pcap/pcapng capture at its original timestamps
+	if(atsc3_pcap_replay_is_file(dev)) {
+		atsc3_pcap_replay_run_from_file(dev, ATSC3_PCAP_REPLAY_MODE_PACED, process_packet);
+		return 0;
+	}
+
+	//native linux capture from a TPACKET_V3 mmap ring, dev: af_packet:<interface>
+	if(atsc3_af_packet_capture_is_dev(dev)) {
+		atsc3_af_packet_capture_run(dev, process_packet);
+		return 0;
+	}
+
+	//join the LLS group and the SLT announced flows only, dev: multicast:<interface>
+	if(atsc3_multicast_receiver_is_dev(dev)) {
+		atsc3_multicast_receiver_run(dev, process_packet, lls_slt_monitor);
+		return 0;
+	}
+
 	char errbuf[PCAP_ERRBUF_SIZE];
 	pcap_t* descr;
 	struct bpf_program fp;
@@ -387,6 +432,9 @@ int main(int argc,char **argv) {
     _ALC_UTILS_TRACE_ENABLED = 1;
     _ISOBMFFTRACKJOINER_DEBUG_ENABLED = 0;
 
+    //format and write debug output on a background thread, off the pcap thread
+    atsc3_log_async_start();
+
     char *dev;
 
     char *filter_dst_ip = NULL;
@@ -448,7 +496,9 @@ int main(int argc,char **argv) {
     	println("%s - a udp mulitcast listener test harness for atsc3 mmt messages", argv[0]);
     	println("---");
     	println("args: dev (dst_ip) (dst_port) (packet_id)");
-    	println(" dev: device to listen for udp multicast, default listen to 0.0.0.0:0");
+    	println(" dev: device to listen for udp multicast, default listen to 0.0.0.0:0, or a pcap/pcapng capture file to replay");
+    	println("      af_packet:<interface> captures from a linux TPACKET_V3 mmap ring instead of libpcap");
+    	println("      multicast:<interface> joins the LLS group and the flows announced in the SLT, no promiscuous capture");
     	println(" (dst_ip): optional, filter to specific ip address");
     	println(" (dst_port): optional, filter to specific port");
     	println(" (packet_id): optional, filter to specific packet_id across all streams");
@@ -462,6 +512,7 @@ int main(int argc,char **argv) {
 
     mmtp_sub_flow_vector = (mmtp_sub_flow_vector_t*)calloc(1, sizeof(*mmtp_sub_flow_vector));
     mmtp_sub_flow_vector_init(mmtp_sub_flow_vector);
+    mpu_retention_policy_set(MPU_RETENTION_DEFAULT_MAX_MPUS_PER_SUB_FLOW, MPU_RETENTION_DEFAULT_MAX_AGE_MS, MPU_RETENTION_DEFAULT_MAX_BYTES_HELD);
     udp_flow_latest_mpu_sequence_number_container = udp_flow_latest_mpu_sequence_number_container_t_init();
 
     lls_slt_monitor = lls_slt_monitor_create();
@@ -0,0 +1,253 @@
+/*
+ * atsc3_mmtp_header_decoder_benchmark.cpp
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: jjustman
+ *
+ * microbenchmark for the MMTP packet header + MPU payload header decode, headers/s of
+ * atsc3_mmtp_header_decoder vs. the previous extract() into stack array implementation
+ *
+ * every MMTP udp payload in the capture (LLS excluded) is loaded into memory once, then each
+ * decoder walks the full set N times. fields both implementations agree on are cross checked,
+ * mismatches are expected for packets with the Q flag set, as the previous decoder read X from the Q bit
+ *
+ * usage:
+ *
+ * 	./atsc3_mmtp_header_decoder_benchmark capture.pcap (iterations)
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "../atsc3_listener_udp.h"
+#include "../atsc3_pcap_replay.h"
+#include "../atsc3_utils.h"
+#include "../atsc3_lls.h"
+#include "../atsc3_mmtp_header_decoder.h"
+
+#define MMTP_HEADER_DECODER_BENCHMARK_DEFAULT_ITERATIONS	200
+
+typedef struct mmtp_header_decoder_benchmark_packet {
+	uint8_t*	data;
+	uint32_t	data_length;
+} mmtp_header_decoder_benchmark_packet_t;
+
+mmtp_header_decoder_benchmark_packet_t* packets = NULL;
+uint32_t packets_n = 0;
+uint32_t packets_allocated = 0;
+
+void process_packet(u_char *user, const struct pcap_pkthdr *pkthdr, const u_char *packet) {
+	udp_packet_t* udp_packet = process_packet_from_pcap(user, pkthdr, packet);
+	if(!udp_packet) {
+		return;
+	}
+
+	if((udp_packet->udp_flow.dst_ip_addr == LLS_DST_ADDR && udp_packet->udp_flow.dst_port == LLS_DST_PORT) ||
+		udp_packet->data_length < MMTP_PACKET_HEADER_FIXED_MIN_LEN ||
+		(udp_packet->data[0] >> 6) != 0x1 || (udp_packet->data[1] & 0xF) > 0x2) {
+		return cleanup(&udp_packet);
+	}
+
+	if(packets_n == packets_allocated) {
+		packets_allocated = packets_allocated ? packets_allocated * 2 : 4096;
+		packets = (mmtp_header_decoder_benchmark_packet_t*)realloc(packets, packets_allocated * sizeof(mmtp_header_decoder_benchmark_packet_t));
+	}
+
+	packets[packets_n].data = (uint8_t*)malloc(udp_packet->data_length);
+	memcpy(packets[packets_n].data, udp_packet->data, udp_packet->data_length);
+	packets[packets_n].data_length = udp_packet->data_length;
+	packets_n++;
+
+	return cleanup(&udp_packet);
+}
+
+/*
+ * previous mmtp_packet_header_parse_from_raw_packet and mmt_mpu_parse_payload header handling, kept as the baseline
+ */
+static uint8_t* mmtp_header_decode_extract(uint8_t* udp_raw_buf, int udp_raw_buf_size, mmtp_packet_header_fixed_t* h, mmt_mpu_payload_header_fixed_t* m) {
+	if(udp_raw_buf_size < 20) {
+		return NULL;
+	}
+
+	uint8_t *buf = udp_raw_buf;
+	uint8_t mmtp_packet_preamble[20];
+	buf = (uint8_t*)extract(buf, mmtp_packet_preamble, 20);
+
+	h->mmtp_packet_version = (mmtp_packet_preamble[0] & 0xC0) >> 6;
+	if(h->mmtp_packet_version != 0x1) {
+		return NULL;
+	}
+
+	h->packet_counter_flag = (mmtp_packet_preamble[0] & 0x20) >> 5;
+	h->fec_type = (mmtp_packet_preamble[0] & 0x18) >> 3;
+	h->mmtp_header_extension_flag = mmtp_packet_preamble[0] & 0x4 >> 2;
+	h->mmtp_rap_flag = (mmtp_packet_preamble[0] & 0x2) >> 1;
+	h->mmtp_qos_flag = mmtp_packet_preamble[0] & 0x1;
+	h->mmtp_flow_identifer_flag = ((mmtp_packet_preamble[1]) & 0x80) >> 7;
+	h->mmtp_flow_extension_flag = ((mmtp_packet_preamble[1]) & 0x40) >> 6;
+	h->mmtp_header_compression = ((mmtp_packet_preamble[1]) &  0x20) >> 5;
+	h->mmtp_indicator_ref_header_flag = ((mmtp_packet_preamble[1]) & 0x10) >> 4;
+	h->mmtp_payload_type = mmtp_packet_preamble[1] & 0xF;
+	h->mmtp_type_of_bitrate = ((mmtp_packet_preamble[16] & 0x40) >> 6) | ((mmtp_packet_preamble[16] & 0x20) >> 5);
+	h->mmtp_delay_sensitivity = ((mmtp_packet_preamble[16] & 0x10) >> 4) | ((mmtp_packet_preamble[16] & 0x8) >> 3) | ((mmtp_packet_preamble[16] & 0x4) >> 2);
+	h->mmtp_transmission_priority =(( mmtp_packet_preamble[16] & 0x02) << 2) | ((mmtp_packet_preamble[16] & 0x1) << 1) | ((mmtp_packet_preamble[17] & 0x80) >>7);
+	h->flow_label = mmtp_packet_preamble[17] & 0x7f;
+
+	if(h->mmtp_header_extension_flag & 0x1) {
+		h->mmtp_header_extension_type = (mmtp_packet_preamble[18] << 8) | mmtp_packet_preamble[19];
+		uint8_t mmtp_header_extension_length_bytes[2];
+		buf = (uint8_t*)extract(buf, mmtp_header_extension_length_bytes, 2);
+		h->mmtp_header_extension_length = mmtp_header_extension_length_bytes[0] << 8 | mmtp_header_extension_length_bytes[1];
+	} else {
+		buf-=2;
+	}
+
+	h->mmtp_packet_id			= mmtp_packet_preamble[2]  << 8  | mmtp_packet_preamble[3];
+	h->mmtp_timestamp 			= mmtp_packet_preamble[4]  << 24 | mmtp_packet_preamble[5]  << 16 | mmtp_packet_preamble[6]   << 8 | mmtp_packet_preamble[7];
+	h->packet_sequence_number	= mmtp_packet_preamble[8]  << 24 | mmtp_packet_preamble[9]  << 16 | mmtp_packet_preamble[10]  << 8 | mmtp_packet_preamble[11];
+
+	if(h->packet_counter_flag) {
+		h->packet_counter 		= mmtp_packet_preamble[12] << 24 | mmtp_packet_preamble[13] << 16 | mmtp_packet_preamble[14]  << 8 | mmtp_packet_preamble[15];
+	} else {
+		buf-=4;
+	}
+
+	if(h->mmtp_payload_type != 0x0 || udp_raw_buf_size - (buf - udp_raw_buf) < MMT_MPU_PAYLOAD_HEADER_LEN) {
+		return buf;
+	}
+
+	uint8_t mpu_payload_length_block[2];
+	buf = (uint8_t*)extract(buf, (uint8_t*)&mpu_payload_length_block, 2);
+	m->mpu_payload_length = (mpu_payload_length_block[0] << 8) | mpu_payload_length_block[1];
+
+	uint8_t mpu_fragmentation_info;
+	buf = (uint8_t*)extract(buf, &mpu_fragmentation_info, 1);
+	m->mpu_fragment_type = (mpu_fragmentation_info & 0xF0) >> 4;
+	m->mpu_timed_flag = (mpu_fragmentation_info & 0x8) >> 3;
+	m->mpu_fragmentation_indicator = (mpu_fragmentation_info & 0x6) >> 1;
+	m->mpu_aggregation_flag = (mpu_fragmentation_info & 0x1);
+
+	uint8_t mpu_fragmentation_counter;
+	buf = (uint8_t*)extract(buf, &mpu_fragmentation_counter, 1);
+	m->mpu_fragmentation_counter = mpu_fragmentation_counter;
+
+	uint8_t mpu_sequence_number_block[4];
+	buf = (uint8_t*)extract(buf, (uint8_t*)&mpu_sequence_number_block, 4);
+	m->mpu_sequence_number = (mpu_sequence_number_block[0] << 24)  | (mpu_sequence_number_block[1] <<16) | (mpu_sequence_number_block[2] << 8) | (mpu_sequence_number_block[3]);
+
+	return buf;
+}
+
+static const uint8_t* mmtp_header_decode_fixed(const uint8_t* udp_raw_buf, uint32_t udp_raw_buf_size, mmtp_packet_header_fixed_t* h, mmt_mpu_payload_header_fixed_t* m) {
+	uint32_t header_length = mmtp_packet_header_fixed_decode(udp_raw_buf, udp_raw_buf_size, h);
+	if(!header_length) {
+		return NULL;
+	}
+
+	if(h->mmtp_payload_type == 0x0) {
+		header_length += mmt_mpu_payload_header_fixed_decode(udp_raw_buf + header_length, udp_raw_buf_size - header_length, m);
+	}
+
+	return udp_raw_buf + header_length;
+}
+
+static double mmtp_header_decoder_benchmark_elapsed_s(struct timespec* start) {
+	struct timespec stop;
+	clock_gettime(CLOCK_MONOTONIC, &stop);
+	return (stop.tv_sec - start->tv_sec) + (stop.tv_nsec - start->tv_nsec) / 1e9;
+}
+
+int main(int argc,char **argv) {
+	if(argc < 2) {
+		println("%s - benchmark MMTP/MPU header decoding against the previous extract() implementation", argv[0]);
+		println("---");
+		println("args: capture (iterations)");
+		println(" capture: pcap or pcapng file");
+		println(" (iterations): optional, default %d passes over every MMTP packet", MMTP_HEADER_DECODER_BENCHMARK_DEFAULT_ITERATIONS);
+		println("");
+		exit(1);
+	}
+
+	int iterations = argc >= 3 ? atoi(argv[2]) : MMTP_HEADER_DECODER_BENCHMARK_DEFAULT_ITERATIONS;
+	if(iterations <= 0) {
+		iterations = MMTP_HEADER_DECODER_BENCHMARK_DEFAULT_ITERATIONS;
+	}
+
+	atsc3_pcap_replay_context_t* atsc3_pcap_replay_context = atsc3_pcap_replay_open_from_file(argv[1], ATSC3_PCAP_REPLAY_MODE_MAX_SPEED);
+	if(!atsc3_pcap_replay_context) {
+		println("unable to open capture: %s", argv[1]);
+		exit(1);
+	}
+	atsc3_pcap_replay_loop(atsc3_pcap_replay_context, process_packet, 0);
+	atsc3_pcap_replay_free(&atsc3_pcap_replay_context);
+
+	if(!packets_n) {
+		println("no MMTP packets found in: %s", argv[1]);
+		exit(1);
+	}
+
+	//cross check the fields both implementations decode the same way
+	uint32_t mismatches = 0;
+	for(uint32_t i = 0; i < packets_n; i++) {
+		mmtp_packet_header_fixed_t h_extract = { 0 }, h_fixed = { 0 };
+		mmt_mpu_payload_header_fixed_t m_extract = { 0 }, m_fixed = { 0 };
+
+		uint8_t* extract_ret = mmtp_header_decode_extract(packets[i].data, packets[i].data_length, &h_extract, &m_extract);
+		const uint8_t* fixed_ret = mmtp_header_decode_fixed(packets[i].data, packets[i].data_length, &h_fixed, &m_fixed);
+
+		if(!extract_ret != !fixed_ret ||
+			h_extract.mmtp_packet_id != h_fixed.mmtp_packet_id ||
+			h_extract.mmtp_payload_type != h_fixed.mmtp_payload_type ||
+			h_extract.mmtp_timestamp != h_fixed.mmtp_timestamp ||
+			h_extract.packet_sequence_number != h_fixed.packet_sequence_number ||
+			h_extract.packet_counter != h_fixed.packet_counter ||
+			memcmp(&m_extract, &m_fixed, sizeof(m_fixed))) {
+			mismatches++;
+		}
+	}
+
+	//keep the compiler from dropping the decode loops
+	volatile uint64_t sink = 0;
+	struct timespec start;
+
+	clock_gettime(CLOCK_MONOTONIC, &start);
+	for(int j = 0; j < iterations; j++) {
+		for(uint32_t i = 0; i < packets_n; i++) {
+			mmtp_packet_header_fixed_t h;
+			mmt_mpu_payload_header_fixed_t m;
+			m.mpu_sequence_number = 0;
+			uint8_t* ret = mmtp_header_decode_extract(packets[i].data, packets[i].data_length, &h, &m);
+			sink += (ret - packets[i].data) + h.packet_sequence_number + m.mpu_sequence_number;
+		}
+	}
+	double extract_s = mmtp_header_decoder_benchmark_elapsed_s(&start);
+
+	clock_gettime(CLOCK_MONOTONIC, &start);
+	for(int j = 0; j < iterations; j++) {
+		for(uint32_t i = 0; i < packets_n; i++) {
+			mmtp_packet_header_fixed_t h;
+			mmt_mpu_payload_header_fixed_t m;
+			m.mpu_sequence_number = 0;
+			const uint8_t* ret = mmtp_header_decode_fixed(packets[i].data, packets[i].data_length, &h, &m);
+			sink += (ret - packets[i].data) + h.packet_sequence_number + m.mpu_sequence_number;
+		}
+	}
+	double fixed_s = mmtp_header_decoder_benchmark_elapsed_s(&start);
+
+	double headers = (double)packets_n * iterations;
+
+	println("---mmtp header decode---");
+	println(" mmtp packets: %u, iterations: %d, field mismatches: %u", packets_n, iterations, mismatches);
+	println(" extract:  %8.3f s, %12.0f headers/s, %6.1f ns/header", extract_s, headers / extract_s, extract_s * 1e9 / headers);
+	println(" fixed:    %8.3f s, %12.0f headers/s, %6.1f ns/header", fixed_s, headers / fixed_s, fixed_s * 1e9 / headers);
+	println(" speedup:  %.2fx", extract_s / fixed_s);
+
+	for(uint32_t i = 0; i < packets_n; i++) {
+		free(packets[i].data);
+	}
+	free(packets);
+
+	return 0;
+}
@@ -0,0 +1,248 @@
+/*
+ * atsc3_pcap_replay_benchmark.cpp
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: jjustman
+ *
+ * receive chain regression benchmark: replays a pcap/pcapng capture through the same
+ * LLS -> SLT -> ALC/MMT -> MPU reconstitution path as atsc3_listener_metrics_ncurses,
+ * without the ncurses ui, and reports packets/s, bytes/s and per-stage time at the end
+ *
+ * usage:
+ *
+ * 	./atsc3_pcap_replay_benchmark capture.pcap (max|paced) (service_id)
+ *
+ * 	(max|paced):	optional, default max - deliver back to back, or at original capture timestamps
+ * 	(service_id):	optional, MMT service to monitor once its MPT packet_id's are known, enabling ISOBMFF reconstitution
+ */
+
+int PACKET_COUNTER=0;
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <limits.h>
+
+#include "../bento4/ISOBMFFTrackJoiner.h"
+#include "../atsc3_isobmff_tools.h"
+
+#include "../atsc3_listener_udp.h"
+#include "../atsc3_pcap_replay.h"
+#include "../atsc3_utils.h"
+
+#include "../atsc3_lls.h"
+#include "../atsc3_lls_alc_utils.h"
+
+#include "../atsc3_lls_slt_parser.h"
+#include "../atsc3_flow_dispatch.h"
+#include "../atsc3_lls_sls_monitor_output_buffer_utils.h"
+
+#include "../atsc3_mmtp_types.h"
+#include "../atsc3_mmtp_parser.h"
+#include "../atsc3_mmtp_ntp32_to_pts.h"
+#include "../atsc3_mmt_mpu_utils.h"
+#include "../atsc3_mmt_reconstitution_from_media_sample.h"
+
+#include "../alc_channel.h"
+#include "../atsc3_alc_rx.h"
+#include "../atsc3_alc_utils.h"
+
+#include "../atsc3_bandwidth_statistics.h"
+#include "../atsc3_packet_statistics.h"
+#include "../atsc3_latency_histogram.h"
+
+#include "../atsc3_logging.h"
+#include "../atsc3_logging_externs.h"
+
+lls_slt_monitor_t* lls_slt_monitor;
+
+mmtp_sub_flow_vector_t*                          mmtp_sub_flow_vector;
+udp_flow_latest_mpu_sequence_number_container_t* udp_flow_latest_mpu_sequence_number_container;
+global_atsc3_stats_t* global_stats;
+
+uint16_t* monitor_service_id = NULL;
+
+//once the MPT for our service has been processed, monitor its audio/video packet_id's, mirrors the ncurses 's' selection
+void mmt_monitor_service_if_ready(lls_sls_mmt_session_t* matching_lls_slt_mmt_session) {
+	if(!monitor_service_id || lls_slt_monitor->lls_sls_mmt_monitor || matching_lls_slt_mmt_session->service_id != *monitor_service_id) {
+		return;
+	}
+
+	if(!matching_lls_slt_mmt_session->video_packet_id || !matching_lls_slt_mmt_session->audio_packet_id) {
+		return;
+	}
+
+	lls_sls_mmt_monitor_t* lls_sls_mmt_monitor = lls_sls_mmt_monitor_create();
+	lls_sls_mmt_monitor->lls_mmt_session = matching_lls_slt_mmt_session;
+	lls_sls_mmt_monitor->service_id = matching_lls_slt_mmt_session->service_id;
+	lls_sls_mmt_monitor->video_packet_id = matching_lls_slt_mmt_session->video_packet_id;
+	lls_sls_mmt_monitor->audio_packet_id = matching_lls_slt_mmt_session->audio_packet_id;
+	lls_slt_monitor->lls_sls_mmt_monitor = lls_sls_mmt_monitor;
+	atsc3_flow_dispatch_rebuild(lls_slt_monitor);
+
+	__INFO("monitoring service_id: %u, video packet_id: %u, audio packet_id: %u", lls_sls_mmt_monitor->service_id, lls_sls_mmt_monitor->video_packet_id, lls_sls_mmt_monitor->audio_packet_id);
+}
+
+void process_packet(u_char *user, const struct pcap_pkthdr *pkthdr, const u_char *packet) {
+	atsc3_pcap_replay_context_t* atsc3_pcap_replay_context = (atsc3_pcap_replay_context_t*)user;
+
+	//nothing from the previous packet is still referenced here, lets retired flow dispatch tables be freed
+	atsc3_qsbr_quiescent();
+
+	atsc3_pcap_replay_stage_start(atsc3_pcap_replay_context, ATSC3_PCAP_REPLAY_STAGE_UDP);
+	udp_packet_t* udp_packet = process_packet_from_pcap(user, pkthdr, packet);
+	atsc3_pcap_replay_stage_stop(atsc3_pcap_replay_context, ATSC3_PCAP_REPLAY_STAGE_UDP);
+
+	if(!udp_packet) {
+		return;
+	}
+
+	global_stats->packets_total_received++;
+
+	//one probe of the compiled SLT flow table instead of walking the ALC and MMT session vectors
+	atsc3_flow_dispatch_entry_t atsc3_flow_dispatch_entry = atsc3_flow_dispatch_find(lls_slt_monitor, udp_packet->udp_flow.src_ip_addr, udp_packet->udp_flow.dst_ip_addr, udp_packet->udp_flow.dst_port);
+
+	//drop mdNS
+	if(atsc3_flow_dispatch_entry.kind == ATSC3_FLOW_DISPATCH_MDNS) {
+		global_stats->packet_counter_filtered_ipv4++;
+		return cleanup(&udp_packet);
+	}
+
+	if(atsc3_flow_dispatch_entry.kind == ATSC3_FLOW_DISPATCH_LLS) {
+		global_stats->packet_counter_lls_packets_received++;
+
+		atsc3_pcap_replay_stage_start(atsc3_pcap_replay_context, ATSC3_PCAP_REPLAY_STAGE_LLS);
+		lls_table_t* lls_table = lls_table_create_or_update_from_lls_slt_monitor_with_metrics(lls_slt_monitor, udp_packet->data, udp_packet->data_length, &global_stats->packet_counter_lls_packets_parsed, &global_stats->packet_counter_lls_packets_parsed_update, &global_stats->packet_counter_lls_packets_parsed_error);
+		if(lls_table && lls_table->lls_table_id == SLT) {
+			global_stats->packet_counter_lls_slt_packets_parsed++;
+			//create_or_update has already applied the SLT and rebuilt the flow table
+			global_stats->packet_counter_lls_slt_update_processed++;
+		}
+		atsc3_pcap_replay_stage_stop(atsc3_pcap_replay_context, ATSC3_PCAP_REPLAY_STAGE_LLS);
+
+		return cleanup(&udp_packet);
+	}
+
+	if(atsc3_flow_dispatch_entry.kind == ATSC3_FLOW_DISPATCH_ALC) {
+		lls_sls_alc_session_t* matching_lls_slt_alc_session = atsc3_flow_dispatch_entry.lls_sls_alc_session;
+		global_stats->packet_counter_alc_recv++;
+
+		if(matching_lls_slt_alc_session->alc_session) {
+			alc_packet_t* alc_packet = NULL;
+			alc_channel_t ch;
+			ch.s = matching_lls_slt_alc_session->alc_session;
+
+			atsc3_pcap_replay_stage_start(atsc3_pcap_replay_context, ATSC3_PCAP_REPLAY_STAGE_ALC);
+			if(!alc_rx_analyze_packet_a331_compliant((char*)udp_packet->data, udp_packet->data_length, &ch, &alc_packet)) {
+				global_stats->packet_counter_alc_packets_parsed++;
+				atsc3_packet_statistics_alc_stats_populate(udp_packet, alc_packet);
+				__LATENCY_HISTOGRAM_RECORD(matching_lls_slt_alc_session->service_id, ATSC3_LATENCY_STAGE_PARSE);
+			} else {
+				global_stats->packet_counter_alc_packets_parsed_error++;
+			}
+			alc_packet_free(&alc_packet);
+			atsc3_pcap_replay_stage_stop(atsc3_pcap_replay_context, ATSC3_PCAP_REPLAY_STAGE_ALC);
+		}
+
+		return cleanup(&udp_packet);
+	}
+
+	if(atsc3_flow_dispatch_entry.kind == ATSC3_FLOW_DISPATCH_MMT) {
+		lls_sls_mmt_session_t* matching_lls_slt_mmt_session = atsc3_flow_dispatch_entry.lls_sls_mmt_session;
+		atsc3_pcap_replay_stage_start(atsc3_pcap_replay_context, ATSC3_PCAP_REPLAY_STAGE_MMTP);
+		mmtp_payload_fragments_union_t* mmtp_payload = mmtp_packet_parse(mmtp_sub_flow_vector, udp_packet->data, udp_packet->data_length);
+		atsc3_pcap_replay_stage_stop(atsc3_pcap_replay_context, ATSC3_PCAP_REPLAY_STAGE_MMTP);
+
+		if(!mmtp_payload) {
+			global_stats->packet_counter_mmtp_packets_parsed_error++;
+			return cleanup(&udp_packet);
+		}
+		global_stats->packet_counter_mmtp_packets_received++;
+		atsc3_packet_statistics_mmt_stats_populate(udp_packet, mmtp_payload);
+
+		atsc3_pcap_replay_stage_start(atsc3_pcap_replay_context, ATSC3_PCAP_REPLAY_STAGE_MMT_RECONSTITUTION);
+		mmtp_process_from_payload(mmtp_sub_flow_vector, udp_flow_latest_mpu_sequence_number_container, lls_slt_monitor, udp_packet, &mmtp_payload, matching_lls_slt_mmt_session);
+		atsc3_pcap_replay_stage_stop(atsc3_pcap_replay_context, ATSC3_PCAP_REPLAY_STAGE_MMT_RECONSTITUTION);
+
+		mmt_monitor_service_if_ready(matching_lls_slt_mmt_session);
+
+		return cleanup(&udp_packet);
+	}
+
+	global_stats->packet_counter_udp_unknown++;
+	return cleanup(&udp_packet);
+}
+
+int main(int argc,char **argv) {
+
+	_MPU_DEBUG_ENABLED = 0;
+	_MMTP_DEBUG_ENABLED = 0;
+	_MMT_MPU_DEBUG_ENABLED = 0;
+	_LLS_DEBUG_ENABLED = 0;
+	_ISOBMFF_TOOLS_DEBUG_ENABLED = 0;
+	_ALC_UTILS_DEBUG_ENABLED = 0;
+	_ISOBMFFTRACKJOINER_DEBUG_ENABLED = 0;
+
+	//format and write debug output on a background thread, off the pcap thread
+	atsc3_log_async_start();
+
+	atsc3_pcap_replay_mode_t mode = ATSC3_PCAP_REPLAY_MODE_MAX_SPEED;
+
+	if(argc < 2) {
+		println("%s - replay a pcap/pcapng capture through the atsc3 receive chain and report throughput", argv[0]);
+		println("---");
+		println("args: capture (max|paced) (service_id)");
+		println(" capture: pcap or pcapng file");
+		println(" (max|paced): optional, default max, deliver back to back or at original capture timestamps");
+		println(" (service_id): optional, MMT service_id to monitor for ISOBMFF reconstitution");
+		println("");
+		exit(1);
+	}
+
+	if(argc >= 3 && !strncmp("paced", argv[2], 5)) {
+		mode = ATSC3_PCAP_REPLAY_MODE_PACED;
+	}
+
+	if(argc >= 4) {
+		monitor_service_id = (uint16_t*)calloc(1, sizeof(uint16_t));
+		*monitor_service_id = atoi(argv[3]) & 0xFFFF;
+	}
+
+	mkdir("mpu", 0777);
+
+	mmtp_sub_flow_vector = (mmtp_sub_flow_vector_t*)calloc(1, sizeof(*mmtp_sub_flow_vector));
+	mmtp_sub_flow_vector_init(mmtp_sub_flow_vector);
+	mpu_retention_policy_set(MPU_RETENTION_DEFAULT_MAX_MPUS_PER_SUB_FLOW, MPU_RETENTION_DEFAULT_MAX_AGE_MS, MPU_RETENTION_DEFAULT_MAX_BYTES_HELD);
+	udp_flow_latest_mpu_sequence_number_container = udp_flow_latest_mpu_sequence_number_container_t_init();
+
+	lls_slt_monitor = lls_slt_monitor_create();
+
+	global_stats = (global_atsc3_stats*)calloc(1, sizeof(*global_stats));
+	gettimeofday(&global_stats->program_timeval_start, 0);
+
+	int packets_delivered = atsc3_pcap_replay_run_from_file(argv[1], mode, process_packet);
+
+	println("---receive chain---");
+	println(" lls packets: %u, mmtp packets: %u (parse errors: %u), alc packets: %u (parse errors: %u), unknown udp: %u",
+			global_stats->packet_counter_lls_packets_received,
+			global_stats->packet_counter_mmtp_packets_received, global_stats->packet_counter_mmtp_packets_parsed_error,
+			global_stats->packet_counter_alc_packets_parsed, global_stats->packet_counter_alc_packets_parsed_error,
+			global_stats->packet_counter_udp_unknown);
+
+#ifdef __LATENCY_HISTOGRAM_ENABLED
+	println("---latency histograms---");
+	atsc3_latency_histogram_dump(stdout);
+#endif
+
+	atsc3_log_async_stop();
+
+	atsc3_log_statistics_t atsc3_log_statistics;
+	atsc3_log_statistics_get(&atsc3_log_statistics);
+	println("---logging---");
+	println(" records written: %llu, dropped: %llu, truncated: %llu",
+			(unsigned long long)atsc3_log_statistics.records_written, (unsigned long long)atsc3_log_statistics.records_dropped, (unsigned long long)atsc3_log_statistics.records_truncated);
+
+	return packets_delivered < 0 ? 1 : 0;
+}
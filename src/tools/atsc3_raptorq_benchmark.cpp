@@ -0,0 +1,128 @@
+/*
+ * atsc3_raptorq_benchmark.cpp
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: jjustman
+ *
+ * RaptorQ source block decode throughput at increasing symbol loss
+ *
+ * for each K, a random source block is encoded once, then each iteration drops loss% of the
+ * source symbols, feeds the survivors plus just enough repair symbols (K + 2 overhead) into a
+ * fresh block decoder and times the decode. throughput is recovered source bytes per second.
+ *
+ * run once as-is and once with ATSC3_GF256_IMPL=scalar to compare the vectorized row operations
+ * against the portable path
+ *
+ * usage:
+ *
+ * 	./atsc3_raptorq_benchmark (symbol_size) (iterations)
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "../atsc3_raptorq.h"
+
+#define RAPTORQ_BENCHMARK_DEFAULT_SYMBOL_SIZE	1312
+#define RAPTORQ_BENCHMARK_DEFAULT_ITERATIONS	5
+#define RAPTORQ_BENCHMARK_OVERHEAD				2
+
+static const uint32_t benchmark_k[] = { 64, 256, 1024 };
+static const uint32_t benchmark_loss_pct[] = { 0, 5, 10, 20, 30 };
+
+static double now_sec() {
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+int main(int argc, char* argv[]) {
+	uint16_t symbol_size = argc > 1 ? atoi(argv[1]) : RAPTORQ_BENCHMARK_DEFAULT_SYMBOL_SIZE;
+	uint32_t iterations = argc > 2 ? atoi(argv[2]) : RAPTORQ_BENCHMARK_DEFAULT_ITERATIONS;
+	if(!symbol_size || !iterations) {
+		printf("usage: %s (symbol_size) (iterations)\n", argv[0]);
+		return 1;
+	}
+
+	atsc3_gf256_init();
+	printf("atsc3_raptorq_benchmark: T: %u, iterations: %u, gf256 row ops: %s\n", symbol_size, iterations, atsc3_gf256_impl_name());
+	printf("%6s %6s %10s %12s %10s\n", "K", "loss%", "failed", "ms/block", "MB/s");
+
+	srand(6330);
+	for(uint32_t ki = 0; ki < sizeof(benchmark_k) / sizeof(benchmark_k[0]); ki++) {
+		uint32_t k = benchmark_k[ki];
+		atsc3_raptorq_params_t params;
+		if(!atsc3_raptorq_params_init(k, &params)) {
+			printf("atsc3_raptorq_benchmark: K: %u not supported, is atsc3_raptorq_tables.c generated from RFC 6330?\n", k);
+			return 1;
+		}
+
+		size_t block_len = (size_t)k * symbol_size;
+		uint8_t* source = (uint8_t*)malloc(block_len);
+		for(size_t i = 0; i < block_len; i++) {
+			source[i] = rand();
+		}
+		uint8_t* intermediate = atsc3_raptorq_encode_intermediate(&params, source, symbol_size);
+		if(!intermediate) {
+			free(source);
+			continue;
+		}
+
+		//pre-encode enough repair symbols for the worst loss rate so only the decode is timed
+		uint32_t repair_n = k * 2 / 5 + RAPTORQ_BENCHMARK_OVERHEAD + 8;
+		uint8_t* repair = (uint8_t*)malloc((size_t)repair_n * symbol_size);
+		for(uint32_t i = 0; i < repair_n; i++) {
+			atsc3_raptorq_encode_symbol(&params, intermediate, symbol_size, k + i, repair + (size_t)i * symbol_size);
+		}
+
+		for(uint32_t li = 0; li < sizeof(benchmark_loss_pct) / sizeof(benchmark_loss_pct[0]); li++) {
+			uint32_t loss_pct = benchmark_loss_pct[li];
+			uint32_t failed = 0;
+			double elapsed = 0;
+
+			for(uint32_t it = 0; it < iterations; it++) {
+				atsc3_raptorq_block_decoder_t* atsc3_raptorq_block_decoder = atsc3_raptorq_block_decoder_create(k, symbol_size);
+				uint32_t lost = 0;
+
+				double start = now_sec();
+				for(uint32_t esi = 0; esi < k; esi++) {
+					if((uint32_t)(rand() % 100) < loss_pct) {
+						lost++;
+						continue;
+					}
+					atsc3_raptorq_block_decoder_add_symbol(atsc3_raptorq_block_decoder, esi, source + (size_t)esi * symbol_size);
+				}
+
+				atsc3_raptorq_decode_status_t status = atsc3_raptorq_block_decoder_decode(atsc3_raptorq_block_decoder);
+				uint32_t i = 0;
+				//only the overhead symbols are fed if the first attempt fails
+				for(; lost && i < lost + RAPTORQ_BENCHMARK_OVERHEAD && i < repair_n; i++) {
+					atsc3_raptorq_block_decoder_add_symbol(atsc3_raptorq_block_decoder, k + i, repair + (size_t)i * symbol_size);
+					if(i + 1 >= lost) {
+						status = atsc3_raptorq_block_decoder_decode(atsc3_raptorq_block_decoder);
+						if(status == ATSC3_RAPTORQ_DECODE_OK) {
+							break;
+						}
+					}
+				}
+				elapsed += now_sec() - start;
+
+				if(status != ATSC3_RAPTORQ_DECODE_OK || memcmp(atsc3_raptorq_block_decoder->source, source, block_len)) {
+					failed++;
+				}
+				atsc3_raptorq_block_decoder_free(&atsc3_raptorq_block_decoder);
+			}
+
+			printf("%6u %6u %10u %12.3f %10.1f\n", k, loss_pct, failed, elapsed * 1000.0 / iterations,
+					(double)block_len * iterations / elapsed / 1e6);
+		}
+
+		free(repair);
+		free(intermediate);
+		free(source);
+	}
+
+	return 0;
+}
@@ -300,12 +300,9 @@ uint8_t* xml_attributes_clone(xml_string_t* s) {
 }
 
 uint8_t* xml_attributes_clone_node(xml_node_t* node) {
+    //xml_node_name is owned by the document, not a copy
     xml_string_t* xml_string = xml_node_name(node);
-    uint8_t* xml_attributes_clone_ret = xml_attributes_clone(xml_string);
-    
-    free(xml_string);
-    
-    return xml_attributes_clone_ret;
+    return xml_attributes_clone(xml_string);
 }
 
 /**
@@ -0,0 +1,105 @@
+#!/usr/bin/env python3
+#
+# rfc6330_tables.py
+#
+# generates src/atsc3_raptorq_tables.c (the V0..V3 tables of RFC 6330 5.5 and the
+# systematic index table of RFC 6330 5.6) from the plain text RFC, so the constants
+# are never transcribed by hand:
+#
+#   curl -o rfc6330.txt https://www.rfc-editor.org/rfc/rfc6330.txt
+#   python3 rfc6330_tables.py rfc6330.txt > ../src/atsc3_raptorq_tables.c
+#
+# or from src/: make raptorq_tables RFC6330_TXT=/path/to/rfc6330.txt
+#
+# atsc3_raptorq_tables.c is committed so the build never needs the RFC or the network.
+# --placeholder writes the same file without any table entries, RaptorQ recovery then
+# reports itself unavailable (atsc3_raptorq_tables_available) instead of decoding
+
+import re
+import sys
+
+
+def body_lines(lines, start_re, end_re):
+    start = None
+    for i, line in enumerate(lines):
+        if start is None:
+            if re.match(start_re, line):
+                start = i + 1
+        elif re.match(end_re, line):
+            return [l for l in lines[start:i] if not is_page_break(l)]
+    raise SystemExit("rfc6330_tables: section %s not found" % start_re)
+
+
+def is_page_break(line):
+    return "[Page" in line or line.startswith("RFC 6330")
+
+
+def v_table(lines, n):
+    body = body_lines(lines, r"^5\.5\.%d\.\s+The Table V%d" % (n + 1, n), r"^(5\.5\.%d\.|5\.6\.)" % (n + 2))
+    values = []
+    for line in body:
+        if re.match(r"^\s+\d+,", line) or re.match(r"^\s+\d+\s*$", line):
+            values.extend(int(v) for v in re.findall(r"\d+", line))
+    if len(values) != 256:
+        raise SystemExit("rfc6330_tables: V%d has %d entries, expected 256" % (n, len(values)))
+    return values
+
+
+def systematic_indices(lines):
+    body = body_lines(lines, r"^5\.6\.\s+Systematic Indices", r"^5\.7\.")
+    values = []
+    for line in body:
+        if line.strip().startswith("|"):
+            values.extend(int(v) for v in re.findall(r"\d+", line))
+    if len(values) % 5:
+        raise SystemExit("rfc6330_tables: systematic index table is not a multiple of 5 columns")
+    rows = sorted(tuple(values[i:i + 5]) for i in range(0, len(values), 5))
+    if len(rows) != 477 or rows[0][0] != 10 or rows[-1][0] != 56403:
+        raise SystemExit("rfc6330_tables: unexpected systematic index table, %d rows" % len(rows))
+    return rows
+
+
+def placeholder(out):
+    out.write("/*\n * atsc3_raptorq_tables.c\n *\n * generated by support_scripts/rfc6330_tables.py --placeholder, do not edit\n *\n")
+    out.write(" * no RFC 6330 table entries, RaptorQ recovery is unavailable until this file is regenerated from the RFC text:\n")
+    out.write(" *\n *   make raptorq_tables RFC6330_TXT=/path/to/rfc6330.txt\n */\n\n")
+    out.write('#include "atsc3_raptorq.h"\n\n')
+    for n in range(4):
+        out.write("const uint32_t atsc3_raptorq_v%d[256] = { 0 };\n" % n)
+    out.write("\nconst atsc3_raptorq_systematic_index_t atsc3_raptorq_systematic_indices[1] = { { 0 } };\n")
+    out.write("const uint32_t atsc3_raptorq_systematic_indices_n = 0;\n")
+
+
+def main():
+    if len(sys.argv) != 2:
+        raise SystemExit("usage: rfc6330_tables.py (rfc6330.txt | --placeholder)")
+
+    out = sys.stdout
+    if sys.argv[1] == "--placeholder":
+        placeholder(out)
+        return
+
+    with open(sys.argv[1]) as f:
+        lines = f.read().splitlines()
+
+    out.write("/*\n * atsc3_raptorq_tables.c\n *\n * generated by support_scripts/rfc6330_tables.py from RFC 6330, do not edit\n */\n\n")
+    out.write('#include "atsc3_raptorq.h"\n')
+
+    for n in range(4):
+        values = v_table(lines, n)
+        out.write("\n//RFC 6330 5.5.%d\nconst uint32_t atsc3_raptorq_v%d[256] = {\n" % (n + 1, n))
+        for i in range(0, 256, 8):
+            out.write("\t" + ", ".join("%u" % v for v in values[i:i + 8]) + ",\n")
+        out.write("};\n")
+
+    rows = systematic_indices(lines)
+    out.write("\n//RFC 6330 5.6 Table 2: K', J(K'), S(K'), H(K'), W(K')\n")
+    out.write("const atsc3_raptorq_systematic_index_t atsc3_raptorq_systematic_indices[] = {\n")
+    for row in rows:
+        out.write("\t{ %u, %u, %u, %u, %u },\n" % row)
+    out.write("};\n\n")
+    out.write("const uint32_t atsc3_raptorq_systematic_indices_n = sizeof(atsc3_raptorq_systematic_indices) / sizeof(atsc3_raptorq_systematic_index_t);\n")
+
+
+if __name__ == "__main__":
+    main()